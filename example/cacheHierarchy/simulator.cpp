@@ -5,75 +5,60 @@
 #include "simulator.hpp"
 
 #include "libCacheSim/cache.h"
+#include "libCacheSim/cacheHierarchy.h"
 #include "libCacheSim/plugin.h"
 #include "libCacheSim/reader.h"
-#include "libCacheSim/simulator.h"
 
 using namespace std;
 
-double Simulator::gen_miss_trace(string algo, uint64_t cache_size,
-                                 string trace_path, string miss_output_path) {
-  uint64_t n_req = 0, n_hit = 0;
-  std::ofstream miss_ofs(miss_output_path);
+void Simulator::simulate_hierarchy(string &algo, Myconfig &config) {
+  cache_hierarchy_policy_e policy;
+  if (!parse_cache_hierarchy_policy(config.policy.c_str(), &policy)) {
+    std::cerr << "unknown policy " << config.policy
+              << ", use inclusive, exclusive or write-back" << std::endl;
+    abort();
+  }
 
   reader_init_param_t reader_init_params = {
       .time_field = 1, .obj_id_field = 2, .obj_size_field = 3, .next_access_vtime_field = 4};
   // see the cacheSimulator example for using csv trace
   reader_init_params.binary_fmt_str = "<IQIQ";
-  reader_t *reader =
-      open_trace(trace_path.c_str(), BIN_TRACE, &reader_init_params);
-  common_cache_params_t cc_params = {.cache_size = cache_size};
-  cache_t *cache = create_cache(algo.c_str(), cc_params, nullptr);
-
-  request_t *req = new_request();
-
-  bool hit;
-  read_one_req(reader, req);
-  while (req->valid) {
-    n_req += 1;
-    hit = cache->get(cache, req);
-    if (!hit)
-      miss_ofs << req->clock_time << "," << (uint64_t)req->obj_id << ","
-               << req->obj_size << std::endl;
-    else
-      n_hit += 1;
-    read_one_req(reader, req);
+  vector<reader_t *> readers;
+  for (auto &trace_path : config.l1_trace_path) {
+    readers.push_back(
+        open_trace(trace_path.c_str(), BIN_TRACE, &reader_init_params));
   }
 
-  miss_ofs.close();
-  std::cout << trace_path << ", object miss ratio "
-            << 1.0 - (double)n_hit / n_req << std::endl;
-
-  return 1.0 - (double)n_hit / n_req;
-}
-
-void Simulator::output_mrc(string &algo, vector<uint64_t> cache_sizes,
-                           string &trace_path, string &mrc_output_path) {
-  char alg[] = "LRU";
-  reader_init_param_t reader_init_params = {
-      .time_field = 1, .obj_id_field = 2, .obj_size_field = 3};
-  reader_init_params.binary_fmt_str = "<III";
-  reader_t *reader =
-      open_trace(trace_path.c_str(), BIN_TRACE, &reader_init_params);
-
-  common_cache_params_t ccparams = {.cache_size = cache_sizes[0]};
-  cache_t *cache = create_cache(algo.c_str(), ccparams, nullptr);
+  common_cache_params_t cc_params = {.cache_size = config.l2_sizes[0]};
+  cache_t *cache = create_cache(algo.c_str(), cc_params, nullptr);
 
-  uint64_t cache_size_array[cache_sizes.size()];
-  std::copy(cache_sizes.begin(), cache_sizes.end(), cache_size_array);
+  cache_hierarchy_t *hierarchy = create_cache_hierarchy(policy);
+  cache_hierarchy_add_level(hierarchy, cache, config.l1_sizes.data(),
+                            config.l1_sizes.size());
+  cache_hierarchy_add_level(hierarchy, cache, config.l2_sizes.data(),
+                            config.l2_sizes.size());
+  simulate_cache_hierarchy(hierarchy, readers.data(), readers.size());
 
-  auto mrc = simulate_at_multi_sizes(reader, cache, cache_sizes.size(),
-                                     cache_size_array, nullptr, 0, 0,
-                                     std::thread::hardware_concurrency(), false);
+  for (int i = 0; i < config.n_l1; i++) {
+    cache_stat_t &stat = hierarchy->levels[0].stats[i].stat;
+    std::cout << config.l1_trace_path.at(i) << ", object miss ratio "
+              << (double)stat.n_miss / stat.n_req << std::endl;
+  }
 
-  std::ofstream mrc_ofs(mrc_output_path);
-  mrc_ofs << "# L2, " << mrc[0].n_req << " req, " << mrc[0].n_req_byte
+  cache_hierarchy_stat_t *mrc = hierarchy->levels[1].stats;
+  std::ofstream mrc_ofs(config.l2_mrc_output_path);
+  mrc_ofs << "# L2, " << mrc[0].stat.n_req << " req, " << mrc[0].stat.n_req_byte
           << " byte" << std::endl;
   mrc_ofs << "# cache size, miss_cnt, miss_byte" << std::endl;
-  for (int i = 0; i < cache_sizes.size(); i++) {
-    mrc_ofs << mrc[i].cache_size << "," << mrc[i].n_miss << ","
-            << mrc[i].n_miss_byte << std::endl;
+  for (int i = 0; i < config.l2_sizes.size(); i++) {
+    mrc_ofs << mrc[i].stat.cache_size << "," << mrc[i].stat.n_miss << ","
+            << mrc[i].stat.n_miss_byte << std::endl;
   }
-
   mrc_ofs.close();
+
+  free_cache_hierarchy(hierarchy);
+  cache->cache_free(cache);
+  for (auto reader : readers) {
+    close_reader(reader);
+  }
 }
@@ -10,19 +10,18 @@
 #include <fstream>
 #include <iostream>
 #include <string>
-#include <thread>
 #include <vector>
 
+#include "myconfig.hpp"
+
 using namespace std;
 
 class Simulator {
  public:
-  /* return obj miss ratio */
-  static double gen_miss_trace(string algo, uint64_t cache_size,
-                               string trace_path, string miss_output_path);
-
-  static void output_mrc(string &algo, std::vector<uint64_t> cache_sizes,
-                         string &trace_path, string &mrc_output_path);
+  /* simulate the L1 caches and the L2 at all the L2 sizes in one pass, the
+   * L1 misses go to the L2 in memory, and the L2 MRC is written to
+   * config.l2_mrc_output_path */
+  static void simulate_hierarchy(string &algo, Myconfig &config);
 };
 
 #endif  // libCacheSim_CACHESIMULATOR_H
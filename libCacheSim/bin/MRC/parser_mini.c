@@ -65,7 +65,7 @@ static struct argp_option options[] = {
     {"eviction-params", OPTION_EVICTION_PARAMS, "\"n-seg=4\"", 0,
      "optional params for each eviction algorithm, e.g., n-seg=4", 4},
     {"admission", OPTION_ADMISSION_ALGO, "bloom-filter", 0,
-     "Admission algorithm: size/bloom-filter/prob", 4},
+     "Admission algorithm: size/bloom-filter/prob/tinylfu", 4},
     {"admission-params", OPTION_ADMISSION_PARAMS, "\"prob=0.8\"", 0,
      "params for admission algorithm", 4},
     {"prefetch", OPTION_PREFETCH_ALGO, "Mithril", 0,
@@ -3,6 +3,7 @@
 #include <glib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <strings.h>
 
 #include "../../include/libCacheSim/const.h"
 #include "../../include/libCacheSim/dist.h"
@@ -46,6 +47,19 @@ enum argp_option_short {
   OPTION_PREFETCH_ALGO = 'p',
   OPTION_PREFETCH_PARAMS = 0x109,
   OPTION_PRINT_HEAD_REQ = 0x10a,
+  OPTION_CONCURRENT_THREADS = 0x10b,
+  OPTION_CONCURRENT_SHARDS = 0x10c,
+  OPTION_CONCURRENT_DISPATCH = 0x10d,
+  OPTION_SWEEP_PARAMS = 0x10e,
+  OPTION_SWEEP_WARMUP_FRAC = 0x10f,
+  OPTION_SWEEP_MODE = 0x110,
+  OPTION_SEARCH_GRID = 0x111,
+  OPTION_SEARCH_ETA = 0x112,
+  OPTION_SEARCH_FIRST_FRAC = 0x113,
+  OPTION_EARLY_STOP_ERROR = 0x114,
+  OPTION_EARLY_STOP_CONFIDENCE = 0x115,
+  OPTION_EARLY_STOP_BATCH = 0x116,
+  OPTION_CHECKPOINT_DIR = 0x117,
 };
 
 /*
@@ -67,7 +81,7 @@ static struct argp_option options[] = {
     {"eviction-params", OPTION_EVICTION_PARAMS, "\"n-seg=4\"", 0,
      "optional params for each eviction algorithm, e.g., n-seg=4", 4},
     {"admission", OPTION_ADMISSION_ALGO, "bloom-filter", 0,
-     "Admission algorithm: size/bloom-filter/prob", 4},
+     "Admission algorithm: size/bloom-filter/prob/tinylfu", 4},
     {"admission-params", OPTION_ADMISSION_PARAMS, "\"prob=0.8\"", 0,
      "params for admission algorithm", 4},
     {"prefetch", OPTION_PREFETCH_ALGO, "Mithril", 0,
@@ -94,6 +108,55 @@ static struct argp_option options[] = {
     {"verbose", OPTION_VERBOSE, "1", 0, "Produce verbose output", 10},
     {"print-head-req", OPTION_PRINT_HEAD_REQ, "false", 0,
      "Print the first few requests", 10},
+    {"concurrent-threads", OPTION_CONCURRENT_THREADS, "64", 0,
+     "Replay each cache on a sharded cache with 1, 2, 4 ... up to this many "
+     "threads and report the throughput and the miss ratio",
+     10},
+    {"concurrent-shards", OPTION_CONCURRENT_SHARDS, "64", 0,
+     "Number of shards used by --concurrent-threads, default the number of "
+     "threads",
+     10},
+    {"concurrent-dispatch", OPTION_CONCURRENT_DISPATCH, "shard", 0,
+     "How --concurrent-threads assigns requests to threads, shard or arrival",
+     10},
+    {"sweep-params", OPTION_SWEEP_PARAMS, "PARAMS", 0,
+     "Warm up each cache once and continue one variant per set of eviction "
+     "parameters (separated by ;) over the rest of the trace, e.g., "
+     "\"small-size-ratio=0.05;small-size-ratio=0.2\"",
+     10},
+    {"sweep-warmup-frac", OPTION_SWEEP_WARMUP_FRAC, "0.2", 0,
+     "Fraction of the requests used to warm up the cache in --sweep-params",
+     10},
+    {"sweep-mode", OPTION_SWEEP_MODE, "thread", 0,
+     "How --sweep-params runs the variants, thread or fork", 10},
+    {"search-grid", OPTION_SEARCH_GRID, "GRID", 0,
+     "Search the best eviction parameters with successive halving, each "
+     "algorithm and size is run with every combination of the values of its "
+     "keys (separated by ;), e.g., \"s3fifo:small-size-ratio=0.05,0.1\", the "
+     "algo: prefix can be omitted with one algorithm, an algorithm without "
+     "keys is run once, default searches the algorithms and sizes only",
+     10},
+    {"search-eta", OPTION_SEARCH_ETA, "2", 0,
+     "--search-grid keeps 1/eta of the candidates at each checkpoint", 10},
+    {"search-first-frac", OPTION_SEARCH_FIRST_FRAC, "0.1", 0,
+     "The first checkpoint of --search-grid as a fraction of the trace, the "
+     "next ones are eta times later",
+     10},
+    {"early-stop-error", OPTION_EARLY_STOP_ERROR, "0.001", 0,
+     "Stop each cache once the confidence interval of its miss ratio is "
+     "within this error, default 0 simulates the whole trace",
+     10},
+    {"early-stop-confidence", OPTION_EARLY_STOP_CONFIDENCE, "0.95", 0,
+     "The confidence of --early-stop-error", 10},
+    {"early-stop-batch", OPTION_EARLY_STOP_BATCH, "10000", 0,
+     "Number of requests in a batch of --early-stop-error at the start, the "
+     "batches grow as the simulation runs",
+     10},
+    {"checkpoint-dir", OPTION_CHECKPOINT_DIR, "DIR", 0,
+     "Save each cache to DIR after the --warmup-sec warmup and restore it "
+     "instead of warming up in later runs, only LRU, FIFO, Clock, Sieve, "
+     "S3FIFO, ARC and LFU without admission or prefetching are saved",
+     10},
 
     {0, 0, 0, 0, 0, 0}};
 
@@ -169,6 +232,81 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case OPTION_PRINT_HEAD_REQ:
       arguments->print_head_req = is_true(arg) ? true : false;
       break;
+    case OPTION_CONCURRENT_THREADS:
+      arguments->concurrent_threads = atoi(arg);
+      if (arguments->concurrent_threads <= 0) {
+        ERROR("concurrent-threads must be positive, got %s\n", arg);
+      }
+      break;
+    case OPTION_CONCURRENT_SHARDS:
+      arguments->concurrent_shards = atoi(arg);
+      if (arguments->concurrent_shards <= 0) {
+        ERROR("concurrent-shards must be positive, got %s\n", arg);
+      }
+      break;
+    case OPTION_CONCURRENT_DISPATCH:
+      if (strcasecmp(arg, "shard") == 0) {
+        arguments->concurrent_dispatch = CONCURRENT_DISPATCH_BY_SHARD;
+      } else if (strcasecmp(arg, "arrival") == 0) {
+        arguments->concurrent_dispatch = CONCURRENT_DISPATCH_BY_ARRIVAL;
+      } else {
+        ERROR("unknown concurrent-dispatch %s, use shard or arrival\n", arg);
+      }
+      break;
+    case OPTION_SWEEP_PARAMS:
+      arguments->sweep_params = strdup(arg);
+      break;
+    case OPTION_SWEEP_WARMUP_FRAC:
+      arguments->sweep_warmup_frac = strtod(arg, NULL);
+      if (arguments->sweep_warmup_frac <= 0 || arguments->sweep_warmup_frac >= 1) {
+        ERROR("sweep-warmup-frac must be in (0, 1), got %s\n", arg);
+      }
+      break;
+    case OPTION_SWEEP_MODE:
+      if (strcasecmp(arg, "thread") == 0) {
+        arguments->sweep_mode = WARMUP_SWEEP_THREAD;
+      } else if (strcasecmp(arg, "fork") == 0) {
+        arguments->sweep_mode = WARMUP_SWEEP_FORK;
+      } else {
+        ERROR("unknown sweep-mode %s, use thread or fork\n", arg);
+      }
+      break;
+    case OPTION_SEARCH_GRID:
+      arguments->search_grid = strdup(arg);
+      break;
+    case OPTION_SEARCH_ETA:
+      arguments->search_eta = strtod(arg, NULL);
+      if (arguments->search_eta <= 1) {
+        ERROR("search-eta must be larger than 1, got %s\n", arg);
+      }
+      break;
+    case OPTION_SEARCH_FIRST_FRAC:
+      arguments->search_first_frac = strtod(arg, NULL);
+      if (arguments->search_first_frac <= 0 || arguments->search_first_frac > 1) {
+        ERROR("search-first-frac must be in (0, 1], got %s\n", arg);
+      }
+      break;
+    case OPTION_EARLY_STOP_ERROR:
+      arguments->early_stop_error = strtod(arg, NULL);
+      if (arguments->early_stop_error < 0 || arguments->early_stop_error >= 1) {
+        ERROR("early-stop-error must be in [0, 1), got %s\n", arg);
+      }
+      break;
+    case OPTION_EARLY_STOP_CONFIDENCE:
+      arguments->early_stop_confidence = strtod(arg, NULL);
+      if (arguments->early_stop_confidence <= 0 || arguments->early_stop_confidence >= 1) {
+        ERROR("early-stop-confidence must be in (0, 1), got %s\n", arg);
+      }
+      break;
+    case OPTION_EARLY_STOP_BATCH:
+      arguments->early_stop_batch = strtoll(arg, NULL, 10);
+      if (arguments->early_stop_batch <= 0) {
+        ERROR("early-stop-batch must be positive, got %s\n", arg);
+      }
+      break;
+    case OPTION_CHECKPOINT_DIR:
+      arguments->checkpoint_dir = strdup(arg);
+      break;
     case ARGP_KEY_ARG:
       if (state->arg_num >= N_ARGS) {
         printf("found too many arguments, current %s\n", arg);
@@ -233,6 +371,19 @@ static void init_arg(struct arguments *args) {
   args->n_req = -1;
   args->sample_ratio = 1.0;
   args->print_head_req = true;
+  args->concurrent_threads = 0;
+  args->concurrent_shards = 0;
+  args->concurrent_dispatch = CONCURRENT_DISPATCH_BY_SHARD;
+  args->sweep_params = NULL;
+  args->sweep_warmup_frac = 0.2;
+  args->sweep_mode = WARMUP_SWEEP_THREAD;
+  args->search_grid = NULL;
+  args->search_eta = 2;
+  args->search_first_frac = 0.1;
+  args->early_stop_error = 0;
+  args->early_stop_confidence = 0.95;
+  args->early_stop_batch = 10000;
+  args->checkpoint_dir = NULL;
 
   for (int i = 0; i < N_MAX_ALGO; i++) {
     args->eviction_algo[i] = NULL;
@@ -252,6 +403,15 @@ void free_arg(struct arguments *args) {
   if (args->admission_params) {
     free(args->admission_params);
   }
+  if (args->sweep_params) {
+    free(args->sweep_params);
+  }
+  if (args->search_grid) {
+    free(args->search_grid);
+  }
+  if (args->checkpoint_dir) {
+    free(args->checkpoint_dir);
+  }
 
   for (int i = 0; i < args->n_eviction_algo; i++) {
     free(args->eviction_algo[i]);
@@ -283,6 +443,17 @@ void parse_cmd(int argc, char *argv[], struct arguments *args) {
                              .argp_domain = NULL};
 
   argp_parse(&argp, argc, argv, 0, 0, args);
+  if (args->concurrent_threads > 0 && args->concurrent_shards == 0) {
+    args->concurrent_shards = args->concurrent_threads;
+  }
+  if (args->checkpoint_dir != NULL) {
+    if (args->warmup_sec <= 0) {
+      ERROR("checkpoint-dir saves the caches after the warmup, it needs warmup-sec\n");
+    }
+    if (args->concurrent_threads > 0 || args->sweep_params != NULL || args->search_grid != NULL) {
+      ERROR("checkpoint-dir cannot be used with concurrent-threads, sweep-params or search-grid\n");
+    }
+  }
 
   args->trace_path = args->args[0];
   args->trace_type_str = args->args[1];
@@ -553,6 +724,23 @@ void print_parsed_args(struct arguments *args) {
     n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
                   ", consider object metadata");
 
+  if (args->concurrent_threads > 0)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", up to %d concurrent threads on %d shards, dispatch by %s",
+                  args->concurrent_threads, args->concurrent_shards,
+                  args->concurrent_dispatch == CONCURRENT_DISPATCH_BY_SHARD
+                      ? "shard"
+                      : "arrival");
+
+  if (args->early_stop_error > 0)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", stop early at error %.4lf with %.2lf confidence",
+                  args->early_stop_error, args->early_stop_confidence);
+
+  if (args->checkpoint_dir != NULL)
+    n += snprintf(output_str + n, OUTPUT_STR_LEN - n - 1,
+                  ", checkpoint dir %s", args->checkpoint_dir);
+
   snprintf(output_str + n, OUTPUT_STR_LEN - n - 1, "\n");
 
   INFO("%s", output_str);
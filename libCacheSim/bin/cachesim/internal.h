@@ -7,6 +7,7 @@
 #include "../../include/libCacheSim/enum.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 #include "../../include/libCacheSim/reader.h"
+#include "../../include/libCacheSim/simulator.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +49,29 @@ struct arguments {
   bool use_ttl;
   bool print_head_req;
 
+  /* replay with 1, 2, 4 ... concurrent_threads threads on a sharded cache */
+  int concurrent_threads;
+  int concurrent_shards;
+  concurrent_dispatch_e concurrent_dispatch;
+
+  /* warm up each cache once and continue one variant per parameter set */
+  char *sweep_params;
+  double sweep_warmup_frac;
+  warmup_sweep_mode_e sweep_mode;
+
+  /* successive halving over the algorithms, sizes and parameter grid */
+  char *search_grid;
+  double search_eta;
+  double search_first_frac;
+
+  /* stop each cache once its miss ratio converges, 0 to disable */
+  double early_stop_error;
+  double early_stop_confidence;
+  int64_t early_stop_batch;
+
+  /* save the caches after the warmup and restore them in later runs */
+  char *checkpoint_dir;
+
   /* arguments generated */
   reader_t *reader;
   cache_t *caches[N_MAX_ALGO * N_MAX_CACHE_SIZE];
@@ -59,7 +83,22 @@ void free_arg(struct arguments *args);
 
 void simulate(reader_t *reader, cache_t *cache, int report_interval,
               int warmup_sec, char *ofilepath, bool ignore_obj_size,
-              bool print_head_req);
+              bool print_head_req, const convergence_params_t *early_stop,
+              int64_t start_ts);
+
+int64_t warmup_with_checkpoints(struct arguments *args, bool inclusive);
+
+void simulate_concurrent_sweep(reader_t *reader, cache_t *caches[], int n_cache,
+                               int max_threads, int n_shard,
+                               concurrent_dispatch_e dispatch,
+                               double warmup_frac, char *ofilepath);
+
+void simulate_warmup_sweep(reader_t *reader, cache_t *caches[], int n_cache,
+                           char *sweep_params, double warmup_frac,
+                           int n_thread, warmup_sweep_mode_e mode,
+                           char *ofilepath);
+
+void simulate_param_search(struct arguments *args);
 
 void print_parsed_args(struct arguments *args);
 
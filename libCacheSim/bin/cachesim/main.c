@@ -16,20 +16,57 @@
 int main(int argc, char **argv) {
   struct arguments args;
   parse_cmd(argc, argv, &args);
+  convergence_params_t early_stop_params = default_convergence_params(args.early_stop_error, args.early_stop_confidence);
+  early_stop_params.batch_size = args.early_stop_batch;
+  const convergence_params_t *early_stop = args.early_stop_error > 0 ? &early_stop_params : NULL;
   if (args.n_cache_size == 0) {
     ERROR("no cache size found\n");
   }
+  if (args.concurrent_threads > 0) {
+    simulate_concurrent_sweep(args.reader, args.caches, args.n_cache_size * args.n_eviction_algo,
+                              args.concurrent_threads, args.concurrent_shards, args.concurrent_dispatch, 0,
+                              args.ofilepath);
+
+    free_arg(&args);
+    return 0;
+  }
+  if (args.search_grid != NULL) {
+    simulate_param_search(&args);
+
+    free_arg(&args);
+    return 0;
+  }
+  if (args.sweep_params != NULL) {
+    simulate_warmup_sweep(args.reader, args.caches, args.n_cache_size * args.n_eviction_algo, args.sweep_params,
+                          args.sweep_warmup_frac, args.n_thread, args.sweep_mode, args.ofilepath);
+
+    free_arg(&args);
+    return 0;
+  }
+  /* simulate and the multi-cache simulator count the requests at warmup_sec
+   * differently, the checkpoints follow the one that is used */
+  int64_t start_ts = -1;
+  if (args.checkpoint_dir != NULL) {
+    start_ts = warmup_with_checkpoints(&args, args.n_cache_size * args.n_eviction_algo == 1);
+  }
   if (args.n_cache_size * args.n_eviction_algo == 1) {
     simulate(args.reader, args.caches[0], args.report_interval, args.warmup_sec, args.ofilepath, args.ignore_obj_size,
-             args.print_head_req);
+             args.print_head_req, early_stop, start_ts);
 
     free_arg(&args);
     return 0;
   }
 
-  cache_stat_t *result = simulate_with_multi_caches(
-      args.reader, args.caches, args.n_cache_size * args.n_eviction_algo, NULL,
-      0, args.warmup_sec, args.n_thread, true, true);
+  cache_stat_t *result;
+  if (args.checkpoint_dir != NULL) {
+    result = simulate_with_multi_caches_from_reader_pos(args.reader, args.caches,
+                                                        args.n_cache_size * args.n_eviction_algo, args.n_thread,
+                                                        true, true, early_stop);
+  } else {
+    result = simulate_with_multi_caches_early_stop(
+        args.reader, args.caches, args.n_cache_size * args.n_eviction_algo, NULL,
+        0, args.warmup_sec, args.n_thread, true, true, early_stop);
+  }
 
   // output to file
   char output_str[1024];
@@ -76,6 +113,16 @@ int main(int argc, char **argv) {
              (double)result[i].n_miss_byte / (double)result[i].n_req_byte);
     printf("%s", output_str);
     fprintf(output_file, "%s", output_str);
+    if (result[i].early_stopped) {
+      INFO("%s cache size %8ld%s stopped early, miss ratio %.4lf +- %.4lf\n", result[i].cache_name,
+           (long)(result[i].cache_size / size_unit), size_unit_str,
+           (double)result[i].n_miss / (double)result[i].n_req, result[i].miss_ratio_ci);
+    }
+#ifdef SUPPORT_TTL
+    INFO("%s cache size %8ld%s, %lld objects (%lld bytes) expired\n", result[i].cache_name,
+         (long)(result[i].cache_size / size_unit), size_unit_str, (long long)result[i].expired_obj_cnt,
+         (long long)result[i].expired_bytes);
+#endif
   }
   fclose(output_file);
 
@@ -1,8 +1,17 @@
+#define _GNU_SOURCE
+#include <unistd.h>
+
 #include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/checkpoint.h"
+#include "../../include/libCacheSim/prefetchAlgo.h"
 #include "../../include/libCacheSim/reader.h"
+#include "../../include/libCacheSim/shardedCache.h"
+#include "../../include/libCacheSim/simulator.h"
 #include "../../utils/include/mymath.h"
 #include "../../utils/include/mystr.h"
 #include "../../utils/include/mysys.h"
+#include "cache_init.h"
+#include "internal.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,8 +23,12 @@ void print_head_requests(request_t *req, uint64_t req_cnt) {
   }
 }
 
+/**
+ * @param start_ts the time of the first request of the trace if the reader
+ * was moved past the warmup, -1 to use the first request read
+ */
 void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_sec, char *ofilepath,
-              bool ignore_obj_size, bool print_head_req) {
+              bool ignore_obj_size, bool print_head_req, const convergence_params_t *early_stop, int64_t start_ts) {
   /* random seed */
   srand(time(NULL));
   set_rand_seed(rand());
@@ -26,13 +39,23 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
   uint64_t req_byte = 0, miss_byte = 0;
 
   read_one_req(reader, req);
-  uint64_t start_ts = (uint64_t)req->clock_time;
+  if (start_ts < 0) {
+    start_ts = req->clock_time;
+  }
   uint64_t last_report_ts = warmup_sec;
 
   char detailed_cache_name[256];
   generate_cache_name(cache, detailed_cache_name, 256);
 
+  convergence_monitor_t monitor;
+  if (early_stop != NULL) {
+    convergence_monitor_init(&monitor, early_stop);
+  }
+
   double start_time = -1;
+#ifdef SUPPORT_TTL
+  int64_t n_warmup_expired_obj = 0, n_warmup_expired_byte = 0;
+#endif
   while (req->valid) {
     if (print_head_req) {
       print_head_requests(req, req_cnt);
@@ -46,15 +69,26 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
     } else {
       if (start_time < 0) {
         start_time = gettime();
+#ifdef SUPPORT_TTL
+        n_warmup_expired_obj = cache->n_expired_obj;
+        n_warmup_expired_byte = cache->n_expired_byte;
+#endif
       }
     }
 
     req_cnt++;
     req_byte += req->obj_size;
-    if (cache->get(cache, req) == false) {
+    bool hit = cache->get(cache, req);
+    if (!hit) {
       miss_cnt++;
       miss_byte += req->obj_size;
     }
+    if (early_stop != NULL && convergence_monitor_add(&monitor, !hit)) {
+      INFO("%s %s %.2lf hour: stop early after %lu requests, miss ratio %.4lf +- %.4lf\n",
+           mybasename(reader->trace_path), detailed_cache_name, (double)req->clock_time / 3600,
+           (unsigned long)req_cnt, (double)miss_cnt / req_cnt, monitor.half_width);
+      break;
+    }
     if (req->clock_time - last_report_ts >= (uint64_t) report_interval &&
         req->clock_time != 0) {
       INFO(
@@ -65,6 +99,11 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
           (double)req->clock_time / 3600, (unsigned long)req_cnt,
           (double)miss_cnt / req_cnt,
           (double)(miss_cnt - last_miss_cnt) / (req_cnt - last_req_cnt));
+      if (early_stop != NULL && monitor.n_batch >= 2) {
+        INFO("%s %s: %d batches of %lld requests, miss ratio %.4lf +- %.4lf, lag-1 autocorrelation %.2lf\n",
+             mybasename(reader->trace_path), detailed_cache_name, monitor.n_batch,
+             (long long)monitor.batch_size, monitor.mean, monitor.half_width, monitor.lag1_autocorr);
+      }
       last_miss_cnt = miss_cnt;
       last_req_cnt = req_cnt;
       last_report_ts = (int64_t)req->clock_time;
@@ -102,6 +141,11 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
 
 #pragma GCC diagnostic pop
   printf("%s", output_str);
+#ifdef SUPPORT_TTL
+  INFO("%s %s: %lld objects (%lld bytes) expired\n", mybasename(reader->trace_path), detailed_cache_name,
+       (long long)(cache->n_expired_obj - n_warmup_expired_obj),
+       (long long)(cache->n_expired_byte - n_warmup_expired_byte));
+#endif
   char *output_dir = rindex(ofilepath, '/');
   if (output_dir != NULL) {
     size_t dir_length = output_dir - ofilepath;
@@ -127,6 +171,434 @@ void simulate(reader_t *reader, cache_t *cache, int report_interval, int warmup_
   cache->cache_free(cache);
 }
 
+/**
+ * @brief replay the trace on each cache with 1, 2, 4 ... max_threads threads,
+ * each run uses a new cache of n_shard shards, and report the throughput and
+ * the miss ratio compared to the unsharded cache
+ *
+ * the caches are freed
+ */
+void simulate_concurrent_sweep(reader_t *reader, cache_t *caches[], int n_cache, int max_threads, int n_shard,
+                               concurrent_dispatch_e dispatch, double warmup_frac, char *ofilepath) {
+  char *output_dir = rindex(ofilepath, '/');
+  if (output_dir != NULL) {
+    size_t dir_length = output_dir - ofilepath;
+    char dir_path[1024];
+    snprintf(dir_path, dir_length + 1, "%s", ofilepath);
+    create_dir(dir_path);
+  }
+  FILE *output_file = fopen(ofilepath, "a");
+  if (output_file == NULL) {
+    ERROR("cannot open file %s %s\n", ofilepath, strerror(errno));
+    exit(1);
+  }
+
+  char output_str[1024];
+  cache_stat_t stat;
+  for (int i = 0; i < n_cache; i++) {
+    cache_t *cache = caches[i];
+    double unsharded_tput = simulate_concurrent(reader, cache, 1, dispatch, warmup_frac, &stat);
+    double unsharded_mr = (double)stat.n_miss / (double)stat.n_req;
+    snprintf(output_str, 1024, "%s %s, %d threads: miss ratio %.4lf, throughput %.2lf MQPS\n",
+             reader->trace_path, cache->cache_name, 1, unsharded_mr, unsharded_tput / 1000000.0);
+    printf("%s", output_str);
+    fprintf(output_file, "%s", output_str);
+
+    double one_thread_tput = 0;
+    for (int n_thread = 1;; n_thread = MIN(n_thread * 2, max_threads)) {
+      cache_t *sharded = sharded_cache_init(cache, n_shard);
+      double tput = simulate_concurrent(reader, sharded, n_thread, dispatch, warmup_frac, &stat);
+      if (n_thread == 1) one_thread_tput = tput;
+      double mr = (double)stat.n_miss / (double)stat.n_req;
+      snprintf(output_str, 1024,
+               "%s %s, %d threads: miss ratio %.4lf (%+.4lf), throughput %.2lf MQPS, speedup %.2lf\n",
+               reader->trace_path, sharded->cache_name, n_thread, mr, mr - unsharded_mr, tput / 1000000.0,
+               tput / one_thread_tput);
+      printf("%s", output_str);
+      fprintf(output_file, "%s", output_str);
+      sharded->cache_free(sharded);
+      if (n_thread == max_threads) break;
+    }
+    cache->cache_free(cache);
+  }
+  fclose(output_file);
+}
+
+void simulate_warmup_sweep(reader_t *reader, cache_t *caches[], int n_cache, char *sweep_params, double warmup_frac,
+                           int n_thread, warmup_sweep_mode_e mode, char *ofilepath) {
+  /* the parameter sets are separated by ; because a set has several
+   * parameters separated by , */
+  int n_variant = 0;
+  const char *variant_params[N_MAX_ALGO * N_MAX_CACHE_SIZE];
+  char *saveptr = NULL;
+  for (char *params = strtok_r(sweep_params, ";", &saveptr); params != NULL;
+       params = strtok_r(NULL, ";", &saveptr)) {
+    if (n_variant == N_MAX_ALGO * N_MAX_CACHE_SIZE) {
+      ERROR("too many parameter sets in sweep-params, at most %d\n", N_MAX_ALGO * N_MAX_CACHE_SIZE);
+    }
+    variant_params[n_variant++] = strcmp(params, "default") == 0 ? NULL : params;
+  }
+  if (n_variant == 0) {
+    ERROR("no parameter set found in sweep-params\n");
+  }
+
+  char *output_dir = rindex(ofilepath, '/');
+  if (output_dir != NULL) {
+    size_t dir_length = output_dir - ofilepath;
+    char dir_path[1024];
+    snprintf(dir_path, dir_length + 1, "%s", ofilepath);
+    create_dir(dir_path);
+  }
+  FILE *output_file = fopen(ofilepath, "a");
+  if (output_file == NULL) {
+    ERROR("cannot open file %s %s\n", ofilepath, strerror(errno));
+    exit(1);
+  }
+
+  char output_str[1024];
+  for (int i = 0; i < n_cache; i++) {
+    cache_t *cache = caches[i];
+    cache_stat_t *result =
+        simulate_variants_after_warmup(reader, cache, n_variant, variant_params, warmup_frac, n_thread, mode);
+    for (int j = 0; j < n_variant; j++) {
+      if (result[j].n_req == 0) continue;
+      snprintf(output_str, 1024,
+               "%s %s warmed by %s, cache size %ld, %lld warmup req, %lld req, miss ratio %.4lf, byte miss ratio "
+               "%.4lf\n",
+               reader->trace_path, result[j].cache_name, cache->cache_name, (long)result[j].cache_size,
+               (long long)result[j].n_warmup_req, (long long)result[j].n_req,
+               (double)result[j].n_miss / (double)result[j].n_req,
+               (double)result[j].n_miss_byte / (double)result[j].n_req_byte);
+      printf("%s", output_str);
+      fprintf(output_file, "%s", output_str);
+    }
+    free(result);
+    cache->cache_free(cache);
+  }
+  fclose(output_file);
+}
+
+/* the number of candidates of --search-grid is limited to avoid running out
+ * of memory by mistake */
+#define N_MAX_SEARCH_CANDIDATE 65536
+#define SEARCH_PARAMS_LEN 1024
+
+#define N_MAX_SEARCH_DIM 64
+#define N_MAX_SEARCH_VALUE 256
+
+/* one key of --search-grid and its values */
+typedef struct {
+  /* the algorithm the key belongs to, NULL if it is not prefixed */
+  const char *eviction_algo;
+  const char *key;
+  const char *values[N_MAX_SEARCH_VALUE];
+  int n_value;
+} search_dim_t;
+
+/**
+ * @brief parse the grid "algo:k1=a,b;algo:k2=c,d" in place, the algo prefix
+ * can be omitted when only one algorithm is searched
+ *
+ * @return the number of keys
+ */
+static int parse_search_grid(char *grid, char **eviction_algos, int n_eviction_algo, search_dim_t *dims) {
+  int n_dim = 0;
+  char *dim_saveptr = NULL;
+  for (char *dim = strtok_r(grid, ";", &dim_saveptr); dim != NULL; dim = strtok_r(NULL, ";", &dim_saveptr)) {
+    char *eq = strchr(dim, '=');
+    if (eq == NULL || n_dim == N_MAX_SEARCH_DIM) {
+      ERROR("cannot parse search-grid %s, expect algo:key=v1,v2;algo:key2=v3\n", dim);
+    }
+    *eq = '\0';
+    search_dim_t *d = &dims[n_dim];
+    /* the values may contain ':', the prefix is only looked for in the key */
+    char *colon = strchr(dim, ':');
+    if (colon != NULL) {
+      *colon = '\0';
+      d->eviction_algo = dim;
+      d->key = colon + 1;
+      bool found = false;
+      for (int i = 0; i < n_eviction_algo; i++) {
+        found = found || strcasecmp(eviction_algos[i], d->eviction_algo) == 0;
+      }
+      if (!found) {
+        ERROR("search-grid key %s is for %s, which is not searched\n", d->key, d->eviction_algo);
+      }
+    } else {
+      if (n_eviction_algo > 1) {
+        ERROR("search-grid key %s does not name an algorithm, use %s:%s with multiple algorithms\n", dim,
+              eviction_algos[0], dim);
+      }
+      d->eviction_algo = NULL;
+      d->key = dim;
+    }
+    d->n_value = 0;
+    char *value_saveptr = NULL;
+    for (char *v = strtok_r(eq + 1, ",", &value_saveptr); v != NULL; v = strtok_r(NULL, ",", &value_saveptr)) {
+      if (d->n_value == N_MAX_SEARCH_VALUE) {
+        ERROR("too many values of %s in search-grid\n", d->key);
+      }
+      d->values[d->n_value++] = v;
+    }
+    if (d->n_value == 0) {
+      ERROR("no value of %s in search-grid\n", d->key);
+    }
+    n_dim += 1;
+  }
+
+  return n_dim;
+}
+
+/**
+ * @brief expand the keys of eviction_algo into the parameter strings
+ * "k1=a,k2=c", "k1=a,k2=d" ..., prefixed by base_params if not NULL, an
+ * algorithm without keys gets base_params only
+ *
+ * @return the number of parameter strings
+ */
+static int expand_search_grid(const search_dim_t *dims, int n_dim, const char *eviction_algo,
+                              const char *base_params, char ***params_out) {
+  const search_dim_t *algo_dims[N_MAX_SEARCH_DIM];
+  int n_algo_dim = 0;
+  for (int d = 0; d < n_dim; d++) {
+    if (dims[d].eviction_algo == NULL || strcasecmp(dims[d].eviction_algo, eviction_algo) == 0) {
+      algo_dims[n_algo_dim++] = &dims[d];
+    }
+  }
+
+  int n_combination = 1;
+  for (int d = 0; d < n_algo_dim; d++) {
+    n_combination *= algo_dims[d]->n_value;
+    if (n_combination > N_MAX_SEARCH_CANDIDATE) {
+      ERROR("search-grid has more than %d combinations\n", N_MAX_SEARCH_CANDIDATE);
+    }
+  }
+
+  char **params = malloc(sizeof(char *) * n_combination);
+  if (n_algo_dim == 0) {
+    params[0] = base_params == NULL ? NULL : strdup(base_params);
+    *params_out = params;
+    return 1;
+  }
+
+  for (int c = 0; c < n_combination; c++) {
+    /* the value index of each dimension, the last dimension changes the
+     * fastest */
+    int value_idx[N_MAX_SEARCH_DIM];
+    for (int d = n_algo_dim - 1, rem = c; d >= 0; d--) {
+      value_idx[d] = rem % algo_dims[d]->n_value;
+      rem /= algo_dims[d]->n_value;
+    }
+
+    params[c] = malloc(SEARCH_PARAMS_LEN);
+    int len = base_params == NULL ? 0 : snprintf(params[c], SEARCH_PARAMS_LEN, "%s", base_params);
+    for (int d = 0; d < n_algo_dim && len < SEARCH_PARAMS_LEN; d++) {
+      len += snprintf(params[c] + len, SEARCH_PARAMS_LEN - len, "%s%s=%s", len > 0 ? "," : "", algo_dims[d]->key,
+                      algo_dims[d]->values[value_idx[d]]);
+    }
+    if (len >= SEARCH_PARAMS_LEN) {
+      ERROR("the parameters of a search-grid candidate are too long\n");
+    }
+  }
+
+  *params_out = params;
+  return n_combination;
+}
+
+void simulate_param_search(struct arguments *args) {
+  /* the caches created by the parser are replaced by the candidates */
+  for (int i = 0; i < args->n_eviction_algo * args->n_cache_size; i++) {
+    args->caches[i]->cache_free(args->caches[i]);
+  }
+
+  /* "default" searches the algorithms and sizes only */
+  search_dim_t *dims = malloc(sizeof(search_dim_t) * N_MAX_SEARCH_DIM);
+  int n_dim = 0;
+  if (strcasecmp(args->search_grid, "default") != 0) {
+    n_dim = parse_search_grid(args->search_grid, args->eviction_algo, args->n_eviction_algo, dims);
+  }
+
+  /* the parameter strings of each algorithm, the candidates of a size are
+   * the algorithms in order, each with all its parameter strings */
+  char **params[N_MAX_ALGO];
+  int n_params[N_MAX_ALGO];
+  int n_candidate = 0;
+  for (int i = 0; i < args->n_eviction_algo; i++) {
+    n_params[i] = expand_search_grid(dims, n_dim, args->eviction_algo[i], args->eviction_params, &params[i]);
+    n_candidate += n_params[i];
+  }
+  free(dims);
+  if (n_candidate > N_MAX_SEARCH_CANDIDATE) {
+    ERROR("too many search candidates %d, at most %d\n", n_candidate, N_MAX_SEARCH_CANDIDATE);
+  }
+
+  char *output_dir = rindex(args->ofilepath, '/');
+  if (output_dir != NULL) {
+    size_t dir_length = output_dir - args->ofilepath;
+    char dir_path[1024];
+    snprintf(dir_path, dir_length + 1, "%s", args->ofilepath);
+    create_dir(dir_path);
+  }
+  FILE *output_file = fopen(args->ofilepath, "a");
+  if (output_file == NULL) {
+    ERROR("cannot open file %s %s\n", args->ofilepath, strerror(errno));
+    exit(1);
+  }
+
+  cache_t **caches = malloc(sizeof(cache_t *) * n_candidate);
+  const char **candidate_params = malloc(sizeof(char *) * n_candidate);
+  int *order = malloc(sizeof(int) * n_candidate);
+  char output_str[2048];
+  /* the candidates of one cache size compete with each other */
+  for (int j = 0; j < args->n_cache_size; j++) {
+    int idx = 0;
+    for (int i = 0; i < args->n_eviction_algo; i++) {
+      for (int k = 0; k < n_params[i]; k++, idx++) {
+        caches[idx] = create_cache(args->trace_path, args->eviction_algo[i], args->cache_sizes[j], params[i][k],
+                                   args->consider_obj_metadata);
+        candidate_params[idx] = params[i][k];
+        if (args->admission_algo != NULL) {
+          caches[idx]->admissioner = create_admissioner(args->admission_algo, args->admission_params);
+        }
+        if (args->prefetch_algo != NULL) {
+          caches[idx]->prefetcher =
+              create_prefetcher(args->prefetch_algo, args->prefetch_params, args->cache_sizes[j]);
+        }
+      }
+    }
+
+    halving_result_t *result = simulate_with_multi_caches_halving(
+        args->reader, caches, n_candidate, 0, args->search_first_frac, args->search_eta, args->n_thread, true);
+
+    /* print the candidates from the best to the worst */
+    for (int i = 0; i < n_candidate; i++) {
+      order[result[i].rank - 1] = i;
+    }
+    printf("\n");
+    for (int r = 0; r < n_candidate; r++) {
+      const halving_result_t *res = &result[order[r]];
+      const char *p = candidate_params[order[r]];
+      bool finished = res->stat.n_req == get_num_of_req(args->reader);
+      char stop_str[64];
+      if (finished) {
+        snprintf(stop_str, 64, "finished, miss ratio");
+      } else {
+        snprintf(stop_str, 64, "stopped at %lld req, interval miss ratio", (long long)res->stat.n_req);
+      }
+      snprintf(output_str, 2048, "%s cache size %ld rank %4d %s (%s), %s %.4lf\n", args->reader->trace_path,
+               (long)res->stat.cache_size, res->rank, res->stat.cache_name, p == NULL ? "default" : p, stop_str,
+               res->miss_ratio);
+      printf("%s", output_str);
+      fprintf(output_file, "%s", output_str);
+    }
+    free(result);
+  }
+  fclose(output_file);
+
+  for (int i = 0; i < args->n_eviction_algo; i++) {
+    for (int k = 0; k < n_params[i]; k++) free(params[i][k]);
+    free(params[i]);
+  }
+  free(order);
+  free(candidate_params);
+  free(caches);
+}
+
+/* the checkpoint of a cache after n_warmup_req requests of the trace */
+static void cache_checkpoint_path(char *path, size_t len, const struct arguments *args, const cache_t *cache,
+                                  int64_t n_warmup_req) {
+  snprintf(path, len, "%s/%s.%s.%lu.%lld.ckpt", args->checkpoint_dir, mybasename(args->trace_path),
+           cache->cache_name, (unsigned long)cache->cache_size, (long long)n_warmup_req);
+}
+
+/* a checkpoint is only used by a cache created with the same parameters */
+static bool checkpoint_matches(const cache_t *restored, const cache_t *cache) {
+  return restored->cache_init == cache->cache_init && restored->cache_size == cache->cache_size &&
+         restored->obj_md_size == cache->obj_md_size && restored->default_ttl == cache->default_ttl &&
+         strcmp(restored->cache_name, cache->cache_name) == 0 &&
+         strcmp(restored->init_params, cache->init_params) == 0;
+}
+
+/**
+ * @brief warm up the caches with the first warmup_sec seconds of the trace
+ * and save them to checkpoint_dir, the caches saved by an earlier run are
+ * restored instead, the reader is moved to the first request after the
+ * warmup
+ *
+ * @param inclusive whether the requests at warmup_sec belong to the warmup
+ * @return the time of the first request of the trace
+ */
+int64_t warmup_with_checkpoints(struct arguments *args, bool inclusive) {
+  int n_cache = args->n_eviction_algo * args->n_cache_size;
+  request_t *req = new_request();
+
+  /* count the warmup requests on a clone, so that the reader stops right
+   * before the first request after the warmup */
+  reader_t *count_reader = clone_reader(args->reader);
+  read_one_req(count_reader, req);
+  int64_t start_ts = req->clock_time;
+  int64_t n_warmup_req = 0;
+  while (req->valid) {
+    int64_t t = req->clock_time - start_ts;
+    if (inclusive ? t > args->warmup_sec : t >= args->warmup_sec) break;
+    n_warmup_req += 1;
+    read_one_req(count_reader, req);
+  }
+  close_reader(count_reader);
+
+  create_dir(args->checkpoint_dir);
+  char path[1024];
+  bool *need_warmup = malloc(sizeof(bool) * n_cache);
+  int n_restored = 0;
+  for (int i = 0; i < n_cache; i++) {
+    cache_t *cache = args->caches[i];
+    need_warmup[i] = true;
+    if (!cache_support_checkpoint(cache)) {
+      WARN("cache %s does not support checkpoints, it is warmed up in every run\n", cache->cache_name);
+      continue;
+    }
+    cache_checkpoint_path(path, sizeof(path), args, cache, n_warmup_req);
+    if (access(path, F_OK) != 0) continue;
+
+    cache_t *restored = cache_restore(path);
+    if (restored != NULL && checkpoint_matches(restored, cache)) {
+      cache->cache_free(cache);
+      args->caches[i] = restored;
+      need_warmup[i] = false;
+      n_restored += 1;
+      continue;
+    }
+    WARN("%s is not a checkpoint of cache %s, warm it up again\n", path, cache->cache_name);
+    if (restored != NULL) restored->cache_free(restored);
+  }
+
+  for (int64_t n = 0; n < n_warmup_req; n++) {
+    read_one_req(args->reader, req);
+    req->clock_time -= start_ts;
+    for (int i = 0; i < n_cache; i++) {
+      if (need_warmup[i]) args->caches[i]->get(args->caches[i], req);
+    }
+  }
+
+  int n_saved = 0;
+  for (int i = 0; i < n_cache; i++) {
+    cache_t *cache = args->caches[i];
+    if (!need_warmup[i] || !cache_support_checkpoint(cache)) continue;
+    cache_checkpoint_path(path, sizeof(path), args, cache, n_warmup_req);
+    if (cache_checkpoint(cache, path)) {
+      n_saved += 1;
+    } else {
+      WARN("cannot save cache %s to %s\n", cache->cache_name, path);
+    }
+  }
+  INFO("%lld warmup requests, %d caches restored from %s, %d warmed up and %d saved\n", (long long)n_warmup_req,
+       n_restored, args->checkpoint_dir, n_cache - n_restored, n_saved);
+
+  free(need_warmup);
+  free_request(req);
+  return start_ts;
+}
+
 #ifdef __cplusplus
 }
 #endif
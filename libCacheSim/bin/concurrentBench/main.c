@@ -0,0 +1,291 @@
+//
+//  concurrentBench
+//  libCacheSim
+//
+//  measure the throughput of the concurrent caches with 1, 2, 4 ... threads,
+//  the requests are generated from a Zipf distribution or read from a trace
+//  into memory before the measurement, and the threads take the requests in
+//  order in chunks
+//
+//  usage:
+//    ./concurrentBench --algo=lru,clock,sieve,s3fifo --threads=16
+//    ./concurrentBench --trace=../data/trace.oracleGeneral.bin --trace-type=oracleGeneral --cache-size=100000
+//
+
+#define _GNU_SOURCE
+#include <argp.h>
+#include <glib.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/libCacheSim/concurrentCache.h"
+#include "../../include/libCacheSim/reader.h"
+#include "../../utils/include/mymath.h"
+#include "../../utils/include/mysys.h"
+#include "../cli_reader_utils.h"
+
+#define N_MAX_ALGO 16
+
+/* the number of requests a thread takes at a time */
+#define CHUNK_SIZE 256
+
+const char *argp_program_version = "concurrentBench 0.0.1";
+const char *argp_program_bug_address = "https://groups.google.com/g/libcachesim/";
+
+enum argp_option_short {
+  OPTION_ALGO = 'a',
+  OPTION_CACHE_SIZE = 'c',
+  OPTION_NUM_THREAD = 0x100,
+  OPTION_ZIPF_ALPHA = 0x101,
+  OPTION_NUM_OBJ = 0x102,
+  OPTION_NUM_REQ = 'n',
+  OPTION_TRACE = 0x103,
+  OPTION_TRACE_TYPE = 0x104,
+  OPTION_WARMUP_FRAC = 0x105,
+};
+
+static struct argp_option options[] = {
+    {"algo", OPTION_ALGO, "lru,clock,sieve,s3fifo", 0, "Comma separated concurrent caches to benchmark", 1},
+    {"cache-size", OPTION_CACHE_SIZE, "0", 0, "Number of objects in the cache, default 10% of the objects", 1},
+    {"threads", OPTION_NUM_THREAD, "n_cores", 0, "Run with 1, 2, 4 ... up to this many threads", 1},
+
+    {0, 0, 0, 0, "Zipf workload:", 2},
+    {"zipf-alpha", OPTION_ZIPF_ALPHA, "1.0", 0, "Skewness of the Zipf distribution", 2},
+    {"num-obj", OPTION_NUM_OBJ, "1000000", 0, "Number of objects", 2},
+    {"num-req", OPTION_NUM_REQ, "10000000", 0, "Number of requests, also caps the requests read from a trace", 2},
+
+    {0, 0, 0, 0, "Trace workload:", 3},
+    {"trace", OPTION_TRACE, "path", 0, "Read the object ids from a trace instead of generating them", 3},
+    {"trace-type", OPTION_TRACE_TYPE, "oracleGeneral", 0, "Type of the trace", 3},
+
+    {"warmup-frac", OPTION_WARMUP_FRAC, "0.2", 0,
+     "Fraction of the requests replayed by one thread before the measurement", 4},
+    {0}};
+
+struct arguments {
+  char *algos[N_MAX_ALGO];
+  int n_algo;
+  int64_t cache_size;
+  int max_threads;
+  double zipf_alpha;
+  int64_t n_obj;
+  int64_t n_req;
+  char *trace_path;
+  const char *trace_type;
+  double warmup_frac;
+};
+
+static void parse_algos(struct arguments *arguments, char *algos) {
+  arguments->n_algo = 0;
+  char *algo = strtok(algos, ",");
+  while (algo != NULL && arguments->n_algo < N_MAX_ALGO) {
+    arguments->algos[arguments->n_algo++] = algo;
+    algo = strtok(NULL, ",");
+  }
+}
+
+static error_t parse_opt(int key, char *arg, struct argp_state *state) {
+  struct arguments *arguments = state->input;
+
+  switch (key) {
+    case OPTION_ALGO:
+      parse_algos(arguments, arg);
+      break;
+    case OPTION_CACHE_SIZE:
+      arguments->cache_size = atoll(arg);
+      break;
+    case OPTION_NUM_THREAD:
+      arguments->max_threads = atoi(arg);
+      break;
+    case OPTION_ZIPF_ALPHA:
+      arguments->zipf_alpha = atof(arg);
+      break;
+    case OPTION_NUM_OBJ:
+      arguments->n_obj = atoll(arg);
+      break;
+    case OPTION_NUM_REQ:
+      arguments->n_req = atoll(arg);
+      break;
+    case OPTION_TRACE:
+      arguments->trace_path = arg;
+      break;
+    case OPTION_TRACE_TYPE:
+      arguments->trace_type = arg;
+      break;
+    case OPTION_WARMUP_FRAC:
+      arguments->warmup_frac = atof(arg);
+      break;
+    case ARGP_KEY_ARG:
+      argp_usage(state);
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+
+static struct argp argp = {options, parse_opt, NULL,
+                           "concurrentBench: measure the throughput of the concurrent caches", NULL, NULL, NULL};
+
+/* draw n_req object ids from a Zipf distribution over n_obj objects */
+static uint64_t *gen_zipf_keys(int64_t n_obj, double alpha, int64_t n_req) {
+  double *cdf = malloc(sizeof(double) * n_obj);
+  double sum = 0;
+  for (int64_t i = 0; i < n_obj; i++) {
+    sum += 1.0 / pow((double)(i + 1), alpha);
+    cdf[i] = sum;
+  }
+
+  uint64_t *keys = malloc(sizeof(uint64_t) * n_req);
+  set_rand_seed(1);
+  for (int64_t i = 0; i < n_req; i++) {
+    double r = (double)(next_rand() >> 11) / (double)(1ull << 53) * sum;
+    int64_t lo = 0, hi = n_obj - 1;
+    while (lo < hi) {
+      int64_t mid = lo + (hi - lo) / 2;
+      if (cdf[mid] < r) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    keys[i] = (uint64_t)lo;
+  }
+  free(cdf);
+  return keys;
+}
+
+static uint64_t *load_trace_keys(const char *trace_path, const char *trace_type, int64_t *n_req, int64_t *n_obj) {
+  reader_t *reader = create_reader(trace_type, trace_path, NULL, *n_req, true, 1);
+  int64_t capacity = 1 << 20, n = 0;
+  uint64_t *keys = malloc(sizeof(uint64_t) * capacity);
+  request_t *req = new_request();
+  read_one_req(reader, req);
+  while (req->valid) {
+    if (n == capacity) {
+      capacity *= 2;
+      keys = realloc(keys, sizeof(uint64_t) * capacity);
+    }
+    keys[n++] = req->obj_id;
+    read_one_req(reader, req);
+  }
+  free_request(req);
+  close_reader(reader);
+
+  GHashTable *objs = g_hash_table_new(g_int64_hash, g_int64_equal);
+  for (int64_t i = 0; i < n; i++) {
+    g_hash_table_add(objs, &keys[i]);
+  }
+  *n_obj = g_hash_table_size(objs);
+  *n_req = n;
+  g_hash_table_destroy(objs);
+  return keys;
+}
+
+typedef struct {
+  concurrent_cache_t *cache;
+  const uint64_t *keys;
+  int64_t n_req;
+  int64_t *next_req;
+  int64_t n_miss;
+} worker_t;
+
+static gpointer run_worker(gpointer data) {
+  worker_t *worker = data;
+  int64_t n_miss = 0;
+  while (true) {
+    int64_t start = __atomic_fetch_add(worker->next_req, CHUNK_SIZE, __ATOMIC_RELAXED);
+    if (start >= worker->n_req) break;
+    int64_t end = MIN(start + CHUNK_SIZE, worker->n_req);
+    for (int64_t i = start; i < end; i++) {
+      if (!worker->cache->get(worker->cache, worker->keys[i])) n_miss += 1;
+    }
+  }
+  worker->n_miss = n_miss;
+  return NULL;
+}
+
+/* return the throughput in requests per second */
+static double run(concurrent_cache_t *cache, const uint64_t *keys, int64_t n_req, int64_t n_warmup_req, int n_thread,
+                  double *miss_ratio) {
+  for (int64_t i = 0; i < n_warmup_req; i++) {
+    cache->get(cache, keys[i]);
+  }
+
+  int64_t next_req = n_warmup_req;
+  worker_t *workers = calloc(n_thread, sizeof(worker_t));
+  GThread **threads = malloc(sizeof(GThread *) * n_thread);
+  gint64 start_time = g_get_monotonic_time();
+  for (int t = 0; t < n_thread; t++) {
+    workers[t] = (worker_t){.cache = cache, .keys = keys, .n_req = n_req, .next_req = &next_req};
+    threads[t] = g_thread_new("concurrentBench", run_worker, &workers[t]);
+  }
+  int64_t n_miss = 0;
+  for (int t = 0; t < n_thread; t++) {
+    g_thread_join(threads[t]);
+    n_miss += workers[t].n_miss;
+  }
+  double elapsed_sec = (double)(g_get_monotonic_time() - start_time) / 1e6;
+
+  *miss_ratio = (double)n_miss / (double)(n_req - n_warmup_req);
+  free(threads);
+  free(workers);
+  return (double)(n_req - n_warmup_req) / elapsed_sec;
+}
+
+int main(int argc, char **argv) {
+  char default_algos[] = "lru,clock,sieve,s3fifo";
+  struct arguments args = {
+      .n_algo = 0,
+      .cache_size = 0,
+      .max_threads = n_cores(),
+      .zipf_alpha = 1.0,
+      .n_obj = 1000000,
+      .n_req = 10000000,
+      .trace_path = NULL,
+      .trace_type = "oracleGeneral",
+      .warmup_frac = 0.2,
+  };
+  argp_parse(&argp, argc, argv, 0, 0, &args);
+  if (args.n_algo == 0) {
+    parse_algos(&args, default_algos);
+  }
+  if (args.max_threads <= 0) {
+    ERROR("threads must be positive, got %d\n", args.max_threads);
+  }
+
+  uint64_t *keys;
+  if (args.trace_path != NULL) {
+    keys = load_trace_keys(args.trace_path, args.trace_type, &args.n_req, &args.n_obj);
+  } else {
+    keys = gen_zipf_keys(args.n_obj, args.zipf_alpha, args.n_req);
+  }
+  if (args.cache_size <= 0) {
+    args.cache_size = MAX(args.n_obj / 10, 1);
+  }
+  int64_t n_warmup_req = (int64_t)((double)args.n_req * args.warmup_frac);
+  INFO("%lld requests, %lld objects, cache size %lld objects, %lld warmup requests\n", (long long)args.n_req,
+       (long long)args.n_obj, (long long)args.cache_size, (long long)n_warmup_req);
+
+  for (int i = 0; i < args.n_algo; i++) {
+    double one_thread_tput = 0;
+    for (int n_thread = 1;; n_thread = MIN(n_thread * 2, args.max_threads)) {
+      concurrent_cache_t *cache = create_concurrent_cache(args.algos[i], args.cache_size);
+      if (cache == NULL) {
+        ERROR("%s has no concurrent implementation, use lru, clock, sieve or s3fifo\n", args.algos[i]);
+      }
+      double miss_ratio;
+      double tput = run(cache, keys, args.n_req, n_warmup_req, n_thread, &miss_ratio);
+      if (n_thread == 1) one_thread_tput = tput;
+      printf("%s %d threads: miss ratio %.4lf, throughput %.2lf Mops/s, speedup %.2lf\n", cache->cache_name,
+             n_thread, miss_ratio, tput / 1e6, tput / one_thread_tput);
+      cache->cache_free(cache);
+      if (n_thread == args.max_threads) break;
+    }
+  }
+
+  free(keys);
+  return 0;
+}
@@ -0,0 +1,82 @@
+//
+// a microbenchmark of Mithril mining, it replays a block trace through LRU
+// with Mithril once for each mining implementation and reports the mined
+// associations and the time spent mining
+//
+// usage: debug_mithril_mining <trace_path> <trace_type> [cache_size_ratio]
+//        [Mithril params]
+// e.g.,  debug_mithril_mining ../data/msr.oracleGeneral.zst oracleGeneral 0.1
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "../../include/libCacheSim/evictionAlgo.h"
+#include "../../include/libCacheSim/prefetchAlgo.h"
+#include "../../include/libCacheSim/prefetchAlgo/Mithril.h"
+#include "../../include/libCacheSim/reader.h"
+#include "../cli_reader_utils.h"
+
+static double now_sec(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void run(reader_t *reader, uint64_t cache_size, const char *impl, const char *extra_params) {
+  char params[1024];
+  snprintf(params, sizeof(params), "mining-impl=%s%s%s", impl, extra_params[0] ? "," : "", extra_params);
+
+  common_cache_params_t cc_params = default_common_cache_params();
+  cc_params.cache_size = cache_size;
+  cache_t *cache = LRU_init(cc_params, NULL);
+  cache->prefetcher = create_prefetcher("Mithril", params, cache_size);
+  Mithril_params_t *Mithril_params = (Mithril_params_t *)cache->prefetcher->params;
+
+  reset_reader(reader);
+  request_t *req = new_request();
+  uint64_t n_req = 0, n_miss = 0;
+  double start = now_sec();
+  while (read_one_req(reader, req) == 0) {
+    n_req += 1;
+    n_miss += !cache->get(cache, req);
+  }
+  double elapsed = now_sec() - start;
+
+  /* the associations of a background batch are added when it is waited on */
+  Mithril_mining_stat_t *stat = &Mithril_params->mining_stat;
+  printf(
+      "%-8s %8lu batches %10lu rows %10lu associations (hash %016lx), "
+      "mining %9.2lf ms, blocked %9.2lf ms, total %7.2lf s, miss ratio %.4lf\n",
+      Mithril_mining_impl_name(Mithril_params->mining_impl), (unsigned long)stat->n_mining,
+      (unsigned long)stat->n_row, (unsigned long)stat->n_association, (unsigned long)stat->association_hash,
+      stat->mining_ms, stat->blocking_ms, elapsed, (double)n_miss / (double)n_req);
+
+  free_request(req);
+  cache->cache_free(cache);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("Usage: %s <trace_path> <trace_type> [cache_size_ratio] [Mithril params]\n", argv[0]);
+    return 1;
+  }
+
+  double cache_size_ratio = argc > 3 ? atof(argv[3]) : 0.1;
+  const char *extra_params = argc > 4 ? argv[4] : "";
+
+  reader_t *reader = create_reader(argv[2], argv[1], NULL, -1, false, 1);
+  int64_t wss_obj = 0, wss_byte = 0;
+  cal_working_set_size(reader, &wss_obj, &wss_byte);
+  uint64_t cache_size = (uint64_t)((double)wss_byte * cache_size_ratio);
+  printf("%s, cache size %lu bytes\n", argv[1], (unsigned long)cache_size);
+
+  const char *impls[] = {"scalar", "sse2", "avx2", "avx512"};
+  for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+    run(reader, cache_size, impls[i], extra_params);
+  }
+
+  close_reader(reader);
+  return 0;
+}
@@ -136,7 +136,8 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
 static char args_doc[] =
     "trace_path trace_type --algo=[LRU] --profiler=[SHARDS] "
     "--profiler-params=[FIX_RATE,0.01,hash_salt|FIX_SIZE,8192,hash_salt|FIX_"
-    "RATE,0.01,thread_num(for MINISIM)] "
+    "RATE,0.01,thread_num(for MINISIM)|AUTO_RATE,0.01,thread_num[,init_"
+    "rate[,n_salt]](for MINISIM)] "
     "--size=[0.01,1,100|1MiB,100MiB,100|0.001,0.002,0.004,0.008,0.016|1MiB,"
     "10MiB,10MiB,1GiB]";
 
@@ -151,7 +152,9 @@ static char doc[] =
     "profiler: "
     "SHARDS or MINISIM\n"
     "profiler-params: "
-    "only SHARDS support fix_size sampling\n"
+    "only SHARDS support fix_size sampling, "
+    "MINISIM AUTO_RATE adapts the sample rate per size until the miss ratio "
+    "confidence interval is within the target error\n"
     "size: "
     "profiling working set size related mrc or fixed size mrc\n\n";
 
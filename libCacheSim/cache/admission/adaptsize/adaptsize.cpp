@@ -2,6 +2,8 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 
@@ -12,22 +14,82 @@
 // Const used in original implementation
 const double EWMA_DECAY = 0.3;
 const double gss_r = 0.61803399;
+const double gss_v = 1 - gss_r;
 const double tol = 3.0e-8;
 
+/* do not split a sweep into chunks smaller than this */
+#define MIN_OBJ_PER_THREAD 16384
+
+static inline double elapsed_ms(
+    const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+/**
+ * @brief sum fn(begin, end) over [0, n), the range is split into n_thread
+ * contiguous chunks and the partial sums are added in order, so the result
+ * only depends on n_thread, and it is the plain loop when n_thread is 1
+ */
+template <typename F>
+static double parallel_sum(size_t n, int n_thread, const F& fn) {
+  if (n_thread > (int)(n / MIN_OBJ_PER_THREAD)) {
+    n_thread = (int)(n / MIN_OBJ_PER_THREAD);
+  }
+  if (n_thread <= 1) {
+    return fn((size_t)0, n);
+  }
+
+  std::vector<double> partial(n_thread, 0);
+  std::vector<std::thread> threads;
+  size_t chunk = (n + n_thread - 1) / n_thread;
+  for (int t = 1; t < n_thread; t++) {
+    size_t begin = chunk * t, end = std::min(n, begin + chunk);
+    threads.emplace_back([&, t, begin, end]() { partial[t] = fn(begin, end); });
+  }
+  partial[0] = fn((size_t)0, chunk);
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  double sum = 0;
+  for (int t = 0; t < n_thread; t++) {
+    sum += partial[t];
+  }
+  return sum;
+}
+
 /**
  * @brief Initialzie Adaptstat
  * @param max_iteration_param
  * @param reconf_interval_param
+ * @param reconf_mode_param where and when the reconfiguration runs
+ * @param n_thread_param the number of threads used by each sweep over objects
+ * @param swap_delay_param the number of requests between a deterministic
+ * background reconfiguration and the use of its result
  */
 Adaptsize::Adaptsize(const uint64_t max_iteration_param,
-                     const uint64_t reconf_interval_param)
+                     const uint64_t reconf_interval_param,
+                     const ReconfMode reconf_mode_param,
+                     const int n_thread_param, const uint64_t swap_delay_param)
     : cache_size(0),
       max_iteration(max_iteration_param),
       reconf_interval(reconf_interval_param),
       next_reconf(reconf_interval_param),
       stat_size(0),
       c_param(1 << 15),
-      gss_v(1 - gss_r) {}
+      reconf_mode(reconf_mode_param),
+      n_thread(n_thread_param),
+      swap_delay(swap_delay_param),
+      n_req_since_search(0),
+      stat() {}
+
+Adaptsize::~Adaptsize() {
+  if (searcher.joinable()) {
+    searcher.join();
+  }
+}
 
 /**
  * @brief Copy constructor
@@ -40,12 +102,13 @@ Adaptsize::Adaptsize(const Adaptsize& other)
       next_reconf(other.next_reconf),
       stat_size(other.stat_size),
       c_param(other.c_param),
-      gss_v(other.gss_v),
+      reconf_mode(other.reconf_mode),
+      n_thread(other.n_thread),
+      swap_delay(other.swap_delay),
+      n_req_since_search(0),
+      stat(other.stat),
       interval_metadata(other.interval_metadata),
-      longterm_metadata(other.longterm_metadata),
-      aligned_obj_size(other.aligned_obj_size),
-      aligned_obj_seen_times(other.aligned_obj_seen_times),
-      aligned_admission_probs(other.aligned_admission_probs) {}
+      longterm_metadata(other.longterm_metadata) {}
 
 /**
  * @brief Move constructor
@@ -58,12 +121,15 @@ Adaptsize::Adaptsize(Adaptsize&& other) noexcept
       next_reconf(other.next_reconf),
       stat_size(other.stat_size),
       c_param(other.c_param),
-      gss_v(other.gss_v),
+      reconf_mode(other.reconf_mode),
+      n_thread(other.n_thread),
+      swap_delay(other.swap_delay),
+      n_req_since_search(other.n_req_since_search),
+      pending_job(std::move(other.pending_job)),
+      searcher(std::move(other.searcher)),
+      stat(other.stat),
       interval_metadata(std::move(other.interval_metadata)),
-      longterm_metadata(std::move(other.longterm_metadata)),
-      aligned_obj_size(std::move(other.aligned_obj_size)),
-      aligned_obj_seen_times(std::move(other.aligned_obj_seen_times)),
-      aligned_admission_probs(std::move(other.aligned_admission_probs)) {}
+      longterm_metadata(std::move(other.longterm_metadata)) {}
 
 /**
  * @brief Copy assignment operator
@@ -72,18 +138,23 @@ Adaptsize::Adaptsize(Adaptsize&& other) noexcept
  */
 Adaptsize& Adaptsize::operator=(const Adaptsize& other) {
   if (this != &other) {
+    if (searcher.joinable()) {
+      searcher.join();
+    }
+    pending_job.reset();
     cache_size = other.cache_size;
     max_iteration = other.max_iteration;
     reconf_interval = other.reconf_interval;
     next_reconf = other.next_reconf;
     stat_size = other.stat_size;
     c_param = other.c_param;
-    gss_v = other.gss_v;
+    reconf_mode = other.reconf_mode;
+    n_thread = other.n_thread;
+    swap_delay = other.swap_delay;
+    n_req_since_search = 0;
+    stat = other.stat;
     interval_metadata = other.interval_metadata;
     longterm_metadata = other.longterm_metadata;
-    aligned_obj_size = other.aligned_obj_size;
-    aligned_obj_seen_times = other.aligned_obj_seen_times;
-    aligned_admission_probs = other.aligned_admission_probs;
   }
   return *this;
 }
@@ -95,18 +166,24 @@ Adaptsize& Adaptsize::operator=(const Adaptsize& other) {
  */
 Adaptsize& Adaptsize::operator=(Adaptsize&& other) noexcept {
   if (this != &other) {
+    if (searcher.joinable()) {
+      searcher.join();
+    }
     cache_size = other.cache_size;
     max_iteration = other.max_iteration;
     reconf_interval = other.reconf_interval;
     next_reconf = other.next_reconf;
     stat_size = other.stat_size;
     c_param = other.c_param;
-    gss_v = other.gss_v;
+    reconf_mode = other.reconf_mode;
+    n_thread = other.n_thread;
+    swap_delay = other.swap_delay;
+    n_req_since_search = other.n_req_since_search;
+    pending_job = std::move(other.pending_job);
+    searcher = std::move(other.searcher);
+    stat = other.stat;
     interval_metadata = std::move(other.interval_metadata);
     longterm_metadata = std::move(other.longterm_metadata);
-    aligned_obj_size = std::move(other.aligned_obj_size);
-    aligned_obj_seen_times = std::move(other.aligned_obj_seen_times);
-    aligned_admission_probs = std::move(other.aligned_admission_probs);
   }
   return *this;
 }
@@ -119,6 +196,7 @@ Adaptsize& Adaptsize::operator=(Adaptsize&& other) noexcept {
 void Adaptsize::updateStats(const request_t* req,
                             const uint64_t cache_size_param) {
   this->cache_size = cache_size_param;
+  poll_search();
   reconfigure();
   if (interval_metadata.count(req->obj_id) == 0 &&
       longterm_metadata.count(req->obj_id) == 0) {
@@ -155,8 +233,37 @@ void Adaptsize::reconfigure() {
     return;
   }
   // END Check if its time for reconfiguration
-  // Prepare for reconf
   next_reconf = reconf_interval;
+
+  // one search at a time, the previous one must have been used
+  if (pending_job != nullptr) {
+    wait_search();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto job = std::make_shared<search_job>();
+  job->cache_size = cache_size;
+  job->max_iteration = max_iteration;
+  job->n_thread = n_thread;
+  prepare_search(*job);
+
+  if (reconf_mode == RECONF_SYNC) {
+    search(*job);
+    finish_search(*job);
+    stat.total_blocking_ms += elapsed_ms(start);
+    return;
+  }
+
+  pending_job = job;
+  n_req_since_search = 0;
+  searcher = std::thread([job]() {
+    search(*job);
+    job->done.store(true, std::memory_order_release);
+  });
+  stat.total_blocking_ms += elapsed_ms(start);
+}
+
+void Adaptsize::prepare_search(search_job& job) {
   for (auto& obj : longterm_metadata) {
     obj.second.obj_seen_times *= EWMA_DECAY;
   }
@@ -170,38 +277,46 @@ void Adaptsize::reconfigure() {
     longterm_metadata[obj.first].obj_size = obj.second.obj_size;
   }
   interval_metadata.clear();
-  aligned_obj_seen_times.clear();
-  aligned_obj_size.clear();
 
   double total_seen_times = 0.0;
   uint64_t total_obj_size = 0.0;
 
+  job.obj_seen_times.reserve(longterm_metadata.size());
+  job.obj_size.reserve(longterm_metadata.size());
   for (auto it = longterm_metadata.begin(); it != longterm_metadata.end();) {
     if (it->second.obj_seen_times < 0.1) {
       stat_size -= it->second.obj_size;
       it = longterm_metadata.erase(it);
       continue;
     }
-    aligned_obj_seen_times.push_back(it->second.obj_seen_times);
+    job.obj_seen_times.push_back(it->second.obj_seen_times);
     total_seen_times += it->second.obj_seen_times;
-    aligned_obj_size.push_back(it->second.obj_size);
+    job.obj_size.push_back(it->second.obj_size);
     total_obj_size += it->second.obj_size;
     ++it;
   }
   VVERBOSE(
       "Reconfiguring over %zu objects - log2 total size %f log2 statsize %f\n",
       longterm_metadata.size(), log2(total_obj_size), log2(stat_size));
-  // END Prepare for reconf
-  // Finding the value of C with the best hit rate
+}
+
+/**
+ * @brief find the value of C with the best modeled hit rate, it only touches
+ * the job so that it can run on the background thread
+ */
+void Adaptsize::search(search_job& job) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<double> admission_probs;
+
   double x0 = 0;
-  double x1 = log2(cache_size);
+  double x1 = log2(job.cache_size);
   double x2 = x1;
   double x3 = x1;
 
   double best_hit_rate = 0.0;
   for (int i = 2; i < x3; i += 4) {
     const double next_log2c = i;
-    const double hit_rate = modelHitRate(next_log2c);
+    const double hit_rate = modelHitRate(job, next_log2c, admission_probs);
     if (hit_rate > best_hit_rate) {
       best_hit_rate = hit_rate;
       x1 = next_log2c;
@@ -213,15 +328,15 @@ void Adaptsize::reconfigure() {
 
   if (x3 - x1 > x1 - x0) {
     x2 = x1 + gss_v * (x3 - x1);
-    h2 = modelHitRate(x2);
+    h2 = modelHitRate(job, x2, admission_probs);
   } else {
     x2 = x1;
     h2 = h1;
     x1 = x0 + gss_v * (x1 - x0);
-    h1 = modelHitRate(x1);
+    h1 = modelHitRate(job, x1, admission_probs);
   }
   uint64_t current_iteration = 0;
-  while (current_iteration++ < max_iteration &&
+  while (current_iteration++ < job.max_iteration &&
          fabs(x3 - x0) > tol * (fabs(x1) + fabs(x2))) {
     if (h1 != h1 || h2 != h2) {
       // Error NaN
@@ -233,28 +348,72 @@ void Adaptsize::reconfigure() {
       x1 = x2;
       x2 = gss_r * x1 + gss_v * x3;
       h1 = h2;
-      h2 = modelHitRate(x2);
+      h2 = modelHitRate(job, x2, admission_probs);
     } else {
       x3 = x2;
       x2 = x1;
       x1 = gss_r * x2 + gss_v * x0;
       h2 = h1;
-      h1 = modelHitRate(x1);
+      h1 = modelHitRate(job, x1, admission_probs);
     }
   }
   // END Finding the value of C with the best hit rate
   // Check for result
+  job.found = true;
   if (h1 != h1 || h2 != h2) {
     // Error NaN
     WARN("BUG: NaN h1:%f h2:%f\n", h1, h2);
+    job.found = false;
   } else if (h1 > h2) {
-    c_param = pow(2, x1);
-    VVERBOSE("C = %f (log2: %f )\n", c_param, x1);
+    job.c_param = pow(2, x1);
+    VVERBOSE("C = %f (log2: %f )\n", job.c_param, x1);
   } else {
-    c_param = pow(2, x2);
-    VVERBOSE("C = %f (log2: %f )\n", c_param, x2);
+    job.c_param = pow(2, x2);
+    VVERBOSE("C = %f (log2: %f )\n", job.c_param, x2);
   }
   // END Check for result
+  job.search_ms = elapsed_ms(start);
+}
+
+/* use the result of a search, on the request path */
+void Adaptsize::finish_search(search_job& job) {
+  if (job.found) {
+    c_param = job.c_param;
+  }
+
+  stat.n_reconf += 1;
+  stat.last_search_ms = job.search_ms;
+  stat.total_search_ms += job.search_ms;
+  if (job.search_ms > stat.max_search_ms) {
+    stat.max_search_ms = job.search_ms;
+  }
+  DEBUG("AdaptSize reconfiguration %lu over %zu objects: %.2lf ms, C %.0lf\n",
+        (unsigned long)stat.n_reconf, job.obj_seen_times.size(),
+        job.search_ms, c_param);
+}
+
+/* use the result of the background search if it is due */
+void Adaptsize::poll_search() {
+  if (pending_job == nullptr) {
+    return;
+  }
+
+  n_req_since_search += 1;
+  if (reconf_mode == RECONF_DETERMINISTIC) {
+    if (n_req_since_search >= swap_delay) {
+      wait_search();
+    }
+  } else if (pending_job->done.load(std::memory_order_acquire)) {
+    wait_search();
+  }
+}
+
+void Adaptsize::wait_search() {
+  auto start = std::chrono::steady_clock::now();
+  searcher.join();
+  stat.total_blocking_ms += elapsed_ms(start);
+  finish_search(*pending_job);
+  pending_job.reset();
 }
 
 /**
@@ -284,65 +443,75 @@ static inline double oP2(double T, double l, double p) {
 
 /**
  * @brief This function get called a lot in reconfigure function, used to
- * predict C hit rate
+ * predict C hit rate, each sweep over the objects is split among job.n_thread
+ * threads
  * @param log2c
+ * @param admission_probs scratch space for the admission probability of each
+ * object
  * @return hit rate prediction
  */
-double Adaptsize::modelHitRate(double log2c) {
+double Adaptsize::modelHitRate(const search_job& job, double log2c,
+                               std::vector<double>& admission_probs) {
   double old_T, the_T, the_C;
-  double sum_val = 0.;
-  double thparam = log2c;
+  const double* seen_times = job.obj_seen_times.data();
+  const double* obj_size = job.obj_size.data();
+  const size_t n_obj = job.obj_seen_times.size();
+  const double c = pow(2, log2c);
 
-  for (size_t i = 0; i < aligned_obj_seen_times.size(); i++) {
-    sum_val += aligned_obj_seen_times[i] *
-               (exp(-aligned_obj_size[i] / pow(2, thparam))) *
-               aligned_obj_size[i];
-  }
+  admission_probs.resize(n_obj);
+  double* probs = admission_probs.data();
+
+  double sum_val = parallel_sum(n_obj, job.n_thread, [&](size_t b, size_t e) {
+    double sum = 0.;
+    for (size_t i = b; i < e; i++) {
+      probs[i] = exp(-obj_size[i] / c);
+      sum += seen_times[i] * probs[i] * obj_size[i];
+    }
+    return sum;
+  });
   if (sum_val <= 0) {
     return (0);
   }
-  the_T = cache_size / sum_val;
-  aligned_admission_probs.clear();
-  for (size_t i = 0; i < aligned_obj_seen_times.size(); i++) {
-    aligned_admission_probs.push_back(
-        exp(-aligned_obj_size[i] / pow(2.0, thparam)));
-  }
+  the_T = job.cache_size / sum_val;
   for (int j = 0; j < 20; j++) {
-    the_C = 0;
     if (the_T > 1e70) {
       break;
     }
-    for (size_t i = 0; i < aligned_obj_seen_times.size(); i++) {
-      const double reqTProd = aligned_obj_seen_times[i] * the_T;
-      if (reqTProd > 150) {
-        the_C += aligned_obj_size[i];
-      } else {
-        const double expTerm = exp(reqTProd) - 1;
-        const double expAdmProd = aligned_admission_probs[i] * expTerm;
-        const double tmp = expAdmProd / (1 + expAdmProd);
-        the_C += aligned_obj_size[i] * tmp;
+    the_C = parallel_sum(n_obj, job.n_thread, [&](size_t b, size_t e) {
+      double sum = 0;
+      for (size_t i = b; i < e; i++) {
+        const double reqTProd = seen_times[i] * the_T;
+        if (reqTProd > 150) {
+          sum += obj_size[i];
+        } else {
+          const double expTerm = exp(reqTProd) - 1;
+          const double expAdmProd = probs[i] * expTerm;
+          const double tmp = expAdmProd / (1 + expAdmProd);
+          sum += obj_size[i] * tmp;
+        }
       }
-    }
+      return sum;
+    });
     old_T = the_T;
-    the_T = cache_size * old_T / the_C;
+    the_T = job.cache_size * old_T / the_C;
   }
 
-  double weighted_hitratio_sum = 0;
-  for (size_t i = 0; i < aligned_obj_seen_times.size(); i++) {
-    const double tmp01 =
-        oP1(the_T, aligned_obj_seen_times[i], aligned_admission_probs[i]);
-    const double tmp02 =
-        oP2(the_T, aligned_obj_seen_times[i], aligned_admission_probs[i]);
-    double tmp;
-    if (tmp01 != 0 && tmp02 == 0)
-      tmp = 0.0;
-    else
-      tmp = tmp01 / tmp02;
-    if (tmp < 0.0)
-      tmp = 0.0;
-    else if (tmp > 1.0)
-      tmp = 1.0;
-    weighted_hitratio_sum += aligned_obj_seen_times[i] * tmp;
-  }
-  return weighted_hitratio_sum;
-}
\ No newline at end of file
+  return parallel_sum(n_obj, job.n_thread, [&](size_t b, size_t e) {
+    double weighted_hitratio_sum = 0;
+    for (size_t i = b; i < e; i++) {
+      const double tmp01 = oP1(the_T, seen_times[i], probs[i]);
+      const double tmp02 = oP2(the_T, seen_times[i], probs[i]);
+      double tmp;
+      if (tmp01 != 0 && tmp02 == 0)
+        tmp = 0.0;
+      else
+        tmp = tmp01 / tmp02;
+      if (tmp < 0.0)
+        tmp = 0.0;
+      else if (tmp > 1.0)
+        tmp = 1.0;
+      weighted_hitratio_sum += seen_times[i] * tmp;
+    }
+    return weighted_hitratio_sum;
+  });
+}
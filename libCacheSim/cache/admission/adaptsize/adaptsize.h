@@ -3,7 +3,10 @@
 
 #include <sys/types.h>
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -11,9 +14,20 @@
 
 class Adaptsize {
  public:
-  Adaptsize(const uint64_t max_iteration, const uint64_t reconf_interval);
+  /* sync searches C on the request path at each reconfiguration; async
+   * searches on a background thread and publishes C as soon as the search
+   * finishes; deterministic also searches on a background thread but
+   * publishes C exactly swap_delay requests after the reconfiguration,
+   * waiting for the thread if needed */
+  enum ReconfMode { RECONF_SYNC = 0, RECONF_ASYNC = 1, RECONF_DETERMINISTIC = 2 };
 
-  // Copy constructor
+  Adaptsize(const uint64_t max_iteration, const uint64_t reconf_interval,
+            const ReconfMode reconf_mode = RECONF_SYNC,
+            const int n_thread = 1, const uint64_t swap_delay = 0);
+
+  ~Adaptsize();
+
+  // Copy constructor, a pending background search is not copied
   Adaptsize(const Adaptsize& other);
 
   // Move constructor
@@ -28,9 +42,44 @@ class Adaptsize {
   bool admit(const request_t* req);
   void updateStats(const request_t* req, const uint64_t cache_size);
 
+  /* reconfiguration cost */
+  struct reconf_stat {
+    uint64_t n_reconf;
+    /* time spent searching C, on whichever thread runs the search */
+    double total_search_ms;
+    double max_search_ms;
+    double last_search_ms;
+    /* time the request path spent preparing the data and waiting for the
+     * background search */
+    double total_blocking_ms;
+  };
+  const reconf_stat& get_reconf_stat() const { return stat; }
+
  private:
+  /* the data of one search, owned by the background thread while it runs */
+  struct search_job {
+    std::vector<double> obj_size;
+    std::vector<double> obj_seen_times;
+    uint64_t cache_size;
+    uint64_t max_iteration;
+    int n_thread;
+
+    double c_param;
+    bool found;
+    double search_ms;
+    std::atomic<bool> done{false};
+  };
+
   void reconfigure();
-  double modelHitRate(double log2c);
+  /* move the interval stats into the long-term stats and build the search
+   * input */
+  void prepare_search(search_job& job);
+  static void search(search_job& job);
+  static double modelHitRate(const search_job& job, double log2c,
+                             std::vector<double>& admission_probs);
+  void finish_search(search_job& job);
+  void poll_search();
+  void wait_search();
 
   uint64_t cache_size;
   uint64_t max_iteration;
@@ -38,7 +87,16 @@ class Adaptsize {
   uint64_t next_reconf;
   uint64_t stat_size;
   double c_param;
-  double gss_v;
+
+  ReconfMode reconf_mode;
+  int n_thread;
+  uint64_t swap_delay;
+  /* the number of requests since the background search started */
+  uint64_t n_req_since_search;
+  std::shared_ptr<search_job> pending_job;
+  std::thread searcher;
+
+  reconf_stat stat;
 
   struct obj_info {
     double obj_seen_times;
@@ -47,9 +105,6 @@ class Adaptsize {
 
   std::unordered_map<obj_id_t, obj_info> interval_metadata;
   std::unordered_map<obj_id_t, obj_info> longterm_metadata;
-  std::vector<double> aligned_obj_size;
-  std::vector<double> aligned_obj_seen_times;
-  std::vector<double> aligned_admission_probs;
 };
 
 #endif  // LIBCACHESIM_ADMISSION_ADAPTSIZE_H
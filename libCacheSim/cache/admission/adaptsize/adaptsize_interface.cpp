@@ -13,10 +13,15 @@ extern "C" {
 typedef struct adaptsize_admissioner {
   uint64_t max_iteration;
   uint64_t reconf_interval;
+  Adaptsize::ReconfMode reconf_mode;
+  int n_thread;
+  uint64_t swap_delay;
   Adaptsize adaptsize;
 } adaptsize_admission_params_t;
 
-static const char *DEFAULT_PARAMS = "max-iteration=15,reconf-interval=30000";
+static const char *DEFAULT_PARAMS =
+    "max-iteration=15,reconf-interval=30000,reconf-mode=sync,n-thread=1,"
+    "swap-delay=10000";
 
 // ***********************************************************************
 // ****                                                               ****
@@ -88,9 +93,35 @@ static void adaptsize_admissioner_parse_params(
         pa->max_iteration = strtoll(value, &end, 10);
       } else if (strcasecmp(key, "reconf-interval") == 0) {
         pa->reconf_interval = strtoull(value, &end, 10);
+      } else if (strcasecmp(key, "reconf-mode") == 0) {
+        if (strcasecmp(value, "sync") == 0) {
+          pa->reconf_mode = Adaptsize::RECONF_SYNC;
+        } else if (strcasecmp(value, "async") == 0) {
+          pa->reconf_mode = Adaptsize::RECONF_ASYNC;
+        } else if (strcasecmp(value, "deterministic") == 0) {
+          pa->reconf_mode = Adaptsize::RECONF_DETERMINISTIC;
+        } else {
+          ERROR(
+              "adaptsize reconf-mode must be sync, async or deterministic, "
+              "get %s\n",
+              value);
+          exit(1);
+        }
+      } else if (strcasecmp(key, "n-thread") == 0) {
+        pa->n_thread = (int)strtol(value, &end, 10);
+        if (pa->n_thread < 1) {
+          ERROR("adaptsize n-thread must be positive, get %s\n", value);
+          exit(1);
+        }
+      } else if (strcasecmp(key, "swap-delay") == 0) {
+        pa->swap_delay = strtoull(value, &end, 10);
       } else if (strcasecmp(key, "print") == 0) {
-        printf("max-iteration=%lu,reconf-interval=%lu", pa->max_iteration,
-               pa->reconf_interval);
+        static const char *mode_str[] = {"sync", "async", "deterministic"};
+        printf(
+            "max-iteration=%lu,reconf-interval=%lu,reconf-mode=%s,n-thread=%d,"
+            "swap-delay=%lu",
+            pa->max_iteration, pa->reconf_interval, mode_str[pa->reconf_mode],
+            pa->n_thread, pa->swap_delay);
         exit(0);
       } else {
         ERROR("adaptsize admission does not have parameter %s\n", key);
@@ -120,6 +151,15 @@ void free_adaptsize_admissioner(admissioner_t *admissioner) {
   adaptsize_admission_params_t *pa =
       (adaptsize_admission_params_t *)(admissioner->params);
 
+  const Adaptsize::reconf_stat &stat = pa->adaptsize.get_reconf_stat();
+  if (stat.n_reconf > 0) {
+    DEBUG(
+        "AdaptSize %lu reconfigurations, search %.2lf ms on average (max "
+        "%.2lf ms), request path blocked %.2lf ms in total\n",
+        (unsigned long)stat.n_reconf, stat.total_search_ms / stat.n_reconf,
+        stat.max_search_ms, stat.total_blocking_ms);
+  }
+
   // Explicitly call the destructor for the Adaptsize object
   pa->adaptsize.~Adaptsize();
 
@@ -141,6 +181,9 @@ admissioner_t *create_adaptsize_admissioner(const char *init_params) {
       sizeof(adaptsize_admission_params_t));
   pa->max_iteration = 0;
   pa->reconf_interval = 0;
+  pa->reconf_mode = Adaptsize::RECONF_SYNC;
+  pa->n_thread = 1;
+  pa->swap_delay = 0;
   // Don't initialize the Adaptsize object here, it will be properly initialized
   // later
 
@@ -153,7 +196,9 @@ admissioner_t *create_adaptsize_admissioner(const char *init_params) {
   memset(admissioner, 0, sizeof(admissioner_t));
 
   // Use placement new to construct the object in-place
-  new (&pa->adaptsize) Adaptsize(pa->max_iteration, pa->reconf_interval);
+  new (&pa->adaptsize)
+      Adaptsize(pa->max_iteration, pa->reconf_interval, pa->reconf_mode,
+                pa->n_thread, pa->swap_delay);
 
   admissioner->params = pa;
   admissioner->admit = adaptsize_admit;
@@ -162,7 +207,15 @@ admissioner_t *create_adaptsize_admissioner(const char *init_params) {
   admissioner->update = adaptsize_update_stats;
   if (init_params != NULL) admissioner->init_params = strdup(init_params);
 
-  strncpy(admissioner->admissioner_name, "AdaptSize", CACHE_NAME_LEN - 1);
+  if (pa->reconf_mode == Adaptsize::RECONF_ASYNC) {
+    strncpy(admissioner->admissioner_name, "AdaptSize-async",
+            CACHE_NAME_LEN - 1);
+  } else if (pa->reconf_mode == Adaptsize::RECONF_DETERMINISTIC) {
+    strncpy(admissioner->admissioner_name, "AdaptSize-deterministic",
+            CACHE_NAME_LEN - 1);
+  } else {
+    strncpy(admissioner->admissioner_name, "AdaptSize", CACHE_NAME_LEN - 1);
+  }
   admissioner->admissioner_name[CACHE_NAME_LEN - 1] = '\0';
   return admissioner;
 }
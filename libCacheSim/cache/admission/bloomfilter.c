@@ -1,42 +1,156 @@
 //
 // Created by Juncheng on 5/29/21.
 //
+// admit an object on its second request, objects seen once (one-hit
+// wonders) are not admitted
+//
+// by default the seen objects are tracked with n-generation blocked bloom
+// filters, each holds n-key objects, when the newest one is full the oldest
+// one is cleared and becomes the newest, so objects not seen for a while are
+// forgotten and the memory is bounded. mode=exact tracks every object ever
+// seen in a hash table
+//
 
 #include <glib.h>
+#include <math.h>
 #include <stdbool.h>
 
+#include "../../dataStructure/blockedBloom.h"
+#include "../../dataStructure/hash/hash.h"
 #include "../../include/libCacheSim/admissionAlgo.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define BF_MAX_N_GENERATION 8
+
 typedef struct bloomfilter_admission {
+  bool exact;
   GHashTable *seen_times;
+
+  int64_t n_key;
+  double fpr;
+  int n_generation;
+  /* generations[curr_gen] is the newest */
+  blocked_bloom_t *generations[BF_MAX_N_GENERATION];
+  int curr_gen;
 } bf_admission_params_t;
 
-bool bloomfilter_admit(admissioner_t *admissioner, const request_t *req) {
-  bf_admission_params_t *bf = admissioner->params;
+static bool bloomfilter_admit_exact(bf_admission_params_t *bf, const request_t *req) {
   gpointer key = GINT_TO_POINTER(req->obj_id);
-  gpointer n_times =
-      g_hash_table_lookup(bf->seen_times, GSIZE_TO_POINTER(req->obj_id));
+  gpointer n_times = g_hash_table_lookup(bf->seen_times, GSIZE_TO_POINTER(req->obj_id));
   if (n_times == NULL) {
     g_hash_table_insert(bf->seen_times, key, GINT_TO_POINTER(1));
     return false;
   } else {
-    g_hash_table_insert(bf->seen_times, key,
-                        GINT_TO_POINTER(GPOINTER_TO_INT(n_times) + 1));
+    g_hash_table_insert(bf->seen_times, key, GINT_TO_POINTER(GPOINTER_TO_INT(n_times) + 1));
     return true;
   }
 }
 
+bool bloomfilter_admit(admissioner_t *admissioner, const request_t *req) {
+  bf_admission_params_t *bf = admissioner->params;
+  if (bf->exact) {
+    return bloomfilter_admit_exact(bf, req);
+  }
+
+  obj_id_t obj_id = req->obj_id;
+  uint64_t hash = get_hash_value_int_64(&obj_id);
+
+  /* record the object in the newest generation so that it stays known */
+  blocked_bloom_t *curr = bf->generations[bf->curr_gen];
+  bool seen = !blocked_bloom_insert(curr, hash);
+  for (int i = 1; i < bf->n_generation && !seen; i++) {
+    int gen = (bf->curr_gen + i) % bf->n_generation;
+    seen = blocked_bloom_contains(bf->generations[gen], hash);
+  }
+
+  if (curr->n_insert >= bf->n_key) {
+    bf->curr_gen = (bf->curr_gen + 1) % bf->n_generation;
+    blocked_bloom_clear(bf->generations[bf->curr_gen]);
+  }
+
+  return seen;
+}
+
+static void bloomfilter_admissioner_parse_params(const char *init_params, bf_admission_params_t *bf) {
+  bf->exact = false;
+  bf->n_key = 1 << 22;
+  bf->fpr = 0.01;
+  bf->n_generation = 2;
+  if (init_params == NULL) {
+    return;
+  }
+
+  char *params_str = strdup(init_params);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "mode") == 0) {
+      if (strcasecmp(value, "exact") == 0) {
+        bf->exact = true;
+      } else if (strcasecmp(value, "bloom") == 0) {
+        bf->exact = false;
+      } else {
+        ERROR("bloomfilter admission mode must be bloom or exact, get %s\n", value);
+      }
+    } else if (strcasecmp(key, "n-key") == 0) {
+      bf->n_key = strtoll(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "fpr") == 0) {
+      bf->fpr = strtod(value, &end);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "n-generation") == 0) {
+      bf->n_generation = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else {
+      ERROR("bloomfilter admission does not have parameter %s\n", key);
+    }
+  }
+  free(old_params_str);
+
+  if (bf->n_key < 1) {
+    ERROR("bloomfilter admission n-key must be positive, get %ld\n", (long)bf->n_key);
+  }
+  if (bf->fpr <= 0 || bf->fpr >= 1) {
+    ERROR("bloomfilter admission fpr must be in (0, 1), get %lf\n", bf->fpr);
+  }
+  if (bf->n_generation < 1 || bf->n_generation > BF_MAX_N_GENERATION) {
+    ERROR("bloomfilter admission n-generation must be in [1, %d], get %d\n", BF_MAX_N_GENERATION,
+          bf->n_generation);
+  }
+}
+
 admissioner_t *clone_bloomfilter_admissioner(admissioner_t *admissioner) {
   return create_bloomfilter_admissioner(admissioner->init_params);
 }
 
 void free_bloomfilter_admissioner(admissioner_t *admissioner) {
   struct bloomfilter_admission *bf = admissioner->params;
-  g_hash_table_destroy(bf->seen_times);
+  if (bf->seen_times != NULL) {
+    g_hash_table_destroy(bf->seen_times);
+  }
+  for (int i = 0; i < bf->n_generation; i++) {
+    if (bf->generations[i] != NULL) blocked_bloom_free(bf->generations[i]);
+  }
   free(bf);
   if (admissioner->init_params) {
     free(admissioner->init_params);
@@ -45,26 +159,39 @@ void free_bloomfilter_admissioner(admissioner_t *admissioner) {
 }
 
 admissioner_t *create_bloomfilter_admissioner(const char *init_params) {
-  if (init_params != NULL) {
-    ERROR("bloomfilter admission does not take any parameters");
-  }
-
   admissioner_t *admissioner = (admissioner_t *)malloc(sizeof(admissioner_t));
   memset(admissioner, 0, sizeof(admissioner_t));
-  admissioner->init_params = NULL;
+  if (init_params != NULL) admissioner->init_params = strdup(init_params);
 
-  bf_admission_params_t *bf_params =
-      (bf_admission_params_t *)malloc(sizeof(bf_admission_params_t));
+  bf_admission_params_t *bf_params = (bf_admission_params_t *)malloc(sizeof(bf_admission_params_t));
   memset(bf_params, 0, sizeof(struct bloomfilter_admission));
-  bf_params->seen_times = g_hash_table_new(g_direct_hash, g_direct_equal);
+  bloomfilter_admissioner_parse_params(init_params, bf_params);
+
+  if (bf_params->exact) {
+    bf_params->seen_times = g_hash_table_new(g_direct_hash, g_direct_equal);
+    strncpy(admissioner->admissioner_name, "BloomFilter-exact", CACHE_NAME_LEN - 1);
+  } else {
+    /* an object is looked up in all generations, so the false positive
+     * rate of the union is split among them */
+    double gen_fpr = 1 - pow(1 - bf_params->fpr, 1.0 / bf_params->n_generation);
+    size_t n_byte = 0;
+    for (int i = 0; i < bf_params->n_generation; i++) {
+      bf_params->generations[i] = blocked_bloom_init(bf_params->n_key, gen_fpr);
+      n_byte += blocked_bloom_n_byte(bf_params->generations[i]);
+    }
+
+    double real_gen_fpr = blocked_bloom_expected_fpr(bf_params->generations[0]->n_block, bf_params->n_key);
+    double fpr = 1 - pow(1 - real_gen_fpr, bf_params->n_generation);
+    snprintf(admissioner->admissioner_name, CACHE_NAME_LEN, "BloomFilter-%dx%ldkey-fpr%.4lf-%.1lfMiB",
+             bf_params->n_generation, (long)bf_params->n_key, fpr, (double)n_byte / MiB);
+  }
+  admissioner->admissioner_name[CACHE_NAME_LEN - 1] = '\0';
 
   admissioner->params = bf_params;
   admissioner->clone = clone_bloomfilter_admissioner;
   admissioner->free = free_bloomfilter_admissioner;
   admissioner->admit = bloomfilter_admit;
 
-  strncpy(admissioner->admissioner_name, "BloomFilter", CACHE_NAME_LEN - 1);
-  admissioner->admissioner_name[CACHE_NAME_LEN - 1] = '\0';
   return admissioner;
 }
 
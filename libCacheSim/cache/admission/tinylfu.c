@@ -0,0 +1,118 @@
+//
+// frequency based admission, every request is recorded in a count-min
+// sketch, a missed object is admitted if its estimated frequency (including
+// the current request) reaches min-freq
+//
+// this is the TinyLFU filter without the comparison against an eviction
+// victim, which the admissioner interface does not expose, WTinyLFU uses the
+// same sketch for the full policy
+//
+
+#include "../../dataStructure/countMinSketch.h"
+#include "../../include/libCacheSim/admissionAlgo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tinylfu_admissioner {
+  count_min_sketch_t *sketch;
+  int min_freq;
+  int64_t n_obj;
+  bool use_doorkeeper;
+} tinylfu_admission_params_t;
+
+bool tinylfu_admit(admissioner_t *admissioner, const request_t *req) {
+  tinylfu_admission_params_t *pa = (tinylfu_admission_params_t *)admissioner->params;
+  return count_min_sketch_estimate(pa->sketch, req->obj_id) >= pa->min_freq;
+}
+
+void tinylfu_update(admissioner_t *admissioner, const request_t *req, const uint64_t cache_size) {
+  tinylfu_admission_params_t *pa = (tinylfu_admission_params_t *)admissioner->params;
+  count_min_sketch_increment(pa->sketch, req->obj_id);
+}
+
+static void tinylfu_admissioner_parse_params(const char *init_params, tinylfu_admission_params_t *pa) {
+  pa->min_freq = 2;
+  pa->n_obj = 1 << 20;
+  pa->use_doorkeeper = true;
+  if (init_params == NULL) {
+    return;
+  }
+
+  char *params_str = strdup(init_params);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "min-freq") == 0) {
+      pa->min_freq = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "n-obj") == 0) {
+      pa->n_obj = strtoll(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "doorkeeper") == 0) {
+      pa->use_doorkeeper = strtol(value, NULL, 0) != 0;
+    } else {
+      ERROR("tinylfu admission does not have parameter %s\n", key);
+    }
+  }
+  free(old_params_str);
+
+  if (pa->min_freq < 1 || pa->min_freq > CMS_MAX_COUNT + 1) {
+    ERROR("tinylfu admission min-freq must be in [1, %d], get %d\n", CMS_MAX_COUNT + 1, pa->min_freq);
+  }
+}
+
+admissioner_t *clone_tinylfu_admissioner(admissioner_t *admissioner) {
+  return create_tinylfu_admissioner(admissioner->init_params);
+}
+
+void free_tinylfu_admissioner(admissioner_t *admissioner) {
+  tinylfu_admission_params_t *pa = admissioner->params;
+
+  count_min_sketch_free(pa->sketch);
+  free(pa);
+  if (admissioner->init_params) {
+    free(admissioner->init_params);
+  }
+  free(admissioner);
+}
+
+admissioner_t *create_tinylfu_admissioner(const char *init_params) {
+  tinylfu_admission_params_t *pa = (tinylfu_admission_params_t *)malloc(sizeof(tinylfu_admission_params_t));
+  memset(pa, 0, sizeof(tinylfu_admission_params_t));
+  tinylfu_admissioner_parse_params(init_params, pa);
+  pa->sketch = count_min_sketch_init(pa->n_obj, pa->use_doorkeeper);
+
+  admissioner_t *admissioner = (admissioner_t *)malloc(sizeof(admissioner_t));
+  memset(admissioner, 0, sizeof(admissioner_t));
+  admissioner->params = pa;
+  admissioner->admit = tinylfu_admit;
+  admissioner->update = tinylfu_update;
+  admissioner->free = free_tinylfu_admissioner;
+  admissioner->clone = clone_tinylfu_admissioner;
+  if (init_params != NULL) admissioner->init_params = strdup(init_params);
+
+  strncpy(admissioner->admissioner_name, "TinyLFU", CACHE_NAME_LEN - 1);
+  admissioner->admissioner_name[CACHE_NAME_LEN - 1] = '\0';
+  return admissioner;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,7 @@
 
 #include "../dataStructure/hashtable/hashtable.h"
 #include "../include/libCacheSim/prefetchAlgo.h"
+#include "../dataStructure/ttlWheel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,6 +66,10 @@ cache_t *cache_struct_init(const char *const cache_name, const common_cache_para
   hashtable_add_ptr_to_monitoring(cache->hashtable, &cache->q_head);
   hashtable_add_ptr_to_monitoring(cache->hashtable, &cache->q_tail);
 
+#ifdef SUPPORT_TTL
+  cache->ttl_wheel = ttl_wheel_init();
+#endif
+
   return cache;
 }
 
@@ -74,6 +79,9 @@ cache_t *cache_struct_init(const char *const cache_name, const common_cache_para
  * @param cache
  */
 void cache_struct_free(cache_t *cache) {
+#ifdef SUPPORT_TTL
+  ttl_wheel_free(cache->ttl_wheel);
+#endif
   free_hashtable(cache->hashtable);
   if (cache->admissioner != NULL) cache->admissioner->free(cache->admissioner);
   if (cache->prefetcher != NULL) cache->prefetcher->free(cache->prefetcher);
@@ -185,10 +193,12 @@ cache_obj_t *cache_find_base(cache_t *cache, const request_t *req, const bool up
 #ifdef SUPPORT_TTL
     if (cache_obj->exp_time != 0 && cache_obj->exp_time < req->clock_time) {
       if (update_cache) {
+        cache->n_expired_obj += 1;
+        cache->n_expired_byte += cache_obj->obj_size;
         cache->remove(cache, cache_obj->obj_id);
       }
 
-      cache_obj = NULL;
+      return NULL;
     }
 #endif
 
@@ -223,6 +233,10 @@ cache_obj_t *cache_find_base(cache_t *cache, const request_t *req, const bool up
 bool cache_get_base(cache_t *cache, const request_t *req) {
   cache->n_req += 1;
 
+#ifdef SUPPORT_TTL
+  cache_expire(cache, req->clock_time);
+#endif
+
   VERBOSE("******* %s req %ld, obj %ld, obj_size %ld, cache size %ld/%ld\n", cache->cache_name, cache->n_req,
           req->obj_id, req->obj_size, cache->get_occupied_byte(cache), cache->cache_size);
 
@@ -270,6 +284,9 @@ cache_obj_t *cache_insert_base(cache_t *cache, const request_t *req) {
   if (cache->default_ttl != 0 && req->ttl == 0) {
     cache_obj->exp_time = (int32_t)cache->default_ttl + req->clock_time;
   }
+  if (cache_obj->exp_time != 0) {
+    ttl_wheel_insert(cache->ttl_wheel, cache_obj);
+  }
 #endif
 
 #if defined(TRACK_EVICTION_V_AGE) || defined(TRACK_DEMOTION) || defined(TRACK_CREATE_TIME)
@@ -296,14 +313,13 @@ void cache_evict_base(cache_t *cache, cache_obj_t *obj, bool remove_from_hashtab
     record_eviction_age(cache, obj, CURR_TIME(cache, req) - obj->create_time);
   }
 #endif
+  if (cache->evict_listener) {
+    cache->evict_listener(cache, obj, cache->evict_listener_data);
+  }
   if (cache->prefetcher && cache->prefetcher->handle_evict) {
-    request_t *check_req = new_request();
-    check_req->obj_id = obj->obj_id;
-    check_req->obj_size = obj->obj_size;
-    // check_req->ttl = 0; // re-add objects should be?
+    evicted_obj_t evicted = {.obj_id = obj->obj_id, .obj_size = obj->obj_size};
     cache_remove_obj_base(cache, obj, remove_from_hashtable);
-    cache->prefetcher->handle_evict(cache, check_req);
-    my_free(sizeof(request_t), check_req);
+    cache->prefetcher->handle_evict(cache, &evicted);
     return;
   }
 
@@ -323,11 +339,29 @@ void cache_remove_obj_base(cache_t *cache, cache_obj_t *obj, bool remove_from_ha
   DEBUG_ASSERT(cache->occupied_byte >= obj->obj_size + cache->obj_md_size);
   cache->occupied_byte -= (obj->obj_size + cache->obj_md_size);
   cache->n_obj -= 1;
+#ifdef SUPPORT_TTL
+  ttl_wheel_remove(cache->ttl_wheel, obj);
+#endif
   if (remove_from_hashtable) {
     hashtable_delete(cache->hashtable, obj);
   }
 }
 
+#ifdef SUPPORT_TTL
+void cache_expire(cache_t *cache, int64_t now) {
+  if (cache->remove == NULL) return;
+
+  cache_obj_t *obj;
+  while ((obj = ttl_wheel_pop_expired(cache->ttl_wheel, now)) != NULL) {
+    cache->n_expired_obj += 1;
+    cache->n_expired_byte += obj->obj_size;
+    /* the algorithm removes the object from its own metadata and calls
+     * cache_remove_obj_base */
+    cache->remove(cache, obj->obj_id);
+  }
+}
+#endif
+
 /**
  * @brief print the recorded eviction age
  *
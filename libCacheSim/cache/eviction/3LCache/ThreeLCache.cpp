@@ -10,37 +10,59 @@ using namespace std;
 using namespace ThreeLCache;
 
 void ThreeLCacheCache::train() {
+  double time_ms;
+  BoosterHandle new_booster = fit(training_data, training_params, &time_ms);
+  install_model(new_booster, time_ms);
+}
+
+BoosterHandle ThreeLCacheCache::fit(TrainingData *data,
+                                    unordered_map<string, string> params,
+                                    double *time_ms) {
   auto timeBegin = chrono::system_clock::now();
-  if (booster) LGBM_BoosterFree(booster);
+  BoosterHandle new_booster = nullptr;
   DatasetHandle trainData;
   std::string params_str;
-  for (const auto &pair : training_params) {
+  for (const auto &pair : params) {
     params_str += pair.first + "=" + pair.second + " ";
   }
   params_str.pop_back();  // Remove trailing space
 
   // Convert to C-style string (const char *)
   const char *training_params_cstr = params_str.c_str();
-  LGBM_DatasetCreateFromCSR(static_cast<void *>(training_data->indptr.data()),
-                            C_API_DTYPE_INT32, training_data->indices.data(),
-                            static_cast<void *>(training_data->data.data()),
-                            C_API_DTYPE_FLOAT64, training_data->indptr.size(),
-                            training_data->data.size(), n_feature,
-                            training_params_cstr, nullptr, &trainData);
+  LGBM_DatasetCreateFromCSR(static_cast<void *>(data->indptr.data()),
+                            C_API_DTYPE_INT32, data->indices.data(),
+                            static_cast<void *>(data->data.data()),
+                            C_API_DTYPE_FLOAT64, data->indptr.size(),
+                            data->data.size(), n_feature, training_params_cstr,
+                            nullptr, &trainData);
 
   LGBM_DatasetSetField(trainData, "label",
-                       static_cast<void *>(training_data->labels.data()),
-                       training_data->labels.size(), C_API_DTYPE_FLOAT32);
-  LGBM_BoosterCreate(trainData, training_params_cstr, &booster);
-  for (int i = 0; i < stoi(training_params["num_iterations"]); i++) {
+                       static_cast<void *>(data->labels.data()),
+                       data->labels.size(), C_API_DTYPE_FLOAT32);
+  LGBM_BoosterCreate(trainData, training_params_cstr, &new_booster);
+  for (int i = 0; i < stoi(params["num_iterations"]); i++) {
     int isFinished;
-    LGBM_BoosterUpdateOneIter(booster, &isFinished);
+    LGBM_BoosterUpdateOneIter(new_booster, &isFinished);
     if (isFinished) {
       break;
     }
   }
   LGBM_DatasetFree(trainData);
 
+  *time_ms = chrono::duration_cast<chrono::milliseconds>(
+                 chrono::system_clock::now() - timeBegin)
+                 .count();
+  return new_booster;
+}
+
+void ThreeLCacheCache::install_model(BoosterHandle new_booster,
+                                     double time_ms) {
+  if (booster) LGBM_BoosterFree(booster);
+  booster = new_booster;
+  ++n_installed_model;
+  training_time = 0.95 * training_time + 0.05 * time_ms;
+
+  // the cached predictions come from the old model
   pred_map.clear();
   pred_times.clear();
   pred_times.shrink_to_fit();
@@ -58,6 +80,46 @@ void ThreeLCacheCache::train() {
   }
 }
 
+void ThreeLCacheCache::on_batch_full() {
+  if (training_mode == sync_training) {
+    train();
+    training_data->clear();
+    return;
+  }
+
+  // one batch is trained at a time, if the next batch fills up before the
+  // previous model is swapped in, wait for it
+  if (trainer.joinable()) swap_model();
+
+  // keep filling the other buffer while the worker trains on this one
+  std::swap(training_data, pending_data);
+  training_data->clear();
+  train_start_seq = current_seq;
+  model_ready.store(false, memory_order_relaxed);
+  trainer = thread([this, params = training_params]() {
+    next_booster = fit(pending_data, params, &next_training_time);
+    model_ready.store(true, memory_order_release);
+  });
+}
+
+void ThreeLCacheCache::poll_model() {
+  if (training_mode == deterministic_training) {
+    if (current_seq - train_start_seq >= swap_delay) swap_model();
+  } else if (model_ready.load(memory_order_acquire)) {
+    swap_model();
+  }
+}
+
+void ThreeLCacheCache::swap_model() {
+  auto waitBegin = chrono::system_clock::now();
+  trainer.join();
+  training_wait_time += chrono::duration_cast<chrono::milliseconds>(
+                            chrono::system_clock::now() - waitBegin)
+                            .count();
+  install_model(next_booster, next_training_time);
+  next_booster = nullptr;
+}
+
 void ThreeLCacheCache::sample() {
   auto rand_idx = _distribution(_generator);
   int32_t pos = rand_idx % (in_cache.metas.size() + out_cache.metas.size());
@@ -72,6 +134,7 @@ void ThreeLCacheCache::update_stat_periodic() {}
 bool ThreeLCacheCache::lookup(const SimpleRequest &req) {
   bool ret;
   ++current_seq;
+  if (trainer.joinable()) poll_model();
   if (is_full == 1) n_req++;
   auto it = key_map.find(req.id);
   if (it != key_map.end()) {
@@ -91,8 +154,7 @@ bool ThreeLCacheCache::lookup(const SimpleRequest &req) {
       training_data->emplace_back(meta, sample_time, future_distance,
                                   meta._key);
       if (training_data->labels.size() >= batch_size && evict_nums <= 0) {
-        train();
-        training_data->clear();
+        on_batch_full();
       }
       meta._sample_times = 0;
     } else {
@@ -140,8 +202,7 @@ void ThreeLCacheCache::erase_out_cache() {
                                     meta._key);
 
         if (training_data->labels.size() >= batch_size && evict_nums <= 0) {
-          train();
-          training_data->clear();
+          on_batch_full();
         }
       }
       key_map.erase(meta._key);
@@ -283,7 +344,7 @@ int32_t ThreeLCacheCache::rank() {
 
 vector<int32_t> ThreeLCacheCache::quick_demotion() {
   vector<int32_t> sampled_objects;
-  int i, j = 0;
+  int i = 0, j = 0;
   while (new_obj_size > (uint64_t)(_currentSize * reserved_space / 100) &&
          j < (int)(sample_rate * 1.5) && (size_t)i < new_obj_keys.size()) {
     auto it = key_map.find(new_obj_keys[i])->second;
@@ -4,12 +4,14 @@
 #include <LightGBM/c_api.h>
 #include <assert.h>
 
+#include <atomic>
 #include <cmath>
 #include <deque>
 #include <fstream>
 #include <list>
 #include <random>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -262,7 +264,28 @@ class ThreeLCacheCache : public Cache {
   CacheUpdateQueue in_cache;
   CacheUpdateQueue out_cache;
 
-  TrainingData *training_data;
+  TrainingData *training_data = nullptr;
+
+  // sync trains on the request path, async and deterministic train on a
+  // worker thread while the current model keeps serving, see LRB
+  enum TrainingModeT : uint8_t {
+    sync_training = 0,
+    async_training = 1,
+    deterministic_training = 2
+  };
+  TrainingModeT training_mode = sync_training;
+  uint64_t swap_delay = batch_size;
+  TrainingData *pending_data = nullptr;
+  thread trainer;
+  atomic<bool> model_ready{false};
+  // written by the worker, read after it is joined
+  BoosterHandle next_booster = nullptr;
+  double next_training_time = 0;
+  uint64_t train_start_seq = 0;
+  // the number of models swapped in, in every training mode
+  int n_installed_model = 0;
+  // time (ms) the request path waited for the worker
+  double training_wait_time = 0;
 
   double training_loss = 0;
   int32_t n_force_eviction = 0;
@@ -307,6 +330,19 @@ class ThreeLCacheCache : public Cache {
         byte_million_req = stoull(it.second);
       } else if (it.first == "sample_rate") {
         sample_rate = stoull(it.second);
+      } else if (it.first == "training") {
+        if (it.second == "sync")
+          training_mode = sync_training;
+        else if (it.second == "async")
+          training_mode = async_training;
+        else if (it.second == "deterministic")
+          training_mode = deterministic_training;
+        else {
+          cerr << "error: unknown training mode " << it.second << endl;
+          exit(-1);
+        }
+      } else if (it.first == "swap_delay") {
+        swap_delay = stoull(it.second);
       } else if (it.first == "objective") {
         if (it.second == "byte-miss-ratio")
           objective = byte_miss_ratio;
@@ -327,6 +363,17 @@ class ThreeLCacheCache : public Cache {
     n_feature = max_n_past_timestamps + 2;
     inference_params = training_params;
     training_data = new TrainingData(n_feature);
+    if (training_mode != sync_training) {
+      pending_data = new TrainingData(n_feature);
+    }
+  }
+
+  ~ThreeLCacheCache() override {
+    if (trainer.joinable()) trainer.join();
+    if (next_booster) LGBM_BoosterFree(next_booster);
+    if (booster) LGBM_BoosterFree(booster);
+    delete training_data;
+    delete pending_data;
   }
 
   bool lookup(const SimpleRequest &req) override;
@@ -347,6 +394,22 @@ class ThreeLCacheCache : public Cache {
 
   void train();
 
+  // train a booster on one batch, it only reads data and params so that it
+  // can run on the training thread
+  BoosterHandle fit(TrainingData *data, unordered_map<string, string> params,
+                    double *time_ms);
+
+  void install_model(BoosterHandle new_booster, double time_ms);
+
+  // called when training_data reaches batch_size
+  void on_batch_full();
+
+  // swap in the model trained on the worker if it is due
+  void poll_model();
+
+  // wait for the worker and swap in its model
+  void swap_model();
+
   void prediction(vector<int32_t> sampled_objects);
 
   void sample();
@@ -17,7 +17,9 @@
 
 #include <string.h>
 
+#include "../../dataStructure/ghostHistory.h"
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/checkpoint.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -37,13 +39,11 @@ typedef struct ARC_params {
 
   cache_obj_t *L1_data_head;
   cache_obj_t *L1_data_tail;
-  cache_obj_t *L1_ghost_head;
-  cache_obj_t *L1_ghost_tail;
+  ghost_history_t *L1_ghost;
 
   cache_obj_t *L2_data_head;
   cache_obj_t *L2_data_tail;
-  cache_obj_t *L2_ghost_head;
-  cache_obj_t *L2_ghost_tail;
+  ghost_history_t *L2_ghost;
 
   double p;
   bool curr_obj_in_L1_ghost;
@@ -67,6 +67,8 @@ static cache_obj_t *ARC_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *ARC_to_evict(cache_t *cache, const request_t *req);
 static void ARC_evict(cache_t *cache, const request_t *req);
 static bool ARC_remove(cache_t *cache, const obj_id_t obj_id);
+static bool ARC_serialize(const cache_t *cache, FILE *f);
+static bool ARC_deserialize(cache_t *cache, FILE *f);
 
 /* internal functions */
 /* this is the case IV in the paper */
@@ -111,6 +113,8 @@ cache_t *ARC_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->get_n_obj = cache_get_n_obj_default;
+  cache->serialize = ARC_serialize;
+  cache->deserialize = ARC_deserialize;
 
   if (ccache_params.consider_obj_metadata) {
     // two pointer + ghost metadata
@@ -129,12 +133,10 @@ cache_t *ARC_init(const common_cache_params_t ccache_params,
   params->L2_ghost_size = 0;
   params->L1_data_head = NULL;
   params->L1_data_tail = NULL;
-  params->L1_ghost_head = NULL;
-  params->L1_ghost_tail = NULL;
+  params->L1_ghost = ghost_history_init(1024);
   params->L2_data_head = NULL;
   params->L2_data_tail = NULL;
-  params->L2_ghost_head = NULL;
-  params->L2_ghost_tail = NULL;
+  params->L2_ghost = ghost_history_init(1024);
 
   params->curr_obj_in_L1_ghost = false;
   params->curr_obj_in_L2_ghost = false;
@@ -156,6 +158,8 @@ cache_t *ARC_init(const common_cache_params_t ccache_params,
 static void ARC_free(cache_t *cache) {
   ARC_params_t *ARC_params = (ARC_params_t *)(cache->eviction_params);
   free_request(ARC_params->req_local);
+  ghost_history_free(ARC_params->L1_ghost);
+  ghost_history_free(ARC_params->L2_ghost);
   my_free(sizeof(ARC_params_t), ARC_params);
   cache_struct_free(cache);
 }
@@ -223,46 +227,51 @@ static cache_obj_t *ARC_find(cache_t *cache, const request_t *req,
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
 
   if (!update_cache) {
-    return obj->ARC.ghost ? NULL : obj;
+    return obj;
   }
 
+  int64_t ghost_size = 0;
   if (obj == NULL) {
-    return NULL;
+    /* ghost entries are not in the hash table */
+    if (ghost_history_remove(params->L1_ghost, req->obj_id, &ghost_size,
+                             NULL)) {
+      params->curr_obj_in_L1_ghost = true;
+      params->curr_obj_in_L2_ghost = false;
+    } else if (ghost_history_remove(params->L2_ghost, req->obj_id,
+                                    &ghost_size, NULL)) {
+      params->curr_obj_in_L1_ghost = false;
+      params->curr_obj_in_L2_ghost = true;
+    } else {
+      return NULL;
+    }
+  } else {
+    params->curr_obj_in_L1_ghost = false;
+    params->curr_obj_in_L2_ghost = false;
   }
 
-  params->curr_obj_in_L1_ghost = false;
-  params->curr_obj_in_L2_ghost = false;
-
-  int lru_id = obj->ARC.lru_id;
   cache_obj_t *ret = obj;
 
-  if (obj->ARC.ghost) {
+  if (obj == NULL) {
     // ghost hit
-    ret = NULL;
     params->vtime_last_req_in_ghost = cache->n_req;
     // cache miss, but hit on thost
-    if (obj->ARC.lru_id == 1) {
-      params->curr_obj_in_L1_ghost = true;
+    if (params->curr_obj_in_L1_ghost) {
       // case II: x in L1_ghost
       DEBUG_ASSERT(params->L1_ghost_size >= 1);
       double delta =
           MAX((double)params->L2_ghost_size / params->L1_ghost_size, 1);
       params->p = MIN(params->p + delta, cache->cache_size);
-      params->L1_ghost_size -= obj->obj_size + cache->obj_md_size;
-      remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
+      params->L1_ghost_size -= ghost_size;
     } else {
-      params->curr_obj_in_L2_ghost = true;
       // case III: x in L2_ghost
       DEBUG_ASSERT(params->L2_ghost_size >= 1);
       double delta =
           MAX((double)params->L1_ghost_size / params->L2_ghost_size, 1);
       params->p = MAX(params->p - delta, 0);
-      params->L2_ghost_size -= obj->obj_size + cache->obj_md_size;
-      remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
+      params->L2_ghost_size -= ghost_size;
     }
-
-    hashtable_delete(cache->hashtable, obj);
   } else {
+    int lru_id = obj->ARC.lru_id;
     // cache hit, case I: x in L1_data or L2_data
 #ifdef USE_BELADY
     if (obj->next_access_vtime == INT64_MAX) {
@@ -389,27 +398,26 @@ static bool ARC_remove(cache_t *cache, const obj_id_t obj_id) {
   cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
 
   if (obj == NULL) {
+    int64_t ghost_size;
+    if (ghost_history_remove(params->L1_ghost, obj_id, &ghost_size, NULL)) {
+      params->L1_ghost_size -= ghost_size;
+      return true;
+    }
+    if (ghost_history_remove(params->L2_ghost, obj_id, &ghost_size, NULL)) {
+      params->L2_ghost_size -= ghost_size;
+      return true;
+    }
     return false;
   }
 
-  if (obj->ARC.ghost) {
-    if (obj->ARC.lru_id == 1) {
-      params->L1_ghost_size -= obj->obj_size + cache->obj_md_size;
-      remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
-    } else {
-      params->L2_ghost_size -= obj->obj_size + cache->obj_md_size;
-      remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
-    }
+  if (obj->ARC.lru_id == 1) {
+    params->L1_data_size -= obj->obj_size + cache->obj_md_size;
+    remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
   } else {
-    if (obj->ARC.lru_id == 1) {
-      params->L1_data_size -= obj->obj_size + cache->obj_md_size;
-      remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
-    } else {
-      params->L2_data_size -= obj->obj_size + cache->obj_md_size;
-      remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
-    }
-    cache_remove_obj_base(cache, obj, true);
+    params->L2_data_size -= obj->obj_size + cache->obj_md_size;
+    remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
   }
+  cache_remove_obj_base(cache, obj, true);
 
   return true;
 }
@@ -453,13 +461,13 @@ static void _ARC_evict_L1_data(cache_t *cache, const request_t *req) {
          obj->misc.next_access_vtime);
 #endif
 
-  cache_evict_base(cache, obj, false);
-
-  params->L1_data_size -= obj->obj_size + cache->obj_md_size;
-  params->L1_ghost_size += obj->obj_size + cache->obj_md_size;
+  int64_t sz = obj->obj_size + cache->obj_md_size;
+  params->L1_data_size -= sz;
+  params->L1_ghost_size += sz;
   remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
-  prepend_obj_to_head(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
-  obj->ARC.ghost = true;
+  ghost_history_insert(params->L1_ghost, obj->obj_id, sz, 0);
+
+  cache_evict_base(cache, obj, true);
 }
 
 static void _ARC_evict_L1_data_no_ghost(cache_t *cache, const request_t *req) {
@@ -483,36 +491,29 @@ static void _ARC_evict_L2_data(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = params->L2_data_tail;
   DEBUG_ASSERT(obj != NULL);
 
-  params->L2_data_size -= obj->obj_size + cache->obj_md_size;
-  params->L2_ghost_size += obj->obj_size + cache->obj_md_size;
+  int64_t sz = obj->obj_size + cache->obj_md_size;
+  params->L2_data_size -= sz;
+  params->L2_ghost_size += sz;
   remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
-  prepend_obj_to_head(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
-
-  obj->ARC.ghost = true;
+  ghost_history_insert(params->L2_ghost, obj->obj_id, sz, 0);
 
-  cache_evict_base(cache, obj, false);
+  cache_evict_base(cache, obj, true);
 }
 
 static void _ARC_evict_L1_ghost(cache_t *cache, const request_t *req) {
   ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
-  cache_obj_t *obj = params->L1_ghost_tail;
-  DEBUG_ASSERT(obj != NULL);
-  DEBUG_ASSERT(obj->ARC.ghost);
-  int64_t sz = obj->obj_size + cache->obj_md_size;
+  int64_t sz = 0;
+  bool popped = ghost_history_pop_oldest(params->L1_ghost, &sz, NULL);
+  DEBUG_ASSERT(popped);
   params->L1_ghost_size -= sz;
-  remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
-  hashtable_delete(cache->hashtable, obj);
 }
 
 static void _ARC_evict_L2_ghost(cache_t *cache, const request_t *req) {
   ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
-  cache_obj_t *obj = params->L2_ghost_tail;
-  DEBUG_ASSERT(obj != NULL);
-  DEBUG_ASSERT(obj->ARC.ghost);
-  int64_t sz = obj->obj_size + cache->obj_md_size;
+  int64_t sz = 0;
+  bool popped = ghost_history_pop_oldest(params->L2_ghost, &sz, NULL);
+  DEBUG_ASSERT(popped);
   params->L2_ghost_size -= sz;
-  remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
-  hashtable_delete(cache->hashtable, obj);
 }
 
 /* the REPLACE function in the paper */
@@ -654,13 +655,7 @@ static void print_cache(cache_t *cache) {
   }
   printf("\n");
 
-  obj = params->L1_ghost_head;
-  printf("B1: ");
-  while (obj != NULL) {
-    printf("%ld ", (long)obj->obj_id);
-    obj = obj->queue.next;
-  }
-  printf("\n");
+  printf("B1: %ld entries\n", (long)params->L1_ghost->n_entry);
 
   obj = params->L2_data_head;
   printf("T2: ");
@@ -670,13 +665,7 @@ static void print_cache(cache_t *cache) {
   }
   printf("\n");
 
-  obj = params->L2_ghost_head;
-  printf("B2: ");
-  while (obj != NULL) {
-    printf("%ld ", (long)obj->obj_id);
-    obj = obj->queue.next;
-  }
-  printf("\n");
+  printf("B2: %ld entries\n", (long)params->L2_ghost->n_entry);
 }
 
 static void _ARC_sanity_check(cache_t *cache, const request_t *req) {
@@ -691,18 +680,12 @@ static void _ARC_sanity_check(cache_t *cache, const request_t *req) {
     DEBUG_ASSERT(params->L1_data_head != NULL);
     DEBUG_ASSERT(params->L1_data_tail != NULL);
   }
-  if (params->L1_ghost_size > 0) {
-    DEBUG_ASSERT(params->L1_ghost_head != NULL);
-    DEBUG_ASSERT(params->L1_ghost_tail != NULL);
-  }
+  DEBUG_ASSERT(params->L1_ghost_size == params->L1_ghost->n_byte);
   if (params->L2_data_size > 0) {
     DEBUG_ASSERT(params->L2_data_head != NULL);
     DEBUG_ASSERT(params->L2_data_tail != NULL);
   }
-  if (params->L2_ghost_size > 0) {
-    DEBUG_ASSERT(params->L2_ghost_head != NULL);
-    DEBUG_ASSERT(params->L2_ghost_tail != NULL);
-  }
+  DEBUG_ASSERT(params->L2_ghost_size == params->L2_ghost->n_byte);
 
   DEBUG_ASSERT(params->L1_data_size + params->L2_data_size ==
                cache->occupied_byte);
@@ -721,13 +704,11 @@ static inline void _ARC_sanity_check_full(cache_t *cache,
   ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
 
   int64_t L1_data_byte = 0, L2_data_byte = 0;
-  int64_t L1_ghost_byte = 0, L2_ghost_byte = 0;
 
   cache_obj_t *obj = params->L1_data_head;
   cache_obj_t *last_obj = NULL;
   while (obj != NULL) {
     DEBUG_ASSERT(obj->ARC.lru_id == 1);
-    DEBUG_ASSERT(!obj->ARC.ghost);
     L1_data_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
@@ -735,41 +716,16 @@ static inline void _ARC_sanity_check_full(cache_t *cache,
   DEBUG_ASSERT(L1_data_byte == params->L1_data_size);
   DEBUG_ASSERT(last_obj == params->L1_data_tail);
 
-  obj = params->L1_ghost_head;
-  last_obj = NULL;
-  while (obj != NULL) {
-    DEBUG_ASSERT(obj->ARC.lru_id == 1);
-    DEBUG_ASSERT(obj->ARC.ghost);
-    L1_ghost_byte += obj->obj_size;
-    last_obj = obj;
-    obj = obj->queue.next;
-  }
-  DEBUG_ASSERT(L1_ghost_byte == params->L1_ghost_size);
-  DEBUG_ASSERT(last_obj == params->L1_ghost_tail);
-
   obj = params->L2_data_head;
   last_obj = NULL;
   while (obj != NULL) {
     DEBUG_ASSERT(obj->ARC.lru_id == 2);
-    DEBUG_ASSERT(!obj->ARC.ghost);
     L2_data_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
   }
   DEBUG_ASSERT(L2_data_byte == params->L2_data_size);
   DEBUG_ASSERT(last_obj == params->L2_data_tail);
-
-  obj = params->L2_ghost_head;
-  last_obj = NULL;
-  while (obj != NULL) {
-    DEBUG_ASSERT(obj->ARC.lru_id == 2);
-    DEBUG_ASSERT(obj->ARC.ghost);
-    L2_ghost_byte += obj->obj_size;
-    last_obj = obj;
-    obj = obj->queue.next;
-  }
-  DEBUG_ASSERT(L2_ghost_byte == params->L2_ghost_size);
-  DEBUG_ASSERT(last_obj == params->L2_ghost_tail);
 }
 
 static bool ARC_get_debug(cache_t *cache, const request_t *req) {
@@ -803,6 +759,85 @@ static bool ARC_get_debug(cache_t *cache, const request_t *req) {
   return false;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     checkpoint functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+static bool ARC_serialize_list(FILE *f, const cache_obj_t *tail) {
+  int64_t n_obj = 0;
+  for (const cache_obj_t *obj = tail; obj != NULL; obj = obj->queue.prev) {
+    n_obj += 1;
+  }
+  if (!checkpoint_write(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (const cache_obj_t *obj = tail; obj != NULL; obj = obj->queue.prev) {
+    if (!checkpoint_write_obj(f, obj, 0)) return false;
+  }
+  return true;
+}
+
+static bool ARC_deserialize_list(cache_t *cache, FILE *f, cache_obj_t **head,
+                                 cache_obj_t **tail, int lru_id,
+                                 int64_t *data_size) {
+  int64_t n_obj;
+  if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (int64_t i = 0; i < n_obj; i++) {
+    cache_obj_t *obj = checkpoint_read_obj(cache, f, NULL);
+    if (obj == NULL) return false;
+    prepend_obj_to_head(head, tail, obj);
+    obj->ARC.lru_id = lru_id;
+    *data_size += obj->obj_size + cache->obj_md_size;
+  }
+  return true;
+}
+
+/**
+ * @brief write T1 and T2 from the least to the most recently used object,
+ * the ghosts B1 and B2, and p, see checkpoint.h
+ */
+static bool ARC_serialize(const cache_t *cache, FILE *f) {
+  ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
+  int64_t state[3] = {params->L1_ghost_size, params->L2_ghost_size,
+                      params->vtime_last_req_in_ghost};
+  bool in_ghost[2] = {params->curr_obj_in_L1_ghost,
+                      params->curr_obj_in_L2_ghost};
+
+  return checkpoint_write(f, &params->p, sizeof(params->p)) &&
+         checkpoint_write(f, state, sizeof(state)) &&
+         checkpoint_write(f, in_ghost, sizeof(in_ghost)) &&
+         ARC_serialize_list(f, params->L1_data_tail) &&
+         ARC_serialize_list(f, params->L2_data_tail) &&
+         ghost_history_save(params->L1_ghost, f) &&
+         ghost_history_save(params->L2_ghost, f);
+}
+
+static bool ARC_deserialize(cache_t *cache, FILE *f) {
+  ARC_params_t *params = (ARC_params_t *)(cache->eviction_params);
+  int64_t state[3];
+  bool in_ghost[2];
+  if (!checkpoint_read(f, &params->p, sizeof(params->p)) ||
+      !checkpoint_read(f, state, sizeof(state)) ||
+      !checkpoint_read(f, in_ghost, sizeof(in_ghost))) {
+    return false;
+  }
+  params->L1_ghost_size = state[0];
+  params->L2_ghost_size = state[1];
+  params->vtime_last_req_in_ghost = state[2];
+  params->curr_obj_in_L1_ghost = in_ghost[0];
+  params->curr_obj_in_L2_ghost = in_ghost[1];
+
+  return ARC_deserialize_list(cache, f, &params->L1_data_head,
+                              &params->L1_data_tail, 1,
+                              &params->L1_data_size) &&
+         ARC_deserialize_list(cache, f, &params->L2_data_head,
+                              &params->L2_data_tail, 2,
+                              &params->L2_data_size) &&
+         ghost_history_load(params->L1_ghost, f) &&
+         ghost_history_load(params->L2_ghost, f);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -101,6 +101,7 @@ cache_t *ARCv0_init(const common_cache_params_t ccache_params,
   cache->evict = ARCv0_evict;
   cache->remove = ARCv0_remove;
   cache->to_evict = ARCv0_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = ARCv0_get_occupied_byte;
   cache->get_n_obj = ARCv0_get_n_obj;
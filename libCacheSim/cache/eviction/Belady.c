@@ -10,6 +10,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../dataStructure/nextAccessWheel.h"
 #include "../../dataStructure/pqueue.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -17,9 +18,22 @@
 extern "C" {
 #endif
 
+static const char *DEFAULT_PARAMS = "engine=wheel,bucket-shift=5";
+
+typedef enum {
+  /* binary heap of per-object nodes, O(log n) per request */
+  BELADY_ENGINE_PQ,
+  /* time wheel keyed by next access vtime, O(1) amortized per request */
+  BELADY_ENGINE_WHEEL,
+} Belady_engine_e;
+
 typedef struct Belady_params {
+  Belady_engine_e engine;
+  int bucket_shift;
   /* a priority queue recording the next access time */
   pqueue_t *pq;
+  /* or a time wheel bucketing objects by next access time */
+  next_access_wheel_t *wheel;
 } Belady_params_t;
 
 // #define EVICT_IMMEDIATELY_IF_NO_FUTURE_ACCESS 1
@@ -39,6 +53,8 @@ static cache_obj_t *Belady_to_evict(cache_t *cache, const request_t *req);
 static void Belady_evict(cache_t *cache, const request_t *req);
 static bool Belady_remove(cache_t *cache, const obj_id_t obj_id);
 static void Belady_remove_obj(cache_t *cache, cache_obj_t *obj);
+static void Belady_parse_params(cache_t *cache,
+                                const char *cache_specific_params);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -51,10 +67,10 @@ static void Belady_remove_obj(cache_t *cache, cache_obj_t *obj);
  * @brief initialize a Belady cache
  *
  * @param ccache_params some common cache parameters
- * @param cache_specific_params Belady specific parameters, should be NULL
+ * @param cache_specific_params Belady specific parameters,
+ *    engine=wheel|pq, bucket-shift=5
  */
 cache_t *Belady_init(const common_cache_params_t ccache_params,
-                     
                      const char *cache_specific_params) {
   cache_t *cache = cache_struct_init("Belady", ccache_params, cache_specific_params);
   cache->cache_init = Belady_init;
@@ -67,9 +83,21 @@ cache_t *Belady_init(const common_cache_params_t ccache_params,
   cache->remove = Belady_remove;
 
   Belady_params_t *params = my_malloc(Belady_params_t);
+  memset(params, 0, sizeof(Belady_params_t));
   cache->eviction_params = params;
 
-  params->pq = pqueue_init((unsigned long)8e6);
+  Belady_parse_params(cache, DEFAULT_PARAMS);
+  if (cache_specific_params != NULL) {
+    Belady_parse_params(cache, cache_specific_params);
+  }
+
+  if (params->engine == BELADY_ENGINE_PQ) {
+    params->pq = pqueue_init((unsigned long)8e6);
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "Belady-pq");
+  } else {
+    params->wheel = next_access_wheel_init(params->bucket_shift);
+  }
+
   return cache;
 }
 
@@ -80,12 +108,18 @@ cache_t *Belady_init(const common_cache_params_t ccache_params,
  */
 static void Belady_free(cache_t *cache) {
   Belady_params_t *params = cache->eviction_params;
-  pq_node_t *node = pqueue_pop(params->pq);
-  while (node) {
-    my_free(sizeof(pq_node_t), node);
-    node = pqueue_pop(params->pq);
+  if (params->pq != NULL) {
+    pq_node_t *node = pqueue_pop(params->pq);
+    while (node) {
+      my_free(sizeof(pq_node_t), node);
+      node = pqueue_pop(params->pq);
+    }
+    pqueue_free(params->pq);
+  }
+  if (params->wheel != NULL) {
+    next_access_wheel_free(params->wheel);
   }
-  pqueue_free(params->pq);
+  my_free(sizeof(Belady_params_t), params);
 
   cache_struct_free(cache);
 }
@@ -114,7 +148,9 @@ static bool Belady_get(cache_t *cache, const request_t *req) {
   DEBUG_ASSERT(req->next_access_vtime != -2);
   Belady_params_t *params = cache->eviction_params;
 
-  DEBUG_ASSERT(cache->n_obj == (int64_t) params->pq->size - 1);
+  DEBUG_ASSERT(params->pq == NULL ||
+               cache->n_obj == (int64_t)params->pq->size - 1);
+  DEBUG_ASSERT(params->wheel == NULL || cache->n_obj == params->wheel->n_obj);
   bool ret = cache_get_base(cache, req);
 
   return ret;
@@ -147,13 +183,19 @@ static cache_obj_t *Belady_find(cache_t *cache, const request_t *req,
     return NULL;
   }
 
-  cached_obj->Belady.next_access_vtime = req->next_access_vtime;
-  pqueue_pri_t pri = {.pri = req->next_access_vtime};
-  pqueue_change_priority(params->pq, pri,
-                         (pq_node_t *)(cached_obj->Belady.pq_node));
-  DEBUG_ASSERT(
-      ((pq_node_t *)hashtable_find(cache->hashtable, req)->Belady.pq_node)
-          ->pri.pri == req->next_access_vtime);
+  if (params->wheel != NULL) {
+    next_access_wheel_remove(params->wheel, cached_obj);
+    cached_obj->Belady.next_access_vtime = req->next_access_vtime;
+    next_access_wheel_insert(params->wheel, cached_obj);
+  } else {
+    cached_obj->Belady.next_access_vtime = req->next_access_vtime;
+    pqueue_pri_t pri = {.pri = req->next_access_vtime};
+    pqueue_change_priority(params->pq, pri,
+                           (pq_node_t *)(cached_obj->Belady.pq_node));
+    DEBUG_ASSERT(
+        ((pq_node_t *)hashtable_find(cache->hashtable, req)->Belady.pq_node)
+            ->pri.pri == req->next_access_vtime);
+  }
 
 #if defined(EVICT_IMMEDIATELY_IF_NO_FUTURE_ACCESS)
   if (req->next_access_vtime == INT64_MAX) {
@@ -183,16 +225,21 @@ static cache_obj_t *Belady_insert(cache_t *cache, const request_t *req) {
 
   cache_obj_t *cached_obj = cache_insert_base(cache, req);
 
-  pq_node_t *node = my_malloc(pq_node_t);
-  node->obj_id = req->obj_id;
-  node->pri.pri = req->next_access_vtime;
-  pqueue_insert(params->pq, (void *)node);
-  cached_obj->Belady.pq_node = node;
   cached_obj->Belady.next_access_vtime = req->next_access_vtime;
-
-  DEBUG_ASSERT(
-      ((pq_node_t *)hashtable_find(cache->hashtable, req)->Belady.pq_node)
-          ->pri.pri == req->next_access_vtime);
+  if (params->wheel != NULL) {
+    cached_obj->Belady.pq_node = NULL;
+    next_access_wheel_insert(params->wheel, cached_obj);
+  } else {
+    pq_node_t *node = my_malloc(pq_node_t);
+    node->obj_id = req->obj_id;
+    node->pri.pri = req->next_access_vtime;
+    pqueue_insert(params->pq, (void *)node);
+    cached_obj->Belady.pq_node = node;
+
+    DEBUG_ASSERT(
+        ((pq_node_t *)hashtable_find(cache->hashtable, req)->Belady.pq_node)
+            ->pri.pri == req->next_access_vtime);
+  }
 
 #if defined(EVICT_IMMEDIATELY_IF_NO_FUTURE_ACCESS)
   if (req->next_access_vtime == INT64_MAX) {
@@ -215,6 +262,10 @@ static cache_obj_t *Belady_insert(cache_t *cache, const request_t *req) {
  */
 static cache_obj_t *Belady_to_evict(cache_t *cache, const request_t *req) {
   Belady_params_t *params = cache->eviction_params;
+  if (params->wheel != NULL) {
+    return next_access_wheel_peek_max(params->wheel);
+  }
+
   pq_node_t *node = (pq_node_t *)pqueue_peek(params->pq);
   return hashtable_find_obj_id(cache->hashtable, node->obj_id);
 }
@@ -230,6 +281,13 @@ static cache_obj_t *Belady_to_evict(cache_t *cache, const request_t *req) {
 static void Belady_evict(cache_t *cache,
                          const request_t *req) {
   Belady_params_t *params = cache->eviction_params;
+  if (params->wheel != NULL) {
+    cache_obj_t *obj_to_evict = next_access_wheel_peek_max(params->wheel);
+    next_access_wheel_remove(params->wheel, obj_to_evict);
+    cache_evict_base(cache, obj_to_evict, true);
+    return;
+  }
+
   pq_node_t *node = (pq_node_t *)pqueue_pop(params->pq);
 
   cache_obj_t *obj_to_evict =
@@ -246,7 +304,9 @@ static void Belady_remove_obj(cache_t *cache, cache_obj_t *obj) {
   Belady_params_t *params = cache->eviction_params;
   DEBUG_ASSERT(obj != NULL);
 
-  if (obj->Belady.pq_node != NULL) {
+  if (params->wheel != NULL) {
+    next_access_wheel_remove(params->wheel, obj);
+  } else if (obj->Belady.pq_node != NULL) {
     /* if it is NULL, it means we have deleted the entry in pq before this */
     pqueue_remove(params->pq, obj->Belady.pq_node);
     my_free(sizeof(pq_node_t), obj->Belady.pq_node);
@@ -279,6 +339,67 @@ static bool Belady_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                  parameter set up functions                   ****
+// ****                                                               ****
+// ***********************************************************************
+static const char *Belady_current_params(Belady_params_t *params) {
+  static __thread char params_str[128];
+  snprintf(params_str, 128, "engine=%s,bucket-shift=%d\n",
+           params->engine == BELADY_ENGINE_PQ ? "pq" : "wheel",
+           params->bucket_shift);
+  return params_str;
+}
+
+static void Belady_parse_params(cache_t *cache,
+                                const char *cache_specific_params) {
+  Belady_params_t *params = (Belady_params_t *)cache->eviction_params;
+  char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by '=' */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "engine") == 0) {
+      if (strcasecmp(value, "pq") == 0) {
+        params->engine = BELADY_ENGINE_PQ;
+      } else if (strcasecmp(value, "wheel") == 0) {
+        params->engine = BELADY_ENGINE_WHEEL;
+      } else {
+        ERROR("Belady engine %s is not supported, use pq or wheel\n", value);
+      }
+    } else if (strcasecmp(key, "bucket-shift") == 0) {
+      params->bucket_shift = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+      if (params->bucket_shift < 0 || params->bucket_shift > 20) {
+        ERROR("bucket-shift must be in [0, 20], got %d\n",
+              params->bucket_shift);
+      }
+    } else if (strcasecmp(key, "print") == 0) {
+      printf("current parameters: %s\n", Belady_current_params(params));
+      exit(0);
+    } else {
+      ERROR("%s does not have parameter %s, support %s\n", cache->cache_name,
+            key, Belady_current_params(params));
+      exit(1);
+    }
+  }
+
+  free(old_params_str);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,10 +4,17 @@
 //
 //  sample object and compare reuse_distance * size, then evict the greatest one
 //
+//  with engine=wheel, objects are grouped by log2(size) and each group is kept
+//  in a time wheel ordered by next access, the search walks the buckets of
+//  each group from the furthest future and stops when no object in the
+//  remaining buckets can beat the best score or after n-sample objects are
+//  examined
 //
 /* todo: change to BeladySize */
 
+#include "../../dataStructure/candidateSelect.h"
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../dataStructure/nextAccessWheel.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -15,11 +22,22 @@ extern "C" {
 #endif
 
 // #define EXACT_Belady 1
-static const char *DEFAULT_PARAMS = "n-sample=128";
+static const char *DEFAULT_PARAMS = "n-sample=128,engine=sample";
+
+#define N_SIZE_CLASS 64
 
 typedef struct {
-  // how many samples to take at each eviction
+  // how many samples to take at each eviction,
+  // for the wheel engine, the max number of objects examined at each eviction
   int n_sample;
+  // random sampling or bounded search on a time wheel
+  bool use_wheel;
+  int bucket_shift;
+  // one wheel per log2(size) class, created on first use
+  next_access_wheel_t *wheels[N_SIZE_CLASS];
+  // the sampled objects and their scores
+  cache_obj_t **samples;
+  double *scores;
 } BeladySize_params_t; /* BeladySize parameters */
 
 // ***********************************************************************
@@ -63,14 +81,22 @@ cache_t *BeladySize_init(const common_cache_params_t ccache_params, const char *
   cache->remove = BeladySize_remove;
   cache->to_evict = BeladySize_to_evict;
 
-  BeladySize_params_t *params = (BeladySize_params_t *)malloc(sizeof(BeladySize_params_t));
+  BeladySize_params_t *params = (BeladySize_params_t *)calloc(1, sizeof(BeladySize_params_t));
   cache->eviction_params = params;
+  params->bucket_shift = 8;
 
   BeladySize_parse_params(cache, DEFAULT_PARAMS);
   if (cache_specific_params != NULL) {
     BeladySize_parse_params(cache, cache_specific_params);
   }
 
+  if (params->use_wheel) {
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "BeladySize-wheel");
+  } else {
+    params->samples = malloc(sizeof(cache_obj_t *) * params->n_sample);
+    params->scores = malloc(sizeof(double) * params->n_sample);
+  }
+
   return cache;
 }
 
@@ -80,6 +106,14 @@ cache_t *BeladySize_init(const common_cache_params_t ccache_params, const char *
  * @param cache
  */
 static void BeladySize_free(cache_t *cache) {
+  BeladySize_params_t *params = (BeladySize_params_t *)cache->eviction_params;
+  for (int i = 0; i < N_SIZE_CLASS; i++) {
+    if (params->wheels[i] != NULL) {
+      next_access_wheel_free(params->wheels[i]);
+    }
+  }
+  free(params->samples);
+  free(params->scores);
   free(cache->eviction_params);
   cache_struct_free(cache);
 }
@@ -105,6 +139,15 @@ static void BeladySize_free(cache_t *cache) {
  */
 static bool BeladySize_get(cache_t *cache, const request_t *req) { return cache_get_base(cache, req); }
 
+/* the wheel of the objects with size in [2^(c-1), 2^c) */
+static inline next_access_wheel_t *size_class_wheel(BeladySize_params_t *params, const cache_obj_t *obj) {
+  int c = obj->obj_size <= 1 ? 1 : 64 - __builtin_clzll((uint64_t)obj->obj_size);
+  if (params->wheels[c] == NULL) {
+    params->wheels[c] = next_access_wheel_init(params->bucket_shift);
+  }
+  return params->wheels[c];
+}
+
 // ***********************************************************************
 // ****                                                               ****
 // ****       developer facing APIs (used by cache developer)         ****
@@ -122,6 +165,7 @@ static bool BeladySize_get(cache_t *cache, const request_t *req) { return cache_
  * @return the object or NULL if not found
  */
 static cache_obj_t *BeladySize_find(cache_t *cache, const request_t *req, const bool update_cache) {
+  BeladySize_params_t *params = (BeladySize_params_t *)cache->eviction_params;
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
 
   if (!update_cache) {
@@ -131,6 +175,11 @@ static cache_obj_t *BeladySize_find(cache_t *cache, const request_t *req, const
   if (update_cache && obj != NULL) {
     if (req->next_access_vtime == -1 || req->next_access_vtime == INT64_MAX) {
       BeladySize_remove(cache, obj->obj_id);
+    } else if (params->use_wheel) {
+      next_access_wheel_t *wheel = size_class_wheel(params, obj);
+      next_access_wheel_remove(wheel, obj);
+      obj->Belady.next_access_vtime = req->next_access_vtime;
+      next_access_wheel_insert(wheel, obj);
     } else {
       obj->Belady.next_access_vtime = req->next_access_vtime;
     }
@@ -154,8 +203,12 @@ static cache_obj_t *BeladySize_insert(cache_t *cache, const request_t *req) {
     return NULL;
   }
 
+  BeladySize_params_t *params = (BeladySize_params_t *)cache->eviction_params;
   cache_obj_t *obj = cache_insert_base(cache, req);
   obj->Belady.next_access_vtime = req->next_access_vtime;
+  if (params->use_wheel) {
+    next_access_wheel_insert(size_class_wheel(params, obj), obj);
+  }
 
   return obj;
 }
@@ -205,31 +258,80 @@ static cache_obj_t *BeladySize_to_evict(cache_t *cache, const request_t *req) {
 }
 
 #else
+/**
+ * score objects by size * reuse distance, starting from the furthest object
+ * of each size class, then walk each class from its furthest bucket,
+ * objects in a bucket are at most 2^class bytes and reused at most at the
+ * end of the bucket, so a class stops once that bound cannot beat the best
+ * score, the result is exact unless n-sample objects are examined first
+ */
+static cache_obj_t *BeladySize_to_evict_wheel(cache_t *cache, BeladySize_params_t *params) {
+  cache_obj_t *obj_to_evict = NULL;
+  double obj_to_evict_score = -1;
+
+  for (int c = 0; c < N_SIZE_CLASS; c++) {
+    next_access_wheel_t *wheel = params->wheels[c];
+    if (wheel == NULL || wheel->n_obj == 0) continue;
+    if (wheel->no_reuse_head != NULL) {
+      return wheel->no_reuse_head;
+    }
+    cache_obj_t *obj = next_access_wheel_peek_max(wheel);
+    double score = (double)obj->obj_size * (double)(obj->Belady.next_access_vtime - cache->n_req);
+    if (score > obj_to_evict_score) {
+      obj_to_evict = obj;
+      obj_to_evict_score = score;
+    }
+  }
+
+  int n_examined = 0;
+  for (int c = N_SIZE_CLASS - 1; c >= 0; c--) {
+    next_access_wheel_t *wheel = params->wheels[c];
+    if (wheel == NULL || wheel->n_obj == 0) continue;
+    double max_size = ldexp(1.0, c);
+    int64_t bucket_idx = next_access_wheel_prev_bucket(wheel, wheel->n_bucket - 1);
+    while (bucket_idx >= 0 && n_examined < params->n_sample) {
+      double bound = max_size * (double)(next_access_wheel_bucket_end(wheel, bucket_idx) - cache->n_req);
+      if (bound <= obj_to_evict_score) break;
+
+      for (cache_obj_t *obj = wheel->buckets[bucket_idx]; obj != NULL; obj = obj->queue.next) {
+        double score = (double)obj->obj_size * (double)(obj->Belady.next_access_vtime - cache->n_req);
+        if (score > obj_to_evict_score) {
+          obj_to_evict = obj;
+          obj_to_evict_score = score;
+        }
+        n_examined++;
+      }
+      bucket_idx = next_access_wheel_prev_bucket(wheel, bucket_idx - 1);
+    }
+  }
+
+  return obj_to_evict;
+}
+
 static cache_obj_t *BeladySize_to_evict(cache_t *cache, const request_t *req) {
   BeladySize_params_t *params = (BeladySize_params_t *)cache->eviction_params;
-  cache_obj_t *obj_to_evict = NULL, *sampled_obj;
-  double obj_to_evict_score = -1, sampled_obj_score = -1;
+  if (params->use_wheel) {
+    return BeladySize_to_evict_wheel(cache, params);
+  }
+
   for (int i = 0; i < params->n_sample; i++) {
-    sampled_obj = hashtable_rand_obj(cache->hashtable);
-    sampled_obj_score =
+    cache_obj_t *sampled_obj = hashtable_rand_obj(cache->hashtable);
+    params->samples[i] = sampled_obj;
+    params->scores[i] =
         log((double)sampled_obj->obj_size) + log((double)(sampled_obj->Belady.next_access_vtime - cache->n_req));
-    if (obj_to_evict_score < sampled_obj_score) {
-      obj_to_evict = sampled_obj;
-      obj_to_evict_score = sampled_obj_score;
-    }
   }
-  if (obj_to_evict == NULL) {
+  int best = candidate_argmax(params->scores, params->n_sample);
+  if (best < 0 || params->scores[best] <= -1) {
     WARN(
         "BeladySize_to_evict: obj_to_evict is NULL, "
         "maybe cache size is too small or hash power too large, "
-        "current hash table size %lu, n_obj %lu, cache size %lu, request size %lu, and %d samples "
-        "obj_to_evict_score %.4lf sampled_obj_score %.4lf\n",
+        "current hash table size %lu, n_obj %lu, cache size %lu, request size %lu, and %d samples\n",
         hashsize(cache->hashtable->hashpower), cache->hashtable->n_obj, cache->cache_size, req->obj_size,
-        params->n_sample, obj_to_evict_score, sampled_obj_score);
+        params->n_sample);
     return BeladySize_to_evict(cache, req);
   }
 
-  return obj_to_evict;
+  return params->samples[best];
 }
 #endif
 
@@ -243,15 +345,23 @@ static cache_obj_t *BeladySize_to_evict(cache_t *cache, const request_t *req) {
  * @param evicted_obj if not NULL, return the evicted object to caller
  */
 static void BeladySize_evict(cache_t *cache, const request_t *req) {
+  BeladySize_params_t *params = (BeladySize_params_t *)cache->eviction_params;
   cache_obj_t *obj_to_evict = BeladySize_to_evict(cache, req);
+  if (params->use_wheel) {
+    next_access_wheel_remove(size_class_wheel(params, obj_to_evict), obj_to_evict);
+  }
   cache_evict_base(cache, obj_to_evict, true);
 }
 
 bool BeladySize_remove(cache_t *cache, const obj_id_t obj_id) {
+  BeladySize_params_t *params = (BeladySize_params_t *)cache->eviction_params;
   cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
   if (obj == NULL) {
     return false;
   }
+  if (params->use_wheel) {
+    next_access_wheel_remove(size_class_wheel(params, obj), obj);
+  }
   cache_remove_obj_base(cache, obj, true);
   return true;
 }
@@ -267,7 +377,8 @@ bool BeladySize_remove(cache_t *cache, const obj_id_t obj_id) {
  */
 static const char *BeladySize_current_params(BeladySize_params_t *params) {
   static __thread char params_str[128];
-  snprintf(params_str, 128, "n-sample=%d\n", params->n_sample);
+  snprintf(params_str, 128, "n-sample=%d,engine=%s,bucket-shift=%d\n", params->n_sample,
+           params->use_wheel ? "wheel" : "sample", params->bucket_shift);
   return params_str;
 }
 
@@ -299,6 +410,22 @@ static void BeladySize_parse_params(cache_t *cache, const char *cache_specific_p
       if (strlen(end) > 2) {
         ERROR("param parsing error, find string \"%s\" after number\n", end);
       }
+    } else if (strcasecmp(key, "engine") == 0) {
+      if (strcasecmp(value, "sample") == 0) {
+        params->use_wheel = false;
+      } else if (strcasecmp(value, "wheel") == 0) {
+        params->use_wheel = true;
+      } else {
+        ERROR("BeladySize engine %s is not supported, use sample or wheel\n", value);
+      }
+    } else if (strcasecmp(key, "bucket-shift") == 0) {
+      params->bucket_shift = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+      if (params->bucket_shift < 0 || params->bucket_shift > 20) {
+        ERROR("bucket-shift must be in [0, 20], got %d\n", params->bucket_shift);
+      }
     } else if (strcasecmp(key, "print") == 0) {
       printf("current parameters: %s\n", BeladySize_current_params(params));
       exit(0);
@@ -7,6 +7,7 @@
 // 
 
 
+#include "../../dataStructure/ghostHistory.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -20,13 +21,11 @@ typedef struct {
 
     cache_obj_t *L1_data_head;
     cache_obj_t *L1_data_tail;
-    cache_obj_t *L1_ghost_head;
-    cache_obj_t *L1_ghost_tail;
+    ghost_history_t *L1_ghost;
 
     cache_obj_t *L2_data_head;
     cache_obj_t *L2_data_tail;
-    cache_obj_t *L2_ghost_head;
-    cache_obj_t *L2_ghost_tail;
+    ghost_history_t *L2_ghost;
 
 
     double p;
@@ -95,12 +94,10 @@ cache_t *CAR_init(
     params->L2_ghost_size = 0;
     params->L1_data_head = NULL;
     params->L1_data_tail = NULL;
-    params->L1_ghost_head = NULL;
-    params->L1_ghost_tail = NULL;
+    params->L1_ghost = ghost_history_init(1024);
     params->L2_data_head = NULL;
     params->L2_data_tail = NULL;
-    params->L2_ghost_head = NULL;
-    params->L2_ghost_tail = NULL;
+    params->L2_ghost = ghost_history_init(1024);
     params->curr_obj_in_L1_ghost = false;
     params->curr_obj_in_L2_ghost = false;
     params->last_req_in_ghost = -1;
@@ -126,18 +123,13 @@ static cache_obj_t *CAR_find(cache_t *cache, const request_t *req, const bool up
 
 
     if (!update_cache) {
-        return obj->CAR.ghost ? NULL : obj;
-      }
-    
-    if (obj == NULL) {
-    return NULL;
+        return obj;
     }
 
-    cache_obj_t* result = obj;
-    if (obj->CAR.ghost) {
-        // Object in Ghost
-        result = NULL;
-        if (obj->CAR.lru_id == 1) { // Obj in B1
+    if (obj == NULL) {
+        // ghost entries are not in the hash table
+        int64_t ghost_size;
+        if (ghost_history_remove(params->L1_ghost, req->obj_id, &ghost_size, NULL)) { // Obj in B1
             params->curr_obj_in_L1_ghost = true;
             params->last_req_in_ghost = cache->n_req;
             // Adapt: Increase the target size for the list T1 as: p = min {p + max{1, |B2|/|B1|}, c}
@@ -149,11 +141,9 @@ static cache_obj_t *CAR_find(cache_t *cache, const request_t *req, const bool up
                 cache->cache_size
             );
             // Move x at the tail of T2. Set the page reference bit of x to 0.
-            remove_obj_from_list(&params->L1_ghost_head,&params->L1_ghost_tail,obj);
-            params->L1_ghost_size -= obj->obj_size + cache->obj_md_size;
-            hashtable_delete(cache->hashtable,obj);
+            params->L1_ghost_size -= ghost_size;
 
-        } else { // Obj in B2
+        } else if (ghost_history_remove(params->L2_ghost, req->obj_id, &ghost_size, NULL)) { // Obj in B2
             params->curr_obj_in_L2_ghost = true;
 
             //  Adapt: Decrease the target size for the list T1 as: p = max {p − max{1, |B1|/|B2|}, 0}
@@ -165,15 +155,12 @@ static cache_obj_t *CAR_find(cache_t *cache, const request_t *req, const bool up
                 0
             );
             //  Move x at the tail of T2. Set the page reference bit of x to 0.
-            remove_obj_from_list(&params->L2_ghost_head,&params->L2_ghost_tail,obj);
-            params->L2_ghost_size -= obj->obj_size + cache->obj_md_size;
-            hashtable_delete(cache->hashtable,obj);
-
+            params->L2_ghost_size -= ghost_size;
         }
     } else {
         obj->CAR.reference = true;
     }
-    return result;
+    return obj;
 }
 
 /**
@@ -182,6 +169,9 @@ static cache_obj_t *CAR_find(cache_t *cache, const request_t *req, const bool up
  * @param cache
  */
 static void CAR_free(cache_t *cache){
+    CAR_params_t *params = (CAR_params_t *)(cache->eviction_params);
+    ghost_history_free(params->L1_ghost);
+    ghost_history_free(params->L2_ghost);
     free(cache->eviction_params);
     cache_struct_free(cache);
 }
@@ -326,27 +316,26 @@ static bool CAR_remove(cache_t *cache, const obj_id_t obj_id){
     cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
   
     if (obj == NULL) {
+      int64_t ghost_size;
+      if (ghost_history_remove(params->L1_ghost, obj_id, &ghost_size, NULL)) {
+        params->L1_ghost_size -= ghost_size;
+        return true;
+      }
+      if (ghost_history_remove(params->L2_ghost, obj_id, &ghost_size, NULL)) {
+        params->L2_ghost_size -= ghost_size;
+        return true;
+      }
       return false;
     }
   
-    if (obj->CAR.ghost) {
-      if (obj->CAR.lru_id == 1) {
-        params->L1_ghost_size -= obj->obj_size + cache->obj_md_size;
-        remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
-      } else {
-        params->L2_ghost_size -= obj->obj_size + cache->obj_md_size;
-        remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
-      }
+    if (obj->CAR.lru_id == 1) {
+      params->L1_data_size -= obj->obj_size + cache->obj_md_size;
+      remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
     } else {
-      if (obj->CAR.lru_id == 1) {
-        params->L1_data_size -= obj->obj_size + cache->obj_md_size;
-        remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
-      } else {
-        params->L2_data_size -= obj->obj_size + cache->obj_md_size;
-        remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
-      }
-      cache_remove_obj_base(cache, obj, true);
+      params->L2_data_size -= obj->obj_size + cache->obj_md_size;
+      remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
     }
+    cache_remove_obj_base(cache, obj, true);
   
     return true;
 }
@@ -409,26 +398,26 @@ static void _CAR_L1_demote_to_MRU_data(cache_t *cache, const request_t *req) {
     CAR_params_t *params = (CAR_params_t*)cache->eviction_params;
     cache_obj_t *obj = params->L1_data_head;
 
+    int64_t sz = obj->obj_size + cache->obj_md_size;
     remove_obj_from_list(&params->L1_data_head, &params->L1_data_tail, obj);
-    params->L1_data_size -= obj->obj_size + cache->obj_md_size;
-    params->L1_ghost_size += obj->obj_size + cache->obj_md_size;
-    prepend_obj_to_head(&params->L1_ghost_head,&params->L1_ghost_tail,obj);
-    obj->CAR.ghost = true;
+    params->L1_data_size -= sz;
+    params->L1_ghost_size += sz;
+    ghost_history_insert(params->L1_ghost, obj->obj_id, sz, 0);
 
-    cache_evict_base(cache, obj, false);
+    cache_evict_base(cache, obj, true);
 }
 
 static void _CAR_L2_demote_to_MRU_data(cache_t *cache, const request_t *req) {
     CAR_params_t *params = (CAR_params_t*)cache->eviction_params;
     cache_obj_t *obj = params->L2_data_head;
 
+    int64_t sz = obj->obj_size + cache->obj_md_size;
     remove_obj_from_list(&params->L2_data_head, &params->L2_data_tail, obj);
-    params->L2_data_size -= obj->obj_size + cache->obj_md_size;
-    params->L2_ghost_size += obj->obj_size + cache->obj_md_size;
-    prepend_obj_to_head(&params->L2_ghost_head,&params->L2_ghost_tail,obj);
-    obj->CAR.ghost = true;
+    params->L2_data_size -= sz;
+    params->L2_ghost_size += sz;
+    ghost_history_insert(params->L2_ghost, obj->obj_id, sz, 0);
 
-    cache_evict_base(cache, obj, false);
+    cache_evict_base(cache, obj, true);
 }
 
 static void _CAR_L1_move_to_tail_L2_data(cache_t *cache, const request_t *req) {
@@ -438,7 +427,6 @@ static void _CAR_L1_move_to_tail_L2_data(cache_t *cache, const request_t *req) {
     params->L1_data_size -= obj->obj_size + cache->obj_md_size;
     params->L2_data_size += obj->obj_size + cache->obj_md_size;
     append_obj_to_tail(&params->L2_data_head,&params->L2_data_tail,obj);
-    obj->CAR.ghost = false;
     obj->CAR.lru_id = 2;
 }
 
@@ -447,26 +435,21 @@ static void _CAR_move_to_tail_L2_data(cache_t *cache, const request_t *req) {
     cache_obj_t *obj = params->L2_data_head;
 
     move_obj_to_tail(&params->L2_data_head,&params->L2_data_tail,obj);
-    obj->CAR.ghost = false;
 
 }
 
 static void _CAR_discard_LRU_L1_ghost(cache_t *cache, const request_t *req){
     CAR_params_t *params = (CAR_params_t*)cache->eviction_params;
-    cache_obj_t *obj = params->L1_ghost_tail;
-    int64_t sz = obj->obj_size + cache->obj_md_size;
+    int64_t sz = 0;
+    ghost_history_pop_oldest(params->L1_ghost, &sz, NULL);
     params->L1_ghost_size -= sz;
-    remove_obj_from_list(&params->L1_ghost_head, &params->L1_ghost_tail, obj);
-    hashtable_delete(cache->hashtable, obj);
 }
 
 static void _CAR_discard_LRU_L2_ghost(cache_t *cache, const request_t *req){
     CAR_params_t *params = (CAR_params_t*)cache->eviction_params;
-    cache_obj_t *obj = params->L2_ghost_tail;
-    int64_t sz = obj->obj_size + cache->obj_md_size;
+    int64_t sz = 0;
+    ghost_history_pop_oldest(params->L2_ghost, &sz, NULL);
     params->L2_ghost_size -= sz;
-    remove_obj_from_list(&params->L2_ghost_head, &params->L2_ghost_tail, obj);
-    hashtable_delete(cache->hashtable, obj);
 }
 
 
@@ -533,13 +516,7 @@ static void print_cache(cache_t *cache) {
     }
     printf("\n");
   
-    obj = params->L1_ghost_head;
-    printf("B1: ");
-    while (obj != NULL) {
-      printf("%ld ", (long)obj->obj_id);
-      obj = obj->queue.next;
-    }
-    printf("\n");
+    printf("B1: %ld entries\n", (long)params->L1_ghost->n_entry);
   
     obj = params->L2_data_head;
     printf("T2: ");
@@ -549,13 +526,7 @@ static void print_cache(cache_t *cache) {
     }
     printf("\n");
   
-    obj = params->L2_ghost_head;
-    printf("B2: ");
-    while (obj != NULL) {
-      printf("%ld ", (long)obj->obj_id);
-      obj = obj->queue.next;
-    }
-    printf("\n");
+    printf("B2: %ld entries\n", (long)params->L2_ghost->n_entry);
   }
 
 static void _CAR_sanity_check(cache_t *cache, const request_t *req) {
@@ -570,18 +541,12 @@ static void _CAR_sanity_check(cache_t *cache, const request_t *req) {
       DEBUG_ASSERT(params->L1_data_head != NULL);
       DEBUG_ASSERT(params->L1_data_tail != NULL);
     }
-    if (params->L1_ghost_size > 0) {
-      DEBUG_ASSERT(params->L1_ghost_head != NULL);
-      DEBUG_ASSERT(params->L1_ghost_tail != NULL);
-    }
+    DEBUG_ASSERT(params->L1_ghost_size == params->L1_ghost->n_byte);
     if (params->L2_data_size > 0) {
       DEBUG_ASSERT(params->L2_data_head != NULL);
       DEBUG_ASSERT(params->L2_data_tail != NULL);
     }
-    if (params->L2_ghost_size > 0) {
-      DEBUG_ASSERT(params->L2_ghost_head != NULL);
-      DEBUG_ASSERT(params->L2_ghost_tail != NULL);
-    }
+    DEBUG_ASSERT(params->L2_ghost_size == params->L2_ghost->n_byte);
   
     DEBUG_ASSERT(params->L1_data_size + params->L2_data_size ==
                  cache->occupied_byte);
@@ -600,13 +565,11 @@ static inline void _CAR_sanity_check_full(cache_t *cache, const request_t *req)
     CAR_params_t *params = (CAR_params_t *)(cache->eviction_params);
 
     int64_t L1_data_byte = 0, L2_data_byte = 0;
-    int64_t L1_ghost_byte = 0, L2_ghost_byte = 0;
 
     cache_obj_t *obj = params->L1_data_head;
     cache_obj_t *last_obj = NULL;
     while (obj != NULL) {
     DEBUG_ASSERT(obj->CAR.lru_id == 1);
-    DEBUG_ASSERT(!obj->CAR.ghost);
     L1_data_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
@@ -614,41 +577,16 @@ static inline void _CAR_sanity_check_full(cache_t *cache, const request_t *req)
     DEBUG_ASSERT(L1_data_byte == params->L1_data_size);
     DEBUG_ASSERT(last_obj == params->L1_data_tail);
 
-    obj = params->L1_ghost_head;
-    last_obj = NULL;
-    while (obj != NULL) {
-    DEBUG_ASSERT(obj->CAR.lru_id == 1);
-    DEBUG_ASSERT(obj->CAR.ghost);
-    L1_ghost_byte += obj->obj_size;
-    last_obj = obj;
-    obj = obj->queue.next;
-    }
-    DEBUG_ASSERT(L1_ghost_byte == params->L1_ghost_size);
-    DEBUG_ASSERT(last_obj == params->L1_ghost_tail);
-
     obj = params->L2_data_head;
     last_obj = NULL;
     while (obj != NULL) {
     DEBUG_ASSERT(obj->CAR.lru_id == 2);
-    DEBUG_ASSERT(!obj->CAR.ghost);
     L2_data_byte += obj->obj_size;
     last_obj = obj;
     obj = obj->queue.next;
     }
     DEBUG_ASSERT(L2_data_byte == params->L2_data_size);
     DEBUG_ASSERT(last_obj == params->L2_data_tail);
-
-    obj = params->L2_ghost_head;
-    last_obj = NULL;
-    while (obj != NULL) {
-    DEBUG_ASSERT(obj->CAR.lru_id == 2);
-    DEBUG_ASSERT(obj->CAR.ghost);
-    L2_ghost_byte += obj->obj_size;
-    last_obj = obj;
-    obj = obj->queue.next;
-    }
-    DEBUG_ASSERT(L2_ghost_byte == params->L2_ghost_size);
-    DEBUG_ASSERT(last_obj == params->L2_ghost_tail);
 }
 
 static bool _CAR_get_debug(cache_t *cache, const request_t *req) {
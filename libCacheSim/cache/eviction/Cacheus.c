@@ -83,6 +83,7 @@ cache_t *Cacheus_init(const common_cache_params_t ccache_params,
   cache->evict = Cacheus_evict;
   cache->remove = Cacheus_remove;
   cache->to_evict = Cacheus_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->can_insert = cache_can_insert_default;
   cache->get_n_obj = Cacheus_get_n_obj;
   cache->get_occupied_byte = Cacheus_get_occupied_byte;
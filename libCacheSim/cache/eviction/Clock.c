@@ -11,6 +11,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/checkpoint.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -36,6 +37,8 @@ static cache_obj_t *Clock_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *Clock_to_evict(cache_t *cache, const request_t *req);
 static void Clock_evict(cache_t *cache, const request_t *req);
 static bool Clock_remove(cache_t *cache, const obj_id_t obj_id);
+static bool Clock_serialize(const cache_t *cache, FILE *f);
+static bool Clock_deserialize(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -81,6 +84,9 @@ cache_t *Clock_init(const common_cache_params_t ccache_params, const char *cache
     Clock_parse_params(cache, cache_specific_params);
   }
 
+  cache->serialize = Clock_serialize;
+  cache->deserialize = Clock_deserialize;
+
   if (params->n_bit_counter != 1) {
     snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "Clock-%d-%d", params->n_bit_counter, params->init_freq);
   }
@@ -328,6 +334,48 @@ static void Clock_parse_params(cache_t *cache, const char *cache_specific_params
   free(old_params_str);
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     checkpoint functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+/**
+ * @brief write the objects from the oldest to the newest, see checkpoint.h
+ */
+static bool Clock_serialize(const cache_t *cache, FILE *f) {
+  Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
+  int64_t n_obj = cache->n_obj;
+  if (!checkpoint_write(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (cache_obj_t *obj = params->q_tail; obj != NULL; obj = obj->queue.prev) {
+    if (!checkpoint_write_obj(f, obj, obj->clock.freq)) return false;
+  }
+
+  int64_t counters[2] = {params->n_obj_rewritten, params->n_byte_rewritten};
+  return checkpoint_write(f, counters, sizeof(counters));
+}
+
+static bool Clock_deserialize(cache_t *cache, FILE *f) {
+  Clock_params_t *params = (Clock_params_t *)cache->eviction_params;
+  int64_t n_obj;
+  if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (int64_t i = 0; i < n_obj; i++) {
+    int64_t md;
+    cache_obj_t *obj = checkpoint_read_obj(cache, f, &md);
+    if (obj == NULL) return false;
+    prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
+    /* the state may come from a clock with a larger counter */
+    obj->clock.freq = md > params->max_freq ? params->max_freq : (int)md;
+  }
+
+  int64_t counters[2];
+  if (!checkpoint_read(f, counters, sizeof(counters))) return false;
+  params->n_obj_rewritten = counters[0];
+  params->n_byte_rewritten = counters[1];
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/checkpoint.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -32,6 +33,8 @@ static cache_obj_t *FIFO_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *FIFO_to_evict(cache_t *cache, const request_t *req);
 static void FIFO_evict(cache_t *cache, const request_t *req);
 static bool FIFO_remove(cache_t *cache, const obj_id_t obj_id);
+static bool FIFO_serialize(const cache_t *cache, FILE *f);
+static bool FIFO_deserialize(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -60,6 +63,8 @@ cache_t *FIFO_init(const common_cache_params_t ccache_params,
   cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->get_n_obj = cache_get_n_obj_default;
   cache->can_insert = cache_can_insert_default;
+  cache->serialize = FIFO_serialize;
+  cache->deserialize = FIFO_deserialize;
   cache->obj_md_size = 0;
 
   cache->eviction_params = malloc(sizeof(FIFO_params_t));
@@ -222,6 +227,38 @@ static void FIFO_parse_params(cache_t *cache,
   }
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     checkpoint functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+/**
+ * @brief write the objects from the oldest to the newest, see checkpoint.h
+ */
+static bool FIFO_serialize(const cache_t *cache, FILE *f) {
+  FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
+  int64_t n_obj = cache->n_obj;
+  if (!checkpoint_write(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (cache_obj_t *obj = params->q_tail; obj != NULL; obj = obj->queue.prev) {
+    if (!checkpoint_write_obj(f, obj, 0)) return false;
+  }
+  return true;
+}
+
+static bool FIFO_deserialize(cache_t *cache, FILE *f) {
+  FIFO_params_t *params = (FIFO_params_t *)cache->eviction_params;
+  int64_t n_obj;
+  if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (int64_t i = 0; i < n_obj; i++) {
+    cache_obj_t *obj = checkpoint_read_obj(cache, f, NULL);
+    if (obj == NULL) return false;
+    prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
+  }
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,7 @@
 
 #include <assert.h>
 
+#include "../../dataStructure/candidateSelect.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -18,11 +19,6 @@
 extern "C" {
 #endif
 
-struct sort_list_node {
-  double metric;
-  cache_obj_t *cache_obj;
-};
-
 typedef enum {
   RETAIN_POLICY_RECENCY = 0,
   RETAIN_POLICY_FREQUENCY,
@@ -42,8 +38,11 @@ typedef struct FIFO_Merge_params {
   int n_exam_obj;
   // of the n_exam_obj, we keep n_keep_obj and evict the rest
   int n_keep_obj;
-  // used to sort the n_exam_obj objects
-  struct sort_list_node *metric_list;
+  // the metric and the object of the n_exam_obj objects
+  double *metrics;
+  cache_obj_t **exam_objs;
+  // exam_objs[metric_order[i]] has the i-th lowest metric
+  int32_t *metric_order;
   // the policy to determine the n_keep_obj objects
   retain_policy_t retain_policy;
   int pos_in_metric_list;
@@ -67,7 +66,6 @@ static void FIFO_Merge_evict(cache_t *cache, const request_t *req);
 static bool FIFO_Merge_remove(cache_t *cache, const obj_id_t obj_id);
 
 /* internal functions */
-static inline int cmp_list_node(const void *a0, const void *b0);
 static inline double belady_metric(cache_t *cache, cache_obj_t *cache_obj);
 static inline double freq_metric(cache_t *cache, cache_obj_t *cache_obj);
 static inline double recency_metric(cache_t *cache, cache_obj_t *cache_obj);
@@ -126,7 +124,9 @@ cache_t *FIFO_Merge_init(const common_cache_params_t ccache_params,
 
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "FIFO_Merge_%s",
            retain_policy_names[params->retain_policy]);
-  params->metric_list = my_malloc_n(struct sort_list_node, params->n_exam_obj);
+  params->metrics = my_malloc_n(double, params->n_exam_obj);
+  params->exam_objs = my_malloc_n(cache_obj_t *, params->n_exam_obj);
+  params->metric_order = my_malloc_n(int32_t, params->n_exam_obj);
 
   return cache;
 }
@@ -138,8 +138,9 @@ cache_t *FIFO_Merge_init(const common_cache_params_t ccache_params,
  */
 static void FIFO_Merge_free(cache_t *cache) {
   FIFO_Merge_params_t *params = (FIFO_Merge_params_t *)cache->eviction_params;
-  my_free(sizeof(struct sort_list_node) * params->n_exam_obj,
-          params->metric_list);
+  my_free(sizeof(double) * params->n_exam_obj, params->metrics);
+  my_free(sizeof(cache_obj_t *) * params->n_exam_obj, params->exam_objs);
+  my_free(sizeof(int32_t) * params->n_exam_obj, params->metric_order);
   my_free(sizeof(FIFO_Merge_params_t), params);
   cache_struct_free(cache);
 }
@@ -250,7 +251,7 @@ static void FIFO_Merge_evict(cache_t *cache, const request_t *req) {
   // the logic is that - we search for n_exam objects and identify n_exam -
   // n_keep objects to evict, each time we evict one object
   if (params->pos_in_metric_list < params->n_exam_obj) {
-    cache_obj = params->metric_list[params->pos_in_metric_list++].cache_obj;
+    cache_obj = params->exam_objs[params->metric_order[params->pos_in_metric_list++]];
     if (params->pos_in_metric_list < params->n_exam_obj - params->n_keep_obj) {
       // there are objects identified to evict
       remove_obj_from_list(&params->q_head, &params->q_tail, cache_obj);
@@ -280,20 +281,22 @@ static void FIFO_Merge_evict(cache_t *cache, const request_t *req) {
       assert(n_loop++ <= 2);
     }
 
-    params->metric_list[i].metric = retain_metric(cache, cache_obj);
-    params->metric_list[i].cache_obj = cache_obj;
+    params->metrics[i] = retain_metric(cache, cache_obj);
+    params->exam_objs[i] = cache_obj;
     cache_obj = cache_obj->queue.prev;
   }
   params->next_to_exam = cache_obj;
   cache_obj = NULL;
 
-  // sort metrics
-  qsort(params->metric_list, params->n_exam_obj, sizeof(struct sort_list_node),
-        cmp_list_node);
+  // only the objects to evict are sorted, they are evicted from the lowest
+  // metric
+  int n_evict = MAX(params->n_exam_obj - params->n_keep_obj, 1);
+  candidate_select(params->metrics, params->n_exam_obj, n_evict, params->metric_order);
+  candidate_sort(params->metrics, params->metric_order, n_evict);
 
   // remove objects
   params->pos_in_metric_list = 1;
-  cache_obj = params->metric_list[0].cache_obj;
+  cache_obj = params->exam_objs[params->metric_order[0]];
   remove_obj_from_list(&params->q_head, &params->q_tail, cache_obj);
   cache_evict_base(cache, cache_obj, true);
 }
@@ -403,19 +406,6 @@ static void FIFO_Merge_parse_params(cache_t *cache,
 // ****                  cache internal functions                     ****
 // ****                                                               ****
 // ***********************************************************************
-static inline int cmp_list_node(const void *a0, const void *b0) {
-  struct sort_list_node *a = (struct sort_list_node *)a0;
-  struct sort_list_node *b = (struct sort_list_node *)b0;
-
-  if (a->metric > b->metric) {
-    return 1;
-  } else if (a->metric < b->metric) {
-    return -1;
-  } else {
-    return 0;
-  }
-}
-
 static inline double belady_metric(cache_t *cache, cache_obj_t *cache_obj) {
   if (cache_obj->misc.next_access_vtime == -1 ||
       cache_obj->misc.next_access_vtime == INT64_MAX)
@@ -12,6 +12,7 @@
 
 #include <assert.h>
 
+#include "../../dataStructure/candidateSelect.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -19,11 +20,6 @@
 extern "C" {
 #endif
 
-struct sort_list_node {
-  double metric;
-  cache_obj_t *cache_obj;
-};
-
 typedef enum {
   RETAIN_POLICY_RECENCY = 0,
   RETAIN_POLICY_FREQUENCY,
@@ -43,8 +39,11 @@ typedef struct FIFO_Reinsertion_params {
   int n_exam_obj;
   // of the n_exam_obj, we keep n_keep_obj and evict the rest
   int n_keep_obj;
-  // used to sort the n_exam_obj objects
-  struct sort_list_node *metric_list;
+  // the metric and the object of the n_exam_obj objects
+  double *metrics;
+  cache_obj_t **exam_objs;
+  // exam_objs[metric_order[i]] has the i-th lowest metric
+  int32_t *metric_order;
   // the policy to determine the n_keep_obj objects
   retain_policy_t retain_policy;
 
@@ -73,7 +72,6 @@ static void FIFO_Reinsertion_remove_obj(cache_t *cache, cache_obj_t *obj);
 static bool FIFO_Reinsertion_remove(cache_t *cache, const obj_id_t obj_id);
 
 /* internal functions */
-static inline int cmp_list_node(const void *a0, const void *b0);
 static inline double belady_metric(cache_t *cache, cache_obj_t *cache_obj);
 static inline double freq_metric(cache_t *cache, cache_obj_t *cache_obj);
 static inline double recency_metric(cache_t *cache, cache_obj_t *cache_obj);
@@ -132,7 +130,9 @@ cache_t *FIFO_Reinsertion_init(const common_cache_params_t ccache_params,
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "FIFO_Reinsertion_%s-%.4lf",
            retain_policy_names[params->retain_policy],
            (double)params->n_keep_obj / params->n_exam_obj);
-  params->metric_list = my_malloc_n(struct sort_list_node, params->n_exam_obj);
+  params->metrics = my_malloc_n(double, params->n_exam_obj);
+  params->exam_objs = my_malloc_n(cache_obj_t *, params->n_exam_obj);
+  params->metric_order = my_malloc_n(int32_t, params->n_exam_obj);
 
   return cache;
 }
@@ -145,8 +145,9 @@ cache_t *FIFO_Reinsertion_init(const common_cache_params_t ccache_params,
 static void FIFO_Reinsertion_free(cache_t *cache) {
   FIFO_Reinsertion_params_t *params =
       (FIFO_Reinsertion_params_t *)cache->eviction_params;
-  my_free(sizeof(struct sort_list_node) * params->n_exam_obj,
-          params->metric_list);
+  my_free(sizeof(double) * params->n_exam_obj, params->metrics);
+  my_free(sizeof(cache_obj_t *) * params->n_exam_obj, params->exam_objs);
+  my_free(sizeof(int32_t) * params->n_exam_obj, params->metric_order);
   my_free(sizeof(FIFO_Reinsertion_params_t), params);
   cache_struct_free(cache);
 }
@@ -279,8 +280,8 @@ static void FIFO_Reinsertion_evict(cache_t *cache, const request_t *req) {
 
   for (int i = 0; i < params->n_exam_obj; i++) {
     assert(cache_obj != NULL);
-    params->metric_list[i].metric = retain_metric(cache, cache_obj);
-    params->metric_list[i].cache_obj = cache_obj;
+    params->metrics[i] = retain_metric(cache, cache_obj);
+    params->exam_objs[i] = cache_obj;
     cache_obj = cache_obj->queue.prev;
 
     //  TODO: wrap back to the head of the list early before reaching the end of
@@ -292,19 +293,20 @@ static void FIFO_Reinsertion_evict(cache_t *cache, const request_t *req) {
   }
   params->next_to_merge = cache_obj;
 
-  // sort metrics
-  qsort(params->metric_list, params->n_exam_obj, sizeof(struct sort_list_node),
-        cmp_list_node);
+  // the evicted objects are not sorted, the kept objects are reinserted from
+  // the lowest metric
+  int n_evict = params->n_exam_obj - params->n_keep_obj;
+  candidate_select(params->metrics, params->n_exam_obj, n_evict, params->metric_order);
+  candidate_sort(params->metrics, params->metric_order + n_evict, params->n_keep_obj);
 
   // remove objects
-  int n_evict = params->n_exam_obj - params->n_keep_obj;
   for (int i = 0; i < n_evict; i++) {
-    cache_obj = params->metric_list[i].cache_obj;
+    cache_obj = params->exam_objs[params->metric_order[i]];
     FIFO_Reinsertion_remove_obj(cache, cache_obj);
   }
 
   for (int i = n_evict; i < params->n_exam_obj; i++) {
-    cache_obj = params->metric_list[i].cache_obj;
+    cache_obj = params->exam_objs[params->metric_order[i]];
     move_obj_to_head(&params->q_head, &params->q_tail, cache_obj);
     cache_obj->FIFO_Reinsertion.freq =
         (cache_obj->FIFO_Reinsertion.freq + 1) / 2;
@@ -423,19 +425,6 @@ static void FIFO_Reinsertion_parse_params(cache_t *cache,
 // ****                  cache internal functions                     ****
 // ****                                                               ****
 // ***********************************************************************
-static inline int cmp_list_node(const void *a0, const void *b0) {
-  struct sort_list_node *a = (struct sort_list_node *)a0;
-  struct sort_list_node *b = (struct sort_list_node *)b0;
-
-  if (a->metric > b->metric) {
-    return 1;
-  } else if (a->metric < b->metric) {
-    return -1;
-  } else {
-    return 0;
-  }
-}
-
 static inline double belady_metric(cache_t *cache, cache_obj_t *cache_obj) {
   if (cache_obj->misc.next_access_vtime == -1 ||
       cache_obj->misc.next_access_vtime == INT64_MAX)
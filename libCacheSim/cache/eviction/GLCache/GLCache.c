@@ -42,6 +42,8 @@ static void set_default_params(GLCache_params_t *params) {
   params->rank_intvl = 0.02;
   params->merge_consecutive_segs = true;
   params->retrain_intvl = 86400;
+  params->train_mode = TRAIN_SYNC;
+  params->swap_delay = 100000;
   params->train_source_y = TRAIN_Y_FROM_ONLINE;
   params->type = LOGCACHE_LEARNED;
 
@@ -53,7 +55,7 @@ const char *GLCache_default_params(void) {
   return "segment-size=100, n-merge=2, "
          "type=learned, rank-intvl=0.02,"
          "merge-consecutive-segs=true, train-source-y=online,"
-         "retrain-intvl=86400";
+         "retrain-intvl=86400, train-mode=sync, swap-delay=100000";
 }
 
 static void GLCache_parse_init_params(const char *cache_specific_params,
@@ -76,6 +78,20 @@ static void GLCache_parse_init_params(const char *cache_specific_params,
       params->merge_consecutive_segs = atoi(value);
     } else if (strcasecmp(key, "retrain-intvl") == 0) {
       params->retrain_intvl = atoi(value);
+    } else if (strcasecmp(key, "train-mode") == 0) {
+      if (strcasecmp(value, "sync") == 0) {
+        params->train_mode = TRAIN_SYNC;
+      } else if (strcasecmp(value, "async") == 0) {
+        params->train_mode = TRAIN_ASYNC;
+      } else if (strcasecmp(value, "deterministic") == 0) {
+        params->train_mode = TRAIN_DETERMINISTIC;
+      } else {
+        ERROR("Unknown train-mode %s, support sync/async/deterministic\n",
+              value);
+        exit(1);
+      }
+    } else if (strcasecmp(key, "swap-delay") == 0) {
+      params->swap_delay = atoll(value);
     } else if (strcasecmp(key, "train-source-y") == 0) {
       if (strcasecmp(value, "online") == 0) {
         params->train_source_y = TRAIN_Y_FROM_ONLINE;
@@ -174,6 +190,14 @@ cache_t *GLCache_init(const common_cache_params_t ccache_params,
       abort();
   };
 
+  if (params->train_mode == TRAIN_ASYNC) {
+    strncat(cache->cache_name, "-async",
+            CACHE_NAME_ARRAY_LEN - strlen(cache->cache_name) - 1);
+  } else if (params->train_mode == TRAIN_DETERMINISTIC) {
+    strncat(cache->cache_name, "-deterministic",
+            CACHE_NAME_ARRAY_LEN - strlen(cache->cache_name) - 1);
+  }
+
   init_global_params();
   init_seg_sel(cache);
   init_obj_sel(cache);
@@ -209,6 +233,13 @@ static void GLCache_free(cache_t *cache) {
   bucket_t *bkt = &params->train_bucket;
   segment_t *seg = bkt->first_seg, *next_seg;
 
+  if (params->learner.training) {
+    swap_model(cache);
+  }
+  if (params->learner.n_train > 0) {
+    safe_call(XGBoosterFree(params->learner.booster));
+  }
+
   while (seg != NULL) {
     next_seg = seg->next_seg;
     my_free(sizeof(cache_obj_t) * params->segment_size, seg->objs);
@@ -280,6 +311,9 @@ static bool GLCache_get(cache_t *cache, const request_t *req) {
       params->type == LOGCACHE_ITEM_ORACLE) {
     /* generate training data by taking a snapshot */
     learner_t *l = &params->learner;
+    if (l->training) {
+      poll_model(cache);
+    }
     if (l->last_train_rtime > 0 &&
         params->curr_rtime - l->last_train_rtime >= params->retrain_intvl + 1) {
       train(cache);
@@ -473,6 +507,15 @@ bool GLCache_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+/**
+ * @brief the number of models that have been swapped in, a model trained in
+ * the background is counted when it is installed, not when training starts
+ */
+int64_t GLCache_get_n_installed_model(const cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  return params->learner.n_train > 0 ? params->learner.n_train : 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
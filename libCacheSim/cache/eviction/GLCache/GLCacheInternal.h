@@ -1,5 +1,6 @@
 #pragma once
 
+#include <pthread.h>
 #include <xgboost/c_api.h>
 
 #include "../../../include/libCacheSim/cache.h"
@@ -31,6 +32,17 @@ typedef enum training_source {
   TRAIN_Y_FROM_ORACLE,
 } train_source_e;
 
+typedef enum train_mode {
+  /* train on the request path */
+  TRAIN_SYNC = 0,
+  /* train on a background thread, swap the model in as soon as it is ready */
+  TRAIN_ASYNC = 1,
+  /* train on a background thread, swap the model in swap_delay requests after
+   * training starts (waiting for the thread if needed), so results do not
+   * depend on the training speed */
+  TRAIN_DETERMINISTIC = 2,
+} train_mode_e;
+
 typedef struct {
   /* rolling stat on hits,
    * number of hits in the N_FEATURE_TIME_WINDOW min, 10min, hour */
@@ -50,7 +62,17 @@ typedef struct learner {
   BoosterHandle booster;   // model
   DMatrixHandle train_dm;  // training data
   DMatrixHandle valid_dm;  // validation data
-  DMatrixHandle inf_dm;    // inference data
+
+  /* background training, the trainer only touches train_dm, valid_dm,
+   * next_n_valid_samples, next_booster and model_ready */
+  pthread_t trainer;
+  bool training; /* a model is being trained or waiting to be swapped in */
+  bool model_ready;
+  BoosterHandle next_booster;
+  int next_n_valid_samples;
+  int64_t train_start_vtime;
+  /* time the request path waited for the trainer */
+  int64_t train_wait_usec;
 
   /* learner stat */
   int n_train;
@@ -180,6 +202,8 @@ typedef struct {
   // lowest utility) or we merge non-consecutive segments based on ranking
   bool merge_consecutive_segs;
   int retrain_intvl;
+  train_mode_e train_mode;
+  int64_t swap_delay;
   train_source_e train_source_y;
   GLCache_type_e type;
   double rank_intvl;
@@ -279,6 +303,12 @@ void train(cache_t *cache);
 
 void inference(cache_t *cache);
 
+/* swap in the model trained in the background if it is due */
+void poll_model(cache_t *cache);
+
+/* wait for the background training and swap in its model */
+void swap_model(cache_t *cache);
+
 /************* data preparation *****************/
 void snapshot_segs_to_training_data(cache_t *cache);
 
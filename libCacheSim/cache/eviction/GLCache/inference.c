@@ -62,21 +62,6 @@ static int prepare_inference_data(cache_t *cache) {
   DEBUG_ASSERT(inv_sample_ratio > 1 ||
                params->n_in_use_segs == (int32_t)n_segs);
 
-  if (params->learner.n_inference > 0) {
-    safe_call(XGDMatrixFree(learner->inf_dm));
-  }
-  safe_call(XGDMatrixCreateFromMat(learner->inference_x, n_segs,
-                                   learner->n_feature, -2, &learner->inf_dm));
-
-  // convert to array interface format
-  char str_n_segs[128];
-  snprintf(
-      str_n_segs, sizeof(str_n_segs),
-      "{\"data\": [%llu],\"shape\": [1],\"typestr\": \"<u4\",\"version\": 3}",
-      (unsigned long long)(uintptr_t)&n_segs);
-  safe_call(
-      XGDMatrixSetInfoFromInterface(learner->inf_dm, "group", str_n_segs));
-
   return n_segs;
 }
 
@@ -95,12 +80,25 @@ void inference_xgboost(cache_t *cache) {
   FILE *f = fopen(filename, "a");
 #endif
 
-  bst_ulong out_len = 0;
-  // TODO: use XGBoosterPredictFromDense to avoid copy
-  // https://github.com/dmlc/xgboost/blob/36346f8f563ef79bae94604e60483fb0bf4c2661/demo/c-api/inference/inference.c
-  safe_call(XGBoosterPredict(learner->booster, learner->inf_dm, 0, 0, 0,
-                             &out_len, &pred));
-  DEBUG_ASSERT(out_len == (bst_ulong)n_segs);
+  /* predict directly from the feature matrix (in array interface format)
+   * instead of copying it into a DMatrix, -2 marks missing values as in the
+   * training matrices */
+  static const char *predict_config =
+      "{\"type\": 0, \"training\": false, \"iteration_begin\": 0, "
+      "\"iteration_end\": 0, \"strict_shape\": false, \"missing\": -2}";
+  char array_interface[256];
+  snprintf(array_interface, sizeof(array_interface),
+           "{\"data\": [%llu, true], \"shape\": [%d, %d], "
+           "\"typestr\": \"<f4\", \"version\": 3}",
+           (unsigned long long)(uintptr_t)learner->inference_x, n_segs,
+           learner->n_feature);
+
+  const bst_ulong *out_shape;
+  bst_ulong out_dim;
+  safe_call(XGBoosterPredictFromDense(learner->booster, array_interface,
+                                      predict_config, NULL, &out_shape,
+                                      &out_dim, &pred));
+  DEBUG_ASSERT(out_dim == 1 && out_shape[0] == (bst_ulong)n_segs);
 
   segment_t **ranked_segs = params->seg_sel.ranked_segs;
 
@@ -1,5 +1,6 @@
 
 #include <math.h>
+#include <pthread.h>
 #include <xgboost/c_api.h>
 
 #include "GLCacheInternal.h"
@@ -19,52 +20,40 @@ static void debug_print_feature_matrix(const DMatrixHandle handle,
   printf("\n");
 }
 
-static void train_xgboost(cache_t *cache) {
-  GLCache_params_t *params = cache->eviction_params;
-  learner_t *learner = &params->learner;
-
-  if (learner->n_train != 0) {
-    safe_call(XGBoosterFree(learner->booster));
-    safe_call(XGDMatrixFree(learner->train_dm));
-    safe_call(XGDMatrixFree(learner->valid_dm));
-  }
-
-  prepare_training_data(cache);
-  // debug_print_feature_matrix(learner->train_dm, 20);
-
-  DMatrixHandle eval_dmats[2] = {learner->train_dm, learner->valid_dm};
+/* train a model, this only touches the data matrices and the new booster so
+ * that it can run on the training thread */
+static void fit_xgboost(DMatrixHandle train_dm, DMatrixHandle valid_dm,
+                        int n_valid_samples, BoosterHandle *booster_p) {
+  DMatrixHandle eval_dmats[2] = {train_dm, valid_dm};
   static const char *eval_names[2] = {"train", "valid"};
   const char *eval_result;
   double train_loss, valid_loss, last_valid_loss = 0;
   int n_stable_iter = 0;
 
-  safe_call(XGBoosterCreate(eval_dmats, 1, &learner->booster));
-  safe_call(XGBoosterSetParam(learner->booster, "booster", "gbtree"));
-  safe_call(XGBoosterSetParam(learner->booster, "verbosity", "1"));
-  safe_call(XGBoosterSetParam(learner->booster, "nthread", "1"));
+  safe_call(XGBoosterCreate(eval_dmats, 1, booster_p));
+  BoosterHandle booster = *booster_p;
+  safe_call(XGBoosterSetParam(booster, "booster", "gbtree"));
+  safe_call(XGBoosterSetParam(booster, "verbosity", "1"));
+  safe_call(XGBoosterSetParam(booster, "nthread", "1"));
 #if OBJECTIVE == REG
-  safe_call(
-      XGBoosterSetParam(learner->booster, "objective", "reg:squarederror"));
+  safe_call(XGBoosterSetParam(booster, "objective", "reg:squarederror"));
 #elif OBJECTIVE == LTR
-  safe_call(XGBoosterSetParam(learner->booster, "objective", "rank:pairwise"));
+  safe_call(XGBoosterSetParam(booster, "objective", "rank:pairwise"));
 #endif
 
   for (int i = 0; i < N_TRAIN_ITER; ++i) {
     // Update the model performance for each iteration
-    safe_call(XGBoosterUpdateOneIter(learner->booster, i, learner->train_dm));
-    if (learner->n_valid_samples < 10) continue;
-    safe_call(XGBoosterEvalOneIter(learner->booster, i, eval_dmats, eval_names,
-                                   2, &eval_result));
+    safe_call(XGBoosterUpdateOneIter(booster, i, train_dm));
+    if (n_valid_samples < 10) continue;
+    safe_call(XGBoosterEvalOneIter(booster, i, eval_dmats, eval_names, 2,
+                                   &eval_result));
 #if OBJECTIVE == REG
     char *train_pos = strstr(eval_result, "train-rmse:") + 11;
     char *valid_pos = strstr(eval_result, "valid-rmse") + 11;
     train_loss = strtof(train_pos, NULL);
     valid_loss = strtof(valid_pos, NULL);
 
-    // DEBUG("%.2lf hour, cache size %.2lf MB, iter %d, train loss %.4lf, valid
-    // loss %.4lf\n",
-    //     (double) params->curr_rtime / 3600.0,
-    //     (double) cache->cache_size / 1024.0 / 1024.0,
+    // DEBUG("iter %d, train loss %.4lf, valid loss %.4lf\n",
     //     i, train_loss, valid_loss);
 
     if (fabs(last_valid_loss - valid_loss) / valid_loss < 0.01) {
@@ -84,6 +73,18 @@ static void train_xgboost(cache_t *cache) {
 #error
 #endif
   }
+}
+
+/* called on the request path once the new model is in learner->booster */
+static void finish_training(cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  /* the training data is copied into the matrices, which are not needed once
+   * the model is trained */
+  safe_call(XGDMatrixFree(learner->train_dm));
+  safe_call(XGDMatrixFree(learner->valid_dm));
+
 #ifndef __APPLE__
   safe_call(XGBoosterBoostedRounds(learner->booster, &learner->n_trees));
 #endif
@@ -107,6 +108,92 @@ static void train_xgboost(cache_t *cache) {
 #endif
 }
 
+static void train_xgboost(cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  if (learner->n_train != 0) {
+    safe_call(XGBoosterFree(learner->booster));
+  }
+
+  prepare_training_data(cache);
+  // debug_print_feature_matrix(learner->train_dm, 20);
+
+  fit_xgboost(learner->train_dm, learner->valid_dm, learner->n_valid_samples,
+              &learner->booster);
+  finish_training(cache);
+  learner->n_train += 1;
+}
+
+static void *train_xgboost_thread(void *arg) {
+  learner_t *learner = arg;
+
+  fit_xgboost(learner->train_dm, learner->valid_dm,
+              learner->next_n_valid_samples, &learner->next_booster);
+  __atomic_store_n(&learner->model_ready, true, __ATOMIC_RELEASE);
+
+  return NULL;
+}
+
+/* snapshot the training data into matrices on the request path and train on a
+ * background thread, the current model keeps serving until the new one is
+ * swapped in */
+static void train_xgboost_async(cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  /* one model is trained at a time */
+  if (learner->training) {
+    swap_model(cache);
+  }
+
+  prepare_training_data(cache);
+
+  learner->next_n_valid_samples = learner->n_valid_samples;
+  learner->train_start_vtime = params->curr_vtime;
+  learner->model_ready = false;
+  learner->training = true;
+  if (pthread_create(&learner->trainer, NULL, train_xgboost_thread, learner) !=
+      0) {
+    ERROR("GLCache: failed to create the training thread\n");
+  }
+}
+
+void swap_model(cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  DEBUG_ASSERT(learner->training);
+  uint64_t start_time = gettime_usec();
+  pthread_join(learner->trainer, NULL);
+  learner->train_wait_usec += (int64_t)(gettime_usec() - start_time);
+
+  if (learner->n_train > 0) {
+    safe_call(XGBoosterFree(learner->booster));
+  }
+  learner->booster = learner->next_booster;
+  learner->next_booster = NULL;
+  learner->training = false;
+
+  finish_training(cache);
+  learner->n_train += 1;
+}
+
+void poll_model(cache_t *cache) {
+  GLCache_params_t *params = cache->eviction_params;
+  learner_t *learner = &params->learner;
+
+  if (!learner->training) return;
+
+  if (params->train_mode == TRAIN_DETERMINISTIC) {
+    if (params->curr_vtime - learner->train_start_vtime >= params->swap_delay) {
+      swap_model(cache);
+    }
+  } else if (__atomic_load_n(&learner->model_ready, __ATOMIC_ACQUIRE)) {
+    swap_model(cache);
+  }
+}
+
 void train(cache_t *cache) {
   GLCache_params_t *params = (GLCache_params_t *)cache->eviction_params;
 
@@ -119,13 +206,17 @@ void train(cache_t *cache) {
     safe_call(XGBoosterLoadModel(learner->booster, s));
     INFO("Load model %s\n", s);
   }
+  params->learner.n_train += 1;
 #else
-  train_xgboost(cache);
+  if (params->train_mode == TRAIN_SYNC) {
+    train_xgboost(cache);
+  } else {
+    train_xgboost_async(cache);
+  }
 #endif
 
   uint64_t end_time = gettime_usec();
   // INFO("training time %.4lf sec\n", (end_time - start_time) / 1000000.0);
-  params->learner.n_train += 1;
   params->learner.last_train_rtime = params->curr_rtime;
   params->learner.n_train_samples = 0;
   params->learner.n_valid_samples = 0;
@@ -1,5 +1,6 @@
 /* Hyperbolic caching */
 
+#include "../../dataStructure/candidateSelect.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -9,6 +10,9 @@ extern "C" {
 
 typedef struct Hyperbolic_params {
   int n_sample;
+  // the sampled objects and their scores
+  cache_obj_t **samples;
+  double *scores;
 } Hyperbolic_params_t;
 
 // ***********************************************************************
@@ -63,6 +67,8 @@ cache_t *Hyperbolic_init(const common_cache_params_t ccache_params,
   if (cache_specific_params != NULL) {
     Hyperbolic_parse_params(cache, cache_specific_params);
   }
+  params->samples = my_malloc_n(cache_obj_t *, params->n_sample);
+  params->scores = my_malloc_n(double, params->n_sample);
 
   if (ccache_params.consider_obj_metadata) {
     // freq + age
@@ -81,6 +87,8 @@ cache_t *Hyperbolic_init(const common_cache_params_t ccache_params,
  */
 static void Hyperbolic_free(cache_t *cache) {
   Hyperbolic_params_t *params = cache->eviction_params;
+  my_free(sizeof(cache_obj_t *) * params->n_sample, params->samples);
+  my_free(sizeof(double) * params->n_sample, params->scores);
   my_free(sizeof(Hyperbolic_params_t), params);
   cache_struct_free(cache);
 }
@@ -166,17 +174,17 @@ static cache_obj_t *Hyperbolic_insert(cache_t *cache, const request_t *req) {
  */
 static cache_obj_t *Hyperbolic_to_evict(cache_t *cache, const request_t *req) {
   Hyperbolic_params_t *params = cache->eviction_params;
-  cache_obj_t *best_candidate = NULL, *sampled_obj;
-  double best_candidate_score = 1.0e16, sampled_obj_score;
+  cache_obj_t *best_candidate = NULL;
   for (int i = 0; i < params->n_sample; i++) {
-    sampled_obj = hashtable_rand_obj(cache->hashtable);
+    cache_obj_t *sampled_obj = hashtable_rand_obj(cache->hashtable);
     double age =
         (double)(cache->n_req - sampled_obj->hyperbolic.vtime_enter_cache);
-    sampled_obj_score = 1.0e8 * (double)sampled_obj->hyperbolic.freq / age;
-    if (best_candidate_score > sampled_obj_score) {
-      best_candidate = sampled_obj;
-      best_candidate_score = sampled_obj_score;
-    }
+    params->samples[i] = sampled_obj;
+    params->scores[i] = 1.0e8 * (double)sampled_obj->hyperbolic.freq / age;
+  }
+  int best = candidate_argmin(params->scores, params->n_sample);
+  if (best >= 0 && params->scores[best] < 1.0e16) {
+    best_candidate = params->samples[best];
   }
 
   cache->to_evict_candidate = best_candidate;
@@ -16,16 +16,18 @@
  *
  * this module uses linkedList to order requests by frequency,
  * which gives an O(1) time complexity at each request,
- * the drawback of this implementation is the memory usage, because two pointers
- * are associated with each obj_id
+ * the freq nodes are linked in freq order (see dataStructure/freqList.h),
+ * a hit moves the object to the next node without looking up the node
+ * the drawback of this implementation is the memory usage, because three
+ * pointers are associated with each obj_id
  *
  * this implementation do not keep an object's frequency after evicting from
  * cache so objects are inserted with frequency 1
  */
 
-#include <glib.h>
-
+#include "../../dataStructure/freqList.h"
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/checkpoint.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -33,10 +35,7 @@ extern "C" {
 #endif
 
 typedef struct LFU_params {
-  freq_node_t *freq_one_node;
-  GHashTable *freq_map;
-  int64_t min_freq;
-  int64_t max_freq;
+  freq_list_t *freq_list;
 } LFU_params_t;
 
 // ***********************************************************************
@@ -54,11 +53,8 @@ static cache_obj_t *LFU_to_evict(cache_t *cache, const request_t *req);
 static void LFU_evict(cache_t *cache, const request_t *req);
 static bool LFU_remove(cache_t *cache, const obj_id_t obj_id);
 static void LFU_remove_obj(cache_t *cache, cache_obj_t *obj);
-
-/* internal functions */
-static inline void free_freq_node(void *list_node);
-static inline freq_node_t *get_min_freq_node(LFU_params_t *params);
-static inline void update_min_freq(LFU_params_t *params);
+static bool LFU_serialize(const cache_t *cache, FILE *f);
+static bool LFU_deserialize(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -84,9 +80,11 @@ cache_t *LFU_init(const common_cache_params_t ccache_params,
   cache->evict = LFU_evict;
   cache->remove = LFU_remove;
   cache->to_evict = LFU_to_evict;
+  cache->serialize = LFU_serialize;
+  cache->deserialize = LFU_deserialize;
 
   if (ccache_params.consider_obj_metadata) {
-    cache->obj_md_size = 8 * 2;
+    cache->obj_md_size = 8 * 3;
   } else {
     cache->obj_md_size = 0;
   }
@@ -94,20 +92,7 @@ cache_t *LFU_init(const common_cache_params_t ccache_params,
   LFU_params_t *params = my_malloc_n(LFU_params_t, 1);
   memset(params, 0, sizeof(LFU_params_t));
   cache->eviction_params = params;
-
-  freq_node_t *freq_node = my_malloc_n(freq_node_t, 1);
-  freq_node->freq = 1;
-  freq_node->n_obj = 0;
-  freq_node->first_obj = NULL;
-  freq_node->last_obj = NULL;
-
-  params->freq_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
-                                           (GDestroyNotify)free_freq_node);
-  g_hash_table_insert(params->freq_map, GSIZE_TO_POINTER(1), freq_node);
-
-  params->min_freq = 1;
-  params->max_freq = 1;
-  params->freq_one_node = freq_node;
+  params->freq_list = freq_list_init();
 
   return cache;
 }
@@ -119,7 +104,7 @@ cache_t *LFU_init(const common_cache_params_t ccache_params,
  */
 static void LFU_free(cache_t *cache) {
   LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
-  g_hash_table_destroy(params->freq_map);
+  freq_list_free(params->freq_list);
   my_free(sizeof(LFU_params_t), params);
   cache_struct_free(cache);
 }
@@ -169,51 +154,8 @@ static cache_obj_t *LFU_find(cache_t *cache, const request_t *req,
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
 
   if (cache_obj && likely(update_cache)) {
-    /* freq incr and move to next freq node */
-    cache_obj->lfu.freq += 1;
-    if ((int64_t)params->max_freq < cache_obj->lfu.freq) {
-      params->max_freq = cache_obj->lfu.freq;
-    }
-
-    // find the freq_node this object belongs to and update its info
-    gpointer old_key = GSIZE_TO_POINTER(cache_obj->lfu.freq - 1);
-    freq_node_t *old_node = g_hash_table_lookup(params->freq_map, old_key);
-    DEBUG_ASSERT(old_node != NULL);
-    DEBUG_ASSERT(old_node->freq == cache_obj->lfu.freq - 1);
-    DEBUG_ASSERT(old_node->n_obj > 0);
-    old_node->n_obj -= 1;
-    remove_obj_from_list(&old_node->first_obj, &old_node->last_obj, cache_obj);
-
-    // find the new freq_node this object should move to
-    gpointer new_key = GSIZE_TO_POINTER(cache_obj->lfu.freq);
-    freq_node_t *new_node = g_hash_table_lookup(params->freq_map, new_key);
-    if (new_node == NULL) {
-      new_node = my_malloc_n(freq_node_t, 1);
-      memset(new_node, 0, sizeof(freq_node_t));
-      new_node->freq = cache_obj->lfu.freq;
-      g_hash_table_insert(params->freq_map, new_key, new_node);
-      VVVERBOSE("allocate new %ld %d %p %p\n", new_node->freq, new_node->n_obj,
-                new_node->first_obj, new_node->last_obj);
-    } else {
-      // it could be new_node is empty
-      DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
-    }
-
-    append_obj_to_tail(&new_node->first_obj, &new_node->last_obj, cache_obj);
-    new_node->n_obj += 1;
-
-    if (old_node->n_obj == 0) {
-      if ((int64_t)params->min_freq == old_node->freq) {
-        // if the old freq_node has one object and is the min_freq_node, after
-        // removing this object, the freq_node will have no object,
-        // then we should update min_freq to the new freq
-        update_min_freq(params);
-      }
-
-      if (old_node->freq != 1) {
-        g_hash_table_remove(params->freq_map, old_key);
-      }
-    }
+    /* freq incr and move to the next freq node */
+    freq_list_move(params->freq_list, cache_obj, cache_obj->lfu.freq + 1);
   }
   return cache_obj;
 }
@@ -230,15 +172,9 @@ static cache_obj_t *LFU_find(cache_t *cache, const request_t *req,
  */
 static cache_obj_t *LFU_insert(cache_t *cache, const request_t *req) {
   LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
-  params->min_freq = 1;
-  freq_node_t *freq_one_node = params->freq_one_node;
 
   cache_obj_t *cache_obj = cache_insert_base(cache, req);
-  cache_obj->lfu.freq = 1;
-  freq_one_node->n_obj += 1;
-
-  append_obj_to_tail(&freq_one_node->first_obj, &freq_one_node->last_obj,
-                     cache_obj);
+  freq_list_add(params->freq_list, NULL, cache_obj, 1);
 
   return cache_obj;
 }
@@ -255,8 +191,8 @@ static cache_obj_t *LFU_insert(cache_t *cache, const request_t *req) {
  */
 static cache_obj_t *LFU_to_evict(cache_t *cache, const request_t *req) {
   LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
-  freq_node_t *min_freq_node = get_min_freq_node(params);
-  return min_freq_node->first_obj;
+  freq_node_t *min_freq_node = freq_list_min(params->freq_list);
+  return min_freq_node == NULL ? NULL : min_freq_node->first_obj;
 }
 
 /**
@@ -270,23 +206,12 @@ static cache_obj_t *LFU_to_evict(cache_t *cache, const request_t *req) {
 static void LFU_evict(cache_t *cache, const request_t *req) {
   LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
 
-  freq_node_t *min_freq_node = get_min_freq_node(params);
-  min_freq_node->n_obj--;
+  freq_node_t *min_freq_node = freq_list_min(params->freq_list);
+  DEBUG_ASSERT(min_freq_node != NULL && min_freq_node->n_obj > 0);
 
+  /* objects of the same freq are evicted in FIFO order */
   cache_obj_t *obj_to_evict = min_freq_node->first_obj;
-
-  remove_obj_from_list(&min_freq_node->first_obj, &min_freq_node->last_obj,
-                       obj_to_evict);
-  if (min_freq_node->n_obj == 0) {
-    /* the only obj of curr freq */
-    DEBUG_ASSERT(min_freq_node->first_obj == NULL);
-    DEBUG_ASSERT(min_freq_node->last_obj == NULL);
-
-    // we delay the min_freq update to next eviction
-    params->min_freq = 0;
-    // /* update min freq */
-    // update_min_freq(params);
-  }
+  freq_list_remove(params->freq_list, obj_to_evict);
 
   cache_evict_base(cache, obj_to_evict, true);
 }
@@ -295,20 +220,8 @@ void LFU_remove_obj(cache_t *cache, cache_obj_t *obj) {
   assert(obj != NULL);
   LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
 
-  gpointer key = GSIZE_TO_POINTER(obj->lfu.freq);
-  freq_node_t *freq_node = g_hash_table_lookup(params->freq_map, key);
-  DEBUG_ASSERT(freq_node->freq == obj->lfu.freq);
-  DEBUG_ASSERT(freq_node->n_obj > 0);
-
-  freq_node->n_obj--;
-  remove_obj_from_list(&freq_node->first_obj, &freq_node->last_obj, obj);
-
+  freq_list_remove(params->freq_list, obj);
   cache_remove_obj_base(cache, obj, true);
-
-  if ((int64_t)freq_node->freq == params->min_freq && freq_node->n_obj == 0) {
-    /* update min freq */
-    update_min_freq(params);
-  }
 }
 
 /**
@@ -337,44 +250,42 @@ bool LFU_remove(cache_t *cache, obj_id_t obj_id) {
 
 // ***********************************************************************
 // ****                                                               ****
-// ****                  cache internal functions                     ****
+// ****                     checkpoint functions                      ****
 // ****                                                               ****
 // ***********************************************************************
-static inline void free_freq_node(void *list_node) {
-  my_free(sizeof(freq_node_t), list_node);
-}
-
-static inline freq_node_t *get_min_freq_node(LFU_params_t *params) {
-  freq_node_t *min_freq_node = NULL;
-  if (params->min_freq == 1) {
-    min_freq_node = params->freq_one_node;
-  } else {
-    if (params->min_freq == 0) {
-      /* update min freq */
-      update_min_freq(params);
+/**
+ * @brief write the objects from the lowest to the highest freq, and objects
+ * of the same freq in the order they reached the freq, see checkpoint.h
+ */
+static bool LFU_serialize(const cache_t *cache, FILE *f) {
+  LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
+  int64_t n_obj = cache->n_obj;
+  if (!checkpoint_write(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (freq_node_t *node = params->freq_list->head; node != NULL;
+       node = node->next) {
+    for (cache_obj_t *obj = node->first_obj; obj != NULL;
+         obj = obj->queue.next) {
+      if (!checkpoint_write_obj(f, obj, obj->lfu.freq)) return false;
     }
-    min_freq_node = g_hash_table_lookup(params->freq_map,
-                                        GSIZE_TO_POINTER(params->min_freq));
   }
-
-  DEBUG_ASSERT(min_freq_node != NULL);
-  DEBUG_ASSERT(min_freq_node->first_obj != NULL);
-  DEBUG_ASSERT(min_freq_node->n_obj > 0);
-
-  return min_freq_node;
+  return true;
 }
 
-static inline void update_min_freq(LFU_params_t *params) {
-  int64_t old_min_freq = params->min_freq;
-  for (int64_t freq = params->min_freq + 1; freq <= params->max_freq; freq++) {
-    freq_node_t *node =
-        g_hash_table_lookup(params->freq_map, GSIZE_TO_POINTER(freq));
-    if (node != NULL && node->n_obj > 0) {
-      params->min_freq = freq;
-      break;
-    }
+static bool LFU_deserialize(cache_t *cache, FILE *f) {
+  LFU_params_t *params = (LFU_params_t *)(cache->eviction_params);
+  int64_t n_obj;
+  if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+
+  /* the freq does not decrease, so the search starts at the last node */
+  freq_node_t *node = NULL;
+  for (int64_t i = 0; i < n_obj; i++) {
+    int64_t freq;
+    cache_obj_t *obj = checkpoint_read_obj(cache, f, &freq);
+    if (obj == NULL) return false;
+    node = freq_list_add(params->freq_list, node, obj, freq);
   }
-  DEBUG_ASSERT(params->min_freq > old_min_freq);
+  return true;
 }
 
 #ifdef __cplusplus
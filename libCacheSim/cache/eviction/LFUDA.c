@@ -6,8 +6,7 @@
 //  Copyright © 2016 Juncheng. All rights reserved.
 //
 
-#include <glib.h>
-
+#include "../../dataStructure/freqList.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -16,10 +15,11 @@ extern "C" {
 #endif
 
 typedef struct LFUDA_params {
-  GHashTable *freq_map;
-  freq_node_t *freq_one_node;
+  freq_list_t *freq_list;
+  // the cache age, objects are inserted with min_freq + 1
   int64_t min_freq;
-  int64_t max_freq;
+  // the node of min_freq, NULL if no object has min_freq
+  freq_node_t *min_freq_node;
 } LFUDA_params_t;
 
 // ***********************************************************************
@@ -39,10 +39,9 @@ static bool LFUDA_remove(cache_t *cache, const obj_id_t obj_id);
 static void LFUDA_remove_obj(cache_t *cache, cache_obj_t *obj);
 
 /* internal functions */
-static inline void free_freq_node(void *list_node);
 static inline freq_node_t *get_min_freq_node(LFUDA_params_t *params);
-static inline void update_min_freq(LFUDA_params_t *params);
-static void free_list_node(void *list_node);
+static inline void update_min_freq(LFUDA_params_t *params,
+                                   freq_node_t *next_node);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -69,7 +68,7 @@ cache_t *LFUDA_init(const common_cache_params_t ccache_params,
   cache->to_evict = LFUDA_to_evict;
 
   if (ccache_params.consider_obj_metadata) {
-    cache->obj_md_size = 8 * 2;
+    cache->obj_md_size = 8 * 3;
   } else {
     cache->obj_md_size = 0;
   }
@@ -77,19 +76,9 @@ cache_t *LFUDA_init(const common_cache_params_t ccache_params,
   LFUDA_params_t *params = my_malloc_n(LFUDA_params_t, 1);
   cache->eviction_params = params;
 
+  params->freq_list = freq_list_init();
   params->min_freq = 0;
-  params->max_freq = 0;
-
-  freq_node_t *freq_node = my_malloc_n(freq_node_t, 1);
-  params->freq_one_node = freq_node;
-  freq_node->freq = 1;
-  freq_node->n_obj = 0;
-  freq_node->first_obj = NULL;
-  freq_node->last_obj = NULL;
-
-  params->freq_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
-                                           (GDestroyNotify)free_list_node);
-  g_hash_table_insert(params->freq_map, GSIZE_TO_POINTER(1), freq_node);
+  params->min_freq_node = NULL;
 
   return cache;
 }
@@ -101,7 +90,8 @@ cache_t *LFUDA_init(const common_cache_params_t ccache_params,
  */
 static void LFUDA_free(cache_t *cache) {
   LFUDA_params_t *params = (LFUDA_params_t *)(cache->eviction_params);
-  g_hash_table_destroy(params->freq_map);
+  freq_list_free(params->freq_list);
+  my_free(sizeof(LFUDA_params_t), params);
   cache_struct_free(cache);
 }
 
@@ -151,43 +141,24 @@ static cache_obj_t *LFUDA_find(cache_t *cache, const request_t *req,
 
   if (cache_obj && likely(update_cache)) {
     /* freq incr and move to next freq node */
-    cache_obj->lfu.freq += params->min_freq;
-    params->max_freq = params->max_freq < cache_obj->lfu.freq
-                           ? cache_obj->lfu.freq
-                           : params->max_freq;
-
-    gpointer old_key = GSIZE_TO_POINTER(cache_obj->lfu.freq - params->min_freq);
-    freq_node_t *old_node = g_hash_table_lookup(params->freq_map, old_key);
-    DEBUG_ASSERT(old_node != NULL);
-    DEBUG_ASSERT(old_node->freq == cache_obj->lfu.freq - params->min_freq);
-    DEBUG_ASSERT(old_node->n_obj > 0);
-    old_node->n_obj--;
-    remove_obj_from_list(&old_node->first_obj, &old_node->last_obj, cache_obj);
+    freq_node_t *old_node = cache_obj->lfu.freq_node;
+    freq_node_t *prev_node = old_node->prev;
+    freq_node_t *next_node = old_node->next;
+    bool old_node_emptied = old_node->n_obj == 1;
+    int64_t new_freq = cache_obj->lfu.freq + params->min_freq;
+    freq_list_remove(params->freq_list, cache_obj);
 
     // if the old freq_node has one object and is the min_freq_node, after
     // removing this object, the freq_node will have no object,
-    // then we should update min_freq to the new freq
-    if (params->min_freq == old_node->freq && old_node->n_obj == 0) {
-      /* update min freq */
-      update_min_freq(params);
-    }
-
-    gpointer new_key = GSIZE_TO_POINTER(cache_obj->lfu.freq);
-    freq_node_t *new_node = g_hash_table_lookup(params->freq_map, new_key);
-    if (new_node == NULL) {
-      new_node = my_malloc_n(freq_node_t, 1);
-      memset(new_node, 0, sizeof(freq_node_t));
-      new_node->freq = cache_obj->lfu.freq;
-      g_hash_table_insert(params->freq_map, new_key, new_node);
-      VVVERBOSE("allocate new %ld %d %p %p\n", new_node->freq, new_node->n_obj,
-                new_node->first_obj, new_node->last_obj);
-    } else {
-      // it could be new_node is empty
-      DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
+    // then we should update min_freq to the next freq
+    if (old_node == params->min_freq_node && old_node_emptied) {
+      update_min_freq(params, next_node);
     }
 
-    append_obj_to_tail(&new_node->first_obj, &new_node->last_obj, cache_obj);
-    new_node->n_obj += 1;
+    // the new freq is no lower than the old one, search from the old node or
+    // from the node before it if the old node is released
+    freq_list_add(params->freq_list, old_node_emptied ? prev_node : old_node,
+                  cache_obj, new_freq);
   }
 
   return cache_obj;
@@ -207,22 +178,8 @@ static cache_obj_t *LFUDA_find(cache_t *cache, const request_t *req,
 static cache_obj_t *LFUDA_insert(cache_t *cache, const request_t *req) {
   LFUDA_params_t *params = (LFUDA_params_t *)(cache->eviction_params);
   cache_obj_t *cache_obj = cache_insert_base(cache, req);
-  cache_obj->lfu.freq = params->min_freq + 1;
-
-  gpointer key = GSIZE_TO_POINTER(cache_obj->lfu.freq);
-  freq_node_t *new_node = g_hash_table_lookup(params->freq_map, key);
-  if (new_node == NULL) {
-    new_node = my_malloc_n(freq_node_t, 1);
-    memset(new_node, 0, sizeof(freq_node_t));
-    new_node->freq = cache_obj->lfu.freq;
-    g_hash_table_insert(params->freq_map, key, new_node);
-    params->max_freq = params->max_freq < cache_obj->lfu.freq ? cache_obj->lfu.freq : params->max_freq;
-  } else {
-    DEBUG_ASSERT(new_node->freq == cache_obj->lfu.freq);
-  }
-
-  append_obj_to_tail(&new_node->first_obj, &new_node->last_obj, cache_obj);
-  new_node->n_obj += 1;
+  freq_list_add(params->freq_list, params->min_freq_node, cache_obj,
+                params->min_freq + 1);
 
   return cache_obj;
 }
@@ -240,7 +197,7 @@ static cache_obj_t *LFUDA_insert(cache_t *cache, const request_t *req) {
 static cache_obj_t *LFUDA_to_evict(cache_t *cache, const request_t *req) {
   LFUDA_params_t *params = (LFUDA_params_t *)(cache->eviction_params);
   freq_node_t *min_freq_node = get_min_freq_node(params);
-  return min_freq_node->first_obj;
+  return min_freq_node == NULL ? NULL : min_freq_node->first_obj;
 }
 
 /**
@@ -259,19 +216,16 @@ static void LFUDA_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj_to_evict = min_freq_node->first_obj;
 
   params->min_freq = min_freq_node->freq;
-  min_freq_node->n_obj--;
-  remove_obj_from_list(&min_freq_node->first_obj, &min_freq_node->last_obj,
-                       obj_to_evict);
+  params->min_freq_node = min_freq_node;
+  freq_node_t *next_node = min_freq_node->next;
+  bool emptied = min_freq_node->n_obj == 1;
+  freq_list_remove(params->freq_list, obj_to_evict);
 
   cache_evict_base(cache, obj_to_evict, true);
 
-  if (min_freq_node->n_obj == 0) {
+  if (emptied) {
     /* the only obj of curr freq */
-    DEBUG_ASSERT(min_freq_node->first_obj == NULL);
-    DEBUG_ASSERT(min_freq_node->last_obj == NULL);
-
-    /* update min freq */
-    update_min_freq(params);
+    update_min_freq(params, next_node);
   }
 }
 
@@ -279,22 +233,16 @@ static void LFUDA_remove_obj(cache_t *cache, cache_obj_t *obj) {
   assert(obj != NULL);
   LFUDA_params_t *params = (LFUDA_params_t *)(cache->eviction_params);
 
-  gpointer key = GSIZE_TO_POINTER(obj->lfu.freq);
-  freq_node_t *freq_node = g_hash_table_lookup(params->freq_map, key);
-  DEBUG_ASSERT(freq_node->freq == obj->lfu.freq);
-  DEBUG_ASSERT(freq_node->n_obj > 0);
-
-  freq_node->n_obj--;
-  remove_obj_from_list(&freq_node->first_obj, &freq_node->last_obj, obj);
+  freq_node_t *freq_node = obj->lfu.freq_node;
+  freq_node_t *next_node = freq_node->next;
+  bool emptied = freq_node->n_obj == 1;
+  freq_list_remove(params->freq_list, obj);
 
   cache_remove_obj_base(cache, obj, true);
 
-  if (freq_node->freq == params->min_freq && freq_node->n_obj == 0) {
-    DEBUG_ASSERT(freq_node->first_obj == NULL);
-    DEBUG_ASSERT(freq_node->last_obj == NULL);
-
+  if (freq_node == params->min_freq_node && emptied) {
     /* update min freq */
-    update_min_freq(params);
+    update_min_freq(params, next_node);
   }
 }
 
@@ -328,69 +276,52 @@ static bool LFUDA_remove(cache_t *cache, obj_id_t obj_id) {
 // ****                                                               ****
 // ***********************************************************************
 static freq_node_t *get_min_freq_node(LFUDA_params_t *params) {
-  freq_node_t *min_freq_node = NULL;
-  if (params->min_freq == 0 || params->min_freq == 1) {
-    min_freq_node = params->freq_one_node;
-  } else {
-    DEBUG_ASSERT(params->min_freq > 1);
-    min_freq_node = g_hash_table_lookup(params->freq_map,
-                                        GSIZE_TO_POINTER(params->min_freq));
+  /* no object has min_freq before the first eviction */
+  freq_node_t *min_freq_node = params->min_freq_node;
+  if (min_freq_node == NULL) {
+    min_freq_node = freq_list_min(params->freq_list);
   }
 
-  DEBUG_ASSERT(min_freq_node != NULL);
-  DEBUG_ASSERT(min_freq_node->first_obj != NULL);
-  DEBUG_ASSERT(min_freq_node->n_obj > 0);
+  DEBUG_ASSERT(min_freq_node == NULL || min_freq_node->n_obj > 0);
 
   return min_freq_node;
 }
 
-static void update_min_freq(LFUDA_params_t *params) {
-  int64_t old_min_freq = params->min_freq;
-  for (int64_t freq = params->min_freq + 1; freq <= params->max_freq; freq++) {
-    freq_node_t *node =
-        g_hash_table_lookup(params->freq_map, GSIZE_TO_POINTER(freq));
-    if (node != NULL && node->n_obj > 0) {
-      params->min_freq = freq;
-      break;
-    }
+/* the min_freq node has no object left, the next node is the lowest freq
+ * above min_freq. If there is no such node, min_freq is unchanged */
+static void update_min_freq(LFUDA_params_t *params, freq_node_t *next_node) {
+  params->min_freq_node = next_node;
+  if (next_node != NULL) {
+    DEBUG_ASSERT(next_node->freq > params->min_freq);
+    params->min_freq = next_node->freq;
   }
-  // If cache is empty, min_freq will be unchanged. 
-  DEBUG_ASSERT(params->min_freq >= old_min_freq);
-}
-
-static void free_list_node(void *list_node) {
-  my_free(sizeof(freq_node_t), list_node);
 }
 
 // ****************** internal debug use functions *******************
 static int _verify(cache_t *cache) {
   LFUDA_params_t *LFUDA_params = (LFUDA_params_t *)(cache->eviction_params);
   cache_obj_t *cache_obj, *prev_obj;
-  /* update min freq */
-  for (int64_t freq = 1; freq <= LFUDA_params->max_freq; freq++) {
-    freq_node_t *freq_node =
-        g_hash_table_lookup(LFUDA_params->freq_map, GSIZE_TO_POINTER(freq));
-    if (freq_node != NULL) {
-      int32_t n_obj = 0;
-      cache_obj = freq_node->first_obj;
-      prev_obj = NULL;
-      while (cache_obj != NULL) {
-        n_obj++;
-        DEBUG_ASSERT(cache_obj->lfu.freq == freq);
-        DEBUG_ASSERT(cache_obj->queue.prev == prev_obj);
-        prev_obj = cache_obj;
-        cache_obj = cache_obj->queue.next;
-      }
-      DEBUG_ASSERT(freq_node->n_obj == n_obj);
+  int64_t last_freq = 0;
+  for (freq_node_t *freq_node = LFUDA_params->freq_list->head;
+       freq_node != NULL; freq_node = freq_node->next) {
+    DEBUG_ASSERT(freq_node->freq > last_freq);
+    last_freq = freq_node->freq;
+    int32_t n_obj = 0;
+    cache_obj = freq_node->first_obj;
+    prev_obj = NULL;
+    while (cache_obj != NULL) {
+      n_obj++;
+      DEBUG_ASSERT(cache_obj->lfu.freq == freq_node->freq);
+      DEBUG_ASSERT(cache_obj->lfu.freq_node == freq_node);
+      DEBUG_ASSERT(cache_obj->queue.prev == prev_obj);
+      prev_obj = cache_obj;
+      cache_obj = cache_obj->queue.next;
     }
+    DEBUG_ASSERT(freq_node->n_obj == n_obj);
   }
   return 0;
 }
 
-static inline void free_freq_node(void *list_node) {
-  my_free(sizeof(freq_node_t), list_node);
-}
-
 #ifdef __cplusplus
 }
 #endif
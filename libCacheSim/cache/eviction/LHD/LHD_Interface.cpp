@@ -17,10 +17,13 @@ typedef struct {
 
   int associativity;
   int admission;
+  int n_thread;
 
   candidate_t to_evict_candidate;
 } LHD_params_t;
 
+static const char *DEFAULT_PARAMS = "associativity=32,admission=8,n-thread=1";
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                   function declarations                       ****
@@ -38,6 +41,7 @@ static void LHD_evict(cache_t *cache, const request_t *req);
 static bool LHD_remove(cache_t *cache, const obj_id_t obj_id);
 static int64_t LHD_get_occupied_byte(const cache_t *cache);
 static int64_t LHD_get_n_obj(const cache_t *cache);
+static void LHD_parse_params(cache_t *cache, const char *cache_specific_params);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -87,15 +91,13 @@ cache_t *LHD_init(const common_cache_params_t ccache_params,
   memset(params, 0, sizeof(LHD_params_t));
   cache->eviction_params = params;
 
-  if (params->admission == 0) {
-    params->admission = 8;
-  }
-  if (params->associativity == 0) {
-    params->associativity = 32;
+  LHD_parse_params(cache, DEFAULT_PARAMS);
+  if (cache_specific_params != NULL) {
+    LHD_parse_params(cache, cache_specific_params);
   }
 
-  params->LHD_cache = static_cast<void *>(
-      new LHD(params->associativity, params->admission, cache));
+  params->LHD_cache = static_cast<void *>(new LHD(
+      params->associativity, params->admission, cache, params->n_thread));
 
   return cache;
 }
@@ -108,6 +110,14 @@ cache_t *LHD_init(const common_cache_params_t ccache_params,
 static void LHD_free(cache_t *cache) {
   auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
   auto *lhd = static_cast<repl::LHD *>(params->LHD_cache);
+  if (lhd->getNumReconfigurations() > 0) {
+    DEBUG(
+        "LHD %d reconfigurations, %.2lf ms on average (max %.2lf ms), %.2lf "
+        "ms in total\n",
+        lhd->getNumReconfigurations(),
+        lhd->getTotalReconfigurationMs() / lhd->getNumReconfigurations(),
+        lhd->getMaxReconfigurationMs(), lhd->getTotalReconfigurationMs());
+  }
   delete lhd;
   free(cache->to_evict_candidate);
   my_free(sizeof(LHD_params_t), params);
@@ -326,6 +336,67 @@ static int64_t LHD_get_occupied_byte(const cache_t *cache) {
 
 static int64_t LHD_get_n_obj(const cache_t *cache) { return cache->n_obj; }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                  parameter set up functions                   ****
+// ****                                                               ****
+// ***********************************************************************
+static const char *LHD_current_params(LHD_params_t *params) {
+  static __thread char params_str[128];
+  snprintf(params_str, 128, "associativity=%d,admission=%d,n-thread=%d",
+           params->associativity, params->admission, params->n_thread);
+  return params_str;
+}
+
+static void LHD_parse_params(cache_t *cache,
+                             const char *cache_specific_params) {
+  auto *params = static_cast<LHD_params_t *>(cache->eviction_params);
+  char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
+  char *end;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "associativity") == 0) {
+      params->associativity = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "admission") == 0) {
+      params->admission = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "n-thread") == 0) {
+      params->n_thread = (int)strtol(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
+    } else if (strcasecmp(key, "print") == 0) {
+      printf("current parameters: %s\n", LHD_current_params(params));
+      exit(0);
+    } else {
+      ERROR("%s does not have parameter %s\n", cache->cache_name, key);
+      exit(1);
+    }
+  }
+  free(old_params_str);
+
+  if (params->associativity < 1 || params->admission < 1 ||
+      params->n_thread < 1) {
+    ERROR("LHD associativity, admission and n-thread must be positive\n");
+  }
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,15 +1,18 @@
 #include "lhd.hpp"
 
+#include <chrono>
 #include <sstream>
+#include <thread>
 
 #include "../../../utils/include/mymath.h"
 #include "constants.hpp"
 
 namespace repl {
 
-LHD::LHD(int _associativity, int _admissions, cache_t* _cache)
+LHD::LHD(int _associativity, int _admissions, cache_t* _cache, int _nThreads)
     : ASSOCIATIVITY(_associativity),
       ADMISSIONS(_admissions),
+      NUM_THREADS(_nThreads),
       cache(_cache),
       recentlyAdmitted(ADMISSIONS, INVALID_CANDIDATE) {
   nextReconfiguration = ACCS_PER_RECONFIGURATION;
@@ -163,18 +166,63 @@ void LHD::replaced(candidate_t id) {
   }
 }
 
+// run fn on every class, the classes are split into contiguous ranges, one
+// per thread
+template <typename F>
+static void forEachClass(std::vector<LHD::Class>& classes, int nThreads,
+                         const F& fn) {
+  uint32_t n = classes.size();
+  if (nThreads <= 1) {
+    for (auto& cl : classes) {
+      fn(cl);
+    }
+    return;
+  }
+
+  uint32_t chunk = (n + nThreads - 1) / nThreads;
+  std::vector<std::thread> threads;
+  for (uint32_t begin = chunk; begin < n; begin += chunk) {
+    uint32_t end = std::min(n, begin + chunk);
+    threads.emplace_back([&classes, &fn, begin, end]() {
+      for (uint32_t c = begin; c < end; c++) {
+        fn(classes[c]);
+      }
+    });
+  }
+  for (uint32_t c = 0; c < std::min(n, chunk); c++) {
+    fn(classes[c]);
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+}
+
 void LHD::reconfigure() {
+  auto start = std::chrono::steady_clock::now();
+
+  forEachClass(classes, NUM_THREADS, [this](Class& cl) { updateClass(cl); });
+
   rank_t totalHits = 0;
   rank_t totalEvictions = 0;
   for (auto& cl : classes) {
-    updateClass(cl);
     totalHits += cl.totalHits;
     totalEvictions += cl.totalEvictions;
   }
 
   adaptAgeCoarsening();
 
-  modelHitDensity();
+  forEachClass(classes, NUM_THREADS,
+               [this](Class& cl) { modelHitDensity(cl); });
+
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  totalReconfigurationMs += ms;
+  if (ms > maxReconfigurationMs) {
+    maxReconfigurationMs = ms;
+  }
+  DEBUG("LHD reconfiguration %d: %.2lf ms, hits %g, evictions %g\n",
+        numReconfigurations + 1, ms, totalHits, totalEvictions);
 
   // Just printfs ...
   for (uint32_t c = 0; c < classes.size(); c++) {
@@ -209,29 +257,26 @@ void LHD::updateClass(Class& cl) {
   }
 }
 
-void LHD::modelHitDensity() {
-  for (uint32_t c = 0; c < classes.size(); c++) {
-    rank_t totalEvents =
-        classes[c].hits[MAX_AGE - 1] + classes[c].evictions[MAX_AGE - 1];
-    rank_t totalHits = classes[c].hits[MAX_AGE - 1];
-    rank_t lifetimeUnconditioned = totalEvents;
+void LHD::modelHitDensity(Class& cl) {
+  rank_t totalEvents = cl.hits[MAX_AGE - 1] + cl.evictions[MAX_AGE - 1];
+  rank_t totalHits = cl.hits[MAX_AGE - 1];
+  rank_t lifetimeUnconditioned = totalEvents;
 
-    // we use a small trick here to compute expectation in O(N) by
-    // accumulating all values at later ages in
-    // lifetimeUnconditioned.
+  // we use a small trick here to compute expectation in O(N) by
+  // accumulating all values at later ages in
+  // lifetimeUnconditioned.
 
-    for (age_t a = MAX_AGE - 2; a < MAX_AGE; a--) {
-      totalHits += classes[c].hits[a];
+  for (age_t a = MAX_AGE - 2; a < MAX_AGE; a--) {
+    totalHits += cl.hits[a];
 
-      totalEvents += classes[c].hits[a] + classes[c].evictions[a];
+    totalEvents += cl.hits[a] + cl.evictions[a];
 
-      lifetimeUnconditioned += totalEvents;
+    lifetimeUnconditioned += totalEvents;
 
-      if (totalEvents > 1e-5) {
-        classes[c].hitDensities[a] = totalHits / lifetimeUnconditioned;
-      } else {
-        classes[c].hitDensities[a] = 0.;
-      }
+    if (totalEvents > 1e-5) {
+      cl.hitDensities[a] = totalHits / lifetimeUnconditioned;
+    } else {
+      cl.hitDensities[a] = 0.;
     }
   }
 }
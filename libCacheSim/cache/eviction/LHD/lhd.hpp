@@ -39,7 +39,7 @@ class LHD {
     std::vector<rank_t> hitDensities;
   };
 
-  LHD(int _associativity, int _admissions, cache_t *cache);
+  LHD(int _associativity, int _admissions, cache_t *cache, int _nThreads = 1);
   ~LHD() {}
 
   // called whenever and object is referenced
@@ -53,6 +53,11 @@ class LHD {
 
   void dumpStats(LHDCache::Cache *cache_params) {}
 
+  // the cost of reconfiguration
+  int getNumReconfigurations() const { return numReconfigurations; }
+  double getTotalReconfigurationMs() const { return totalReconfigurationMs; }
+  double getMaxReconfigurationMs() const { return maxReconfigurationMs; }
+
   std::unordered_map<candidate_t, uint32_t> sizeMap;
   // object metadata; indices maps object id -> metadata
   std::vector<Tag> tags;
@@ -97,6 +102,10 @@ class LHD {
   // verbose debugging output?
   static constexpr bool DUMP_RANKS = false;
 
+  // the classes are independent during reconfiguration, so they are split
+  // among this many threads, the result does not depend on it
+  const int NUM_THREADS;
+
   // FIELDS //////////////////////////////
   cache_t *cache;
   //    repl::CandidateMap<bool> historyAccess;
@@ -128,6 +137,10 @@ class LHD {
 
   int64_t explorerBudget = 0;
 
+  // time spent in reconfigure(), which blocks the request path
+  double totalReconfigurationMs = 0;
+  double maxReconfigurationMs = 0;
+
   // METHODS /////////////////////////////
 
   // returns something like log(maxAge - age)
@@ -203,7 +216,7 @@ class LHD {
   void reconfigure();
   void adaptAgeCoarsening();
   void updateClass(Class &cl);
-  void modelHitDensity();
+  void modelHitDensity(Class &cl);
   void dumpClassRanks(Class &cl);
 };
 
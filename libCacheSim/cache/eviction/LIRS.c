@@ -6,6 +6,7 @@
 //
 //
 
+#include "../../dataStructure/ghostHistory.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
@@ -18,7 +19,9 @@ extern "C" {
 typedef struct LIRS_params {
   cache_t *LRU_s;
   cache_t *LRU_q;
-  cache_t *LRU_nh;
+  // non-resident HIR blocks in S in FIFO order, the data of an entry is the
+  // object id
+  ghost_history_t *nh;
   double hirs_ratio;
   uint64_t hirs_limit;
   uint64_t lirs_limit;
@@ -83,6 +86,7 @@ cache_t *LIRS_init(const common_cache_params_t ccache_params,
   cache->evict = LIRS_evict;
   cache->remove = LIRS_remove;
   cache->to_evict = LIRS_to_evict;
+  cache->evict_in_sub_cache = true;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
@@ -106,11 +110,10 @@ cache_t *LIRS_init(const common_cache_params_t ccache_params,
   ccache_params_s.cache_size = params->lirs_limit;
   common_cache_params_t ccache_params_q = ccache_params;
   ccache_params_q.cache_size = params->hirs_limit;
-  common_cache_params_t ccache_params_nh = ccache_params;
 
   params->LRU_s = LRU_init(ccache_params_s, NULL);
   params->LRU_q = LRU_init(ccache_params_q, NULL);
-  params->LRU_nh = LRU_init(ccache_params_nh, NULL);
+  params->nh = ghost_history_init(1024);
 
   return cache;
 }
@@ -124,7 +127,7 @@ static void LIRS_free(cache_t *cache) {
   LIRS_params_t *params = (LIRS_params_t *)(cache->eviction_params);
   params->LRU_s->cache_free(params->LRU_s);
   params->LRU_q->cache_free(params->LRU_q);
-  params->LRU_nh->cache_free(params->LRU_nh);
+  ghost_history_free(params->nh);
   my_free(sizeof(LIRS_params_t), params);
   cache_struct_free(cache);
 }
@@ -173,7 +176,7 @@ static bool LIRS_get(cache_t *cache, const request_t *req) {
            params->lirs_count);
     printf("Q(%ld): %ld %ld \n", params->hirs_limit,
            params->LRU_q->occupied_byte, params->hirs_count);
-    printf("NH: %ld %ld \n", params->LRU_nh->occupied_byte,
+    printf("NH: %ld %ld \n", params->nh->n_byte,
            params->nonresident);
     printf("\n\n");
   }
@@ -439,7 +442,9 @@ static bool LIRS_remove(cache_t *cache, obj_id_t obj_id) {
         cache->n_obj--;
       } else {
         params->LRU_s->remove(params->LRU_s, obj_id);
-        params->nonresident -= obj_s->obj_size;
+        if (ghost_history_remove(params->nh, obj_id, NULL, NULL)) {
+          params->nonresident -= obj_s->obj_size;
+        }
       }
       if (obj_q != NULL) {
         params->LRU_q->remove(params->LRU_q, obj_id);
@@ -490,7 +495,7 @@ bool LIRS_can_insert(cache_t *cache, const request_t *req) {
       evictLIR(cache);
     }
 
-    bool res = params->LRU_nh->remove(params->LRU_nh, obj_s->obj_id);
+    bool res = ghost_history_remove(params->nh, obj_s->obj_id, NULL, NULL);
     if (res) {
       params->nonresident -= obj_s->obj_size;
     }
@@ -535,9 +540,10 @@ static void LIRS_prune(cache_t *cache) {
       break;
     }
 
-    // remove obj from LRU_nh
+    // remove obj from nh
     if (obj_to_remove->LIRS.in_cache == false) {
-      bool res = params->LRU_nh->remove(params->LRU_nh, obj_to_remove->obj_id);
+      bool res =
+          ghost_history_remove(params->nh, obj_to_remove->obj_id, NULL, NULL);
       if (res) {
         params->nonresident -= obj_to_remove->obj_size;
       }
@@ -574,7 +580,7 @@ static cache_obj_t *hit_RD_HIRinS(cache_t *cache, cache_obj_t *cache_obj_s,
 static cache_obj_t *hit_NR_HIRinS(cache_t *cache, cache_obj_t *cache_obj_s) {
   LIRS_params_t *params = (LIRS_params_t *)(cache->eviction_params);
 
-  bool res = params->LRU_nh->remove(params->LRU_nh, cache_obj_s->obj_id);
+  bool res = ghost_history_remove(params->nh, cache_obj_s->obj_id, NULL, NULL);
   if (res) {
     params->nonresident -= cache_obj_s->obj_size;
   }
@@ -655,7 +661,8 @@ static bool evictHIR(cache_t *cache) {
       params->LRU_s->find(params->LRU_s, req_local, false);
   if (obj_to_update != NULL) {
     obj_to_update->LIRS.in_cache = false;
-    params->LRU_nh->insert(params->LRU_nh, req_local);
+    ghost_history_insert(params->nh, req_local->obj_id, req_local->obj_size,
+                         (int64_t)req_local->obj_id);
     params->nonresident += obj_to_update->obj_size;
   }
 
@@ -669,11 +676,10 @@ static void limitStack(cache_t *cache) {
   LIRS_params_t *params = (LIRS_params_t *)cache->eviction_params;
 
   while (params->LRU_s->occupied_byte > (2 * cache->cache_size)) {
-    cache_obj_t *obj_to_evict = params->LRU_nh->to_evict(params->LRU_nh, NULL);
-    if (obj_to_evict) {
-      params->nonresident -= obj_to_evict->obj_size;
-      params->LRU_s->remove(params->LRU_s, obj_to_evict->obj_id);
-      params->LRU_nh->evict(params->LRU_nh, NULL);
+    int64_t obj_size, obj_id;
+    if (ghost_history_pop_oldest(params->nh, &obj_size, &obj_id)) {
+      params->nonresident -= obj_size;
+      params->LRU_s->remove(params->LRU_s, (obj_id_t)obj_id);
     } else {
       break;
     }
@@ -708,12 +714,11 @@ static void LIRS_print_cache(cache_t *cache) {
   printf("\n");
 
   printf("NH Stack: \n");
-  cache_obj_t *obj_nh =
-      ((LRU_params_t *)params->LRU_nh->eviction_params)->q_head;
-  while (obj_nh) {
-    printf("%ld(%lu, %s, %s)->", (long)obj_nh->obj_id, obj_nh->obj_size,
-           obj_nh->LIRS.in_cache ? "R" : "N", obj_nh->LIRS.is_LIR ? "L" : "H");
-    obj_nh = obj_nh->queue.next;
+  ghost_history_t *nh = params->nh;
+  for (uint64_t pos = nh->tail; pos > nh->head; pos--) {
+    ghost_entry_t *e = &nh->entries[(pos - 1) & nh->ring_mask];
+    if (e->hash == 0) continue;
+    printf("%ld(%lu, N, H)->", (long)e->data, (unsigned long)e->size);
   }
   printf("\n\n");
 }
@@ -740,13 +745,11 @@ static void LIRS_print_cache_compared_to_cacheus(cache_t *cache) {
   }
 
   printf("NH:\n");
-  cache_obj_t *obj_nh =
-      ((LRU_params_t *)params->LRU_nh->eviction_params)->q_tail;
-  while (obj_nh) {
-    printf("(o=%ld, is_LIR=%s, in_cache=%s)\n", (long)obj_nh->obj_id,
-           obj_nh->LIRS.is_LIR ? "True" : "False",
-           obj_nh->LIRS.in_cache ? "True" : "False");
-    obj_nh = obj_nh->queue.prev;
+  ghost_history_t *nh = params->nh;
+  for (uint64_t pos = nh->head; pos < nh->tail; pos++) {
+    ghost_entry_t *e = &nh->entries[pos & nh->ring_mask];
+    if (e->hash == 0) continue;
+    printf("(o=%ld, is_LIR=False, in_cache=False)\n", (long)e->data);
   }
   printf("\n");
 }
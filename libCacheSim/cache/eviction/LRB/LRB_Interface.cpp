@@ -19,13 +19,16 @@ extern "C" {
 typedef struct {
   void *LRB_cache;
   char *objective;
+  char *training;
+  int64_t swap_delay;
   SimpleRequest lrb_req;
 
   pair<uint64_t, uint32_t> to_evict_pair;
   cache_obj_t obj_tmp;
 } LRB_params_t;
 
-static const char *DEFAULT_PARAMS = "objective=byte-miss-ratio";
+static const char *DEFAULT_PARAMS =
+    "objective=byte-miss-ratio,training=sync,swap-delay=131072";
 
 // ***********************************************************************
 // ****                                                               ****
@@ -93,12 +96,13 @@ cache_t *LRB_init(const common_cache_params_t ccache_params,
   }
 
   LRB_params_t *params = my_malloc(LRB_params_t);
+  params->objective = NULL;
+  params->training = NULL;
   cache->eviction_params = params;
 
+  LRB_parse_params(cache, DEFAULT_PARAMS);
   if (cache_specific_params != NULL) {
     LRB_parse_params(cache, cache_specific_params);
-  } else {
-    LRB_parse_params(cache, DEFAULT_PARAMS);
   }
 
   auto *lrb = new lrb::LRBCache();
@@ -109,6 +113,8 @@ cache_t *LRB_init(const common_cache_params_t ccache_params,
   std::map<string, string> params_map;
 
   params_map["objective"] = params->objective;
+  params_map["training"] = params->training;
+  params_map["swap_delay"] = std::to_string(params->swap_delay);
 
   if (strcmp(params->objective, "object-miss-ratio") == 0) {
     snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "%s", "LRB-OMR");
@@ -117,6 +123,11 @@ cache_t *LRB_init(const common_cache_params_t ccache_params,
   } else {
     ERROR("LRB does not support objective %s\n", params->objective);
   }
+  if (strcasecmp(params->training, "sync") != 0) {
+    int n = strlen(cache->cache_name);
+    snprintf(cache->cache_name + n, CACHE_NAME_ARRAY_LEN - n, "-%s",
+             params->training);
+  }
 
   lrb->init_with_params(params_map);
 
@@ -132,6 +143,8 @@ static void LRB_free(cache_t *cache) {
   auto *params = static_cast<LRB_params_t *>(cache->eviction_params);
   auto *LRB = static_cast<lrb::LRBCache *>(params->LRB_cache);
   delete LRB;
+  free(params->objective);
+  free(params->training);
   free(cache->to_evict_candidate);
   my_free(sizeof(LRB_params_t), params);
   cache_struct_free(cache);
@@ -293,6 +306,17 @@ static int64_t LRB_get_n_obj(const cache_t *cache) {
   return lrb->in_cache_metas.size();
 }
 
+/**
+ * @brief the number of models that have been swapped in, a model trained
+ * asynchronously is counted when it is installed, not when training starts
+ */
+int64_t LRB_get_n_installed_model(const cache_t *cache) {
+  auto *params = static_cast<LRB_params_t *>(cache->eviction_params);
+  auto *lrb = static_cast<lrb::LRBCache *>(params->LRB_cache);
+
+  return lrb->n_installed_model;
+}
+
 static int64_t LRB_get_occupied_byte(const cache_t *cache) {
   auto *params = static_cast<LRB_params_t *>(cache->eviction_params);
   auto *lrb = static_cast<lrb::LRBCache *>(params->LRB_cache);
@@ -307,7 +331,9 @@ static int64_t LRB_get_occupied_byte(const cache_t *cache) {
 // ***********************************************************************
 static const char *LRB_current_params(cache_t *cache, LRB_params_t *params) {
   static __thread char params_str[128];
-  int n = snprintf(params_str, 128, "objective=%s", params->objective);
+  int n = snprintf(params_str, 128, "objective=%s,training=%s,swap-delay=%ld",
+                   params->objective, params->training,
+                   (long)params->swap_delay);
 
   snprintf(cache->cache_name + n, 128 - n, "\n");
 
@@ -332,10 +358,24 @@ static void LRB_parse_params(cache_t *cache,
     }
 
     if (strcasecmp(key, "objective") == 0) {
+      free(params->objective);
       params->objective = strdup(value);
       if (params->objective == NULL) {
         ERROR("out of memory %s\n", strerror(errno));
       }
+    } else if (strcasecmp(key, "training") == 0) {
+      if (strcasecmp(value, "sync") != 0 && strcasecmp(value, "async") != 0 &&
+          strcasecmp(value, "deterministic") != 0) {
+        ERROR("LRB training must be sync, async or deterministic, get %s\n",
+              value);
+      }
+      free(params->training);
+      params->training = strdup(value);
+    } else if (strcasecmp(key, "swap-delay") == 0) {
+      params->swap_delay = strtoll(value, &end, 0);
+      if (strlen(end) > 2) {
+        ERROR("param parsing error, find string \"%s\" after number\n", end);
+      }
     } else if (strcasecmp(key, "print") == 0) {
       printf("current parameters: %s\n", LRB_current_params(cache, params));
       exit(0);
@@ -15,57 +15,112 @@ using namespace lrb;
 
 void LRBCache::train() {
   ++n_retrain;
+  double se, time_ms;
+  BoosterHandle new_booster =
+      fit(training_data, training_params, &se, &time_ms);
+  install_model(new_booster, se, time_ms);
+}
+
+BoosterHandle LRBCache::fit(TrainingData *data,
+                            unordered_map<string, string> params, double *se,
+                            double *time_ms) {
   auto timeBegin = chrono::system_clock::now();
-  if (booster) LGBM_BoosterFree(booster);
+  BoosterHandle new_booster = nullptr;
   // create training dataset
   DatasetHandle trainData;
   LGBM_DatasetCreateFromCSR(
-      static_cast<void *>(training_data->indptr.data()), C_API_DTYPE_INT32,
-      training_data->indices.data(),
-      static_cast<void *>(training_data->data.data()), C_API_DTYPE_FLOAT64,
-      training_data->indptr.size(), training_data->data.size(),
+      static_cast<void *>(data->indptr.data()), C_API_DTYPE_INT32,
+      data->indices.data(), static_cast<void *>(data->data.data()),
+      C_API_DTYPE_FLOAT64, data->indptr.size(), data->data.size(),
       n_feature,  // remove future t
-      map_to_string(training_params).c_str(), nullptr, &trainData);
+      map_to_string(params).c_str(), nullptr, &trainData);
 
   LGBM_DatasetSetField(trainData, "label",
-                       static_cast<void *>(training_data->labels.data()),
-                       training_data->labels.size(), C_API_DTYPE_FLOAT32);
+                       static_cast<void *>(data->labels.data()),
+                       data->labels.size(), C_API_DTYPE_FLOAT32);
 
   // init booster
-  LGBM_BoosterCreate(trainData, map_to_string(training_params).c_str(),
-                     &booster);
+  LGBM_BoosterCreate(trainData, map_to_string(params).c_str(), &new_booster);
   // train
-  for (int i = 0; i < stoi(training_params["num_iterations"]); i++) {
+  for (int i = 0; i < stoi(params["num_iterations"]); i++) {
     int isFinished;
-    LGBM_BoosterUpdateOneIter(booster, &isFinished);
+    LGBM_BoosterUpdateOneIter(new_booster, &isFinished);
     if (isFinished) {
       break;
     }
   }
 
   int64_t len;
-  vector<double> result(training_data->indptr.size() - 1);
+  vector<double> result(data->indptr.size() - 1);
   LGBM_BoosterPredictForCSR(
-      booster, static_cast<void *>(training_data->indptr.data()),
-      C_API_DTYPE_INT32, training_data->indices.data(),
-      static_cast<void *>(training_data->data.data()), C_API_DTYPE_FLOAT64,
-      training_data->indptr.size(), training_data->data.size(),
+      new_booster, static_cast<void *>(data->indptr.data()), C_API_DTYPE_INT32,
+      data->indices.data(), static_cast<void *>(data->data.data()),
+      C_API_DTYPE_FLOAT64, data->indptr.size(), data->data.size(),
       n_feature,  // remove future t
-      C_API_PREDICT_NORMAL, 0, atoi(training_params["num_iterations"].c_str()),
-      map_to_string(training_params).c_str(), &len, result.data());
+      C_API_PREDICT_NORMAL, 0, atoi(params["num_iterations"].c_str()),
+      map_to_string(params).c_str(), &len, result.data());
 
-  double se = 0;
+  *se = 0;
   for (size_t i = 0; i < result.size(); ++i) {
-    auto diff = result[i] - training_data->labels[i];
-    se += diff * diff;
+    auto diff = result[i] - data->labels[i];
+    *se += diff * diff;
   }
-  training_loss = training_loss * 0.99 + se / batch_size * 0.01;
 
   LGBM_DatasetFree(trainData);
-  training_time =
-      0.95 * training_time + 0.05 * chrono::duration_cast<chrono::milliseconds>(
-                                        chrono::system_clock::now() - timeBegin)
-                                        .count();
+  *time_ms = chrono::duration_cast<chrono::milliseconds>(
+                 chrono::system_clock::now() - timeBegin)
+                 .count();
+  return new_booster;
+}
+
+void LRBCache::install_model(BoosterHandle new_booster, double se,
+                             double time_ms) {
+  if (booster) LGBM_BoosterFree(booster);
+  booster = new_booster;
+  ++n_installed_model;
+  training_loss = training_loss * 0.99 + se / batch_size * 0.01;
+  training_time = 0.95 * training_time + 0.05 * time_ms;
+}
+
+void LRBCache::on_batch_full() {
+  if (training_mode == sync_training) {
+    train();
+    training_data->clear();
+    return;
+  }
+
+  // one batch is trained at a time, if the next batch fills up before the
+  // previous model is swapped in, wait for it
+  if (trainer.joinable()) swap_model();
+
+  // keep filling the other buffer while the worker trains on this one
+  std::swap(training_data, pending_data);
+  training_data->clear();
+  ++n_retrain;
+  train_start_seq = current_seq;
+  model_ready.store(false, memory_order_relaxed);
+  trainer = thread([this, params = training_params]() {
+    next_booster = fit(pending_data, params, &next_se, &next_training_time);
+    model_ready.store(true, memory_order_release);
+  });
+}
+
+void LRBCache::poll_model() {
+  if (training_mode == deterministic_training) {
+    if (current_seq - train_start_seq >= swap_delay) swap_model();
+  } else if (model_ready.load(memory_order_acquire)) {
+    swap_model();
+  }
+}
+
+void LRBCache::swap_model() {
+  auto waitBegin = chrono::system_clock::now();
+  trainer.join();
+  training_wait_time += chrono::duration_cast<chrono::milliseconds>(
+                            chrono::system_clock::now() - waitBegin)
+                            .count();
+  install_model(next_booster, next_se, next_training_time);
+  next_booster = nullptr;
 }
 
 void LRBCache::sample() {
@@ -120,6 +175,7 @@ void LRBCache::update_stat_periodic() {
 bool LRBCache::lookup(const SimpleRequest &req) {
   bool ret;
   ++current_seq;
+  if (trainer.joinable()) poll_model();
 
   forget();
 
@@ -152,8 +208,7 @@ bool LRBCache::lookup(const SimpleRequest &req) {
       }
       // batch_size ~>= batch_size
       if (training_data->labels.size() >= batch_size) {
-        train();
-        training_data->clear();
+        on_batch_full();
       }
       meta._sample_times.clear();
       meta._sample_times.shrink_to_fit();
@@ -216,8 +271,7 @@ void LRBCache::forget() {
       }
       // batch_size ~>= batch_size
       if (training_data->labels.size() >= batch_size) {
-        train();
-        training_data->clear();
+        on_batch_full();
       }
       meta._sample_times.clear();
       meta._sample_times.shrink_to_fit();
@@ -432,8 +486,7 @@ void LRBCache::evict_with_candidate(pair<uint64_t, uint32_t> &epair) {
       }
       // batch_size ~>= batch_size
       if (training_data->labels.size() >= batch_size) {
-        train();
-        training_data->clear();
+        on_batch_full();
       }
       meta._sample_times.clear();
       meta._sample_times.shrink_to_fit();
@@ -8,11 +8,13 @@
 #include <LightGBM/c_api.h>
 #include <assert.h>
 
+#include <atomic>
 #include <cmath>
 #include <fstream>
 #include <list>
 #include <random>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -284,7 +286,33 @@ class LRBCache : public Cache {
 
   InCacheLRUQueue in_cache_lru_queue;
   shared_ptr<sparse_hash_map<uint64_t, uint64_t>> negative_candidate_queue;
-  TrainingData *training_data;
+  TrainingData *training_data = nullptr;
+
+  // sync trains on the request path; async trains the full batch on a worker
+  // thread while the current model keeps serving, and swaps the new model in
+  // as soon as it is ready; deterministic also trains on the worker but swaps
+  // the model in exactly swap_delay requests after the batch is full (waiting
+  // for the worker if needed), so results do not depend on the training speed
+  enum TrainingModeT : uint8_t {
+    sync_training = 0,
+    async_training = 1,
+    deterministic_training = 2
+  };
+  TrainingModeT training_mode = sync_training;
+  uint32_t swap_delay = batch_size;
+  // the batch being trained on, swapped with training_data when it is full
+  TrainingData *pending_data = nullptr;
+  thread trainer;
+  atomic<bool> model_ready{false};
+  // written by the worker, read after it is joined
+  BoosterHandle next_booster = nullptr;
+  double next_se = 0;
+  double next_training_time = 0;
+  uint32_t train_start_seq = 0;
+  // the number of models swapped in, in every training mode
+  int n_installed_model = 0;
+  // time (ms) the request path waited for the worker
+  double training_wait_time = 0;
 
   // sample_size: use n_memorize keys + random choose (sample_rate - n_memorize)
   // keys
@@ -346,6 +374,19 @@ class LRBCache : public Cache {
         training_params["num_leaves"] = it.second;
       } else if (it.first == "byte_million_req") {
         byte_million_req = stoull(it.second);
+      } else if (it.first == "training") {
+        if (it.second == "sync")
+          training_mode = sync_training;
+        else if (it.second == "async")
+          training_mode = async_training;
+        else if (it.second == "deterministic")
+          training_mode = deterministic_training;
+        else {
+          cerr << "error: unknown training mode " << it.second << endl;
+          exit(-1);
+        }
+      } else if (it.first == "swap_delay") {
+        swap_delay = stoul(it.second);
       } else if (it.first == "n_edc_feature") {
         if (stoull(it.second) != n_edc_feature) {
           cerr << "error: cannot change n_edc_feature because of const" << endl;
@@ -394,6 +435,17 @@ class LRBCache : public Cache {
     }
     inference_params = training_params;
     training_data = new TrainingData(n_feature, memory_window);
+    if (training_mode != sync_training) {
+      pending_data = new TrainingData(n_feature, memory_window);
+    }
+  }
+
+  ~LRBCache() override {
+    if (trainer.joinable()) trainer.join();
+    if (next_booster) LGBM_BoosterFree(next_booster);
+    if (booster) LGBM_BoosterFree(booster);
+    delete training_data;
+    delete pending_data;
   }
 
   string map_to_string(unordered_map<string, string> &map) {
@@ -420,6 +472,22 @@ class LRBCache : public Cache {
 
   void train();
 
+  // train a booster on one batch, it only reads data and params so that it
+  // can run on the training thread
+  BoosterHandle fit(TrainingData *data, unordered_map<string, string> params,
+                    double *se, double *time_ms);
+
+  void install_model(BoosterHandle new_booster, double se, double time_ms);
+
+  // called when training_data reaches batch_size
+  void on_batch_full();
+
+  // swap in the model trained on the worker if it is due
+  void poll_model();
+
+  // wait for the worker and swap in its model
+  void swap_model();
+
   void sample();
 
   void update_stat_periodic() override;
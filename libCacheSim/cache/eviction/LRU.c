@@ -10,6 +10,7 @@
 //
 
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/checkpoint.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -33,6 +34,8 @@ static cache_obj_t *LRU_to_evict(cache_t *cache, const request_t *req);
 static void LRU_evict(cache_t *cache, const request_t *req);
 static bool LRU_remove(cache_t *cache, const obj_id_t obj_id);
 static void LRU_print_cache(const cache_t *cache);
+static bool LRU_serialize(const cache_t *cache, FILE *f);
+static bool LRU_deserialize(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -62,6 +65,8 @@ cache_t *LRU_init(const common_cache_params_t ccache_params,
   cache->can_insert = cache_can_insert_default;
   cache->get_n_obj = cache_get_n_obj_default;
   cache->print_cache = LRU_print_cache;
+  cache->serialize = LRU_serialize;
+  cache->deserialize = LRU_deserialize;
 
   if (ccache_params.consider_obj_metadata) {
     cache->obj_md_size = 8 * 2;
@@ -280,6 +285,40 @@ static void LRU_print_cache(const cache_t *cache) {
   printf("END\n");
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     checkpoint functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+/**
+ * @brief write the objects from the least to the most recently used, see
+ * checkpoint.h
+ */
+static bool LRU_serialize(const cache_t *cache, FILE *f) {
+  LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
+  int64_t n_obj = cache->n_obj;
+  if (!checkpoint_write(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (cache_obj_t *obj = params->q_tail; obj != NULL;
+       obj = obj->queue.prev) {
+    if (!checkpoint_write_obj(f, obj, 0)) return false;
+  }
+  return true;
+}
+
+static bool LRU_deserialize(cache_t *cache, FILE *f) {
+  LRU_params_t *params = (LRU_params_t *)cache->eviction_params;
+  int64_t n_obj;
+  if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (int64_t i = 0; i < n_obj; i++) {
+    cache_obj_t *obj = checkpoint_read_obj(cache, f, NULL);
+    if (obj == NULL) return false;
+    prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
+  }
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
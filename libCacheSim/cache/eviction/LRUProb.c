@@ -202,7 +202,7 @@ static void LRU_Prob_evict(cache_t *cache, const request_t *req) {
   LRU_Prob_params_t *params = (LRU_Prob_params_t *)cache->eviction_params;
   cache_obj_t *obj_to_evict = params->q_tail;
   remove_obj_from_list(&params->q_head, &params->q_tail, obj_to_evict);
-  cache_remove_obj_base(cache, obj_to_evict, true);
+  cache_evict_base(cache, obj_to_evict, true);
 }
 
 static void LRU_Prob_remove_obj(cache_t *cache, cache_obj_t *obj_to_remove) {
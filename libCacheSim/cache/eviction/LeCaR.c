@@ -10,6 +10,7 @@
 #include <glib.h>
 #include <math.h>
 
+#include "../../dataStructure/ghostHistory.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 #include "../../include/libCacheSim/logging.h"
@@ -32,14 +33,9 @@ typedef struct LeCaR_params {
   int64_t min_freq;
   int64_t max_freq;
 
-  // eviction history
-  cache_obj_t *ghost_lru_head;
-  cache_obj_t *ghost_lru_tail;
-  int64_t lru_g_occupied_byte;
-
-  cache_obj_t *ghost_lfu_head;
-  cache_obj_t *ghost_lfu_tail;
-  int64_t lfu_g_occupied_byte;
+  // eviction history, the data of an entry is the eviction vtime
+  ghost_history_t *ghost_lru;
+  ghost_history_t *ghost_lfu;
 
   // LeCaR
   double w_lru;
@@ -74,6 +70,8 @@ static bool LeCaR_remove(cache_t *cache, const obj_id_t obj_id);
 
 /* internal */
 static void verify_ghost_lru_integrity(cache_t *cache, LeCaR_params_t *params);
+static void insert_ghost(cache_t *cache, ghost_history_t *ghost,
+                         cache_obj_t *obj);
 static inline void update_LFU_min_freq(LeCaR_params_t *params);
 static inline freq_node_t *get_min_freq_node(LeCaR_params_t *params);
 static inline void remove_obj_from_freq_node(LeCaR_params_t *params,
@@ -133,10 +131,8 @@ cache_t *LeCaR_init(const common_cache_params_t ccache_params,
   params->update_weight = true;
   params->n_hit_lru_history = params->n_hit_lfu_history = 0;
 
-  params->ghost_lru_head = params->ghost_lru_tail = NULL;
-  params->ghost_lfu_head = params->ghost_lfu_tail = NULL;
-  params->lru_g_occupied_byte = 0;
-  params->lfu_g_occupied_byte = 0;
+  params->ghost_lru = ghost_history_init(1024);
+  params->ghost_lfu = ghost_history_init(1024);
   params->q_head = params->q_tail = NULL;
 
   if (cache_specific_params != NULL) {
@@ -172,6 +168,8 @@ cache_t *LeCaR_init(const common_cache_params_t ccache_params,
 static void LeCaR_free(cache_t *cache) {
   LeCaR_params_t *params = (LeCaR_params_t *)(cache->eviction_params);
   g_hash_table_destroy(params->freq_map);
+  ghost_history_free(params->ghost_lru);
+  ghost_history_free(params->ghost_lfu);
   my_free(sizeof(LeCaR_params_t), params);
   cache_struct_free(cache);
 }
@@ -223,46 +221,28 @@ static cache_obj_t *LeCaR_find(cache_t *cache, const request_t *req,
 
   cache_obj_t *cache_obj = cache_find_base(cache, req, update_cache);
 
-  if (cache_obj == NULL) {
-    return NULL;
-  }
-
   if (!update_cache) {
-    if (cache_obj->LeCaR.is_ghost) {
-      return NULL;
-    } else {
-      return cache_obj;
-    }
+    return cache_obj;
   }
 
-  // if it is a ghost object, update its weight
-  if (cache_obj->LeCaR.is_ghost) {
-    if (cache_obj->LeCaR.evict_expert == 1) {
+  // ghost objects are not in the hash table, if it is a ghost object,
+  // update the weight
+  if (cache_obj == NULL) {
+    int64_t eviction_vtime;
+    if (ghost_history_remove(params->ghost_lru, req->obj_id, NULL,
+                             &eviction_vtime)) {
       // evicted by expert LRU
       params->n_hit_lru_history++;
-      int64_t t = cache->n_req - cache_obj->LeCaR.eviction_vtime;
+      int64_t t = cache->n_req - eviction_vtime;
       update_weight(cache, t, &params->w_lru, &params->w_lfu);
-
-      remove_obj_from_list(&params->ghost_lru_head, &params->ghost_lru_tail,
-                           cache_obj);
-      params->lru_g_occupied_byte -= (cache_obj->obj_size + cache->obj_md_size);
-      hashtable_delete(cache->hashtable, cache_obj);
-    } else if (cache_obj->LeCaR.evict_expert == 2) {
+    } else if (ghost_history_remove(params->ghost_lfu, req->obj_id, NULL,
+                                    &eviction_vtime)) {
       // evicted by expert LFU
       params->n_hit_lfu_history++;
-      int64_t t = cache->n_req - cache_obj->LeCaR.eviction_vtime;
+      int64_t t = cache->n_req - eviction_vtime;
       update_weight(cache, t, &params->w_lfu, &params->w_lru);
-
-      remove_obj_from_list(&params->ghost_lfu_head, &params->ghost_lfu_tail,
-                           cache_obj);
-      params->lfu_g_occupied_byte -= (cache_obj->obj_size + cache->obj_md_size);
-      hashtable_delete(cache->hashtable, cache_obj);
-    } else {
-      assert(cache_obj->LeCaR.evict_expert == -1);
-      hashtable_delete(cache->hashtable, cache_obj);
-      // the two experts both pick this object, do nothing
-      ;
     }
+    // if the two experts both picked this object, it is not in the history
     return NULL;
   } else {
     // if it is an cached object, update cache state
@@ -292,11 +272,7 @@ static cache_obj_t *LeCaR_find(cache_t *cache, const request_t *req,
     }
   }
 
-  if (cache_obj == NULL || cache_obj->LeCaR.is_ghost) {
-    return NULL;
-  } else {
-    return cache_obj;
-  }
+  return cache_obj;
 }
 
 /**
@@ -319,7 +295,6 @@ cache_obj_t *LeCaR_insert(cache_t *cache, const request_t *req) {
 
   prepend_obj_to_head(&params->q_head, &params->q_tail, cache_obj);
   cache_obj->LeCaR.freq = 1;
-  cache_obj->LeCaR.is_ghost = false;
   cache_obj->LeCaR.evict_expert = 0;
   cache_obj->LeCaR.eviction_vtime = 0;
 
@@ -405,20 +380,14 @@ static void LeCaR_evict(cache_t *cache, const request_t *req) {
     cache_obj = lfu_choice;
   }
 
-  cache_obj->LeCaR.is_ghost = true;
-  cache_obj->LeCaR.evict_expert = -1;
-  cache_obj->LeCaR.eviction_vtime = cache->n_req;
-
   // update LRU chain state
   remove_obj_from_list(&params->q_head, &params->q_tail, cache_obj);
 
   // update LFU chain state
   remove_obj_from_freq_node(params, cache_obj);
 
-  // update cache state
-  DEBUG_ASSERT(cache->occupied_byte >= cache_obj->obj_size);
-  cache->occupied_byte -= (cache_obj->obj_size + cache->obj_md_size);
-  cache->n_obj -= 1;
+  // update cache state, the object is not kept in the history
+  cache_evict_base(cache, cache_obj, true);
 }
 
 #else
@@ -497,51 +466,24 @@ void LeCaR_evict(cache_t *cache, const request_t *req) {
     }
   }
 
-  obj_to_evict->LeCaR.is_ghost = true;
-  obj_to_evict->LeCaR.eviction_vtime = cache->n_req;
-
   // update LRU chain state
   remove_obj_from_list(&params->q_head, &params->q_tail, obj_to_evict);
 
   // update LFU chain state
   remove_obj_from_freq_node(params, obj_to_evict);
 
-  // update cache state
-  cache_evict_base(cache, obj_to_evict, false);
-
   // update history
   if (obj_to_evict->LeCaR.evict_expert == 1) {
-    prepend_obj_to_head(&params->ghost_lru_head, &params->ghost_lru_tail,
-                        obj_to_evict);
-    params->lru_g_occupied_byte += obj_to_evict->obj_size + cache->obj_md_size;
-    // evict ghost entries if its full
-    while (params->lru_g_occupied_byte > cache->cache_size / 2) {
-      cache_obj_t *ghost_to_evict = params->ghost_lru_tail;
-      DEBUG_ASSERT(ghost_to_evict != NULL);
-      params->lru_g_occupied_byte -=
-          (ghost_to_evict->obj_size + cache->obj_md_size);
-      remove_obj_from_list(&params->ghost_lru_head, &params->ghost_lru_tail,
-                           ghost_to_evict);
-      hashtable_delete(cache->hashtable, ghost_to_evict);
-    }
+    insert_ghost(cache, params->ghost_lru, obj_to_evict);
   } else if (obj_to_evict->LeCaR.evict_expert == 2) {
-    prepend_obj_to_head(&params->ghost_lfu_head, &params->ghost_lfu_tail,
-                        obj_to_evict);
-    params->lfu_g_occupied_byte += obj_to_evict->obj_size + cache->obj_md_size;
-    // evict ghost entries if its full
-    while (params->lfu_g_occupied_byte > cache->cache_size / 2) {
-      cache_obj_t *ghost_to_evict = params->ghost_lfu_tail;
-      DEBUG_ASSERT(ghost_to_evict != NULL);
-      params->lfu_g_occupied_byte -=
-          (ghost_to_evict->obj_size + cache->obj_md_size);
-      remove_obj_from_list(&params->ghost_lfu_head, &params->ghost_lfu_tail,
-                           ghost_to_evict);
-      hashtable_delete(cache->hashtable, ghost_to_evict);
-    }
+    insert_ghost(cache, params->ghost_lfu, obj_to_evict);
   } else {
     // evicted by both caches
     // TODO: this currently does not increase ghost size
   }
+
+  // update cache state
+  cache_evict_base(cache, obj_to_evict, true);
 }
 #endif
 
@@ -562,7 +504,8 @@ bool LeCaR_remove(cache_t *cache, obj_id_t obj_id) {
   LeCaR_params_t *params = (LeCaR_params_t *)(cache->eviction_params);
   cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
   if (obj == NULL) {
-    return false;
+    return ghost_history_remove(params->ghost_lru, obj_id, NULL, NULL) ||
+           ghost_history_remove(params->ghost_lfu, obj_id, NULL, NULL);
   }
 
   // remove from LRU list
@@ -747,6 +690,16 @@ static inline void insert_obj_info_freq_node(LeCaR_params_t *params,
   new_node->n_obj += 1;
 }
 
+/* each history holds at most half of the cache size */
+static void insert_ghost(cache_t *cache, ghost_history_t *ghost,
+                         cache_obj_t *obj) {
+  ghost_history_insert(ghost, obj->obj_id, obj->obj_size + cache->obj_md_size,
+                       cache->n_req);
+  while (ghost->n_byte > cache->cache_size / 2) {
+    ghost_history_pop_oldest(ghost, NULL, NULL);
+  }
+}
+
 static void update_weight(cache_t *cache, int64_t t, double *w_update,
                           double *w_no_update) {
   LeCaR_params_t *params = (LeCaR_params_t *)(cache->eviction_params);
@@ -766,35 +719,24 @@ static void update_weight(cache_t *cache, int64_t t, double *w_update,
 // ****                                                               ****
 // ***********************************************************************
 static void verify_ghost_lru_integrity(cache_t *cache, LeCaR_params_t *params) {
-  if (params->ghost_lru_head == NULL) {
-    assert(params->ghost_lru_tail == NULL);
-    assert(params->lru_g_occupied_byte == 0);
-    return;
-  } else {
-    assert(params->ghost_lru_tail != NULL);
-    assert(params->lru_g_occupied_byte > 0);
-  }
-
-  int64_t ghost_entry_size = 0;
-  cache_obj_t *cur = params->ghost_lru_head;
-  while (cur != NULL) {
-    ghost_entry_size += (cur->obj_size + cache->obj_md_size);
-    if (cur->queue.next == NULL) {
-      assert(cur == params->ghost_lru_tail);
-    } else {
-      assert(cur->queue.next->queue.prev == cur);
-    }
-    cur = cur->queue.next;
+  ghost_history_t *ghost = params->ghost_lru;
+  int64_t n_entry = 0, ghost_entry_size = 0;
+  for (uint64_t pos = ghost->head; pos < ghost->tail; pos++) {
+    ghost_entry_t *e = &ghost->entries[pos & ghost->ring_mask];
+    if (e->hash == 0) continue;
+    n_entry += 1;
+    ghost_entry_size += e->size;
   }
 
   VVVERBOSE(
-      "ghost entry head %p tail %p, "
+      "ghost entry %ld, "
       "ghost_entry_size from scan = %ld,"
-      "lru_g_occupied_byte = %ld\n ",
-      params->ghost_lru_head, params->ghost_lru_tail, ghost_entry_size,
-      params->lru_g_occupied_byte);
+      "lru ghost n_byte = %ld\n ",
+      (long)n_entry, (long)ghost_entry_size, (long)ghost->n_byte);
 
-  assert(ghost_entry_size == params->lru_g_occupied_byte);
+  assert(n_entry == ghost->n_entry);
+  assert(ghost_entry_size == ghost->n_byte);
+  assert(ghost->n_byte <= cache->cache_size / 2);
 }
 
 #ifdef __cplusplus
@@ -88,6 +88,7 @@ cache_t *LeCaRv0_init(const common_cache_params_t ccache_params,
   cache->evict = LeCaRv0_evict;
   cache->remove = LeCaRv0_remove;
   cache->to_evict = LeCaRv0_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = LeCaRv0_get_n_obj;
   cache->get_occupied_byte = LeCaRv0_get_occupied_byte;
 
@@ -4,6 +4,10 @@
 //  20% FIFO + ARC
 //  insert to ARC when evicting from FIFO
 //
+//  the FIFO, and the main cache when it is a clock or a FIFO, are rings of
+//  object pointers that share the cache hash table (see
+//  dataStructure/ringFifo.h), other main caches are separate caches
+//
 //
 //  QDLP.c
 //  libCacheSim
@@ -12,17 +16,31 @@
 //  Copyright © 2018 Juncheng. All rights reserved.
 //
 
+#include "../../dataStructure/ghostHistory.h"
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../dataStructure/ringFifo.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* the FIFO and, when the main cache is a clock, the main cache are rings of
+ * object pointers that share the cache hash table, other main caches are
+ * separate caches */
+#define FIFO_QUEUE 0
+#define MAIN_QUEUE 1
+
 typedef struct {
-  cache_t *fifo;
-  cache_t *fifo_ghost;
+  ring_fifo_t *queues;
+  int64_t fifo_size;
+  int64_t main_size;
+  ghost_history_t *ghost;
+  int64_t ghost_size;
+  /* NULL if the main cache is in the queues */
   cache_t *main_cache;
+  /* the counter of the main clock saturates at main_max_freq */
+  int main_max_freq;
   bool hit_on_ghost;
 
   int64_t n_obj_admit_to_fifo;
@@ -82,6 +100,7 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
   cache->evict = QDLP_evict;
   cache->remove = QDLP_remove;
   cache->to_evict = QDLP_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = QDLP_get_n_obj;
   cache->get_occupied_byte = QDLP_get_occupied_byte;
   cache->can_insert = QDLP_can_insert;
@@ -99,38 +118,38 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
     QDLP_parse_params(cache, cache_specific_params);
   }
 
-  int64_t fifo_cache_size =
+  params->fifo_size =
       (int64_t)ccache_params.cache_size * params->fifo_size_ratio;
-  int64_t main_cache_size = ccache_params.cache_size - fifo_cache_size;
+  params->main_size = ccache_params.cache_size - params->fifo_size;
   int64_t fifo_ghost_cache_size =
       (int64_t)(ccache_params.cache_size * params->ghost_size_ratio);
 
-  common_cache_params_t ccache_params_local = ccache_params;
-  ccache_params_local.cache_size = fifo_cache_size;
-  params->fifo = FIFO_init(ccache_params_local, NULL);
+  params->queues = ring_fifo_init(2);
 
   if (fifo_ghost_cache_size > 0) {
-    ccache_params_local.cache_size = fifo_ghost_cache_size;
-    params->fifo_ghost = FIFO_init(ccache_params_local, NULL);
-    snprintf(params->fifo_ghost->cache_name, CACHE_NAME_ARRAY_LEN,
-             "FIFO-ghost");
+    params->ghost_size = fifo_ghost_cache_size;
+    params->ghost = ghost_history_init(1024);
   } else {
-    params->fifo_ghost = NULL;
+    params->ghost = NULL;
   }
 
-  ccache_params_local.cache_size = main_cache_size;
-  if (strcasecmp(params->main_cache_type, "ARC") == 0) {
+  common_cache_params_t ccache_params_local = ccache_params;
+  ccache_params_local.cache_size = params->main_size;
+  params->main_cache = NULL;
+  if (strcasecmp(params->main_cache_type, "clock") == 0) {
+    params->main_max_freq = 1;
+  } else if (strcasecmp(params->main_cache_type, "clock2") == 0) {
+    params->main_max_freq = 3;
+  } else if (strcasecmp(params->main_cache_type, "clock3") == 0) {
+    params->main_max_freq = 7;
+  } else if (strcasecmp(params->main_cache_type, "FIFO") == 0) {
+    params->main_max_freq = 0;
+  } else if (strcasecmp(params->main_cache_type, "ARC") == 0) {
     params->main_cache = ARC_init(ccache_params_local, NULL);
   } else if (strcasecmp(params->main_cache_type, "LHD") == 0) {
     params->main_cache = LHD_init(ccache_params_local, NULL);
-  } else if (strcasecmp(params->main_cache_type, "clock") == 0) {
-    params->main_cache = Clock_init(ccache_params_local, NULL);
   } else if (strcasecmp(params->main_cache_type, "sieve") == 0) {
     params->main_cache = Sieve_init(ccache_params_local, NULL);
-  } else if (strcasecmp(params->main_cache_type, "clock2") == 0) {
-    params->main_cache = Clock_init(ccache_params_local, "n-bit-counter=2");
-  } else if (strcasecmp(params->main_cache_type, "clock3") == 0) {
-    params->main_cache = Clock_init(ccache_params_local, "n-bit-counter=3");
   } else if (strcasecmp(params->main_cache_type, "LRU") == 0) {
     params->main_cache = LRU_init(ccache_params_local, NULL);
   } else if (strcasecmp(params->main_cache_type, "LeCaR") == 0) {
@@ -139,8 +158,6 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
     params->main_cache = Cacheus_init(ccache_params_local, NULL);
   } else if (strcasecmp(params->main_cache_type, "twoQ") == 0) {
     params->main_cache = TwoQ_init(ccache_params_local, NULL);
-  } else if (strcasecmp(params->main_cache_type, "FIFO") == 0) {
-    params->main_cache = FIFO_init(ccache_params_local, NULL);
   } else if (strcasecmp(params->main_cache_type, "SLRU") == 0) {
     params->main_cache = SLRU_init(ccache_params_local, NULL);
   } else if (strcasecmp(params->main_cache_type, "LIRS") == 0) {
@@ -152,11 +169,9 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
   }
 
 #if defined(TRACK_EVICTION_V_AGE)
-  if (params->fifo_ghost != NULL) {
-    params->fifo_ghost->track_eviction_age = false;
+  if (params->main_cache != NULL) {
+    params->main_cache->track_eviction_age = false;
   }
-  params->fifo->track_eviction_age = false;
-  params->main_cache->track_eviction_age = false;
 #endif
 
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "QDLP-%.4lf-%.4lf-%s-%d",
@@ -174,11 +189,13 @@ cache_t *QDLP_init(const common_cache_params_t ccache_params,
 static void QDLP_free(cache_t *cache) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
   free_request(params->req_local);
-  params->fifo->cache_free(params->fifo);
-  if (params->fifo_ghost != NULL) {
-    params->fifo_ghost->cache_free(params->fifo_ghost);
+  ring_fifo_free(params->queues);
+  if (params->ghost != NULL) {
+    ghost_history_free(params->ghost);
+  }
+  if (params->main_cache != NULL) {
+    params->main_cache->cache_free(params->main_cache);
   }
-  params->main_cache->cache_free(params->main_cache);
   free(cache->eviction_params);
   cache_struct_free(cache);
 }
@@ -203,10 +220,7 @@ static void QDLP_free(cache_t *cache) {
  * @return true if cache hit, false if cache miss
  */
 static bool QDLP_get(cache_t *cache, const request_t *req) {
-  QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
-  DEBUG_ASSERT(params->fifo->get_occupied_byte(params->fifo) +
-                   params->main_cache->get_occupied_byte(params->main_cache) <=
-               cache->cache_size);
+  DEBUG_ASSERT(cache->get_occupied_byte(cache) <= cache->cache_size);
 
   bool cache_hit = cache_get_base(cache, req);
 
@@ -232,37 +246,71 @@ static cache_obj_t *QDLP_find(cache_t *cache, const request_t *req,
                                 const bool update_cache) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
 
+  cache_obj_t *obj = cache_find_base(cache, req, update_cache);
+
   // if update cache is false, we only check the fifo and main caches
   if (!update_cache) {
-    cache_obj_t *obj = params->fifo->find(params->fifo, req, false);
-    if (obj != NULL) {
-      return obj;
-    }
-    obj = params->main_cache->find(params->main_cache, req, false);
-    if (obj != NULL) {
-      return obj;
+    if (obj == NULL && params->main_cache != NULL) {
+      obj = params->main_cache->find(params->main_cache, req, false);
     }
-    return NULL;
+    return obj;
   }
 
   /* update cache is true from now */
   params->hit_on_ghost = false;
-  cache_obj_t *obj = params->fifo->find(params->fifo, req, true);
   if (obj != NULL) {
+    /* objects in the fifo count hits in misc.freq */
+    if (obj->ring_fifo.queue_id == MAIN_QUEUE &&
+        obj->ring_fifo.freq < params->main_max_freq) {
+      obj->ring_fifo.freq += 1;
+    }
     return obj;
   }
 
-  if (params->fifo_ghost != NULL &&
-      params->fifo_ghost->remove(params->fifo_ghost, req->obj_id)) {
+  if (params->ghost != NULL &&
+      ghost_history_remove(params->ghost, req->obj_id, NULL, NULL)) {
     // if object in fifo_ghost, remove will return true
     params->hit_on_ghost = true;
   }
 
-  obj = params->main_cache->find(params->main_cache, req, true);
+  if (params->main_cache != NULL) {
+    obj = params->main_cache->find(params->main_cache, req, true);
+  }
 
   return obj;
 }
 
+/* evict one object from the main clock */
+static void QDLP_evict_main(cache_t *cache) {
+  QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
+  ring_fifo_t *queues = params->queues;
+
+  cache_obj_t *obj_to_evict = ring_fifo_oldest(queues, MAIN_QUEUE);
+  while (obj_to_evict->ring_fifo.freq >= 1) {
+    obj_to_evict->ring_fifo.freq -= 1;
+    ring_fifo_move_to_tail(queues, obj_to_evict, MAIN_QUEUE);
+    obj_to_evict = ring_fifo_oldest(queues, MAIN_QUEUE);
+  }
+
+  ring_fifo_remove(queues, obj_to_evict);
+  cache_evict_base(cache, obj_to_evict, true);
+}
+
+/* make room for obj_size bytes in the main clock, false if the object
+ * is larger than the main clock */
+static bool QDLP_make_room_in_main(cache_t *cache, int64_t obj_size) {
+  QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
+  if (obj_size > params->main_size) {
+    return false;
+  }
+
+  while (ring_fifo_n_byte(params->queues, MAIN_QUEUE) + obj_size >
+         params->main_size) {
+    QDLP_evict_main(cache);
+  }
+  return true;
+}
+
 /**
  * @brief insert an object into the cache,
  * update the hash table and cache metadata
@@ -279,27 +327,33 @@ static cache_obj_t *QDLP_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = NULL;
 
   if (params->hit_on_ghost) {
-    /* insert into the ARC */
+    /* insert into the main cache */
     params->hit_on_ghost = false;
     params->n_obj_admit_to_main += 1;
     params->n_byte_admit_to_main += req->obj_size;
-    params->main_cache->get(params->main_cache, req);
-    obj = params->main_cache->find(params->main_cache, req, false);
+    if (params->main_cache != NULL) {
+      params->main_cache->get(params->main_cache, req);
+      obj = params->main_cache->find(params->main_cache, req, false);
+#if defined(TRACK_EVICTION_V_AGE)
+      if (obj != NULL) obj->create_time = CURR_TIME(cache, req);
+#endif
+    } else if (QDLP_make_room_in_main(cache, req->obj_size)) {
+      obj = cache_insert_base(cache, req);
+      ring_fifo_push(params->queues, MAIN_QUEUE, obj);
+      obj->ring_fifo.freq = 0;
+    }
   } else {
     /* insert into the fifo */
-    if (req->obj_size >= params->fifo->cache_size) {
+    if (req->obj_size >= params->fifo_size) {
       return NULL;
     }
     params->n_obj_admit_to_fifo += 1;
     params->n_byte_admit_to_fifo += req->obj_size;
-    obj = params->fifo->insert(params->fifo, req);
+    obj = cache_insert_base(cache, req);
+    ring_fifo_push(params->queues, FIFO_QUEUE, obj);
   }
 
-#if defined(TRACK_EVICTION_V_AGE)
-  obj->create_time = CURR_TIME(cache, req);
-#endif
-
-  assert(obj->misc.freq == 0);
+  assert(obj == NULL || obj->misc.freq == 0);
 
   return obj;
 }
@@ -319,6 +373,49 @@ static cache_obj_t *QDLP_to_evict(cache_t *cache, const request_t *req) {
   return NULL;
 }
 
+/* the ghost is a FIFO bounded by ghost_size bytes */
+static void QDLP_insert_ghost(QDLP_params_t *params, const cache_obj_t *obj) {
+  if (obj->obj_size > params->ghost_size) {
+    return;
+  }
+
+  while (params->ghost->n_byte + obj->obj_size > params->ghost_size) {
+    ghost_history_pop_oldest(params->ghost, NULL, NULL);
+  }
+  ghost_history_insert(params->ghost, obj->obj_id, obj->obj_size, 0);
+}
+
+/* move an object that was accessed in the fifo to the main cache */
+static void QDLP_move_to_main(cache_t *cache, cache_obj_t *obj,
+                              const request_t *req) {
+  QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
+  params->n_obj_move_to_main += 1;
+  params->n_byte_move_to_main += obj->obj_size;
+
+  if (params->main_cache == NULL) {
+    if (QDLP_make_room_in_main(cache, obj->obj_size)) {
+      ring_fifo_move_to_tail(params->queues, obj, MAIN_QUEUE);
+      obj->ring_fifo.freq = 0;
+      obj->misc.freq = 0;
+    } else {
+      ring_fifo_remove(params->queues, obj);
+      cache_evict_base(cache, obj, true);
+    }
+    return;
+  }
+
+  // get will insert to and evict from main cache
+  copy_cache_obj_to_request(params->req_local, obj);
+  params->main_cache->get(params->main_cache, params->req_local);
+#if defined(TRACK_EVICTION_V_AGE)
+  cache_obj_t *main_obj =
+      params->main_cache->find(params->main_cache, params->req_local, false);
+  if (main_obj != NULL) main_obj->create_time = obj->create_time;
+#endif
+  ring_fifo_remove(params->queues, obj);
+  cache_remove_obj_base(cache, obj, true);
+}
+
 /**
  * @brief evict an object from the cache
  * it needs to call cache_evict_base before returning
@@ -330,52 +427,40 @@ static cache_obj_t *QDLP_to_evict(cache_t *cache, const request_t *req) {
  */
 static void QDLP_evict(cache_t *cache, const request_t *req) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
-
-  cache_t *fifo = params->fifo;
-  cache_t *ghost = params->fifo_ghost;
   cache_t *main = params->main_cache;
 
-  if (fifo->get_occupied_byte(fifo) == 0) {
+  if (ring_fifo_n_byte(params->queues, FIFO_QUEUE) == 0) {
+    // evict from main cache
+    if (main == NULL) {
+      QDLP_evict_main(cache);
+      return;
+    }
+
 #if defined(TRACK_EVICTION_V_AGE)
     cache_obj_t *obj = main->to_evict(main, req);
     record_eviction_age(cache, obj, CURR_TIME(cache, req) - obj->create_time);
 #endif
 
     assert(main->get_occupied_byte(main) <= cache->cache_size);
-    // evict from main cache
     main->evict(main, req);
 
     return;
   }
 
   // evict from FIFO
-  cache_obj_t *obj = fifo->to_evict(fifo, req);
+  cache_obj_t *obj = ring_fifo_oldest(params->queues, FIFO_QUEUE);
   assert(obj != NULL);
-  // need to copy the object before it is evicted
-  copy_cache_obj_to_request(params->req_local, obj);
 
   if (obj->misc.freq >= params->move_to_main_threshold) {
-    // get will insert to and evict from main cache
-    params->n_obj_move_to_main += 1;
-    params->n_byte_move_to_main += obj->obj_size;
-
-    params->main_cache->get(params->main_cache, params->req_local);
-#if defined(TRACK_EVICTION_V_AGE)
-    main->find(main, params->req_local, false)->create_time = obj->create_time;
-  } else {
-    record_eviction_age(cache, obj, CURR_TIME(cache, req) - obj->create_time);
-#else
+    QDLP_move_to_main(cache, obj, req);
   } else {
-#endif
     // insert to ghost
-    if (ghost != NULL) {
-      ghost->get(ghost, params->req_local);
+    if (params->ghost != NULL) {
+      QDLP_insert_ghost(params, obj);
     }
+    ring_fifo_remove(params->queues, obj);
+    cache_evict_base(cache, obj, true);
   }
-
-  // remove from fifo, but do not update stat
-  // bool removed = fifo->remove(fifo, params->req_local->obj_id);
-  fifo->evict(fifo, req);
 }
 
 /**
@@ -393,31 +478,44 @@ static void QDLP_evict(cache_t *cache, const request_t *req) {
  */
 static bool QDLP_remove(cache_t *cache, const obj_id_t obj_id) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
-  bool removed = false;
-  removed = removed || params->fifo->remove(params->fifo, obj_id);
-  removed = removed || (params->fifo_ghost &&
-                        params->fifo_ghost->remove(params->fifo_ghost, obj_id));
-  removed = removed || params->main_cache->remove(params->main_cache, obj_id);
+  cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
+  if (obj != NULL) {
+    ring_fifo_remove(params->queues, obj);
+    cache_remove_obj_base(cache, obj, true);
+    return true;
+  }
 
-  return removed;
+  if (params->ghost != NULL &&
+      ghost_history_remove(params->ghost, obj_id, NULL, NULL)) {
+    return true;
+  }
+
+  return params->main_cache != NULL &&
+         params->main_cache->remove(params->main_cache, obj_id);
 }
 
 static inline int64_t QDLP_get_occupied_byte(const cache_t *cache) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
-  return params->fifo->get_occupied_byte(params->fifo) +
-         params->main_cache->get_occupied_byte(params->main_cache);
+  int64_t occupied_byte = cache->occupied_byte;
+  if (params->main_cache != NULL) {
+    occupied_byte += params->main_cache->get_occupied_byte(params->main_cache);
+  }
+  return occupied_byte;
 }
 
 static inline int64_t QDLP_get_n_obj(const cache_t *cache) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
-  return params->fifo->get_n_obj(params->fifo) +
-         params->main_cache->get_n_obj(params->main_cache);
+  int64_t n_obj = cache->n_obj;
+  if (params->main_cache != NULL) {
+    n_obj += params->main_cache->get_n_obj(params->main_cache);
+  }
+  return n_obj;
 }
 
 static inline bool QDLP_can_insert(cache_t *cache, const request_t *req) {
   QDLP_params_t *params = (QDLP_params_t *)cache->eviction_params;
 
-  return req->obj_size <= params->fifo->cache_size && cache_can_insert_default(cache, req);
+  return req->obj_size <= params->fifo_size && cache_can_insert_default(cache, req);
 }
 
 // ***********************************************************************
@@ -428,7 +526,7 @@ static inline bool QDLP_can_insert(cache_t *cache, const request_t *req) {
 static const char *QDLP_current_params(QDLP_params_t *params) {
   static __thread char params_str[128];
   snprintf(params_str, 128, "fifo-size-ratio=%.4lf,main-cache=%s\n",
-           params->fifo_size_ratio, params->main_cache->cache_name);
+           params->fifo_size_ratio, params->main_cache_type);
   return params_str;
 }
 
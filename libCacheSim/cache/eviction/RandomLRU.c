@@ -2,8 +2,8 @@
 //  RandomLRU.c
 //  libCacheSim
 //
-//  Picks two objects at random and evicts the one that is the least recently
-//  used RandomLRU eviction
+//  samples n-samples objects at random and evicts the least recently used
+//  one
 //
 //  Created by Juncheng on 8/2/16.
 //  Copyright © 2016 Juncheng. All rights reserved.
@@ -11,6 +11,7 @@
 
 #include <stdlib.h>
 
+#include "../../dataStructure/candidateSelect.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 #include "../../include/libCacheSim/macro.h"
@@ -21,6 +22,9 @@ extern "C" {
 
 typedef struct RandomLRU_params {
   int32_t n_samples;
+  // the sampled objects and their last access time
+  cache_obj_t **samples;
+  double *scores;
 } RandomLRU_params_t;
 
 static const char *DEFAULT_CACHE_PARAMS = "n-samples=16";
@@ -76,6 +80,8 @@ cache_t *RandomLRU_init(const common_cache_params_t ccache_params, const char *c
   }
 
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "RandomLRU-%d", params->n_samples);
+  params->samples = (cache_obj_t **)malloc(sizeof(cache_obj_t *) * params->n_samples);
+  params->scores = (double *)malloc(sizeof(double) * params->n_samples);
 
   return cache;
 }
@@ -85,7 +91,13 @@ cache_t *RandomLRU_init(const common_cache_params_t ccache_params, const char *c
  *
  * @param cache
  */
-static void RandomLRU_free(cache_t *cache) { cache_struct_free(cache); }
+static void RandomLRU_free(cache_t *cache) {
+  RandomLRU_params_t *params = (RandomLRU_params_t *)(cache->eviction_params);
+  free(params->samples);
+  free(params->scores);
+  free(params);
+  cache_struct_free(cache);
+}
 
 /**
  * @brief this function is the user facing API
@@ -178,19 +190,6 @@ static cache_obj_t *RandomLRU_to_evict(cache_t *cache, const request_t *req) {
   return NULL;
 }
 
-static int compare_access_time(const void *p1, const void *p2) {
-  const cache_obj_t *obj1 = *(const cache_obj_t **)p1;
-  const cache_obj_t *obj2 = *(const cache_obj_t **)p2;
-
-  if (obj1->Random.last_access_vtime < obj2->Random.last_access_vtime) {
-    return -1;
-  } else if (obj1->Random.last_access_vtime > obj2->Random.last_access_vtime) {
-    return 1;
-  } else {
-    return 0;
-  }
-}
-
 /**
  * @brief evict an object from the cache
  * it needs to call cache_evict_base before returning
@@ -200,13 +199,13 @@ static int compare_access_time(const void *p1, const void *p2) {
  * @param req not used
  */
 static void RandomLRU_evict(cache_t *cache, const request_t *req) {
-  const int N = 64;
-  cache_obj_t *obj_to_evict[N];
-  for (int i = 0; i < N; i++) {
-    obj_to_evict[i] = hashtable_rand_obj(cache->hashtable);
+  RandomLRU_params_t *params = (RandomLRU_params_t *)(cache->eviction_params);
+  for (int i = 0; i < params->n_samples; i++) {
+    params->samples[i] = hashtable_rand_obj(cache->hashtable);
+    params->scores[i] = (double)params->samples[i]->Random.last_access_vtime;
   }
-  qsort(obj_to_evict, N, sizeof(cache_obj_t *), compare_access_time);
-  cache_evict_base(cache, obj_to_evict[0], true);
+  int oldest = candidate_argmin(params->scores, params->n_samples);
+  cache_evict_base(cache, params->samples[oldest], true);
 }
 
 /**
@@ -22,21 +22,36 @@
 //  S3FIFO.c
 //  libCacheSim
 //
+//  the small and main FIFOs share the cache hash table and are stored as rings
+//  of object pointers (see dataStructure/ringFifo.h), so promotion and
+//  reinsertion only move a pointer
+//
 //  Created by Juncheng on 12/4/24.
 //  Copyright © 2018 Juncheng. All rights reserved.
 //
 
+#include "../../dataStructure/ghostHistory.h"
 #include "../../dataStructure/hashtable/hashtable.h"
+#include "../../dataStructure/ringFifo.h"
+#include "../../include/libCacheSim/checkpoint.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* the small and main FIFOs are two rings of object pointers, all objects are
+ * in the cache hash table, so moving an object between or within the queues
+ * does not touch the hash table */
+#define SMALL_QUEUE 0
+#define MAIN_QUEUE 1
+
 typedef struct {
-  cache_t *small_fifo;
-  cache_t *ghost_fifo;
-  cache_t *main_fifo;
+  ring_fifo_t *queues;
+  int64_t small_size;
+  int64_t main_size;
+  ghost_history_t *ghost;
+  int64_t ghost_size;
   bool hit_on_ghost;
 
   int move_to_main_threshold;
@@ -44,7 +59,6 @@ typedef struct {
   double ghost_size_ratio;
 
   bool has_evicted;
-  request_t *req_local;
 } S3FIFO_params_t;
 
 static const char *DEFAULT_CACHE_PARAMS = "small-size-ratio=0.10,ghost-size-ratio=0.90,move-to-main-threshold=2";
@@ -62,10 +76,10 @@ static cache_obj_t *S3FIFO_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *S3FIFO_to_evict(cache_t *cache, const request_t *req);
 static void S3FIFO_evict(cache_t *cache, const request_t *req);
 static bool S3FIFO_remove(cache_t *cache, const obj_id_t obj_id);
-static inline int64_t S3FIFO_get_occupied_byte(const cache_t *cache);
-static inline int64_t S3FIFO_get_n_obj(const cache_t *cache);
 static inline bool S3FIFO_can_insert(cache_t *cache, const request_t *req);
 static void S3FIFO_parse_params(cache_t *cache, const char *cache_specific_params);
+static bool S3FIFO_serialize(const cache_t *cache, FILE *f);
+static bool S3FIFO_deserialize(cache_t *cache, FILE *f);
 
 static void S3FIFO_evict_small(cache_t *cache, const request_t *req);
 static void S3FIFO_evict_main(cache_t *cache, const request_t *req);
@@ -86,16 +100,17 @@ cache_t *S3FIFO_init(const common_cache_params_t ccache_params, const char *cach
   cache->evict = S3FIFO_evict;
   cache->remove = S3FIFO_remove;
   cache->to_evict = S3FIFO_to_evict;
-  cache->get_n_obj = S3FIFO_get_n_obj;
-  cache->get_occupied_byte = S3FIFO_get_occupied_byte;
+  cache->get_n_obj = cache_get_n_obj_default;
+  cache->get_occupied_byte = cache_get_occupied_byte_default;
   cache->can_insert = S3FIFO_can_insert;
+  cache->serialize = S3FIFO_serialize;
+  cache->deserialize = S3FIFO_deserialize;
 
   cache->obj_md_size = 0;
 
   cache->eviction_params = malloc(sizeof(S3FIFO_params_t));
   memset(cache->eviction_params, 0, sizeof(S3FIFO_params_t));
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  params->req_local = new_request();
   params->hit_on_ghost = false;
 
   S3FIFO_parse_params(cache, DEFAULT_CACHE_PARAMS);
@@ -103,26 +118,20 @@ cache_t *S3FIFO_init(const common_cache_params_t ccache_params, const char *cach
     S3FIFO_parse_params(cache, cache_specific_params);
   }
 
-  int64_t small_fifo_size = (int64_t)ccache_params.cache_size * params->small_size_ratio;
-  int64_t main_fifo_size = ccache_params.cache_size - small_fifo_size;
+  params->small_size = (int64_t)ccache_params.cache_size * params->small_size_ratio;
+  params->main_size = ccache_params.cache_size - params->small_size;
   int64_t ghost_fifo_size = (int64_t)(ccache_params.cache_size * params->ghost_size_ratio);
 
-  common_cache_params_t ccache_params_local = ccache_params;
-  ccache_params_local.cache_size = small_fifo_size;
-  params->small_fifo = FIFO_init(ccache_params_local, NULL);
+  params->queues = ring_fifo_init(2);
   params->has_evicted = false;
 
   if (ghost_fifo_size > 0) {
-    ccache_params_local.cache_size = ghost_fifo_size;
-    params->ghost_fifo = FIFO_init(ccache_params_local, NULL);
-    snprintf(params->ghost_fifo->cache_name, CACHE_NAME_ARRAY_LEN, "FIFO-ghost");
+    params->ghost_size = ghost_fifo_size;
+    params->ghost = ghost_history_init(1024);
   } else {
-    params->ghost_fifo = NULL;
+    params->ghost = NULL;
   }
 
-  ccache_params_local.cache_size = main_fifo_size;
-  params->main_fifo = FIFO_init(ccache_params_local, NULL);
-
   snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "S3FIFO-%.4lf-%d", params->small_size_ratio,
            params->move_to_main_threshold);
 
@@ -136,12 +145,10 @@ cache_t *S3FIFO_init(const common_cache_params_t ccache_params, const char *cach
  */
 static void S3FIFO_free(cache_t *cache) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  free_request(params->req_local);
-  params->small_fifo->cache_free(params->small_fifo);
-  if (params->ghost_fifo != NULL) {
-    params->ghost_fifo->cache_free(params->ghost_fifo);
+  ring_fifo_free(params->queues);
+  if (params->ghost != NULL) {
+    ghost_history_free(params->ghost);
   }
-  params->main_fifo->cache_free(params->main_fifo);
   free(cache->eviction_params);
   cache_struct_free(cache);
 }
@@ -166,10 +173,7 @@ static void S3FIFO_free(cache_t *cache) {
  * @return true if cache hit, false if cache miss
  */
 static bool S3FIFO_get(cache_t *cache, const request_t *req) {
-  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  DEBUG_ASSERT(params->small_fifo->get_occupied_byte(params->small_fifo) +
-                   params->main_fifo->get_occupied_byte(params->main_fifo) <=
-               cache->cache_size);
+  DEBUG_ASSERT(cache->get_occupied_byte(cache) <= cache->cache_size);
 
   bool cache_hit = cache_get_base(cache, req);
 
@@ -194,38 +198,24 @@ static bool S3FIFO_get(cache_t *cache, const request_t *req) {
 static cache_obj_t *S3FIFO_find(cache_t *cache, const request_t *req, const bool update_cache) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
 
-  // if update cache is false, we only check the fifo and main caches
+  cache_obj_t *obj = cache_find_base(cache, req, update_cache);
   if (!update_cache) {
-    cache_obj_t *obj = params->small_fifo->find(params->small_fifo, req, false);
-    if (obj != NULL) {
-      return obj;
-    }
-    obj = params->main_fifo->find(params->main_fifo, req, false);
-    if (obj != NULL) {
-      return obj;
-    }
-    return NULL;
+    return obj;
   }
 
   /* update cache is true from now */
   params->hit_on_ghost = false;
-  cache_obj_t *obj = params->small_fifo->find(params->small_fifo, req, true);
   if (obj != NULL) {
-    obj->S3FIFO.freq += 1;
+    if (obj->ring_fifo.freq < INT32_MAX) obj->ring_fifo.freq += 1;
     return obj;
   }
 
-  if (params->ghost_fifo != NULL && params->ghost_fifo->remove(params->ghost_fifo, req->obj_id)) {
-    // if object in ghost_fifo, remove will return true
+  if (params->ghost != NULL && ghost_history_remove(params->ghost, req->obj_id, NULL, NULL)) {
+    // if object in ghost, remove will return true
     params->hit_on_ghost = true;
   }
 
-  obj = params->main_fifo->find(params->main_fifo, req, true);
-  if (obj != NULL) {
-    obj->S3FIFO.freq += 1;
-  }
-
-  return obj;
+  return NULL;
 }
 
 /**
@@ -241,29 +231,28 @@ static cache_obj_t *S3FIFO_find(cache_t *cache, const request_t *req, const bool
  */
 static cache_obj_t *S3FIFO_insert(cache_t *cache, const request_t *req) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  cache_obj_t *obj = NULL;
-
-  cache_t *small = params->small_fifo;
-  cache_t *main = params->main_fifo;
+  int queue_id;
 
   if (params->hit_on_ghost) {
     /* insert into main FIFO */
     params->hit_on_ghost = false;
-    obj = main->insert(main, req);
+    queue_id = MAIN_QUEUE;
   } else {
     /* insert into small fifo */
-    if (req->obj_size >= small->cache_size) {
+    if (req->obj_size >= params->small_size) {
       return NULL;
     }
 
-    if (!params->has_evicted && small->get_occupied_byte(small) >= small->cache_size) {
-      obj = main->insert(main, req);
+    if (!params->has_evicted && ring_fifo_n_byte(params->queues, SMALL_QUEUE) >= params->small_size) {
+      queue_id = MAIN_QUEUE;
     } else {
-      obj = small->insert(small, req);
+      queue_id = SMALL_QUEUE;
     }
   }
 
-  obj->S3FIFO.freq = 0;
+  cache_obj_t *obj = cache_insert_base(cache, req);
+  ring_fifo_push(params->queues, queue_id, obj);
+  obj->ring_fifo.freq = 0;
 
   return obj;
 }
@@ -283,58 +272,58 @@ static cache_obj_t *S3FIFO_to_evict(cache_t *cache, const request_t *req) {
   return NULL;
 }
 
+/* the ghost is a FIFO bounded by ghost_size bytes */
+static void S3FIFO_insert_ghost(S3FIFO_params_t *params, const cache_obj_t *obj) {
+  if (obj->obj_size > params->ghost_size) {
+    return;
+  }
+
+  while (params->ghost->n_byte + obj->obj_size > params->ghost_size) {
+    ghost_history_pop_oldest(params->ghost, NULL, NULL);
+  }
+  ghost_history_insert(params->ghost, obj->obj_id, obj->obj_size, 0);
+}
+
 static void S3FIFO_evict_small(cache_t *cache, const request_t *req) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  cache_t *small = params->small_fifo;
-  cache_t *ghost = params->ghost_fifo;
-  cache_t *main = params->main_fifo;
+  ring_fifo_t *queues = params->queues;
 
   bool has_evicted = false;
-  while (!has_evicted && small->get_occupied_byte(small) > 0) {
-    cache_obj_t *obj_to_evict = small->to_evict(small, req);
+  while (!has_evicted && ring_fifo_n_byte(queues, SMALL_QUEUE) > 0) {
+    cache_obj_t *obj_to_evict = ring_fifo_oldest(queues, SMALL_QUEUE);
     DEBUG_ASSERT(obj_to_evict != NULL);
-    // need to copy the object before it is evicted
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
 
-    if (obj_to_evict->S3FIFO.freq >= params->move_to_main_threshold) {
-      main->insert(main, params->req_local);
+    if (obj_to_evict->ring_fifo.freq >= params->move_to_main_threshold) {
+      ring_fifo_move_to_tail(queues, obj_to_evict, MAIN_QUEUE);
+      obj_to_evict->ring_fifo.freq = 0;
     } else {
       // insert to ghost
-      if (ghost != NULL) {
-        ghost->get(ghost, params->req_local);
+      if (params->ghost != NULL) {
+        S3FIFO_insert_ghost(params, obj_to_evict);
       }
+      ring_fifo_remove(queues, obj_to_evict);
+      cache_evict_base(cache, obj_to_evict, true);
       has_evicted = true;
     }
-
-    // remove from small fifo, but do not update stat
-    bool removed = small->remove(small, params->req_local->obj_id);
-    DEBUG_ASSERT(removed);
   }
 }
 
 static void S3FIFO_evict_main(cache_t *cache, const request_t *req) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  cache_t *main = params->main_fifo;
+  ring_fifo_t *queues = params->queues;
 
   bool has_evicted = false;
-  while (!has_evicted && main->get_occupied_byte(main) > 0) {
-    cache_obj_t *obj_to_evict = main->to_evict(main, req);
+  while (!has_evicted && ring_fifo_n_byte(queues, MAIN_QUEUE) > 0) {
+    cache_obj_t *obj_to_evict = ring_fifo_oldest(queues, MAIN_QUEUE);
     DEBUG_ASSERT(obj_to_evict != NULL);
-    int freq = obj_to_evict->S3FIFO.freq;
-    copy_cache_obj_to_request(params->req_local, obj_to_evict);
+    int freq = obj_to_evict->ring_fifo.freq;
     if (freq >= 1) {
-      // we need to evict first because the object to insert has the same obj_id
-      main->remove(main, obj_to_evict->obj_id);
-      obj_to_evict = NULL;
-
-      cache_obj_t *new_obj = main->insert(main, params->req_local);
+      ring_fifo_move_to_tail(queues, obj_to_evict, MAIN_QUEUE);
       // clock with 2-bit counter
-      new_obj->S3FIFO.freq = MIN(freq, 3) - 1;
-
+      obj_to_evict->ring_fifo.freq = MIN(freq, 3) - 1;
     } else {
-      bool removed = main->remove(main, obj_to_evict->obj_id);
-      DEBUG_ASSERT(removed);
-
+      ring_fifo_remove(queues, obj_to_evict);
+      cache_evict_base(cache, obj_to_evict, true);
       has_evicted = true;
     }
   }
@@ -353,10 +342,8 @@ static void S3FIFO_evict(cache_t *cache, const request_t *req) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
   params->has_evicted = true;
 
-  cache_t *small = params->small_fifo;
-  cache_t *main = params->main_fifo;
-
-  if (main->get_occupied_byte(main) > main->cache_size || small->get_occupied_byte(small) == 0) {
+  if (ring_fifo_n_byte(params->queues, MAIN_QUEUE) > params->main_size ||
+      ring_fifo_n_byte(params->queues, SMALL_QUEUE) == 0) {
     S3FIFO_evict_main(cache, req);
   } else {
     S3FIFO_evict_small(cache, req);
@@ -378,29 +365,20 @@ static void S3FIFO_evict(cache_t *cache, const request_t *req) {
  */
 static bool S3FIFO_remove(cache_t *cache, const obj_id_t obj_id) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  bool removed = false;
-  removed = removed || params->small_fifo->remove(params->small_fifo, obj_id);
-  removed = removed || (params->ghost_fifo && params->ghost_fifo->remove(params->ghost_fifo, obj_id));
-  removed = removed || params->main_fifo->remove(params->main_fifo, obj_id);
-
-  return removed;
-}
-
-static inline int64_t S3FIFO_get_occupied_byte(const cache_t *cache) {
-  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  return params->small_fifo->get_occupied_byte(params->small_fifo) +
-         params->main_fifo->get_occupied_byte(params->main_fifo);
-}
+  cache_obj_t *obj = hashtable_find_obj_id(cache->hashtable, obj_id);
+  if (obj != NULL) {
+    ring_fifo_remove(params->queues, obj);
+    cache_remove_obj_base(cache, obj, true);
+    return true;
+  }
 
-static inline int64_t S3FIFO_get_n_obj(const cache_t *cache) {
-  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
-  return params->small_fifo->get_n_obj(params->small_fifo) + params->main_fifo->get_n_obj(params->main_fifo);
+  return params->ghost != NULL && ghost_history_remove(params->ghost, obj_id, NULL, NULL);
 }
 
 static inline bool S3FIFO_can_insert(cache_t *cache, const request_t *req) {
   S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
 
-  return req->obj_size <= params->small_fifo->cache_size && cache_can_insert_default(cache, req);
+  return req->obj_size <= params->small_size && cache_can_insert_default(cache, req);
 }
 
 // ***********************************************************************
@@ -450,6 +428,67 @@ static void S3FIFO_parse_params(cache_t *cache, const char *cache_specific_param
   free(old_params_str);
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     checkpoint functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+/**
+ * @brief write the small and the main queue from the oldest to the newest
+ * object and the ghost, see checkpoint.h
+ */
+static bool S3FIFO_serialize(const cache_t *cache, FILE *f) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  if (!checkpoint_write(f, &params->has_evicted, sizeof(params->has_evicted))) return false;
+
+  for (int queue_id = SMALL_QUEUE; queue_id <= MAIN_QUEUE; queue_id++) {
+    const ring_fifo_queue_t *q = &params->queues->queues[queue_id];
+    if (!checkpoint_write(f, &q->n_obj, sizeof(q->n_obj))) return false;
+    for (int64_t pos = q->head; pos < q->tail; pos++) {
+      const cache_obj_t *obj = q->slots[pos & q->mask];
+      if (obj != NULL && !checkpoint_write_obj(f, obj, obj->ring_fifo.freq)) return false;
+    }
+  }
+
+  bool has_ghost = params->ghost != NULL;
+  if (!checkpoint_write(f, &has_ghost, sizeof(has_ghost))) return false;
+  return !has_ghost || ghost_history_save(params->ghost, f);
+}
+
+static bool S3FIFO_deserialize(cache_t *cache, FILE *f) {
+  S3FIFO_params_t *params = (S3FIFO_params_t *)cache->eviction_params;
+  if (!checkpoint_read(f, &params->has_evicted, sizeof(params->has_evicted))) return false;
+
+  for (int queue_id = SMALL_QUEUE; queue_id <= MAIN_QUEUE; queue_id++) {
+    int64_t n_obj;
+    if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+    for (int64_t i = 0; i < n_obj; i++) {
+      int64_t md;
+      cache_obj_t *obj = checkpoint_read_obj(cache, f, &md);
+      if (obj == NULL) return false;
+      ring_fifo_push(params->queues, queue_id, obj);
+      obj->ring_fifo.freq = (int32_t)md;
+    }
+  }
+
+  /* the cache may be restored with a different ghost size (deep_clone_cache),
+   * a saved ghost is dropped if the cache has none, and trimmed to its size */
+  bool has_ghost;
+  if (!checkpoint_read(f, &has_ghost, sizeof(has_ghost))) return false;
+  if (!has_ghost) return true;
+  if (params->ghost == NULL) {
+    ghost_history_t *ghost = ghost_history_init(1024);
+    bool loaded = ghost_history_load(ghost, f);
+    ghost_history_free(ghost);
+    return loaded;
+  }
+  if (!ghost_history_load(params->ghost, f)) return false;
+  while (params->ghost->n_byte > params->ghost_size) {
+    ghost_history_pop_oldest(params->ghost, NULL, NULL);
+  }
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -82,6 +82,7 @@ cache_t *S3FIFOd_init(const common_cache_params_t ccache_params,
   cache->evict = S3FIFOd_evict;
   cache->remove = S3FIFOd_remove;
   cache->to_evict = S3FIFOd_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = S3FIFOd_get_n_obj;
   cache->get_occupied_byte = S3FIFOd_get_occupied_byte;
   cache->can_insert = S3FIFOd_can_insert;
@@ -87,6 +87,7 @@ cache_t *S3FIFOv0_init(const common_cache_params_t ccache_params, const char *ca
   cache->evict = S3FIFOv0_evict;
   cache->remove = S3FIFOv0_remove;
   cache->to_evict = S3FIFOv0_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = S3FIFOv0_get_n_obj;
   cache->get_occupied_byte = S3FIFOv0_get_occupied_byte;
   cache->can_insert = S3FIFOv0_can_insert;
@@ -71,6 +71,7 @@ cache_t *SLRUv0_init(const common_cache_params_t ccache_params,
   cache->evict = SLRUv0_evict;
   cache->remove = SLRUv0_remove;
   cache->to_evict = SLRUv0_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->can_insert = SLRUv0_can_insert;
   cache->get_occupied_byte = SLRUv0_get_occupied_byte;
   cache->get_n_obj = SLRUv0_get_n_obj;
@@ -2,6 +2,7 @@
 
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../include/libCacheSim/cache.h"
+#include "../../include/libCacheSim/checkpoint.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +28,8 @@ static cache_obj_t *Sieve_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *Sieve_to_evict(cache_t *cache, const request_t *req);
 static void Sieve_evict(cache_t *cache, const request_t *req);
 static bool Sieve_remove(cache_t *cache, const obj_id_t obj_id);
+static bool Sieve_serialize(const cache_t *cache, FILE *f);
+static bool Sieve_deserialize(cache_t *cache, FILE *f);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -68,6 +71,9 @@ cache_t *Sieve_init(const common_cache_params_t ccache_params,
   params->q_head = NULL;
   params->q_tail = NULL;
 
+  cache->serialize = Sieve_serialize;
+  cache->deserialize = Sieve_deserialize;
+
   return cache;
 }
 
@@ -281,6 +287,57 @@ static void Sieve_verify(cache_t *cache) {
   assert(n_byte == cache->get_occupied_byte(cache));
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                     checkpoint functions                      ****
+// ****                                                               ****
+// ***********************************************************************
+/**
+ * @brief write the objects from the oldest to the newest, see checkpoint.h
+ */
+static bool Sieve_serialize(const cache_t *cache, FILE *f) {
+  Sieve_params_t *params = (Sieve_params_t *)cache->eviction_params;
+  int64_t n_obj = cache->n_obj;
+  if (!checkpoint_write(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (cache_obj_t *obj = params->q_tail; obj != NULL;
+       obj = obj->queue.prev) {
+    if (!checkpoint_write_obj(f, obj, obj->sieve.freq)) return false;
+  }
+
+  /* the hand is NULL before the first eviction and after a full round */
+  bool has_pointer = params->pointer != NULL;
+  obj_id_t pointer_id = has_pointer ? params->pointer->obj_id : 0;
+  return checkpoint_write(f, &has_pointer, sizeof(has_pointer)) &&
+         checkpoint_write(f, &pointer_id, sizeof(pointer_id));
+}
+
+static bool Sieve_deserialize(cache_t *cache, FILE *f) {
+  Sieve_params_t *params = (Sieve_params_t *)cache->eviction_params;
+  int64_t n_obj;
+  if (!checkpoint_read(f, &n_obj, sizeof(n_obj))) return false;
+
+  for (int64_t i = 0; i < n_obj; i++) {
+    int64_t md;
+    cache_obj_t *obj = checkpoint_read_obj(cache, f, &md);
+    if (obj == NULL) return false;
+    prepend_obj_to_head(&params->q_head, &params->q_tail, obj);
+    obj->sieve.freq = (int)md;
+  }
+
+  bool has_pointer;
+  obj_id_t pointer_id;
+  if (!checkpoint_read(f, &has_pointer, sizeof(has_pointer)) ||
+      !checkpoint_read(f, &pointer_id, sizeof(pointer_id))) {
+    return false;
+  }
+  if (has_pointer) {
+    params->pointer = hashtable_find_obj_id(cache->hashtable, pointer_id);
+    if (params->pointer == NULL) return false;
+  }
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,10 @@
 //
 //  the Size eviction algorithm (MIN)
 //
+//  objects are kept in a bucket queue of log2 size classes, order=exact evicts
+//  the largest object (the oldest one if several have the same size),
+//  order=approx evicts the oldest object of the largest size class
+//
 //
 //  Size.c
 //  libCacheSim
@@ -9,8 +13,8 @@
 // Created by Juncheng Yang on 3/30/21.
 //
 
+#include "../../dataStructure/bucketQueue.h"
 #include "../../dataStructure/hashtable/hashtable.h"
-#include "../../dataStructure/pqueue.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
 
 #ifdef __cplusplus
@@ -19,9 +23,12 @@ extern "C" {
 
 typedef struct Size_params {
   /* a priority queue ordering the object size */
-  pqueue_t *pq;
+  bucket_queue_t *bq;
+  bool exact;
 } Size_params_t;
 
+static const char *DEFAULT_PARAMS = "order=exact";
+
 // ***********************************************************************
 // ****                                                               ****
 // ****                   function declarations                       ****
@@ -37,6 +44,7 @@ static cache_obj_t *Size_to_evict(cache_t *cache, const request_t *req);
 static void Size_evict(cache_t *cache, const request_t *req);
 static bool Size_remove(cache_t *cache, const obj_id_t obj_id);
 static void Size_remove_obj(cache_t *cache, cache_obj_t *obj);
+static void Size_parse_params(cache_t *cache, const char *cache_specific_params);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -65,9 +73,19 @@ cache_t *Size_init(const common_cache_params_t ccache_params,
   cache->remove = Size_remove;
 
   Size_params_t *params = my_malloc(Size_params_t);
+  memset(params, 0, sizeof(Size_params_t));
   cache->eviction_params = params;
 
-  params->pq = pqueue_init((unsigned long)8e6);
+  Size_parse_params(cache, DEFAULT_PARAMS);
+  if (cache_specific_params != NULL) {
+    Size_parse_params(cache, cache_specific_params);
+  }
+
+  if (!params->exact) {
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "Size-approx");
+  }
+
+  params->bq = bucket_queue_init(true, params->exact);
   return cache;
 }
 
@@ -78,12 +96,8 @@ cache_t *Size_init(const common_cache_params_t ccache_params,
  */
 static void Size_free(cache_t *cache) {
   Size_params_t *params = cache->eviction_params;
-  pq_node_t *node = pqueue_pop(params->pq);
-  while (node) {
-    my_free(sizeof(pq_node_t), node);
-    node = pqueue_pop(params->pq);
-  }
-  pqueue_free(params->pq);
+  bucket_queue_free(params->bq);
+  my_free(sizeof(Size_params_t), params);
 
   cache_struct_free(cache);
 }
@@ -109,7 +123,7 @@ static void Size_free(cache_t *cache) {
  */
 static bool Size_get(cache_t *cache, const request_t *req) {
   Size_params_t *params = cache->eviction_params;
-  DEBUG_ASSERT(cache->n_obj == (int64_t) params->pq->size - 1);
+  DEBUG_ASSERT(cache->n_obj == params->bq->n_obj);
   bool ret = cache_get_base(cache, req);
 
   return ret;
@@ -142,9 +156,9 @@ static cache_obj_t *Size_find(cache_t *cache, const request_t *req,
     return NULL;
   }
 
-  pqueue_pri_t pri = {.pri = req->obj_size};
-  pqueue_change_priority(params->pq, pri,
-                         (pq_node_t *)(cached_obj->Size.pq_node));
+  if (cached_obj->bucket_queue.key != (double)req->obj_size) {
+    bucket_queue_update(params->bq, cached_obj, (double)req->obj_size);
+  }
   return cached_obj;
 }
 
@@ -163,11 +177,7 @@ static cache_obj_t *Size_insert(cache_t *cache, const request_t *req) {
 
   cache_obj_t *cached_obj = cache_insert_base(cache, req);
 
-  pq_node_t *node = my_malloc(pq_node_t);
-  node->obj_id = req->obj_id;
-  node->pri.pri = req->obj_size;
-  pqueue_insert(params->pq, (void *)node);
-  cached_obj->Size.pq_node = node;
+  bucket_queue_insert(params->bq, cached_obj, (double)req->obj_size);
 
   return cached_obj;
 }
@@ -184,8 +194,7 @@ static cache_obj_t *Size_insert(cache_t *cache, const request_t *req) {
  */
 static cache_obj_t *Size_to_evict(cache_t *cache, const request_t *req) {
   Size_params_t *params = cache->eviction_params;
-  pq_node_t *node = (pq_node_t *)pqueue_peek(params->pq);
-  return hashtable_find_obj_id(cache->hashtable, node->obj_id);
+  return bucket_queue_peek(params->bq);
 }
 
 /**
@@ -199,14 +208,8 @@ static cache_obj_t *Size_to_evict(cache_t *cache, const request_t *req) {
 static void Size_evict(cache_t *cache,
                          const request_t *req) {
   Size_params_t *params = cache->eviction_params;
-  pq_node_t *node = (pq_node_t *)pqueue_pop(params->pq);
-
-  cache_obj_t *obj_to_evict =
-      hashtable_find_obj_id(cache->hashtable, node->obj_id);
-  DEBUG_ASSERT(node == obj_to_evict->Size.pq_node);
-
-  obj_to_evict->Size.pq_node = NULL;
-  my_free(sizeof(pq_node_t), node);
+  cache_obj_t *obj_to_evict = bucket_queue_pop(params->bq);
+  DEBUG_ASSERT(obj_to_evict != NULL);
 
   cache_evict_base(cache, obj_to_evict, true);
 }
@@ -215,13 +218,7 @@ static void Size_remove_obj(cache_t *cache, cache_obj_t *obj) {
   Size_params_t *params = cache->eviction_params;
   DEBUG_ASSERT(obj != NULL);
 
-  if (obj->Size.pq_node != NULL) {
-    /* if it is NULL, it means we have deleted the entry in pq before this */
-    pqueue_remove(params->pq, obj->Size.pq_node);
-    my_free(sizeof(pq_node_t), obj->Size.pq_node);
-    obj->Size.pq_node = NULL;
-  }
-
+  bucket_queue_remove(params->bq, obj);
   cache_remove_obj_base(cache, obj, true);
 }
 
@@ -248,6 +245,53 @@ static bool Size_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                  parameter set up functions                   ****
+// ****                                                               ****
+// ***********************************************************************
+static const char *Size_current_params(Size_params_t *params) {
+  static __thread char params_str[128];
+  snprintf(params_str, 128, "order=%s\n", params->exact ? "exact" : "approx");
+  return params_str;
+}
+
+static void Size_parse_params(cache_t *cache, const char *cache_specific_params) {
+  Size_params_t *params = (Size_params_t *)cache->eviction_params;
+  char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "order") == 0) {
+      if (strcasecmp(value, "exact") == 0) {
+        params->exact = true;
+      } else if (strcasecmp(value, "approx") == 0) {
+        params->exact = false;
+      } else {
+        ERROR("unknown order %s, supported: exact, approx\n", value);
+      }
+    } else if (strcasecmp(key, "print") == 0) {
+      printf("current parameters: %s\n", Size_current_params(params));
+      exit(0);
+    } else {
+      ERROR("%s does not have parameter %s, example parameters %s\n", cache->cache_name, key,
+            Size_current_params(params));
+      exit(1);
+    }
+  }
+  free(old_params_str);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -76,6 +76,7 @@ cache_t *TwoQ_init(const common_cache_params_t ccache_params,
   cache->evict = TwoQ_evict;
   cache->remove = TwoQ_remove;
   cache->to_evict = TwoQ_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = TwoQ_get_n_obj;
   cache->get_occupied_byte = TwoQ_get_occupied_byte;
   cache->can_insert = TwoQ_can_insert;
@@ -14,6 +14,7 @@
 //  Created by Ziyue on 14/1/2023.
 //
 
+#include "../../dataStructure/countMinSketch.h"
 #include "../../dataStructure/hashtable/hashtable.h"
 #include "../../dataStructure/minimalIncrementCBF.h"
 #include "../../include/libCacheSim/evictionAlgo.h"
@@ -32,6 +33,11 @@ typedef struct WTinyLFU_params {
   cache_t *main_cache;  // any eviction policy
   double window_size;
   int64_t n_admit_bytes;
+  // frequency estimator, the blocked count-min sketch or, for comparison,
+  // the minimal increment CBF
+  count_min_sketch_t *sketch;
+  bool use_doorkeeper;
+  bool use_CBF;
   struct minimalIncrementCBF *CBF;
   size_t max_request_num;
   size_t request_counter;
@@ -40,7 +46,12 @@ typedef struct WTinyLFU_params {
   request_t *req_local;
 } WTinyLFU_params_t;
 
-static const char *DEFAULT_PARAMS = "main-cache=SLRU,window-size=0.01";
+static const char *DEFAULT_PARAMS =
+    "main-cache=SLRU,window-size=0.01,sketch=cms,doorkeeper=1";
+
+/* the sketch starts with room for this many objects and grows with the
+ * cache, so byte-sized caches do not allocate one counter per byte */
+#define SKETCH_MAX_INIT_N_OBJ (1 << 20)
 
 // ***********************************************************************
 // ****                                                               ****
@@ -62,6 +73,8 @@ static void WTinyLFU_parse_params(cache_t *cache,
 bool WTinyLFU_can_insert(cache_t *cache, const request_t *req);
 static int64_t WTinyLFU_get_occupied_byte(const cache_t *cache);
 static int64_t WTinyLFU_get_n_obj(const cache_t *cache);
+static void WTinyLFU_record_freq(WTinyLFU_params_t *params, obj_id_t obj_id);
+static int WTinyLFU_estimate_freq(WTinyLFU_params_t *params, obj_id_t obj_id);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -89,6 +102,7 @@ cache_t *WTinyLFU_init(const common_cache_params_t ccache_params,
   cache->evict = WTinyLFU_evict;
   cache->remove = WTinyLFU_remove;
   cache->to_evict = WTinyLFU_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->can_insert = WTinyLFU_can_insert;
   cache->get_occupied_byte = WTinyLFU_get_occupied_byte;
   cache->get_n_obj = WTinyLFU_get_n_obj;
@@ -144,30 +158,41 @@ cache_t *WTinyLFU_init(const common_cache_params_t ccache_params,
     ERROR("WTinyLFU does not support %s \n", params->main_cache_type);
   }
 
-  snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "WTinyLFU-w%.2lf-%s",
-           params->window_size, params->main_cache_type);
+  snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "WTinyLFU-w%.2lf-%s%s%s",
+           params->window_size, params->main_cache_type,
+           params->use_CBF ? "-CBF" : "",
+           !params->use_CBF && !params->use_doorkeeper ? "-noDK" : "");
 
   params->req_local = new_request();
   params->n_admit_bytes = 0;
 
-  params->max_request_num =
-      32 * params->main_cache->cache_size;  // sample size is 32
-
-  params->CBF =
-      (struct minimalIncrementCBF *)malloc(sizeof(struct minimalIncrementCBF));
-  DEBUG_ASSERT(params->CBF != NULL);
-  params->CBF->ready = 0;
-
-  // TODO @ Ziyue: how to set entries and error rate?
-  int ret = minimalIncrementCBF_init(params->CBF,
-                                     params->main_cache->cache_size, 0.001);
-  if (ret != 0) {
-    ERROR("CBF init failed\n");
-  }
+  params->sketch = NULL;
+  params->CBF = NULL;
+  if (params->use_CBF) {
+    params->max_request_num =
+        32 * params->main_cache->cache_size;  // sample size is 32
+
+    params->CBF = (struct minimalIncrementCBF *)malloc(
+        sizeof(struct minimalIncrementCBF));
+    DEBUG_ASSERT(params->CBF != NULL);
+    params->CBF->ready = 0;
+
+    // TODO @ Ziyue: how to set entries and error rate?
+    int ret = minimalIncrementCBF_init(params->CBF,
+                                       params->main_cache->cache_size, 0.001);
+    if (ret != 0) {
+      ERROR("CBF init failed\n");
+    }
 
 #ifdef DEBUG_MODE
-  minimalIncrementCBF_print(params->CBF);
+    minimalIncrementCBF_print(params->CBF);
 #endif
+  } else {
+    // the sketch ages by itself
+    params->sketch = count_min_sketch_init(
+        MIN(params->main_cache->cache_size, SKETCH_MAX_INIT_N_OBJ),
+        params->use_doorkeeper);
+  }
 
   params->request_counter = 0;  // initialize request counter
 
@@ -189,8 +214,13 @@ static void WTinyLFU_free(cache_t *cache) {
   params->LRU->cache_free(params->LRU);
   params->main_cache->cache_free(params->main_cache);
 
-  minimalIncrementCBF_free(params->CBF);
-  free(params->CBF);
+  if (params->CBF != NULL) {
+    minimalIncrementCBF_free(params->CBF);
+    free(params->CBF);
+  }
+  if (params->sketch != NULL) {
+    count_min_sketch_free(params->sketch);
+  }
   free_request(params->req_local);
 
   cache_struct_free(cache);
@@ -223,12 +253,15 @@ static cache_obj_t *WTinyLFU_find(cache_t *cache, const request_t *req,
 
   if (obj_main != NULL) {
     // frequency update
-    minimalIncrementCBF_add(params->CBF, (void *)&req->obj_id, sizeof(obj_id_t));
-
-    params->request_counter++;
-    if (params->request_counter >= params->max_request_num) {
-      params->request_counter = 0;
-      minimalIncrementCBF_decay(params->CBF);
+    WTinyLFU_record_freq(params, req->obj_id);
+
+    // the sketch ages by itself, the CBF decays every max_request_num hits
+    if (params->CBF != NULL) {
+      params->request_counter++;
+      if (params->request_counter >= params->max_request_num) {
+        params->request_counter = 0;
+        minimalIncrementCBF_decay(params->CBF);
+      }
     }
   }
 
@@ -241,7 +274,10 @@ cache_obj_t *WTinyLFU_insert(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = NULL;
   obj = params->LRU->insert(params->LRU, req);
 
-  minimalIncrementCBF_add(params->CBF, (void *)&req->obj_id, sizeof(obj_id_t));
+  if (params->sketch != NULL) {
+    count_min_sketch_ensure_capacity(params->sketch, WTinyLFU_get_n_obj(cache));
+  }
+  WTinyLFU_record_freq(params, req->obj_id);
 
 #if defined(TRACK_DEMOTION)
   obj->create_time = cache->n_req;
@@ -292,12 +328,8 @@ static void WTinyLFU_evict(cache_t *cache, const request_t *req) {
         cache_obj_t *main_cache_victim = main->to_evict(main, req);
         DEBUG_ASSERT(main_cache_victim != NULL);
         // if window_victim is more frequent, insert it into main_cache
-        if (minimalIncrementCBF_estimate(params->CBF,
-                                         (void *)&window_victim->obj_id,
-                                         sizeof(window_victim->obj_id)) >
-            minimalIncrementCBF_estimate(params->CBF,
-                                         (void *)&main_cache_victim->obj_id,
-                                         sizeof(main_cache_victim->obj_id))) {
+        if (WTinyLFU_estimate_freq(params, window_victim->obj_id) >
+            WTinyLFU_estimate_freq(params, main_cache_victim->obj_id)) {
 #if defined(TRACK_DEMOTION)
           printf("%ld keep %ld %ld\n", cache->n_req, window_victim->create_time,
                  window_victim->misc.next_access_vtime);
@@ -322,9 +354,7 @@ static void WTinyLFU_evict(cache_t *cache, const request_t *req) {
           evicted = true;
         }
       }
-      // TODO @ Ziyue: add doorkeeper
-      minimalIncrementCBF_add(params->CBF, (void *)(&params->req_local->obj_id),
-                              sizeof(obj_id_t));
+      WTinyLFU_record_freq(params, params->req_local->obj_id);
     } else {
       DEBUG_ASSERT(window->get_occupied_byte(window) == 0);
       main->evict(main, req);
@@ -364,6 +394,17 @@ static void WTinyLFU_parse_params(cache_t *cache,
 
     if (strcasecmp(key, "main-cache") == 0) {
       strncpy(params->main_cache_type, value, 30);
+    } else if (strcasecmp(key, "sketch") == 0) {
+      if (strcasecmp(value, "cms") == 0) {
+        params->use_CBF = false;
+      } else if (strcasecmp(value, "cbf") == 0) {
+        params->use_CBF = true;
+      } else {
+        ERROR("WTinyLFU sketch must be cms or cbf, got %s\n", value);
+        exit(1);
+      }
+    } else if (strcasecmp(key, "doorkeeper") == 0) {
+      params->use_doorkeeper = strtol(value, NULL, 10) != 0;
     } else if (strcasecmp(key, "window-size") == 0) {
       params->window_size = strtod(value, NULL);  // cover default value
       if (params->window_size < 0 || params->window_size >= 1) {
@@ -398,6 +439,24 @@ static int64_t WTinyLFU_get_occupied_byte(const cache_t *cache) {
   return occupied_byte;
 }
 
+static void WTinyLFU_record_freq(WTinyLFU_params_t *params, obj_id_t obj_id) {
+  if (params->sketch != NULL) {
+    count_min_sketch_increment(params->sketch, obj_id);
+    return;
+  }
+
+  minimalIncrementCBF_add(params->CBF, (void *)&obj_id, sizeof(obj_id_t));
+}
+
+static int WTinyLFU_estimate_freq(WTinyLFU_params_t *params, obj_id_t obj_id) {
+  if (params->sketch != NULL) {
+    return count_min_sketch_estimate(params->sketch, obj_id);
+  }
+
+  return minimalIncrementCBF_estimate(params->CBF, (void *)&obj_id,
+                                      sizeof(obj_id_t));
+}
+
 static int64_t WTinyLFU_get_n_obj(const cache_t *cache) {
   WTinyLFU_params_t *params = (WTinyLFU_params_t *)cache->eviction_params;
   int64_t n_obj = 0;
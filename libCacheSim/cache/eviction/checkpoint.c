@@ -0,0 +1,303 @@
+//
+//  checkpoint.c
+//  libCacheSim
+//
+//  save and restore the state of a cache, see checkpoint.h
+//
+
+#include "../../include/libCacheSim/checkpoint.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../dataStructure/hashtable/hashtable.h"
+#include "../../include/libCacheSim/evictionAlgo.h"
+#ifdef SUPPORT_TTL
+#include "../../dataStructure/ttlWheel.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* "LCSCKPT" */
+#define CHECKPOINT_MAGIC 0x54504b4353434cULL
+#define CHECKPOINT_VERSION 2
+
+/* the algorithms that cache_restore can create, a cache is matched by its
+ * cache_init function */
+static const struct {
+  const char *algo;
+  cache_init_func_ptr init;
+} checkpoint_algos[] = {
+    {"LRU", LRU_init},     {"FIFO", FIFO_init}, {"Clock", Clock_init}, {"Sieve", Sieve_init},
+    {"S3FIFO", S3FIFO_init}, {"ARC", ARC_init},   {"LFU", LFU_init},
+};
+
+#define N_CHECKPOINT_ALGO (int)(sizeof(checkpoint_algos) / sizeof(checkpoint_algos[0]))
+
+typedef struct {
+  uint64_t magic;
+  int32_t version;
+  int32_t obj_md_size;
+  char algo[CACHE_NAME_ARRAY_LEN];
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+  char init_params[CACHE_INIT_PARAMS_LEN];
+  int64_t cache_size;
+  int64_t default_ttl;
+  int32_t hashpower;
+  int32_t pad;
+
+  int64_t n_req;
+  /* checked after the objects are restored */
+  int64_t n_obj;
+  int64_t occupied_byte;
+  int64_t n_expired_obj;
+  int64_t n_expired_byte;
+  int64_t log_eviction_age_cnt[EVICTION_AGE_ARRAY_SZE];
+} checkpoint_header_t;
+
+typedef struct {
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int64_t next_access_vtime;
+  int64_t md;
+  int32_t freq;
+  /* 0 if the object does not expire or the library is built without TTL */
+  uint32_t exp_time;
+} checkpoint_obj_t;
+
+static int find_checkpoint_algo(cache_init_func_ptr init) {
+  for (int i = 0; i < N_CHECKPOINT_ALGO; i++) {
+    if (checkpoint_algos[i].init == init) return i;
+  }
+  return -1;
+}
+
+bool cache_support_checkpoint(const cache_t *cache) {
+  return find_checkpoint_algo(cache->cache_init) >= 0 && cache->serialize != NULL && cache->deserialize != NULL &&
+         cache->admissioner == NULL && cache->prefetcher == NULL;
+}
+
+bool checkpoint_write(FILE *f, const void *buf, size_t size) { return size == 0 || fwrite(buf, size, 1, f) == 1; }
+
+bool checkpoint_read(FILE *f, void *buf, size_t size) { return size == 0 || fread(buf, size, 1, f) == 1; }
+
+bool checkpoint_write_obj(FILE *f, const cache_obj_t *obj, int64_t md) {
+  checkpoint_obj_t rec = {
+      .obj_id = obj->obj_id,
+      .obj_size = obj->obj_size,
+      .next_access_vtime = obj->misc.next_access_vtime,
+      .md = md,
+      .freq = obj->misc.freq,
+      .exp_time = 0,
+  };
+#ifdef SUPPORT_TTL
+  rec.exp_time = obj->exp_time;
+#endif
+  return checkpoint_write(f, &rec, sizeof(rec));
+}
+
+cache_obj_t *checkpoint_read_obj(cache_t *cache, FILE *f, int64_t *md) {
+  checkpoint_obj_t rec;
+  if (!checkpoint_read(f, &rec, sizeof(rec))) return NULL;
+
+  request_t req;
+  memset(&req, 0, sizeof(req));
+  req.obj_id = rec.obj_id;
+  req.obj_size = rec.obj_size;
+  req.next_access_vtime = rec.next_access_vtime;
+  req.valid = true;
+  /* exp_time = clock_time + ttl */
+  req.ttl = rec.exp_time;
+
+  cache_obj_t *obj = cache_insert_base(cache, &req);
+#ifdef SUPPORT_TTL
+  if (rec.exp_time == 0 && obj->exp_time != 0) {
+    ttl_wheel_remove(cache->ttl_wheel, obj);
+    obj->exp_time = 0;
+  }
+#endif
+  obj->misc.freq = rec.freq;
+  if (md != NULL) *md = rec.md;
+
+  return obj;
+}
+
+static bool write_checkpoint(const cache_t *cache, int algo_idx, FILE *f) {
+  checkpoint_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = CHECKPOINT_MAGIC;
+  header.version = CHECKPOINT_VERSION;
+  header.obj_md_size = cache->obj_md_size;
+  strncpy(header.algo, checkpoint_algos[algo_idx].algo, CACHE_NAME_ARRAY_LEN - 1);
+  memcpy(header.cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+  memcpy(header.init_params, cache->init_params, CACHE_INIT_PARAMS_LEN);
+  header.cache_size = cache->cache_size;
+  header.default_ttl = cache->default_ttl;
+  header.hashpower = cache->hashtable->hashpower;
+  header.n_req = cache->n_req;
+  header.n_obj = cache->get_n_obj(cache);
+  header.occupied_byte = cache->get_occupied_byte(cache);
+#ifdef SUPPORT_TTL
+  header.n_expired_obj = cache->n_expired_obj;
+  header.n_expired_byte = cache->n_expired_byte;
+#endif
+  memcpy(header.log_eviction_age_cnt, cache->log_eviction_age_cnt, sizeof(header.log_eviction_age_cnt));
+
+  uint64_t end_magic = CHECKPOINT_MAGIC;
+  return checkpoint_write(f, &header, sizeof(header)) && cache->serialize(cache, f) &&
+         checkpoint_write(f, &end_magic, sizeof(end_magic));
+}
+
+bool cache_checkpoint(const cache_t *cache, const char *path) {
+  if (!cache_support_checkpoint(cache)) {
+    WARN("%s does not support checkpoints\n", cache->cache_name);
+    return false;
+  }
+
+  size_t path_len = strlen(path);
+  char *tmp_path = malloc(path_len + 5);
+  memcpy(tmp_path, path, path_len);
+  memcpy(tmp_path + path_len, ".tmp", 5);
+
+  FILE *f = fopen(tmp_path, "wb");
+  if (f == NULL) {
+    WARN("cannot open %s to write the checkpoint\n", tmp_path);
+    free(tmp_path);
+    return false;
+  }
+  setvbuf(f, NULL, _IOFBF, 1 << 20);
+
+  bool ok = write_checkpoint(cache, find_checkpoint_algo(cache->cache_init), f);
+  ok = fclose(f) == 0 && ok;
+  if (ok && rename(tmp_path, path) != 0) {
+    ok = false;
+  }
+  if (!ok) {
+    WARN("failed to write the checkpoint of %s to %s\n", cache->cache_name, path);
+    remove(tmp_path);
+  }
+
+  free(tmp_path);
+  return ok;
+}
+
+/**
+ * @brief create the cache from the checkpoint in f
+ *
+ * @param path used in the warnings
+ * @param cache_specific_params if not NULL, the cache is created with these
+ * parameters instead of the saved ones and keeps its own name
+ */
+static cache_t *read_checkpoint(FILE *f, const char *path, const char *cache_specific_params) {
+  checkpoint_header_t header;
+  if (!checkpoint_read(f, &header, sizeof(header)) || header.magic != CHECKPOINT_MAGIC) {
+    WARN("%s is not a cache checkpoint\n", path);
+    return NULL;
+  }
+  if (header.version != CHECKPOINT_VERSION) {
+    WARN("%s has checkpoint version %d, expect %d\n", path, header.version, CHECKPOINT_VERSION);
+    return NULL;
+  }
+
+  header.algo[CACHE_NAME_ARRAY_LEN - 1] = '\0';
+  header.cache_name[CACHE_NAME_ARRAY_LEN - 1] = '\0';
+  header.init_params[CACHE_INIT_PARAMS_LEN - 1] = '\0';
+  int algo_idx = -1;
+  for (int i = 0; i < N_CHECKPOINT_ALGO; i++) {
+    if (strcmp(checkpoint_algos[i].algo, header.algo) == 0) algo_idx = i;
+  }
+  if (algo_idx < 0) {
+    WARN("%s: unknown algorithm %s\n", path, header.algo);
+    return NULL;
+  }
+
+  common_cache_params_t cc_params = {
+      .cache_size = header.cache_size,
+      .default_ttl = header.default_ttl,
+      .hashpower = header.hashpower,
+      .consider_obj_metadata = header.obj_md_size != 0,
+  };
+  bool same_params = cache_specific_params == NULL;
+  if (same_params && header.init_params[0] != '\0') {
+    cache_specific_params = header.init_params;
+  }
+  cache_t *cache = checkpoint_algos[algo_idx].init(cc_params, cache_specific_params);
+  if (cache->deserialize == NULL || cache->obj_md_size != header.obj_md_size) {
+    WARN("%s: cannot restore %s with parameters \"%s\"\n", path, header.algo,
+         cache_specific_params == NULL ? "" : cache_specific_params);
+    cache->cache_free(cache);
+    return NULL;
+  }
+
+  uint64_t end_magic = 0;
+  if (!cache->deserialize(cache, f) || !checkpoint_read(f, &end_magic, sizeof(end_magic)) ||
+      end_magic != CHECKPOINT_MAGIC || cache->get_n_obj(cache) != header.n_obj ||
+      cache->get_occupied_byte(cache) != header.occupied_byte) {
+    WARN("%s: the checkpoint of %s is truncated or corrupted\n", path, header.cache_name);
+    cache->cache_free(cache);
+    return NULL;
+  }
+
+  if (same_params) {
+    memcpy(cache->cache_name, header.cache_name, CACHE_NAME_ARRAY_LEN);
+  }
+  cache->n_req = header.n_req;
+#ifdef SUPPORT_TTL
+  cache->n_expired_obj = header.n_expired_obj;
+  cache->n_expired_byte = header.n_expired_byte;
+#endif
+  memcpy(cache->log_eviction_age_cnt, header.log_eviction_age_cnt, sizeof(header.log_eviction_age_cnt));
+
+  return cache;
+}
+
+cache_t *cache_restore(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    WARN("cannot open checkpoint %s\n", path);
+    return NULL;
+  }
+  setvbuf(f, NULL, _IOFBF, 1 << 20);
+
+  cache_t *cache = read_checkpoint(f, path, NULL);
+  fclose(f);
+  return cache;
+}
+
+cache_t *deep_clone_cache(const cache_t *cache, const char *cache_specific_params) {
+  if (!cache_support_checkpoint(cache)) {
+    WARN("%s does not support checkpoints and cannot be deep cloned\n", cache->cache_name);
+    return NULL;
+  }
+
+  char *buf = NULL;
+  size_t buf_size = 0;
+  FILE *f = open_memstream(&buf, &buf_size);
+  if (f == NULL) {
+    WARN("cannot open a memory stream to clone %s\n", cache->cache_name);
+    return NULL;
+  }
+  bool ok = write_checkpoint(cache, find_checkpoint_algo(cache->cache_init), f);
+  ok = fclose(f) == 0 && ok;
+
+  cache_t *new_cache = NULL;
+  if (ok) {
+    f = fmemopen(buf, buf_size, "rb");
+    if (f != NULL) {
+      new_cache = read_checkpoint(f, cache->cache_name, cache_specific_params);
+      fclose(f);
+    }
+  }
+  if (new_cache == NULL) {
+    WARN("failed to deep clone %s\n", cache->cache_name);
+  }
+
+  free(buf);
+  return new_cache;
+}
+
+#ifdef __cplusplus
+}
+#endif
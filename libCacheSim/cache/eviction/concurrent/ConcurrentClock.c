@@ -0,0 +1,99 @@
+//
+//  ConcurrentClock.c
+//  libCacheSim
+//
+//  Clock with one visited bit, the entries form the ring, a hit sets the bit
+//  without a lock, and a miss takes the eviction lock, moves the hand past the
+//  visited entries and puts the new object in the first entry that is not
+//  visited, which is behind the hand
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../../include/libCacheSim/concurrentCache.h"
+#include "concurrentIndex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  concurrent_index_t index;
+  spin_lock_t lock;
+  uint8_t *visited;
+  int64_t hand;
+  int64_t n_obj;
+} concurrent_Clock_params_t;
+
+static bool concurrent_Clock_get(concurrent_cache_t *cache, uint64_t key) {
+  concurrent_Clock_params_t *params = cache->eviction_params;
+  uint64_t hv = concurrent_hash(key);
+
+  int32_t entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    /* read before writing so that hits on a visited object do not invalidate
+     * the cache line in the other cores */
+    if (!__atomic_load_n(&params->visited[entry], __ATOMIC_RELAXED)) {
+      __atomic_store_n(&params->visited[entry], 1, __ATOMIC_RELAXED);
+    }
+    return true;
+  }
+
+  spin_lock(&params->lock);
+  entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    spin_unlock(&params->lock);
+    __atomic_store_n(&params->visited[entry], 1, __ATOMIC_RELAXED);
+    return true;
+  }
+
+  if (params->n_obj < cache->cache_size) {
+    entry = (int32_t)params->n_obj;
+    __atomic_store_n(&params->n_obj, params->n_obj + 1, __ATOMIC_RELAXED);
+  } else {
+    while (__atomic_load_n(&params->visited[params->hand], __ATOMIC_RELAXED)) {
+      __atomic_store_n(&params->visited[params->hand], 0, __ATOMIC_RELAXED);
+      params->hand = params->hand + 1 == cache->cache_size ? 0 : params->hand + 1;
+    }
+    entry = (int32_t)params->hand;
+    params->hand = params->hand + 1 == cache->cache_size ? 0 : params->hand + 1;
+    concurrent_index_remove(&params->index, entry);
+  }
+  __atomic_store_n(&params->visited[entry], 0, __ATOMIC_RELAXED);
+  concurrent_index_insert(&params->index, entry, key, hv);
+  spin_unlock(&params->lock);
+  return false;
+}
+
+static int64_t concurrent_Clock_get_n_obj(const concurrent_cache_t *cache) {
+  const concurrent_Clock_params_t *params = cache->eviction_params;
+  return __atomic_load_n(&params->n_obj, __ATOMIC_RELAXED);
+}
+
+static void concurrent_Clock_free(concurrent_cache_t *cache) {
+  concurrent_Clock_params_t *params = cache->eviction_params;
+  concurrent_index_free(&params->index);
+  free(params->visited);
+  free(params);
+  free(cache);
+}
+
+concurrent_cache_t *concurrent_Clock_init(int64_t cache_size) {
+  concurrent_cache_t *cache = calloc(1, sizeof(concurrent_cache_t));
+  cache->get = concurrent_Clock_get;
+  cache->get_n_obj = concurrent_Clock_get_n_obj;
+  cache->cache_free = concurrent_Clock_free;
+  cache->cache_size = cache_size;
+  strncpy(cache->cache_name, "Clock-concurrent", CACHE_NAME_ARRAY_LEN - 1);
+
+  concurrent_Clock_params_t *params = calloc(1, sizeof(concurrent_Clock_params_t));
+  concurrent_index_init(&params->index, cache_size);
+  params->visited = calloc(cache_size, sizeof(uint8_t));
+  cache->eviction_params = params;
+  return cache;
+}
+
+#ifdef __cplusplus
+}
+#endif
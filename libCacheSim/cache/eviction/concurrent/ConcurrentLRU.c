@@ -0,0 +1,116 @@
+//
+//  ConcurrentLRU.c
+//  libCacheSim
+//
+//  LRU behind one mutex, the baseline of the concurrent caches, every request
+//  takes the mutex because a hit moves the object to the head of the list
+//
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../../include/libCacheSim/concurrentCache.h"
+#include "concurrentIndex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  concurrent_index_t index;
+  GMutex lock;
+  /* the list of the entries, head is the most recently used */
+  int32_t *prev;
+  int32_t *next;
+  int32_t head;
+  int32_t tail;
+  int64_t n_obj;
+} concurrent_LRU_params_t;
+
+static void list_remove(concurrent_LRU_params_t *params, int32_t entry) {
+  int32_t prev = params->prev[entry], next = params->next[entry];
+  if (prev >= 0) {
+    params->next[prev] = next;
+  } else {
+    params->head = next;
+  }
+  if (next >= 0) {
+    params->prev[next] = prev;
+  } else {
+    params->tail = prev;
+  }
+}
+
+static void list_prepend(concurrent_LRU_params_t *params, int32_t entry) {
+  params->prev[entry] = -1;
+  params->next[entry] = params->head;
+  if (params->head >= 0) params->prev[params->head] = entry;
+  params->head = entry;
+  if (params->tail < 0) params->tail = entry;
+}
+
+static bool concurrent_LRU_get(concurrent_cache_t *cache, uint64_t key) {
+  concurrent_LRU_params_t *params = cache->eviction_params;
+  uint64_t hv = concurrent_hash(key);
+
+  g_mutex_lock(&params->lock);
+  int32_t entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    if (entry != params->head) {
+      list_remove(params, entry);
+      list_prepend(params, entry);
+    }
+    g_mutex_unlock(&params->lock);
+    return true;
+  }
+
+  if (params->n_obj < cache->cache_size) {
+    entry = (int32_t)params->n_obj++;
+  } else {
+    entry = params->tail;
+    list_remove(params, entry);
+    concurrent_index_remove(&params->index, entry);
+  }
+  concurrent_index_insert(&params->index, entry, key, hv);
+  list_prepend(params, entry);
+  g_mutex_unlock(&params->lock);
+  return false;
+}
+
+static int64_t concurrent_LRU_get_n_obj(const concurrent_cache_t *cache) {
+  const concurrent_LRU_params_t *params = cache->eviction_params;
+  return __atomic_load_n(&params->n_obj, __ATOMIC_RELAXED);
+}
+
+static void concurrent_LRU_free(concurrent_cache_t *cache) {
+  concurrent_LRU_params_t *params = cache->eviction_params;
+  concurrent_index_free(&params->index);
+  g_mutex_clear(&params->lock);
+  free(params->prev);
+  free(params->next);
+  free(params);
+  free(cache);
+}
+
+concurrent_cache_t *concurrent_LRU_init(int64_t cache_size) {
+  concurrent_cache_t *cache = calloc(1, sizeof(concurrent_cache_t));
+  cache->get = concurrent_LRU_get;
+  cache->get_n_obj = concurrent_LRU_get_n_obj;
+  cache->cache_free = concurrent_LRU_free;
+  cache->cache_size = cache_size;
+  strncpy(cache->cache_name, "LRU-concurrent", CACHE_NAME_ARRAY_LEN - 1);
+
+  concurrent_LRU_params_t *params = calloc(1, sizeof(concurrent_LRU_params_t));
+  concurrent_index_init(&params->index, cache_size);
+  g_mutex_init(&params->lock);
+  params->prev = malloc(sizeof(int32_t) * cache_size);
+  params->next = malloc(sizeof(int32_t) * cache_size);
+  params->head = params->tail = -1;
+  cache->eviction_params = params;
+  return cache;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,204 @@
+//
+//  ConcurrentS3FIFO.c
+//  libCacheSim
+//
+//  S3FIFO with a small FIFO, a main FIFO (2-bit Clock) and a ghost FIFO, the
+//  same policy as S3FIFO.c with the default move-to-main threshold of 2
+//
+//  a hit increments the 2-bit frequency of the object without a lock, and a
+//  miss takes the eviction lock, evicts from the small or the main FIFO and
+//  inserts the new object into the small FIFO, or into the main FIFO if it is
+//  in the ghost. The FIFOs are rings of entry ids and the ghost is a
+//  ghost_history_t, both are only used under the lock
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../../dataStructure/ghostHistory.h"
+#include "../../../include/libCacheSim/concurrentCache.h"
+#include "concurrentIndex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define S3FIFO_MAX_FREQ 3
+#define S3FIFO_MOVE_TO_MAIN_THRESHOLD 2
+
+typedef struct {
+  int32_t *entries;
+  int64_t capacity;
+  int64_t head;
+  int64_t n_entry;
+} entry_fifo_t;
+
+typedef struct {
+  concurrent_index_t index;
+  spin_lock_t lock;
+  uint8_t *freq;
+
+  entry_fifo_t small;
+  entry_fifo_t main;
+  int64_t small_size;
+  int64_t main_size;
+
+  ghost_history_t *ghost;
+  int64_t ghost_size;
+
+  /* the entries that do not hold an object */
+  int32_t *free_entries;
+  int64_t n_free;
+  bool has_evicted;
+} concurrent_S3FIFO_params_t;
+
+static inline void fifo_push(entry_fifo_t *fifo, int32_t entry) {
+  int64_t pos = fifo->head + fifo->n_entry;
+  fifo->entries[pos >= fifo->capacity ? pos - fifo->capacity : pos] = entry;
+  fifo->n_entry += 1;
+}
+
+static inline int32_t fifo_pop(entry_fifo_t *fifo) {
+  int32_t entry = fifo->entries[fifo->head];
+  fifo->head = fifo->head + 1 == fifo->capacity ? 0 : fifo->head + 1;
+  fifo->n_entry -= 1;
+  return entry;
+}
+
+static void free_entry(concurrent_S3FIFO_params_t *params, int32_t entry) {
+  concurrent_index_remove(&params->index, entry);
+  params->free_entries[params->n_free++] = entry;
+}
+
+static void evict_small(concurrent_S3FIFO_params_t *params) {
+  while (params->small.n_entry > 0) {
+    int32_t entry = fifo_pop(&params->small);
+    if (__atomic_load_n(&params->freq[entry], __ATOMIC_RELAXED) >= S3FIFO_MOVE_TO_MAIN_THRESHOLD) {
+      __atomic_store_n(&params->freq[entry], 0, __ATOMIC_RELAXED);
+      fifo_push(&params->main, entry);
+    } else {
+      if (params->ghost_size > 0) {
+        if (params->ghost->n_entry >= params->ghost_size) {
+          ghost_history_pop_oldest(params->ghost, NULL, NULL);
+        }
+        ghost_history_insert(params->ghost, params->index.keys[entry], 1, 0);
+      }
+      free_entry(params, entry);
+      return;
+    }
+  }
+}
+
+static void evict_main(concurrent_S3FIFO_params_t *params) {
+  while (params->main.n_entry > 0) {
+    int32_t entry = fifo_pop(&params->main);
+    uint8_t freq = __atomic_load_n(&params->freq[entry], __ATOMIC_RELAXED);
+    if (freq >= 1) {
+      __atomic_store_n(&params->freq[entry], freq - 1, __ATOMIC_RELAXED);
+      fifo_push(&params->main, entry);
+    } else {
+      free_entry(params, entry);
+      return;
+    }
+  }
+}
+
+static bool concurrent_S3FIFO_get(concurrent_cache_t *cache, uint64_t key) {
+  concurrent_S3FIFO_params_t *params = cache->eviction_params;
+  uint64_t hv = concurrent_hash(key);
+
+  int32_t entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    uint8_t freq = __atomic_load_n(&params->freq[entry], __ATOMIC_RELAXED);
+    if (freq < S3FIFO_MAX_FREQ) {
+      __atomic_store_n(&params->freq[entry], freq + 1, __ATOMIC_RELAXED);
+    }
+    return true;
+  }
+
+  spin_lock(&params->lock);
+  entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    uint8_t freq = __atomic_load_n(&params->freq[entry], __ATOMIC_RELAXED);
+    if (freq < S3FIFO_MAX_FREQ) {
+      __atomic_store_n(&params->freq[entry], freq + 1, __ATOMIC_RELAXED);
+    }
+    spin_unlock(&params->lock);
+    return true;
+  }
+
+  bool hit_on_ghost = params->ghost_size > 0 && ghost_history_remove(params->ghost, key, NULL, NULL);
+  while (params->n_free == 0) {
+    params->has_evicted = true;
+    if (params->main.n_entry > params->main_size || params->small.n_entry == 0) {
+      evict_main(params);
+    } else {
+      evict_small(params);
+    }
+  }
+
+  entry = params->free_entries[--params->n_free];
+  __atomic_store_n(&params->freq[entry], 0, __ATOMIC_RELAXED);
+  if (hit_on_ghost || (!params->has_evicted && params->small.n_entry >= params->small_size)) {
+    fifo_push(&params->main, entry);
+  } else {
+    fifo_push(&params->small, entry);
+  }
+  concurrent_index_insert(&params->index, entry, key, hv);
+  spin_unlock(&params->lock);
+  return false;
+}
+
+static int64_t concurrent_S3FIFO_get_n_obj(const concurrent_cache_t *cache) {
+  const concurrent_S3FIFO_params_t *params = cache->eviction_params;
+  return cache->cache_size - __atomic_load_n(&params->n_free, __ATOMIC_RELAXED);
+}
+
+static void concurrent_S3FIFO_free(concurrent_cache_t *cache) {
+  concurrent_S3FIFO_params_t *params = cache->eviction_params;
+  concurrent_index_free(&params->index);
+  ghost_history_free(params->ghost);
+  free(params->freq);
+  free(params->small.entries);
+  free(params->main.entries);
+  free(params->free_entries);
+  free(params);
+  free(cache);
+}
+
+concurrent_cache_t *concurrent_S3FIFO_init(int64_t cache_size, double small_size_ratio) {
+  if (small_size_ratio <= 0 || small_size_ratio >= 1) {
+    ERROR("S3FIFO small-size-ratio must be in (0, 1), got %lf\n", small_size_ratio);
+  }
+  concurrent_cache_t *cache = calloc(1, sizeof(concurrent_cache_t));
+  cache->get = concurrent_S3FIFO_get;
+  cache->get_n_obj = concurrent_S3FIFO_get_n_obj;
+  cache->cache_free = concurrent_S3FIFO_free;
+  cache->cache_size = cache_size;
+  snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "S3FIFO-%.4lf-concurrent", small_size_ratio);
+
+  concurrent_S3FIFO_params_t *params = calloc(1, sizeof(concurrent_S3FIFO_params_t));
+  concurrent_index_init(&params->index, cache_size);
+  params->freq = calloc(cache_size, sizeof(uint8_t));
+  /* every object can be in either FIFO */
+  params->small.entries = malloc(sizeof(int32_t) * cache_size);
+  params->small.capacity = cache_size;
+  params->main.entries = malloc(sizeof(int32_t) * cache_size);
+  params->main.capacity = cache_size;
+  params->small_size = MAX((int64_t)((double)cache_size * small_size_ratio), 1);
+  params->main_size = cache_size - params->small_size;
+  params->ghost_size = params->main_size;
+  params->ghost = ghost_history_init(MAX(params->ghost_size, 1));
+
+  params->free_entries = malloc(sizeof(int32_t) * cache_size);
+  for (int64_t i = 0; i < cache_size; i++) {
+    params->free_entries[i] = (int32_t)(cache_size - 1 - i);
+  }
+  params->n_free = cache_size;
+  cache->eviction_params = params;
+  return cache;
+}
+
+#ifdef __cplusplus
+}
+#endif
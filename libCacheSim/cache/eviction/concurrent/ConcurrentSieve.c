@@ -0,0 +1,134 @@
+//
+//  ConcurrentSieve.c
+//  libCacheSim
+//
+//  Sieve with one visited bit, a hit sets the bit without a lock, and a miss
+//  takes the eviction lock, moves the hand from the tail towards the head past
+//  the visited objects, removes the first object that is not visited and
+//  inserts the new object at the head. The objects that survive the hand stay
+//  where they are, so the list is only changed by misses
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../../include/libCacheSim/concurrentCache.h"
+#include "concurrentIndex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  concurrent_index_t index;
+  spin_lock_t lock;
+  uint8_t *visited;
+  /* the list of the entries from the newest (head) to the oldest (tail) */
+  int32_t *prev;
+  int32_t *next;
+  int32_t head;
+  int32_t tail;
+  int32_t hand;
+  int64_t n_obj;
+} concurrent_Sieve_params_t;
+
+static int32_t evict(concurrent_Sieve_params_t *params) {
+  int32_t entry = params->hand >= 0 ? params->hand : params->tail;
+  while (__atomic_load_n(&params->visited[entry], __ATOMIC_RELAXED)) {
+    __atomic_store_n(&params->visited[entry], 0, __ATOMIC_RELAXED);
+    entry = params->prev[entry] >= 0 ? params->prev[entry] : params->tail;
+  }
+  params->hand = params->prev[entry];
+
+  int32_t prev = params->prev[entry], next = params->next[entry];
+  if (prev >= 0) {
+    params->next[prev] = next;
+  } else {
+    params->head = next;
+  }
+  if (next >= 0) {
+    params->prev[next] = prev;
+  } else {
+    params->tail = prev;
+  }
+  concurrent_index_remove(&params->index, entry);
+  return entry;
+}
+
+static bool concurrent_Sieve_get(concurrent_cache_t *cache, uint64_t key) {
+  concurrent_Sieve_params_t *params = cache->eviction_params;
+  uint64_t hv = concurrent_hash(key);
+
+  int32_t entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    if (!__atomic_load_n(&params->visited[entry], __ATOMIC_RELAXED)) {
+      __atomic_store_n(&params->visited[entry], 1, __ATOMIC_RELAXED);
+    }
+    return true;
+  }
+
+  spin_lock(&params->lock);
+  entry = concurrent_index_find(&params->index, key, hv);
+  if (entry >= 0) {
+    spin_unlock(&params->lock);
+    __atomic_store_n(&params->visited[entry], 1, __ATOMIC_RELAXED);
+    return true;
+  }
+
+  if (params->n_obj < cache->cache_size) {
+    entry = (int32_t)params->n_obj;
+    __atomic_store_n(&params->n_obj, params->n_obj + 1, __ATOMIC_RELAXED);
+  } else {
+    entry = evict(params);
+  }
+  __atomic_store_n(&params->visited[entry], 0, __ATOMIC_RELAXED);
+  params->prev[entry] = -1;
+  params->next[entry] = params->head;
+  if (params->head >= 0) {
+    params->prev[params->head] = entry;
+  }
+  params->head = entry;
+  if (params->tail < 0) {
+    params->tail = entry;
+  }
+  concurrent_index_insert(&params->index, entry, key, hv);
+  spin_unlock(&params->lock);
+  return false;
+}
+
+static int64_t concurrent_Sieve_get_n_obj(const concurrent_cache_t *cache) {
+  const concurrent_Sieve_params_t *params = cache->eviction_params;
+  return __atomic_load_n(&params->n_obj, __ATOMIC_RELAXED);
+}
+
+static void concurrent_Sieve_free(concurrent_cache_t *cache) {
+  concurrent_Sieve_params_t *params = cache->eviction_params;
+  concurrent_index_free(&params->index);
+  free(params->visited);
+  free(params->prev);
+  free(params->next);
+  free(params);
+  free(cache);
+}
+
+concurrent_cache_t *concurrent_Sieve_init(int64_t cache_size) {
+  concurrent_cache_t *cache = calloc(1, sizeof(concurrent_cache_t));
+  cache->get = concurrent_Sieve_get;
+  cache->get_n_obj = concurrent_Sieve_get_n_obj;
+  cache->cache_free = concurrent_Sieve_free;
+  cache->cache_size = cache_size;
+  strncpy(cache->cache_name, "Sieve-concurrent", CACHE_NAME_ARRAY_LEN - 1);
+
+  concurrent_Sieve_params_t *params = calloc(1, sizeof(concurrent_Sieve_params_t));
+  concurrent_index_init(&params->index, cache_size);
+  params->visited = calloc(cache_size, sizeof(uint8_t));
+  params->prev = malloc(sizeof(int32_t) * cache_size);
+  params->next = malloc(sizeof(int32_t) * cache_size);
+  params->head = params->tail = params->hand = -1;
+  cache->eviction_params = params;
+  return cache;
+}
+
+#ifdef __cplusplus
+}
+#endif
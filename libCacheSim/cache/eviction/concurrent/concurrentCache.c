@@ -0,0 +1,31 @@
+//
+//  concurrentCache.c
+//  libCacheSim
+//
+//  create a concurrent cache by name, see concurrentCache.h
+//
+
+#include "../../../include/libCacheSim/concurrentCache.h"
+
+#include <strings.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+concurrent_cache_t *create_concurrent_cache(const char *algo, int64_t cache_size) {
+  if (strcasecmp(algo, "lru") == 0) {
+    return concurrent_LRU_init(cache_size);
+  } else if (strcasecmp(algo, "clock") == 0) {
+    return concurrent_Clock_init(cache_size);
+  } else if (strcasecmp(algo, "sieve") == 0) {
+    return concurrent_Sieve_init(cache_size);
+  } else if (strcasecmp(algo, "s3fifo") == 0) {
+    return concurrent_S3FIFO_init(cache_size, 0.1);
+  }
+  return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
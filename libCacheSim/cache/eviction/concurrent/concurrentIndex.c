@@ -0,0 +1,67 @@
+//
+//  concurrentIndex.c
+//  libCacheSim
+//
+//  see concurrentIndex.h
+//
+
+#include "concurrentIndex.h"
+
+#include <stdlib.h>
+
+#include "../../../include/libCacheSim/logging.h"
+#include "../../../utils/include/mymath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void concurrent_index_init(concurrent_index_t *index, int64_t n_entry) {
+  if (n_entry <= 0 || n_entry >= UINT32_MAX / 2) {
+    ERROR("concurrent index cannot hold %lld entries\n", (long long)n_entry);
+  }
+  uint64_t n_bucket = next_power_of_2_v2((uint64_t)n_entry * 2);
+  index->buckets = calloc(n_bucket, sizeof(uint32_t));
+  index->keys = calloc(n_entry, sizeof(uint64_t));
+  if (index->buckets == NULL || index->keys == NULL) {
+    ERROR("cannot allocate a concurrent index of %lld entries\n", (long long)n_entry);
+  }
+  index->mask = n_bucket - 1;
+  index->n_entry = n_entry;
+}
+
+void concurrent_index_free(concurrent_index_t *index) {
+  free(index->buckets);
+  free(index->keys);
+}
+
+void concurrent_index_insert(concurrent_index_t *index, int32_t entry, uint64_t key, uint64_t hv) {
+  /* the key is visible before the bucket points to the entry */
+  __atomic_store_n(&index->keys[entry], key, __ATOMIC_RELAXED);
+  uint64_t pos = hv & index->mask;
+  while (index->buckets[pos] != 0) {
+    pos = (pos + 1) & index->mask;
+  }
+  __atomic_store_n(&index->buckets[pos], (uint32_t)entry + 1, __ATOMIC_RELEASE);
+}
+
+void concurrent_index_remove(concurrent_index_t *index, int32_t entry) {
+  uint64_t hole = concurrent_hash(index->keys[entry]) & index->mask;
+  while (index->buckets[hole] != (uint32_t)entry + 1) {
+    hole = (hole + 1) & index->mask;
+  }
+
+  /* move back the buckets whose home is not between the hole and them */
+  for (uint64_t pos = (hole + 1) & index->mask; index->buckets[pos] != 0; pos = (pos + 1) & index->mask) {
+    uint64_t home = concurrent_hash(index->keys[index->buckets[pos] - 1]) & index->mask;
+    if (((pos - home) & index->mask) >= ((pos - hole) & index->mask)) {
+      __atomic_store_n(&index->buckets[hole], index->buckets[pos], __ATOMIC_RELEASE);
+      hole = pos;
+    }
+  }
+  __atomic_store_n(&index->buckets[hole], 0, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,92 @@
+//
+//  concurrentIndex.h
+//  libCacheSim
+//
+//  the hash index and the eviction lock shared by the concurrent caches
+//
+//  the objects live in a fixed array of entries, and the index maps a key to
+//  its entry with linear probing over buckets that hold the entry id plus one
+//  (zero is empty). Finding a key is lock-free, inserting and removing are
+//  done under the eviction lock, so there is one writer at a time. Removing
+//  shifts the following buckets back instead of leaving a tombstone, so a
+//  concurrent find may miss a key that is being moved, the caller then looks
+//  it up again under the lock
+//
+
+#pragma once
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../../../dataStructure/hash/hash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  /* entry id + 1 of each bucket, 0 is empty */
+  uint32_t *buckets;
+  uint64_t mask;
+  /* the key of each entry */
+  uint64_t *keys;
+  int64_t n_entry;
+} concurrent_index_t;
+
+static inline uint64_t concurrent_hash(uint64_t key) { return get_hash_value_int_64(&key); }
+
+/**
+ * @brief create an index of n_entry entries with at least twice as many
+ * buckets
+ */
+void concurrent_index_init(concurrent_index_t *index, int64_t n_entry);
+
+void concurrent_index_free(concurrent_index_t *index);
+
+/**
+ * @brief the entry of the key, -1 if not found, does not lock
+ */
+static inline int32_t concurrent_index_find(const concurrent_index_t *index, uint64_t key, uint64_t hv) {
+  for (uint64_t pos = hv & index->mask;; pos = (pos + 1) & index->mask) {
+    uint32_t bucket = __atomic_load_n(&index->buckets[pos], __ATOMIC_ACQUIRE);
+    if (bucket == 0) return -1;
+    if (__atomic_load_n(&index->keys[bucket - 1], __ATOMIC_RELAXED) == key) {
+      return (int32_t)(bucket - 1);
+    }
+  }
+}
+
+/**
+ * @brief add an entry with the key, the key must not be in the index, the
+ * caller holds the eviction lock
+ */
+void concurrent_index_insert(concurrent_index_t *index, int32_t entry, uint64_t key, uint64_t hv);
+
+/**
+ * @brief remove an entry from the index, the caller holds the eviction lock
+ */
+void concurrent_index_remove(concurrent_index_t *index, int32_t entry);
+
+/* a spin lock that yields the CPU when it cannot get the lock after a few
+ * tries, the eviction lock is held for a short time */
+typedef struct {
+  int locked;
+} spin_lock_t;
+
+static inline void spin_lock(spin_lock_t *lock) {
+  while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+    for (int i = 0; __atomic_load_n(&lock->locked, __ATOMIC_RELAXED); i++) {
+      if (i >= 64) {
+        sched_yield();
+        i = 0;
+      }
+    }
+  }
+}
+
+static inline void spin_unlock(spin_lock_t *lock) { __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE); }
+
+#ifdef __cplusplus
+}
+#endif
@@ -33,6 +33,7 @@ static cache_obj_t *GDSF_to_evict(cache_t *cache, const request_t *req);
 static void GDSF_evict(cache_t *cache, const request_t *req);
 
 static bool GDSF_remove(cache_t *cache, const obj_id_t obj_id);
+static void GDSF_parse_params(cache_t *cache, const char *cache_specific_params);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -50,7 +51,8 @@ static bool GDSF_remove(cache_t *cache, const obj_id_t obj_id);
  */
 cache_t *GDSF_init(const common_cache_params_t ccache_params, const char *cache_specific_params) {
   cache_t *cache = cache_struct_init("GDSF", ccache_params, cache_specific_params);
-  cache->eviction_params = reinterpret_cast<void *>(new eviction::GDSF);
+  auto *gdsf = new eviction::GDSF;
+  cache->eviction_params = reinterpret_cast<void *>(gdsf);
 
   cache->cache_init = GDSF_init;
   cache->cache_free = GDSF_free;
@@ -68,6 +70,14 @@ cache_t *GDSF_init(const common_cache_params_t ccache_params, const char *cache_
     cache->obj_md_size = 0;
   }
 
+  if (cache_specific_params != nullptr) {
+    GDSF_parse_params(cache, cache_specific_params);
+  }
+
+  if (gdsf->pq_type != eviction::pq_type_e::HEAP) {
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "GDSF-%s", eviction::pq_type_name(gdsf->pq_type));
+  }
+
   return cache;
 }
 
@@ -112,8 +122,7 @@ static bool GDSF_get(cache_t *cache, const request_t *req) {
     }
   }
 
-  DEBUG_ASSERT((int64_t) gdsf->pq.size() == cache->n_obj);
-  DEBUG_ASSERT((int64_t) gdsf->pq_map.size() == cache->n_obj);
+  DEBUG_ASSERT((int64_t)gdsf->size() == cache->n_obj);
 
   return hit;
 }
@@ -144,13 +153,8 @@ static cache_obj_t *GDSF_find(cache_t *cache, const request_t *req, const bool u
     /* misc frequency is updated in cache_find_base */
     // obj->misc.freq += 1;
 
-    auto node = gdsf->pq_map[obj];
-    gdsf->pq.erase(node);
-
     double pri = gdsf->pri_last_evict + (double)(obj->misc.freq) * 1.0e6 / obj->obj_size;
-    eviction::pq_node_type new_node = {obj, pri, cache->n_req};
-    gdsf->pq.insert(new_node);
-    gdsf->pq_map[obj] = new_node;
+    gdsf->update_obj(obj, pri, cache->n_req);
   }
 
   return obj;
@@ -169,22 +173,20 @@ static bool GDSF_can_insert(cache_t *cache, const request_t *req) {
   int64_t to_evict_size = req->obj_size - (cache->cache_size - cache->get_occupied_byte(cache));
   double pri = gdsf->pri_last_evict + 1.0e6 / req->obj_size;
   bool can_insert = true;
-  auto iter = gdsf->pq.begin();
 
   int n_evict = 0;
-  while (to_evict_size > 0) {
-    assert(iter != gdsf->pq.end());
-    assert(iter->obj->obj_id != req->obj_id);
+  gdsf->for_each_lowest([&](const eviction::pq_node_type &node) {
+    assert(node.obj->obj_id != req->obj_id);
     n_evict += 1;
 
-    if (iter->priority > pri) {
+    if (node.priority > pri) {
       // the incoming object will be evicted so not insert it
       can_insert = false;
-      break;
+      return false;
     }
-    to_evict_size -= iter->obj->obj_size;
-    iter++;
-  }
+    to_evict_size -= node.obj->obj_size;
+    return to_evict_size > 0;
+  });
 
   if (can_insert) {
     n_insert += 1;
@@ -226,10 +228,7 @@ static cache_obj_t *GDSF_insert(cache_t *cache, const request_t *req) {
   obj->misc.freq = 1;
 
   double pri = gdsf->pri_last_evict + 1.0e6 / obj->obj_size;
-  eviction::pq_node_type new_node = {obj, pri, cache->n_req};
-  auto r = gdsf->pq.insert(new_node);
-  DEBUG_ASSERT(r.second);
-  gdsf->pq_map[obj] = new_node;
+  gdsf->insert_obj(obj, pri, cache->n_req);
 
   return obj;
 }
@@ -266,7 +265,7 @@ static void GDSF_evict(cache_t *cache, const request_t *req) {
   cache_obj_t *obj = p.obj;
 
   gdsf->pri_last_evict = p.priority;
-  cache_remove_obj_base(cache, obj, true);
+  cache_evict_base(cache, obj, true);
 }
 
 static void GDSF_remove_obj(cache_t *cache, cache_obj_t *obj) {
@@ -292,6 +291,50 @@ static bool GDSF_remove(cache_t *cache, const obj_id_t obj_id) {
   return gdsf->remove(cache, obj_id);
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                  parameter set up functions                   ****
+// ****                                                               ****
+// ***********************************************************************
+static const char *GDSF_current_params(eviction::GDSF *gdsf) {
+  static __thread char params_str[128];
+  snprintf(params_str, 128, "pq-type=%s\n", eviction::pq_type_name(gdsf->pq_type));
+  return params_str;
+}
+
+static void GDSF_parse_params(cache_t *cache, const char *cache_specific_params) {
+  auto *gdsf = reinterpret_cast<eviction::GDSF *>(cache->eviction_params);
+  char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "pq-type") == 0) {
+      if (!eviction::parse_pq_type(value, &gdsf->pq_type)) {
+        ERROR("GDSF does not support pq-type %s, use heap, set or bucket\n", value);
+        exit(1);
+      }
+    } else if (strcasecmp(key, "print") == 0) {
+      printf("current parameters: %s\n", GDSF_current_params(gdsf));
+      exit(0);
+    } else {
+      ERROR("%s does not have parameter %s, example parameters %s\n", cache->cache_name, key,
+            GDSF_current_params(gdsf));
+      exit(1);
+    }
+  }
+  free(old_params_str);
+}
+
 #ifdef __cplusplus
 }
 #endif
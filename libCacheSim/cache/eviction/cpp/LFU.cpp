@@ -35,6 +35,7 @@ static cache_obj_t *LFUCpp_insert(cache_t *cache, const request_t *req);
 static cache_obj_t *LFUCpp_to_evict(cache_t *cache, const request_t *req);
 static void LFUCpp_evict(cache_t *cache, const request_t *req);
 static bool LFUCpp_remove(cache_t *cache, const obj_id_t obj_id);
+static void LFUCpp_parse_params(cache_t *cache, const char *cache_specific_params);
 
 // ***********************************************************************
 // ****                                                               ****
@@ -70,6 +71,14 @@ cache_t *LFUCpp_init(const common_cache_params_t ccache_params, const char *cach
     cache->obj_md_size = 0;
   }
 
+  if (cache_specific_params != nullptr) {
+    LFUCpp_parse_params(cache, cache_specific_params);
+  }
+
+  if (lfu->pq_type == eviction::pq_type_e::SET) {
+    snprintf(cache->cache_name, CACHE_NAME_ARRAY_LEN, "LFUCpp-set");
+  }
+
   return cache;
 }
 
@@ -125,12 +134,8 @@ static cache_obj_t *LFUCpp_find(cache_t *cache, const request_t *req, const bool
   auto *lfu = static_cast<eviction::LFUCpp *>(cache->eviction_params);
   cache_obj_t *obj = cache_find_base(cache, req, update_cache);
   if (obj != nullptr && update_cache) {
-    obj->lfu.freq++;
-    auto itr = lfu->pq_map[obj];
-    lfu->pq.erase(itr);
-    eviction::pq_node_type new_node = {obj, (double)obj->lfu.freq, cache->n_req};
-    lfu->pq.insert(new_node);
-    lfu->pq_map[obj] = new_node;
+    obj->rank.freq++;
+    lfu->update_obj(obj, (double)obj->rank.freq, cache->n_req);
   }
 
   return obj;
@@ -151,12 +156,10 @@ static cache_obj_t *LFUCpp_insert(cache_t *cache, const request_t *req) {
   auto *lfu = static_cast<eviction::LFUCpp *>(cache->eviction_params);
 
   cache_obj_t *obj = cache_insert_base(cache, req);
-  obj->lfu.freq = 1;
+  obj->rank.freq = 1;
 
-  eviction::pq_node_type new_node = {obj, 1.0, cache->n_req};
-  lfu->pq.insert(new_node);
-  lfu->pq_map[obj] = new_node;
-  DEBUG_ASSERT((int64_t) lfu->pq_map.size() == cache->n_obj);
+  lfu->insert_obj(obj, 1.0, cache->n_req);
+  DEBUG_ASSERT((int64_t)lfu->size() == cache->n_obj);
 
   return obj;
 }
@@ -192,7 +195,7 @@ static void LFUCpp_evict(cache_t *cache, const request_t *req) {
   eviction::pq_node_type p = lfu->pop_lowest_score();
   cache_obj_t *obj = p.obj;
 
-  cache_remove_obj_base(cache, obj, true);
+  cache_evict_base(cache, obj, true);
 }
 
 static void LFUCpp_remove_obj(cache_t *cache, cache_obj_t *obj) {
@@ -212,6 +215,51 @@ static bool LFUCpp_remove(cache_t *cache, const obj_id_t obj_id) {
   return true;
 }
 
+// ***********************************************************************
+// ****                                                               ****
+// ****                  parameter set up functions                   ****
+// ****                                                               ****
+// ***********************************************************************
+static const char *LFUCpp_current_params(eviction::LFUCpp *lfu) {
+  static __thread char params_str[128];
+  snprintf(params_str, 128, "pq-type=%s\n", lfu->pq_type == eviction::pq_type_e::HEAP ? "heap" : "set");
+  return params_str;
+}
+
+static void LFUCpp_parse_params(cache_t *cache, const char *cache_specific_params) {
+  auto *lfu = static_cast<eviction::LFUCpp *>(cache->eviction_params);
+  char *params_str = strdup(cache_specific_params);
+  char *old_params_str = params_str;
+
+  while (params_str != NULL && params_str[0] != '\0') {
+    /* different parameters are separated by comma,
+     * key and value are separated by = */
+    char *key = strsep((char **)&params_str, "=");
+    char *value = strsep((char **)&params_str, ",");
+
+    // skip the white space
+    while (params_str != NULL && *params_str == ' ') {
+      params_str++;
+    }
+
+    if (strcasecmp(key, "pq-type") == 0) {
+      /* the bucket queue shares the object metadata with obj->rank.freq */
+      if (!eviction::parse_pq_type(value, &lfu->pq_type) || lfu->pq_type == eviction::pq_type_e::BUCKET) {
+        ERROR("LFUCpp does not support pq-type %s, use heap or set\n", value);
+        exit(1);
+      }
+    } else if (strcasecmp(key, "print") == 0) {
+      printf("current parameters: %s\n", LFUCpp_current_params(lfu));
+      exit(0);
+    } else {
+      ERROR("%s does not have parameter %s, example parameters %s\n", cache->cache_name, key,
+            LFUCpp_current_params(lfu));
+      exit(1);
+    }
+  }
+  free(old_params_str);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,6 +12,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "../../../dataStructure/bucketQueue.h"
 #include "../../../dataStructure/hashtable/hashtable.h"
 #include "../../../include/libCacheSim/cache.h"
 #include "../../../include/libCacheSim/cacheObj.h"
@@ -52,13 +53,48 @@ struct pq_node_type {
   }
 };
 
+/* the data structure used to rank objects */
+enum class pq_type_e {
+  /* 4-ary implicit heap in a flat array, the position of an object in the
+   * heap is stored in obj->rank.heap_pos, each update is one sift in place */
+  HEAP,
+  /* std::set + std::unordered_map, two node allocations and a rebalance
+   * per update, kept as the reference implementation */
+  SET,
+  /* the exact bucket queue of dataStructure/bucketQueue.h, the priority must
+   * not be negative and is kept in obj->bucket_queue, which shares the memory
+   * of obj->rank, so it cannot be used by the algorithms that use rank.freq */
+  BUCKET,
+};
+
 class abstractRank {
-  /* ranking based eviction algorithm */
+  /* ranking based eviction algorithm
+   * both data structures order objects by (priority, last_request_vtime),
+   * so they produce the same eviction order */
 
  public:
   abstractRank() = default;
 
+  ~abstractRank() {
+    if (bq != nullptr) bucket_queue_free(bq);
+  }
+
+  inline size_t size() const {
+    if (pq_type == pq_type_e::BUCKET) {
+      return bq == nullptr ? 0 : (size_t)bq->n_obj;
+    }
+    return pq_type == pq_type_e::HEAP ? heap.size() : pq.size();
+  }
+
   inline pq_node_type peek_lowest_score() {
+    if (pq_type == pq_type_e::HEAP) {
+      return heap[0];
+    }
+    if (pq_type == pq_type_e::BUCKET) {
+      cache_obj_t *obj = bucket_queue_peek(bq);
+      return pq_node_type(obj, obj->bucket_queue.key, -1);
+    }
+
     auto p = pq.begin();
     pq_node_type p_copy(*p);
 
@@ -66,6 +102,16 @@ class abstractRank {
   }
 
   inline pq_node_type pop_lowest_score() {
+    if (pq_type == pq_type_e::HEAP) {
+      pq_node_type p_copy = heap[0];
+      heap_remove_at(0);
+      return p_copy;
+    }
+    if (pq_type == pq_type_e::BUCKET) {
+      cache_obj_t *obj = bucket_queue_pop(bq);
+      return pq_node_type(obj, obj->bucket_queue.key, -1);
+    }
+
     auto p = pq.begin();
     pq_node_type p_copy(*p);
     pq_map.erase(p->obj);
@@ -74,10 +120,62 @@ class abstractRank {
     return p_copy;
   }
 
+  /* add a new object to the ranking */
+  inline void insert_obj(cache_obj_t *obj, double priority, int64_t last_request_vtime) {
+    pq_node_type new_node(obj, priority, last_request_vtime);
+    if (pq_type == pq_type_e::HEAP) {
+      heap.push_back(new_node);
+      heap_sift_up(heap.size() - 1);
+      return;
+    }
+    if (pq_type == pq_type_e::BUCKET) {
+      if (bq == nullptr) bq = bucket_queue_init(false, true);
+      bucket_queue_insert(bq, obj, priority);
+      return;
+    }
+
+    auto r = pq.insert(new_node);
+    DEBUG_ASSERT(r.second);
+    pq_map[obj] = new_node;
+  }
+
+  /* change the priority of an object that is already ranked */
+  inline void update_obj(cache_obj_t *obj, double priority, int64_t last_request_vtime) {
+    pq_node_type new_node(obj, priority, last_request_vtime);
+    if (pq_type == pq_type_e::HEAP) {
+      size_t pos = obj->rank.heap_pos;
+      DEBUG_ASSERT(pos < heap.size() && heap[pos].obj == obj);
+      bool move_up = new_node < heap[pos];
+      heap[pos] = new_node;
+      if (move_up) {
+        heap_sift_up(pos);
+      } else {
+        heap_sift_down(pos);
+      }
+      return;
+    }
+    if (pq_type == pq_type_e::BUCKET) {
+      /* ordered after the objects with the same priority as in the heap */
+      bucket_queue_update(bq, obj, priority);
+      return;
+    }
+
+    auto node = pq_map[obj];
+    pq.erase(node);
+    pq.insert(new_node);
+    pq_map[obj] = new_node;
+  }
+
   inline void remove_obj(cache_t *cache, cache_obj_t *obj) {
-    auto pq_node = pq_map[obj];
-    pq.erase(pq_node);
-    pq_map.erase(obj);
+    if (pq_type == pq_type_e::HEAP) {
+      heap_remove_at(obj->rank.heap_pos);
+    } else if (pq_type == pq_type_e::BUCKET) {
+      bucket_queue_remove(bq, obj);
+    } else {
+      auto pq_node = pq_map[obj];
+      pq.erase(pq_node);
+      pq_map.erase(obj);
+    }
     cache_remove_obj_base(cache, obj, true);
   }
 
@@ -91,7 +189,52 @@ class abstractRank {
     return true;
   }
 
+  /**
+   * visit the objects from the lowest score in order until func returns false,
+   * the heap is traversed best-first, so visiting k objects costs O(k log k)
+   */
+  template <typename F>
+  void for_each_lowest(F func) {
+    if (pq_type == pq_type_e::SET) {
+      for (auto &p : pq) {
+        if (!func(p)) return;
+      }
+      return;
+    }
+    if (pq_type == pq_type_e::BUCKET) {
+      if (bq == nullptr) return;
+      bucket_queue_for_each(
+          bq,
+          [](cache_obj_t *obj, void *user_data) -> bool {
+            return (*static_cast<F *>(user_data))(pq_node_type(obj, obj->bucket_queue.key, -1));
+          },
+          &func);
+      return;
+    }
+
+    auto cmp = [this](size_t a, size_t b) { return heap[b] < heap[a]; };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(cmp)> frontier(cmp);
+    if (!heap.empty()) frontier.push(0);
+    while (!frontier.empty()) {
+      size_t pos = frontier.top();
+      frontier.pop();
+      if (!func(heap[pos])) return;
+      for (size_t c = pos * HEAP_ARITY + 1; c <= pos * HEAP_ARITY + HEAP_ARITY && c < heap.size(); c++) {
+        frontier.push(c);
+      }
+    }
+  }
+
   void print_keys() {
+    if (pq_type == pq_type_e::HEAP) {
+      printf("heap size %ld\n", heap.size());
+      printf("============= heap =============\n");
+      for (auto &p : heap) {
+        p.print();
+      }
+      return;
+    }
+
     printf("pq size %ld, pq_map size %ld\n", pq.size(), pq_map.size());
     printf("============= pq =============\n");
     for (auto &p : pq) {
@@ -104,9 +247,86 @@ class abstractRank {
     }
   }
 
+  pq_type_e pq_type = pq_type_e::HEAP;
+
+  std::vector<pq_node_type> heap{};
+
   std::set<pq_node_type> pq{};
   std::unordered_map<cache_obj_t *, pq_node_type> pq_map;
 
+  bucket_queue_t *bq = nullptr;
+
  private:
+  static constexpr size_t HEAP_ARITY = 4;
+
+  inline void heap_place(size_t pos, const pq_node_type &node) {
+    heap[pos] = node;
+    node.obj->rank.heap_pos = (int32_t)pos;
+  }
+
+  inline void heap_sift_up(size_t pos) {
+    pq_node_type node = heap[pos];
+    while (pos > 0) {
+      size_t parent = (pos - 1) / HEAP_ARITY;
+      if (!(node < heap[parent])) break;
+      heap_place(pos, heap[parent]);
+      pos = parent;
+    }
+    heap_place(pos, node);
+  }
+
+  inline void heap_sift_down(size_t pos) {
+    pq_node_type node = heap[pos];
+    size_t n = heap.size();
+    while (true) {
+      size_t first_child = pos * HEAP_ARITY + 1;
+      if (first_child >= n) break;
+      size_t last_child = first_child + HEAP_ARITY < n ? first_child + HEAP_ARITY : n;
+      size_t min_child = first_child;
+      for (size_t c = first_child + 1; c < last_child; c++) {
+        if (heap[c] < heap[min_child]) min_child = c;
+      }
+      if (!(heap[min_child] < node)) break;
+      heap_place(pos, heap[min_child]);
+      pos = min_child;
+    }
+    heap_place(pos, node);
+  }
+
+  inline void heap_remove_at(size_t pos) {
+    DEBUG_ASSERT(pos < heap.size());
+    pq_node_type last = heap.back();
+    heap.pop_back();
+    if (pos == heap.size()) return;
+
+    bool move_up = last < heap[pos];
+    heap[pos] = last;
+    if (move_up) {
+      heap_sift_up(pos);
+    } else {
+      heap_sift_down(pos);
+    }
+  }
 };
+
+/**
+ * parse the pq-type parameter shared by the ranking based algorithms
+ * @return true if the value is valid
+ */
+static inline const char *pq_type_name(pq_type_e pq_type) {
+  return pq_type == pq_type_e::HEAP ? "heap" : (pq_type == pq_type_e::SET ? "set" : "bucket");
+}
+
+static inline bool parse_pq_type(const char *value, pq_type_e *pq_type) {
+  if (strcasecmp(value, "heap") == 0) {
+    *pq_type = pq_type_e::HEAP;
+  } else if (strcasecmp(value, "set") == 0) {
+    *pq_type = pq_type_e::SET;
+  } else if (strcasecmp(value, "bucket") == 0) {
+    *pq_type = pq_type_e::BUCKET;
+  } else {
+    return false;
+  }
+  return true;
+}
 }  // namespace eviction
@@ -91,6 +91,7 @@ cache_t *LP_ARC_init(const common_cache_params_t ccache_params,
   cache->evict = LP_ARC_evict;
   cache->remove = LP_ARC_remove;
   cache->to_evict = LP_ARC_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->can_insert = cache_can_insert_default;
   cache->get_occupied_byte = LP_ARC_get_occupied_byte;
   cache->get_n_obj = LP_ARC_get_n_obj;
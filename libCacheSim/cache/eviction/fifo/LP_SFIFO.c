@@ -69,6 +69,7 @@ cache_t *LP_SFIFO_init(const common_cache_params_t ccache_params,
   cache->evict = LP_SFIFO_evict;
   cache->remove = LP_SFIFO_remove;
   cache->to_evict = LP_SFIFO_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_occupied_byte = LP_SFIFO_get_occupied_byte;
   cache->get_n_obj = LP_SFIFO_get_n_obj;
   cache->can_insert = LP_SFIFO_can_insert;
@@ -81,6 +81,7 @@ cache_t *LP_TwoQ_init(const common_cache_params_t ccache_params,
   cache->evict = LP_TwoQ_evict;
   cache->remove = LP_TwoQ_remove;
   cache->to_evict = LP_TwoQ_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = LP_TwoQ_get_n_obj;
   cache->get_occupied_byte = LP_TwoQ_get_occupied_byte;
   cache->can_insert = LP_TwoQ_can_insert;
@@ -346,11 +346,11 @@ static bool SFIFO_remove(cache_t *cache, const obj_id_t obj_id) {
     return false;
   }
 
-  cache->occupied_byte -= (obj->obj_size + cache->obj_md_size);
-  cache->n_obj -= 1;
+  params->fifo_n_bytes[obj->SFIFO.fifo_id] -= obj->obj_size + cache->obj_md_size;
+  params->fifo_n_objs[obj->SFIFO.fifo_id]--;
   remove_obj_from_list(&(params->fifo_heads[obj->SFIFO.fifo_id]),
                        &(params->fifo_tails[obj->SFIFO.fifo_id]), obj);
-  hashtable_delete(cache->hashtable, obj);
+  cache_remove_obj_base(cache, obj, true);
 
   return true;
 }
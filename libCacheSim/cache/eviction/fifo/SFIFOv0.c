@@ -82,6 +82,7 @@ cache_t *SFIFOv0_init(const common_cache_params_t ccache_params,
   cache->evict = SFIFOv0_evict;
   cache->remove = SFIFOv0_remove;
   cache->to_evict = SFIFOv0_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->can_insert = SFIFOv0_can_insert;
   cache->get_occupied_byte = SFIFOv0_get_occupied_byte;
   cache->get_n_obj = SFIFOv0_get_n_obj;
@@ -87,6 +87,7 @@ cache_t *S3LRU_init(const common_cache_params_t ccache_params,
   cache->evict = S3LRU_evict;
   cache->remove = S3LRU_remove;
   cache->to_evict = S3LRU_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = S3LRU_get_n_obj;
   cache->get_occupied_byte = S3LRU_get_occupied_byte;
   cache->can_insert = S3LRU_can_insert;
@@ -74,6 +74,7 @@ cache_t *flashProb_init(const common_cache_params_t ccache_params,
   cache->evict = flashProb_evict;
   cache->remove = flashProb_remove;
   cache->to_evict = flashProb_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = flashProb_get_n_obj;
   cache->get_occupied_byte = flashProb_get_occupied_byte;
 
@@ -121,6 +121,7 @@ cache_t *S3FIFOdv2_init(const common_cache_params_t ccache_params,
   cache->evict = S3FIFOdv2_evict;
   cache->remove = S3FIFOdv2_remove;
   cache->to_evict = S3FIFOdv2_to_evict;
+  cache->evict_in_sub_cache = true;
   cache->get_n_obj = S3FIFOdv2_get_n_obj;
   cache->get_occupied_byte = S3FIFOdv2_get_occupied_byte;
   cache->can_insert = S3FIFOdv2_can_insert;
@@ -15,6 +15,7 @@
 #include <string.h>
 #include <strings.h>
 #include <sys/types.h>
+#include <time.h>
 
 #include "../../include/libCacheSim/prefetchAlgo.h"
 #include "../../include/libCacheSim/prefetchAlgo/Mithril.h"
@@ -40,18 +41,19 @@ static inline void _Mithril_record_entry(cache_t *Mithril,
                                          const request_t *req);
 static inline void _Mithril_rec_min_support_one(cache_t *Mithril,
                                                 const request_t *req);
-static inline gint _Mithril_get_total_num_of_ts(gint64 *row, gint row_length);
 static void _Mithril_mining(cache_t *Mithril);
+static void _Mithril_wait_mining(cache_t *Mithril);
 
-static void _Mithril_add_to_prefetch_table(cache_t *Mithril, gpointer gp1,
-                                           gpointer gp2);
+static void _Mithril_add_to_prefetch_table(cache_t *Mithril, obj_id_t src,
+                                           obj_id_t dst);
 
 const char *Mithril_default_params(void) {
   return "lookahead-range=20, "
          "max-support=8, min-support=2, confidence=1, pf-list-size=2, "
          "rec-trigger=miss, block-size=1, max-metadata-size=0.1, "
          "cycle-time=2, mining-threshold=5120, sequential-type=0, "
-         "sequential-K=-1, AMP-pthreshold=-1";
+         "sequential-K=-1, AMP-pthreshold=-1, mining-impl=auto, "
+         "mining-mode=sync";
 }
 
 static void set_Mithril_default_init_params(
@@ -71,6 +73,9 @@ static void set_Mithril_default_init_params(
   init_params->sequential_K = -1;
 
   init_params->AMP_pthreshold = -1;
+
+  init_params->mining_impl = MINING_IMPL_AUTO;
+  init_params->mining_mode = MINING_SYNC;
 }
 
 static void Mithril_parse_init_params(const char *cache_specific_params,
@@ -119,6 +124,36 @@ static void Mithril_parse_init_params(const char *cache_specific_params,
       init_params->sequential_K = atoi(value);
     } else if (strcasecmp(key, "AMP-pthreshold") == 0) {
       init_params->AMP_pthreshold = atoi(value);
+    } else if (strcasecmp(key, "mining-impl") == 0) {
+      if (strcasecmp(value, "auto") == 0) {
+        init_params->mining_impl = MINING_IMPL_AUTO;
+      } else if (strcasecmp(value, "scalar") == 0) {
+        init_params->mining_impl = MINING_IMPL_SCALAR;
+      } else if (strcasecmp(value, "sse2") == 0) {
+        init_params->mining_impl = MINING_IMPL_SSE2;
+      } else if (strcasecmp(value, "avx2") == 0) {
+        init_params->mining_impl = MINING_IMPL_AVX2;
+      } else if (strcasecmp(value, "avx512") == 0) {
+        init_params->mining_impl = MINING_IMPL_AVX512;
+      } else {
+        ERROR(
+            "Mithril's mining-impl does not support %s, "
+            "support auto/scalar/sse2/avx2/avx512\n",
+            value);
+      }
+    } else if (strcasecmp(key, "mining-mode") == 0) {
+      if (strcasecmp(value, "sync") == 0) {
+        init_params->mining_mode = MINING_SYNC;
+      } else if (strcasecmp(value, "async") == 0) {
+        init_params->mining_mode = MINING_ASYNC;
+      } else if (strcasecmp(value, "deterministic") == 0) {
+        init_params->mining_mode = MINING_DETERMINISTIC;
+      } else {
+        ERROR(
+            "Mithril's mining-mode does not support %s, "
+            "support sync/async/deterministic\n",
+            value);
+      }
     } else if (strcasecmp(key, "print") == 0 ||
                strcasecmp(key, "default") == 0) {
       printf("default params: %s\n", Mithril_default_params());
@@ -176,21 +211,25 @@ static void set_Mithril_params(Mithril_params_t *Mithril_params,
       (gint)ceil((double)Mithril_params->min_support / (double)4) + 1;
   rmtable->mtable_row_len =
       (gint)ceil((double)Mithril_params->max_support / (double)4) + 1;
-  rmtable->mining_table =
-      g_array_sized_new(FALSE, TRUE, sizeof(int64_t) * rmtable->mtable_row_len,
-                        Mithril_params->mtable_size);
-  rmtable->hashtable =
-      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-  Mithril_params->prefetch_hashtable =
-      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-  Mithril_params->cache_size_map =
-      g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+  rmtable->mining_table = g_new0(
+      gint64, Mithril_params->mtable_size * rmtable->mtable_row_len);
+  rmtable->mining_table_len = 0;
+  rmtable->hashtable = id_map_init(Mithril_params->mtable_size);
+
+  Mithril_params->mining_impl =
+      Mithril_resolve_mining_impl(init_params->mining_impl);
+  Mithril_params->mining_mode = init_params->mining_mode;
+  Mithril_params->mining_job = Mithril_mining_job_init(
+      Mithril_params->mtable_size, rmtable->mtable_row_len,
+      Mithril_params->lookahead_range, Mithril_params->confidence,
+      Mithril_params->mining_impl);
+  memset(&Mithril_params->mining_stat, 0, sizeof(Mithril_mining_stat_t));
+  Mithril_params->prefetch_hashtable = id_map_init(PREFETCH_TABLE_SHARD_SIZE);
+  Mithril_params->cache_size_map = id_map_init(1 << 16);
 
   if (Mithril_params->output_statistics) {
-    Mithril_params->prefetched_hashtable_Mithril =
-        g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-    Mithril_params->prefetched_hashtable_sequential =
-        g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+    Mithril_params->prefetched_hashtable_Mithril = id_map_init(1024);
+    Mithril_params->prefetched_hashtable_sequential = id_map_init(1024);
   }
 
   Mithril_params->ptable_cur_row = 1;
@@ -248,22 +287,16 @@ static void Mithril_handle_find(cache_t *cache, const request_t *req,
       (Mithril_params_t *)(cache->prefetcher->params);
 
   /*use cache_size_map to record the current requested obj's size*/
-  g_hash_table_insert(Mithril_params->cache_size_map,
-                      GINT_TO_POINTER(req->obj_id),
-                      GINT_TO_POINTER(req->obj_size));
+  id_map_put(Mithril_params->cache_size_map, req->obj_id, req->obj_size);
 
   if (Mithril_params->output_statistics) {
-    if (g_hash_table_contains(Mithril_params->prefetched_hashtable_Mithril,
-                              GINT_TO_POINTER(req->obj_id))) {
+    if (id_map_remove(Mithril_params->prefetched_hashtable_Mithril,
+                      req->obj_id)) {
       Mithril_params->hit_on_prefetch_Mithril += 1;
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(req->obj_id));
     }
-    if (g_hash_table_contains(Mithril_params->prefetched_hashtable_sequential,
-                              GINT_TO_POINTER(req->obj_id))) {
+    if (id_map_remove(Mithril_params->prefetched_hashtable_sequential,
+                      req->obj_id)) {
       Mithril_params->hit_on_prefetch_sequential += 1;
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_sequential,
-                          GINT_TO_POINTER(req->obj_id));
     }
   }
 
@@ -277,27 +310,38 @@ static void Mithril_handle_find(cache_t *cache, const request_t *req,
 }
 
 /**
- evict_req->obj_id has been evict by cache_remove_base.
+ evicted->obj_id has been evict by cache_remove_base.
  Now, prefetcher checks whether it can be added to cache (second chance).
 
  @param cache the cache struct
- @param req the request containing the request
+ @param evicted the evicted object
  @return
 */
-void Mithril_handle_evict(cache_t *cache, const request_t *check_req) {
+void Mithril_handle_evict(cache_t *cache, const evicted_obj_t *evicted) {
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
 
   if (Mithril_params->output_statistics) {
-    obj_id_t check_id = check_req->obj_id;
+    obj_id_t check_id = evicted->obj_id;
+
+    gint type = (gint)id_map_get(Mithril_params->prefetched_hashtable_Mithril,
+                                 check_id, 0);
+    bool second_chance = type != 0 && type < Mithril_params->cycle_time;
+    bool record = !second_chance && (Mithril_params->rec_trigger == evict ||
+                                     Mithril_params->rec_trigger == miss_evict);
+
+    request_t *check_req = NULL;
+    if (second_chance || record) {
+      check_req = prefetcher_get_req(cache->prefetcher);
+      init_request(check_req);
+      check_req->obj_id = evicted->obj_id;
+      check_req->obj_size = evicted->obj_size;
+    }
 
-    gint type = GPOINTER_TO_INT(
-        g_hash_table_lookup(Mithril_params->prefetched_hashtable_Mithril,
-                            GINT_TO_POINTER(check_id)));
-    if (type != 0 && type < Mithril_params->cycle_time) {
+    if (second_chance) {
       // give one more chance
-      g_hash_table_insert(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(check_id), GINT_TO_POINTER(type + 1));
+      id_map_put(Mithril_params->prefetched_hashtable_Mithril, check_id,
+                 type + 1);
 
       while ((long)cache->get_occupied_byte(cache) + check_req->obj_size +
                  cache->obj_md_size >
@@ -306,15 +350,16 @@ void Mithril_handle_evict(cache_t *cache, const request_t *check_req) {
       }
       cache->insert(cache, check_req);
     } else {
-      if (Mithril_params->rec_trigger == evict ||
-          Mithril_params->rec_trigger == miss_evict) {
+      if (record) {
         _Mithril_record_entry(cache, check_req);
       }
 
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(check_req->obj_id));
-      g_hash_table_remove(Mithril_params->prefetched_hashtable_sequential,
-                          GINT_TO_POINTER(check_req->obj_id));
+      id_map_remove(Mithril_params->prefetched_hashtable_Mithril, check_id);
+      id_map_remove(Mithril_params->prefetched_hashtable_sequential, check_id);
+    }
+
+    if (check_req != NULL) {
+      prefetcher_put_req(cache->prefetcher, check_req);
     }
   }
 }
@@ -331,15 +376,21 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
 
-  gint prefetch_table_index = GPOINTER_TO_INT(g_hash_table_lookup(
-      Mithril_params->prefetch_hashtable, GINT_TO_POINTER(req->obj_id)));
+  Mithril_mining_job_t *job = Mithril_params->mining_job;
+  if (Mithril_params->mining_mode == MINING_ASYNC && job->running &&
+      __atomic_load_n(&job->done, __ATOMIC_ACQUIRE)) {
+    _Mithril_wait_mining(cache);
+  }
+
+  gint prefetch_table_index =
+      (gint)id_map_get(Mithril_params->prefetch_hashtable, req->obj_id, 0);
 
   gint dim1 =
       (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
   gint dim2 = prefetch_table_index % PREFETCH_TABLE_SHARD_SIZE *
               (Mithril_params->pf_list_size + 1);
 
-  request_t *new_req = my_malloc(request_t);
+  request_t *new_req = prefetcher_get_req(cache->prefetcher);
   copy_request(new_req, req);
 
   if (prefetch_table_index) {
@@ -350,8 +401,8 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
         break;
       }
       new_req->obj_id = Mithril_params->ptable_array[dim1][dim2 + i];
-      new_req->obj_size = GPOINTER_TO_INT(g_hash_table_lookup(
-          Mithril_params->cache_size_map, GINT_TO_POINTER(new_req->obj_id)));
+      new_req->obj_size =
+          id_map_get(Mithril_params->cache_size_map, new_req->obj_id, 0);
 
       if (Mithril_params->output_statistics) {
         Mithril_params->num_of_check += 1;
@@ -371,9 +422,8 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
       if (Mithril_params->output_statistics) {
         Mithril_params->num_of_prefetch_Mithril += 1;
 
-        g_hash_table_insert(Mithril_params->prefetched_hashtable_Mithril,
-                            GINT_TO_POINTER(new_req->obj_id),
-                            GINT_TO_POINTER(1));
+        id_map_put(Mithril_params->prefetched_hashtable_Mithril,
+                   new_req->obj_id, 1);
       }
     }
   }
@@ -386,7 +436,7 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
     new_req->obj_size = req->obj_size;  // same size
 
     if (cache->find(cache, new_req, false)) {
-      my_free(sizeof(request_t), new_req);
+      prefetcher_put_req(cache->prefetcher, new_req);
       return;
     }
 
@@ -401,11 +451,11 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
 
     if (Mithril_params->output_statistics) {
       Mithril_params->num_of_prefetch_sequential += 1;
-      g_hash_table_insert(Mithril_params->prefetched_hashtable_Mithril,
-                          GINT_TO_POINTER(new_req->obj_id), GINT_TO_POINTER(1));
+      id_map_put(Mithril_params->prefetched_hashtable_Mithril, new_req->obj_id,
+                 1);
     }
   }
-  my_free(sizeof(request), new_req);
+  prefetcher_put_req(cache->prefetcher, new_req);
 
   Mithril_params->ts++;
 }
@@ -413,11 +463,29 @@ void Mithril_prefetch(cache_t *cache, const request_t *req) {
 void free_Mithril_prefetcher(prefetcher_t *prefetcher) {
   Mithril_params_t *Mithril_params = (Mithril_params_t *)prefetcher->params;
 
-  g_hash_table_destroy(Mithril_params->prefetch_hashtable);
-  g_hash_table_destroy(Mithril_params->cache_size_map);
-  g_hash_table_destroy(Mithril_params->rmtable->hashtable);
+  Mithril_mining_job_t *job = Mithril_params->mining_job;
+  if (job->running) {
+    pthread_join(job->miner, NULL);
+  }
+  Mithril_mining_job_free(job);
+
+  Mithril_mining_stat_t *stat = &Mithril_params->mining_stat;
+  DEBUG(
+      "Mithril mining (%s, %s): %lu batches, %lu rows, %lu associations, "
+      "mining %.2lf ms (max %.2lf ms), request path blocked %.2lf ms\n",
+      Mithril_mining_impl_name(Mithril_params->mining_impl),
+      Mithril_params->mining_mode == MINING_SYNC    ? "sync"
+      : Mithril_params->mining_mode == MINING_ASYNC ? "async"
+                                                    : "deterministic",
+      (unsigned long)stat->n_mining, (unsigned long)stat->n_row,
+      (unsigned long)stat->n_association, stat->mining_ms,
+      stat->max_mining_ms, stat->blocking_ms);
+
+  id_map_free(Mithril_params->prefetch_hashtable);
+  id_map_free(Mithril_params->cache_size_map);
+  id_map_free(Mithril_params->rmtable->hashtable);
   g_free(Mithril_params->rmtable->recording_table);
-  g_array_free(Mithril_params->rmtable->mining_table, TRUE);
+  g_free(Mithril_params->rmtable->mining_table);
   g_free(Mithril_params->rmtable);
 
   int i = 0;
@@ -436,10 +504,11 @@ void free_Mithril_prefetcher(prefetcher_t *prefetcher) {
   g_free(Mithril_params->ptable_array);
 
   if (Mithril_params->output_statistics) {
-    g_hash_table_destroy(Mithril_params->prefetched_hashtable_Mithril);
-    g_hash_table_destroy(Mithril_params->prefetched_hashtable_sequential);
+    id_map_free(Mithril_params->prefetched_hashtable_Mithril);
+    id_map_free(Mithril_params->prefetched_hashtable_sequential);
   }
   my_free(sizeof(Mithril_params_t), Mithril_params);
+  prefetcher_free_req_pool(prefetcher);
   if (prefetcher->init_params) {
     free(prefetcher->init_params);
   }
@@ -496,7 +565,7 @@ static inline bool _Mithril_check_sequential(cache_t *cache,
       (Mithril_params_t *)(cache->prefetcher->params);
   if (Mithril_params->sequential_K == 0) return FALSE;
 
-  request_t *new_req = my_malloc(request_t);
+  request_t *new_req = prefetcher_get_req(cache->prefetcher);
   copy_request(new_req, req);
   bool is_sequential = TRUE;
   gint sequential_K = Mithril_params->sequential_K;
@@ -510,9 +579,31 @@ static inline bool _Mithril_check_sequential(cache_t *cache,
       break;
     }
   }
+  prefetcher_put_req(cache->prefetcher, new_req);
   return is_sequential;
 }
 
+/* append a row to the mining table */
+static inline void _Mithril_mtable_append(rec_mining_t *rmtable,
+                                          const gint64 *row) {
+  memcpy(rmtable->mining_table +
+             (size_t)rmtable->mining_table_len * rmtable->mtable_row_len,
+         row, sizeof(TS_REPRESENTATION) * rmtable->mtable_row_len);
+  rmtable->mining_table_len++;
+}
+
+/* remove a row from the mining table, the last row is moved into its place */
+static inline void _Mithril_mtable_remove(rec_mining_t *rmtable,
+                                          gint row_num) {
+  rmtable->mining_table_len--;
+  if (row_num != rmtable->mining_table_len) {
+    memcpy(rmtable->mining_table + (size_t)row_num * rmtable->mtable_row_len,
+           rmtable->mining_table +
+               (size_t)rmtable->mining_table_len * rmtable->mtable_row_len,
+           sizeof(TS_REPRESENTATION) * rmtable->mtable_row_len);
+  }
+}
+
 static inline void _Mithril_rec_min_support_one(cache_t *cache,
                                                 const request_t *req) {
   Mithril_params_t *Mithril_params =
@@ -521,8 +612,7 @@ static inline void _Mithril_rec_min_support_one(cache_t *cache,
 
 #ifdef TRACK_BLOCK
   if (req->obj_id == TRACK_BLOCK) {
-    int old_pos = GPOINTER_TO_INT(
-        g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(req->obj_id)));
+    int old_pos = (int)id_map_get(rmtable->hashtable, req->obj_id, 0);
     printf("insert %ld, old pos %d", TRACK_BLOCK, old_pos);
     if (old_pos == 0)
       printf("\n");
@@ -532,8 +622,7 @@ static inline void _Mithril_rec_min_support_one(cache_t *cache,
 
   } else {
     gint64 b = TRACK_BLOCK;
-    int old_pos = GPOINTER_TO_INT(
-        g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(b)));
+    int old_pos = (int)id_map_get(rmtable->hashtable, b, 0);
     if (old_pos != 0) {
       ERROR("ts %lu, checking %ld, %ld is found at pos %d\n",
             (unsigned long)Mithril_params->ts, (long)TRACK_BLOCK,
@@ -546,8 +635,7 @@ static inline void _Mithril_rec_min_support_one(cache_t *cache,
 
   int i;
   // check the obj_id in hashtable for training
-  gint index = GPOINTER_TO_INT(
-      g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(req->obj_id)));
+  gint index = (gint)id_map_get(rmtable->hashtable, req->obj_id, 0);
   if (index == 0) {
     // the node is not in the recording/mining data, should be added
     gint64 array_ele[rmtable->mtable_row_len];
@@ -559,16 +647,15 @@ static inline void _Mithril_rec_min_support_one(cache_t *cache,
     for (i = 1; i < rmtable->mtable_row_len; i++) array_ele[i] = 0;
     array_ele[1] = ADD_TS(array_ele[1], Mithril_params->ts);
 
-    g_array_append_val(rmtable->mining_table, array_ele);
+    _Mithril_mtable_append(rmtable, array_ele);
     rmtable->n_avail_mining++;
 
     // all index is real row number + 1
-    g_hash_table_insert(rmtable->hashtable, GINT_TO_POINTER(req->obj_id),
-                        GINT_TO_POINTER(rmtable->mining_table->len));
+    id_map_put(rmtable->hashtable, req->obj_id, rmtable->mining_table_len);
 
 #ifdef SANITY_CHECK
     gint64 *row_in_mtable =
-        GET_ROW_IN_MTABLE(Mithril_params, rmtable->mining_table->len - 1);
+        GET_ROW_IN_MTABLE(Mithril_params, rmtable->mining_table_len - 1);
     if (req->obj_id != (obj_id_t) row_in_mtable[0]) {
       ERROR("after inserting, hashtable mining not consistent %ld %ld\n",
             (long)req->obj_id, (long)row_in_mtable[0]);
@@ -599,18 +686,15 @@ static inline void _Mithril_rec_min_support_one(cache_t *cache,
     }
     if (timestamps_length == Mithril_params->max_support) {
       /* no timestamp added, drop this request, it is too frequent */
-      if (!g_hash_table_remove(rmtable->hashtable,
-                               GINT_TO_POINTER(row_in_mtable[0]))) {
+      if (!id_map_remove(rmtable->hashtable, row_in_mtable[0])) {
         ERROR("removing from rmtable failed for mining table entry\n");
       }
 
-      g_array_remove_index_fast(rmtable->mining_table, index - 1);
+      _Mithril_mtable_remove(rmtable, index - 1);
 
       // if array is moved, need to update hashtable
-      if (index - 1 != (long)rmtable->mining_table->len) {
-        g_hash_table_replace(rmtable->hashtable,
-                             GINT_TO_POINTER(row_in_mtable[0]),
-                             GINT_TO_POINTER(index));
+      if (index - 1 != rmtable->mining_table_len) {
+        id_map_put(rmtable->hashtable, row_in_mtable[0], index);
       }
       rmtable->n_avail_mining--;
     }
@@ -640,8 +724,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
   } else {
     gint64 *row_in_rtable;
     // check the obj_id in hashtable for training
-    gint index = GPOINTER_TO_INT(
-        g_hash_table_lookup(rmtable->hashtable, GINT_TO_POINTER(req->obj_id)));
+    gint index = (gint)id_map_get(rmtable->hashtable, req->obj_id, 0);
 
     if (index == 0) {
       // the node is not in the recording/mining data, should be added
@@ -656,8 +739,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
 
       row_in_rtable[0] = req->obj_id;
       // row_in_rtable is a pointer to the block number
-      g_hash_table_insert(rmtable->hashtable, GINT_TO_POINTER(row_in_rtable[0]),
-                          GINT_TO_POINTER(rmtable->rtable_cur_row));
+      id_map_put(rmtable->hashtable, row_in_rtable[0], rmtable->rtable_cur_row);
 
       row_in_rtable[1] = ADD_TS(row_in_rtable[1], Mithril_params->ts);
 
@@ -678,8 +760,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
          *  and current position has old resident,
          *  we need to remove them
          **/
-        if (!g_hash_table_contains(rmtable->hashtable,
-                                   GINT_TO_POINTER(row_in_rtable[0]))) {
+        if (!id_map_contains(rmtable->hashtable, row_in_rtable[0])) {
           ERROR(
               "remove old entry from recording table, "
               "but it is not in recording hashtable, "
@@ -693,8 +774,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
           abort();
         }
 
-        g_hash_table_remove(rmtable->hashtable,
-                            GINT_TO_POINTER(row_in_rtable[0]));
+        id_map_remove(rmtable->hashtable, row_in_rtable[0]);
 
         /* clear recording table */
         for (i = 0; i < rmtable->rtable_row_len; i++) {
@@ -735,26 +815,18 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
         }
         if (timestamps_length == Mithril_params->max_support) {
           /* no timestamp added, drop this request, it is too frequent */
-          if (!g_hash_table_remove(rmtable->hashtable,
-                                   GINT_TO_POINTER(row_in_mtable[0]))) {
+          if (!id_map_remove(rmtable->hashtable, row_in_mtable[0])) {
             ERROR("removing from rmtable failed for mining table entry\n");
           }
 
-          /** for dataType c, now the pointer to string has been freed,
-           *  so mining table entry is incorrect,
-           *  but mining table entry will be deleted, so it is OK
-           */
-
-          g_array_remove_index_fast(rmtable->mining_table, -index - 1);
+          _Mithril_mtable_remove(rmtable, -index - 1);
 
           /** if the removed block is not the last entry,
-           *  g_array_remove_index_fast uses the last entry to fill in
+           *  _Mithril_mtable_remove uses the last entry to fill in
            *  the old position, so we need to update its index
            **/
-          if (-index - 1 != (long)rmtable->mining_table->len) {
-            g_hash_table_replace(rmtable->hashtable,
-                                 GINT_TO_POINTER(row_in_mtable[0]),
-                                 GINT_TO_POINTER(index));
+          if (-index - 1 != rmtable->mining_table_len) {
+            id_map_put(rmtable->hashtable, row_in_mtable[0], index);
           }
           rmtable->n_avail_mining--;
         }
@@ -797,18 +869,17 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
                  sizeof(TS_REPRESENTATION) *
                      (rmtable->mtable_row_len - rmtable->rtable_row_len));
 #ifdef SANITY_CHECK
-          if ((long)rmtable->mining_table->len >= Mithril_params->mtable_size) {
-            /* if this happens, array will re-malloc, which will make
-             * the hashtable key not reliable when obj_id_type is l */
+          if (rmtable->mining_table_len >= Mithril_params->mtable_size) {
+            /* the mining table has mtable_size rows */
             ERROR(
                 "mining table length reaches limit, but no mining, "
-                "entry %d, size %u, threshold %d\n",
-                rmtable->n_avail_mining, rmtable->mining_table->len,
+                "entry %d, size %d, threshold %d\n",
+                rmtable->n_avail_mining, rmtable->mining_table_len,
                 Mithril_params->mtable_size);
             abort();
           }
 #endif
-          g_array_append_val(rmtable->mining_table, array_ele);
+          _Mithril_mtable_append(rmtable, array_ele);
           rmtable->n_avail_mining++;
 
           if (index != rmtable->rtable_cur_row - 1 &&
@@ -836,7 +907,7 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
           }
 
           gint64 *inserted_row_in_mtable =
-              GET_ROW_IN_MTABLE(Mithril_params, rmtable->mining_table->len - 1);
+              GET_ROW_IN_MTABLE(Mithril_params, rmtable->mining_table_len - 1);
 
 #ifdef SANITY_CHECK
           if (inserted_row_in_mtable[0] != (gint64)req->obj_id) {
@@ -850,16 +921,13 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
            *  in other words, the range of mining table index
            *  is -1 ~ -max_index-1, mapping to 0~max_index
            */
-          g_hash_table_replace(
-              rmtable->hashtable, GINT_TO_POINTER(inserted_row_in_mtable[0]),
-              GINT_TO_POINTER(-((gint)rmtable->mining_table->len - 1 + 1)));
+          id_map_put(rmtable->hashtable, inserted_row_in_mtable[0],
+                     -(rmtable->mining_table_len - 1 + 1));
 
           if (index != rmtable->rtable_cur_row - 1 &&
               rmtable->rtable_cur_row >= 2)
             // last entry in the recording table is moved up index position
-            g_hash_table_replace(rmtable->hashtable,
-                                 GINT_TO_POINTER(row_in_rtable[0]),
-                                 GINT_TO_POINTER(index));
+            id_map_put(rmtable->hashtable, row_in_rtable[0], index);
 
           // one entry has been moved to mining table, shrinking recording
           // table size by 1
@@ -878,41 +946,70 @@ static inline void _Mithril_record_entry(cache_t *cache, const request_t *req) {
   }
 }
 
-static inline gint _Mithril_get_total_num_of_ts(gint64 *row, gint row_length) {
-  int i, t;
-  int count = 0;
-  for (i = 1; i < row_length; i++) {
-    t = NUM_OF_TS(row[i]);
-    if (t == 0) return count;
-    count += t;
+/* in debug */
+void print_prefetch_table(Mithril_params_t *Mithril_params) {
+  id_map_t *map = Mithril_params->prefetch_hashtable;
+  for (uint64_t slot = 0; slot <= map->mask; slot++) {
+    if (map->slots[slot].key == ID_MAP_EMPTY_KEY) continue;
+    gint prefetch_table_index = (gint)map->slots[slot].value;
+    gint dim1 =
+        (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
+    gint dim2 = prefetch_table_index % PREFETCH_TABLE_SHARD_SIZE *
+                (Mithril_params->pf_list_size + 1);
+    printf("src %ld, prefetch ", (long)map->slots[slot].key);
+    for (int i = 1; i < Mithril_params->pf_list_size + 1; i++) {
+      printf("%ld ", (long)Mithril_params->ptable_array[dim1][dim2 + i]);
+    }
+    printf("\n");
   }
-  return count;
 }
 
-gint mining_table_entry_cmp(gconstpointer a, gconstpointer b) {
-  return (gint)GET_NTH_TS(a, 1) - (gint)GET_NTH_TS(b, 1);
+static double _Mithril_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
 }
 
-/* in debug */
-void print_one_line(gpointer key, gpointer value, gpointer user_data) {
-  gint src_key = GPOINTER_TO_INT(key);
-  gint prefetch_table_index = GPOINTER_TO_INT(value);
-  Mithril_params_t *Mithril_params = (Mithril_params_t *)user_data;
-  gint dim1 =
-      (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
-  gint dim2 = prefetch_table_index % PREFETCH_TABLE_SHARD_SIZE *
-              (Mithril_params->pf_list_size + 1);
-  printf("src %d, prefetch ", src_key);
-  for (int i = 1; i < Mithril_params->pf_list_size + 1; i++) {
-    printf("%ld ", (long)Mithril_params->ptable_array[dim1][dim2 + i]);
-  }
-  printf("\n");
+static void *_Mithril_mining_thread(void *arg) {
+  Mithril_mining_job_t *job = (Mithril_mining_job_t *)arg;
+  Mithril_mine(job);
+  __atomic_store_n(&job->done, TRUE, __ATOMIC_RELEASE);
+  return NULL;
 }
 
-/* in debug */
-void print_prefetch_table(Mithril_params_t *Mithril_params) {
-  g_hash_table_foreach(Mithril_params->prefetch_hashtable, print_one_line,
-                       Mithril_params);
+/**
+ add the associations of the last mining job to the prefetch table, in the
+ order they are mined, waiting for the background mining if needed
+
+ @param Mithril the cache struct
+ */
+static void _Mithril_wait_mining(cache_t *cache) {
+  Mithril_params_t *Mithril_params =
+      (Mithril_params_t *)(cache->prefetcher->params);
+  Mithril_mining_job_t *job = Mithril_params->mining_job;
+  Mithril_mining_stat_t *stat = &Mithril_params->mining_stat;
+
+  if (job->running) {
+    double start = _Mithril_now_ms();
+    pthread_join(job->miner, NULL);
+    stat->blocking_ms += _Mithril_now_ms() - start;
+    job->running = FALSE;
+  }
+
+  stat->n_mining += 1;
+  stat->n_row += job->n_row;
+  stat->n_association += job->n_pair;
+  stat->mining_ms += job->mining_ms;
+  stat->max_mining_ms = MAX(stat->max_mining_ms, job->mining_ms);
+
+  for (gint64 i = 0; i < job->n_pair; i++) {
+    obj_id_t src = job->pairs[i * 2], dst = job->pairs[i * 2 + 1];
+    stat->association_hash =
+        (stat->association_hash ^ src) * 0x100000001B3ULL ^ dst;
+    _Mithril_add_to_prefetch_table(cache, src, dst);
+  }
+  job->n_pair = 0;
+  job->n_row = 0;
 }
 
 /**
@@ -924,6 +1021,7 @@ static void _Mithril_mining(cache_t *cache) {
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
   rec_mining_t *rmtable = Mithril_params->rmtable;
+  Mithril_mining_job_t *job = Mithril_params->mining_job;
 
 #ifdef PROFILING
   GTimer *timer = g_timer_new();
@@ -931,82 +1029,36 @@ static void _Mithril_mining(cache_t *cache) {
   g_timer_start(timer);
 #endif
 
-  int i, j, k;
+  /* only one batch is mined at a time */
+  if (job->running) {
+    _Mithril_wait_mining(cache);
+  }
 
-  /* first sort mining table, then do the mining */
-  /* first remove all elements from hashtable, otherwise after sort, it will
-   mess up for obj_id_type l but we can't do this for dataType c, otherwise
-   the string will be freed during remove in hashtable
-   */
-  gint64 *item = (gint64 *)rmtable->mining_table->data;
-  for (i = 0; i < (int)rmtable->mining_table->len; i++) {
-    g_hash_table_remove(rmtable->hashtable, GINT_TO_POINTER(*item));
+  /* first remove all elements from hashtable, the rows are no longer in the
+   * mining table after they are handed to the job */
+  gint64 *item = rmtable->mining_table;
+  for (gint i = 0; i < rmtable->mining_table_len; i++) {
+    id_map_remove(rmtable->hashtable, *item);
     item += rmtable->mtable_row_len;
   }
 
-  g_array_sort(rmtable->mining_table, mining_table_entry_cmp);
-
-  gboolean associated_flag, first_flag;
-  gint64 *item1, *item2;
-  gint num_of_ts1, num_of_ts2, shorter_length;
-  for (i = 0; i < (long)rmtable->mining_table->len - 1; i++) {
-    item1 = GET_ROW_IN_MTABLE(Mithril_params, i);
-    num_of_ts1 = _Mithril_get_total_num_of_ts(item1, rmtable->mtable_row_len);
-    first_flag = TRUE;
-
-    for (j = i + 1; j < (long)rmtable->mining_table->len; j++) {
-      item2 = GET_ROW_IN_MTABLE(Mithril_params, j);
-
-      // check first timestamp
-      if (GET_NTH_TS(item2, 1) - GET_NTH_TS(item1, 1) >
-          Mithril_params->lookahead_range) {
-        break;
-      }
-      num_of_ts2 = _Mithril_get_total_num_of_ts(item2, rmtable->mtable_row_len);
-
-      if (ABS(num_of_ts1 - num_of_ts2) > Mithril_params->confidence) {
-        continue;
-      }
-
-      shorter_length = MIN(num_of_ts1, num_of_ts2);
-
-      associated_flag = FALSE;
-      if (first_flag) {
-        associated_flag = TRUE;
-        first_flag = FALSE;
-      }
-      // is next line useless??
-      if (shorter_length == 1 &&
-          ABS(GET_NTH_TS(item1, 1) - GET_NTH_TS(item2, 1)) == 1) {
-        associated_flag = TRUE;
-      }
+  gint64 *tmp = job->table;
+  job->table = rmtable->mining_table;
+  job->n_row = rmtable->mining_table_len;
+  rmtable->mining_table = tmp;
+  rmtable->mining_table_len = 0;
 
-      gint error = 0;
-      for (k = 1; k < shorter_length; k++) {
-        if (ABS(GET_NTH_TS(item1, k) - GET_NTH_TS(item2, k)) >
-            Mithril_params->lookahead_range) {
-          error++;
-          if (error > Mithril_params->confidence) {
-            associated_flag = FALSE;
-            break;
-          }
-        }
-
-        if (ABS(GET_NTH_TS(item1, k) - GET_NTH_TS(item2, k)) == 1) {
-          associated_flag = TRUE;
-        }
-      }
-      if (associated_flag) {
-        // finally, add to prefetch table
-        _Mithril_add_to_prefetch_table(cache, GINT_TO_POINTER(item1[0]),
-                                       GINT_TO_POINTER(item2[0]));
-      }
+  if (Mithril_params->mining_mode == MINING_SYNC) {
+    Mithril_mine(job);
+    _Mithril_wait_mining(cache);
+  } else {
+    job->done = FALSE;
+    job->running = TRUE;
+    if (pthread_create(&job->miner, NULL, _Mithril_mining_thread, job) != 0) {
+      ERROR("Mithril: failed to create the mining thread\n");
     }
   }
 
-  // may be just following?
-  rmtable->mining_table->len = 0;
-
 #ifdef PROFILING
   printf("ts: %lu, clearing training data takes %lf seconds\n",
          (unsigned long)Mithril_params->ts,
@@ -1024,18 +1076,18 @@ static void _Mithril_mining(cache_t *cache) {
  add two associated block into prefetch table
 
  @param Mithril the cache struct
- @param gp1 pointer to the first block
- @param gp2 pointer to the second block
+ @param src the first block
+ @param dst the second block, prefetched when src is requested
  */
-static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
-                                           gpointer gp2) {
+static void _Mithril_add_to_prefetch_table(cache_t *cache, obj_id_t src,
+                                           obj_id_t dst) {
   /** currently prefetch table can only support up to 2^31 entries,
    * and this function assumes the platform is 64 bit */
   Mithril_params_t *Mithril_params =
       (Mithril_params_t *)(cache->prefetcher->params);
 
-  gint prefetch_table_index = GPOINTER_TO_INT(
-      g_hash_table_lookup(Mithril_params->prefetch_hashtable, gp1));
+  gint prefetch_table_index =
+      (gint)id_map_get(Mithril_params->prefetch_hashtable, src, 0);
   gint dim1 =
       (gint)floor(prefetch_table_index / (double)PREFETCH_TABLE_SHARD_SIZE);
   gint dim2 = prefetch_table_index % PREFETCH_TABLE_SHARD_SIZE *
@@ -1053,16 +1105,15 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
       // again ATTENTION: the following
       // assumes a 64 bit platform
 #ifdef SANITY_CHECK
-      if (Mithril_params->ptable_array[dim1][dim2] != GPOINTER_TO_INT(gp1)) {
-        fprintf(stderr, "ERROR prefetch table pos wrong %d %ld, dim %d %d\n",
-                GPOINTER_TO_INT(gp1),
-                (long)Mithril_params->ptable_array[dim1][dim2], dim1, dim2);
+      if (Mithril_params->ptable_array[dim1][dim2] != (gint64)src) {
+        fprintf(stderr, "ERROR prefetch table pos wrong %ld %ld, dim %d %d\n",
+                (long)src, (long)Mithril_params->ptable_array[dim1][dim2],
+                dim1, dim2);
         exit(1);
       }
 #endif
       if ((Mithril_params->ptable_array[dim1][dim2 + i]) == 0) break;
-      if ((Mithril_params->ptable_array[dim1][dim2 + i]) ==
-          GPOINTER_TO_INT(gp2)) {
+      if ((Mithril_params->ptable_array[dim1][dim2 + i]) == (gint64)dst) {
         /* update score here, not implemented yet */
         insert = FALSE;
       }
@@ -1082,7 +1133,7 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
         i = Mithril_params->pf_list_size;
       }
       // new add at position i
-      Mithril_params->ptable_array[dim1][dim2 + i] = GPOINTER_TO_INT(gp2);
+      Mithril_params->ptable_array[dim1][dim2 + i] = (gint64)dst;
     }
   } else {
     // does not have entry, need to add a new entry
@@ -1096,29 +1147,27 @@ static void _Mithril_add_to_prefetch_table(cache_t *cache, gpointer gp1,
      to replace the entry at ptable_cur_row by set the entry it points to as
      0, delete from prefetch_hashtable and add new entry */
     if (Mithril_params->ptable_is_full) {
-      g_hash_table_remove(
-          Mithril_params->prefetch_hashtable,
-          GINT_TO_POINTER(Mithril_params->ptable_array[dim1][dim2]));
+      id_map_remove(Mithril_params->prefetch_hashtable,
+                    Mithril_params->ptable_array[dim1][dim2]);
 
       memset(&(Mithril_params->ptable_array[dim1][dim2]), 0,
              sizeof(gint64) * (Mithril_params->pf_list_size + 1));
     }
 
-    Mithril_params->ptable_array[dim1][dim2 + 1] = GPOINTER_TO_INT(gp2);
-    Mithril_params->ptable_array[dim1][dim2] = GPOINTER_TO_INT(gp1);
+    Mithril_params->ptable_array[dim1][dim2 + 1] = (gint64)dst;
+    Mithril_params->ptable_array[dim1][dim2] = (gint64)src;
 
 #ifdef SANITY_CHECK
-    // make sure gp1 is not in prefetch_hashtable
-    if (g_hash_table_contains(Mithril_params->prefetch_hashtable, gp1)) {
-      gpointer gp =
-          g_hash_table_lookup(Mithril_params->prefetch_hashtable, gp1);
-      printf("contains %d, value %d, %d\n", GPOINTER_TO_INT(gp1),
-             GPOINTER_TO_INT(gp), prefetch_table_index);
+    // make sure src is not in prefetch_hashtable
+    int64_t *old_index = id_map_find(Mithril_params->prefetch_hashtable, src);
+    if (old_index != NULL) {
+      printf("contains %ld, value %ld, %d\n", (long)src, (long)*old_index,
+             prefetch_table_index);
     }
 #endif
 
-    g_hash_table_insert(Mithril_params->prefetch_hashtable, gp1,
-                        GINT_TO_POINTER(Mithril_params->ptable_cur_row));
+    id_map_put(Mithril_params->prefetch_hashtable, src,
+               Mithril_params->ptable_cur_row);
 
     // check current shard is full or not
     if ((Mithril_params->ptable_cur_row + 1) % PREFETCH_TABLE_SHARD_SIZE == 0) {
@@ -0,0 +1,426 @@
+//
+//  MithrilMining.c
+//  libCacheSim
+//
+//  the mining step of Mithril, it finds the associated pairs in a batch of
+//  rows of the mining table
+//
+//  the rows are sorted by their first timestamp, so that the rows that can be
+//  associated with a row are the following rows whose first timestamp is
+//  within lookahead_range. the timestamps are decoded from the packed rows
+//  into one column per timestamp order, then a row is compared with 4 (SSE2),
+//  8 (AVX2) or 16 (AVX-512) following rows at a time. all implementations
+//  find the same pairs in the same order as the scalar one
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../include/libCacheSim/logging.h"
+#include "../../include/libCacheSim/prefetchAlgo/Mithril.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MITHRIL_MINING_X86
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the columns are padded so that the widest vector can be loaded at the last
+ * row */
+#define COL_PADDING 16
+
+#define TS_COL(job, k) ((job)->ts_col + (size_t)((k)-1) * (job)->col_len)
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+mining_impl_e Mithril_resolve_mining_impl(mining_impl_e impl) {
+#ifdef MITHRIL_MINING_X86
+  bool has_avx512 = __builtin_cpu_supports("avx512f");
+  bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (impl == MINING_IMPL_AUTO) {
+    return has_avx512 ? MINING_IMPL_AVX512 : has_avx2 ? MINING_IMPL_AVX2 : MINING_IMPL_SSE2;
+  }
+  if (impl == MINING_IMPL_AVX512 && !has_avx512) {
+    WARN("Mithril: the cpu does not support AVX-512, mine with %s\n",
+         Mithril_mining_impl_name(has_avx2 ? MINING_IMPL_AVX2 : MINING_IMPL_SSE2));
+    return has_avx2 ? MINING_IMPL_AVX2 : MINING_IMPL_SSE2;
+  }
+  if (impl == MINING_IMPL_AVX2 && !has_avx2) {
+    WARN("Mithril: the cpu does not support AVX2, mine with SSE2\n");
+    return MINING_IMPL_SSE2;
+  }
+  return impl;
+#else
+  if (impl != MINING_IMPL_AUTO && impl != MINING_IMPL_SCALAR) {
+    WARN("Mithril: %s mining is only supported on x86-64, mine with scalar\n", Mithril_mining_impl_name(impl));
+  }
+  return MINING_IMPL_SCALAR;
+#endif
+}
+
+const char *Mithril_mining_impl_name(mining_impl_e impl) {
+  switch (impl) {
+    case MINING_IMPL_AUTO:
+      return "auto";
+    case MINING_IMPL_SCALAR:
+      return "scalar";
+    case MINING_IMPL_SSE2:
+      return "sse2";
+    case MINING_IMPL_AVX2:
+      return "avx2";
+    case MINING_IMPL_AVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+Mithril_mining_job_t *Mithril_mining_job_init(gint mtable_size, gint row_len, gint lookahead_range, gint confidence,
+                                              mining_impl_e impl) {
+  Mithril_mining_job_t *job = g_new0(Mithril_mining_job_t, 1);
+  job->row_len = row_len;
+  job->lookahead_range = lookahead_range;
+  job->confidence = confidence;
+  job->impl = impl;
+
+  job->table = g_new0(gint64, (size_t)mtable_size * row_len);
+  job->table_buf = g_new0(gint64, (size_t)mtable_size * row_len);
+  job->sort_keys = g_new0(guint64, mtable_size);
+
+  /* each 64-bit integer after the label holds at most 4 timestamps */
+  job->n_col = (row_len - 1) * 4;
+  job->col_len = mtable_size + COL_PADDING;
+  job->ts_col = g_new0(gint32, (size_t)job->n_col * job->col_len);
+  job->n_ts = g_new0(gint32, job->col_len);
+  job->row_id = g_new0(obj_id_t, job->col_len);
+
+  job->pair_cap = 1024;
+  job->pairs = malloc(sizeof(obj_id_t) * job->pair_cap * 2);
+
+  return job;
+}
+
+void Mithril_mining_job_free(Mithril_mining_job_t *job) {
+  g_free(job->table);
+  g_free(job->table_buf);
+  g_free(job->sort_keys);
+  g_free(job->ts_col);
+  g_free(job->n_ts);
+  g_free(job->row_id);
+  free(job->pairs);
+  g_free(job);
+}
+
+static int sort_key_cmp(const void *a, const void *b) {
+  guint64 ka = *(const guint64 *)a, kb = *(const guint64 *)b;
+  return (ka > kb) - (ka < kb);
+}
+
+/**
+ sort the rows by the first timestamp of each row, rows with the same first
+ timestamp keep their order
+
+ @param job
+ */
+static void sort_rows(Mithril_mining_job_t *job) {
+  size_t row_byte = sizeof(TS_REPRESENTATION) * job->row_len;
+
+  /* the row number in the low bits makes the keys unique */
+  for (gint i = 0; i < job->n_row; i++) {
+    job->sort_keys[i] = ((guint64)GET_NTH_TS(job->table + (size_t)i * job->row_len, 1) << 32) | (guint64)i;
+  }
+  qsort(job->sort_keys, job->n_row, sizeof(guint64), sort_key_cmp);
+
+  for (gint i = 0; i < job->n_row; i++) {
+    gint src = (gint)(job->sort_keys[i] & 0xffffffffULL);
+    memcpy(job->table_buf + (size_t)i * job->row_len, job->table + (size_t)src * job->row_len, row_byte);
+  }
+  gint64 *tmp = job->table;
+  job->table = job->table_buf;
+  job->table_buf = tmp;
+}
+
+/* the number of timestamps in a row, counted until the first empty integer */
+static inline gint32 total_num_of_ts(const gint64 *row, gint row_len) {
+  gint32 count = 0;
+  for (gint i = 1; i < row_len; i++) {
+    gint32 t = NUM_OF_TS(row[i]);
+    if (t == 0) return count;
+    count += t;
+  }
+  return count;
+}
+
+/**
+ decode the timestamps into columns, GET_NTH_TS is used as in the row-wise
+ comparison so that the same timestamps are compared
+
+ @param job
+ */
+static void decode_rows(Mithril_mining_job_t *job) {
+  for (gint r = 0; r < job->n_row; r++) {
+    gint64 *row = job->table + (size_t)r * job->row_len;
+    job->row_id[r] = (obj_id_t)row[0];
+    job->n_ts[r] = MIN(total_num_of_ts(row, job->row_len), job->n_col);
+    for (gint k = 1; k <= job->n_col; k++) {
+      TS_COL(job, k)[r] = GET_NTH_TS(row, k);
+    }
+  }
+
+  /* the padding rows are never in the lookahead window */
+  for (gint r = job->n_row; r < job->n_row + COL_PADDING; r++) {
+    job->row_id[r] = 0;
+    job->n_ts[r] = 0;
+    TS_COL(job, 1)[r] = INT32_MAX;
+    for (gint k = 2; k <= job->n_col; k++) {
+      TS_COL(job, k)[r] = 0;
+    }
+  }
+}
+
+static inline void add_pair(Mithril_mining_job_t *job, obj_id_t src, obj_id_t dst) {
+  if (job->n_pair == job->pair_cap) {
+    job->pair_cap *= 2;
+    job->pairs = realloc(job->pairs, sizeof(obj_id_t) * job->pair_cap * 2);
+  }
+  job->pairs[job->n_pair * 2] = src;
+  job->pairs[job->n_pair * 2 + 1] = dst;
+  job->n_pair++;
+}
+
+/**
+ two rows are associated if the number of timestamps differs by at most
+ confidence, no more than confidence pairs of timestamps are further than
+ lookahead_range apart, and one pair of timestamps is next to each other
+ (or it is the first candidate of the row), the last timestamp of the
+ shorter row is not compared
+ */
+static void mine_scalar(Mithril_mining_job_t *job) {
+  const gint32 *first_ts = TS_COL(job, 1);
+  gint32 lookahead = job->lookahead_range, confidence = job->confidence;
+
+  for (gint i = 0; i < job->n_row - 1; i++) {
+    gint32 t1 = first_ts[i], n1 = job->n_ts[i];
+    gboolean first_flag = TRUE;
+
+    for (gint j = i + 1; j < job->n_row; j++) {
+      gint32 dt = first_ts[j] - t1;
+      if (dt > lookahead) break;
+      gint32 n2 = job->n_ts[j];
+      if (ABS(n1 - n2) > confidence) continue;
+
+      gint32 shorter = MIN(n1, n2);
+      gboolean associated = first_flag || (shorter == 1 && dt == 1);
+      first_flag = FALSE;
+
+      gint32 error = 0;
+      for (gint k = 1; k < shorter; k++) {
+        gint32 d = ABS(TS_COL(job, k)[j] - TS_COL(job, k)[i]);
+        error += d > lookahead;
+        associated |= d == 1;
+      }
+      if (associated && error <= confidence) {
+        add_pair(job, job->row_id[i], job->row_id[j]);
+      }
+    }
+  }
+}
+
+#ifdef MITHRIL_MINING_X86
+/* the lanes of the candidate mask, in the order of the rows */
+static inline void add_pairs_in_mask(Mithril_mining_job_t *job, gint i, gint j0, uint32_t mask) {
+  while (mask != 0) {
+    add_pair(job, job->row_id[i], job->row_id[j0 + __builtin_ctz(mask)]);
+    mask &= mask - 1;
+  }
+}
+
+static void mine_sse2(Mithril_mining_job_t *job) {
+  const gint32 *first_ts = TS_COL(job, 1);
+  const __m128i lookahead = _mm_set1_epi32(job->lookahead_range);
+  const __m128i neg_lookahead = _mm_set1_epi32(-job->lookahead_range);
+  const __m128i confidence = _mm_set1_epi32(job->confidence);
+  const __m128i neg_confidence = _mm_set1_epi32(-job->confidence);
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i neg_one = _mm_set1_epi32(-1);
+
+  for (gint i = 0; i < job->n_row - 1; i++) {
+    gint32 n1 = job->n_ts[i];
+    const __m128i t1 = _mm_set1_epi32(first_ts[i]);
+    const __m128i vn1 = _mm_set1_epi32(n1);
+    gboolean first_flag = TRUE;
+
+    for (gint j0 = i + 1; j0 < job->n_row; j0 += 4) {
+      __m128i dt = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(first_ts + j0)), t1);
+      uint32_t out_of_window = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(dt, lookahead)));
+
+      __m128i n2 = _mm_loadu_si128((const __m128i *)(job->n_ts + j0));
+      __m128i dn = _mm_sub_epi32(vn1, n2);
+      __m128i bad_n = _mm_or_si128(_mm_cmpgt_epi32(dn, confidence), _mm_cmplt_epi32(dn, neg_confidence));
+      uint32_t candidate = ~(out_of_window | _mm_movemask_ps(_mm_castsi128_ps(bad_n))) & 0xfu;
+
+      if (candidate != 0) {
+        /* SSE2 has no min_epi32 */
+        __m128i n2_is_shorter = _mm_cmplt_epi32(n2, vn1);
+        __m128i shorter = _mm_or_si128(_mm_and_si128(n2_is_shorter, n2), _mm_andnot_si128(n2_is_shorter, vn1));
+        __m128i error = _mm_setzero_si128();
+        __m128i near = _mm_setzero_si128();
+        for (gint k = 1; k < n1; k++) {
+          const gint32 *col = TS_COL(job, k);
+          __m128i valid = _mm_cmpgt_epi32(shorter, _mm_set1_epi32(k));
+          __m128i d = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(col + j0)), _mm_set1_epi32(col[i]));
+          __m128i far = _mm_or_si128(_mm_cmpgt_epi32(d, lookahead), _mm_cmplt_epi32(d, neg_lookahead));
+          error = _mm_sub_epi32(error, _mm_and_si128(far, valid));
+          __m128i next_to = _mm_or_si128(_mm_cmpeq_epi32(d, one), _mm_cmpeq_epi32(d, neg_one));
+          near = _mm_or_si128(near, _mm_and_si128(next_to, valid));
+        }
+        near = _mm_or_si128(near, _mm_and_si128(_mm_cmpeq_epi32(shorter, one), _mm_cmpeq_epi32(dt, one)));
+
+        uint32_t associated = _mm_movemask_ps(_mm_castsi128_ps(near));
+        if (first_flag) {
+          associated |= candidate & (0u - candidate);
+          first_flag = FALSE;
+        }
+        uint32_t too_many_error = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(error, confidence)));
+        add_pairs_in_mask(job, i, j0, candidate & associated & ~too_many_error);
+      }
+      /* the rows are sorted, so the following rows are out of the window */
+      if (out_of_window != 0) break;
+    }
+  }
+}
+
+__attribute__((target("avx2"))) static void mine_avx2(Mithril_mining_job_t *job) {
+  const gint32 *first_ts = TS_COL(job, 1);
+  const __m256i lookahead = _mm256_set1_epi32(job->lookahead_range);
+  const __m256i confidence = _mm256_set1_epi32(job->confidence);
+  const __m256i one = _mm256_set1_epi32(1);
+
+  for (gint i = 0; i < job->n_row - 1; i++) {
+    gint32 n1 = job->n_ts[i];
+    const __m256i t1 = _mm256_set1_epi32(first_ts[i]);
+    const __m256i vn1 = _mm256_set1_epi32(n1);
+    gboolean first_flag = TRUE;
+
+    for (gint j0 = i + 1; j0 < job->n_row; j0 += 8) {
+      __m256i dt = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(first_ts + j0)), t1);
+      uint32_t out_of_window = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(dt, lookahead)));
+
+      __m256i n2 = _mm256_loadu_si256((const __m256i *)(job->n_ts + j0));
+      __m256i dn = _mm256_abs_epi32(_mm256_sub_epi32(vn1, n2));
+      uint32_t bad_n = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(dn, confidence)));
+      uint32_t candidate = ~(out_of_window | bad_n) & 0xffu;
+
+      if (candidate != 0) {
+        __m256i shorter = _mm256_min_epi32(vn1, n2);
+        __m256i error = _mm256_setzero_si256();
+        __m256i near = _mm256_setzero_si256();
+        for (gint k = 1; k < n1; k++) {
+          const gint32 *col = TS_COL(job, k);
+          __m256i valid = _mm256_cmpgt_epi32(shorter, _mm256_set1_epi32(k));
+          __m256i d = _mm256_abs_epi32(
+              _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(col + j0)), _mm256_set1_epi32(col[i])));
+          error = _mm256_sub_epi32(error, _mm256_and_si256(_mm256_cmpgt_epi32(d, lookahead), valid));
+          near = _mm256_or_si256(near, _mm256_and_si256(_mm256_cmpeq_epi32(d, one), valid));
+        }
+        near = _mm256_or_si256(near,
+                               _mm256_and_si256(_mm256_cmpeq_epi32(shorter, one), _mm256_cmpeq_epi32(dt, one)));
+
+        uint32_t associated = _mm256_movemask_ps(_mm256_castsi256_ps(near));
+        if (first_flag) {
+          associated |= candidate & (0u - candidate);
+          first_flag = FALSE;
+        }
+        uint32_t too_many_error =
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(error, confidence)));
+        add_pairs_in_mask(job, i, j0, candidate & associated & ~too_many_error);
+      }
+      if (out_of_window != 0) break;
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) static void mine_avx512(Mithril_mining_job_t *job) {
+  const gint32 *first_ts = TS_COL(job, 1);
+  const __m512i lookahead = _mm512_set1_epi32(job->lookahead_range);
+  const __m512i confidence = _mm512_set1_epi32(job->confidence);
+  const __m512i one = _mm512_set1_epi32(1);
+
+  for (gint i = 0; i < job->n_row - 1; i++) {
+    gint32 n1 = job->n_ts[i];
+    const __m512i t1 = _mm512_set1_epi32(first_ts[i]);
+    const __m512i vn1 = _mm512_set1_epi32(n1);
+    gboolean first_flag = TRUE;
+
+    for (gint j0 = i + 1; j0 < job->n_row; j0 += 16) {
+      __m512i dt = _mm512_sub_epi32(_mm512_loadu_si512(first_ts + j0), t1);
+      __mmask16 out_of_window = _mm512_cmpgt_epi32_mask(dt, lookahead);
+
+      __m512i n2 = _mm512_loadu_si512(job->n_ts + j0);
+      __m512i dn = _mm512_abs_epi32(_mm512_sub_epi32(vn1, n2));
+      __mmask16 candidate = ~(out_of_window | _mm512_cmpgt_epi32_mask(dn, confidence));
+
+      if (candidate != 0) {
+        __m512i shorter = _mm512_min_epi32(vn1, n2);
+        __m512i error = _mm512_setzero_si512();
+        __mmask16 near = 0;
+        for (gint k = 1; k < n1; k++) {
+          const gint32 *col = TS_COL(job, k);
+          __mmask16 valid = _mm512_cmpgt_epi32_mask(shorter, _mm512_set1_epi32(k));
+          __m512i d = _mm512_abs_epi32(_mm512_sub_epi32(_mm512_loadu_si512(col + j0), _mm512_set1_epi32(col[i])));
+          error = _mm512_mask_add_epi32(error, valid & _mm512_cmpgt_epi32_mask(d, lookahead), error, one);
+          near |= valid & _mm512_cmpeq_epi32_mask(d, one);
+        }
+        near |= _mm512_cmpeq_epi32_mask(shorter, one) & _mm512_cmpeq_epi32_mask(dt, one);
+
+        uint32_t associated = near;
+        if (first_flag) {
+          associated |= (uint32_t)candidate & (0u - (uint32_t)candidate);
+          first_flag = FALSE;
+        }
+        uint32_t too_many_error = _mm512_cmpgt_epi32_mask(error, confidence);
+        add_pairs_in_mask(job, i, j0, (uint32_t)candidate & associated & ~too_many_error);
+      }
+      if (out_of_window != 0) break;
+    }
+  }
+}
+#endif
+
+void Mithril_mine(Mithril_mining_job_t *job) {
+  double start = now_ms();
+
+  job->n_pair = 0;
+  sort_rows(job);
+  decode_rows(job);
+
+  switch (job->impl) {
+#ifdef MITHRIL_MINING_X86
+    case MINING_IMPL_SSE2:
+      mine_sse2(job);
+      break;
+    case MINING_IMPL_AVX2:
+      mine_avx2(job);
+      break;
+    case MINING_IMPL_AVX512:
+      mine_avx512(job);
+      break;
+#endif
+    default:
+      mine_scalar(job);
+      break;
+  }
+
+  job->mining_ms = now_ms() - start;
+}
+
+#ifdef __cplusplus
+}
+#endif
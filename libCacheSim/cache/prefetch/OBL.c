@@ -118,18 +118,19 @@ static void OBL_prefetch(cache_t *cache, const request_t *req) {
 
   if (OBL_params->do_prefetch) {
     OBL_params->do_prefetch = false;
-    request_t *new_req = new_request();
+    request_t *new_req = prefetcher_get_req(cache->prefetcher);
+    init_request(new_req);
     new_req->obj_size = OBL_params->block_size;
     new_req->obj_id = req->obj_id + 1;
     if (cache->find(cache, new_req, false)) {
-      free_request(new_req);
+      prefetcher_put_req(cache->prefetcher, new_req);
       return;
     }
     while (cache->get_occupied_byte(cache) + OBL_params->block_size > cache->cache_size) {
       cache->evict(cache, req);
     }
     cache->insert(cache, new_req);
-    free_request(new_req);
+    prefetcher_put_req(cache->prefetcher, new_req);
   }
 }
 
@@ -138,6 +139,7 @@ static void free_OBL_prefetcher(prefetcher_t *prefetcher) {
   free(OBL_params->prev_access_block);
 
   my_free(sizeof(OBL_params_t), OBL_params);
+  prefetcher_free_req_pool(prefetcher);
   if (prefetcher->init_params) {
     free(prefetcher->init_params);
   }
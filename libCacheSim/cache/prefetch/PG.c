@@ -38,7 +38,7 @@ extern "C" {
 // ***********************************************************************
 static inline void _graphNode_destroy(gpointer data);
 static inline void _PG_add_to_graph(cache_t *cache, const request_t *req);
-static inline GList *_PG_get_prefetch_list(cache_t *cache, const request_t *req);
+static inline int _PG_get_prefetch_list(cache_t *cache, const request_t *req);
 
 const char *PG_default_params(void) {
   return "lookahead-range=20, "
@@ -82,6 +82,10 @@ static void PG_parse_init_params(const char *cache_specific_params, PG_init_para
 }
 
 static void set_PG_params(PG_params_t *PG_params, PG_init_params_t *init_params, uint64_t cache_size) {
+  if (!(init_params->prefetch_threshold > 0 && init_params->prefetch_threshold <= 1)) {
+    ERROR("pg prefetch-threshold must be in (0, 1], get %lf\n", init_params->prefetch_threshold);
+  }
+
   PG_params->lookahead_range = init_params->lookahead_range;
   PG_params->block_size = init_params->block_size;
   PG_params->cur_metadata_size = 0;
@@ -91,14 +95,19 @@ static void set_PG_params(PG_params_t *PG_params, PG_init_params_t *init_params,
   PG_params->stop_recording = FALSE;
 
   PG_params->graph = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, _graphNode_destroy);
-  PG_params->prefetched = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+  PG_params->prefetched = id_map_init(1024);
   PG_params->past_requests = g_new0(guint64, PG_params->lookahead_range);
 
   PG_params->past_request_pointer = 0;
   PG_params->num_of_hit = 0;
   PG_params->num_of_prefetch = 0;
 
-  PG_params->cache_size_map = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+  PG_params->cache_size_map = id_map_init(1 << 16);
+
+  /* an object is prefetched if it follows the current one in more than
+   * prefetch_threshold of the cases, so there are at most 1 / threshold */
+  PG_params->prefetch_list_size = (int)(1.0 / PG_params->prefetch_threshold) + 1;
+  PG_params->prefetch_list = calloc(PG_params->prefetch_list_size, sizeof(pq_node_t *));
 }
 
 // ***********************************************************************
@@ -120,16 +129,12 @@ static void PG_handle_find(cache_t *cache, const request_t *req, bool hit) {
   PG_params_t *PG_params = (PG_params_t *)(cache->prefetcher->params);
 
   /*use cache_size_map to record the current requested obj's size*/
-  g_hash_table_insert(PG_params->cache_size_map, GINT_TO_POINTER(req->obj_id), GINT_TO_POINTER(req->obj_size));
+  id_map_put(PG_params->cache_size_map, req->obj_id, req->obj_size);
 
   _PG_add_to_graph(cache, req);
 
-  if (g_hash_table_contains(PG_params->prefetched, GINT_TO_POINTER(req->obj_id))) {
+  if (id_map_remove(PG_params->prefetched, req->obj_id)) {
     PG_params->num_of_hit++;
-    g_hash_table_remove(PG_params->prefetched, GINT_TO_POINTER(req->obj_id));
-    if (g_hash_table_contains(PG_params->prefetched, GINT_TO_POINTER(req->obj_id))) {
-      fprintf(stderr, "ERROR found prefetch\n");
-    }
   }
 }
 
@@ -137,13 +142,13 @@ static void PG_handle_find(cache_t *cache, const request_t *req, bool hit) {
  remove this obj from `prefetched` if it was previously prefetched into cache.
 
  @param cache the cache struct
- @param req the request containing the request
+ @param evicted the evicted object
  @return
 */
-void PG_handle_evict(cache_t *cache, const request_t *check_req) {
+void PG_handle_evict(cache_t *cache, const evicted_obj_t *evicted) {
   PG_params_t *PG_params = (PG_params_t *)(cache->prefetcher->params);
 
-  g_hash_table_remove(PG_params->prefetched, GINT_TO_POINTER(check_req->obj_id));
+  id_map_remove(PG_params->prefetched, evicted->obj_id);
 }
 
 /**
@@ -157,15 +162,13 @@ void PG_prefetch(cache_t *cache, const request_t *req) {
   PG_params_t *PG_params = (PG_params_t *)(cache->prefetcher->params);
 
   // begin prefetching
-  GList *prefetch_list = _PG_get_prefetch_list(cache, req);
-  if (prefetch_list) {
-    GList *node = prefetch_list;
-    request_t *new_req = my_malloc(request_t);
+  int n_prefetch = _PG_get_prefetch_list(cache, req);
+  if (n_prefetch > 0) {
+    request_t *new_req = prefetcher_get_req(cache->prefetcher);
     copy_request(new_req, req);
-    while (node) {
-      new_req->obj_id = GPOINTER_TO_INT(node->data);
-      new_req->obj_size =
-          GPOINTER_TO_INT(g_hash_table_lookup(PG_params->cache_size_map, GINT_TO_POINTER(new_req->obj_id)));
+    for (int i = 0; i < n_prefetch; i++) {
+      new_req->obj_id = PG_params->prefetch_list[i]->obj_id;
+      new_req->obj_size = id_map_get(PG_params->cache_size_map, new_req->obj_id, 0);
       if (!cache->find(cache, new_req, false)) {
         while ((long)cache->get_occupied_byte(cache) + new_req->obj_size + cache->obj_md_size >
                (long)cache->cache_size) {
@@ -175,26 +178,26 @@ void PG_prefetch(cache_t *cache, const request_t *req) {
 
         PG_params->num_of_prefetch += 1;
 
-        g_hash_table_insert(PG_params->prefetched, GINT_TO_POINTER(new_req->obj_id), GINT_TO_POINTER(1));
+        id_map_put(PG_params->prefetched, new_req->obj_id, 1);
       }
-      node = node->next;
     }
 
-    my_free(sizeof(request_t), new_req);
-    g_list_free(prefetch_list);
+    prefetcher_put_req(cache->prefetcher, new_req);
   }
 }
 
 void free_PG_prefetcher(prefetcher_t *prefetcher) {
   PG_params_t *PG_params = (PG_params_t *)prefetcher->params;
 
-  g_hash_table_destroy(PG_params->cache_size_map);
+  id_map_free(PG_params->cache_size_map);
   g_hash_table_destroy(PG_params->graph);
-  g_hash_table_destroy(PG_params->prefetched);
+  id_map_free(PG_params->prefetched);
 
   g_free(PG_params->past_requests);
+  free(PG_params->prefetch_list);
 
   my_free(sizeof(PG_params_t), PG_params);
+  prefetcher_free_req_pool(prefetcher);
   if (prefetcher->init_params) {
     free(prefetcher->init_params);
   }
@@ -335,43 +338,43 @@ static inline void _PG_add_to_graph(cache_t *cache, const request_t *req) {
 
  @param cache the cache struct
  @param req the request containing the request
- @return list containing all objs that should be prefetched
+ @return the number of objs that should be prefetched, they are stored in
+ PG_params->prefetch_list from the least to the most likely
  */
-static inline GList *_PG_get_prefetch_list(cache_t *cache, const request_t *req) {
+static inline int _PG_get_prefetch_list(cache_t *cache, const request_t *req) {
   PG_params_t *PG_params = (PG_params_t *)(cache->prefetcher->params);
-  GList *list = NULL;
   graphNode_t *graphNode = g_hash_table_lookup(PG_params->graph, GINT_TO_POINTER(req->obj_id));
 
   if (graphNode == NULL) {
-    return list;
+    return 0;
   }
 
-  GList *pq_node_list = NULL;
+  /* pop in the order of probability, then put the nodes back from the least
+   * likely one */
+  int n = 0;
   while (1) {
     pq_node_t *pqNode = pqueue_pop(graphNode->pq);
-    if (pqNode == NULL) {
+    if (pqNode == NULL || (double)(pqNode->pri.pri) / (graphNode->total_count) <= PG_params->prefetch_threshold) {
       break;
     }
-    if ((double)(pqNode->pri.pri) / (graphNode->total_count) > PG_params->prefetch_threshold) {
-      list = g_list_prepend(list, GINT_TO_POINTER(pqNode->obj_id));
-      pq_node_list = g_list_prepend(pq_node_list, pqNode);
-    } else {
-      //            printf("threshold %lf\n",
-      //            (double)(pqNode->pri)/(graphNode->total_count));
-      break;
+    if (n == PG_params->prefetch_list_size) {
+      PG_params->prefetch_list_size *= 2;
+      PG_params->prefetch_list =
+          realloc(PG_params->prefetch_list, sizeof(pq_node_t *) * PG_params->prefetch_list_size);
     }
+    PG_params->prefetch_list[n++] = pqNode;
   }
 
-  if (pq_node_list) {
-    GList *node = pq_node_list;
-    while (node) {
-      pqueue_insert(graphNode->pq, node->data);
-      node = node->next;
-    }
+  for (int i = 0; i < n / 2; i++) {
+    pq_node_t *tmp = PG_params->prefetch_list[i];
+    PG_params->prefetch_list[i] = PG_params->prefetch_list[n - 1 - i];
+    PG_params->prefetch_list[n - 1 - i] = tmp;
+  }
+  for (int i = 0; i < n; i++) {
+    pqueue_insert(graphNode->pq, PG_params->prefetch_list[i]);
   }
-  g_list_free(pq_node_list);
 
-  return list;
+  return n;
 }
 
 #ifdef __cplusplus
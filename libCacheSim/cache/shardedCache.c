@@ -0,0 +1,246 @@
+//
+//  shardedCache.c
+//  libCacheSim
+//
+//  n shards of one eviction algorithm, each behind its own lock, see
+//  shardedCache.h
+//
+
+#include "../include/libCacheSim/shardedCache.h"
+
+#include "../dataStructure/hash/hash.h"
+#include "../dataStructure/hashtable/hashtable.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void sharded_cache_free(cache_t *cache);
+static bool sharded_cache_get(cache_t *cache, const request_t *req);
+static cache_obj_t *sharded_cache_find(cache_t *cache, const request_t *req, const bool update_cache);
+static bool sharded_cache_can_insert(cache_t *cache, const request_t *req);
+static cache_obj_t *sharded_cache_insert(cache_t *cache, const request_t *req);
+static cache_obj_t *sharded_cache_to_evict(cache_t *cache, const request_t *req);
+static void sharded_cache_evict(cache_t *cache, const request_t *req);
+static bool sharded_cache_remove(cache_t *cache, const obj_id_t obj_id);
+static int64_t sharded_cache_get_occupied_byte(const cache_t *cache);
+static int64_t sharded_cache_get_n_obj(const cache_t *cache);
+static void sharded_cache_print_cache(const cache_t *cache);
+
+/* the shard is chosen by the high bits of the hash of the object id, the hash
+ * tables of the shards use the low bits. remove only has the object id, so the
+ * requests are routed by the object id as well, not by a hash value set by the
+ * caller */
+static inline int shard_of_obj_id(obj_id_t obj_id, int n_shard) {
+  uint64_t hv = get_hash_value_int_64(&obj_id);
+  return (int)(((hv >> 32) * (uint64_t)n_shard) >> 32);
+}
+
+/* a sharded cache is made from an existing cache, it cannot be re-created from
+ * the cache parameters by clone_cache or create_cache_with_new_size */
+static cache_t *sharded_cache_reinit(const common_cache_params_t ccache_params, const char *cache_specific_params) {
+  ERROR("a sharded cache cannot be cloned, shard the new cache with sharded_cache_init instead\n");
+  return NULL;
+}
+
+static cache_t *create_shard(const cache_t *cache, uint64_t shard_size, int hashpower) {
+  common_cache_params_t cc_params = {
+      .cache_size = shard_size,
+      .default_ttl = cache->default_ttl,
+      .hashpower = hashpower,
+      .consider_obj_metadata = cache->obj_md_size == 0 ? false : true,
+  };
+  cache_t *shard = cache->cache_init(cc_params, cache->init_params);
+  if (cache->admissioner != NULL) {
+    shard->admissioner = cache->admissioner->clone(cache->admissioner);
+  }
+  if (cache->prefetcher != NULL) {
+    shard->prefetcher = cache->prefetcher->clone(cache->prefetcher, shard_size);
+  }
+  shard->future_stack_dist = cache->future_stack_dist;
+  shard->future_stack_dist_array_size = cache->future_stack_dist_array_size;
+  return shard;
+}
+
+cache_t *sharded_cache_init(const cache_t *cache, int n_shard) {
+  if (n_shard <= 0) {
+    ERROR("the number of shards must be positive, got %d\n", n_shard);
+  }
+  if ((uint64_t)cache->cache_size < (uint64_t)n_shard) {
+    ERROR("cache size %ld is too small for %d shards\n", (long)cache->cache_size, n_shard);
+  }
+
+  /* the wrapper does not store objects, so its hash table is tiny */
+  common_cache_params_t cc_params = {
+      .cache_size = cache->cache_size,
+      .default_ttl = cache->default_ttl,
+      .hashpower = 4,
+      .consider_obj_metadata = cache->obj_md_size == 0 ? false : true,
+  };
+  cache_t *sharded = cache_struct_init("Sharded", cc_params, cache->init_params);
+  sharded->cache_init = sharded_cache_reinit;
+  sharded->cache_free = sharded_cache_free;
+  sharded->get = sharded_cache_get;
+  sharded->find = sharded_cache_find;
+  sharded->can_insert = sharded_cache_can_insert;
+  sharded->insert = sharded_cache_insert;
+  sharded->evict = sharded_cache_evict;
+  sharded->remove = sharded_cache_remove;
+  sharded->to_evict = sharded_cache_to_evict;
+  sharded->get_occupied_byte = sharded_cache_get_occupied_byte;
+  sharded->get_n_obj = sharded_cache_get_n_obj;
+  sharded->print_cache = sharded_cache_print_cache;
+  sharded->obj_md_size = cache->obj_md_size;
+  sharded->evict_in_sub_cache = true;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+  snprintf(sharded->cache_name, CACHE_NAME_ARRAY_LEN, "%s-shard%d", cache->cache_name, n_shard);
+#pragma GCC diagnostic pop
+
+  sharded_cache_params_t *params = my_malloc(sharded_cache_params_t);
+  params->n_shard = n_shard;
+  params->shards = my_malloc_n(cache_t *, n_shard);
+  params->locks = my_malloc_n(GMutex, n_shard);
+  sharded->eviction_params = params;
+
+  /* each shard holds about 1/n_shard of the objects */
+  int hashpower = cache->hashtable->hashpower;
+  for (int n = n_shard; n > 1 && hashpower > 16; n >>= 1) {
+    hashpower -= 1;
+  }
+  uint64_t shard_size = cache->cache_size / n_shard;
+  for (int i = 0; i < n_shard; i++) {
+    params->shards[i] = create_shard(cache, shard_size, hashpower);
+    g_mutex_init(&params->locks[i]);
+  }
+
+  return sharded;
+}
+
+int sharded_cache_shard_of(const cache_t *cache, const request_t *req) {
+  const sharded_cache_params_t *params = cache->eviction_params;
+  return shard_of_obj_id(req->obj_id, params->n_shard);
+}
+
+bool is_sharded_cache(const cache_t *cache) { return cache->cache_free == sharded_cache_free; }
+
+static void sharded_cache_free(cache_t *cache) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  for (int i = 0; i < params->n_shard; i++) {
+    params->shards[i]->cache_free(params->shards[i]);
+    g_mutex_clear(&params->locks[i]);
+  }
+  my_free(sizeof(cache_t *) * params->n_shard, params->shards);
+  my_free(sizeof(GMutex) * params->n_shard, params->locks);
+  my_free(sizeof(sharded_cache_params_t), params);
+  cache_struct_free(cache);
+}
+
+static bool sharded_cache_get(cache_t *cache, const request_t *req) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = sharded_cache_shard_of(cache, req);
+  __atomic_fetch_add(&cache->n_req, 1, __ATOMIC_RELAXED);
+
+  g_mutex_lock(&params->locks[i]);
+  bool hit = params->shards[i]->get(params->shards[i], req);
+  g_mutex_unlock(&params->locks[i]);
+  return hit;
+}
+
+static cache_obj_t *sharded_cache_find(cache_t *cache, const request_t *req, const bool update_cache) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = sharded_cache_shard_of(cache, req);
+
+  g_mutex_lock(&params->locks[i]);
+  cache_obj_t *obj = params->shards[i]->find(params->shards[i], req, update_cache);
+  g_mutex_unlock(&params->locks[i]);
+  return obj;
+}
+
+static bool sharded_cache_can_insert(cache_t *cache, const request_t *req) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = sharded_cache_shard_of(cache, req);
+
+  g_mutex_lock(&params->locks[i]);
+  bool can_insert = params->shards[i]->can_insert(params->shards[i], req);
+  g_mutex_unlock(&params->locks[i]);
+  return can_insert;
+}
+
+static cache_obj_t *sharded_cache_insert(cache_t *cache, const request_t *req) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = sharded_cache_shard_of(cache, req);
+
+  g_mutex_lock(&params->locks[i]);
+  cache_obj_t *obj = params->shards[i]->insert(params->shards[i], req);
+  g_mutex_unlock(&params->locks[i]);
+  return obj;
+}
+
+/* evict from the shard of the request, which is the shard it will be
+ * inserted into */
+static cache_obj_t *sharded_cache_to_evict(cache_t *cache, const request_t *req) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = sharded_cache_shard_of(cache, req);
+
+  g_mutex_lock(&params->locks[i]);
+  cache_obj_t *obj = params->shards[i]->to_evict(params->shards[i], req);
+  g_mutex_unlock(&params->locks[i]);
+  return obj;
+}
+
+static void sharded_cache_evict(cache_t *cache, const request_t *req) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = sharded_cache_shard_of(cache, req);
+
+  g_mutex_lock(&params->locks[i]);
+  params->shards[i]->evict(params->shards[i], req);
+  g_mutex_unlock(&params->locks[i]);
+}
+
+static bool sharded_cache_remove(cache_t *cache, const obj_id_t obj_id) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int i = shard_of_obj_id(obj_id, params->n_shard);
+
+  g_mutex_lock(&params->locks[i]);
+  bool removed = params->shards[i]->remove(params->shards[i], obj_id);
+  g_mutex_unlock(&params->locks[i]);
+  return removed;
+}
+
+static int64_t sharded_cache_get_occupied_byte(const cache_t *cache) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int64_t occupied_byte = 0;
+  for (int i = 0; i < params->n_shard; i++) {
+    g_mutex_lock(&params->locks[i]);
+    occupied_byte += params->shards[i]->get_occupied_byte(params->shards[i]);
+    g_mutex_unlock(&params->locks[i]);
+  }
+  return occupied_byte;
+}
+
+static int64_t sharded_cache_get_n_obj(const cache_t *cache) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  int64_t n_obj = 0;
+  for (int i = 0; i < params->n_shard; i++) {
+    g_mutex_lock(&params->locks[i]);
+    n_obj += params->shards[i]->get_n_obj(params->shards[i]);
+    g_mutex_unlock(&params->locks[i]);
+  }
+  return n_obj;
+}
+
+static void sharded_cache_print_cache(const cache_t *cache) {
+  sharded_cache_params_t *params = cache->eviction_params;
+  for (int i = 0; i < params->n_shard; i++) {
+    printf("shard %d: %ld objects, %ld bytes\n", i, (long)params->shards[i]->get_n_obj(params->shards[i]),
+           (long)params->shards[i]->get_occupied_byte(params->shards[i]));
+    if (params->shards[i]->print_cache != NULL) {
+      params->shards[i]->print_cache(params->shards[i]);
+    }
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,157 @@
+//
+//  blockedBloom.c
+//  libCacheSim
+//
+//  see blockedBloom.h
+//
+
+#include "blockedBloom.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BLOCKED_BLOOM_X86
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define N_LANE 8
+
+/* odd constants that spread the key into the eight lanes */
+static const uint32_t SALT[N_LANE] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+/* the high half of the hash picks the block, the low half the bits */
+static inline uint32_t *block_of(const blocked_bloom_t *bloom, uint64_t hash) {
+  uint64_t block = ((hash >> 32) * bloom->n_block) >> 32;
+  return &bloom->lanes[block * N_LANE];
+}
+
+static bool contains_scalar(const uint32_t *lanes, uint32_t key) {
+  for (int i = 0; i < N_LANE; i++) {
+    uint32_t bit = 1U << ((key * SALT[i]) >> 27);
+    if ((lanes[i] & bit) == 0) return false;
+  }
+  return true;
+}
+
+static bool insert_scalar(uint32_t *lanes, uint32_t key) {
+  uint32_t missing = 0;
+  for (int i = 0; i < N_LANE; i++) {
+    uint32_t bit = 1U << ((key * SALT[i]) >> 27);
+    missing |= ~lanes[i] & bit;
+    lanes[i] |= bit;
+  }
+  return missing != 0;
+}
+
+#ifdef BLOCKED_BLOOM_X86
+__attribute__((target("avx2"))) static inline __m256i make_mask_avx2(uint32_t key) {
+  const __m256i salt = _mm256_loadu_si256((const __m256i *)SALT);
+  __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), salt), 27);
+  return _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+}
+
+__attribute__((target("avx2"))) static bool contains_avx2(const uint32_t *lanes, uint32_t key) {
+  __m256i block = _mm256_load_si256((const __m256i *)lanes);
+  return _mm256_testc_si256(block, make_mask_avx2(key));
+}
+
+__attribute__((target("avx2"))) static bool insert_avx2(uint32_t *lanes, uint32_t key) {
+  __m256i block = _mm256_load_si256((const __m256i *)lanes);
+  __m256i mask = make_mask_avx2(key);
+  bool present = _mm256_testc_si256(block, mask);
+  _mm256_store_si256((__m256i *)lanes, _mm256_or_si256(block, mask));
+  return !present;
+}
+#endif
+
+double blocked_bloom_expected_fpr(uint64_t n_block, int64_t n_key) {
+  /* the number of keys in a block is Poisson distributed, a block with i
+   * keys gives a false positive if the probed bit of every lane is set */
+  double lambda = (double)n_key / (double)n_block;
+  double p_load = exp(-lambda);
+  double fpr = 0;
+  int max_load = (int)(lambda + 12 * sqrt(lambda) + 32);
+  for (int i = 0; i <= max_load; i++) {
+    double lane_fpr = 1 - pow(1 - 1.0 / 32, i);
+    fpr += p_load * pow(lane_fpr, N_LANE);
+    p_load *= lambda / (i + 1);
+  }
+  return fpr;
+}
+
+blocked_bloom_t *blocked_bloom_init(int64_t n_key, double fpr) {
+  if (n_key < 1) n_key = 1;
+
+  /* the smallest filter that meets the false positive rate */
+  uint64_t n_block = 2;
+  for (double bits_per_key = 4; bits_per_key <= 64; bits_per_key += 0.5) {
+    n_block = (uint64_t)ceil((double)n_key * bits_per_key / 256);
+    /* two blocks per cache line */
+    n_block = (n_block + 1) & ~1ULL;
+    if (blocked_bloom_expected_fpr(n_block, n_key) <= fpr) break;
+  }
+  if (n_block > UINT32_MAX) {
+    ERROR("blocked bloom filter: %lu blocks is too large\n", (unsigned long)n_block);
+  }
+
+  blocked_bloom_t *bloom = calloc(1, sizeof(blocked_bloom_t));
+  bloom->n_block = n_block;
+  bloom->lanes = aligned_alloc(64, n_block * N_LANE * sizeof(uint32_t));
+  if (bloom->lanes == NULL) {
+    ERROR("blocked bloom filter: failed to allocate %lu blocks\n", (unsigned long)n_block);
+  }
+  blocked_bloom_clear(bloom);
+
+#ifdef BLOCKED_BLOOM_X86
+  bloom->use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+  return bloom;
+}
+
+void blocked_bloom_free(blocked_bloom_t *bloom) {
+  free(bloom->lanes);
+  free(bloom);
+}
+
+bool blocked_bloom_contains(const blocked_bloom_t *bloom, uint64_t hash) {
+  const uint32_t *lanes = block_of(bloom, hash);
+#ifdef BLOCKED_BLOOM_X86
+  if (bloom->use_avx2) return contains_avx2(lanes, (uint32_t)hash);
+#endif
+  return contains_scalar(lanes, (uint32_t)hash);
+}
+
+bool blocked_bloom_insert(blocked_bloom_t *bloom, uint64_t hash) {
+  uint32_t *lanes = block_of(bloom, hash);
+  bool is_new;
+#ifdef BLOCKED_BLOOM_X86
+  if (bloom->use_avx2) {
+    is_new = insert_avx2(lanes, (uint32_t)hash);
+  } else {
+    is_new = insert_scalar(lanes, (uint32_t)hash);
+  }
+#else
+  is_new = insert_scalar(lanes, (uint32_t)hash);
+#endif
+  bloom->n_insert += is_new;
+  return is_new;
+}
+
+void blocked_bloom_clear(blocked_bloom_t *bloom) {
+  memset(bloom->lanes, 0, bloom->n_block * N_LANE * sizeof(uint32_t));
+  bloom->n_insert = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,64 @@
+//
+//  blockedBloom.h
+//  libCacheSim
+//
+//  a split block bloom filter (the layout used by Parquet and Impala), used
+//  by the bloom filter admissioner
+//
+//  the filter is an array of 256-bit blocks of eight 32-bit lanes, a key
+//  selects one block and sets one bit in each lane, so a lookup or an insert
+//  touches half a cache line and the eight bit positions are computed and
+//  tested with a few vector instructions (AVX2 when the CPU supports it)
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct blocked_bloom {
+  /* n_block * 8 lanes, aligned to 64 bytes */
+  uint32_t *lanes;
+  uint64_t n_block;
+  /* the number of inserted keys that were not already in the filter */
+  int64_t n_insert;
+  bool use_avx2;
+} blocked_bloom_t;
+
+/**
+ * @brief create a filter sized so that it has at most the given false
+ * positive rate after n_key distinct keys are inserted
+ */
+blocked_bloom_t *blocked_bloom_init(int64_t n_key, double fpr);
+
+void blocked_bloom_free(blocked_bloom_t *bloom);
+
+/**
+ * @brief check whether a key is in the filter
+ *
+ * @param hash a 64-bit hash of the key, e.g., get_hash_value_int_64
+ */
+bool blocked_bloom_contains(const blocked_bloom_t *bloom, uint64_t hash);
+
+/**
+ * @brief add a key
+ *
+ * @return true if the key was not in the filter before
+ */
+bool blocked_bloom_insert(blocked_bloom_t *bloom, uint64_t hash);
+
+void blocked_bloom_clear(blocked_bloom_t *bloom);
+
+static inline size_t blocked_bloom_n_byte(const blocked_bloom_t *bloom) { return bloom->n_block * 32; }
+
+/* the expected false positive rate of n_block blocks holding n_key keys */
+double blocked_bloom_expected_fpr(uint64_t n_block, int64_t n_key);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,260 @@
+//
+//  bucketQueue.c
+//  libCacheSim
+//
+//  see bucketQueue.h
+//
+
+#include "bucketQueue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bucket_queue_t *bucket_queue_init(bool max_first, bool exact) {
+  bucket_queue_t *bq = calloc(1, sizeof(bucket_queue_t));
+  bq->max_first = max_first;
+  bq->exact = exact;
+  return bq;
+}
+
+void bucket_queue_free(bucket_queue_t *bq) {
+  for (int i = 0; i < BUCKET_QUEUE_N_BUCKET; i++) {
+    free(bq->buckets[i].heap);
+  }
+  free(bq);
+}
+
+static inline int key_to_bucket(double key) {
+  if (!(key >= 1.0)) return 0;
+  /* the exponent of the double is floor(log2(key)) */
+  uint64_t bits;
+  memcpy(&bits, &key, sizeof(bits));
+  int exponent = (int)((bits >> 52) & 0x7ff) - 1023;
+  if (exponent < 0) return 0;
+  return exponent + 1 < BUCKET_QUEUE_N_BUCKET ? exponent + 1 : BUCKET_QUEUE_N_BUCKET - 1;
+}
+
+/* whether a is evicted before b */
+static inline bool before(const bucket_queue_t *bq, const cache_obj_t *a, const cache_obj_t *b) {
+  double key_a = a->bucket_queue.key, key_b = b->bucket_queue.key;
+  if (key_a != key_b) {
+    return bq->max_first ? key_a > key_b : key_a < key_b;
+  }
+  return a->bucket_queue.seq < b->bucket_queue.seq;
+}
+
+/* the bucket with the best keys */
+static inline int first_bucket(uint64_t non_empty, bool max_first) {
+  if (non_empty == 0) return -1;
+  return max_first ? 63 - __builtin_clzll(non_empty) : __builtin_ctzll(non_empty);
+}
+
+/**************************** the heap of a bucket ****************************/
+static inline void heap_set(bucket_queue_bucket_t *b, int64_t pos, cache_obj_t *obj) {
+  b->heap[pos] = obj;
+  obj->bucket_queue.heap_pos = (int32_t)pos;
+}
+
+static void heap_sift_up(const bucket_queue_t *bq, bucket_queue_bucket_t *b, int64_t pos) {
+  cache_obj_t *obj = b->heap[pos];
+  while (pos > 0) {
+    int64_t parent = (pos - 1) / 2;
+    if (!before(bq, obj, b->heap[parent])) break;
+    heap_set(b, pos, b->heap[parent]);
+    pos = parent;
+  }
+  heap_set(b, pos, obj);
+}
+
+static void heap_sift_down(const bucket_queue_t *bq, bucket_queue_bucket_t *b, int64_t pos) {
+  cache_obj_t *obj = b->heap[pos];
+  while (true) {
+    int64_t child = pos * 2 + 1;
+    if (child >= b->n_obj) break;
+    if (child + 1 < b->n_obj && before(bq, b->heap[child + 1], b->heap[child])) {
+      child += 1;
+    }
+    if (!before(bq, b->heap[child], obj)) break;
+    heap_set(b, pos, b->heap[child]);
+    pos = child;
+  }
+  heap_set(b, pos, obj);
+}
+
+static void heap_reserve(bucket_queue_bucket_t *b, int64_t n) {
+  if (n <= b->heap_capacity) return;
+  int64_t capacity = b->heap_capacity == 0 ? 1024 : b->heap_capacity;
+  while (capacity < n) capacity *= 2;
+  b->heap = realloc(b->heap, sizeof(cache_obj_t *) * capacity);
+  if (b->heap == NULL) {
+    ERROR("bucket queue: failed to allocate a heap of %ld objects\n", (long)capacity);
+  }
+  b->heap_capacity = capacity;
+}
+
+/* move the objects of the list into the heap */
+static void heapify_bucket(const bucket_queue_t *bq, bucket_queue_bucket_t *b) {
+  heap_reserve(b, b->n_obj);
+  int64_t pos = 0;
+  for (cache_obj_t *obj = b->head; obj != NULL; obj = obj->queue.next) {
+    heap_set(b, pos++, obj);
+  }
+  DEBUG_ASSERT(pos == b->n_obj);
+  b->head = b->tail = NULL;
+  b->is_heap = true;
+  for (int64_t i = b->n_obj / 2 - 1; i >= 0; i--) {
+    heap_sift_down(bq, b, i);
+  }
+}
+
+/******************************************************************************/
+void bucket_queue_insert(bucket_queue_t *bq, cache_obj_t *obj, double key) {
+  DEBUG_ASSERT(key >= 0);
+  int idx = key_to_bucket(key);
+  bucket_queue_bucket_t *b = &bq->buckets[idx];
+  obj->bucket_queue.key = key;
+  obj->bucket_queue.seq = bq->n_insert++;
+  obj->bucket_queue.bucket = (int8_t)idx;
+
+  b->n_obj += 1;
+  bq->n_obj += 1;
+  bq->non_empty |= 1ull << idx;
+  if (b->is_heap) {
+    heap_reserve(b, b->n_obj);
+    heap_set(b, b->n_obj - 1, obj);
+    heap_sift_up(bq, b, b->n_obj - 1);
+  } else {
+    b->same_key = b->n_obj == 1 || (b->same_key && b->head->bucket_queue.key == key);
+    append_obj_to_tail(&b->head, &b->tail, obj);
+  }
+}
+
+void bucket_queue_remove(bucket_queue_t *bq, cache_obj_t *obj) {
+  int idx = obj->bucket_queue.bucket;
+  bucket_queue_bucket_t *b = &bq->buckets[idx];
+  DEBUG_ASSERT(b->n_obj > 0);
+  b->n_obj -= 1;
+  bq->n_obj -= 1;
+  if (b->is_heap) {
+    int64_t pos = obj->bucket_queue.heap_pos;
+    DEBUG_ASSERT(b->heap[pos] == obj);
+    if (pos != b->n_obj) {
+      cache_obj_t *last = b->heap[b->n_obj];
+      heap_set(b, pos, last);
+      if (pos > 0 && before(bq, last, b->heap[(pos - 1) / 2])) {
+        heap_sift_up(bq, b, pos);
+      } else {
+        heap_sift_down(bq, b, pos);
+      }
+    }
+  } else {
+    remove_obj_from_list(&b->head, &b->tail, obj);
+  }
+  if (b->n_obj == 0) {
+    b->is_heap = false;
+    bq->non_empty &= ~(1ull << idx);
+  }
+}
+
+void bucket_queue_update(bucket_queue_t *bq, cache_obj_t *obj, double key) {
+  bucket_queue_remove(bq, obj);
+  bucket_queue_insert(bq, obj, key);
+}
+
+cache_obj_t *bucket_queue_peek(bucket_queue_t *bq) {
+  int idx = first_bucket(bq->non_empty, bq->max_first);
+  if (idx < 0) return NULL;
+
+  bucket_queue_bucket_t *b = &bq->buckets[idx];
+  if (!bq->exact || (!b->is_heap && b->same_key)) {
+    return b->head;
+  }
+  if (!b->is_heap) {
+    heapify_bucket(bq, b);
+  }
+  return b->heap[0];
+}
+
+cache_obj_t *bucket_queue_pop(bucket_queue_t *bq) {
+  cache_obj_t *obj = bucket_queue_peek(bq);
+  if (obj != NULL) {
+    bucket_queue_remove(bq, obj);
+  }
+  return obj;
+}
+
+/* visit the heap best-first, the frontier is a heap of heap positions */
+static bool for_each_in_heap(const bucket_queue_t *bq, bucket_queue_bucket_t *b,
+                             bool (*func)(cache_obj_t *obj, void *user_data),
+                             void *user_data) {
+  int64_t capacity = 64, n = 1;
+  int64_t *frontier = malloc(sizeof(int64_t) * capacity);
+  frontier[0] = 0;
+  bool cont = true;
+  while (n > 0 && cont) {
+    int64_t pos = frontier[0];
+    frontier[0] = frontier[--n];
+    for (int64_t i = 0;;) {
+      int64_t c = i * 2 + 1;
+      if (c >= n) break;
+      if (c + 1 < n && before(bq, b->heap[frontier[c + 1]], b->heap[frontier[c]])) c += 1;
+      if (!before(bq, b->heap[frontier[c]], b->heap[frontier[i]])) break;
+      int64_t t = frontier[i];
+      frontier[i] = frontier[c];
+      frontier[c] = t;
+      i = c;
+    }
+
+    cont = func(b->heap[pos], user_data);
+
+    for (int64_t child = pos * 2 + 1; child <= pos * 2 + 2 && child < b->n_obj; child++) {
+      if (n == capacity) {
+        capacity *= 2;
+        frontier = realloc(frontier, sizeof(int64_t) * capacity);
+      }
+      int64_t i = n++;
+      frontier[i] = child;
+      while (i > 0 && before(bq, b->heap[frontier[i]], b->heap[frontier[(i - 1) / 2]])) {
+        int64_t t = frontier[i];
+        frontier[i] = frontier[(i - 1) / 2];
+        frontier[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
+      }
+    }
+  }
+  free(frontier);
+  return cont;
+}
+
+void bucket_queue_for_each(bucket_queue_t *bq,
+                           bool (*func)(cache_obj_t *obj, void *user_data),
+                           void *user_data) {
+  uint64_t non_empty = bq->non_empty;
+  while (non_empty != 0) {
+    int idx = first_bucket(non_empty, bq->max_first);
+    non_empty &= ~(1ull << idx);
+
+    bucket_queue_bucket_t *b = &bq->buckets[idx];
+    if (!bq->exact || (!b->is_heap && b->same_key)) {
+      for (cache_obj_t *obj = b->head; obj != NULL; obj = obj->queue.next) {
+        if (!func(obj, user_data)) return;
+      }
+      continue;
+    }
+    if (!b->is_heap) {
+      heapify_bucket(bq, b);
+    }
+    if (!for_each_in_heap(bq, b, func, user_data)) return;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,113 @@
+//
+//  bucketQueue.h
+//  libCacheSim
+//
+//  a priority queue of cache objects bucketed by the log2 of the key, for the
+//  size-aware algorithms that evict the largest object (Size) or the object
+//  with the lowest score (GDSF)
+//
+//  a bitmap of the non-empty buckets finds the first bucket to evict from with
+//  one count leading or trailing zeros. In the approximate mode, each bucket
+//  is a list linked through obj->queue and its objects are evicted in FIFO
+//  order, so every operation is O(1) and the evicted object is within a factor
+//  of two of the best key. In the exact mode, a bucket stays an unordered list
+//  until it becomes the first bucket, then it is turned into a binary heap of
+//  the objects, which it stays until it is empty. Each object is moved into a
+//  heap at most once, and objects with the same key are evicted in the order
+//  they were inserted. A bucket whose objects all have the same key, e.g., Size
+//  on a trace of fixed size blocks, is already in order and stays a list
+//
+//  the queue grows with the number of objects, nothing is preallocated
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bucket 0 holds the keys below 1, bucket i holds [2^(i-1), 2^i), the last
+ * bucket also holds the larger keys */
+#define BUCKET_QUEUE_N_BUCKET 64
+
+typedef struct {
+  /* the list of the objects, head is evicted first in the approximate mode */
+  cache_obj_t *head;
+  cache_obj_t *tail;
+  /* the heap of the objects if is_heap, heap[0] is evicted first */
+  cache_obj_t **heap;
+  int64_t heap_capacity;
+  int64_t n_obj;
+  bool is_heap;
+  /* all objects in the list have the same key, so the list is in eviction
+   * order and does not need a heap */
+  bool same_key;
+} bucket_queue_bucket_t;
+
+typedef struct bucket_queue {
+  bucket_queue_bucket_t buckets[BUCKET_QUEUE_N_BUCKET];
+  /* bit i is set if bucket i has objects */
+  uint64_t non_empty;
+  /* evict the largest key if true, otherwise the smallest key */
+  bool max_first;
+  bool exact;
+  int64_t n_obj;
+  int64_t n_insert;
+} bucket_queue_t;
+
+/**
+ * @brief create an empty bucket queue
+ *
+ * @param max_first evict the object with the largest key if true, otherwise
+ * the object with the smallest key
+ * @param exact evict the best key, otherwise evict the oldest object in the
+ * bucket of the best key
+ */
+bucket_queue_t *bucket_queue_init(bool max_first, bool exact);
+
+void bucket_queue_free(bucket_queue_t *bq);
+
+/**
+ * @brief add an object with a non-negative key
+ */
+void bucket_queue_insert(bucket_queue_t *bq, cache_obj_t *obj, double key);
+
+/**
+ * @brief remove an object from the queue
+ */
+void bucket_queue_remove(bucket_queue_t *bq, cache_obj_t *obj);
+
+/**
+ * @brief change the key of an object in the queue, the object is ordered
+ * after the objects that already have the new key
+ */
+void bucket_queue_update(bucket_queue_t *bq, cache_obj_t *obj, double key);
+
+/**
+ * @brief the object to evict, NULL if the queue is empty
+ */
+cache_obj_t *bucket_queue_peek(bucket_queue_t *bq);
+
+/**
+ * @brief remove the object to evict from the queue and return it, NULL if the
+ * queue is empty
+ */
+cache_obj_t *bucket_queue_pop(bucket_queue_t *bq);
+
+/**
+ * @brief visit the objects in eviction order until func returns false, in the
+ * exact mode, the buckets it reaches are turned into heaps and visiting k
+ * objects of a bucket costs O(k log k)
+ */
+void bucket_queue_for_each(bucket_queue_t *bq,
+                           bool (*func)(cache_obj_t *obj, void *user_data),
+                           void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
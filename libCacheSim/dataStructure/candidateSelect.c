@@ -0,0 +1,204 @@
+//
+//  candidateSelect.c
+//  libCacheSim
+//
+//  see candidateSelect.h
+//
+
+#include "candidateSelect.h"
+
+#include <math.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CANDIDATE_SELECT_X86
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* below this, quickselect finishes with an insertion sort */
+#define INSERTION_SORT_THRESHOLD 16
+
+static inline int first_index_of(const double *scores, int n, double value) {
+  for (int i = 0; i < n; i++) {
+    if (scores[i] == value) return i;
+  }
+  return -1;
+}
+
+static double min_scalar(const double *scores, int n) {
+  double best = INFINITY;
+  for (int i = 0; i < n; i++) {
+    if (scores[i] < best) best = scores[i];
+  }
+  return best;
+}
+
+static double max_scalar(const double *scores, int n) {
+  double best = -INFINITY;
+  for (int i = 0; i < n; i++) {
+    if (scores[i] > best) best = scores[i];
+  }
+  return best;
+}
+
+#ifdef CANDIDATE_SELECT_X86
+/* min_pd and max_pd return the second operand if either one is NaN, so the
+ * running result is always the second operand */
+__attribute__((target("avx2"))) static double min_avx2(const double *scores, int n) {
+  __m256d m0 = _mm256_set1_pd(INFINITY), m1 = m0;
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    m0 = _mm256_min_pd(_mm256_loadu_pd(scores + i), m0);
+    m1 = _mm256_min_pd(_mm256_loadu_pd(scores + i + 4), m1);
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_min_pd(m0, m1));
+  double best = min_scalar(lanes, 4), rest = min_scalar(scores + i, n - i);
+  return rest < best ? rest : best;
+}
+
+__attribute__((target("avx2"))) static double max_avx2(const double *scores, int n) {
+  __m256d m0 = _mm256_set1_pd(-INFINITY), m1 = m0;
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    m0 = _mm256_max_pd(_mm256_loadu_pd(scores + i), m0);
+    m1 = _mm256_max_pd(_mm256_loadu_pd(scores + i + 4), m1);
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_max_pd(m0, m1));
+  double best = max_scalar(lanes, 4), rest = max_scalar(scores + i, n - i);
+  return rest > best ? rest : best;
+}
+
+static bool use_avx2(void) {
+  /* the race on the first call is benign, every thread writes the same value */
+  static int supported = -1;
+  if (supported < 0) supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+  return supported == 1;
+}
+#endif
+
+int candidate_argmin(const double *scores, int n) {
+  double best;
+#ifdef CANDIDATE_SELECT_X86
+  if (use_avx2()) {
+    best = min_avx2(scores, n);
+  } else
+#endif
+  {
+    best = min_scalar(scores, n);
+  }
+  return first_index_of(scores, n, best);
+}
+
+int candidate_argmax(const double *scores, int n) {
+  double best;
+#ifdef CANDIDATE_SELECT_X86
+  if (use_avx2()) {
+    best = max_avx2(scores, n);
+  } else
+#endif
+  {
+    best = max_scalar(scores, n);
+  }
+  return first_index_of(scores, n, best);
+}
+
+/* the order of the candidates, NaN is the highest score and the index breaks
+ * ties, so no two candidates are equal */
+static inline bool lower(const double *scores, int32_t a, int32_t b) {
+  double sa = scores[a], sb = scores[b];
+  if (isnan(sa) || isnan(sb)) {
+    return isnan(sa) == isnan(sb) ? a < b : isnan(sb);
+  }
+  return sa < sb || (sa == sb && a < b);
+}
+
+static inline void swap_idx(int32_t *idx, int i, int j) {
+  int32_t t = idx[i];
+  idx[i] = idx[j];
+  idx[j] = t;
+}
+
+static void insertion_sort(const double *scores, int32_t *idx, int n) {
+  for (int i = 1; i < n; i++) {
+    int32_t cur = idx[i];
+    int j = i - 1;
+    while (j >= 0 && lower(scores, cur, idx[j])) {
+      idx[j + 1] = idx[j];
+      j--;
+    }
+    idx[j + 1] = cur;
+  }
+}
+
+/* partition idx[lo, hi] around the median of three, return the final
+ * position of the pivot */
+static int partition(const double *scores, int32_t *idx, int lo, int hi) {
+  int mid = lo + (hi - lo) / 2;
+  if (lower(scores, idx[mid], idx[lo])) swap_idx(idx, mid, lo);
+  if (lower(scores, idx[hi], idx[lo])) swap_idx(idx, hi, lo);
+  if (lower(scores, idx[hi], idx[mid])) swap_idx(idx, hi, mid);
+  /* idx[lo] <= idx[mid] <= idx[hi], use the median as the pivot at hi - 1 */
+  swap_idx(idx, mid, hi - 1);
+  int32_t pivot = idx[hi - 1];
+
+  int i = lo, j = hi - 1;
+  while (true) {
+    while (lower(scores, idx[++i], pivot)) {
+    }
+    while (lower(scores, pivot, idx[--j])) {
+    }
+    if (i >= j) break;
+    swap_idx(idx, i, j);
+  }
+  swap_idx(idx, i, hi - 1);
+  return i;
+}
+
+void candidate_select(const double *scores, int n, int k, int32_t *idx) {
+  for (int i = 0; i < n; i++) {
+    idx[i] = i;
+  }
+  if (k <= 0 || k >= n) return;
+
+  int lo = 0, hi = n - 1;
+  while (hi - lo + 1 > INSERTION_SORT_THRESHOLD) {
+    int p = partition(scores, idx, lo, hi);
+    if (p == k || p == k - 1) return;
+    if (p > k) {
+      hi = p - 1;
+    } else {
+      lo = p + 1;
+    }
+  }
+  insertion_sort(scores, idx + lo, hi - lo + 1);
+}
+
+void candidate_sort(const double *scores, int32_t *idx, int n) {
+  if (n <= INSERTION_SORT_THRESHOLD) {
+    insertion_sort(scores, idx, n);
+    return;
+  }
+  /* quicksort, recurse into the smaller part */
+  while (n > INSERTION_SORT_THRESHOLD) {
+    int p = partition(scores, idx, 0, n - 1);
+    if (p < n - 1 - p) {
+      candidate_sort(scores, idx, p);
+      idx += p + 1;
+      n -= p + 1;
+    } else {
+      candidate_sort(scores, idx + p + 1, n - 1 - p);
+      n = p;
+    }
+  }
+  insertion_sort(scores, idx, n);
+}
+
+#ifdef __cplusplus
+}
+#endif
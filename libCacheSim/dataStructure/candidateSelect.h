@@ -0,0 +1,56 @@
+//
+//  candidateSelect.h
+//  libCacheSim
+//
+//  pick eviction candidates from a packed array of scores, for the algorithms
+//  that sample or scan a few objects and evict the ones with the lowest or the
+//  highest score (RandomLRU, Hyperbolic, BeladySize, FIFO_Merge and
+//  FIFO_Reinsertion)
+//
+//  the caller gathers the scores into a contiguous array once, so the
+//  selection does not follow the object pointers. argmin and argmax are a
+//  min/max reduction (AVX2 when the CPU has it) followed by a scan for the
+//  first index with the result, and candidate_select is a quickselect that
+//  only moves the k lowest scores to the front instead of sorting all of them
+//
+//  ties are broken by the index, so the results are the same as a stable sort
+//  of the candidates. NaN scores are never selected by argmin and argmax, and
+//  are ordered after all other scores by candidate_select
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief the first index of the lowest score, -1 if n is 0 or all scores are
+ * NaN
+ */
+int candidate_argmin(const double *scores, int n);
+
+/**
+ * @brief the first index of the highest score, -1 if n is 0 or all scores are
+ * NaN
+ */
+int candidate_argmax(const double *scores, int n);
+
+/**
+ * @brief reorder idx so that idx[0, k) are the indices of the k lowest scores
+ * and idx[k, n) the others, neither part is sorted
+ *
+ * @param idx filled with a permutation of [0, n)
+ */
+void candidate_select(const double *scores, int n, int k, int32_t *idx);
+
+/**
+ * @brief sort n indices by their score
+ */
+void candidate_sort(const double *scores, int32_t *idx, int n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,180 @@
+//
+//  countMinSketch.c
+//  libCacheSim
+//
+//  see countMinSketch.h
+//
+
+#include "countMinSketch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+#include "hash/hash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMS_BLOCK_N_WORD 8
+/* clears the high bit of each counter after shifting right by one */
+#define CMS_RESET_MASK 0x7777777777777777ULL
+/* the low bit of each counter */
+#define CMS_ONE_MASK 0x1111111111111111ULL
+/* the counters are halved after this many increments per expected object */
+#define CMS_SAMPLE_FACTOR 10
+
+static inline uint64_t next_pow2(uint64_t n) {
+  uint64_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+static inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+/* the block comes from the low bits of the hash, the counters of the key
+ * come from the high bits, remixed so that a weak hash still spreads */
+static inline void locate(const count_min_sketch_t *sketch, uint64_t hash, uint64_t slot[4], int shift[4]) {
+  uint64_t block = (hash & sketch->block_mask) * CMS_BLOCK_N_WORD;
+  uint32_t counter_hash = (uint32_t)((rotl64(hash, 32) * 0x9E3779B97F4A7C15ULL) >> 32);
+  for (int i = 0; i < 4; i++) {
+    uint32_t h = counter_hash >> (i * 8);
+    /* counter i is in word 2i or 2i+1 of the block */
+    slot[i] = block + (h & 1) + (uint64_t)i * 2;
+    shift[i] = (int)((h >> 1) & 15) * 4;
+  }
+}
+
+/* the doorkeeper sets three bits in one word */
+static inline uint64_t *doorkeeper_word(const count_min_sketch_t *sketch, uint64_t hash, uint64_t *bits) {
+  uint64_t h = rotl64(hash, 21) * 0xC2B2AE3D27D4EB4FULL;
+  *bits = (1ULL << ((h >> 14) & 63)) | (1ULL << ((h >> 20) & 63)) | (1ULL << ((h >> 26) & 63));
+  return &sketch->doorkeeper[(h >> 32) & sketch->doorkeeper_mask];
+}
+
+static void allocate_table(count_min_sketch_t *sketch, int64_t n_obj, bool use_doorkeeper) {
+  /* one word (16 counters) per expected object */
+  uint64_t n_word = next_pow2(n_obj > CMS_BLOCK_N_WORD ? (uint64_t)n_obj : CMS_BLOCK_N_WORD);
+
+  free(sketch->table);
+  sketch->table = aligned_alloc(64, n_word * sizeof(uint64_t));
+  if (sketch->table == NULL) {
+    ERROR("count min sketch: failed to allocate %lu words\n", (unsigned long)n_word);
+  }
+  memset(sketch->table, 0, n_word * sizeof(uint64_t));
+  sketch->n_word = (int64_t)n_word;
+  sketch->block_mask = n_word / CMS_BLOCK_N_WORD - 1;
+
+  free(sketch->doorkeeper);
+  sketch->doorkeeper = NULL;
+  if (use_doorkeeper) {
+    /* 16 bits per expected object */
+    uint64_t n_dk_word = n_word / 4 > 0 ? n_word / 4 : 1;
+    sketch->doorkeeper = calloc(n_dk_word, sizeof(uint64_t));
+    if (sketch->doorkeeper == NULL) {
+      ERROR("count min sketch: failed to allocate doorkeeper\n");
+    }
+    sketch->doorkeeper_mask = n_dk_word - 1;
+  }
+
+  sketch->sample_size = (int64_t)n_word * CMS_SAMPLE_FACTOR;
+  sketch->n_sample = 0;
+}
+
+count_min_sketch_t *count_min_sketch_init(int64_t n_obj, bool use_doorkeeper) {
+  count_min_sketch_t *sketch = calloc(1, sizeof(count_min_sketch_t));
+  allocate_table(sketch, n_obj, use_doorkeeper);
+
+  return sketch;
+}
+
+void count_min_sketch_free(count_min_sketch_t *sketch) {
+  free(sketch->table);
+  free(sketch->doorkeeper);
+  free(sketch);
+}
+
+void count_min_sketch_ensure_capacity(count_min_sketch_t *sketch, int64_t n_obj) {
+  if (n_obj <= sketch->n_word) {
+    return;
+  }
+  allocate_table(sketch, n_obj, sketch->doorkeeper != NULL);
+}
+
+void count_min_sketch_increment(count_min_sketch_t *sketch, obj_id_t obj_id) {
+  uint64_t hash = get_hash_value_int_64(&obj_id);
+
+  if (sketch->doorkeeper != NULL) {
+    uint64_t bits;
+    uint64_t *word = doorkeeper_word(sketch, hash, &bits);
+    if ((*word & bits) != bits) {
+      /* the first occurrence only goes to the doorkeeper */
+      *word |= bits;
+      if (++sketch->n_sample >= sketch->sample_size) {
+        count_min_sketch_age(sketch);
+      }
+      return;
+    }
+  }
+
+  uint64_t slot[4];
+  int shift[4];
+  locate(sketch, hash, slot, shift);
+
+  /* each counter is in a different word, add one unless it is saturated */
+  uint64_t added = 0;
+  for (int i = 0; i < 4; i++) {
+    uint64_t word = sketch->table[slot[i]];
+    uint64_t not_full = ((word >> shift[i]) & 15) != 15;
+    sketch->table[slot[i]] = word + (not_full << shift[i]);
+    added |= not_full;
+  }
+
+  if (added && ++sketch->n_sample >= sketch->sample_size) {
+    count_min_sketch_age(sketch);
+  }
+}
+
+int count_min_sketch_estimate(const count_min_sketch_t *sketch, obj_id_t obj_id) {
+  uint64_t hash = get_hash_value_int_64(&obj_id);
+
+  uint64_t slot[4];
+  int shift[4];
+  locate(sketch, hash, slot, shift);
+
+  int freq = CMS_MAX_COUNT;
+  for (int i = 0; i < 4; i++) {
+    int count = (int)((sketch->table[slot[i]] >> shift[i]) & 15);
+    freq = MIN(freq, count);
+  }
+
+  if (sketch->doorkeeper != NULL) {
+    uint64_t bits;
+    const uint64_t *word = doorkeeper_word(sketch, hash, &bits);
+    if ((*word & bits) == bits) freq += 1;
+  }
+
+  return freq;
+}
+
+void count_min_sketch_age(count_min_sketch_t *sketch) {
+  /* halve all sixteen counters of a word at once, the odd counters lose
+   * half an increment each, which is subtracted from the sample count */
+  int64_t n_odd = 0;
+  for (int64_t i = 0; i < sketch->n_word; i++) {
+    n_odd += __builtin_popcountll(sketch->table[i] & CMS_ONE_MASK);
+    sketch->table[i] = (sketch->table[i] >> 1) & CMS_RESET_MASK;
+  }
+  sketch->n_sample = (sketch->n_sample - (n_odd >> 2)) >> 1;
+  sketch->n_aging += 1;
+
+  if (sketch->doorkeeper != NULL) {
+    memset(sketch->doorkeeper, 0, (sketch->doorkeeper_mask + 1) * sizeof(uint64_t));
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,80 @@
+//
+//  countMinSketch.h
+//  libCacheSim
+//
+//  a frequency sketch with 4-bit counters (the TinyLFU sketch used by
+//  Caffeine), used by WTinyLFU and the frequency admissioner
+//
+//  the table is split into 64-byte blocks of eight 64-bit words, each word
+//  holds sixteen 4-bit counters. A key maps to one block and has one counter
+//  in each of four different words of the block, so an increment or an
+//  estimate touches a single cache line. Counters saturate at 15 and are
+//  halved every sample_size increments so that old popularity fades out.
+//
+//  an optional doorkeeper (a bloom filter with all bits of a key in one
+//  64-bit word) absorbs the first occurrence of each key, so one-hit wonders
+//  do not pollute the counters, it is cleared when the counters are halved
+//
+//  the table takes 8 bytes per expected object and the doorkeeper 2 bytes
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the largest value a counter can hold, estimates can be one larger when
+ * the doorkeeper is used */
+#define CMS_MAX_COUNT 15
+
+typedef struct count_min_sketch {
+  /* aligned to 64 bytes, 8 words per block */
+  uint64_t *table;
+  int64_t n_word;
+  uint64_t block_mask;
+
+  /* NULL if the doorkeeper is not used */
+  uint64_t *doorkeeper;
+  uint64_t doorkeeper_mask;
+
+  /* the counters are halved after sample_size increments */
+  int64_t sample_size;
+  int64_t n_sample;
+  int64_t n_aging;
+} count_min_sketch_t;
+
+/**
+ * @brief create a sketch
+ *
+ * @param n_obj the expected number of objects tracked, e.g., the number of
+ * objects in the cache
+ * @param use_doorkeeper whether to put a doorkeeper in front of the counters
+ */
+count_min_sketch_t *count_min_sketch_init(int64_t n_obj, bool use_doorkeeper);
+
+void count_min_sketch_free(count_min_sketch_t *sketch);
+
+/**
+ * @brief grow the sketch if it is sized for fewer than n_obj objects,
+ * growing clears all counters
+ */
+void count_min_sketch_ensure_capacity(count_min_sketch_t *sketch, int64_t n_obj);
+
+/* record one occurrence of the object */
+void count_min_sketch_increment(count_min_sketch_t *sketch, obj_id_t obj_id);
+
+/* the estimated frequency of the object */
+int count_min_sketch_estimate(const count_min_sketch_t *sketch, obj_id_t obj_id);
+
+/* halve all counters and clear the doorkeeper */
+void count_min_sketch_age(count_min_sketch_t *sketch);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+//
+//  freqList.c
+//  libCacheSim
+//
+//  see freqList.h
+//
+
+#include "freqList.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FREQ_LIST_CHUNK_N_NODE 1024
+
+freq_list_t *freq_list_init(void) {
+  freq_list_t *fl = calloc(1, sizeof(freq_list_t));
+  return fl;
+}
+
+void freq_list_free(freq_list_t *fl) {
+  for (int32_t i = 0; i < fl->n_chunk; i++) {
+    free(fl->chunks[i]);
+  }
+  free(fl->chunks);
+  free(fl);
+}
+
+static void add_chunk(freq_list_t *fl) {
+  if (fl->n_chunk == fl->chunk_capacity) {
+    fl->chunk_capacity = fl->chunk_capacity == 0 ? 8 : fl->chunk_capacity * 2;
+    fl->chunks = realloc(fl->chunks, sizeof(freq_node_t *) * fl->chunk_capacity);
+  }
+  freq_node_t *chunk = malloc(sizeof(freq_node_t) * FREQ_LIST_CHUNK_N_NODE);
+  if (chunk == NULL || fl->chunks == NULL) {
+    ERROR("freq list: failed to allocate %d freq nodes\n", FREQ_LIST_CHUNK_N_NODE);
+  }
+  fl->chunks[fl->n_chunk++] = chunk;
+  for (int i = 0; i < FREQ_LIST_CHUNK_N_NODE; i++) {
+    chunk[i].next = fl->free_nodes;
+    fl->free_nodes = &chunk[i];
+  }
+}
+
+/* take a node from the pool and link it after prev, or as the head if prev is
+ * NULL */
+static freq_node_t *new_node_after(freq_list_t *fl, freq_node_t *prev, int64_t freq) {
+  if (fl->free_nodes == NULL) {
+    add_chunk(fl);
+  }
+  freq_node_t *node = fl->free_nodes;
+  fl->free_nodes = node->next;
+
+  memset(node, 0, sizeof(freq_node_t));
+  node->freq = freq;
+  node->prev = prev;
+  node->next = prev == NULL ? fl->head : prev->next;
+  if (node->next != NULL) {
+    node->next->prev = node;
+  } else {
+    fl->tail = node;
+  }
+  if (prev != NULL) {
+    prev->next = node;
+  } else {
+    fl->head = node;
+  }
+  fl->n_node += 1;
+  return node;
+}
+
+static void release_node(freq_list_t *fl, freq_node_t *node) {
+  DEBUG_ASSERT(node->n_obj == 0);
+  if (node->prev != NULL) {
+    node->prev->next = node->next;
+  } else {
+    fl->head = node->next;
+  }
+  if (node->next != NULL) {
+    node->next->prev = node->prev;
+  } else {
+    fl->tail = node->prev;
+  }
+  fl->n_node -= 1;
+
+  node->next = fl->free_nodes;
+  fl->free_nodes = node;
+}
+
+freq_node_t *freq_list_add(freq_list_t *fl, freq_node_t *start,
+                           cache_obj_t *obj, int64_t freq) {
+  /* the last node with a freq no larger than freq */
+  freq_node_t *prev = NULL;
+  freq_node_t *node = start == NULL ? fl->head : start;
+  DEBUG_ASSERT(node == NULL || start == NULL || node->freq <= freq);
+  while (node != NULL && node->freq <= freq) {
+    prev = node;
+    node = node->next;
+  }
+
+  if (prev == NULL || prev->freq != freq) {
+    prev = new_node_after(fl, prev, freq);
+  }
+
+  append_obj_to_tail(&prev->first_obj, &prev->last_obj, obj);
+  prev->n_obj += 1;
+  obj->lfu.freq = freq;
+  obj->lfu.freq_node = prev;
+  return prev;
+}
+
+void freq_list_remove(freq_list_t *fl, cache_obj_t *obj) {
+  freq_node_t *node = obj->lfu.freq_node;
+  DEBUG_ASSERT(node != NULL && node->n_obj > 0);
+  remove_obj_from_list(&node->first_obj, &node->last_obj, obj);
+  node->n_obj -= 1;
+  obj->lfu.freq_node = NULL;
+  if (node->n_obj == 0) {
+    release_node(fl, node);
+  }
+}
+
+void freq_list_move(freq_list_t *fl, cache_obj_t *obj, int64_t freq) {
+  freq_node_t *node = obj->lfu.freq_node;
+  DEBUG_ASSERT(node != NULL && node->freq <= freq);
+  remove_obj_from_list(&node->first_obj, &node->last_obj, obj);
+  node->n_obj -= 1;
+
+  /* the node stays linked until the object is in its new node, so that the
+   * search can start from it */
+  freq_node_t *new_node = freq_list_add(fl, node, obj, freq);
+  if (node->n_obj == 0 && node != new_node) {
+    release_node(fl, node);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,77 @@
+//
+//  freqList.h
+//  libCacheSim
+//
+//  the frequency list of the constant time LFU: the freq nodes that have
+//  objects are linked in increasing freq order, each node keeps its objects
+//  in a list ordered by the time they reached the freq, and each object points
+//  to its node in obj->lfu.freq_node
+//
+//  a hit moves the object to the next node or to a new node right after its
+//  node, so neither a hit nor finding the least frequent object searches a
+//  map. A node is returned to a pool as soon as its last object leaves, the
+//  pool grows in chunks and is only freed with the list
+//
+//  used by LFU, LFUDA and CR_LFU
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "../include/libCacheSim/evictionAlgo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct freq_list {
+  /* the nodes with the lowest and the highest freq */
+  freq_node_t *head;
+  freq_node_t *tail;
+  int64_t n_node;
+
+  /* unused nodes linked by next */
+  freq_node_t *free_nodes;
+  freq_node_t **chunks;
+  int32_t n_chunk;
+  int32_t chunk_capacity;
+} freq_list_t;
+
+freq_list_t *freq_list_init(void);
+
+void freq_list_free(freq_list_t *fl);
+
+/**
+ * @brief append the object to the node of freq, the node is created if no
+ * object has this freq
+ *
+ * @param start where the node search starts, a node with a freq no larger
+ * than freq, NULL searches from the lowest freq
+ * @return the node of the object
+ */
+freq_node_t *freq_list_add(freq_list_t *fl, freq_node_t *start,
+                           cache_obj_t *obj, int64_t freq);
+
+/**
+ * @brief remove the object from its node, the node is released if it has no
+ * object left
+ */
+void freq_list_remove(freq_list_t *fl, cache_obj_t *obj);
+
+/**
+ * @brief move the object to the tail of the node of freq, which must not be
+ * lower than the current freq of the object
+ */
+void freq_list_move(freq_list_t *fl, cache_obj_t *obj, int64_t freq);
+
+/**
+ * @brief the node with the lowest freq, NULL if the list is empty
+ */
+static inline freq_node_t *freq_list_min(const freq_list_t *fl) {
+  return fl->head;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,235 @@
+//
+//  ghostHistory.c
+//  libCacheSim
+//
+//  see ghostHistory.h
+//
+
+#include "ghostHistory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+#include "hash/hash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GHOST_MIN_N_ENTRY 1024
+
+static inline uint64_t hash_of(obj_id_t obj_id) {
+  uint64_t hash = get_hash_value_int_64(&obj_id);
+  /* 0 is reserved for removed ring entries */
+  return hash == 0 ? 1 : hash;
+}
+
+static inline uint32_t fingerprint_of(uint64_t hash) {
+  uint32_t fp = (uint32_t)hash;
+  /* 0 is reserved for empty map slots */
+  return fp == 0 ? 1 : fp;
+}
+
+/* fingerprints are hash bits, but the low bits are mixed again so that
+ * consecutive fingerprints from a weak hash do not cluster */
+static inline uint64_t map_home(const ghost_history_t *history, uint32_t fp) {
+  return ((uint64_t)fp * 0x9E3779B97F4A7C15ULL >> 32) & history->map_mask;
+}
+
+static inline uint64_t next_pow2(uint64_t n) {
+  uint64_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+/* the map slot of the hash, or the empty slot where it should go,
+ * a fingerprint match is confirmed against the full hash in the ring */
+static inline uint64_t map_find(const ghost_history_t *history, uint64_t hash) {
+  uint32_t fp = fingerprint_of(hash);
+  uint64_t i = map_home(history, fp);
+  while (history->map[i].fingerprint != 0) {
+    if (history->map[i].fingerprint == fp && history->entries[history->map[i].ring_slot].hash == hash) break;
+    i = (i + 1) & history->map_mask;
+  }
+  return i;
+}
+
+/* the first empty map slot in the probe sequence of the fingerprint */
+static inline uint64_t map_find_empty(const ghost_history_t *history, uint32_t fp) {
+  uint64_t i = map_home(history, fp);
+  while (history->map[i].fingerprint != 0) {
+    i = (i + 1) & history->map_mask;
+  }
+  return i;
+}
+
+/* backward shift deletion keeps the probe sequences intact without
+ * tombstones */
+static void map_delete_at(ghost_history_t *history, uint64_t i) {
+  uint64_t j = i;
+  while (true) {
+    j = (j + 1) & history->map_mask;
+    if (history->map[j].fingerprint == 0) break;
+    uint64_t home = map_home(history, history->map[j].fingerprint);
+    /* move j to i if its home is not in the cyclic range (i, j] */
+    bool in_range = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+    if (!in_range) {
+      history->map[i] = history->map[j];
+      i = j;
+    }
+  }
+  history->map[i].fingerprint = 0;
+}
+
+/* copy the live entries into a ring of n_slot entries and rebuild the map,
+ * this squeezes out removed entries and grows the ring if needed */
+static void rebuild(ghost_history_t *history, uint64_t n_slot) {
+  ghost_entry_t *new_entries = malloc(sizeof(ghost_entry_t) * n_slot);
+  ghost_map_slot_t *new_map = calloc(n_slot * 2, sizeof(ghost_map_slot_t));
+  if (new_entries == NULL || new_map == NULL) {
+    ERROR("ghost history: failed to allocate %lu entries\n", (unsigned long)n_slot);
+  }
+
+  free(history->map);
+  history->map = new_map;
+  history->map_mask = n_slot * 2 - 1;
+
+  uint64_t n = 0;
+  for (uint64_t pos = history->head; pos < history->tail; pos++) {
+    ghost_entry_t *e = &history->entries[pos & history->ring_mask];
+    if (e->hash == 0) continue;
+    new_entries[n] = *e;
+    uint32_t fp = fingerprint_of(e->hash);
+    uint64_t i = map_find_empty(history, fp);
+    history->map[i].fingerprint = fp;
+    history->map[i].ring_slot = (uint32_t)n;
+    n++;
+  }
+  DEBUG_ASSERT((int64_t)n == history->n_entry);
+
+  free(history->entries);
+  history->entries = new_entries;
+  history->ring_mask = n_slot - 1;
+  history->head = 0;
+  history->tail = n;
+}
+
+ghost_history_t *ghost_history_init(int64_t init_n_entry) {
+  ghost_history_t *history = calloc(1, sizeof(ghost_history_t));
+  uint64_t n_slot = next_pow2(init_n_entry > GHOST_MIN_N_ENTRY ? (uint64_t)init_n_entry : GHOST_MIN_N_ENTRY);
+  history->ring_mask = 0;
+  rebuild(history, n_slot);
+
+  return history;
+}
+
+void ghost_history_free(ghost_history_t *history) {
+  free(history->entries);
+  free(history->map);
+  free(history);
+}
+
+static void remove_at_map_slot(ghost_history_t *history, uint64_t map_slot, int64_t *size, int64_t *data) {
+  ghost_entry_t *e = &history->entries[history->map[map_slot].ring_slot];
+  if (size != NULL) *size = e->size;
+  if (data != NULL) *data = e->data;
+
+  history->n_entry -= 1;
+  history->n_byte -= e->size;
+  e->hash = 0;
+  map_delete_at(history, map_slot);
+}
+
+static void insert_hash(ghost_history_t *history, uint64_t hash, int64_t size, int64_t data) {
+  uint64_t i = map_find(history, hash);
+  if (history->map[i].fingerprint != 0) {
+    remove_at_map_slot(history, i, NULL, NULL);
+  }
+
+  if (history->tail - history->head > history->ring_mask) {
+    /* the ring is full, grow it only if most entries are live */
+    uint64_t n_slot = history->ring_mask + 1;
+    if ((uint64_t)history->n_entry * 2 >= n_slot) n_slot *= 2;
+    rebuild(history, n_slot);
+  }
+  uint32_t fp = fingerprint_of(hash);
+  i = map_find_empty(history, fp);
+
+  uint64_t ring_slot = history->tail & history->ring_mask;
+  ghost_entry_t *e = &history->entries[ring_slot];
+  e->hash = hash;
+  e->size = size > UINT32_MAX ? UINT32_MAX : (uint32_t)size;
+  e->data = data;
+  history->tail += 1;
+
+  history->map[i].fingerprint = fp;
+  history->map[i].ring_slot = (uint32_t)ring_slot;
+  history->n_entry += 1;
+  history->n_byte += e->size;
+}
+
+void ghost_history_insert(ghost_history_t *history, obj_id_t obj_id, int64_t size, int64_t data) {
+  insert_hash(history, hash_of(obj_id), size, data);
+}
+
+bool ghost_history_remove(ghost_history_t *history, obj_id_t obj_id, int64_t *size, int64_t *data) {
+  uint64_t i = map_find(history, hash_of(obj_id));
+  if (history->map[i].fingerprint == 0) {
+    return false;
+  }
+
+  remove_at_map_slot(history, i, size, data);
+  return true;
+}
+
+bool ghost_history_contains(const ghost_history_t *history, obj_id_t obj_id) {
+  uint64_t i = map_find(history, hash_of(obj_id));
+  return history->map[i].fingerprint != 0;
+}
+
+bool ghost_history_pop_oldest(ghost_history_t *history, int64_t *size, int64_t *data) {
+  while (history->head < history->tail && history->entries[history->head & history->ring_mask].hash == 0) {
+    history->head += 1;
+  }
+  if (history->head == history->tail) {
+    return false;
+  }
+
+  uint64_t i = map_find(history, history->entries[history->head & history->ring_mask].hash);
+  DEBUG_ASSERT(history->map[i].ring_slot == (history->head & history->ring_mask));
+  remove_at_map_slot(history, i, size, data);
+  history->head += 1;
+
+  return true;
+}
+
+bool ghost_history_save(const ghost_history_t *history, FILE *f) {
+  int64_t n_entry = history->n_entry;
+  if (fwrite(&n_entry, sizeof(n_entry), 1, f) != 1) return false;
+
+  for (uint64_t pos = history->head; pos < history->tail; pos++) {
+    const ghost_entry_t *e = &history->entries[pos & history->ring_mask];
+    if (e->hash == 0) continue;
+    if (fwrite(e, sizeof(ghost_entry_t), 1, f) != 1) return false;
+  }
+  return true;
+}
+
+bool ghost_history_load(ghost_history_t *history, FILE *f) {
+  int64_t n_entry;
+  if (fread(&n_entry, sizeof(n_entry), 1, f) != 1) return false;
+
+  for (int64_t i = 0; i < n_entry; i++) {
+    ghost_entry_t e;
+    if (fread(&e, sizeof(ghost_entry_t), 1, f) != 1 || e.hash == 0) return false;
+    insert_hash(history, e.hash, e.size, e.data);
+  }
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
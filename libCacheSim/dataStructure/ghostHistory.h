@@ -0,0 +1,110 @@
+//
+//  ghostHistory.h
+//  libCacheSim
+//
+//  a compact eviction history (ghost list) shared by ARC, CAR, LeCaR, LIRS and
+//  S3FIFO, it replaces keeping evicted objects as full cache_obj_t in the
+//  cache hash table or in a separate ghost cache
+//
+//  the history is a FIFO ring of object id hashes, a linear probing map of
+//  32-bit fingerprints (the low bits of the hash) to ring slots supports
+//  lookup and removal from the middle. A fingerprint match in the map is
+//  confirmed against the full hash in the ring, so only objects with the
+//  same 64-bit hash alias each other. Removed entries become holes in the
+//  ring that are skipped when popping and squeezed out when the ring is full
+//
+//  each entry takes 24 bytes in the ring and 16 bytes in the map (at load
+//  0.5), compared to a cache_obj_t and a hash table slot for a ghost object
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  /* hash of the object id, 0 marks a removed entry */
+  uint64_t hash;
+  /* opaque to the history, e.g., eviction time or object id */
+  int64_t data;
+  /* saturates at UINT32_MAX */
+  uint32_t size;
+} ghost_entry_t;
+
+typedef struct {
+  uint32_t fingerprint;
+  uint32_t ring_slot;
+} ghost_map_slot_t;
+
+typedef struct ghost_history {
+  /* entries[head & ring_mask] is the oldest */
+  ghost_entry_t *entries;
+  uint64_t head;
+  uint64_t tail;
+  uint64_t ring_mask;
+
+  ghost_map_slot_t *map;
+  uint64_t map_mask;
+
+  /* live entries and their total size */
+  int64_t n_entry;
+  int64_t n_byte;
+} ghost_history_t;
+
+/**
+ * @brief create a history
+ *
+ * @param init_n_entry the expected number of entries, the history grows
+ * when needed
+ */
+ghost_history_t *ghost_history_init(int64_t init_n_entry);
+
+void ghost_history_free(ghost_history_t *history);
+
+/**
+ * add an object as the newest entry, an older entry of the same object is
+ * dropped
+ */
+void ghost_history_insert(ghost_history_t *history, obj_id_t obj_id, int64_t size, int64_t data);
+
+/**
+ * @brief remove the entry of the object
+ *
+ * @param size if not NULL, returns the size of the removed entry
+ * @param data if not NULL, returns the data of the removed entry
+ * @return true if the object was in the history
+ */
+bool ghost_history_remove(ghost_history_t *history, obj_id_t obj_id, int64_t *size, int64_t *data);
+
+bool ghost_history_contains(const ghost_history_t *history, obj_id_t obj_id);
+
+/**
+ * @brief remove the oldest entry
+ *
+ * @return false if the history is empty
+ */
+bool ghost_history_pop_oldest(ghost_history_t *history, int64_t *size, int64_t *data);
+
+/**
+ * @brief write the entries from the oldest to the newest, used by the
+ * checkpoints of the algorithms that have a ghost, see checkpoint.h
+ */
+bool ghost_history_save(const ghost_history_t *history, FILE *f);
+
+/**
+ * @brief add the entries written by ghost_history_save as the newest entries
+ *
+ * @return false if the file ends
+ */
+bool ghost_history_load(ghost_history_t *history, FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
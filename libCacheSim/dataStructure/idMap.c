@@ -0,0 +1,150 @@
+//
+//  idMap.c
+//  libCacheSim
+//
+//  see idMap.h
+//
+
+#include "idMap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ID_MAP_MIN_HASHPOWER 4
+
+/* Fibonacci hashing, the high bits of the product pick the slot, so
+ * sequential block numbers spread over the table */
+static inline uint64_t home_slot(const id_map_t *map, uint64_t key) {
+  return (key * 0x9E3779B97F4A7C15ULL) >> map->shift;
+}
+
+static void alloc_slots(id_map_t *map, int hashpower) {
+  uint64_t n_slot = 1ULL << hashpower;
+  map->slots = malloc(n_slot * sizeof(id_map_slot_t));
+  if (map->slots == NULL) {
+    ERROR("id map: failed to allocate %lu slots\n", (unsigned long)n_slot);
+  }
+  for (uint64_t i = 0; i < n_slot; i++) {
+    map->slots[i].key = ID_MAP_EMPTY_KEY;
+  }
+  map->mask = n_slot - 1;
+  map->shift = 64 - hashpower;
+}
+
+id_map_t *id_map_init(int64_t n_entry_hint) {
+  id_map_t *map = calloc(1, sizeof(id_map_t));
+  int hashpower = ID_MAP_MIN_HASHPOWER;
+  while ((1LL << hashpower) < n_entry_hint * 2) {
+    hashpower++;
+  }
+  alloc_slots(map, hashpower);
+  return map;
+}
+
+void id_map_free(id_map_t *map) {
+  free(map->slots);
+  free(map);
+}
+
+static void grow(id_map_t *map) {
+  id_map_slot_t *old_slots = map->slots;
+  uint64_t old_n_slot = map->mask + 1;
+
+  alloc_slots(map, 64 - map->shift + 1);
+  for (uint64_t i = 0; i < old_n_slot; i++) {
+    if (old_slots[i].key == ID_MAP_EMPTY_KEY) continue;
+    uint64_t pos = home_slot(map, old_slots[i].key);
+    while (map->slots[pos].key != ID_MAP_EMPTY_KEY) {
+      pos = (pos + 1) & map->mask;
+    }
+    map->slots[pos] = old_slots[i];
+  }
+  free(old_slots);
+}
+
+int64_t *id_map_find(id_map_t *map, uint64_t key) {
+  if (key == ID_MAP_EMPTY_KEY) {
+    return map->has_empty_key ? &map->empty_key_value : NULL;
+  }
+
+  uint64_t pos = home_slot(map, key);
+  while (map->slots[pos].key != ID_MAP_EMPTY_KEY) {
+    if (map->slots[pos].key == key) return &map->slots[pos].value;
+    pos = (pos + 1) & map->mask;
+  }
+  return NULL;
+}
+
+void id_map_put(id_map_t *map, uint64_t key, int64_t value) {
+  if (key == ID_MAP_EMPTY_KEY) {
+    map->n_entry += !map->has_empty_key;
+    map->has_empty_key = true;
+    map->empty_key_value = value;
+    return;
+  }
+
+  uint64_t pos = home_slot(map, key);
+  while (map->slots[pos].key != ID_MAP_EMPTY_KEY) {
+    if (map->slots[pos].key == key) {
+      map->slots[pos].value = value;
+      return;
+    }
+    pos = (pos + 1) & map->mask;
+  }
+  map->slots[pos].key = key;
+  map->slots[pos].value = value;
+  map->n_entry += 1;
+
+  if ((uint64_t)map->n_entry * 2 > map->mask + 1) {
+    grow(map);
+  }
+}
+
+bool id_map_remove(id_map_t *map, uint64_t key) {
+  if (key == ID_MAP_EMPTY_KEY) {
+    bool had_key = map->has_empty_key;
+    map->n_entry -= had_key;
+    map->has_empty_key = false;
+    return had_key;
+  }
+
+  uint64_t pos = home_slot(map, key);
+  while (map->slots[pos].key != key) {
+    if (map->slots[pos].key == ID_MAP_EMPTY_KEY) return false;
+    pos = (pos + 1) & map->mask;
+  }
+
+  /* shift back the following entries that probed past the hole */
+  uint64_t hole = pos;
+  uint64_t next = (pos + 1) & map->mask;
+  while (map->slots[next].key != ID_MAP_EMPTY_KEY) {
+    uint64_t home = home_slot(map, map->slots[next].key);
+    if (((next - home) & map->mask) >= ((next - hole) & map->mask)) {
+      map->slots[hole] = map->slots[next];
+      hole = next;
+    }
+    next = (next + 1) & map->mask;
+  }
+  map->slots[hole].key = ID_MAP_EMPTY_KEY;
+  map->n_entry -= 1;
+
+  return true;
+}
+
+void id_map_clear(id_map_t *map) {
+  for (uint64_t i = 0; i <= map->mask; i++) {
+    map->slots[i].key = ID_MAP_EMPTY_KEY;
+  }
+  map->n_entry = 0;
+  map->has_empty_key = false;
+}
+
+#ifdef __cplusplus
+}
+#endif
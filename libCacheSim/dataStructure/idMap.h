@@ -0,0 +1,86 @@
+//
+//  idMap.h
+//  libCacheSim
+//
+//  a flat map from object id to a 64-bit value, used by the prefetchers for
+//  their per-object tables instead of GHashTable
+//
+//  the map is an array of (key, value) slots with linear probing, a removed
+//  key shifts the following slots back instead of leaving a tombstone, so
+//  lookups stay short under the insert/remove churn of the recording tables.
+//  the table doubles when it is half full. UINT64_MAX marks an empty slot, the
+//  value of that key is kept outside of the table
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ID_MAP_EMPTY_KEY UINT64_MAX
+
+typedef struct {
+  uint64_t key;
+  int64_t value;
+} id_map_slot_t;
+
+typedef struct id_map {
+  id_map_slot_t *slots;
+  uint64_t mask;
+  /* 64 - log2(number of slots) */
+  int shift;
+  int64_t n_entry;
+
+  bool has_empty_key;
+  int64_t empty_key_value;
+} id_map_t;
+
+/**
+ * @brief create a map
+ *
+ * @param n_entry_hint the expected number of entries, the map grows beyond it
+ */
+id_map_t *id_map_init(int64_t n_entry_hint);
+
+void id_map_free(id_map_t *map);
+
+/**
+ * @brief find the value of a key
+ *
+ * @return a pointer to the value that is valid until the next insert or
+ * remove, NULL if the key is not in the map
+ */
+int64_t *id_map_find(id_map_t *map, uint64_t key);
+
+/**
+ * @brief insert a key or replace its value
+ */
+void id_map_put(id_map_t *map, uint64_t key, int64_t value);
+
+/**
+ * @brief remove a key
+ *
+ * @return whether the key was in the map
+ */
+bool id_map_remove(id_map_t *map, uint64_t key);
+
+void id_map_clear(id_map_t *map);
+
+/* the value of a key, or default_value if the key is not in the map */
+static inline int64_t id_map_get(id_map_t *map, uint64_t key, int64_t default_value) {
+  int64_t *value = id_map_find(map, key);
+  return value == NULL ? default_value : *value;
+}
+
+static inline bool id_map_contains(id_map_t *map, uint64_t key) { return id_map_find(map, key) != NULL; }
+
+static inline int64_t id_map_n_entry(const id_map_t *map) { return map->n_entry; }
+
+#ifdef __cplusplus
+}
+#endif
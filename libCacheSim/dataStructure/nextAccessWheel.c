@@ -0,0 +1,221 @@
+//
+//  nextAccessWheel.c
+//  libCacheSim
+//
+//  see nextAccessWheel.h
+//
+
+#include "nextAccessWheel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NAW_INIT_N_BUCKET (1 << 16)
+
+static inline int64_t n_word_of(int64_t n_bit) { return (n_bit + 63) >> 6; }
+
+static inline int highest_bit(uint64_t word) { return 63 - __builtin_clzll(word); }
+
+static void set_bucket_bit(next_access_wheel_t *wheel, int64_t bucket_idx) {
+  int64_t idx = bucket_idx;
+  for (int level = 0; level < wheel->n_level; level++) {
+    uint64_t *word = &wheel->bitmap[level][idx >> 6];
+    bool was_empty = *word == 0;
+    *word |= 1ULL << (idx & 63);
+    /* the upper levels already mark this word */
+    if (!was_empty) break;
+    idx >>= 6;
+  }
+}
+
+static void clear_bucket_bit(next_access_wheel_t *wheel, int64_t bucket_idx) {
+  int64_t idx = bucket_idx;
+  for (int level = 0; level < wheel->n_level; level++) {
+    uint64_t *word = &wheel->bitmap[level][idx >> 6];
+    *word &= ~(1ULL << (idx & 63));
+    if (*word != 0) break;
+    idx >>= 6;
+  }
+}
+
+/* (re)build the bitmaps from the bucket heads, used at init and resize */
+static void build_bitmap(next_access_wheel_t *wheel) {
+  for (int level = 0; level < wheel->n_level; level++) {
+    free(wheel->bitmap[level]);
+    wheel->bitmap[level] = NULL;
+  }
+
+  int64_t n_bit = wheel->n_bucket;
+  wheel->n_level = 0;
+  do {
+    DEBUG_ASSERT(wheel->n_level < NAW_MAX_LEVEL);
+    wheel->bitmap[wheel->n_level] = calloc(n_word_of(n_bit), sizeof(uint64_t));
+    if (wheel->bitmap[wheel->n_level] == NULL) {
+      ERROR("next access wheel: failed to allocate bitmap\n");
+    }
+    n_bit = n_word_of(n_bit);
+    wheel->n_level++;
+  } while (n_bit > 1);
+
+  for (int64_t i = 0; i < wheel->n_bucket; i++) {
+    if (wheel->buckets[i] != NULL) set_bucket_bit(wheel, i);
+  }
+}
+
+/* the trace length is not known beforehand, so the wheel doubles when an
+ * object lands beyond the last bucket */
+static void grow(next_access_wheel_t *wheel, int64_t bucket_idx) {
+  int64_t new_n_bucket = wheel->n_bucket;
+  while (new_n_bucket <= bucket_idx) new_n_bucket *= 2;
+
+  cache_obj_t **new_buckets = realloc(wheel->buckets, sizeof(cache_obj_t *) * new_n_bucket);
+  if (new_buckets == NULL) {
+    ERROR("next access wheel: failed to grow to %ld buckets\n", (long)new_n_bucket);
+  }
+  memset(new_buckets + wheel->n_bucket, 0, sizeof(cache_obj_t *) * (new_n_bucket - wheel->n_bucket));
+  wheel->buckets = new_buckets;
+  wheel->n_bucket = new_n_bucket;
+  build_bitmap(wheel);
+}
+
+next_access_wheel_t *next_access_wheel_init(int bucket_shift) {
+  next_access_wheel_t *wheel = calloc(1, sizeof(next_access_wheel_t));
+  wheel->bucket_shift = bucket_shift;
+  wheel->n_bucket = NAW_INIT_N_BUCKET;
+  wheel->buckets = calloc(wheel->n_bucket, sizeof(cache_obj_t *));
+  if (wheel->buckets == NULL) {
+    ERROR("next access wheel: failed to allocate buckets\n");
+  }
+  build_bitmap(wheel);
+
+  return wheel;
+}
+
+void next_access_wheel_free(next_access_wheel_t *wheel) {
+  for (int level = 0; level < wheel->n_level; level++) {
+    free(wheel->bitmap[level]);
+  }
+  free(wheel->buckets);
+  free(wheel);
+}
+
+void next_access_wheel_insert(next_access_wheel_t *wheel, cache_obj_t *obj) {
+  int64_t next_access_vtime = obj->Belady.next_access_vtime;
+  DEBUG_ASSERT(next_access_vtime >= 0);
+  wheel->n_obj++;
+
+  cache_obj_t **head;
+  int64_t bucket_idx = -1;
+  if (next_access_vtime >= NAW_NO_REUSE_VTIME) {
+    head = &wheel->no_reuse_head;
+    wheel->n_no_reuse++;
+  } else {
+    bucket_idx = next_access_wheel_bucket_of(wheel, next_access_vtime);
+    if (bucket_idx >= wheel->n_bucket) {
+      grow(wheel, bucket_idx);
+    }
+    head = &wheel->buckets[bucket_idx];
+  }
+
+  obj->queue.prev = NULL;
+  obj->queue.next = *head;
+  if (*head != NULL) {
+    (*head)->queue.prev = obj;
+  } else if (bucket_idx >= 0) {
+    set_bucket_bit(wheel, bucket_idx);
+  }
+  *head = obj;
+}
+
+void next_access_wheel_remove(next_access_wheel_t *wheel, cache_obj_t *obj) {
+  int64_t next_access_vtime = obj->Belady.next_access_vtime;
+  wheel->n_obj--;
+
+  cache_obj_t **head;
+  int64_t bucket_idx = -1;
+  if (next_access_vtime >= NAW_NO_REUSE_VTIME) {
+    head = &wheel->no_reuse_head;
+    wheel->n_no_reuse--;
+  } else {
+    bucket_idx = next_access_wheel_bucket_of(wheel, next_access_vtime);
+    DEBUG_ASSERT(bucket_idx < wheel->n_bucket);
+    head = &wheel->buckets[bucket_idx];
+  }
+
+  if (obj->queue.prev != NULL) {
+    obj->queue.prev->queue.next = obj->queue.next;
+  } else {
+    DEBUG_ASSERT(*head == obj);
+    *head = obj->queue.next;
+  }
+  if (obj->queue.next != NULL) {
+    obj->queue.next->queue.prev = obj->queue.prev;
+  }
+  obj->queue.prev = NULL;
+  obj->queue.next = NULL;
+
+  if (*head == NULL && bucket_idx >= 0) {
+    clear_bucket_bit(wheel, bucket_idx);
+  }
+}
+
+int64_t next_access_wheel_prev_bucket(const next_access_wheel_t *wheel, int64_t bucket_idx) {
+  if (bucket_idx >= wheel->n_bucket) bucket_idx = wheel->n_bucket - 1;
+
+  /* walk up until a word has a set bit at or below the position */
+  int64_t idx = bucket_idx;
+  int level = 0;
+  while (true) {
+    if (idx < 0) return -1;
+    int bit = (int)(idx & 63);
+    uint64_t mask = bit == 63 ? UINT64_MAX : (2ULL << bit) - 1;
+    uint64_t word = wheel->bitmap[level][idx >> 6] & mask;
+    if (word != 0) {
+      idx = (idx & ~63LL) | highest_bit(word);
+      break;
+    }
+    if (level == wheel->n_level - 1) return -1;
+    /* the current word has nothing, continue with the previous word */
+    idx = (idx >> 6) - 1;
+    level++;
+  }
+
+  /* walk down taking the highest set bit */
+  while (level > 0) {
+    level--;
+    idx = (idx << 6) | highest_bit(wheel->bitmap[level][idx]);
+  }
+
+  return idx;
+}
+
+cache_obj_t *next_access_wheel_peek_max(const next_access_wheel_t *wheel) {
+  if (wheel->no_reuse_head != NULL) {
+    return wheel->no_reuse_head;
+  }
+
+  int64_t bucket_idx = next_access_wheel_prev_bucket(wheel, wheel->n_bucket - 1);
+  if (bucket_idx < 0) {
+    return NULL;
+  }
+
+  cache_obj_t *max_obj = wheel->buckets[bucket_idx];
+  for (cache_obj_t *obj = max_obj->queue.next; obj != NULL; obj = obj->queue.next) {
+    if (obj->Belady.next_access_vtime > max_obj->Belady.next_access_vtime) {
+      max_obj = obj;
+    }
+  }
+
+  return max_obj;
+}
+
+#ifdef __cplusplus
+}
+#endif
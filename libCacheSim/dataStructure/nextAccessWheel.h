@@ -0,0 +1,93 @@
+//
+//  nextAccessWheel.h
+//  libCacheSim
+//
+//  a bucketed time wheel that orders cached objects by their next access
+//  vtime, used by the Belady family to find the object requested furthest in
+//  the future without a comparison based priority queue
+//
+//  objects are hashed into buckets of 2^bucket_shift consecutive vtimes and
+//  linked through obj->queue.prev/next, so the wheel does not allocate per
+//  object. A hierarchical bitmap over the buckets finds the highest
+//  non-empty bucket in O(log_64(n_bucket)) word operations.
+//
+//  because each request is the next access of at most one object, a bucket
+//  holds at most 2^bucket_shift objects, which bounds the scan that finds the
+//  exact maximum in a bucket
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NAW_MAX_LEVEL 8
+/* next access vtime at or above this value means the object is not
+ * requested again (the reader uses INT64_MAX) */
+#define NAW_NO_REUSE_VTIME ((int64_t)1 << 48)
+
+typedef struct next_access_wheel {
+  /* head of the object list of each bucket */
+  cache_obj_t **buckets;
+  /* bitmap[0] marks non-empty buckets,
+   * bitmap[i] marks non-zero words of bitmap[i - 1] */
+  uint64_t *bitmap[NAW_MAX_LEVEL];
+  int n_level;
+  int bucket_shift;
+  int64_t n_bucket;
+  /* objects that will not be requested again */
+  cache_obj_t *no_reuse_head;
+  int64_t n_no_reuse;
+  int64_t n_obj;
+} next_access_wheel_t;
+
+/**
+ * @brief create a wheel
+ *
+ * @param bucket_shift each bucket covers 2^bucket_shift vtimes
+ */
+next_access_wheel_t *next_access_wheel_init(int bucket_shift);
+
+void next_access_wheel_free(next_access_wheel_t *wheel);
+
+/**
+ * add an object keyed by obj->Belady.next_access_vtime,
+ * the key must not change while the object is in the wheel
+ */
+void next_access_wheel_insert(next_access_wheel_t *wheel, cache_obj_t *obj);
+
+void next_access_wheel_remove(next_access_wheel_t *wheel, cache_obj_t *obj);
+
+/**
+ * @brief find the highest non-empty bucket that is not above bucket_idx
+ *
+ * @return the bucket index or -1 if all buckets at or below bucket_idx are
+ * empty
+ */
+int64_t next_access_wheel_prev_bucket(const next_access_wheel_t *wheel, int64_t bucket_idx);
+
+/**
+ * @brief the object with the largest next access vtime,
+ * objects that are not requested again come first
+ *
+ * @return the object or NULL if the wheel is empty
+ */
+cache_obj_t *next_access_wheel_peek_max(const next_access_wheel_t *wheel);
+
+static inline int64_t next_access_wheel_bucket_of(const next_access_wheel_t *wheel, int64_t next_access_vtime) {
+  return next_access_vtime >> wheel->bucket_shift;
+}
+
+/* the largest next access vtime that falls into the bucket */
+static inline int64_t next_access_wheel_bucket_end(const next_access_wheel_t *wheel, int64_t bucket_idx) {
+  return ((bucket_idx + 1) << wheel->bucket_shift) - 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,99 @@
+//
+//  ringFifo.c
+//  libCacheSim
+//
+//  see ringFifo.h
+//
+
+#include "ringFifo.h"
+
+#include <stdlib.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RING_FIFO_MIN_N_SLOT 1024
+
+static void queue_alloc(ring_fifo_queue_t *q, int64_t n_slot) {
+  q->slots = calloc(n_slot, sizeof(cache_obj_t *));
+  if (q->slots == NULL) {
+    ERROR("ring fifo: failed to allocate %ld slots\n", (long)n_slot);
+  }
+  q->mask = n_slot - 1;
+}
+
+ring_fifo_t *ring_fifo_init(int n_queue) {
+  DEBUG_ASSERT(n_queue > 0 && n_queue <= RING_FIFO_MAX_N_QUEUE);
+  ring_fifo_t *rf = calloc(1, sizeof(ring_fifo_t));
+  rf->n_queue = n_queue;
+  for (int i = 0; i < n_queue; i++) {
+    queue_alloc(&rf->queues[i], RING_FIFO_MIN_N_SLOT);
+  }
+  return rf;
+}
+
+void ring_fifo_free(ring_fifo_t *rf) {
+  for (int i = 0; i < rf->n_queue; i++) {
+    free(rf->queues[i].slots);
+  }
+  free(rf);
+}
+
+/* the ring is full, squeeze out the holes into a ring of the same size if at
+ * least half of the slots are holes, otherwise into a ring twice as large,
+ * either way the next n_slot / 2 pushes do not rebuild the ring */
+static void queue_rebuild(ring_fifo_queue_t *q) {
+  int64_t n_slot = q->mask + 1;
+  cache_obj_t **old_slots = q->slots;
+  int64_t old_mask = q->mask;
+
+  queue_alloc(q, q->n_obj <= n_slot / 2 ? n_slot : n_slot * 2);
+
+  int64_t pos = q->head;
+  for (int64_t i = q->head; i < q->tail; i++) {
+    cache_obj_t *obj = old_slots[i & old_mask];
+    if (obj == NULL) continue;
+    obj->ring_fifo.pos = pos;
+    q->slots[pos & q->mask] = obj;
+    pos += 1;
+  }
+  q->tail = pos;
+  free(old_slots);
+}
+
+void ring_fifo_push(ring_fifo_t *rf, int queue_id, cache_obj_t *obj) {
+  ring_fifo_queue_t *q = &rf->queues[queue_id];
+  if (q->tail - q->head > q->mask) {
+    queue_rebuild(q);
+  }
+
+  q->slots[q->tail & q->mask] = obj;
+  obj->ring_fifo.pos = q->tail;
+  obj->ring_fifo.queue_id = (int8_t)queue_id;
+  q->tail += 1;
+  q->n_obj += 1;
+  q->n_byte += obj->obj_size;
+}
+
+void ring_fifo_remove(ring_fifo_t *rf, cache_obj_t *obj) {
+  ring_fifo_queue_t *q = &rf->queues[obj->ring_fifo.queue_id];
+  DEBUG_ASSERT(q->slots[obj->ring_fifo.pos & q->mask] == obj);
+  q->slots[obj->ring_fifo.pos & q->mask] = NULL;
+  q->n_obj -= 1;
+  q->n_byte -= obj->obj_size;
+
+  /* keep the ring short when objects are removed from either end */
+  if (obj->ring_fifo.pos == q->tail - 1) {
+    q->tail -= 1;
+  } else if (obj->ring_fifo.pos == q->head) {
+    q->head += 1;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,92 @@
+//
+//  ringFifo.h
+//  libCacheSim
+//
+//  a small set of FIFO queues stored as rings of object pointers, the core of
+//  the FIFO-family algorithms (S3FIFO, QDLP) that keep all their objects in
+//  the cache hash table and only move pointers between queues
+//
+//  each object records its queue id and its position in the queue in
+//  obj->ring_fifo, so moving an object to the tail of a queue, e.g., when it
+//  is promoted from the small queue to the main queue or reinserted by the
+//  clock, does not touch the hash table or allocate. Removing an object from
+//  the middle of a queue leaves a hole in the ring, holes are skipped when
+//  looking for the oldest object and squeezed out when the ring is full
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RING_FIFO_MAX_N_QUEUE 4
+
+typedef struct {
+  /* slots[pos & mask], NULL marks a removed object */
+  cache_obj_t **slots;
+  /* positions of the oldest object and after the newest object */
+  int64_t head;
+  int64_t tail;
+  int64_t mask;
+
+  int64_t n_obj;
+  int64_t n_byte;
+} ring_fifo_queue_t;
+
+typedef struct ring_fifo {
+  ring_fifo_queue_t queues[RING_FIFO_MAX_N_QUEUE];
+  int n_queue;
+} ring_fifo_t;
+
+/**
+ * @brief create n_queue empty queues, the rings grow when needed
+ */
+ring_fifo_t *ring_fifo_init(int n_queue);
+
+void ring_fifo_free(ring_fifo_t *rf);
+
+/**
+ * @brief append the object to the tail (newest end) of the queue, the object
+ * must not be in any queue
+ */
+void ring_fifo_push(ring_fifo_t *rf, int queue_id, cache_obj_t *obj);
+
+/**
+ * @brief remove the object from its queue
+ */
+void ring_fifo_remove(ring_fifo_t *rf, cache_obj_t *obj);
+
+/**
+ * @brief the oldest object in the queue, or NULL if the queue is empty
+ */
+static inline cache_obj_t *ring_fifo_oldest(ring_fifo_t *rf, int queue_id) {
+  ring_fifo_queue_t *q = &rf->queues[queue_id];
+  while (q->head < q->tail) {
+    cache_obj_t *obj = q->slots[q->head & q->mask];
+    if (obj != NULL) return obj;
+    q->head += 1;
+  }
+  return NULL;
+}
+
+/**
+ * @brief move the object from its queue to the tail of queue_id, which can be
+ * the same queue
+ */
+static inline void ring_fifo_move_to_tail(ring_fifo_t *rf, cache_obj_t *obj, int queue_id) {
+  ring_fifo_remove(rf, obj);
+  ring_fifo_push(rf, queue_id, obj);
+}
+
+static inline int64_t ring_fifo_n_obj(const ring_fifo_t *rf, int queue_id) { return rf->queues[queue_id].n_obj; }
+
+static inline int64_t ring_fifo_n_byte(const ring_fifo_t *rf, int queue_id) { return rf->queues[queue_id].n_byte; }
+
+#ifdef __cplusplus
+}
+#endif
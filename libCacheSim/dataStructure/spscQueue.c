@@ -0,0 +1,43 @@
+//
+//  spscQueue.c
+//  libCacheSim
+//
+//  see spscQueue.h
+//
+
+#include "spscQueue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+spsc_queue_t *spsc_queue_new(int64_t capacity) {
+  if (capacity < 2 * SPSC_QUEUE_BATCH || (capacity & (capacity - 1)) != 0) {
+    ERROR("the queue capacity must be a power of two and at least %d, got %lld\n", 2 * SPSC_QUEUE_BATCH,
+          (long long)capacity);
+  }
+  spsc_queue_t *q = aligned_alloc(64, sizeof(spsc_queue_t));
+  memset(q, 0, sizeof(spsc_queue_t));
+  q->reqs = malloc(sizeof(queued_req_t) * capacity);
+  q->mask = capacity - 1;
+  return q;
+}
+
+void spsc_queue_free(spsc_queue_t *q) {
+  free(q->reqs);
+  free(q);
+}
+
+void spsc_queue_close(spsc_queue_t *q) {
+  spsc_queue_flush(q);
+  __atomic_store_n(&q->closed, true, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,117 @@
+//
+//  spscQueue.h
+//  libCacheSim
+//
+//  a bounded lock-free queue of requests between one producer thread and one
+//  consumer thread, used to pass request streams between the threads of the
+//  pipelined simulations (cacheHierarchy.c, cacheCluster.c)
+//
+//  the producer publishes the requests in batches and the consumer returns
+//  the free slots in batches, so the two threads touch the shared indices
+//  once every SPSC_QUEUE_BATCH requests. A producer that finds the queue full
+//  and a consumer that finds it empty yield the CPU
+//
+
+#pragma once
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../include/libCacheSim/request.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPSC_QUEUE_BATCH 64
+
+typedef struct {
+  int64_t clock_time;
+  obj_id_t obj_id;
+  int64_t obj_size;
+  /* defined by the user, e.g., the message type or the destination */
+  int32_t type;
+  int32_t dst;
+} queued_req_t;
+
+typedef struct {
+  queued_req_t *reqs;
+  int64_t mask;
+
+  /* shared, head is written by the consumer, tail and closed by the producer */
+  int64_t head __attribute__((aligned(64)));
+  int64_t tail __attribute__((aligned(64)));
+  bool closed;
+
+  /* private to the producer */
+  int64_t local_tail __attribute__((aligned(64)));
+  int64_t cached_head;
+
+  /* private to the consumer */
+  int64_t local_head __attribute__((aligned(64)));
+  int64_t cached_tail;
+} spsc_queue_t;
+
+/**
+ * @brief create a queue, capacity must be a power of two and at least
+ * 2 * SPSC_QUEUE_BATCH
+ */
+spsc_queue_t *spsc_queue_new(int64_t capacity);
+
+void spsc_queue_free(spsc_queue_t *q);
+
+static inline void spsc_queue_flush(spsc_queue_t *q) {
+  __atomic_store_n(&q->tail, q->local_tail, __ATOMIC_RELEASE);
+}
+
+static inline void spsc_queue_push(spsc_queue_t *q, const queued_req_t *req) {
+  if (q->local_tail - q->cached_head > q->mask) {
+    spsc_queue_flush(q);
+    while ((q->cached_head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) + q->mask + 1 == q->local_tail) {
+      sched_yield();
+    }
+  }
+  q->reqs[q->local_tail & q->mask] = *req;
+  q->local_tail += 1;
+  if ((q->local_tail & (SPSC_QUEUE_BATCH - 1)) == 0) {
+    spsc_queue_flush(q);
+  }
+}
+
+/**
+ * @brief publish the pending requests and tell the consumer that no more
+ * requests will come
+ */
+void spsc_queue_close(spsc_queue_t *q);
+
+/**
+ * @brief the oldest request in the queue, wait if the queue is empty, return
+ * NULL if the queue is closed and empty
+ */
+static inline const queued_req_t *spsc_queue_peek(spsc_queue_t *q) {
+  while (q->local_head == q->cached_tail) {
+    __atomic_store_n(&q->head, q->local_head, __ATOMIC_RELEASE);
+    /* load closed before tail, so the tail is final if closed is set */
+    bool closed = __atomic_load_n(&q->closed, __ATOMIC_ACQUIRE);
+    q->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (q->local_head != q->cached_tail) break;
+    if (closed) return NULL;
+    sched_yield();
+  }
+  return &q->reqs[q->local_head & q->mask];
+}
+
+/**
+ * @brief remove the request returned by spsc_queue_peek
+ */
+static inline void spsc_queue_pop(spsc_queue_t *q) {
+  q->local_head += 1;
+  if ((q->local_head & (SPSC_QUEUE_BATCH - 1)) == 0) {
+    __atomic_store_n(&q->head, q->local_head, __ATOMIC_RELEASE);
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,140 @@
+//
+//  ttlWheel.c
+//  libCacheSim
+//
+//  see ttlWheel.h
+//
+
+#include "ttlWheel.h"
+
+#include <stdlib.h>
+
+#include "../include/libCacheSim/logging.h"
+#include "../include/libCacheSim/macro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SUPPORT_TTL
+
+#define SLOT_MASK (TTL_WHEEL_N_SLOT - 1)
+
+ttl_wheel_t *ttl_wheel_init(void) {
+  ttl_wheel_t *wheel = calloc(1, sizeof(ttl_wheel_t));
+  if (wheel == NULL) {
+    ERROR("ttl wheel: failed to allocate\n");
+  }
+  return wheel;
+}
+
+void ttl_wheel_free(ttl_wheel_t *wheel) { free(wheel); }
+
+static inline void link_obj(ttl_wheel_t *wheel, cache_obj_t *obj) {
+  int64_t exp_time = obj->exp_time;
+  /* an object that has already expired is popped at the next advance */
+  if (exp_time < wheel->curr_time) exp_time = wheel->curr_time;
+
+  int level = 0;
+  while (level < TTL_WHEEL_N_LEVEL - 1 &&
+         (exp_time >> (TTL_WHEEL_SLOT_BITS * (level + 1))) !=
+             (wheel->curr_time >> (TTL_WHEEL_SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+  int slot = (int)((exp_time >> (TTL_WHEEL_SLOT_BITS * level)) & SLOT_MASK);
+
+  cache_obj_t *head = wheel->slots[level][slot];
+  obj->ttl_wheel.prev = NULL;
+  obj->ttl_wheel.next = head;
+  if (head != NULL) head->ttl_wheel.prev = obj;
+  obj->ttl_wheel.slot_id = (uint16_t)(level * TTL_WHEEL_N_SLOT + slot + 1);
+  wheel->slots[level][slot] = obj;
+
+  wheel->n_obj_in_level[level] += 1;
+  wheel->n_obj += 1;
+}
+
+static inline void unlink_obj(ttl_wheel_t *wheel, cache_obj_t *obj) {
+  int level = (obj->ttl_wheel.slot_id - 1) / TTL_WHEEL_N_SLOT;
+  int slot = (obj->ttl_wheel.slot_id - 1) % TTL_WHEEL_N_SLOT;
+  if (obj->ttl_wheel.prev != NULL) {
+    obj->ttl_wheel.prev->ttl_wheel.next = obj->ttl_wheel.next;
+  } else {
+    wheel->slots[level][slot] = obj->ttl_wheel.next;
+  }
+  if (obj->ttl_wheel.next != NULL) {
+    obj->ttl_wheel.next->ttl_wheel.prev = obj->ttl_wheel.prev;
+  }
+  obj->ttl_wheel.prev = NULL;
+  obj->ttl_wheel.next = NULL;
+  obj->ttl_wheel.slot_id = 0;
+
+  wheel->n_obj_in_level[level] -= 1;
+  wheel->n_obj -= 1;
+}
+
+void ttl_wheel_insert(ttl_wheel_t *wheel, cache_obj_t *obj) {
+  DEBUG_ASSERT(obj->exp_time != 0);
+  if (ttl_wheel_contains(obj)) unlink_obj(wheel, obj);
+  link_obj(wheel, obj);
+}
+
+void ttl_wheel_remove(ttl_wheel_t *wheel, cache_obj_t *obj) {
+  if (ttl_wheel_contains(obj)) unlink_obj(wheel, obj);
+}
+
+/* move the slots that start at curr_time to the lower levels, from the
+ * highest level so that an object can move down more than one level */
+static void cascade(ttl_wheel_t *wheel) {
+  for (int level = TTL_WHEEL_N_LEVEL - 1; level > 0; level--) {
+    int64_t span = 1LL << (TTL_WHEEL_SLOT_BITS * level);
+    if ((wheel->curr_time & (span - 1)) != 0) continue;
+
+    int slot = (int)((wheel->curr_time >> (TTL_WHEEL_SLOT_BITS * level)) & SLOT_MASK);
+    cache_obj_t *obj = wheel->slots[level][slot];
+    while (obj != NULL) {
+      cache_obj_t *next = obj->ttl_wheel.next;
+      unlink_obj(wheel, obj);
+      link_obj(wheel, obj);
+      obj = next;
+    }
+  }
+}
+
+cache_obj_t *ttl_wheel_pop_expired(ttl_wheel_t *wheel, int64_t now) {
+  while (wheel->curr_time < now) {
+    if (wheel->n_obj == 0) {
+      wheel->curr_time = now;
+      return NULL;
+    }
+
+    /* the level 0 slot of curr_time holds the objects expiring at curr_time */
+    cache_obj_t *obj = wheel->slots[0][wheel->curr_time & SLOT_MASK];
+    if (obj != NULL) {
+      unlink_obj(wheel, obj);
+      return obj;
+    }
+
+    /* skip to the next multiple of 256^level where the lowest non-empty
+     * level cascades, the slots in between are empty */
+    int level = 0;
+    while (wheel->n_obj_in_level[level] == 0) level++;
+    int64_t next_time = level == 0 ? wheel->curr_time + 1
+                                   : (wheel->curr_time | ((1LL << (TTL_WHEEL_SLOT_BITS * level)) - 1)) + 1;
+    if (next_time > now) {
+      /* only level > 0 can be skipped past now, and nothing expires before
+       * next_time, the objects stay in the same slots */
+      wheel->curr_time = now;
+      return NULL;
+    }
+    wheel->curr_time = next_time;
+    if ((next_time & SLOT_MASK) == 0) cascade(wheel);
+  }
+  return NULL;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,70 @@
+//
+//  ttlWheel.h
+//  libCacheSim
+//
+//  a hierarchical timing wheel that holds the cached objects by exp_time, so
+//  that expired objects are reclaimed as the clock advances instead of
+//  staying in the cache until they are looked up or evicted
+//
+//  the wheel has 4 levels of 256 slots, level l holds the objects whose
+//  exp_time shares all but the lowest 8 * (l + 1) bits with the current time,
+//  in the slot of bits [8 * l, 8 * (l + 1)) of exp_time. when the current
+//  time crosses a multiple of 256^l, the slot of level l that starts there is
+//  moved to the lower levels. a slot is a doubly linked list through
+//  obj->ttl_wheel, so insert and remove are O(1)
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include "../include/libCacheSim/cacheObj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SUPPORT_TTL
+
+#define TTL_WHEEL_N_LEVEL 4
+#define TTL_WHEEL_SLOT_BITS 8
+#define TTL_WHEEL_N_SLOT (1 << TTL_WHEEL_SLOT_BITS)
+
+typedef struct ttl_wheel {
+  /* the objects that expire before curr_time have been popped */
+  int64_t curr_time;
+  int64_t n_obj;
+  int64_t n_obj_in_level[TTL_WHEEL_N_LEVEL];
+  cache_obj_t *slots[TTL_WHEEL_N_LEVEL][TTL_WHEEL_N_SLOT];
+} ttl_wheel_t;
+
+ttl_wheel_t *ttl_wheel_init(void);
+
+void ttl_wheel_free(ttl_wheel_t *wheel);
+
+/**
+ * @brief add an object with a non-zero exp_time to the wheel, an object that
+ * is already in the wheel is moved to its new exp_time
+ */
+void ttl_wheel_insert(ttl_wheel_t *wheel, cache_obj_t *obj);
+
+/**
+ * @brief remove an object from the wheel, no-op if it is not in the wheel
+ */
+void ttl_wheel_remove(ttl_wheel_t *wheel, cache_obj_t *obj);
+
+/**
+ * @brief advance the wheel to now and pop one object that expired before now
+ *
+ * @return the expired object, which is no longer in the wheel, or NULL if
+ * all expired objects have been popped
+ */
+cache_obj_t *ttl_wheel_pop_expired(ttl_wheel_t *wheel, int64_t now);
+
+static inline bool ttl_wheel_contains(const cache_obj_t *obj) { return obj->ttl_wheel.slot_id != 0; }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
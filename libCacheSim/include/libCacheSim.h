@@ -26,8 +26,14 @@
 #include "libCacheSim/sampling.h"
 
 /* cache simulator */
+#include "libCacheSim/cacheCluster.h"
+#include "libCacheSim/cacheHierarchy.h"
+#include "libCacheSim/checkpoint.h"
+#include "libCacheSim/concurrentCache.h"
+#include "libCacheSim/convergence.h"
 #include "libCacheSim/plugin.h"
 #include "libCacheSim/profilerLRU.h"
+#include "libCacheSim/shardedCache.h"
 #include "libCacheSim/simulator.h"
 
 #endif  // libCacheSim_H
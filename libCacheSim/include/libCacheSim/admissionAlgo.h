@@ -29,6 +29,7 @@ admissioner_t *create_prob_admissioner(const char *init_params);
 admissioner_t *create_size_admissioner(const char *init_params);
 admissioner_t *create_size_probabilistic_admissioner(const char *init_params);
 admissioner_t *create_adaptsize_admissioner(const char *init_params);
+admissioner_t *create_tinylfu_admissioner(const char *init_params);
 
 static inline admissioner_t *create_admissioner(const char *admission_algo, const char *admission_params) {
   admissioner_t *admissioner = NULL;
@@ -42,6 +43,8 @@ static inline admissioner_t *create_admissioner(const char *admission_algo, cons
     admissioner = create_size_probabilistic_admissioner(admission_params);
   } else if (strcasecmp(admission_algo, "adaptsize") == 0) {
     admissioner = create_adaptsize_admissioner(admission_params);
+  } else if (strcasecmp(admission_algo, "tinylfu") == 0) {
+    admissioner = create_tinylfu_admissioner(admission_params);
   } else {
     ERROR("admission algo %s not supported\n", admission_algo);
   }
@@ -65,6 +65,14 @@ typedef int64_t (*cache_get_n_obj_func_ptr)(const cache_t *);
 
 typedef void (*cache_print_cache_func_ptr)(const cache_t *);
 
+/* called by cache_evict_base before the evicted object is freed */
+typedef void (*cache_evict_listener_func_ptr)(cache_t *, const cache_obj_t *, void *);
+
+/* write and read the state of the eviction algorithm, see checkpoint.h */
+typedef bool (*cache_serialize_func_ptr)(const cache_t *, FILE *);
+
+typedef bool (*cache_deserialize_func_ptr)(cache_t *, FILE *);
+
 // #define EVICTION_AGE_ARRAY_SZE 40
 #define EVICTION_AGE_ARRAY_SZE 320
 #define EVICTION_AGE_LOG_BASE 1.08
@@ -83,8 +91,15 @@ typedef struct {
   float sampler_ratio;
   /* current trace time, used to determine obj expiration */
   int64_t curr_rtime;
+  /* the number of objects and bytes removed because they expired */
   int64_t expired_obj_cnt;
   int64_t expired_bytes;
+  /* set when the simulation stops because the miss ratio has converged,
+   * see convergence.h */
+  bool early_stopped;
+  /* the half width of the confidence interval of the miss ratio, 0 if the
+   * simulation does not stop early */
+  double miss_ratio_ci;
 
   char cache_name[CACHE_NAME_ARRAY_LEN];
 } cache_stat_t;
@@ -112,6 +127,19 @@ struct cache {
 
   struct prefetcher *prefetcher;
 
+  /* notified of every eviction, e.g., to demote the evicted objects to the
+   * next level of a cache hierarchy, see cacheHierarchy.h */
+  cache_evict_listener_func_ptr evict_listener;
+  void *evict_listener_data;
+  /* set by the algorithms that evict from their internal caches, these
+   * evictions do not go through cache_evict_base and evict_listener */
+  bool evict_in_sub_cache;
+
+  /* used by cache_checkpoint and cache_restore, NULL if the algorithm does
+   * not support checkpoints */
+  cache_serialize_func_ptr serialize;
+  cache_deserialize_func_ptr deserialize;
+
   void *eviction_params;
 
   // other name: logical_time, virtual_time, reference_count
@@ -147,6 +175,13 @@ struct cache {
   char init_params[CACHE_INIT_PARAMS_LEN];
 
   const char *last_request_metadata;
+#ifdef SUPPORT_TTL
+  /* objects with an exp_time, expired objects are removed when the clock
+   * advances in cache_get_base, see dataStructure/ttlWheel.h */
+  struct ttl_wheel *ttl_wheel;
+  int64_t n_expired_obj;
+  int64_t n_expired_byte;
+#endif
 #if defined(TRACK_EVICTION_V_AGE)
   bool track_eviction_age;
 #endif
@@ -264,6 +299,17 @@ void cache_remove_obj_base(cache_t *cache, cache_obj_t *obj,
 void cache_evict_base(cache_t *cache, cache_obj_t *obj,
                       bool remove_from_hashtable);
 
+#ifdef SUPPORT_TTL
+/**
+ * @brief remove the objects that expired before now, it is called by
+ * cache_get_base, algorithms that manage sub-caches can call it on them
+ *
+ * @param cache the cache
+ * @param now the current trace time
+ */
+void cache_expire(cache_t *cache, int64_t now);
+#endif
+
 /**
  * @brief get the number of bytes occupied, this is the default
  * for most algorithms, but some algorithms may have different implementation
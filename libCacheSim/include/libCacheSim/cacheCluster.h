@@ -0,0 +1,127 @@
+//
+//  cacheCluster.h
+//  libCacheSim
+//
+//  simulate a cluster of cache servers (e.g., a CDN tier) that the requests
+//  are routed to by consistent hashing
+//
+//  the calling thread reads the trace, routes every request to its server
+//  and batches the requests into one single-producer single-consumer queue
+//  per worker thread, each worker owns the caches of a subset of the servers,
+//  so the servers are simulated in parallel and every server sees its
+//  requests in trace order, the result does not depend on the number of
+//  threads
+//
+//  servers can be removed and added during the replay, a removed server loses
+//  its content and its requests are routed to the other servers, an added
+//  server starts empty
+//
+//  usage:
+//    cache_cluster_t *cluster = create_cache_cluster(lru, 100, CLUSTER_ROUTING_KETAMA);
+//    cache_cluster_add_event(cluster, 3600, CLUSTER_EVENT_REMOVE_SERVER, 7);
+//    simulate_cache_cluster(cluster, reader, 8);
+//    cluster->stat, cluster->server_stats[i], cache_cluster_load_imbalance(cluster)
+//    free_cache_cluster(cluster);
+//
+
+#ifndef libCacheSim_CACHECLUSTER_H
+#define libCacheSim_CACHECLUSTER_H
+
+#include "cache.h"
+#include "reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLUSTER_N_VNODE_PER_SERVER 160
+
+typedef enum {
+  /* a ketama ring with CLUSTER_N_VNODE_PER_SERVER points per server, stored
+   * as a sorted array and searched with binary search */
+  CLUSTER_ROUTING_KETAMA,
+  /* jump consistent hashing, the requests of a removed server are re-hashed
+   * until they land on an active server */
+  CLUSTER_ROUTING_JUMP_HASH,
+} cluster_routing_e;
+
+typedef enum {
+  CLUSTER_EVENT_ADD_SERVER,
+  CLUSTER_EVENT_REMOVE_SERVER,
+} cluster_event_type_e;
+
+typedef struct {
+  /* trace time since the first request, the event happens before the first
+   * request at or after this time */
+  int64_t time;
+  cluster_event_type_e type;
+  int server_id;
+} cluster_event_t;
+
+typedef struct cache_cluster {
+  int n_server;
+  cache_t **servers;
+  /* whether a server receives requests */
+  bool *active;
+  cluster_routing_e routing;
+
+  cluster_event_t *events;
+  int n_event;
+
+  /* results */
+  cache_stat_t *server_stats;
+  cache_stat_t stat;
+
+  /* the capacity of the queue of a worker in requests, a power of two and
+   * at least 2 * SPSC_QUEUE_BATCH */
+  int64_t queue_size;
+
+  /* the ketama ring of the active servers sorted by point */
+  uint64_t *ring_points;
+  int32_t *ring_servers;
+  int64_t n_ring_point;
+} cache_cluster_t;
+
+/**
+ * @brief create a cluster of n_server servers, each server has a cache with
+ * the algorithm, size and parameters of cache, created with
+ * create_cache_with_new_size, all the servers are active at the start
+ */
+cache_cluster_t *create_cache_cluster(const cache_t *cache, int n_server, cluster_routing_e routing);
+
+/**
+ * @brief add or remove a server at the trace time, a server that should not
+ * be active at the start can be removed at time 0
+ */
+void cache_cluster_add_event(cache_cluster_t *cluster, int64_t time, cluster_event_type_e type, int server_id);
+
+/**
+ * @brief the server of the object with the current active servers
+ */
+int cache_cluster_route(const cache_cluster_t *cluster, obj_id_t obj_id);
+
+/**
+ * @brief replay the reader on the cluster with n_thread worker threads, the
+ * reader is cloned, the results are in cluster->stat and
+ * cluster->server_stats
+ */
+void simulate_cache_cluster(cache_cluster_t *cluster, reader_t *reader, int n_thread);
+
+/**
+ * @brief the number of requests of the busiest server divided by the mean
+ * over the servers that received requests, 1 is perfectly balanced
+ */
+double cache_cluster_load_imbalance(const cache_cluster_t *cluster);
+
+void free_cache_cluster(cache_cluster_t *cluster);
+
+/**
+ * @brief parse ketama or jump, return false if the routing is unknown
+ */
+bool parse_cluster_routing(const char *str, cluster_routing_e *routing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libCacheSim_CACHECLUSTER_H */
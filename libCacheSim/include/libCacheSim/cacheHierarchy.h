@@ -0,0 +1,126 @@
+//
+//  cacheHierarchy.h
+//  libCacheSim
+//
+//  simulate a multi-level cache hierarchy in one pass over the traces, the
+//  top level has one cache per trace (e.g., several L1 caches) and each lower
+//  level has one cache, or one cache per size to compute the miss ratio curve
+//  of the level, the first size is the one that sends its misses to the level
+//  below
+//
+//  each cache of the top level and each lower level runs on its own thread,
+//  the levels are connected by bounded lock-free single-producer
+//  single-consumer queues that carry the misses, demotions and write-backs in
+//  memory, and a level with several upper caches merges their streams by the
+//  request timestamp. A level never waits for the level below, so the
+//  simulation is a pipeline and the result is the same as simulating the
+//  levels one after another
+//
+//  usage:
+//    cache_hierarchy_t *h = create_cache_hierarchy(CACHE_HIERARCHY_INCLUSIVE);
+//    cache_hierarchy_add_level(h, l1_cache, l1_sizes, n_l1);
+//    cache_hierarchy_add_level(h, l2_cache, l2_sizes, n_l2_size);
+//    simulate_cache_hierarchy(h, readers, n_l1);
+//    h->levels[1].stats[i].n_miss ...
+//    free_cache_hierarchy(h);
+//
+
+#ifndef libCacheSim_CACHEHIERARCHY_H
+#define libCacheSim_CACHEHIERARCHY_H
+
+#include "cache.h"
+#include "reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHE_HIERARCHY_MAX_LEVEL 8
+
+typedef enum {
+  /* a miss is sent to the level below, and every level inserts the objects
+   * it misses, the lower levels do not invalidate the upper levels */
+  CACHE_HIERARCHY_INCLUSIVE,
+  /* a miss is looked up in the level below and a hit moves the object up
+   * (removes it from the lower level), the objects evicted from a level are
+   * demoted to the level below, so an object is in at most one level */
+  CACHE_HIERARCHY_EXCLUSIVE,
+  /* reads are handled as in the inclusive hierarchy, writes (set, add,
+   * replace, cas, append, prepend, write, update) are absorbed by the top
+   * level and mark the object dirty, and a dirty object is written to the
+   * level below when it is evicted */
+  CACHE_HIERARCHY_WRITE_BACK,
+} cache_hierarchy_policy_e;
+
+typedef struct {
+  /* n_req and n_miss count the requests from the trace or the misses of the
+   * level above */
+  cache_stat_t stat;
+  /* the objects demoted or written back from the level above */
+  int64_t n_demote;
+  int64_t n_demote_byte;
+  /* the dirty objects written back to the level below */
+  int64_t n_writeback;
+  int64_t n_writeback_byte;
+} cache_hierarchy_stat_t;
+
+typedef struct {
+  int n_cache;
+  cache_t **caches;
+  cache_hierarchy_stat_t *stats;
+} cache_hierarchy_level_t;
+
+typedef struct cache_hierarchy {
+  cache_hierarchy_policy_e policy;
+  int n_level;
+  cache_hierarchy_level_t levels[CACHE_HIERARCHY_MAX_LEVEL];
+  /* the capacity of the queue between two caches in requests, a power of two
+   * and at least 2 * SPSC_QUEUE_BATCH */
+  int64_t queue_size;
+} cache_hierarchy_t;
+
+cache_hierarchy_t *create_cache_hierarchy(cache_hierarchy_policy_e policy);
+
+/**
+ * @brief add a level below the current lowest level, the caches of the level
+ * are created with create_cache_with_new_size, cache is not used after this
+ * returns
+ *
+ * the top level has one cache per reader, and a lower level simulates all the
+ * sizes on the miss stream of the level above, the misses of the first size
+ * go to the next level. In an exclusive or write-back hierarchy, the levels
+ * above the lowest one cannot use an algorithm that evicts from internal
+ * caches (evict_in_sub_cache, e.g., TwoQ, WTinyLFU and Cacheus)
+ *
+ * @param hierarchy
+ * @param cache the algorithm and parameters of the level
+ * @param cache_sizes
+ * @param n_size
+ */
+void cache_hierarchy_add_level(cache_hierarchy_t *hierarchy, const cache_t *cache, const uint64_t *cache_sizes,
+                               int n_size);
+
+/**
+ * @brief replay the readers on the hierarchy, readers[i] is the trace of the
+ * i-th cache of the top level, the results are in levels[l].stats
+ *
+ * the readers are cloned, and the caches keep their content after this
+ * returns
+ */
+void simulate_cache_hierarchy(cache_hierarchy_t *hierarchy, reader_t **readers, int n_reader);
+
+void free_cache_hierarchy(cache_hierarchy_t *hierarchy);
+
+const char *cache_hierarchy_policy_str(cache_hierarchy_policy_e policy);
+
+/**
+ * @brief parse inclusive, exclusive or write-back, return false if the
+ * policy is unknown
+ */
+bool parse_cache_hierarchy_policy(const char *str, cache_hierarchy_policy_e *policy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libCacheSim_CACHEHIERARCHY_H */
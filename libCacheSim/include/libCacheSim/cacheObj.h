@@ -19,6 +19,8 @@ extern "C" {
 // ############## per object metadata used in eviction algorithm cache obj
 typedef struct {
   int64_t freq;
+  // the freq node the object is on, see dataStructure/freqList.h
+  struct freq_node *freq_node;
 } LFU_obj_metadata_t;
 
 typedef struct {
@@ -37,12 +39,14 @@ typedef struct {
 } ClockPro_obj_metadata_t;
 
 typedef struct {
-  void *pq_node;
-} Size_obj_metadata_t;
+  double key;
+  int64_t seq;       // breaks ties in insertion order in the exact mode
+  int32_t heap_pos;  // position in the bucket heap in the exact mode
+  int8_t bucket;
+} __attribute__((packed)) BucketQueue_obj_metadata_t;
 
 typedef struct {
   int lru_id;
-  bool ghost;
 } ARC_obj_metadata_t;
 
 typedef struct {
@@ -50,7 +54,6 @@ typedef struct {
   void *lfu_prev;
   int64_t eviction_vtime:40;
   int64_t freq:24;
-  bool is_ghost;
   int8_t evict_expert; // 1: LRU, 2: LFU
 } __attribute__((packed)) LeCaR_obj_metadata_t;
 
@@ -134,6 +137,12 @@ typedef struct {
   int32_t main_insert_freq;
 } S3FIFO_obj_metadata_t;
 
+typedef struct {
+  int64_t pos;       // position in the queue ring, see dataStructure/ringFifo.h
+  int32_t freq;
+  int8_t queue_id;
+} __attribute__((packed)) RingFIFO_obj_metadata_t;
+
 typedef struct {
   // int32_t freq;
   int lru_id;
@@ -145,6 +154,11 @@ typedef struct {
   int32_t freq;
 } __attribute__((packed)) Sieve_obj_params_t;
 
+typedef struct {
+  int64_t freq;
+  int32_t heap_pos;  // position in the ranking heap
+} __attribute__((packed)) Rank_obj_metadata_t;
+
 typedef struct {
   int64_t next_access_vtime;
   int32_t freq;
@@ -162,6 +176,12 @@ typedef struct cache_obj {
   } queue;  // for LRU, FIFO, etc.
 #ifdef SUPPORT_TTL
   uint32_t exp_time;
+  struct {
+    struct cache_obj *prev;
+    struct cache_obj *next;
+    // level * n_slot + slot + 1, 0 if the object is not in the wheel
+    uint16_t slot_id;
+  } ttl_wheel;  // for expiring objects, see dataStructure/ttlWheel.h
 #endif
 /* age is defined as the time since the object entered the cache */
 #if defined(TRACK_EVICTION_V_AGE) || \
@@ -175,7 +195,7 @@ typedef struct cache_obj {
     LFU_obj_metadata_t lfu;          // for LFU
     Clock_obj_metadata_t clock;      // for Clock
     ClockPro_obj_metadata_t clockpro;// for ClockPro
-    Size_obj_metadata_t Size;        // for Size
+    BucketQueue_obj_metadata_t bucket_queue;  // for Size and GDSF, see dataStructure/bucketQueue.h
     ARC_obj_metadata_t ARC;          // for ARC
     LeCaR_obj_metadata_t LeCaR;      // for LeCaR
     Cacheus_obj_metadata_t Cacheus;  // for Cacheus
@@ -191,8 +211,10 @@ typedef struct cache_obj {
     QDLP_obj_metadata_t QDLP;
     LIRS_obj_metadata_t LIRS;
     S3FIFO_obj_metadata_t S3FIFO;
+    RingFIFO_obj_metadata_t ring_fifo;  // for S3FIFO and QDLP
     Sieve_obj_params_t sieve;
     CAR_obj_metadata_t CAR;
+    Rank_obj_metadata_t rank;        // for the C++ ranking algorithms
 
 #if defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1
     GLCache_obj_metadata_t GLCache;
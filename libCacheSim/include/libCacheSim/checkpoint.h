@@ -0,0 +1,105 @@
+//
+//  checkpoint.h
+//  libCacheSim
+//
+//  save the state of a cache to a file and restore it later, so that a cache
+//  warmed up once can be reused by the simulations of several configurations,
+//  or a long simulation can resume after a crash
+//
+//  the file has the common cache parameters and counters followed by the
+//  state written by the serialize hook of the eviction algorithm: the objects
+//  in queue order with their metadata and the parameters that change during
+//  the run (e.g., the ghost lists and p of ARC). The hash table is rebuilt
+//  from the objects with the same hash power, so a restored cache makes the
+//  same decisions as the original one
+//
+//  LRU, FIFO, Clock, Sieve, S3FIFO, ARC and LFU support checkpoints,
+//  cache_checkpoint returns false for the other algorithms and for caches
+//  with an admissioner or a prefetcher
+//
+//  the reader position is saved with reader_checkpoint, see reader.h
+//
+//  cachesim --checkpoint-dir saves the caches after the --warmup-sec warmup
+//  and restores them in later runs with the same trace, warmup and cache
+//  parameters
+//
+//  usage:
+//    simulate the warmup on cache
+//    cache_checkpoint(cache, "warm.ckpt");
+//    reader_checkpoint(reader, "warm.reader.ckpt");
+//    ...
+//    cache_t *warm_cache = cache_restore("warm.ckpt");
+//    reader_restore(reader, "warm.reader.ckpt");
+//
+
+#ifndef libCacheSim_CHECKPOINT_H
+#define libCacheSim_CHECKPOINT_H
+
+#include <stdio.h>
+
+#include "cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief whether cache_checkpoint can save the cache
+ */
+bool cache_support_checkpoint(const cache_t *cache);
+
+/**
+ * @brief save the cache to path, the file is written to a temporary file and
+ * renamed, so an existing checkpoint is not lost if the process dies
+ *
+ * @return false if the cache does not support checkpoints or the file cannot
+ * be written
+ */
+bool cache_checkpoint(const cache_t *cache, const char *path);
+
+/**
+ * @brief create a cache from a file written by cache_checkpoint
+ *
+ * @return the cache, or NULL if the file cannot be read or is not a
+ * checkpoint of a supported algorithm
+ */
+cache_t *cache_restore(const char *path);
+
+/**
+ * @brief copy the full state of the cache (objects, queues, ghosts) into a new
+ * cache of the same algorithm and size, unlike clone_cache which creates an
+ * empty cache. The state is written and read in memory in the checkpoint
+ * format, so only the caches that support checkpoints can be cloned
+ *
+ * @param cache_specific_params the parameters of the new cache, e.g., a
+ * different small-size-ratio of S3FIFO, NULL to keep the parameters of cache
+ * @return the new cache, or NULL if the cache does not support checkpoints or
+ * the state cannot be loaded with the parameters
+ */
+cache_t *deep_clone_cache(const cache_t *cache, const char *cache_specific_params);
+
+/* used by the serialize and deserialize hooks of the eviction algorithms */
+
+bool checkpoint_write(FILE *f, const void *buf, size_t size);
+
+bool checkpoint_read(FILE *f, void *buf, size_t size);
+
+/**
+ * @brief write the object id, size, expiration time and misc metadata of the
+ * object, and md, a value chosen by the algorithm such as the freq
+ */
+bool checkpoint_write_obj(FILE *f, const cache_obj_t *obj, int64_t md);
+
+/**
+ * @brief read an object written by checkpoint_write_obj and insert it into
+ * the cache with cache_insert_base, the algorithm links it into its queues
+ *
+ * @return the object, or NULL if the file ends
+ */
+cache_obj_t *checkpoint_read_obj(cache_t *cache, FILE *f, int64_t *md);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libCacheSim_CHECKPOINT_H */
@@ -0,0 +1,72 @@
+//
+//  concurrentCache.h
+//  libCacheSim
+//
+//  concurrent reference implementations of Sieve, Clock and S3FIFO, and an
+//  LRU protected by a mutex as the baseline, for measuring how the eviction
+//  algorithms scale with threads rather than simulating their miss ratio
+//
+//  the caches store keys without values and count objects instead of bytes.
+//  A lookup is lock-free: it probes a hash index of open addressing buckets
+//  and, on a hit, sets the visited bit (Clock, Sieve) or increments the
+//  frequency (S3FIFO) of the object with an atomic store, so hits never modify
+//  a list. A miss takes the eviction lock, which serializes the eviction hand
+//  and the updates of the hash index. The LRU baseline takes a mutex for every
+//  request because a hit moves the object to the head
+//
+//  a lookup racing with an eviction may hit an object that is being evicted,
+//  or miss and find the object again under the lock, both are counted as hits
+//  like a concurrent cache would serve them
+//
+
+#ifndef libCacheSim_CONCURRENTCACHE_H
+#define libCacheSim_CONCURRENTCACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct concurrent_cache;
+typedef struct concurrent_cache concurrent_cache_t;
+
+struct concurrent_cache {
+  /* look up the key and insert it on a miss, return true on a hit, can be
+   * called by multiple threads */
+  bool (*get)(concurrent_cache_t *cache, uint64_t key);
+  int64_t (*get_n_obj)(const concurrent_cache_t *cache);
+  void (*cache_free)(concurrent_cache_t *cache);
+
+  /* the number of objects */
+  int64_t cache_size;
+  void *eviction_params;
+  char cache_name[CACHE_NAME_ARRAY_LEN];
+};
+
+concurrent_cache_t *concurrent_LRU_init(int64_t cache_size);
+
+concurrent_cache_t *concurrent_Clock_init(int64_t cache_size);
+
+concurrent_cache_t *concurrent_Sieve_init(int64_t cache_size);
+
+/**
+ * @param small_size_ratio the fraction of the cache used by the small FIFO,
+ * the ghost FIFO remembers as many objects as the main FIFO
+ */
+concurrent_cache_t *concurrent_S3FIFO_init(int64_t cache_size, double small_size_ratio);
+
+/**
+ * @brief create a concurrent cache by name (lru, clock, sieve or s3fifo),
+ * return NULL if the algorithm has no concurrent implementation
+ */
+concurrent_cache_t *create_concurrent_cache(const char *algo, int64_t cache_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libCacheSim_CONCURRENTCACHE_H */
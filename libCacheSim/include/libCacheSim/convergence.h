@@ -0,0 +1,108 @@
+//
+//  convergence.h
+//  libCacheSim
+//
+//  decide when the miss ratio of a simulation has converged, so that a long
+//  simulation can stop early
+//
+//  the requests after the warmup are split into batches of batch_size
+//  requests, and the miss ratio of a batch is one sample. The steady-state
+//  miss ratio is the mean of the batch means, and its confidence interval is
+//  t * s / sqrt(k), where s is the standard deviation of the k batch means and
+//  t is the quantile of the Student's t distribution. The batch means of a
+//  cache are correlated, so the simulation only stops when the lag-1
+//  autocorrelation of the batch means is small. When
+//  CONVERGENCE_MAX_N_BATCH batches are full, adjacent batches are merged and
+//  the batch size doubles, so the batches grow until they are long enough to
+//  be nearly independent
+//
+//  usage:
+//    convergence_monitor_t monitor;
+//    convergence_monitor_init(&monitor, &params);
+//    for each request after the warmup:
+//      bool hit = cache->get(cache, req);
+//      if (convergence_monitor_add(&monitor, !hit)) break;
+//    monitor.mean, monitor.half_width
+//
+
+#ifndef libCacheSim_CONVERGENCE_H
+#define libCacheSim_CONVERGENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONVERGENCE_MAX_N_BATCH 64
+
+/* the simulation does not stop while the batch means are more correlated */
+#define CONVERGENCE_MAX_LAG1_AUTOCORR 0.2
+
+typedef struct {
+  /* stop when the half width of the confidence interval of the miss ratio is
+   * at most max_error, e.g., 0.001 */
+  double max_error;
+  /* e.g., 0.95 */
+  double confidence;
+  /* the number of requests in a batch at the start */
+  int64_t batch_size;
+  /* the number of batches before the simulation can stop, at least 2 and at
+   * most CONVERGENCE_MAX_N_BATCH */
+  int min_n_batch;
+} convergence_params_t;
+
+typedef struct {
+  convergence_params_t params;
+  int64_t batch_size;
+  int n_batch;
+  double batch_miss_ratio[CONVERGENCE_MAX_N_BATCH];
+  /* the batch that is not full yet */
+  int64_t curr_n_req;
+  int64_t curr_n_miss;
+
+  /* updated when a batch is full */
+  double mean;
+  double half_width;
+  double lag1_autocorr;
+  bool converged;
+} convergence_monitor_t;
+
+/**
+ * @brief the default parameters with the given error and confidence, batches
+ * of 10000 requests and at least 16 batches
+ */
+convergence_params_t default_convergence_params(double max_error, double confidence);
+
+void convergence_monitor_init(convergence_monitor_t *monitor, const convergence_params_t *params);
+
+/**
+ * @brief called when a batch is full, update the estimate and decide whether
+ * the miss ratio has converged
+ */
+bool convergence_monitor_end_batch(convergence_monitor_t *monitor);
+
+/**
+ * @brief add one request after the warmup
+ *
+ * @return true if the miss ratio has converged and the simulation can stop
+ */
+static inline bool convergence_monitor_add(convergence_monitor_t *monitor, bool miss) {
+  monitor->curr_n_req += 1;
+  monitor->curr_n_miss += miss;
+  if (monitor->curr_n_req < monitor->batch_size) return false;
+  return convergence_monitor_end_batch(monitor);
+}
+
+/**
+ * @brief the quantile of the Student's t distribution with df degrees of
+ * freedom for a two-sided interval with the confidence
+ */
+double student_t_quantile(double confidence, int df);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libCacheSim_CONVERGENCE_H */
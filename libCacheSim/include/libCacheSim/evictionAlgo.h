@@ -23,6 +23,9 @@ typedef struct freq_node {
   cache_obj_t *first_obj;
   cache_obj_t *last_obj;
   int32_t n_obj;
+  // the nodes with a lower and a higher freq, see dataStructure/freqList.h
+  struct freq_node *prev;
+  struct freq_node *next;
 } freq_node_t;
 
 typedef struct {
@@ -134,10 +137,16 @@ cache_t *CAR_init(const common_cache_params_t ccache_params, const char *cache_s
   
 cache_t *ThreeLCache_init(const common_cache_params_t ccache_params, const char *cache_specific_params);
 
+#ifdef ENABLE_3L_CACHE
+int64_t ThreeLCache_get_n_installed_model(const cache_t *cache);
+#endif
+
 cache_t *PQEvolve_init(const common_cache_params_t ccache_params, const char *cache_specific_params);
 
 #ifdef ENABLE_LRB
 cache_t *LRB_init(const common_cache_params_t ccache_params, const char *cache_specific_params);
+
+int64_t LRB_get_n_installed_model(const cache_t *cache);
 #endif
 
 #ifdef INCLUDE_PRIV
@@ -160,6 +169,8 @@ cache_t *MClock_init(const common_cache_params_t ccache_params, const char *cach
 
 cache_t *GLCache_init(const common_cache_params_t ccache_params, const char *cache_specific_params);
 
+int64_t GLCache_get_n_installed_model(const cache_t *cache);
+
 #endif
 
 #ifdef __cplusplus
@@ -16,11 +16,10 @@ typedef struct SR_LRU_params {
   request_t *req_local;
 } SR_LRU_params_t;
 
+struct freq_list;
+
 typedef struct CR_LFU_params {
-  freq_node_t *freq_one_node;
-  GHashTable *freq_map;
-  int64_t min_freq;
-  int64_t max_freq;
+  struct freq_list *freq_list;
   cache_t *other_cache;
   request_t *req_local;
 } CR_LFU_params_t;
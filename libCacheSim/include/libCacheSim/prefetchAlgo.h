@@ -12,11 +12,19 @@ extern "C" {
 
 struct prefetcher;
 struct cache;
+
+/* the object passed to handle_evict, it has been removed from the cache when
+ * handle_evict is called */
+typedef struct evicted_obj {
+  obj_id_t obj_id;
+  int64_t obj_size;
+} evicted_obj_t;
+
 typedef struct prefetcher *(*prefetcher_create_func_ptr)(const char *);
 typedef void (*prefetcher_prefetch_func_ptr)(struct cache *, const request_t *);
 typedef void (*prefetcher_handle_find_func_ptr)(struct cache *, const request_t *, bool);
 typedef void (*prefetcher_handle_insert_func_ptr)(struct cache *, const request_t *);
-typedef void (*prefetcher_handle_evict_func_ptr)(struct cache *, const request_t *);
+typedef void (*prefetcher_handle_evict_func_ptr)(struct cache *, const evicted_obj_t *);
 typedef void (*prefetcher_free_func_ptr)(struct prefetcher *);
 typedef struct prefetcher *(*prefetcher_clone_func_ptr)(struct prefetcher *, uint64_t);
 
@@ -30,8 +38,50 @@ typedef struct prefetcher {
   void *params;
   char *init_params;
   char prefetcher_name[64];
+
+  /* preallocated requests for inserting prefetched objects, see
+   * prefetcher_get_req */
+  request_t **req_pool;
+  int req_pool_size;
+  int req_pool_top;
 } prefetcher_t;
 
+/**
+ * @brief borrow a request to find or insert an object, so that prefetching
+ * does not allocate, the request has the content of its last use
+ *
+ * an insert can evict objects and call back into handle_evict, which may
+ * borrow another request, so requests are returned in the reverse order of
+ * borrowing with prefetcher_put_req
+ */
+static inline request_t *prefetcher_get_req(prefetcher_t *prefetcher) {
+  if (prefetcher->req_pool_top == prefetcher->req_pool_size) {
+    int new_size = prefetcher->req_pool_size == 0 ? 4 : prefetcher->req_pool_size * 2;
+    prefetcher->req_pool = (request_t **)realloc(prefetcher->req_pool, sizeof(request_t *) * new_size);
+    for (int i = prefetcher->req_pool_size; i < new_size; i++) {
+      prefetcher->req_pool[i] = new_request();
+    }
+    prefetcher->req_pool_size = new_size;
+  }
+  return prefetcher->req_pool[prefetcher->req_pool_top++];
+}
+
+static inline void prefetcher_put_req(prefetcher_t *prefetcher, request_t *req) {
+  prefetcher->req_pool_top -= 1;
+  DEBUG_ASSERT(prefetcher->req_pool[prefetcher->req_pool_top] == req);
+}
+
+/* called by the free function of each prefetcher */
+static inline void prefetcher_free_req_pool(prefetcher_t *prefetcher) {
+  for (int i = 0; i < prefetcher->req_pool_size; i++) {
+    free_request(prefetcher->req_pool[i]);
+  }
+  free(prefetcher->req_pool);
+  prefetcher->req_pool = NULL;
+  prefetcher->req_pool_size = 0;
+  prefetcher->req_pool_top = 0;
+}
+
 prefetcher_t *create_Mithril_prefetcher(const char *init_params, uint64_t cache_size);
 prefetcher_t *create_OBL_prefetcher(const char *init_params, uint64_t cache_size);
 prefetcher_t *create_PG_prefetcher(const char *init_params, uint64_t cache_size);
@@ -16,10 +16,12 @@
 
 #include <glib.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
 
+#include "../../../dataStructure/idMap.h"
 #include "../cache.h"
 
 /** related to mining table size,
@@ -75,8 +77,8 @@
  @param row_num the order of row
  @return a pointer to the beginning of the row
  */
-#define GET_ROW_IN_MTABLE(param, row_num)                        \
-  (((TS_REPRESENTATION *)(param)->rmtable->mining_table->data) + \
+#define GET_ROW_IN_MTABLE(param, row_num) \
+  ((param)->rmtable->mining_table +       \
    (param)->rmtable->mtable_row_len * (row_num))
 
 /****************************************************************************
@@ -148,6 +150,29 @@ extern "C" {
 /* the representation of timestamp */
 typedef gint64 TS_REPRESENTATION;
 
+/* how the rows of the mining table are compared, auto picks the widest
+ * instruction set the cpu supports, all give the same associations */
+typedef enum {
+  MINING_IMPL_AUTO = 0,
+  MINING_IMPL_SCALAR,
+  MINING_IMPL_SSE2,
+  MINING_IMPL_AVX2,
+  MINING_IMPL_AVX512,
+} mining_impl_e;
+
+/** when mining runs,
+ *  sync mines on the request path when the mining table is full,
+ *  async mines on a background thread and adds the associations to the
+ *  prefetch table at the first request after the thread finishes,
+ *  deterministic also mines on a background thread but adds the associations
+ *  when the mining table is full again, waiting for the thread if needed
+ **/
+typedef enum {
+  MINING_SYNC = 0,
+  MINING_ASYNC,
+  MINING_DETERMINISTIC,
+} mining_mode_e;
+
 /* when recording takes place */
 typedef enum _recording_loc {
   miss = 0,  // this is the default, change order will have effect
@@ -227,6 +252,9 @@ typedef struct {
   /** this is the control knob for whether printing out statistics **/
   gint output_statistics;
 
+  mining_impl_e mining_impl;
+  mining_mode_e mining_mode;
+
 } Mithril_init_params_t;
 
 typedef struct {
@@ -236,7 +264,7 @@ typedef struct {
    *  if the value is positive, it is pointing to recording table,
    *  if it is negative, it is pointing to mining table
    **/
-  GHashTable *hashtable;
+  id_map_t *hashtable;
 
   /** this is the location for storing recording table,
    *  recording table is N*(min_support/4+1) array,
@@ -270,15 +298,84 @@ typedef struct {
   gint8 mtable_row_len;
 
   /** location for mining table,
-   *  use GArray for quick appending
+   *  mtable_size rows of mtable_row_len, the first mining_table_len rows
+   *  are used, mining is triggered before it is full
    **/
-  GArray *mining_table;
+  gint64 *mining_table;
+  gint mining_table_len;
 
   /** this is the counter for how many obj/blocks
    *  in the mining table are ready for mining **/
   gint n_avail_mining;
 } rec_mining_t;
 
+/** one batch of mining, the full mining table is swapped with the table of
+ *  the job, so that recording continues while the job is mined
+ **/
+typedef struct {
+  /* n_row rows of the mining table, sorted by the first timestamp */
+  gint64 *table;
+  gint n_row;
+  gint row_len;
+
+  /* see Mithril_params_t */
+  gint lookahead_range;
+  gint confidence;
+  mining_impl_e impl;
+
+  /** the table is sorted into this buffer, then the two are swapped,
+   *  sort_keys holds the first timestamp and the row of each entry
+   **/
+  gint64 *table_buf;
+  guint64 *sort_keys;
+
+  /** the timestamps decoded column by column, the kth timestamp of row r is
+   *  ts_col[k * col_len + r], so that one vector compares a row with several
+   *  following rows, n_col - 1 is the max number of timestamps in a row,
+   *  the columns are padded after the last row
+   **/
+  gint32 *ts_col;
+  gint32 *n_ts;
+  obj_id_t *row_id;
+  gint n_col;
+  gint col_len;
+
+  /* the mined associations, pairs[2i] is associated with pairs[2i+1] */
+  obj_id_t *pairs;
+  gint64 n_pair;
+  gint64 pair_cap;
+
+  double mining_ms;
+
+  pthread_t miner;
+  gboolean running;
+  gboolean done;
+} Mithril_mining_job_t;
+
+typedef struct {
+  guint64 n_mining;
+  guint64 n_row;
+  guint64 n_association;
+  /* an order-dependent hash of the associations, to compare implementations */
+  guint64 association_hash;
+  /* time spent mining, on whichever thread mines */
+  double mining_ms;
+  double max_mining_ms;
+  /* time the request path waited for the background mining */
+  double blocking_ms;
+} Mithril_mining_stat_t;
+
+/* the mining of one batch, implemented in MithrilMining.c */
+mining_impl_e Mithril_resolve_mining_impl(mining_impl_e impl);
+const char *Mithril_mining_impl_name(mining_impl_e impl);
+Mithril_mining_job_t *Mithril_mining_job_init(gint mtable_size, gint row_len,
+                                              gint lookahead_range,
+                                              gint confidence,
+                                              mining_impl_e impl);
+void Mithril_mining_job_free(Mithril_mining_job_t *job);
+/* sort the rows of the job and find the associated pairs */
+void Mithril_mine(Mithril_mining_job_t *job);
+
 typedef struct {
   /* see Mithril_init_params_t */
   gint lookahead_range;
@@ -294,6 +391,12 @@ typedef struct {
   gint sequential_K;
   gint output_statistics;
 
+  /* resolved to the instruction set used, never auto */
+  mining_impl_e mining_impl;
+  mining_mode_e mining_mode;
+  Mithril_mining_job_t *mining_job;
+  Mithril_mining_stat_t mining_stat;
+
   /* mining table size */
   gint mtable_size;
 
@@ -312,7 +415,7 @@ typedef struct {
   rec_mining_t *rmtable;
 
   /* prefetch hashtable block -> index in ptable_array*/
-  GHashTable *prefetch_hashtable;
+  id_map_t *prefetch_hashtable;
 
   /* the number of current row in prefetch table */
   gint32 ptable_cur_row;
@@ -333,17 +436,17 @@ typedef struct {
   guint64 ts;
 
   // for statistics
-  GHashTable *prefetched_hashtable_Mithril;
+  id_map_t *prefetched_hashtable_Mithril;
   guint64 hit_on_prefetch_Mithril;
   guint64 num_of_prefetch_Mithril;
 
-  GHashTable *prefetched_hashtable_sequential;
+  id_map_t *prefetched_hashtable_sequential;
   guint64 hit_on_prefetch_sequential;
   guint64 num_of_prefetch_sequential;
 
   guint64 num_of_check;
 
-  GHashTable *cache_size_map;
+  id_map_t *cache_size_map;
 } Mithril_params_t;
 
 #ifdef __cplusplus
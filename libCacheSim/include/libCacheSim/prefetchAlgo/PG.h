@@ -15,6 +15,7 @@
 
 #include <glib.h>
 
+#include "../../../dataStructure/idMap.h"
 #include "../../../dataStructure/pqueue.h"
 #include "../../../traceReader/readerInternal.h"
 #include "../cache.h"
@@ -49,8 +50,8 @@ typedef struct {
 
   gboolean stop_recording;
 
-  GHashTable* graph;  // key -> graphNode_t
-  GHashTable* prefetched;
+  GHashTable* graph;     // key -> graphNode_t
+  id_map_t* prefetched;  // prefetched objects that have not been requested
   void* past_requests;  // past requests, using array instead of queue to avoid
                         // frequent memory allocation
 
@@ -58,7 +59,11 @@ typedef struct {
   gint64 num_of_prefetch;
   gint64 num_of_hit;
 
-  GHashTable* cache_size_map;  // key -> size
+  id_map_t* cache_size_map;  // key -> size
+
+  /* the objects to prefetch for the current request, reused across requests */
+  pq_node_t** prefetch_list;
+  int prefetch_list_size;
 } PG_params_t;
 
 typedef struct {
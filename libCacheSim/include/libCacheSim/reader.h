@@ -269,6 +269,30 @@ int go_back_one_req(reader_t *reader);
 
 void reader_set_read_pos(reader_t *reader, double pos);
 
+/**
+ * @brief save the position of the reader, so that a reader of the same trace
+ * can continue from here with reader_restore, used with cache_checkpoint
+ * (see checkpoint.h)
+ *
+ * @return false if the reader is between the chunks of a request split by
+ * the trace reader, has a temporal sampler, or the file cannot be written
+ */
+bool reader_checkpoint(const reader_t *reader, const char *path);
+
+/**
+ * @brief move the reader to the position saved by reader_checkpoint, the
+ * reader must be opened on the same trace with the same parameters, a zstd
+ * compressed trace is read again from the start
+ */
+bool reader_restore(reader_t *reader, const char *path);
+
+/**
+ * @brief move the reader to the position of src, a reader of the same trace,
+ * e.g., a cloned reader continues from where the warmup stopped, the same
+ * restrictions as reader_checkpoint apply
+ */
+bool reader_copy_pos(reader_t *reader, const reader_t *src);
+
 static inline void print_reader(reader_t *reader) {
   printf(
       "trace_type: %s, trace_path: %s, trace_start_offset: %d, mmap_offset: "
@@ -71,11 +71,10 @@ typedef struct request {
 } request_t;
 
 /**
- * allocate a new request_t struct and fill in necessary field
- * @return
+ * reset a request_t struct to the state of a new request
+ * @param req
  */
-static inline request_t *new_request(void) {
-  request_t *req = my_malloc(request_t);
+static inline void init_request(request_t *req) {
   memset(req, 0, sizeof(request_t));
   req->obj_size = 1;
   req->op = OP_NOP;
@@ -85,6 +84,15 @@ static inline request_t *new_request(void) {
   req->hv = 0;
   req->next_access_vtime = -2;
   req->ttl = 0;
+}
+
+/**
+ * allocate a new request_t struct and fill in necessary field
+ * @return
+ */
+static inline request_t *new_request(void) {
+  request_t *req = my_malloc(request_t);
+  init_request(req);
   return req;
 }
 
@@ -0,0 +1,63 @@
+//
+//  shardedCache.h
+//  libCacheSim
+//
+//  a thread-safe cache made of n independent shards of one eviction
+//  algorithm, each shard has 1/n of the cache size and its own lock, and a
+//  request goes to the shard of its hash value (req->hv, or the hash of the
+//  object id if the reader does not set it)
+//
+//  this models a sharded production cache: requests to different shards do
+//  not contend, and the miss ratio differs from a single cache of the same
+//  size because the objects are not spread evenly over the shards
+//
+
+#ifndef libCacheSim_SHARDEDCACHE_H
+#define libCacheSim_SHARDEDCACHE_H
+
+#include <glib.h>
+
+#include "cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sharded_cache_params {
+  int n_shard;
+  cache_t **shards;
+  /* locks[i] protects shards[i] */
+  GMutex *locks;
+} sharded_cache_params_t;
+
+/**
+ * @brief create a sharded cache with the algorithm, size and parameters of
+ * cache, the shards are created with create_cache_with_new_size, and cache is
+ * not used after this returns
+ *
+ * the returned cache can be used by multiple threads, its get, find, insert,
+ * remove and evict lock the shard of the request. The objects returned by
+ * find, insert and to_evict belong to a shard and may be evicted by another
+ * thread after the call returns. The algorithms that keep global state (e.g.,
+ * static counters) are not safe to shard
+ *
+ * @param cache the cache to shard
+ * @param n_shard the number of shards
+ */
+cache_t *sharded_cache_init(const cache_t *cache, int n_shard);
+
+/**
+ * @brief the shard of the request, chosen by its object id
+ */
+int sharded_cache_shard_of(const cache_t *cache, const request_t *req);
+
+/**
+ * @brief whether the cache is created by sharded_cache_init
+ */
+bool is_sharded_cache(const cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libCacheSim_SHARDEDCACHE_H */
@@ -9,6 +9,7 @@
 #define simulator_h
 
 #include "cache.h"
+#include "convergence.h"
 #include "reader.h"
 
 #ifdef __cplusplus
@@ -99,6 +100,188 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader,
                                          bool free_cache_when_finish, 
                                          bool use_random_seed);
 
+/**
+ * same as simulate_with_multi_caches, but each cache stops once the
+ * confidence interval of its miss ratio is narrower than early_stop->max_error,
+ * and the thread moves on to the next cache. n_req and n_miss of a stopped
+ * cache only count the requests before the stop, and early_stopped and
+ * miss_ratio_ci are set in its result
+ *
+ * @param early_stop NULL to simulate the whole trace
+ * @return
+ */
+cache_stat_t *simulate_with_multi_caches_early_stop(reader_t *reader,
+                                                    cache_t *caches[],
+                                                    int num_of_caches,
+                                                    reader_t *warmup_reader,
+                                                    double warmup_frac,
+                                                    int warmup_sec,
+                                                    int num_of_threads,
+                                                    bool free_cache_when_finish,
+                                                    bool use_random_seed,
+                                                    const convergence_params_t *early_stop);
+
+/**
+ * same as simulate_with_multi_caches_early_stop without warmup, but each
+ * cache continues from the current position of reader instead of the start
+ * of the trace, e.g., the caches were warmed up or restored from checkpoints
+ * (see checkpoint.h) and reader was moved past the warmup. The clock of the
+ * requests stays relative to the start of the trace
+ *
+ * @param early_stop NULL to simulate the rest of the trace
+ * @return
+ */
+cache_stat_t *simulate_with_multi_caches_from_reader_pos(reader_t *reader,
+                                                         cache_t *caches[],
+                                                         int num_of_caches,
+                                                         int num_of_threads,
+                                                         bool free_cache_when_finish,
+                                                         bool use_random_seed,
+                                                         const convergence_params_t *early_stop);
+
+/**
+ * same as simulate_with_multi_caches, but each cache reads from its own
+ * reader, e.g., readers with different samplers or sampling salts
+ *
+ * @param readers one reader per cache
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_reader
+ * @param warmup_frac
+ * @param warmup_sec
+ * @param num_of_threads
+ * @param free_cache_when_finish
+ * @return
+ */
+cache_stat_t *simulate_with_multi_caches_scaling(reader_t **readers,
+                                                 cache_t *caches[],
+                                                 int num_of_caches,
+                                                 reader_t *warmup_reader,
+                                                 double warmup_frac,
+                                                 int warmup_sec,
+                                                 int num_of_threads,
+                                                 bool free_cache_when_finish);
+
+typedef enum {
+  /* each thread serves the requests of its own shards in trace order, so a
+   * shard is never used by two threads */
+  CONCURRENT_DISPATCH_BY_SHARD,
+  /* the threads take the next chunk of requests in trace order and contend
+   * on the shard locks */
+  CONCURRENT_DISPATCH_BY_ARRIVAL,
+} concurrent_dispatch_e;
+
+/**
+ * replay the trace on one cache with num_of_threads threads, the trace is
+ * loaded into memory before the replay so that the reader is not timed
+ *
+ * the cache must be created by sharded_cache_init unless num_of_threads is 1,
+ * and it is not freed. The first warmup_frac of the requests are replayed by
+ * one thread in trace order and are not counted
+ *
+ * @param reader
+ * @param cache
+ * @param num_of_threads
+ * @param dispatch how the requests are assigned to the threads
+ * @param warmup_frac
+ * @param stat filled with the number of requests and misses
+ * @return the throughput in requests per second
+ */
+double simulate_concurrent(reader_t *reader,
+                           cache_t *cache,
+                           int num_of_threads,
+                           concurrent_dispatch_e dispatch,
+                           double warmup_frac,
+                           cache_stat_t *stat);
+
+typedef struct {
+  /* the requests after the warmup until the candidate is stopped */
+  cache_stat_t stat;
+  /* the number of checkpoints the candidate passed, a candidate stopped at
+   * the first checkpoint passed 0, and a candidate that reaches the end of
+   * the trace passed all checkpoints plus one */
+  int n_checkpoint_passed;
+  /* the miss ratio between the last two checkpoints of a stopped candidate,
+   * or the miss ratio after the warmup of a candidate that reaches the end */
+  double miss_ratio;
+  /* the candidates that run longer rank higher, and the candidates stopped at
+   * the same checkpoint are ranked by miss_ratio, 1 is the best */
+  int rank;
+} halving_result_t;
+
+/**
+ * search the best of num_of_caches candidates (e.g., one algorithm with a
+ * grid of parameters) with successive halving: all the candidates start, at
+ * every checkpoint the candidates are compared by the miss ratio since the
+ * previous checkpoint and only ceil(n / eta) of them continue, so the threads
+ * of the stopped candidates go to the ones that are still running
+ *
+ * the trace is decoded once, every chunk of requests is replayed by all the
+ * running candidates on the thread pool. The checkpoints are at
+ * first_checkpoint_frac, first_checkpoint_frac * eta ... of the requests after
+ * the warmup. A candidate that is not stopped gets the same result as in
+ * simulate_with_multi_caches
+ *
+ * @param reader
+ * @param caches
+ * @param num_of_caches
+ * @param warmup_frac the requests used to warm up every candidate
+ * @param first_checkpoint_frac
+ * @param eta larger than 1, 2 keeps the better half at each checkpoint
+ * @param num_of_threads
+ * @param free_cache_when_finish free a cache when the candidate stops
+ * @return an array of num_of_caches results in the order of caches, freed by
+ * the user
+ */
+halving_result_t *simulate_with_multi_caches_halving(reader_t *reader,
+                                                     cache_t *caches[],
+                                                     int num_of_caches,
+                                                     double warmup_frac,
+                                                     double first_checkpoint_frac,
+                                                     double eta,
+                                                     int num_of_threads,
+                                                     bool free_cache_when_finish);
+
+typedef enum {
+  /* the variants are deep copies of the warm cache made in this process and
+   * are simulated on a thread pool */
+  WARMUP_SWEEP_THREAD,
+  /* each variant is simulated in a child process forked after the warmup,
+   * which shares the warm cache and the trace with the parent copy-on-write
+   * and sends its result back through a pipe */
+  WARMUP_SWEEP_FORK,
+} warmup_sweep_mode_e;
+
+/**
+ * warm up cache once with the first warmup_frac of the requests, then
+ * continue n_variant copies of the warm cache over the rest of the trace, so
+ * sweeping the parameters of an algorithm costs one warmup instead of one per
+ * configuration
+ *
+ * variant i is created by deep_clone_cache (see checkpoint.h) with
+ * variant_params[i], e.g., "small-size-ratio=0.05" for S3FIFO, applied over
+ * the parameters of the cache, so the algorithm must support checkpoints. In WARMUP_SWEEP_FORK mode a variant
+ * with NULL parameters uses the warm cache of its process directly and works
+ * with any algorithm. The returned results only count the requests after the
+ * warmup, a variant that cannot be created has n_req 0
+ *
+ * @param reader
+ * @param cache warmed up in place, it is not freed
+ * @param n_variant
+ * @param variant_params
+ * @param warmup_frac
+ * @param num_of_threads the number of threads or child processes
+ * @param mode
+ * @return an array of n_variant cache_stat_t, freed by the user
+ */
+cache_stat_t *simulate_variants_after_warmup(reader_t *reader,
+                                             cache_t *cache,
+                                             int n_variant,
+                                             const char *variant_params[],
+                                             double warmup_frac,
+                                             int num_of_threads,
+                                             warmup_sweep_mode_e mode);
+
 #ifdef __cplusplus
 }
 #endif
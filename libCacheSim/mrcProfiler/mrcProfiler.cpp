@@ -4,6 +4,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <ostream>
 #include <set>
@@ -265,7 +269,18 @@ void mrcProfiler::MRCProfilerSHARDS::fixed_sample_size_run() {
 }
 
 void mrcProfiler::MRCProfilerMINISIM::run() {
+  if (has_run_) return;
+
+  if (params_.minisim_params.enable_auto_rate) {
+    auto_sample_rate_run();
+  } else {
+    fixed_sample_rate_run();
+  }
+
   has_run_ = true;
+}
+
+void mrcProfiler::MRCProfilerMINISIM::fixed_sample_rate_run() {
 
   request_t *req = new_request();
   double sample_rate = params_.minisim_params.sample_rate;
@@ -324,4 +339,248 @@ void mrcProfiler::MRCProfilerMINISIM::run() {
       hit_size_vec[i] = sum_obj_size_req - result[i].n_miss_byte;
     }
   }
-}
\ No newline at end of file
+}
+namespace {
+
+/* the first salt is the one used by the fixed rate MINISIM */
+constexpr uint64_t MINISIM_BASE_SALT = 10000019;
+constexpr uint64_t MINISIM_SALT_STEP = 1000003;
+constexpr int MINISIM_MAX_ROUND = 64;
+
+/* two-sided 95% quantile of Student's t distribution, indexed by the degree of
+ * freedom, we fall back to the normal quantile for large degrees of freedom */
+double t_quantile_95(int64_t dof) {
+  static const double t_table[] = {
+      0,      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201,  2.179,  2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080,  2.074,  2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if (dof <= 0) return t_table[1];
+  if (dof < (int64_t)(sizeof(t_table) / sizeof(t_table[0]))) return t_table[dof];
+  return 1.960;
+}
+
+/* half width of the 95% confidence interval of the mean of v */
+double ci_half_width_95(const std::vector<double> &v) {
+  size_t n = v.size();
+  if (n < 2) return 1.0;
+  double mean = 0, var = 0;
+  for (double x : v) mean += x;
+  mean /= n;
+  for (double x : v) var += (x - mean) * (x - mean);
+  var /= (n - 1);
+  return t_quantile_95(n - 1) * sqrt(var / n);
+}
+
+double rusage_cpu_sec() {
+  struct rusage r_usage;
+  getrusage(RUSAGE_SELF, &r_usage);
+  return r_usage.ru_utime.tv_sec + r_usage.ru_utime.tv_usec / 1e6 +
+         r_usage.ru_stime.tv_sec + r_usage.ru_stime.tv_usec / 1e6;
+}
+
+/* the estimates of one profile point at its current sample rate */
+struct minisim_point_t {
+  int64_t sample_ratio_inv;
+  int64_t target_n_salt;
+  std::vector<double> miss_ratio;
+  std::vector<double> byte_miss_ratio;
+  double ci_half_width;
+  bool converged;
+};
+
+}  // namespace
+
+/**
+ * adaptive MINISIM
+ *
+ * each round simulates the unconverged profile points with new salts at
+ * their current sample rate, all (point, salt) pairs run in parallel on the
+ * simulator thread pool. After each round, a point converges if the 95%
+ * confidence interval of the miss ratio (and byte miss ratio) across salts is
+ * narrower than target_error. Otherwise, we estimate how many more samples
+ * are needed, and either add salts (if it needs no more than max_n_salt) or
+ * raise the sample rate and start over with n_salt salts at the new rate.
+ * A point that reaches a sample rate of 1 is simulated exactly.
+ */
+void mrcProfiler::MRCProfilerMINISIM::auto_sample_rate_run() {
+  const auto &mp = params_.minisim_params;
+  const size_t n_point = mrc_size_vec.size();
+  const double target_error = mp.target_error;
+  double cpu_start = rusage_cpu_sec();
+
+  // 1. obtain the n_req_ and sum_obj_size_req
+  request_t *req = new_request();
+  read_one_req(reader_, req);
+  do {
+    DEBUG_ASSERT(req->obj_size != 0);
+    n_req_ += 1;
+    sum_obj_size_req += req->obj_size;
+    read_one_req(reader_, req);
+  } while (req->valid);
+  free_request(req);
+  reset_reader(reader_);
+  double cpu_scan = rusage_cpu_sec() - cpu_start;
+
+  int64_t init_inv = (int64_t)(1.0 / mp.init_sample_rate + 0.5);
+  init_inv = std::max(init_inv, (int64_t)2);
+
+  std::vector<minisim_point_t> points(n_point);
+  for (auto &p : points) {
+    p.sample_ratio_inv = init_inv;
+    p.target_n_salt = mp.n_salt;
+    p.ci_half_width = 1.0;
+    p.converged = false;
+  }
+
+  sampler_t *orig_sampler = reader_->init_params.sampler;
+  int64_t n_sampled_req = 0;
+  double cpu_sim = 0;
+  auto_rate_stat_ = minisim_auto_rate_stat_t{};
+
+  // 2. simulate round by round until all points converge
+  int round = 0;
+  for (; round < MINISIM_MAX_ROUND; round++) {
+    std::vector<std::pair<size_t, int64_t>> jobs;  // (point idx, salt idx)
+    for (size_t i = 0; i < n_point; i++) {
+      if (points[i].converged) continue;
+      for (int64_t s = points[i].miss_ratio.size(); s < points[i].target_n_salt; s++) {
+        jobs.emplace_back(i, s);
+      }
+    }
+    if (jobs.empty()) break;
+
+    int n_job = (int)jobs.size();
+    std::vector<reader_t *> readers(n_job);
+    std::vector<cache_t *> caches(n_job);
+    std::vector<sampler_t *> samplers(n_job, nullptr);
+    for (int j = 0; j < n_job; j++) {
+      minisim_point_t &p = points[jobs[j].first];
+      sampler_t *sampler = nullptr;
+      if (p.sample_ratio_inv > 1) {
+        sampler = create_spatial_sampler(1.0 / p.sample_ratio_inv);
+        set_spatial_sampler_salt(sampler, MINISIM_BASE_SALT + jobs[j].second * MINISIM_SALT_STEP);
+      }
+      // the cloned reader keeps a pointer to the sampler in its init_params
+      samplers[j] = sampler;
+      reader_->init_params.sampler = sampler;
+      readers[j] = clone_reader(reader_);
+
+      size_t _cache_size = mrc_size_vec[jobs[j].first] / p.sample_ratio_inv;
+      common_cache_params_t cc_params = {.cache_size = std::max(_cache_size, (size_t)1),
+                                         .default_ttl = 0,
+                                         .hashpower = 20,
+                                         .consider_obj_metadata = false};
+      caches[j] = create_cache(params_.cache_algorithm_str, cc_params, nullptr);
+    }
+    reader_->init_params.sampler = orig_sampler;
+
+    double cpu_round_start = rusage_cpu_sec();
+    cache_stat_t *res = simulate_with_multi_caches_scaling(readers.data(), caches.data(), n_job, NULL, 0, 0,
+                                                           mp.thread_num, true);
+    cpu_sim += rusage_cpu_sec() - cpu_round_start;
+
+    for (int j = 0; j < n_job; j++) {
+      minisim_point_t &p = points[jobs[j].first];
+      p.miss_ratio.push_back((double)res[j].n_miss * p.sample_ratio_inv / n_req_);
+      p.byte_miss_ratio.push_back((double)res[j].n_miss_byte * p.sample_ratio_inv / sum_obj_size_req);
+      n_sampled_req += res[j].n_req;
+      close_reader(readers[j]);
+      if (samplers[j] != nullptr) samplers[j]->free(samplers[j]);
+    }
+    my_free(sizeof(cache_stat_t) * n_job, res);
+    auto_rate_stat_.n_sim += n_job;
+
+    // 3. check convergence, add salts or raise the sample rate if needed
+    for (size_t i = 0; i < n_point; i++) {
+      minisim_point_t &p = points[i];
+      if (p.converged) continue;
+      if (p.sample_ratio_inv == 1) {
+        // no sampling, the result is exact
+        p.ci_half_width = 0;
+        p.converged = true;
+        continue;
+      }
+
+      p.ci_half_width = std::max(ci_half_width_95(p.miss_ratio), ci_half_width_95(p.byte_miss_ratio));
+      if (p.ci_half_width <= target_error) {
+        p.converged = true;
+        continue;
+      }
+
+      // no round is left to simulate at a higher rate, keep the estimates
+      if (round == MINISIM_MAX_ROUND - 1) continue;
+
+      // the variance shrinks linearly with the number of sampled objects
+      double ratio = p.ci_half_width / target_error;
+      int64_t n_salt_needed = (int64_t)ceil(p.miss_ratio.size() * ratio * ratio);
+      if (n_salt_needed <= mp.max_n_salt) {
+        p.target_n_salt = n_salt_needed;
+      } else {
+        int64_t scale = (int64_t)ceil((double)n_salt_needed / mp.n_salt);
+        int64_t new_inv = p.sample_ratio_inv / std::max(scale, (int64_t)2);
+        p.sample_ratio_inv = new_inv < 2 ? 1 : new_inv;
+        p.target_n_salt = p.sample_ratio_inv == 1 ? 1 : mp.n_salt;
+        p.miss_ratio.clear();
+        p.byte_miss_ratio.clear();
+      }
+    }
+
+    DEBUG("MINISIM auto rate round %d: %d simulations\n", round, n_job);
+  }
+  auto_rate_stat_.n_round = round;
+
+  // 4. aggregate the estimates across salts
+  int64_t fixed_inv = init_inv, fixed_n_salt = 1;
+  for (size_t i = 0; i < n_point; i++) {
+    minisim_point_t &p = points[i];
+    double miss_ratio = 0, byte_miss_ratio = 0;
+    for (size_t s = 0; s < p.miss_ratio.size(); s++) {
+      miss_ratio += p.miss_ratio[s];
+      byte_miss_ratio += p.byte_miss_ratio[s];
+    }
+    if (!p.miss_ratio.empty()) {
+      miss_ratio /= p.miss_ratio.size();
+      byte_miss_ratio /= p.byte_miss_ratio.size();
+    }
+    hit_cnt_vec[i] = (int64_t)(n_req_ * (1 - miss_ratio));
+    hit_size_vec[i] = (int64_t)(sum_obj_size_req * (1 - byte_miss_ratio));
+
+    if (!p.converged) {
+      WARN("MINISIM auto rate: cache size %zu does not converge, CI half width %.4lf\n", mrc_size_vec[i],
+           p.ci_half_width);
+    }
+
+    auto_rate_stat_.sample_rate.push_back(1.0 / p.sample_ratio_inv);
+    auto_rate_stat_.n_salt.push_back(p.miss_ratio.size());
+    auto_rate_stat_.ci_half_width.push_back(p.ci_half_width);
+    auto_rate_stat_.converged.push_back(p.converged);
+    if (p.sample_ratio_inv < fixed_inv ||
+        (p.sample_ratio_inv == fixed_inv && (int64_t)p.miss_ratio.size() > fixed_n_salt)) {
+      fixed_inv = p.sample_ratio_inv;
+      fixed_n_salt = p.miss_ratio.size();
+    }
+  }
+
+  // 5. estimate the cost of a fixed rate run reaching the same accuracy, i.e.,
+  // simulating all points at the finest rate with the most salts, we assume
+  // the simulation cost is proportional to the number of sampled requests
+  auto_rate_stat_.cpu_time_sec = rusage_cpu_sec() - cpu_start;
+  auto_rate_stat_.fixed_sample_rate = 1.0 / fixed_inv;
+  auto_rate_stat_.fixed_n_salt = fixed_n_salt;
+  double cpu_per_sampled_req = n_sampled_req > 0 ? cpu_sim / n_sampled_req : 0;
+  auto_rate_stat_.fixed_rate_cpu_time_sec =
+      cpu_scan + cpu_per_sampled_req * n_point * fixed_n_salt * ((double)n_req_ / fixed_inv);
+
+  double saved = 1 - auto_rate_stat_.cpu_time_sec / auto_rate_stat_.fixed_rate_cpu_time_sec;
+  INFO(
+      "MINISIM auto rate: %d rounds, %ld simulations, cpu time %.2lf s, "
+      "estimated cpu time of fixed rate %lf with %ld salts %.2lf s, saved "
+      "%.2lf%%\n",
+      auto_rate_stat_.n_round, (long)auto_rate_stat_.n_sim, auto_rate_stat_.cpu_time_sec,
+      auto_rate_stat_.fixed_sample_rate, (long)auto_rate_stat_.fixed_n_salt, auto_rate_stat_.fixed_rate_cpu_time_sec,
+      saved * 100);
+  for (size_t i = 0; i < n_point; i++) {
+    INFO("MINISIM auto rate: cache size %zu, sample rate %lf, %ld salts, CI half width %.4lf\n", mrc_size_vec[i],
+         auto_rate_stat_.sample_rate[i], (long)auto_rate_stat_.n_salt[i], auto_rate_stat_.ci_half_width[i]);
+  }
+}
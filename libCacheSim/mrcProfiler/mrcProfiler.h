@@ -114,19 +114,42 @@ typedef struct profiler_params {
     double sample_rate;
     int64_t thread_num;
 
+    // adaptive sampling: start at init_sample_rate with n_salt salts, then add
+    // salts or raise the rate only for the sizes whose confidence interval
+    // is still wider than target_error
+    bool enable_auto_rate;
+    double target_error;
+    double init_sample_rate;
+    int64_t n_salt;
+    int64_t max_n_salt;
+
     void print() {
       printf("minisim params:\n");
       printf("  sample_rate: %f\n", sample_rate);
       printf("  thread_num: %ld\n", thread_num);
+      printf("  enable_auto_rate: %d\n", enable_auto_rate);
+      if (enable_auto_rate) {
+        printf("  target_error: %f\n", target_error);
+        printf("  init_sample_rate: %f\n", init_sample_rate);
+        printf("  n_salt: %ld\n", n_salt);
+        printf("  max_n_salt: %ld\n", max_n_salt);
+      }
     }
 
     void parse_params(const char *str) {
       // format: FIX_RATE,0.01,thread_num
+      //         AUTO_RATE,target_error,thread_num[,init_sample_rate[,n_salt]]
       if (strlen(str) == 0) {
         ERROR("invalid params for shards\n");
         exit(1);
       }
 
+      enable_auto_rate = false;
+      target_error = 0.01;
+      init_sample_rate = 0.001;
+      n_salt = 4;
+      max_n_salt = 16;
+
       char buffer[1024];
       char *start = (char *)str;
       char *end = (char *)str;
@@ -146,17 +169,28 @@ typedef struct profiler_params {
           if (current_param_idx == 0) {
             // check the sample type
             if (strcmp(buffer, "FIX_RATE") == 0) {
-              ;
+              enable_auto_rate = false;
+            } else if (strcmp(buffer, "AUTO_RATE") == 0) {
+              enable_auto_rate = true;
             } else {
               ERROR("invalid sample type for minisim: %s\n", str);
               exit(1);
             }
           } else if (current_param_idx == 1) {
-            // check the sample rate or sample size
-            sample_rate = atof(buffer);
-            if (sample_rate <= 0 || sample_rate > 1) {
-              ERROR("invalid sample rate for minisim: %s\n", str);
-              exit(1);
+            if (enable_auto_rate) {
+              // check the target error (absolute miss ratio error)
+              target_error = atof(buffer);
+              if (target_error <= 0 || target_error >= 1) {
+                ERROR("invalid target error for minisim: %s\n", str);
+                exit(1);
+              }
+            } else {
+              // check the sample rate or sample size
+              sample_rate = atof(buffer);
+              if (sample_rate <= 0 || sample_rate > 1) {
+                ERROR("invalid sample rate for minisim: %s\n", str);
+                exit(1);
+              }
             }
           } else if (current_param_idx == 2) {
             // check the thread_num
@@ -165,6 +199,21 @@ typedef struct profiler_params {
               ERROR("invalid thread_num for minisim: %s\n", str);
               exit(1);
             }
+          } else if (current_param_idx == 3 && enable_auto_rate) {
+            // check the initial sample rate
+            init_sample_rate = atof(buffer);
+            if (init_sample_rate <= 0 || init_sample_rate > 0.5) {
+              ERROR("invalid init sample rate for minisim: %s\n", str);
+              exit(1);
+            }
+          } else if (current_param_idx == 4 && enable_auto_rate) {
+            // check the number of salts
+            n_salt = atoi(buffer);
+            if (n_salt < 2) {
+              ERROR("invalid n_salt for minisim (at least 2): %s\n", str);
+              exit(1);
+            }
+            if (n_salt > max_n_salt) max_n_salt = n_salt;
           } else {
             ERROR("too many params for minisim: %s\n", str);
             exit(1);
@@ -243,6 +292,26 @@ class MRCProfilerSHARDS : public MRCProfilerBase {
   void fixed_sample_size_run();
 };
 
+/**
+ * statistics of an adaptive (AUTO_RATE) MINISIM run
+ */
+typedef struct minisim_auto_rate_stat {
+  int n_round;
+  int64_t n_sim;
+  // per profile point: the final sample rate, the number of salts and the
+  // half width of the confidence interval of the miss ratio
+  std::vector<double> sample_rate;
+  std::vector<int64_t> n_salt;
+  std::vector<double> ci_half_width;
+  std::vector<bool> converged;
+  // cpu time (user + sys) of the adaptive run, and the estimated cpu time of
+  // a fixed-rate run that uses the finest rate and the most salts for all sizes
+  double cpu_time_sec;
+  double fixed_rate_cpu_time_sec;
+  double fixed_sample_rate;
+  int64_t fixed_n_salt;
+} minisim_auto_rate_stat_t;
+
 class MRCProfilerMINISIM : public MRCProfilerBase {
  public:
   explicit MRCProfilerMINISIM(reader_t *reader, std::string output_path, const mrc_profiler_params_t &params)
@@ -252,8 +321,15 @@ class MRCProfilerMINISIM : public MRCProfilerBase {
 
   void run() override;
 
+  const minisim_auto_rate_stat_t &get_auto_rate_stat() { return auto_rate_stat_; }
+
  private:
+  void fixed_sample_rate_run();
+
+  void auto_sample_rate_run();
+
   cache_stat_t *result = nullptr;
+  minisim_auto_rate_stat_t auto_rate_stat_{};
 };
 
 MRCProfilerBase *create_mrc_profiler(mrc_profiler_e type, reader_t *reader, std::string output_path,
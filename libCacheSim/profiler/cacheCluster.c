@@ -0,0 +1,322 @@
+//
+//  cacheCluster.c
+//  libCacheSim
+//
+//  parallel simulation of a cache cluster with consistent hashing, see
+//  cacheCluster.h
+//
+//  the calling thread is the router, it owns the routing state (the active
+//  servers and the ketama ring) and applies the events, the workers own the
+//  server caches and the server stats. A removed server is flushed by a
+//  message in the queue of its worker, so the flush happens between the same
+//  requests as in a sequential replay
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../include/libCacheSim/cacheCluster.h"
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "../dataStructure/hash/hash.h"
+#include "../dataStructure/spscQueue.h"
+#include "../utils/include/mymath.h"
+
+typedef enum {
+  CLUSTER_MSG_REQ,
+  /* drop the content of the server, sent when the server is removed */
+  CLUSTER_MSG_FLUSH,
+} cluster_msg_type_e;
+
+typedef struct {
+  cache_cluster_t *cluster;
+  spsc_queue_t *queue;
+} cluster_worker_t;
+
+static int32_t jump_consistent_hash(uint64_t key, int32_t n_bucket) {
+  int64_t b = -1, j = 0;
+  while (j < n_bucket) {
+    b = j;
+    key = key * 2862933555777941757ULL + 1;
+    j = (int64_t)((double)(b + 1) * ((double)(1LL << 31) / (double)((key >> 33) + 1)));
+  }
+  return (int32_t)b;
+}
+
+typedef struct {
+  uint64_t point;
+  int32_t server;
+} ring_point_t;
+
+static int cmp_ring_point(const void *a, const void *b) {
+  const ring_point_t *pa = a, *pb = b;
+  if (pa->point != pb->point) return pa->point < pb->point ? -1 : 1;
+  return pa->server - pb->server;
+}
+
+static void build_ring(cache_cluster_t *cluster) {
+  int64_t n = 0;
+  ring_point_t *points = malloc(sizeof(ring_point_t) * cluster->n_server * CLUSTER_N_VNODE_PER_SERVER);
+  for (int32_t s = 0; s < cluster->n_server; s++) {
+    if (!cluster->active[s]) continue;
+    for (uint64_t v = 0; v < CLUSTER_N_VNODE_PER_SERVER; v++) {
+      uint64_t key = ((uint64_t)s << 32) | v;
+      points[n++] = (ring_point_t){.point = get_hash_value_int_64(&key), .server = s};
+    }
+  }
+  qsort(points, n, sizeof(ring_point_t), cmp_ring_point);
+  for (int64_t i = 0; i < n; i++) {
+    cluster->ring_points[i] = points[i].point;
+    cluster->ring_servers[i] = points[i].server;
+  }
+  cluster->n_ring_point = n;
+  free(points);
+}
+
+static inline int route(const cache_cluster_t *cluster, uint64_t hv) {
+  if (cluster->routing == CLUSTER_ROUTING_JUMP_HASH) {
+    int32_t server = jump_consistent_hash(hv, cluster->n_server);
+    while (!cluster->active[server]) {
+      hv = get_hash_value_int_64(&hv);
+      server = jump_consistent_hash(hv, cluster->n_server);
+    }
+    return server;
+  }
+
+  /* the first point at or after hv, wrapping around */
+  int64_t lo = 0, hi = cluster->n_ring_point;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (cluster->ring_points[mid] < hv) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return cluster->ring_servers[lo == cluster->n_ring_point ? 0 : lo];
+}
+
+int cache_cluster_route(const cache_cluster_t *cluster, obj_id_t obj_id) {
+  return route(cluster, get_hash_value_int_64(&obj_id));
+}
+
+static gpointer run_worker(gpointer data) {
+  cluster_worker_t *worker = data;
+  cache_cluster_t *cluster = worker->cluster;
+  set_rand_seed(1);
+  request_t *req = new_request();
+  const queued_req_t *msg;
+  while ((msg = spsc_queue_peek(worker->queue)) != NULL) {
+    cache_t *cache = cluster->servers[msg->dst];
+    cache_stat_t *stat = &cluster->server_stats[msg->dst];
+    if (msg->type == CLUSTER_MSG_FLUSH) {
+      cluster->servers[msg->dst] = create_cache_with_new_size(cache, cache->cache_size);
+      cache->cache_free(cache);
+    } else {
+      req->clock_time = msg->clock_time;
+      req->obj_id = msg->obj_id;
+      req->obj_size = msg->obj_size;
+      stat->n_req += 1;
+      stat->n_req_byte += msg->obj_size;
+      if (!cache->get(cache, req)) {
+        stat->n_miss += 1;
+        stat->n_miss_byte += msg->obj_size;
+      }
+      stat->curr_rtime = msg->clock_time;
+    }
+    spsc_queue_pop(worker->queue);
+  }
+  free_request(req);
+  return NULL;
+}
+
+static void apply_event(cache_cluster_t *cluster, const cluster_event_t *event, cluster_worker_t *workers,
+                        int n_thread) {
+  int s = event->server_id;
+  if (event->type == CLUSTER_EVENT_ADD_SERVER) {
+    if (cluster->active[s]) {
+      WARN("server %d is already in the cluster\n", s);
+      return;
+    }
+    cluster->active[s] = true;
+  } else {
+    if (!cluster->active[s]) {
+      WARN("server %d is not in the cluster\n", s);
+      return;
+    }
+    int n_active = 0;
+    for (int i = 0; i < cluster->n_server; i++) n_active += cluster->active[i];
+    if (n_active == 1) {
+      ERROR("cannot remove server %d, it is the last server in the cluster\n", s);
+    }
+    cluster->active[s] = false;
+    queued_req_t msg = {.clock_time = event->time, .type = CLUSTER_MSG_FLUSH, .dst = s};
+    spsc_queue_push(workers[s % n_thread].queue, &msg);
+  }
+  if (cluster->routing == CLUSTER_ROUTING_KETAMA) {
+    build_ring(cluster);
+  }
+}
+
+static int cmp_event(const void *a, const void *b) {
+  const cluster_event_t *ea = a, *eb = b;
+  return ea->time < eb->time ? -1 : (ea->time > eb->time ? 1 : 0);
+}
+
+cache_cluster_t *create_cache_cluster(const cache_t *cache, int n_server, cluster_routing_e routing) {
+  if (n_server <= 0) {
+    ERROR("a cache cluster needs at least one server, got %d\n", n_server);
+  }
+  cache_cluster_t *cluster = calloc(1, sizeof(cache_cluster_t));
+  cluster->n_server = n_server;
+  cluster->routing = routing;
+  cluster->servers = malloc(sizeof(cache_t *) * n_server);
+  cluster->active = malloc(sizeof(bool) * n_server);
+  cluster->server_stats = calloc(n_server, sizeof(cache_stat_t));
+  for (int i = 0; i < n_server; i++) {
+    cluster->servers[i] = create_cache_with_new_size(cache, cache->cache_size);
+    cluster->active[i] = true;
+  }
+  cluster->ring_points = malloc(sizeof(uint64_t) * n_server * CLUSTER_N_VNODE_PER_SERVER);
+  cluster->ring_servers = malloc(sizeof(int32_t) * n_server * CLUSTER_N_VNODE_PER_SERVER);
+  build_ring(cluster);
+  cluster->queue_size = 1 << 16;
+  return cluster;
+}
+
+void cache_cluster_add_event(cache_cluster_t *cluster, int64_t time, cluster_event_type_e type, int server_id) {
+  if (server_id < 0 || server_id >= cluster->n_server) {
+    ERROR("server %d is not in [0, %d)\n", server_id, cluster->n_server);
+  }
+  cluster->events = realloc(cluster->events, sizeof(cluster_event_t) * (cluster->n_event + 1));
+  cluster->events[cluster->n_event++] = (cluster_event_t){.time = time, .type = type, .server_id = server_id};
+}
+
+void simulate_cache_cluster(cache_cluster_t *cluster, reader_t *reader, int n_thread) {
+  n_thread = MAX(MIN(n_thread, cluster->n_server), 1);
+  /* keep the order of the events at the same time */
+  for (int i = 1; i < cluster->n_event; i++) {
+    for (int j = i; j > 0 && cmp_event(&cluster->events[j - 1], &cluster->events[j]) > 0; j--) {
+      cluster_event_t tmp = cluster->events[j];
+      cluster->events[j] = cluster->events[j - 1];
+      cluster->events[j - 1] = tmp;
+    }
+  }
+
+  memset(&cluster->stat, 0, sizeof(cache_stat_t));
+  for (int i = 0; i < cluster->n_server; i++) {
+    memset(&cluster->server_stats[i], 0, sizeof(cache_stat_t));
+    cluster->server_stats[i].cache_size = cluster->servers[i]->cache_size;
+    strncpy(cluster->server_stats[i].cache_name, cluster->servers[i]->cache_name, CACHE_NAME_ARRAY_LEN);
+  }
+
+  cluster_worker_t *workers = calloc(n_thread, sizeof(cluster_worker_t));
+  GThread **threads = malloc(sizeof(GThread *) * n_thread);
+  for (int t = 0; t < n_thread; t++) {
+    workers[t].cluster = cluster;
+    workers[t].queue = spsc_queue_new(cluster->queue_size);
+    threads[t] = g_thread_new("cacheCluster", run_worker, &workers[t]);
+  }
+
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  int next_event = 0;
+  read_one_req(cloned_reader, req);
+  int64_t start_ts = (int64_t)req->clock_time;
+  while (req->valid) {
+    req->clock_time -= start_ts;
+    while (next_event < cluster->n_event && cluster->events[next_event].time <= (int64_t)req->clock_time) {
+      apply_event(cluster, &cluster->events[next_event++], workers, n_thread);
+    }
+    int server = cache_cluster_route(cluster, req->obj_id);
+    queued_req_t msg = {.clock_time = req->clock_time,
+                        .obj_id = req->obj_id,
+                        .obj_size = req->obj_size,
+                        .type = CLUSTER_MSG_REQ,
+                        .dst = server};
+    spsc_queue_push(workers[server % n_thread].queue, &msg);
+    read_one_req(cloned_reader, req);
+  }
+  /* the events after the last request */
+  while (next_event < cluster->n_event) {
+    apply_event(cluster, &cluster->events[next_event++], workers, n_thread);
+  }
+
+  for (int t = 0; t < n_thread; t++) {
+    spsc_queue_close(workers[t].queue);
+  }
+  for (int t = 0; t < n_thread; t++) {
+    g_thread_join(threads[t]);
+    spsc_queue_free(workers[t].queue);
+  }
+
+  for (int i = 0; i < cluster->n_server; i++) {
+    cache_stat_t *stat = &cluster->server_stats[i];
+    stat->n_obj = cluster->servers[i]->get_n_obj(cluster->servers[i]);
+    stat->occupied_byte = cluster->servers[i]->get_occupied_byte(cluster->servers[i]);
+    cluster->stat.n_req += stat->n_req;
+    cluster->stat.n_req_byte += stat->n_req_byte;
+    cluster->stat.n_miss += stat->n_miss;
+    cluster->stat.n_miss_byte += stat->n_miss_byte;
+    cluster->stat.n_obj += stat->n_obj;
+    cluster->stat.occupied_byte += stat->occupied_byte;
+    cluster->stat.cache_size += stat->cache_size;
+  }
+  cluster->stat.curr_rtime = req->clock_time;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+  snprintf(cluster->stat.cache_name, CACHE_NAME_ARRAY_LEN, "%s-cluster", cluster->servers[0]->cache_name);
+#pragma GCC diagnostic pop
+
+  free_request(req);
+  close_reader(cloned_reader);
+  free(threads);
+  free(workers);
+}
+
+double cache_cluster_load_imbalance(const cache_cluster_t *cluster) {
+  int64_t max_req = 0, sum_req = 0;
+  int n_busy = 0;
+  for (int i = 0; i < cluster->n_server; i++) {
+    int64_t n_req = cluster->server_stats[i].n_req;
+    if (n_req == 0) continue;
+    max_req = MAX(max_req, n_req);
+    sum_req += n_req;
+    n_busy += 1;
+  }
+  if (n_busy == 0) return 0;
+  return (double)max_req / ((double)sum_req / n_busy);
+}
+
+void free_cache_cluster(cache_cluster_t *cluster) {
+  for (int i = 0; i < cluster->n_server; i++) {
+    cluster->servers[i]->cache_free(cluster->servers[i]);
+  }
+  free(cluster->servers);
+  free(cluster->active);
+  free(cluster->server_stats);
+  free(cluster->events);
+  free(cluster->ring_points);
+  free(cluster->ring_servers);
+  free(cluster);
+}
+
+bool parse_cluster_routing(const char *str, cluster_routing_e *routing) {
+  if (strcasecmp(str, "ketama") == 0) {
+    *routing = CLUSTER_ROUTING_KETAMA;
+  } else if (strcasecmp(str, "jump") == 0 || strcasecmp(str, "jump-hash") == 0) {
+    *routing = CLUSTER_ROUTING_JUMP_HASH;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,375 @@
+//
+//  cacheHierarchy.c
+//  libCacheSim
+//
+//  pipelined simulation of a multi-level cache hierarchy, see cacheHierarchy.h
+//
+//  a spsc_queue_t connects one cache of the top level, or one lower level, to
+//  the level below it, the type of a queued request is a msg_type_e
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../include/libCacheSim/cacheHierarchy.h"
+
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "../dataStructure/spscQueue.h"
+#include "../utils/include/mymath.h"
+
+typedef enum {
+  /* a miss of the level above */
+  MSG_READ,
+  /* an object evicted from the level above in an exclusive hierarchy */
+  MSG_DEMOTE,
+  /* a dirty object evicted from the level above in a write-back hierarchy */
+  MSG_WRITEBACK,
+} msg_type_e;
+
+typedef struct {
+  cache_hierarchy_t *hierarchy;
+  int level;
+  /* the caches the worker simulates, caches[0] sends to the level below */
+  cache_t **caches;
+  cache_hierarchy_stat_t *stats;
+  int n_cache;
+
+  reader_t *reader;
+  spsc_queue_t **in;
+  int n_in;
+  spsc_queue_t *out;
+
+  /* the objects evicted from caches[0] by the current message, they are sent
+   * after the miss so that the level below sees the read first */
+  queued_req_t *evicted;
+  int n_evicted;
+  int evicted_capacity;
+  bool removing;
+  /* the dirty objects in caches[0] */
+  GHashTable *dirty;
+} level_worker_t;
+
+static void on_evict(cache_t *cache, const cache_obj_t *obj, void *data) {
+  level_worker_t *worker = data;
+  if (worker->removing) return;
+  if (worker->n_evicted == worker->evicted_capacity) {
+    worker->evicted_capacity = worker->evicted_capacity == 0 ? 8 : worker->evicted_capacity * 2;
+    worker->evicted = realloc(worker->evicted, sizeof(queued_req_t) * worker->evicted_capacity);
+  }
+  worker->evicted[worker->n_evicted++] = (queued_req_t){.obj_id = obj->obj_id, .obj_size = obj->obj_size};
+}
+
+static inline bool is_write(const request_t *req) {
+  switch (req->op) {
+    case OP_SET:
+    case OP_ADD:
+    case OP_CAS:
+    case OP_REPLACE:
+    case OP_APPEND:
+    case OP_PREPEND:
+    case OP_WRITE:
+    case OP_UPDATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static inline void send(level_worker_t *worker, msg_type_e type, const request_t *req) {
+  queued_req_t msg = {.clock_time = req->clock_time, .obj_id = req->obj_id, .obj_size = req->obj_size, .type = type};
+  spsc_queue_push(worker->out, &msg);
+}
+
+/* send the objects evicted from caches[0] to the level below */
+static void send_evicted(level_worker_t *worker, int64_t clock_time) {
+  for (int i = 0; i < worker->n_evicted; i++) {
+    queued_req_t *msg = &worker->evicted[i];
+    msg->clock_time = clock_time;
+    if (worker->hierarchy->policy == CACHE_HIERARCHY_EXCLUSIVE) {
+      msg->type = MSG_DEMOTE;
+      spsc_queue_push(worker->out, msg);
+    } else if (g_hash_table_remove(worker->dirty, GSIZE_TO_POINTER(msg->obj_id))) {
+      msg->type = MSG_WRITEBACK;
+      worker->stats[0].n_writeback += 1;
+      worker->stats[0].n_writeback_byte += msg->obj_size;
+      spsc_queue_push(worker->out, msg);
+    }
+  }
+  worker->n_evicted = 0;
+}
+
+static void mark_dirty(level_worker_t *worker, const request_t *req) {
+  if (worker->caches[0]->find(worker->caches[0], req, false) != NULL) {
+    g_hash_table_add(worker->dirty, GSIZE_TO_POINTER(req->obj_id));
+  }
+}
+
+static void serve_request(level_worker_t *worker, const request_t *req) {
+  cache_t *cache = worker->caches[0];
+  cache_stat_t *stat = &worker->stats[0].stat;
+  stat->n_req += 1;
+  stat->n_req_byte += req->obj_size;
+  bool hit = cache->get(cache, req);
+  if (!hit) {
+    stat->n_miss += 1;
+    stat->n_miss_byte += req->obj_size;
+  }
+
+  if (worker->hierarchy->policy == CACHE_HIERARCHY_WRITE_BACK && is_write(req)) {
+    /* the write is absorbed */
+    if (worker->dirty) mark_dirty(worker, req);
+  } else if (!hit && worker->out) {
+    send(worker, MSG_READ, req);
+  }
+  if (worker->out) send_evicted(worker, req->clock_time);
+}
+
+static void serve_msg(level_worker_t *worker, const queued_req_t *msg, request_t *req) {
+  cache_hierarchy_policy_e policy = worker->hierarchy->policy;
+  req->clock_time = msg->clock_time;
+  req->obj_id = msg->obj_id;
+  req->obj_size = msg->obj_size;
+
+  for (int i = 0; i < worker->n_cache; i++) {
+    cache_t *cache = worker->caches[i];
+    cache_hierarchy_stat_t *stat = &worker->stats[i];
+    if (msg->type != MSG_READ) {
+      stat->n_demote += 1;
+      stat->n_demote_byte += msg->obj_size;
+      cache->get(cache, req);
+      if (i == 0 && msg->type == MSG_WRITEBACK && worker->dirty) mark_dirty(worker, req);
+      continue;
+    }
+
+    stat->stat.n_req += 1;
+    stat->stat.n_req_byte += msg->obj_size;
+    bool hit;
+    if (policy == CACHE_HIERARCHY_EXCLUSIVE) {
+      /* a hit moves the object to the level above */
+      hit = cache->find(cache, req, false) != NULL;
+      if (hit) {
+        worker->removing = true;
+        cache->remove(cache, req->obj_id);
+        worker->removing = false;
+      }
+    } else {
+      hit = cache->get(cache, req);
+    }
+    if (!hit) {
+      stat->stat.n_miss += 1;
+      stat->stat.n_miss_byte += msg->obj_size;
+      if (i == 0 && worker->out) send(worker, MSG_READ, req);
+    }
+  }
+  if (worker->out) send_evicted(worker, msg->clock_time);
+}
+
+static gpointer run_top_level(gpointer data) {
+  level_worker_t *worker = data;
+  set_rand_seed(1);
+  request_t *req = new_request();
+  read_one_req(worker->reader, req);
+  while (req->valid) {
+    serve_request(worker, req);
+    worker->stats[0].stat.curr_rtime = req->clock_time;
+    read_one_req(worker->reader, req);
+  }
+  if (worker->out) spsc_queue_close(worker->out);
+  free_request(req);
+  return NULL;
+}
+
+static gpointer run_lower_level(gpointer data) {
+  level_worker_t *worker = data;
+  set_rand_seed(1);
+  request_t *req = new_request();
+  req->op = OP_READ;
+  while (true) {
+    /* merge the streams of the upper caches by time */
+    int next = -1;
+    const queued_req_t *next_msg = NULL;
+    for (int i = 0; i < worker->n_in; i++) {
+      const queued_req_t *msg = spsc_queue_peek(worker->in[i]);
+      if (msg != NULL && (next_msg == NULL || msg->clock_time < next_msg->clock_time)) {
+        next = i;
+        next_msg = msg;
+      }
+    }
+    if (next_msg == NULL) break;
+    serve_msg(worker, next_msg, req);
+    spsc_queue_pop(worker->in[next]);
+  }
+  for (int i = 0; i < worker->n_cache; i++) {
+    worker->stats[i].stat.curr_rtime = req->clock_time;
+  }
+  if (worker->out) spsc_queue_close(worker->out);
+  free_request(req);
+  return NULL;
+}
+
+cache_hierarchy_t *create_cache_hierarchy(cache_hierarchy_policy_e policy) {
+  cache_hierarchy_t *hierarchy = calloc(1, sizeof(cache_hierarchy_t));
+  hierarchy->policy = policy;
+  hierarchy->queue_size = 1 << 16;
+  return hierarchy;
+}
+
+void cache_hierarchy_add_level(cache_hierarchy_t *hierarchy, const cache_t *cache, const uint64_t *cache_sizes,
+                               int n_size) {
+  if (hierarchy->n_level == CACHE_HIERARCHY_MAX_LEVEL) {
+    ERROR("a cache hierarchy has at most %d levels\n", CACHE_HIERARCHY_MAX_LEVEL);
+  }
+  if (n_size <= 0) {
+    ERROR("a cache hierarchy level needs at least one cache size\n");
+  }
+  if (hierarchy->policy == CACHE_HIERARCHY_EXCLUSIVE && hierarchy->n_level > 0 && cache->remove == NULL) {
+    ERROR("%s does not support remove and cannot be a lower level of an exclusive hierarchy\n", cache->cache_name);
+  }
+  /* the evictions of an upper level are demoted or written back through
+   * evict_listener */
+  if (hierarchy->policy != CACHE_HIERARCHY_INCLUSIVE && hierarchy->n_level > 0 &&
+      hierarchy->levels[hierarchy->n_level - 1].caches[0]->evict_in_sub_cache) {
+    ERROR("%s evicts from its internal caches and cannot be an upper level of a %s hierarchy\n",
+          hierarchy->levels[hierarchy->n_level - 1].caches[0]->cache_name,
+          cache_hierarchy_policy_str(hierarchy->policy));
+  }
+
+  cache_hierarchy_level_t *level = &hierarchy->levels[hierarchy->n_level++];
+  level->n_cache = n_size;
+  level->caches = malloc(sizeof(cache_t *) * n_size);
+  level->stats = calloc(n_size, sizeof(cache_hierarchy_stat_t));
+  for (int i = 0; i < n_size; i++) {
+    level->caches[i] = create_cache_with_new_size(cache, cache_sizes[i]);
+  }
+}
+
+void simulate_cache_hierarchy(cache_hierarchy_t *hierarchy, reader_t **readers, int n_reader) {
+  if (hierarchy->n_level == 0) {
+    ERROR("the cache hierarchy has no level\n");
+  }
+  if (n_reader != hierarchy->levels[0].n_cache) {
+    ERROR("the top level has %d caches but %d readers are given\n", hierarchy->levels[0].n_cache, n_reader);
+  }
+
+  /* queues[0..n_reader) connect the top caches to the second level, and
+   * queues[n_reader + l - 1] connects level l to level l + 1 */
+  int n_queue = hierarchy->n_level == 1 ? 0 : n_reader + hierarchy->n_level - 2;
+  spsc_queue_t **queues = malloc(sizeof(spsc_queue_t *) * MAX(n_queue, 1));
+  for (int i = 0; i < n_queue; i++) {
+    queues[i] = spsc_queue_new(hierarchy->queue_size);
+  }
+
+  int n_worker = n_reader + hierarchy->n_level - 1;
+  level_worker_t *workers = calloc(n_worker, sizeof(level_worker_t));
+  for (int i = 0; i < n_worker; i++) {
+    level_worker_t *worker = &workers[i];
+    worker->hierarchy = hierarchy;
+    if (i < n_reader) {
+      worker->level = 0;
+      worker->caches = &hierarchy->levels[0].caches[i];
+      worker->stats = &hierarchy->levels[0].stats[i];
+      worker->n_cache = 1;
+      worker->reader = clone_reader(readers[i]);
+      worker->out = n_queue > 0 ? queues[i] : NULL;
+    } else {
+      int l = i - n_reader + 1;
+      worker->level = l;
+      worker->caches = hierarchy->levels[l].caches;
+      worker->stats = hierarchy->levels[l].stats;
+      worker->n_cache = hierarchy->levels[l].n_cache;
+      if (l == 1) {
+        worker->in = queues;
+        worker->n_in = n_reader;
+      } else {
+        worker->in = &queues[n_reader + l - 2];
+        worker->n_in = 1;
+      }
+      worker->out = l + 1 < hierarchy->n_level ? queues[n_reader + l - 1] : NULL;
+    }
+
+    for (int j = 0; j < worker->n_cache; j++) {
+      cache_hierarchy_stat_t *stat = &worker->stats[j];
+      memset(stat, 0, sizeof(cache_hierarchy_stat_t));
+      stat->stat.cache_size = worker->caches[j]->cache_size;
+      strncpy(stat->stat.cache_name, worker->caches[j]->cache_name, CACHE_NAME_ARRAY_LEN);
+    }
+    if (worker->out != NULL && hierarchy->policy != CACHE_HIERARCHY_INCLUSIVE) {
+      worker->caches[0]->evict_listener = on_evict;
+      worker->caches[0]->evict_listener_data = worker;
+      worker->dirty = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+  }
+
+  GThread **threads = malloc(sizeof(GThread *) * n_worker);
+  for (int i = 0; i < n_worker; i++) {
+    threads[i] = g_thread_new("cacheHierarchy", i < n_reader ? run_top_level : run_lower_level, &workers[i]);
+  }
+  for (int i = 0; i < n_worker; i++) {
+    g_thread_join(threads[i]);
+  }
+
+  for (int i = 0; i < n_worker; i++) {
+    level_worker_t *worker = &workers[i];
+    for (int j = 0; j < worker->n_cache; j++) {
+      worker->stats[j].stat.n_obj = worker->caches[j]->get_n_obj(worker->caches[j]);
+      worker->stats[j].stat.occupied_byte = worker->caches[j]->get_occupied_byte(worker->caches[j]);
+    }
+    worker->caches[0]->evict_listener = NULL;
+    worker->caches[0]->evict_listener_data = NULL;
+    if (worker->reader) close_reader(worker->reader);
+    if (worker->dirty) g_hash_table_destroy(worker->dirty);
+    free(worker->evicted);
+  }
+  for (int i = 0; i < n_queue; i++) {
+    spsc_queue_free(queues[i]);
+  }
+  free(threads);
+  free(workers);
+  free(queues);
+}
+
+void free_cache_hierarchy(cache_hierarchy_t *hierarchy) {
+  for (int l = 0; l < hierarchy->n_level; l++) {
+    for (int i = 0; i < hierarchy->levels[l].n_cache; i++) {
+      hierarchy->levels[l].caches[i]->cache_free(hierarchy->levels[l].caches[i]);
+    }
+    free(hierarchy->levels[l].caches);
+    free(hierarchy->levels[l].stats);
+  }
+  free(hierarchy);
+}
+
+const char *cache_hierarchy_policy_str(cache_hierarchy_policy_e policy) {
+  switch (policy) {
+    case CACHE_HIERARCHY_INCLUSIVE:
+      return "inclusive";
+    case CACHE_HIERARCHY_EXCLUSIVE:
+      return "exclusive";
+    case CACHE_HIERARCHY_WRITE_BACK:
+      return "write-back";
+    default:
+      return "unknown";
+  }
+}
+
+bool parse_cache_hierarchy_policy(const char *str, cache_hierarchy_policy_e *policy) {
+  if (strcasecmp(str, "inclusive") == 0) {
+    *policy = CACHE_HIERARCHY_INCLUSIVE;
+  } else if (strcasecmp(str, "exclusive") == 0) {
+    *policy = CACHE_HIERARCHY_EXCLUSIVE;
+  } else if (strcasecmp(str, "write-back") == 0 || strcasecmp(str, "writeback") == 0) {
+    *policy = CACHE_HIERARCHY_WRITE_BACK;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,115 @@
+//
+//  convergence.c
+//  libCacheSim
+//
+//  batch means confidence interval of the miss ratio, see convergence.h
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../include/libCacheSim/convergence.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/libCacheSim/logging.h"
+
+convergence_params_t default_convergence_params(double max_error, double confidence) {
+  convergence_params_t params = {
+      .max_error = max_error,
+      .confidence = confidence,
+      .batch_size = 10000,
+      .min_n_batch = 16,
+  };
+  return params;
+}
+
+void convergence_monitor_init(convergence_monitor_t *monitor, const convergence_params_t *params) {
+  if (params->max_error <= 0) {
+    ERROR("the error of the miss ratio must be positive, got %lf\n", params->max_error);
+  }
+  if (params->confidence <= 0 || params->confidence >= 1) {
+    ERROR("the confidence must be in (0, 1), got %lf\n", params->confidence);
+  }
+  if (params->batch_size <= 0 || params->min_n_batch < 2 || params->min_n_batch > CONVERGENCE_MAX_N_BATCH) {
+    ERROR("invalid batch size %lld or number of batches %d\n", (long long)params->batch_size, params->min_n_batch);
+  }
+
+  memset(monitor, 0, sizeof(convergence_monitor_t));
+  monitor->params = *params;
+  monitor->batch_size = params->batch_size;
+}
+
+bool convergence_monitor_end_batch(convergence_monitor_t *monitor) {
+  if (monitor->n_batch == CONVERGENCE_MAX_N_BATCH) {
+    /* merge adjacent batches, which have the same size */
+    for (int i = 0; i < CONVERGENCE_MAX_N_BATCH / 2; i++) {
+      monitor->batch_miss_ratio[i] = (monitor->batch_miss_ratio[2 * i] + monitor->batch_miss_ratio[2 * i + 1]) / 2;
+    }
+    monitor->n_batch = CONVERGENCE_MAX_N_BATCH / 2;
+    monitor->batch_size *= 2;
+    /* the current batch becomes the first half of a larger batch */
+    if (monitor->curr_n_req < monitor->batch_size) return false;
+  }
+
+  monitor->batch_miss_ratio[monitor->n_batch++] = (double)monitor->curr_n_miss / (double)monitor->curr_n_req;
+  monitor->curr_n_req = 0;
+  monitor->curr_n_miss = 0;
+
+  int k = monitor->n_batch;
+  double sum = 0;
+  for (int i = 0; i < k; i++) sum += monitor->batch_miss_ratio[i];
+  monitor->mean = sum / k;
+  if (k < 2) return false;
+
+  double sq_sum = 0, lag1_sum = 0;
+  for (int i = 0; i < k; i++) {
+    double d = monitor->batch_miss_ratio[i] - monitor->mean;
+    sq_sum += d * d;
+    if (i > 0) lag1_sum += d * (monitor->batch_miss_ratio[i - 1] - monitor->mean);
+  }
+  double stddev = sqrt(sq_sum / (k - 1));
+  monitor->half_width = student_t_quantile(monitor->params.confidence, k - 1) * stddev / sqrt(k);
+  monitor->lag1_autocorr = sq_sum > 0 ? lag1_sum / sq_sum : 0;
+
+  monitor->converged = k >= monitor->params.min_n_batch && monitor->half_width <= monitor->params.max_error &&
+                       monitor->lag1_autocorr <= CONVERGENCE_MAX_LAG1_AUTOCORR;
+  return monitor->converged;
+}
+
+/* the quantile of the standard normal distribution, p > 0.5 */
+static double normal_quantile(double p) {
+  double lo = 0, hi = 40;
+  for (int i = 0; i < 100; i++) {
+    double mid = (lo + hi) / 2;
+    if (0.5 * erfc(-mid / M_SQRT2) < p) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo + hi) / 2;
+}
+
+double student_t_quantile(double confidence, int df) {
+  double z = normal_quantile(0.5 + confidence / 2);
+  if (df <= 0) return INFINITY;
+
+  /* the Cornish-Fisher expansion of the t quantile around the normal
+   * quantile (Hill, 1970), accurate to 1e-3 for df >= 8 at 99%, it is too
+   * small for fewer degrees of freedom */
+  double z2 = z * z, z3 = z2 * z, z5 = z3 * z2, z7 = z5 * z2, z9 = z7 * z2;
+  double g1 = (z3 + z) / 4;
+  double g2 = (5 * z5 + 16 * z3 + 3 * z) / 96;
+  double g3 = (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / 384;
+  double g4 = (79 * z9 + 776 * z7 + 1482 * z5 - 1920 * z3 - 945 * z) / 92160;
+  double n = df;
+  return z + g1 / n + g2 / (n * n) + g3 / (n * n * n) + g4 / (n * n * n * n);
+}
+
+#ifdef __cplusplus
+}
+#endif
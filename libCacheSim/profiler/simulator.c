@@ -15,8 +15,11 @@ extern "C" {
 #include <math.h>
 
 #include "../cache/cacheUtils.h"
+#include "../include/libCacheSim/convergence.h"
 #include "../include/libCacheSim/evictionAlgo.h"
 #include "../include/libCacheSim/plugin.h"
+#include "../include/libCacheSim/shardedCache.h"
+#include "../dataStructure/hash/hash.h"
 #include "../utils/include/myprint.h"
 #include "../utils/include/mystr.h"
 
@@ -34,6 +37,11 @@ typedef struct simulator_multithreading_params {
   gpointer other_data;
   bool free_cache_when_finish;
   bool use_random_seed;
+  /* NULL if each cache runs to the end of the trace */
+  const convergence_params_t *early_stop;
+  /* the caches continue from the position of reader instead of the start of
+   * the trace */
+  bool from_reader_pos;
 } sim_mt_params_t;
 
 static void _simulate(gpointer data, gpointer user_data) {
@@ -71,6 +79,13 @@ static void _simulate(gpointer data, gpointer user_data) {
 
   read_one_req(cloned_reader, req);
   int64_t start_ts = (int64_t)req->clock_time;
+  /* the clock stays relative to the start of the trace */
+  if (params->from_reader_pos) {
+    if (!reader_copy_pos(cloned_reader, source_reader)) {
+      ERROR("cannot continue the simulation of cache %s from the position of the reader\n", local_cache->cache_name);
+    }
+    read_one_req(cloned_reader, req);
+  }
 
   /* using warmup_frac or warmup_sec of requests from reader to warm up */
   if (params->n_warmup_req > 0 || params->warmup_sec > 0) {
@@ -89,6 +104,15 @@ static void _simulate(gpointer data, gpointer user_data) {
          local_cache->cache_name, local_cache->cache_size, n_warmup, (double)(req->clock_time - start_ts) / 3600.0);
   }
 
+#ifdef SUPPORT_TTL
+  int64_t n_warmup_expired_obj = local_cache->n_expired_obj;
+  int64_t n_warmup_expired_byte = local_cache->n_expired_byte;
+#endif
+
+  convergence_monitor_t monitor;
+  if (params->early_stop != NULL) {
+    convergence_monitor_init(&monitor, params->early_stop);
+  }
 
   // #ifdef SIMULATE_MAX_REQUESTS
   //   long long int total_requests_simulated = 0;
@@ -106,32 +130,28 @@ static void _simulate(gpointer data, gpointer user_data) {
     // #endif
 
     req->clock_time -= start_ts;
-    if (local_cache->get(local_cache, req) == false) {
+    bool hit = local_cache->get(local_cache, req);
+    if (!hit) {
       result[idx].n_miss++;
       result[idx].n_miss_byte += req->obj_size;
     }
+    /* the thread moves on to the next cache once this one converges */
+    if (params->early_stop != NULL && convergence_monitor_add(&monitor, !hit)) {
+      result[idx].early_stopped = true;
+      result[idx].miss_ratio_ci = monitor.half_width;
+      INFO("cache %s (size %" PRIu64 ") stops early after %" PRId64
+           " requests, miss ratio %.4lf +- %.4lf\n",
+           local_cache->cache_name, local_cache->cache_size, result[idx].n_req,
+           (double)result[idx].n_miss / (double)result[idx].n_req, monitor.half_width);
+      break;
+    }
     read_one_req(cloned_reader, req);
   }
 
-/* disabled due to ARC and LeCaR use ghost entries in the hash table */
-#if defined(SUPPORT_TTL) && defined(ENABLE_SCAN)
-  /* get expiration information */
-  if (local_cache->hashtable->n_obj != 0) {
-    cache_stat_t temp_stat;
-    memset(&temp_stat, 0, sizeof(cache_stat_t));
-    temp_stat.curr_rtime = req->clock_time;
-    get_cache_state(local_cache, &temp_stat);
-
-    if (local_cache->occupied_size != temp_stat.occupied_size) {
-      WARN(
-          "occupied_size not match, %ld vs %ld, maybe the "
-          "cache uses a ghost list, in which case, the expired "
-          "object count may not be accurate",
-          local_cache->occupied_size, temp_stat.occupied_size);
-    }
-    result[idx].expired_obj_cnt = temp_stat.expired_obj_cnt;
-    result[idx].expired_bytes = temp_stat.expired_bytes;
-  }
+#ifdef SUPPORT_TTL
+  /* the objects expired during warmup are not counted */
+  result[idx].expired_obj_cnt = local_cache->n_expired_obj - n_warmup_expired_obj;
+  result[idx].expired_bytes = local_cache->n_expired_byte - n_warmup_expired_byte;
 #endif
 
   result[idx].curr_rtime = req->clock_time;
@@ -200,6 +220,8 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache, in
   params->n_warmup_req = (uint64_t)((double)get_num_of_req(reader) * warmup_frac);
   params->result = result;
   params->free_cache_when_finish = true;
+  params->early_stop = NULL;
+  params->from_reader_pos = false;
   params->progress = &progress;
   params->use_random_seed = use_random_seed;
   g_mutex_init(&(params->mtx));
@@ -257,6 +279,15 @@ cache_stat_t *simulate_at_multi_sizes(reader_t *reader, const cache_t *cache, in
 cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[], int num_of_caches,
                                          reader_t *warmup_reader, double warmup_frac, int warmup_sec,
                                          int num_of_threads, bool free_cache_when_finish, bool use_random_seed) {
+  return simulate_with_multi_caches_early_stop(reader, caches, num_of_caches, warmup_reader, warmup_frac, warmup_sec,
+                                               num_of_threads, free_cache_when_finish, use_random_seed, NULL);
+}
+
+static cache_stat_t *_simulate_with_multi_caches(reader_t *reader, cache_t *caches[], int num_of_caches,
+                                                 reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+                                                 int num_of_threads, bool free_cache_when_finish,
+                                                 bool use_random_seed, const convergence_params_t *early_stop,
+                                                 bool from_reader_pos) {
   assert(num_of_caches > 0);
   int i, progress = 0;
 
@@ -271,6 +302,8 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[], in
   params->warmup_reader = warmup_reader;
   params->warmup_sec = warmup_sec;
   params->use_random_seed = use_random_seed;
+  params->early_stop = early_stop;
+  params->from_reader_pos = from_reader_pos;
   if (warmup_frac > 1e-6) {
     params->n_warmup_req = (uint64_t)((double)get_num_of_req(reader) * warmup_frac);
   } else {
@@ -317,6 +350,22 @@ cache_stat_t *simulate_with_multi_caches(reader_t *reader, cache_t *caches[], in
   return result;
 }
 
+cache_stat_t *simulate_with_multi_caches_early_stop(reader_t *reader, cache_t *caches[], int num_of_caches,
+                                                    reader_t *warmup_reader, double warmup_frac, int warmup_sec,
+                                                    int num_of_threads, bool free_cache_when_finish,
+                                                    bool use_random_seed, const convergence_params_t *early_stop) {
+  return _simulate_with_multi_caches(reader, caches, num_of_caches, warmup_reader, warmup_frac, warmup_sec,
+                                     num_of_threads, free_cache_when_finish, use_random_seed, early_stop, false);
+}
+
+cache_stat_t *simulate_with_multi_caches_from_reader_pos(reader_t *reader, cache_t *caches[], int num_of_caches,
+                                                         int num_of_threads, bool free_cache_when_finish,
+                                                         bool use_random_seed,
+                                                         const convergence_params_t *early_stop) {
+  return _simulate_with_multi_caches(reader, caches, num_of_caches, NULL, 0, 0, num_of_threads,
+                                     free_cache_when_finish, use_random_seed, early_stop, true);
+}
+
 cache_stat_t *simulate_with_multi_caches_scaling(reader_t **readers, cache_t *caches[], int num_of_caches,
                                                  reader_t *warmup_reader, double warmup_frac, int warmup_sec,
                                                  int num_of_threads, bool free_cache_when_finish) {
@@ -332,6 +381,8 @@ cache_stat_t *simulate_with_multi_caches_scaling(reader_t **readers, cache_t *ca
   params->warmup_reader = warmup_reader;
   params->warmup_sec = warmup_sec;
   params->use_random_seed = false;  // or set as desired
+  params->early_stop = NULL;
+  params->from_reader_pos = false;
   if (warmup_frac > 1e-6) {
     params->n_warmup_req = (uint64_t)((double)get_num_of_req(readers[0]) * warmup_frac);
   } else {
@@ -368,11 +419,505 @@ cache_stat_t *simulate_with_multi_caches_scaling(reader_t **readers, cache_t *ca
   g_mutex_clear(&(params->mtx));
   my_free(sizeof(sim_mt_params_t), params);
   for (int i=0; i<num_of_caches; i++) {
-    result[i].sampler_ratio = readers[i]->sampler->sampling_ratio;
+    result[i].sampler_ratio = readers[i]->sampler != NULL ? readers[i]->sampler->sampling_ratio : 1.0;
   }
   return result;
 }
 
+/* the fields of a request used by the eviction algorithms, a trace is loaded
+ * into an array of these before a concurrent replay */
+typedef struct {
+  int64_t clock_time;
+  uint64_t hv;
+  obj_id_t obj_id;
+  int64_t obj_size;
+  int64_t next_access_vtime;
+  int32_t ttl;
+  int32_t op;
+} compact_req_t;
+
+typedef struct {
+  cache_t *cache;
+  const compact_req_t *reqs;
+  /* by shard: the indices of the requests of this thread */
+  const int64_t *req_idx;
+  int64_t n_req;
+  /* by arrival: the next request to take, shared by all threads */
+  int64_t *next_req;
+  int thread_id;
+  cache_stat_t stat;
+} concurrent_worker_t;
+
+/* the number of requests a thread takes at a time when dispatching by arrival */
+#define CONCURRENT_CHUNK_SIZE 64
+
+static inline void fill_request(request_t *req, const compact_req_t *r) {
+  req->clock_time = r->clock_time;
+  req->hv = r->hv;
+  req->obj_id = r->obj_id;
+  req->obj_size = r->obj_size;
+  req->next_access_vtime = r->next_access_vtime;
+  req->ttl = r->ttl;
+  req->op = (req_op_e)r->op;
+}
+
+static inline void serve_request(concurrent_worker_t *worker, request_t *req, const compact_req_t *r) {
+  fill_request(req, r);
+  worker->stat.n_req += 1;
+  worker->stat.n_req_byte += r->obj_size;
+  if (!worker->cache->get(worker->cache, req)) {
+    worker->stat.n_miss += 1;
+    worker->stat.n_miss_byte += r->obj_size;
+  }
+}
+
+static gpointer _simulate_concurrent(gpointer data) {
+  concurrent_worker_t *worker = (concurrent_worker_t *)data;
+  set_rand_seed(worker->thread_id + 1);
+  request_t *req = new_request();
+
+  if (worker->req_idx != NULL) {
+    for (int64_t i = 0; i < worker->n_req; i++) {
+      serve_request(worker, req, &worker->reqs[worker->req_idx[i]]);
+    }
+  } else {
+    while (true) {
+      int64_t start = __atomic_fetch_add(worker->next_req, CONCURRENT_CHUNK_SIZE, __ATOMIC_RELAXED);
+      if (start >= worker->n_req) break;
+      int64_t end = MIN(start + CONCURRENT_CHUNK_SIZE, worker->n_req);
+      for (int64_t i = start; i < end; i++) {
+        serve_request(worker, req, &worker->reqs[i]);
+      }
+    }
+  }
+
+  free_request(req);
+  return NULL;
+}
+
+static compact_req_t *load_trace_in_memory(reader_t *reader, int64_t *n_req) {
+  int64_t capacity = 1 << 20, n = 0;
+  compact_req_t *reqs = malloc(sizeof(compact_req_t) * capacity);
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+
+  read_one_req(cloned_reader, req);
+  int64_t start_ts = (int64_t)req->clock_time;
+  while (req->valid) {
+    if (n == capacity) {
+      capacity *= 2;
+      reqs = realloc(reqs, sizeof(compact_req_t) * capacity);
+      ASSERT_NOT_NULL(reqs, "cannot allocate memory for %lld requests\n", (long long)capacity);
+    }
+    reqs[n++] = (compact_req_t){
+        .clock_time = req->clock_time - start_ts,
+        .hv = req->hv != 0 ? req->hv : get_hash_value_int_64(&req->obj_id),
+        .obj_id = req->obj_id,
+        .obj_size = req->obj_size,
+        .next_access_vtime = req->next_access_vtime,
+        .ttl = req->ttl,
+        .op = (int32_t)req->op,
+    };
+    read_one_req(cloned_reader, req);
+  }
+
+  free_request(req);
+  close_reader(cloned_reader);
+  *n_req = n;
+  return reqs;
+}
+
+double simulate_concurrent(reader_t *reader, cache_t *cache, int num_of_threads, concurrent_dispatch_e dispatch,
+                           double warmup_frac, cache_stat_t *stat) {
+  if (num_of_threads <= 0) {
+    ERROR("the number of threads must be positive, got %d\n", num_of_threads);
+  }
+  if (num_of_threads > 1 && !is_sharded_cache(cache)) {
+    ERROR("cache %s is not thread-safe, create it with sharded_cache_init\n", cache->cache_name);
+  }
+
+  int64_t n_req;
+  compact_req_t *reqs = load_trace_in_memory(reader, &n_req);
+  int64_t n_warmup_req = warmup_frac > 1e-6 ? (int64_t)((double)n_req * warmup_frac) : 0;
+
+  memset(stat, 0, sizeof(cache_stat_t));
+  strncpy(stat->cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+  stat->cache_size = cache->cache_size;
+  stat->n_warmup_req = n_warmup_req;
+
+  /* warm up in trace order */
+  if (n_warmup_req > 0) {
+    set_rand_seed(1);
+    request_t *req = new_request();
+    for (int64_t i = 0; i < n_warmup_req; i++) {
+      fill_request(req, &reqs[i]);
+      cache->get(cache, req);
+    }
+    free_request(req);
+  }
+
+  concurrent_worker_t *workers = calloc(num_of_threads, sizeof(concurrent_worker_t));
+  int64_t next_req = n_warmup_req;
+  int64_t **req_idx = NULL;
+  if (dispatch == CONCURRENT_DISPATCH_BY_SHARD && num_of_threads > 1) {
+    /* a shard belongs to one thread, the threads get the shards round-robin */
+    const sharded_cache_params_t *sharded_params = cache->eviction_params;
+    req_idx = calloc(num_of_threads, sizeof(int64_t *));
+    int64_t *n_thread_req = calloc(num_of_threads, sizeof(int64_t));
+    for (int64_t i = n_warmup_req; i < n_req; i++) {
+      request_t r = {.hv = reqs[i].hv, .obj_id = reqs[i].obj_id};
+      n_thread_req[sharded_cache_shard_of(cache, &r) % num_of_threads] += 1;
+    }
+    for (int t = 0; t < num_of_threads; t++) {
+      req_idx[t] = malloc(sizeof(int64_t) * MAX(n_thread_req[t], 1));
+      workers[t].req_idx = req_idx[t];
+      workers[t].n_req = 0;
+    }
+    for (int64_t i = n_warmup_req; i < n_req; i++) {
+      request_t r = {.hv = reqs[i].hv, .obj_id = reqs[i].obj_id};
+      int t = sharded_cache_shard_of(cache, &r) % num_of_threads;
+      req_idx[t][workers[t].n_req++] = i;
+    }
+    free(n_thread_req);
+    if (sharded_params->n_shard < num_of_threads) {
+      WARN("%d shards cannot keep %d threads busy\n", sharded_params->n_shard, num_of_threads);
+    }
+  } else {
+    for (int t = 0; t < num_of_threads; t++) {
+      workers[t].n_req = n_req;
+      workers[t].next_req = &next_req;
+    }
+  }
+
+  GThread **threads = malloc(sizeof(GThread *) * num_of_threads);
+  gint64 start_time = g_get_monotonic_time();
+  for (int t = 0; t < num_of_threads; t++) {
+    workers[t].cache = cache;
+    workers[t].reqs = reqs;
+    workers[t].thread_id = t;
+    threads[t] = g_thread_new("simulate_concurrent", _simulate_concurrent, &workers[t]);
+  }
+  for (int t = 0; t < num_of_threads; t++) {
+    g_thread_join(threads[t]);
+  }
+  double elapsed_sec = (double)(g_get_monotonic_time() - start_time) / 1e6;
+
+  for (int t = 0; t < num_of_threads; t++) {
+    stat->n_req += workers[t].stat.n_req;
+    stat->n_req_byte += workers[t].stat.n_req_byte;
+    stat->n_miss += workers[t].stat.n_miss;
+    stat->n_miss_byte += workers[t].stat.n_miss_byte;
+    if (req_idx != NULL) free(req_idx[t]);
+  }
+  stat->n_obj = cache->get_n_obj(cache);
+  stat->occupied_byte = cache->get_occupied_byte(cache);
+  stat->curr_rtime = n_req > 0 ? reqs[n_req - 1].clock_time : 0;
+
+  free(req_idx);
+  free(threads);
+  free(workers);
+  free(reqs);
+
+  return elapsed_sec > 0 ? (double)stat->n_req / elapsed_sec : 0;
+}
+
+/* the requests are decoded once into a chunk and every candidate that is
+ * still running replays the chunk, the next chunk is decoded while the
+ * candidates replay the current one */
+#define HALVING_CHUNK_SIZE (1 << 16)
+
+typedef struct {
+  compact_req_t *reqs;
+  int64_t n_req;
+  /* the chunk is part of the warmup and is not counted */
+  bool is_warmup;
+} halving_chunk_t;
+
+typedef struct {
+  cache_t **caches;
+  halving_result_t *results;
+  /* the requests and misses since the last checkpoint */
+  int64_t *interval_n_req;
+  int64_t *interval_n_miss;
+  /* the random number generator of each candidate, it is thread-local and a
+   * candidate runs on different threads */
+  __uint128_t *rand_states;
+  const halving_chunk_t *chunk;
+
+  GMutex mtx;
+  GCond cond;
+  int n_pending;
+} halving_params_t;
+
+static void _simulate_halving_chunk(gpointer data, gpointer user_data) {
+  halving_params_t *params = (halving_params_t *)user_data;
+  int idx = GPOINTER_TO_INT(data) - 1;
+  cache_t *cache = params->caches[idx];
+  cache_stat_t *stat = &params->results[idx].stat;
+  const halving_chunk_t *chunk = params->chunk;
+  g_lehmer64_state = params->rand_states[idx];
+
+  request_t *req = new_request();
+  int64_t n_miss = 0;
+  for (int64_t i = 0; i < chunk->n_req; i++) {
+    fill_request(req, &chunk->reqs[i]);
+    if (!cache->get(cache, req)) {
+      n_miss += 1;
+      if (!chunk->is_warmup) stat->n_miss_byte += req->obj_size;
+    }
+    if (!chunk->is_warmup) stat->n_req_byte += req->obj_size;
+  }
+  free_request(req);
+  params->rand_states[idx] = g_lehmer64_state;
+
+  if (chunk->is_warmup) {
+    stat->n_warmup_req += chunk->n_req;
+  } else {
+    stat->n_req += chunk->n_req;
+    stat->n_miss += n_miss;
+    params->interval_n_req[idx] += chunk->n_req;
+    params->interval_n_miss[idx] += n_miss;
+    stat->curr_rtime = chunk->reqs[chunk->n_req - 1].clock_time;
+  }
+
+  g_mutex_lock(&params->mtx);
+  params->n_pending -= 1;
+  if (params->n_pending == 0) g_cond_signal(&params->cond);
+  g_mutex_unlock(&params->mtx);
+}
+
+/* a chunk never crosses the end of the warmup or a checkpoint */
+static inline int64_t halving_chunk_size(int64_t n_read, int64_t n_warmup_req, int64_t checkpoint_req) {
+  return MIN(HALVING_CHUNK_SIZE, (n_read < n_warmup_req ? n_warmup_req : checkpoint_req) - n_read);
+}
+
+/* decode at most max_req requests into the chunk, return the number read */
+static int64_t read_halving_chunk(reader_t *reader, request_t *req, int64_t *start_ts, compact_req_t *reqs,
+                                  int64_t max_req) {
+  int64_t n = 0;
+  while (n < max_req && read_one_req(reader, req) == 0) {
+    if (*start_ts < 0) *start_ts = (int64_t)req->clock_time;
+    reqs[n++] = (compact_req_t){
+        .clock_time = req->clock_time - *start_ts,
+        .hv = req->hv,
+        .obj_id = req->obj_id,
+        .obj_size = req->obj_size,
+        .next_access_vtime = req->next_access_vtime,
+        .ttl = req->ttl,
+        .op = (int32_t)req->op,
+    };
+  }
+  return n;
+}
+
+typedef struct {
+  int idx;
+  int n_checkpoint_passed;
+  double miss_ratio;
+} halving_rank_t;
+
+static int cmp_halving_rank(const void *a, const void *b) {
+  const halving_rank_t *ra = (const halving_rank_t *)a;
+  const halving_rank_t *rb = (const halving_rank_t *)b;
+  if (ra->n_checkpoint_passed != rb->n_checkpoint_passed) {
+    return rb->n_checkpoint_passed - ra->n_checkpoint_passed;
+  }
+  if (ra->miss_ratio != rb->miss_ratio) {
+    return ra->miss_ratio < rb->miss_ratio ? -1 : 1;
+  }
+  return ra->idx - rb->idx;
+}
+
+/* sort the candidates from the best to the worst */
+static void sort_halving_candidates(int *candidates, int n, const halving_result_t *results) {
+  halving_rank_t *ranks = malloc(sizeof(halving_rank_t) * n);
+  for (int i = 0; i < n; i++) {
+    ranks[i] = (halving_rank_t){candidates[i], results[candidates[i]].n_checkpoint_passed,
+                                results[candidates[i]].miss_ratio};
+  }
+  qsort(ranks, n, sizeof(halving_rank_t), cmp_halving_rank);
+  for (int i = 0; i < n; i++) candidates[i] = ranks[i].idx;
+  free(ranks);
+}
+
+/**
+ * @brief stop the worse candidates at a checkpoint, keep ceil(n_alive / eta)
+ * of them by the miss ratio since the last checkpoint
+ *
+ * @return the number of candidates still running
+ */
+static int halving_checkpoint(halving_params_t *params, int *alive, int n_alive, double eta, int checkpoint,
+                              bool free_cache_when_finish) {
+  for (int i = 0; i < n_alive; i++) {
+    int idx = alive[i];
+    params->results[idx].miss_ratio =
+        params->interval_n_req[idx] > 0
+            ? (double)params->interval_n_miss[idx] / (double)params->interval_n_req[idx]
+            : 0;
+    params->interval_n_req[idx] = 0;
+    params->interval_n_miss[idx] = 0;
+  }
+
+  sort_halving_candidates(alive, n_alive, params->results);
+  int n_keep = (int)ceil((double)n_alive / eta);
+  for (int i = 0; i < n_alive; i++) {
+    int idx = alive[i];
+    if (i >= n_keep) {
+      params->results[idx].n_checkpoint_passed = checkpoint;
+      params->results[idx].stat.n_obj = params->caches[idx]->get_n_obj(params->caches[idx]);
+      params->results[idx].stat.occupied_byte = params->caches[idx]->get_occupied_byte(params->caches[idx]);
+      if (free_cache_when_finish) {
+        params->caches[idx]->cache_free(params->caches[idx]);
+        params->caches[idx] = NULL;
+      }
+    } else {
+      params->results[idx].n_checkpoint_passed = checkpoint + 1;
+    }
+  }
+
+  return n_keep;
+}
+
+halving_result_t *simulate_with_multi_caches_halving(reader_t *reader, cache_t *caches[], int num_of_caches,
+                                                     double warmup_frac, double first_checkpoint_frac, double eta,
+                                                     int num_of_threads, bool free_cache_when_finish) {
+  assert(num_of_caches > 0);
+  if (eta <= 1) {
+    ERROR("eta must be larger than 1, got %lf\n", eta);
+  }
+  if (first_checkpoint_frac <= 0 || first_checkpoint_frac > 1) {
+    ERROR("the first checkpoint must be in (0, 1], got %lf\n", first_checkpoint_frac);
+  }
+
+  int64_t n_total_req = get_num_of_req(reader);
+  int64_t n_warmup_req = warmup_frac > 1e-6 ? (int64_t)((double)n_total_req * warmup_frac) : 0;
+  int64_t n_measure_req = n_total_req - n_warmup_req;
+
+  /* the checkpoints are at first_checkpoint_frac, first_checkpoint_frac * eta
+   * ... of the requests after the warmup, the last one is the end */
+  int n_checkpoint = 0;
+  int64_t *checkpoints = malloc(sizeof(int64_t) * 64);
+  for (double frac = first_checkpoint_frac; frac < 1 && n_checkpoint < 63; frac *= eta) {
+    int64_t pos = n_warmup_req + (int64_t)((double)n_measure_req * frac);
+    if (pos > (n_checkpoint > 0 ? checkpoints[n_checkpoint - 1] : n_warmup_req)) {
+      checkpoints[n_checkpoint++] = pos;
+    }
+  }
+  checkpoints[n_checkpoint] = INT64_MAX;
+
+  halving_result_t *results = calloc(num_of_caches, sizeof(halving_result_t));
+  int *alive = malloc(sizeof(int) * num_of_caches);
+  for (int i = 0; i < num_of_caches; i++) {
+    strncpy(results[i].stat.cache_name, caches[i]->cache_name, CACHE_NAME_ARRAY_LEN);
+    results[i].stat.cache_size = caches[i]->cache_size;
+    alive[i] = i;
+  }
+  int n_alive = num_of_caches;
+
+  halving_params_t *params = my_malloc(halving_params_t);
+  params->caches = caches;
+  params->results = results;
+  params->interval_n_req = calloc(num_of_caches, sizeof(int64_t));
+  params->interval_n_miss = calloc(num_of_caches, sizeof(int64_t));
+  /* every candidate starts with the seed of simulate_with_multi_caches */
+  params->rand_states = malloc(sizeof(__uint128_t) * num_of_caches);
+  for (int i = 0; i < num_of_caches; i++) params->rand_states[i] = 1;
+  params->n_pending = 0;
+  g_mutex_init(&params->mtx);
+  g_cond_init(&params->cond);
+
+  GThreadPool *gthread_pool =
+      g_thread_pool_new((GFunc)_simulate_halving_chunk, (gpointer)params, num_of_threads, TRUE, NULL);
+  ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in simulator\n");
+
+  INFO("%s starts computation, num_warmup_req %lld, %d candidates, %d checkpoints, eta %.2lf, %d threads\n",
+       __func__, (long long)n_warmup_req, num_of_caches, n_checkpoint, eta, num_of_threads);
+
+  reader_t *cloned_reader = clone_reader(reader);
+  request_t *req = new_request();
+  int64_t start_ts = -1, n_read = 0;
+  int checkpoint = 0;
+  halving_chunk_t chunks[2];
+  for (int i = 0; i < 2; i++) {
+    chunks[i].reqs = malloc(sizeof(compact_req_t) * HALVING_CHUNK_SIZE);
+  }
+
+  int cur = 0;
+  chunks[cur].is_warmup = n_warmup_req > 0;
+  chunks[cur].n_req = read_halving_chunk(cloned_reader, req, &start_ts, chunks[cur].reqs,
+                                         halving_chunk_size(n_read, n_warmup_req, checkpoints[checkpoint]));
+  n_read += chunks[cur].n_req;
+
+  while (chunks[cur].n_req > 0) {
+    params->chunk = &chunks[cur];
+    params->n_pending = n_alive;
+    for (int i = 0; i < n_alive; i++) {
+      ASSERT_TRUE(g_thread_pool_push(gthread_pool, GINT_TO_POINTER(alive[i] + 1), NULL),
+                  "cannot push data into thread_pool in %s\n", __func__);
+    }
+
+    /* a chunk that ends at a checkpoint is followed by the checkpoint, so
+     * the next chunk starts at the following one */
+    bool at_checkpoint = !chunks[cur].is_warmup && n_read == checkpoints[checkpoint];
+    int next_checkpoint = at_checkpoint ? checkpoint + 1 : checkpoint;
+    int next = 1 - cur;
+    chunks[next].is_warmup = n_read < n_warmup_req;
+    chunks[next].n_req = read_halving_chunk(cloned_reader, req, &start_ts, chunks[next].reqs,
+                                            halving_chunk_size(n_read, n_warmup_req, checkpoints[next_checkpoint]));
+
+    g_mutex_lock(&params->mtx);
+    while (params->n_pending > 0) g_cond_wait(&params->cond, &params->mtx);
+    g_mutex_unlock(&params->mtx);
+
+    if (at_checkpoint) {
+      int n_keep = n_alive > 1 ? halving_checkpoint(params, alive, n_alive, eta, checkpoint, free_cache_when_finish)
+                               : n_alive;
+      INFO("checkpoint %d at %lld requests, %d of %d candidates continue\n", checkpoint + 1, (long long)n_read,
+           n_keep, n_alive);
+      n_alive = n_keep;
+      checkpoint = next_checkpoint;
+    }
+    n_read += chunks[next].n_req;
+    cur = next;
+  }
+
+  /* the candidates that reach the end are ranked by the miss ratio after the
+   * warmup */
+  for (int i = 0; i < n_alive; i++) {
+    int idx = alive[i];
+    cache_stat_t *stat = &results[idx].stat;
+    results[idx].n_checkpoint_passed = n_checkpoint + 1;
+    results[idx].miss_ratio = stat->n_req > 0 ? (double)stat->n_miss / (double)stat->n_req : 0;
+    stat->n_obj = caches[idx]->get_n_obj(caches[idx]);
+    stat->occupied_byte = caches[idx]->get_occupied_byte(caches[idx]);
+    if (free_cache_when_finish) {
+      caches[idx]->cache_free(caches[idx]);
+      caches[idx] = NULL;
+    }
+  }
+
+  int *order = malloc(sizeof(int) * num_of_caches);
+  for (int i = 0; i < num_of_caches; i++) order[i] = i;
+  sort_halving_candidates(order, num_of_caches, results);
+  for (int i = 0; i < num_of_caches; i++) results[order[i]].rank = i + 1;
+
+  g_thread_pool_free(gthread_pool, FALSE, TRUE);
+  g_mutex_clear(&params->mtx);
+  g_cond_clear(&params->cond);
+  free(params->interval_n_req);
+  free(params->interval_n_miss);
+  free(params->rand_states);
+  my_free(sizeof(halving_params_t), params);
+  for (int i = 0; i < 2; i++) free(chunks[i].reqs);
+  free_request(req);
+  close_reader(cloned_reader);
+  free(checkpoints);
+  free(alive);
+  free(order);
+
+  return results;
+}
+
 #ifdef __cplusplus
 }
 #endif
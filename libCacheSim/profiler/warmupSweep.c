@@ -0,0 +1,255 @@
+//
+//  warmupSweep.c
+//  libCacheSim
+//
+//  warm up one cache and continue several variants of it with different
+//  parameters over the rest of the trace, see simulate_variants_after_warmup
+//  in simulator.h
+//
+//  the warm cache is only read after the warmup, so the thread workers clone
+//  it concurrently and a forked child shares its pages with the parent until
+//  the child writes to them
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../include/libCacheSim/checkpoint.h"
+#include "../include/libCacheSim/simulator.h"
+#include "../utils/include/mymath.h"
+
+typedef struct {
+  const cache_t *warm_cache;
+  /* the reader stopped after the last warmup request */
+  const reader_t *warm_reader;
+  int64_t start_ts;
+  const char **variant_params;
+  cache_stat_t *result;
+} sweep_params_t;
+
+/* the parameters of a variant override the ones the cache was created with,
+ * the parsers apply the keys in order so the later value wins */
+static void merge_variant_params(const cache_t *cache, const char *variant_params, char *buf, size_t buf_size) {
+  if (cache->init_params[0] == '\0') {
+    snprintf(buf, buf_size, "%s", variant_params);
+  } else {
+    snprintf(buf, buf_size, "%s,%s", cache->init_params, variant_params);
+  }
+}
+
+/**
+ * @brief create variant idx from the warm cache and replay the rest of the
+ * trace on it
+ *
+ * @return false if the variant cannot be created
+ */
+static bool simulate_variant(sweep_params_t *params, int idx, bool can_use_warm_cache) {
+  cache_stat_t *stat = &params->result[idx];
+  const char *variant_params = params->variant_params[idx];
+  set_rand_seed(1);
+
+  /* a forked child owns its copy of the warm cache */
+  cache_t *cache = (cache_t *)params->warm_cache;
+  if (variant_params != NULL || !can_use_warm_cache) {
+    char merged_params[CACHE_INIT_PARAMS_LEN * 2];
+    if (variant_params != NULL) {
+      merge_variant_params(params->warm_cache, variant_params, merged_params, sizeof(merged_params));
+      variant_params = merged_params;
+    }
+    cache = deep_clone_cache(params->warm_cache, variant_params);
+    if (cache == NULL) return false;
+  }
+  strncpy(stat->cache_name, cache->cache_name, CACHE_NAME_ARRAY_LEN);
+
+  reader_t *reader = clone_reader(params->warm_reader);
+  if (!reader_copy_pos(reader, params->warm_reader)) {
+    close_reader(reader);
+    if (cache != params->warm_cache) cache->cache_free(cache);
+    return false;
+  }
+
+#ifdef SUPPORT_TTL
+  int64_t n_warmup_expired_obj = cache->n_expired_obj;
+  int64_t n_warmup_expired_byte = cache->n_expired_byte;
+#endif
+
+  request_t *req = new_request();
+  read_one_req(reader, req);
+  while (req->valid) {
+    stat->n_req++;
+    stat->n_req_byte += req->obj_size;
+
+    req->clock_time -= params->start_ts;
+    if (cache->get(cache, req) == false) {
+      stat->n_miss++;
+      stat->n_miss_byte += req->obj_size;
+    }
+    read_one_req(reader, req);
+  }
+
+#ifdef SUPPORT_TTL
+  stat->expired_obj_cnt = cache->n_expired_obj - n_warmup_expired_obj;
+  stat->expired_bytes = cache->n_expired_byte - n_warmup_expired_byte;
+#endif
+  stat->curr_rtime = req->clock_time;
+  stat->n_obj = cache->get_n_obj(cache);
+  stat->occupied_byte = cache->get_occupied_byte(cache);
+
+  free_request(req);
+  close_reader(reader);
+  if (cache != params->warm_cache) cache->cache_free(cache);
+  return true;
+}
+
+static void simulate_variant_thread(gpointer data, gpointer user_data) {
+  sweep_params_t *params = (sweep_params_t *)user_data;
+  int idx = GPOINTER_TO_INT(data) - 1;
+  if (!simulate_variant(params, idx, false)) {
+    WARN("cannot simulate variant %d \"%s\" of %s\n", idx,
+         params->variant_params[idx] == NULL ? "" : params->variant_params[idx], params->warm_cache->cache_name);
+  }
+}
+
+/**
+ * @brief wait for one child, read its result from its pipe
+ *
+ * @return the number of children that are still running
+ */
+static int wait_variant_process(sweep_params_t *params, pid_t *pids, int *fds, int n_variant, int n_running) {
+  int status;
+  pid_t pid = waitpid(-1, &status, 0);
+  if (pid < 0) {
+    ERROR("waitpid failed: %s\n", strerror(errno));
+  }
+
+  for (int i = 0; i < n_variant; i++) {
+    if (pids[i] != pid) continue;
+
+    /* the result is smaller than the pipe buffer, so the child has written
+     * it before it exits */
+    cache_stat_t stat;
+    ssize_t n_read = read(fds[i], &stat, sizeof(stat));
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && n_read == (ssize_t)sizeof(stat)) {
+      params->result[i] = stat;
+    } else {
+      WARN("cannot simulate variant %d \"%s\" of %s\n", i,
+           params->variant_params[i] == NULL ? "" : params->variant_params[i], params->warm_cache->cache_name);
+    }
+    close(fds[i]);
+    pids[i] = 0;
+    return n_running - 1;
+  }
+
+  return n_running;
+}
+
+static void simulate_variant_processes(sweep_params_t *params, int n_variant, int n_process) {
+  pid_t *pids = calloc(n_variant, sizeof(pid_t));
+  int *fds = calloc(n_variant, sizeof(int));
+  int n_running = 0;
+
+  /* the buffered output would be printed again by every child */
+  fflush(NULL);
+  for (int i = 0; i < n_variant; i++) {
+    if (n_running == n_process) {
+      n_running = wait_variant_process(params, pids, fds, n_variant, n_running);
+    }
+
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+      ERROR("cannot create pipe: %s\n", strerror(errno));
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+      ERROR("cannot fork: %s\n", strerror(errno));
+    }
+
+    if (pid == 0) {
+      close(pipe_fds[0]);
+      bool ok = simulate_variant(params, i, true);
+      ok = ok && write(pipe_fds[1], &params->result[i], sizeof(cache_stat_t)) == (ssize_t)sizeof(cache_stat_t);
+      close(pipe_fds[1]);
+      _exit(ok ? 0 : 1);
+    }
+
+    close(pipe_fds[1]);
+    pids[i] = pid;
+    fds[i] = pipe_fds[0];
+    n_running += 1;
+  }
+
+  while (n_running > 0) {
+    n_running = wait_variant_process(params, pids, fds, n_variant, n_running);
+  }
+
+  free(pids);
+  free(fds);
+}
+
+cache_stat_t *simulate_variants_after_warmup(reader_t *reader, cache_t *cache, int n_variant,
+                                             const char *variant_params[], double warmup_frac, int num_of_threads,
+                                             warmup_sweep_mode_e mode) {
+  assert(n_variant > 0);
+  cache_stat_t *result = calloc(n_variant, sizeof(cache_stat_t));
+
+  int64_t n_warmup_req = (int64_t)((double)get_num_of_req(reader) * warmup_frac);
+  reader_t *warm_reader = clone_reader(reader);
+  request_t *req = new_request();
+  int64_t start_ts = 0;
+  set_rand_seed(1);
+
+  /* stop right after the last warmup request, so that the variants start
+   * from the position of warm_reader */
+  for (int64_t n = 0; n < n_warmup_req; n++) {
+    if (read_one_req(warm_reader, req) != 0) break;
+    if (n == 0) start_ts = (int64_t)req->clock_time;
+    req->clock_time -= start_ts;
+    cache->get(cache, req);
+  }
+  free_request(req);
+
+  for (int i = 0; i < n_variant; i++) {
+    result[i].cache_size = cache->cache_size;
+    result[i].n_warmup_req = warm_reader->n_read_req;
+  }
+  INFO("%s finishes warm up %s with %lld requests, simulate %d variants with %d %s\n", __func__, cache->cache_name,
+       (long long)warm_reader->n_read_req, n_variant, num_of_threads,
+       mode == WARMUP_SWEEP_FORK ? "processes" : "threads");
+
+  sweep_params_t params = {
+      .warm_cache = cache,
+      .warm_reader = warm_reader,
+      .start_ts = start_ts,
+      .variant_params = variant_params,
+      .result = result,
+  };
+
+  if (mode == WARMUP_SWEEP_FORK) {
+    simulate_variant_processes(&params, n_variant, num_of_threads);
+  } else {
+    GThreadPool *gthread_pool =
+        g_thread_pool_new((GFunc)simulate_variant_thread, (gpointer)&params, num_of_threads, TRUE, NULL);
+    ASSERT_NOT_NULL(gthread_pool, "cannot create thread pool in simulator\n");
+    for (int i = 1; i < n_variant + 1; i++) {
+      ASSERT_TRUE(g_thread_pool_push(gthread_pool, GINT_TO_POINTER(i), NULL),
+                  "cannot push data into thread_pool in %s\n", __func__);
+    }
+    g_thread_pool_free(gthread_pool, FALSE, TRUE);
+  }
+
+  close_reader(warm_reader);
+  return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
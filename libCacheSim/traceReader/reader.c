@@ -617,6 +617,137 @@ void reader_set_read_pos(reader_t *const reader, double pos) {
   }
 }
 
+/* "LCSRCKPT" */
+#define READER_CHECKPOINT_MAGIC 0x54504b435253434cULL
+#define READER_CHECKPOINT_VERSION 1
+
+typedef struct {
+  uint64_t magic;
+  int32_t version;
+  int32_t trace_type;
+  int64_t file_size;
+  int64_t n_read_req;
+  /* the file offset of the next request, -1 if the reader has to read the
+   * trace from the start to get there, e.g., a zstd compressed trace */
+  int64_t offset;
+} reader_checkpoint_t;
+
+/* the position of the reader in the trace file, -1 if the position can only
+ * be reached by reading the trace from the start, e.g., a zstd compressed
+ * trace */
+static int64_t reader_offset(const reader_t *reader) {
+  if (reader->trace_format == TXT_TRACE_FORMAT) {
+    return ftell(reader->file);
+  } else if (!reader->is_zstd_file) {
+    return (int64_t)reader->mmap_offset;
+  }
+  return -1;
+}
+
+/* move the reader to the offset returned by reader_offset after n_read_req
+ * requests, return false if the trace has fewer requests */
+static bool move_reader_to(reader_t *reader, int64_t offset, int64_t n_read_req) {
+  if (offset >= 0) {
+    if (reader->trace_format == TXT_TRACE_FORMAT) {
+      fseek(reader->file, offset, SEEK_SET);
+    } else {
+      reader->mmap_offset = offset;
+    }
+    reader->n_read_req = n_read_req;
+    reader->n_req_left = 0;
+    return true;
+  }
+
+  /* read the requests again without the sampler, whose decisions do not
+   * change the position in the trace */
+  sampler_t *sampler = reader->sampler;
+  reader->sampler = NULL;
+  reset_reader(reader);
+  request_t *req = new_request();
+  while (reader->n_read_req < n_read_req) {
+    if (read_one_req(reader, req) != 0) break;
+  }
+  free_request(req);
+  reader->sampler = sampler;
+  reader->n_req_left = 0;
+
+  return reader->n_read_req == n_read_req;
+}
+
+bool reader_checkpoint(const reader_t *reader, const char *path) {
+  if (reader->n_req_left > 0) {
+    WARN("cannot checkpoint the reader between the chunks of a request\n");
+    return false;
+  }
+  if (reader->sampler != NULL && reader->sampler->type == TEMPORAL_SAMPLER) {
+    WARN("cannot checkpoint a reader with a temporal sampler\n");
+    return false;
+  }
+
+  reader_checkpoint_t ckpt = {
+      .magic = READER_CHECKPOINT_MAGIC,
+      .version = READER_CHECKPOINT_VERSION,
+      .trace_type = reader->trace_type,
+      .file_size = (int64_t)reader->file_size,
+      .n_read_req = reader->n_read_req,
+      .offset = reader_offset(reader),
+  };
+
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    WARN("cannot open %s to write the reader checkpoint\n", path);
+    return false;
+  }
+  bool ok = fwrite(&ckpt, sizeof(ckpt), 1, f) == 1;
+  ok = fclose(f) == 0 && ok;
+  if (!ok) {
+    WARN("failed to write the reader checkpoint to %s\n", path);
+  }
+  return ok;
+}
+
+bool reader_restore(reader_t *reader, const char *path) {
+  reader_checkpoint_t ckpt;
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    WARN("cannot open reader checkpoint %s\n", path);
+    return false;
+  }
+  bool ok = fread(&ckpt, sizeof(ckpt), 1, f) == 1;
+  fclose(f);
+  if (!ok || ckpt.magic != READER_CHECKPOINT_MAGIC || ckpt.version != READER_CHECKPOINT_VERSION) {
+    WARN("%s is not a reader checkpoint\n", path);
+    return false;
+  }
+  if (ckpt.trace_type != (int32_t)reader->trace_type || ckpt.file_size != (int64_t)reader->file_size) {
+    WARN("%s is the checkpoint of a different trace\n", path);
+    return false;
+  }
+
+  if (!move_reader_to(reader, ckpt.offset, ckpt.n_read_req)) {
+    WARN("%s: the trace has only %ld requests\n", path, (long)reader->n_read_req);
+    return false;
+  }
+  return true;
+}
+
+bool reader_copy_pos(reader_t *reader, const reader_t *src) {
+  if (reader->trace_type != src->trace_type || reader->file_size != src->file_size) {
+    WARN("cannot copy the position of a reader of a different trace\n");
+    return false;
+  }
+  if (src->n_req_left > 0) {
+    WARN("cannot copy the position of a reader between the chunks of a request\n");
+    return false;
+  }
+  if (src->sampler != NULL && src->sampler->type == TEMPORAL_SAMPLER) {
+    WARN("cannot copy the position of a reader with a temporal sampler\n");
+    return false;
+  }
+
+  return move_reader_to(reader, reader_offset(src), src->n_read_req);
+}
+
 void read_first_req(reader_t *reader, request_t *req) {
   uint64_t offset = reader->mmap_offset;
   reset_reader(reader);
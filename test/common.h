@@ -81,6 +81,64 @@ static reader_t *setup_oracleGeneralBin_reader(void) {
   return reader_oracle;
 }
 
+#define SYNTHETIC_N_REQ 200000
+#define SYNTHETIC_N_OBJ 40000
+#define SYNTHETIC_N_REQ_BYTE 7033834496ULL
+#define SYNTHETIC_REC_SIZE 24
+
+/**
+ * a skewed trace of SYNTHETIC_N_REQ requests written to the working directory
+ * as oracleGeneral, it only uses integer arithmetic so that the results are
+ * the same on every platform, and it does not need the traces in data/
+ *
+ * @param ignore_obj_size every object has size 1, so cache sizes are in objects
+ */
+static reader_t *setup_synthetic_reader(bool ignore_obj_size) {
+  const char *path = "synthetic.oracleGeneral.bin";
+  char *buf = (char *)g_malloc(SYNTHETIC_N_REQ * SYNTHETIC_REC_SIZE);
+  uint32_t *rank = (uint32_t *)g_malloc(SYNTHETIC_N_REQ * sizeof(uint32_t));
+  int64_t *next_access = (int64_t *)g_malloc(SYNTHETIC_N_OBJ * sizeof(int64_t));
+
+  uint64_t state = 88172645463325252ULL;
+  for (int64_t i = 0; i < SYNTHETIC_N_REQ; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    /* u^3 concentrates the requests on the small ranks */
+    uint64_t u = state >> 32;
+    uint64_t skewed = (((u * u) >> 32) * u) >> 32;
+    rank[i] = (uint32_t)((skewed * SYNTHETIC_N_OBJ) >> 32);
+  }
+  for (int64_t i = 0; i < SYNTHETIC_N_OBJ; i++) next_access[i] = -1;
+
+  for (int64_t i = SYNTHETIC_N_REQ - 1; i >= 0; i--) {
+    char *rec = buf + i * SYNTHETIC_REC_SIZE;
+    uint32_t clock_time = (uint32_t)(i / 100);
+    uint64_t obj_id = (uint64_t)rank[i] * 7919 + 13;
+    uint32_t obj_size = 1024 * (1 + (uint32_t)((obj_id * 2654435761ULL) % 64));
+    memcpy(rec, &clock_time, 4);
+    memcpy(rec + 4, &obj_id, 8);
+    memcpy(rec + 12, &obj_size, 4);
+    memcpy(rec + 16, &next_access[rank[i]], 8);
+    next_access[rank[i]] = i;
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (f == NULL || fwrite(buf, SYNTHETIC_REC_SIZE, SYNTHETIC_N_REQ, f) != SYNTHETIC_N_REQ) {
+    ERROR("cannot write %s\n", path);
+  }
+  fclose(f);
+  g_free(buf);
+  g_free(rank);
+  g_free(next_access);
+
+  reader_init_param_t *init_params = g_new0(reader_init_param_t, 1);
+  init_params->ignore_obj_size = ignore_obj_size;
+  reader_t *reader = setup_reader(path, ORACLE_GENERAL_TRACE, init_params);
+  g_free(init_params);
+  return reader;
+}
+
 static reader_t *setup_GLCacheTestData_reader(void) {
   const char *url =
       "https://ftp.pdl.cmu.edu/pub/datasets/twemcacheWorkload/"
@@ -238,6 +296,8 @@ static cache_t *create_test_cache(const char *alg_name,
     cache = LFUDA_init(cc_params, NULL);
   } else if (strcasecmp(alg_name, "GDSF") == 0) {
     cache = GDSF_init(cc_params, NULL);
+  } else if (strcasecmp(alg_name, "GDSF-set") == 0) {
+    cache = GDSF_init(cc_params, "pq-type=set");
   } else if (strcasecmp(alg_name, "ARC") == 0) {
     cache = ARC_init(cc_params, NULL);
 #if defined(ENABLE_GLCACHE) && ENABLE_GLCACHE == 1
@@ -257,18 +317,33 @@ static cache_t *create_test_cache(const char *alg_name,
       init_params =
           "type=learned, "
           "train-source-y=online, rank-intvl=0.05, retrain-intvl=172800";
+    } else if (strcasecmp(alg_name, "GLCache-LearnedOnlineAsync") == 0) {
+      init_params =
+          "type=learned, "
+          "train-source-y=online, rank-intvl=0.05, retrain-intvl=172800, "
+          "train-mode=async";
+    } else if (strcasecmp(alg_name, "GLCache-LearnedOnlineDeterministic") ==
+               0) {
+      init_params =
+          "type=learned, "
+          "train-source-y=online, rank-intvl=0.05, retrain-intvl=172800, "
+          "train-mode=deterministic, swap-delay=100000";
     }
     cache = GLCache_init(cc_params, init_params);
 #endif
 #if defined(ENABLE_3L_CACHE) && ENABLE_3L_CACHE == 1
   } else if (strncasecmp(alg_name, "3LCache", 7) == 0) {
-    const char *init_params = NULL;
+    const char *init_params = params;
     if (strcasecmp(alg_name, "3LCache-object-miss-ratio") == 0) {
       init_params = "objective=object-miss-ratio";
     } else if (strcasecmp(alg_name, "3LCache-byte-miss-ratio") == 0) {
       init_params = "objective=byte-miss-ratio";
     }
     cache = ThreeLCache_init(cc_params, init_params);
+#endif
+#if defined(ENABLE_LRB) && ENABLE_LRB == 1
+  } else if (strcasecmp(alg_name, "LRB") == 0) {
+    cache = LRB_init(cc_params, params);
 #endif
   } else if (strcasecmp(alg_name, "LHD") == 0) {
     cache = LHD_init(cc_params, NULL);
@@ -318,6 +393,16 @@ static cache_t *create_test_cache(const char *alg_name,
   } else if (strcasecmp(alg_name, "BloomFilter") == 0) {
     cache = LRU_init(cc_params, NULL);
     cache->admissioner = create_bloomfilter_admissioner(NULL);
+  } else if (strcasecmp(alg_name, "WTinyLFU") == 0) {
+    cache = WTinyLFU_init(cc_params, NULL);
+  } else if (strcasecmp(alg_name, "WTinyLFU-CBF") == 0) {
+    cache = WTinyLFU_init(cc_params, "sketch=cbf");
+  } else if (strcasecmp(alg_name, "TinyLFU") == 0) {
+    cache = LRU_init(cc_params, NULL);
+    cache->admissioner = create_tinylfu_admissioner(NULL);
+  } else if (strcasecmp(alg_name, "BloomFilterExact") == 0) {
+    cache = LRU_init(cc_params, NULL);
+    cache->admissioner = create_bloomfilter_admissioner("mode=exact");
   } else {
     printf("cannot recognize algorithm %s\n", alg_name);
     exit(1);
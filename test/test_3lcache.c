@@ -63,6 +63,83 @@ static void test_3LCache_BYTE_MISS_RATIO(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+#define ThreeLCache_SYNTHETIC_CACHE_SIZE (32 * MiB)
+#define ThreeLCache_N_PASS 4
+/* the number of batches in ThreeLCache_N_PASS passes */
+#define ThreeLCache_N_SYNC_MODEL 2
+
+typedef struct {
+  uint64_t n_req;
+  uint64_t n_miss;
+  uint64_t n_miss_byte;
+  int64_t n_installed_model;
+} ThreeLCache_run_t;
+
+/* the synthetic trace is replayed so that several batches are trained */
+static ThreeLCache_run_t run_3LCache(reader_t *reader, const char *params) {
+  common_cache_params_t cc_params = {
+      .cache_size = ThreeLCache_SYNTHETIC_CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("3LCache", cc_params, reader, params);
+  request_t *req = new_request();
+  ThreeLCache_run_t run = {0};
+
+  for (int i = 0; i < ThreeLCache_N_PASS; i++) {
+    reset_reader(reader);
+    while (read_one_req(reader, req) == 0) {
+      run.n_req += 1;
+      if (!cache->get(cache, req)) {
+        run.n_miss += 1;
+        run.n_miss_byte += req->obj_size;
+      }
+    }
+  }
+  run.n_installed_model = ThreeLCache_get_n_installed_model(cache);
+  printf("%s: req %" PRIu64 " miss %" PRIu64 " miss_byte %" PRIu64 " models %" PRId64 "\n", cache->cache_name,
+         run.n_req, run.n_miss, run.n_miss_byte, run.n_installed_model);
+
+  free_request(req);
+  cache->cache_free(cache);
+  return run;
+}
+
+/* the results before the training modes were added */
+static void test_3LCache_sync_training(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  ThreeLCache_run_t run = run_3LCache(reader, "objective=byte-miss-ratio,training=sync");
+
+  g_assert_cmpuint(run.n_req, ==, SYNTHETIC_N_REQ * ThreeLCache_N_PASS);
+  g_assert_cmpuint(run.n_miss, ==, 602094);
+  g_assert_cmpuint(run.n_miss_byte, ==, 19979151360ULL);
+  g_assert_cmpint(run.n_installed_model, ==, ThreeLCache_N_SYNC_MODEL);
+}
+
+/* the deterministic mode does not depend on the training speed, and the
+ * results change with the swap delay only if the installed models are used */
+static void test_3LCache_deterministic_training(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  ThreeLCache_run_t run1 = run_3LCache(reader, "objective=byte-miss-ratio,training=deterministic,swap-delay=1000");
+  ThreeLCache_run_t run2 = run_3LCache(reader, "objective=byte-miss-ratio,training=deterministic,swap-delay=1000");
+  ThreeLCache_run_t run3 =
+      run_3LCache(reader, "objective=byte-miss-ratio,training=deterministic,swap-delay=100000000");
+
+  g_assert_cmpint(run1.n_installed_model, ==, ThreeLCache_N_SYNC_MODEL);
+  g_assert_cmpint(run1.n_installed_model, ==, run2.n_installed_model);
+  g_assert_cmpuint(run1.n_miss, ==, run2.n_miss);
+  g_assert_cmpuint(run1.n_miss_byte, ==, run2.n_miss_byte);
+  g_assert_cmpint(run3.n_installed_model, >, 0);
+  g_assert_cmpuint(run3.n_miss, !=, run1.n_miss);
+}
+
+/* the models trained on the worker thread are installed, the last one may
+ * still be training when the trace ends */
+static void test_3LCache_async_training(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  ThreeLCache_run_t run = run_3LCache(reader, "objective=byte-miss-ratio,training=async");
+
+  g_assert_cmpint(run.n_installed_model, >=, ThreeLCache_N_SYNC_MODEL - 1);
+  g_assert_cmpfloat(fabs((double)run.n_miss - 602094) / 602094, <, 0.05);
+}
+
 static void empty_test(gconstpointer user_data) { ; }
 
 int main(int argc, char *argv[]) {
@@ -71,6 +148,13 @@ int main(int argc, char *argv[]) {
   reader_t *reader;
 
 #if defined(ENABLE_3L_CACHE) && ENABLE_3L_CACHE == 1
+  reader = setup_synthetic_reader(false);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_3LCache_sync_training", reader, test_3LCache_sync_training);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_3LCache_deterministic_training", reader,
+                       test_3LCache_deterministic_training);
+  g_test_add_data_func_full("/libCacheSim/cacheAlgo_3LCache_async_training", reader, test_3LCache_async_training,
+                            test_teardown);
+
   reader = setup_3LCacheTestData_reader();
   g_test_add_data_func("/libCacheSim/cacheAlgo_3LCache_OBJECT_MISS_RATIO", reader, test_3LCache_OBJECT_MISS_RATIO);
   g_test_add_data_func("/libCacheSim/cacheAlgo_3LCache_BYTE_MISS_RATIO", reader, test_3LCache_BYTE_MISS_RATIO);
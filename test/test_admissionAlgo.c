@@ -101,6 +101,42 @@ static void test_BloomFilter(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+/* the hash table mode has no false positives, the default mode reaches the
+ * same result because this trace fills a tiny part of its filters */
+static void test_BloomFilterExact(gconstpointer user_data) {
+  uint64_t miss_cnt_true[] = {94816, 90386, 88417, 85744, 82344, 79504, 77058, 76979};
+  uint64_t miss_byte_true[] = {4193502720, 3979631104, 3877562880, 3716727296, 3503820288, 3323299328, 3257762304, 3254848512};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("BloomFilterExact", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true, miss_cnt_true, g_req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
+/* pinned on the synthetic trace */
+static void test_TinyLFU(gconstpointer user_data) {
+  uint64_t req_cnt_true = SYNTHETIC_N_REQ, req_byte_true = SYNTHETIC_N_REQ_BYTE;
+  uint64_t miss_cnt_true[] = {132637, 109467, 93880, 82954, 75239, 70135, 67538, 67182};
+  uint64_t miss_byte_true[] = {4410582016, 3646055424, 3127008256, 2760158208, 2504186880, 2335330304, 2249016320, 2237520896};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("TinyLFU", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, req_cnt_true, miss_cnt_true, req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
 static void empty_test(gconstpointer user_data) { ; }
 
 int main(int argc, char *argv[]) {
@@ -121,6 +157,10 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func("/libCacheSim/admissionAlgo_Size", reader, test_Size);
   g_test_add_data_func("/libCacheSim/admissionAlgo_SizeProb", reader, test_SizeProb);
   g_test_add_data_func("/libCacheSim/admissionAlgo_BloomFilter", reader, test_BloomFilter);
+  g_test_add_data_func("/libCacheSim/admissionAlgo_BloomFilterExact", reader, test_BloomFilterExact);
+
+  reader = setup_synthetic_reader(false);
+  g_test_add_data_func("/libCacheSim/admissionAlgo_TinyLFU", reader, test_TinyLFU);
 
   return g_test_run();
 }
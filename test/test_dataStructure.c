@@ -2,8 +2,19 @@
 // Created by Juncheng Yang on 11/24/24.
 //
 
+#include "../libCacheSim/dataStructure/blockedBloom.h"
+#include "../libCacheSim/dataStructure/bucketQueue.h"
+#include "../libCacheSim/dataStructure/candidateSelect.h"
+#include "../libCacheSim/dataStructure/countMinSketch.h"
+#include "../libCacheSim/dataStructure/freqList.h"
+#include "../libCacheSim/dataStructure/ghostHistory.h"
 #include "../libCacheSim/dataStructure/hashtable/chainedHashTableV2.h"
+#include "../libCacheSim/dataStructure/hash/hash.h"
 #include "../libCacheSim/dataStructure/hashtable/hashtable.h"
+#include "../libCacheSim/dataStructure/idMap.h"
+#include "../libCacheSim/dataStructure/nextAccessWheel.h"
+#include "../libCacheSim/dataStructure/ringFifo.h"
+#include "../libCacheSim/dataStructure/ttlWheel.h"
 #include "common.h"
 
 void test_chained_hashtable_v2(gconstpointer user_data) {
@@ -29,12 +40,496 @@ void test_chained_hashtable_v2(gconstpointer user_data) {
   // printf("random object %lu\n", obj->obj_id);
 }
 
+void test_next_access_wheel(gconstpointer user_data) {
+  /* unique keys spread beyond the initial number of buckets */
+  const int n_obj = 20000;
+  cache_obj_t *objs = calloc(n_obj, sizeof(cache_obj_t));
+  next_access_wheel_t *wheel = next_access_wheel_init(3);
+  for (int i = 0; i < n_obj; i++) {
+    objs[i].obj_id = i;
+    objs[i].Belady.next_access_vtime = (i % 7 == 0) ? INT64_MAX : (int64_t)i * 97 + 1;
+    next_access_wheel_insert(wheel, &objs[i]);
+  }
+  g_assert_cmpint(wheel->n_obj, ==, n_obj);
+
+  /* objects that are not requested again come first */
+  for (int i = 0; i < n_obj; i += 7) {
+    cache_obj_t *obj = next_access_wheel_peek_max(wheel);
+    g_assert_true(obj->Belady.next_access_vtime == INT64_MAX);
+    next_access_wheel_remove(wheel, obj);
+  }
+
+  /* then in the order of decreasing next access vtime */
+  int64_t last_vtime = INT64_MAX;
+  while (wheel->n_obj > 0) {
+    cache_obj_t *obj = next_access_wheel_peek_max(wheel);
+    g_assert_true(obj->Belady.next_access_vtime < last_vtime);
+    last_vtime = obj->Belady.next_access_vtime;
+    next_access_wheel_remove(wheel, obj);
+  }
+  g_assert_true(last_vtime == 1 * 97 + 1);
+  g_assert_true(next_access_wheel_peek_max(wheel) == NULL);
+
+  next_access_wheel_free(wheel);
+  free(objs);
+}
+
+void test_ring_fifo(gconstpointer user_data) {
+  /* more than the initial ring so that the rings are rebuilt */
+  const int n_obj = 5000;
+  cache_obj_t *objs = calloc(n_obj, sizeof(cache_obj_t));
+  ring_fifo_t *rf = ring_fifo_init(2);
+  for (int i = 0; i < n_obj; i++) {
+    objs[i].obj_id = i;
+    objs[i].obj_size = 1 + i % 3;
+    ring_fifo_push(rf, 0, &objs[i]);
+  }
+  /* remove every third object, move every fourth object to the second queue */
+  int64_t n_byte = 0, n_obj_q0 = 0;
+  for (int i = 0; i < n_obj; i++) {
+    if (i % 3 == 0) {
+      ring_fifo_remove(rf, &objs[i]);
+    } else if (i % 4 == 0) {
+      ring_fifo_move_to_tail(rf, &objs[i], 1);
+    } else {
+      n_obj_q0 += 1;
+      n_byte += objs[i].obj_size;
+    }
+  }
+  g_assert_cmpint(ring_fifo_n_obj(rf, 0), ==, n_obj_q0);
+  g_assert_cmpint(ring_fifo_n_byte(rf, 0), ==, n_byte);
+
+  /* both queues pop in insertion order */
+  for (int q = 0; q < 2; q++) {
+    int last_id = -1;
+    cache_obj_t *obj;
+    while ((obj = ring_fifo_oldest(rf, q)) != NULL) {
+      g_assert_cmpint(obj->ring_fifo.queue_id, ==, q);
+      g_assert_cmpint((int)obj->obj_id, >, last_id);
+      g_assert_true((obj->obj_id % 3 != 0) && ((obj->obj_id % 4 == 0) == (q == 1)));
+      last_id = (int)obj->obj_id;
+      ring_fifo_remove(rf, obj);
+    }
+    g_assert_cmpint(ring_fifo_n_obj(rf, q), ==, 0);
+    g_assert_cmpint(ring_fifo_n_byte(rf, q), ==, 0);
+  }
+
+  ring_fifo_free(rf);
+  free(objs);
+}
+
+void test_freq_list(gconstpointer user_data) {
+  /* more nodes than one chunk of the node pool */
+  const int n_obj = 3000;
+  cache_obj_t *objs = calloc(n_obj, sizeof(cache_obj_t));
+  freq_list_t *fl = freq_list_init();
+  for (int i = 0; i < n_obj; i++) {
+    objs[i].obj_id = i;
+    freq_list_add(fl, NULL, &objs[i], 1);
+  }
+  g_assert_cmpint(fl->n_node, ==, 1);
+
+  /* object i is hit i times, every other object jumps to freq 5000 first */
+  for (int i = 0; i < n_obj; i++) {
+    if (i % 2 == 0) freq_list_move(fl, &objs[i], 5000);
+    for (int j = 0; j < i; j++) {
+      freq_list_move(fl, &objs[i], objs[i].lfu.freq + 1);
+    }
+  }
+  g_assert_cmpint(fl->n_node, ==, n_obj);
+
+  /* the nodes are in freq order */
+  int64_t last_freq = 0, n_seen = 0;
+  for (freq_node_t *node = fl->head; node != NULL; node = node->next) {
+    g_assert_cmpint(node->freq, >, last_freq);
+    g_assert_cmpint(node->n_obj, ==, 1);
+    g_assert_true(node->first_obj->lfu.freq_node == node);
+    last_freq = node->freq;
+    n_seen += 1;
+  }
+  g_assert_cmpint(n_seen, ==, n_obj);
+  g_assert_cmpint(freq_list_min(fl)->freq, ==, 2);
+  g_assert_true(freq_list_min(fl)->first_obj == &objs[1]);
+  g_assert_cmpint(fl->tail->freq, ==, 5000 + n_obj - 2);
+
+  /* removing objects releases their nodes */
+  for (int i = 0; i < n_obj; i += 3) {
+    freq_list_remove(fl, &objs[i]);
+  }
+  g_assert_cmpint(fl->n_node, ==, n_obj - (n_obj + 2) / 3);
+  while (freq_list_min(fl) != NULL) {
+    freq_list_remove(fl, freq_list_min(fl)->first_obj);
+  }
+  g_assert_true(fl->tail == NULL);
+
+  freq_list_free(fl);
+  free(objs);
+}
+
+/* the exact bucket queue evicts the same objects as a linear scan for the
+ * best key, the approximate queue evicts from the best size class */
+static int bucket_queue_ref_best(const double *keys, const int64_t *order,
+                                 const bool *in_queue, int n, bool max_first) {
+  int best = -1;
+  for (int i = 0; i < n; i++) {
+    if (!in_queue[i]) continue;
+    if (best == -1 || (max_first ? keys[i] > keys[best] : keys[i] < keys[best]) ||
+        (keys[i] == keys[best] && order[i] < order[best])) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+static bool bucket_queue_check_order(cache_obj_t *obj, void *user_data) {
+  double *last_key = user_data;
+  g_assert_true(obj->bucket_queue.key >= *last_key);
+  *last_key = obj->bucket_queue.key;
+  return true;
+}
+
+void test_bucket_queue(gconstpointer user_data) {
+  const int n_obj = 2000;
+  cache_obj_t *objs = calloc(n_obj, sizeof(cache_obj_t));
+  double *keys = calloc(n_obj, sizeof(double));
+  int64_t *order = calloc(n_obj, sizeof(int64_t));
+  bool *in_queue = calloc(n_obj, sizeof(bool));
+
+  for (int mode = 0; mode < 3; mode++) {
+    bool max_first = mode != 1, exact = mode != 2;
+    bucket_queue_t *bq = bucket_queue_init(max_first, exact);
+    memset(in_queue, 0, sizeof(bool) * n_obj);
+    int64_t n_op = 0, n_in_queue = 0;
+
+    uint64_t rand_state = 42;
+    for (int i = 0; i < n_obj * 10; i++) {
+      rand_state = rand_state * 6364136223846793005ull + 1442695040888963407ull;
+      int id = (int)((rand_state >> 33) % n_obj);
+      /* few distinct keys so that there are ties, and keys below 1 */
+      double key = (double)((rand_state >> 12) % 4096) / 4.0;
+      if (in_queue[id]) {
+        if ((rand_state >> 8) % 4 == 0) {
+          bucket_queue_remove(bq, &objs[id]);
+          in_queue[id] = false;
+          n_in_queue -= 1;
+        } else {
+          bucket_queue_update(bq, &objs[id], key);
+          keys[id] = key;
+          order[id] = n_op++;
+        }
+        continue;
+      }
+
+      if (n_in_queue == n_obj / 2) {
+        int expected = bucket_queue_ref_best(keys, order, in_queue, n_obj, max_first);
+        cache_obj_t *victim = bucket_queue_pop(bq);
+        if (exact) {
+          g_assert_true(victim == &objs[expected]);
+        } else {
+          /* the oldest object of the size class of the best key */
+          g_assert_cmpint(victim->bucket_queue.bucket, ==, objs[expected].bucket_queue.bucket);
+          for (int j = 0; j < n_obj; j++) {
+            if (in_queue[j] && objs[j].bucket_queue.bucket == victim->bucket_queue.bucket) {
+              g_assert_cmpint(order[j], >=, order[victim - objs]);
+            }
+          }
+        }
+        in_queue[victim - objs] = false;
+        n_in_queue -= 1;
+      }
+      bucket_queue_insert(bq, &objs[id], key);
+      keys[id] = key;
+      order[id] = n_op++;
+      in_queue[id] = true;
+      n_in_queue += 1;
+    }
+    g_assert_cmpint(bq->n_obj, ==, n_in_queue);
+
+    if (!max_first) {
+      double last_key = 0;
+      bucket_queue_for_each(bq, bucket_queue_check_order, &last_key);
+    }
+    while (bucket_queue_pop(bq) != NULL) {
+      n_in_queue -= 1;
+    }
+    g_assert_cmpint(n_in_queue, ==, 0);
+    g_assert_cmpint(bq->non_empty, ==, 0);
+    bucket_queue_free(bq);
+  }
+
+  free(objs);
+  free(keys);
+  free(order);
+  free(in_queue);
+}
+
+static const double *candidate_ref_scores;
+
+/* the reference order, NaN last and ties by index */
+static int candidate_ref_cmp(const void *a0, const void *b0) {
+  int32_t a = *(const int32_t *)a0, b = *(const int32_t *)b0;
+  double sa = candidate_ref_scores[a], sb = candidate_ref_scores[b];
+  if (isnan(sa) != isnan(sb)) return isnan(sa) ? 1 : -1;
+  if (!isnan(sa) && sa != sb) return sa < sb ? -1 : 1;
+  return a - b;
+}
+
+void test_candidate_select(gconstpointer user_data) {
+  const int max_n = 300;
+  double *scores = calloc(max_n, sizeof(double));
+  int32_t *idx = calloc(max_n, sizeof(int32_t));
+  int32_t *ref = calloc(max_n, sizeof(int32_t));
+  candidate_ref_scores = scores;
+
+  uint64_t rand_state = 42;
+  for (int round = 0; round < 2000; round++) {
+    rand_state = rand_state * 6364136223846793005ull + 1442695040888963407ull;
+    int n = (int)((rand_state >> 33) % max_n) + 1;
+    /* few distinct values so that there are ties, and some NaN */
+    for (int i = 0; i < n; i++) {
+      rand_state = rand_state * 6364136223846793005ull + 1442695040888963407ull;
+      uint64_t r = rand_state >> 33;
+      scores[i] = r % 97 == 0 ? NAN : (double)(r % 50) - 20;
+    }
+
+    for (int i = 0; i < n; i++) ref[i] = i;
+    qsort(ref, n, sizeof(int32_t), candidate_ref_cmp);
+    int first_nan = n;
+    while (first_nan > 0 && isnan(scores[ref[first_nan - 1]])) first_nan--;
+
+    g_assert_cmpint(candidate_argmin(scores, n), ==, first_nan > 0 ? ref[0] : -1);
+    int expected_max = -1;
+    for (int i = 0; i < n; i++) {
+      if (!isnan(scores[i]) && (expected_max == -1 || scores[i] > scores[expected_max])) expected_max = i;
+    }
+    g_assert_cmpint(candidate_argmax(scores, n), ==, expected_max);
+
+    int k = (int)((rand_state >> 7) % (n + 1));
+    candidate_select(scores, n, k, idx);
+    candidate_sort(scores, idx, k);
+    for (int i = 0; i < k; i++) {
+      g_assert_cmpint(idx[i], ==, ref[i]);
+    }
+    candidate_sort(scores, idx + k, n - k);
+    for (int i = k; i < n; i++) {
+      g_assert_cmpint(idx[i], ==, ref[i]);
+    }
+  }
+
+  g_assert_cmpint(candidate_argmin(scores, 0), ==, -1);
+  free(scores);
+  free(idx);
+  free(ref);
+}
+
+#ifdef SUPPORT_TTL
+void test_ttl_wheel(gconstpointer user_data) {
+  /* exp_times span all levels of the wheel */
+  const int n_obj = 20000;
+  cache_obj_t *objs = calloc(n_obj, sizeof(cache_obj_t));
+  bool *popped = calloc(n_obj, sizeof(bool));
+  ttl_wheel_t *wheel = ttl_wheel_init();
+  for (int i = 0; i < n_obj; i++) {
+    objs[i].obj_id = i;
+    objs[i].exp_time = 1 + (uint32_t)(((uint64_t)i * 2654435761u) % 50000000);
+    ttl_wheel_insert(wheel, &objs[i]);
+  }
+  /* removed objects do not expire, moved objects expire at the new time */
+  for (int i = 0; i < n_obj; i += 5) {
+    ttl_wheel_remove(wheel, &objs[i]);
+    popped[i] = true;
+  }
+  for (int i = 1; i < n_obj; i += 5) {
+    objs[i].exp_time = objs[i].exp_time / 3 + 1;
+    ttl_wheel_insert(wheel, &objs[i]);
+  }
+  g_assert_cmpint(wheel->n_obj, ==, n_obj - n_obj / 5);
+
+  int64_t last_now = 0, now = 0;
+  while (wheel->n_obj > 0) {
+    now += 1 + (now % 7) * 1013 + (now % 3) * 300007;
+    cache_obj_t *obj;
+    while ((obj = ttl_wheel_pop_expired(wheel, now)) != NULL) {
+      g_assert_true(obj->exp_time < now && obj->exp_time >= last_now);
+      g_assert_false(popped[obj->obj_id]);
+      g_assert_false(ttl_wheel_contains(obj));
+      popped[obj->obj_id] = true;
+    }
+    /* everything that expired before now has been popped */
+    for (int i = 0; i < n_obj; i++) {
+      if (!popped[i]) g_assert_true(objs[i].exp_time >= now);
+    }
+    last_now = now;
+  }
+
+  ttl_wheel_free(wheel);
+  free(popped);
+  free(objs);
+}
+#endif
+
+void test_ghost_history(gconstpointer user_data) {
+  /* more than the initial ring so that the history is rebuilt */
+  const int64_t n = 5000;
+  ghost_history_t *history = ghost_history_init(1024);
+
+  for (int64_t i = 0; i < n; i++) {
+    ghost_history_insert(history, i, i + 1, i * 10);
+  }
+  g_assert_cmpint(history->n_entry, ==, n);
+  g_assert_cmpint(history->n_byte, ==, n * (n + 1) / 2);
+
+  /* remove every other object from the middle */
+  int64_t size, data;
+  for (int64_t i = 1; i < n; i += 2) {
+    g_assert_true(ghost_history_remove(history, i, &size, &data));
+    g_assert_cmpint(size, ==, i + 1);
+    g_assert_cmpint(data, ==, i * 10);
+  }
+  g_assert_false(ghost_history_remove(history, 1, NULL, NULL));
+  g_assert_false(ghost_history_contains(history, n + 1));
+  g_assert_true(ghost_history_contains(history, 2));
+
+  /* reinserting an object moves it to the newest position */
+  ghost_history_insert(history, 0, 1, -1);
+  g_assert_cmpint(history->n_entry, ==, n / 2);
+
+  for (int64_t i = 2; i < n; i += 2) {
+    g_assert_true(ghost_history_pop_oldest(history, &size, &data));
+    g_assert_cmpint(data, ==, i * 10);
+  }
+  g_assert_true(ghost_history_pop_oldest(history, &size, &data));
+  g_assert_cmpint(data, ==, -1);
+  g_assert_false(ghost_history_pop_oldest(history, NULL, NULL));
+  g_assert_cmpint(history->n_byte, ==, 0);
+
+  ghost_history_free(history);
+}
+
+void test_count_min_sketch(gconstpointer user_data) {
+  count_min_sketch_t *sketch = count_min_sketch_init(1024, false);
+
+  for (int i = 0; i < 10; i++) count_min_sketch_increment(sketch, 42);
+  for (int i = 0; i < 40; i++) count_min_sketch_increment(sketch, 7);
+  /* counters never underestimate and saturate at 15 */
+  g_assert_cmpint(count_min_sketch_estimate(sketch, 42), >=, 10);
+  g_assert_cmpint(count_min_sketch_estimate(sketch, 7), ==, CMS_MAX_COUNT);
+
+  int n_nonzero = 0;
+  for (obj_id_t id = 1000; id < 2000; id++) n_nonzero += count_min_sketch_estimate(sketch, id) > 0;
+  g_assert_cmpint(n_nonzero, <, 10);
+
+  count_min_sketch_age(sketch);
+  g_assert_cmpint(count_min_sketch_estimate(sketch, 7), ==, CMS_MAX_COUNT / 2);
+
+  /* the sketch ages by itself after 10 increments per word */
+  int64_t n_aging = sketch->n_aging;
+  for (obj_id_t id = 0; id < (obj_id_t)sketch->n_word * 20; id++) count_min_sketch_increment(sketch, id);
+  g_assert_cmpint(sketch->n_aging, >, n_aging);
+  count_min_sketch_free(sketch);
+
+  /* the first occurrence only sets the doorkeeper */
+  sketch = count_min_sketch_init(1024, true);
+  count_min_sketch_increment(sketch, 42);
+  g_assert_cmpint(count_min_sketch_estimate(sketch, 42), ==, 1);
+  count_min_sketch_increment(sketch, 42);
+  g_assert_cmpint(count_min_sketch_estimate(sketch, 42), >=, 2);
+  count_min_sketch_age(sketch);
+  g_assert_cmpint(count_min_sketch_estimate(sketch, 42), ==, 0);
+  count_min_sketch_free(sketch);
+}
+
+void test_blocked_bloom(gconstpointer user_data) {
+  const int64_t n_key = 100000;
+  blocked_bloom_t *bloom = blocked_bloom_init(n_key, 0.01);
+  g_assert_cmpfloat(blocked_bloom_expected_fpr(bloom->n_block, n_key), <=, 0.01);
+
+  for (obj_id_t id = 0; id < (obj_id_t)n_key; id++) {
+    blocked_bloom_insert(bloom, get_hash_value_int_64(&id));
+  }
+  g_assert_cmpint(bloom->n_insert, <=, n_key);
+  g_assert_cmpint(bloom->n_insert, >, n_key * 98 / 100);
+
+  /* no false negatives */
+  for (obj_id_t id = 0; id < (obj_id_t)n_key; id++) {
+    g_assert_true(blocked_bloom_contains(bloom, get_hash_value_int_64(&id)));
+    g_assert_false(blocked_bloom_insert(bloom, get_hash_value_int_64(&id)));
+  }
+
+  int64_t n_false_positive = 0;
+  for (obj_id_t id = n_key; id < (obj_id_t)n_key * 11; id++) {
+    n_false_positive += blocked_bloom_contains(bloom, get_hash_value_int_64(&id));
+  }
+  g_assert_cmpint(n_false_positive, <, n_key * 10 / 100 * 2);
+
+  /* the vector and the scalar paths set the same bits */
+  blocked_bloom_t *scalar_bloom = blocked_bloom_init(n_key, 0.01);
+  scalar_bloom->use_avx2 = false;
+  for (obj_id_t id = 0; id < (obj_id_t)n_key; id++) {
+    blocked_bloom_insert(scalar_bloom, get_hash_value_int_64(&id));
+  }
+  g_assert_cmpint(memcmp(bloom->lanes, scalar_bloom->lanes, blocked_bloom_n_byte(bloom)), ==, 0);
+  blocked_bloom_free(scalar_bloom);
+
+  blocked_bloom_clear(bloom);
+  obj_id_t id = 0;
+  g_assert_false(blocked_bloom_contains(bloom, get_hash_value_int_64(&id)));
+  blocked_bloom_free(bloom);
+}
+
+void test_id_map(gconstpointer user_data) {
+  id_map_t *map = id_map_init(4);
+  const uint64_t n = 100000;
+
+  /* sequential ids as in block traces, the map grows from 16 slots */
+  for (uint64_t id = 1; id <= n; id++) id_map_put(map, id, (int64_t)id * 2);
+  id_map_put(map, ID_MAP_EMPTY_KEY, -1);
+  g_assert_cmpint(id_map_n_entry(map), ==, n + 1);
+  g_assert_cmpint(id_map_get(map, ID_MAP_EMPTY_KEY, 0), ==, -1);
+
+  /* remove every other id, the remaining ones must still be found after the
+   * following entries are shifted back */
+  for (uint64_t id = 1; id <= n; id += 2) g_assert_true(id_map_remove(map, id));
+  g_assert_false(id_map_remove(map, 1));
+  for (uint64_t id = 1; id <= n; id++) {
+    if (id % 2 == 1) {
+      g_assert_false(id_map_contains(map, id));
+    } else {
+      g_assert_cmpint(id_map_get(map, id, 0), ==, (int64_t)id * 2);
+    }
+  }
+  g_assert_cmpint(id_map_n_entry(map), ==, n / 2 + 1);
+
+  id_map_put(map, 2, 7);
+  *id_map_find(map, 4) += 1;
+  g_assert_cmpint(id_map_get(map, 2, 0), ==, 7);
+  g_assert_cmpint(id_map_get(map, 4, 0), ==, 9);
+
+  id_map_clear(map);
+  g_assert_cmpint(id_map_n_entry(map), ==, 0);
+  g_assert_false(id_map_contains(map, 2));
+  g_assert_false(id_map_contains(map, ID_MAP_EMPTY_KEY));
+  id_map_free(map);
+}
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   reader_t *reader;
 
   reader = setup_plaintxt_reader_num();
   g_test_add_data_func("/libCacheSim/test_chained_hashtable_v2", NULL, test_chained_hashtable_v2);
+  g_test_add_data_func("/libCacheSim/test_next_access_wheel", NULL, test_next_access_wheel);
+  g_test_add_data_func("/libCacheSim/test_ring_fifo", NULL, test_ring_fifo);
+  g_test_add_data_func("/libCacheSim/test_freq_list", NULL, test_freq_list);
+  g_test_add_data_func("/libCacheSim/test_bucket_queue", NULL, test_bucket_queue);
+  g_test_add_data_func("/libCacheSim/test_candidate_select", NULL, test_candidate_select);
+#ifdef SUPPORT_TTL
+  g_test_add_data_func("/libCacheSim/test_ttl_wheel", NULL, test_ttl_wheel);
+#endif
+  g_test_add_data_func("/libCacheSim/test_ghost_history", NULL, test_ghost_history);
+  g_test_add_data_func("/libCacheSim/test_count_min_sketch", NULL, test_count_min_sketch);
+  g_test_add_data_func("/libCacheSim/test_blocked_bloom", NULL, test_blocked_bloom);
+  g_test_add_data_func("/libCacheSim/test_id_map", NULL, test_id_map);
 
   return g_test_run();
 }
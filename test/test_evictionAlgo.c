@@ -152,6 +152,30 @@ static void test_BeladySize(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+/* the time wheel engine must make the same decisions as the priority queue */
+static void test_Belady_engine(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache_pq = create_test_cache("Belady", cc_params, reader, "engine=pq");
+  cache_t *cache_wheel = create_test_cache("Belady", cc_params, reader, "engine=wheel");
+  g_assert_true(cache_pq != NULL && cache_wheel != NULL);
+  cache_stat_t *res_pq =
+      simulate_at_multi_sizes_with_step_size(reader, cache_pq, STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+  cache_stat_t *res_wheel =
+      simulate_at_multi_sizes_with_step_size(reader, cache_wheel, STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+  print_results(cache_pq, res_pq);
+  for (uint64_t i = 0; i < CACHE_SIZE / STEP_SIZE; i++) {
+    g_assert_cmpuint(res_pq[i].n_req, ==, res_wheel[i].n_req);
+    g_assert_cmpuint(res_pq[i].n_miss, ==, res_wheel[i].n_miss);
+    g_assert_cmpuint(res_pq[i].n_miss_byte, ==, res_wheel[i].n_miss_byte);
+  }
+  cache_pq->cache_free(cache_pq);
+  cache_wheel->cache_free(cache_wheel);
+  my_free(sizeof(cache_stat_t), res_pq);
+  my_free(sizeof(cache_stat_t), res_wheel);
+}
+
 static void test_Random(gconstpointer user_data) {
   uint64_t miss_cnt_true[] = {92457, 88582, 84459, 80277, 76132, 72134, 68230, 64225};
   uint64_t miss_byte_true[] = {4170166272, 3975292416, 3757524992, 3539850752,
@@ -220,6 +244,24 @@ static void test_GDSF(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+static void test_GDSF_set(gconstpointer user_data) {
+  /* the set and the heap rank objects in the same order */
+  uint64_t miss_cnt_true[] = {89070, 84750, 74850, 70490, 67923, 64180, 61027, 58721};
+  uint64_t miss_byte_true[] = {4210726912, 4057058816, 3719176192, 3436855296,
+                               3271648256, 3029728768, 2828456448, 2677800448};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("GDSF-set", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+  print_results(cache, res);
+  _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true, miss_cnt_true, g_req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
 static void test_LHD(gconstpointer user_data) {
   uint64_t miss_cnt_true[] = {90534, 86891, 82334, 77339, 71355, 66938, 63677, 61116};
   uint64_t miss_byte_true[] = {4211037696, 4059153920, 3834546176, 3596945408,
@@ -474,8 +516,45 @@ static void test_Sieve(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+/* pinned on the synthetic trace with cache sizes in objects, the CBF is sized
+ * by the cache size and cannot be used with byte-sized caches */
+#define SYNTHETIC_CACHE_SIZE 8000
+#define SYNTHETIC_STEP_SIZE 1000
+
 static void test_WTinyLFU(gconstpointer user_data) {
-  // TODO: to be implemented
+  uint64_t req_cnt_true = SYNTHETIC_N_REQ, req_byte_true = SYNTHETIC_N_REQ;
+  uint64_t miss_cnt_true[] = {149806, 136797, 127238, 120784, 113822, 108628, 103801, 99393};
+  uint64_t miss_byte_true[] = {149806, 136797, 127238, 120784, 113822, 108628, 103801, 99393};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = SYNTHETIC_CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("WTinyLFU", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, SYNTHETIC_STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+  print_results(cache, res);
+  _verify_profiler_results(res, SYNTHETIC_CACHE_SIZE / SYNTHETIC_STEP_SIZE, req_cnt_true, miss_cnt_true, req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
+}
+
+static void test_WTinyLFU_CBF(gconstpointer user_data) {
+  uint64_t req_cnt_true = SYNTHETIC_N_REQ, req_byte_true = SYNTHETIC_N_REQ;
+  uint64_t miss_cnt_true[] = {151828, 139293, 128835, 121806, 115210, 109300, 104847, 100046};
+  uint64_t miss_byte_true[] = {151828, 139293, 128835, 121806, 115210, 109300, 104847, 100046};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = SYNTHETIC_CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("WTinyLFU-CBF", cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, SYNTHETIC_STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+  print_results(cache, res);
+  _verify_profiler_results(res, SYNTHETIC_CACHE_SIZE / SYNTHETIC_STEP_SIZE, req_cnt_true, miss_cnt_true, req_byte_true, miss_byte_true);
+  cache->cache_free(cache);
+  my_free(sizeof(cache_stat_t), res);
 }
 
 static void test_LIRS(gconstpointer user_data) {
@@ -497,6 +576,196 @@ static void test_LIRS(gconstpointer user_data) {
 
 static void empty_test(gconstpointer user_data) { ; }
 
+static gpointer concurrent_cache_worker(gpointer data) {
+  concurrent_cache_t *cache = data;
+  for (uint64_t i = 0; i < 200000; i++) {
+    cache->get(cache, (i * 7919) % 5000);
+  }
+  return NULL;
+}
+
+static void test_concurrent_cache(void) {
+  const char *algos[] = {"lru", "clock", "sieve", "s3fifo"};
+  for (int i = 0; i < 4; i++) {
+    concurrent_cache_t *cache = create_concurrent_cache(algos[i], 1000);
+    for (uint64_t key = 0; key < 1000; key++) {
+      g_assert_false(cache->get(cache, key));
+    }
+    g_assert_cmpint(cache->get_n_obj(cache), ==, 1000);
+    for (uint64_t key = 0; key < 1000; key++) {
+      g_assert_true(cache->get(cache, key));
+    }
+    for (uint64_t key = 1000; key < 3000; key++) {
+      g_assert_false(cache->get(cache, key));
+    }
+    g_assert_cmpint(cache->get_n_obj(cache), ==, 1000);
+
+    GThread *threads[4];
+    for (int t = 0; t < 4; t++) {
+      threads[t] = g_thread_new("concurrent_cache", concurrent_cache_worker, cache);
+    }
+    for (int t = 0; t < 4; t++) {
+      g_thread_join(threads[t]);
+    }
+    g_assert_cmpint(cache->get_n_obj(cache), ==, 1000);
+    cache->cache_free(cache);
+  }
+  g_assert_null(create_concurrent_cache("ARC", 1000));
+}
+
+/* on one thread, a concurrent cache evicts like the sequential algorithm with
+ * a cache of the same number of objects */
+static void test_concurrent_cache_miss_ratio(gconstpointer user_data) {
+  const int64_t cache_n_obj = 2000;
+  struct {
+    const char *concurrent_algo;
+    cache_init_func_ptr init;
+    const char *params;
+  } algos[] = {{"lru", LRU_init, NULL},
+               {"clock", Clock_init, NULL},
+               {"sieve", Sieve_init, NULL},
+               {"s3fifo", S3FIFO_init, "small-size-ratio=0.1,ghost-size-ratio=0.9,move-to-main-threshold=2"}};
+  common_cache_params_t cc_params = {.cache_size = cache_n_obj, .hashpower = 16};
+
+  for (int i = 0; i < (int)(sizeof(algos) / sizeof(algos[0])); i++) {
+    reader_t *reader = clone_reader((reader_t *)user_data);
+    concurrent_cache_t *concurrent_cache = create_concurrent_cache(algos[i].concurrent_algo, cache_n_obj);
+    cache_t *cache = algos[i].init(cc_params, algos[i].params);
+    request_t *req = new_request();
+    int64_t n_miss = 0, n_concurrent_miss = 0;
+    while (read_one_req(reader, req) == 0) {
+      req->obj_size = 1;
+      if (!cache->get(cache, req)) n_miss += 1;
+      if (!concurrent_cache->get(concurrent_cache, req->obj_id)) n_concurrent_miss += 1;
+    }
+    printf("%s: sequential miss %ld, concurrent miss %ld\n", concurrent_cache->cache_name, (long)n_miss,
+           (long)n_concurrent_miss);
+    g_assert_cmpint(n_miss, >, 0);
+    g_assert_cmpint(n_concurrent_miss, ==, n_miss);
+
+    free_request(req);
+    cache->cache_free(cache);
+    concurrent_cache->cache_free(concurrent_cache);
+    close_reader(reader);
+  }
+}
+
+static int64_t replay_n_req(cache_t *cache, reader_t *reader, int64_t n_req) {
+  request_t *req = new_request();
+  int64_t n_miss = 0;
+  for (int64_t i = 0; (n_req < 0 || i < n_req) && read_one_req(reader, req) == 0; i++) {
+    if (!cache->get(cache, req)) n_miss++;
+  }
+  free_request(req);
+  return n_miss;
+}
+
+static void test_cache_checkpoint(gconstpointer user_data) {
+  const char *cache_ckpt = "test_cache.ckpt", *reader_ckpt = "test_reader.ckpt";
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  struct {
+    cache_init_func_ptr init;
+    const char *params;
+  } algos[] = {{LRU_init, NULL},    {FIFO_init, NULL}, {Clock_init, "n-bit-counter=2"}, {Sieve_init, NULL},
+               {S3FIFO_init, NULL}, {ARC_init, NULL},  {LFU_init, NULL}};
+
+  for (int i = 0; i < (int)(sizeof(algos) / sizeof(algos[0])); i++) {
+    reader_t *reader = clone_reader((reader_t *)user_data);
+    int64_t n_warmup_req = get_num_of_req(reader) / 2;
+    cache_t *cache = algos[i].init(cc_params, algos[i].params);
+    replay_n_req(cache, reader, n_warmup_req);
+    g_assert_true(cache_checkpoint(cache, cache_ckpt));
+    g_assert_true(reader_checkpoint(reader, reader_ckpt));
+    int64_t n_miss = replay_n_req(cache, reader, -1);
+
+    /* the restored cache continues exactly where the checkpoint was taken */
+    reader_t *restored_reader = clone_reader((reader_t *)user_data);
+    cache_t *restored_cache = cache_restore(cache_ckpt);
+    g_assert_nonnull(restored_cache);
+    g_assert_true(reader_restore(restored_reader, reader_ckpt));
+    g_assert_cmpstr(restored_cache->cache_name, ==, cache->cache_name);
+    g_assert_cmpint(replay_n_req(restored_cache, restored_reader, -1), ==, n_miss);
+    g_assert_cmpint(restored_cache->n_req, ==, cache->n_req);
+    g_assert_cmpint(restored_cache->get_n_obj(restored_cache), ==, cache->get_n_obj(cache));
+    g_assert_cmpint(restored_cache->get_occupied_byte(restored_cache), ==, cache->get_occupied_byte(cache));
+
+    cache->cache_free(cache);
+    restored_cache->cache_free(restored_cache);
+    close_reader(reader);
+    close_reader(restored_reader);
+  }
+
+  /* a deep clone can drop or add the ghost of S3FIFO */
+  const char *ghost_params[] = {"ghost-size-ratio=0.9", "ghost-size-ratio=0"};
+  for (int i = 0; i < 2; i++) {
+    reader_t *reader = clone_reader((reader_t *)user_data);
+    cache_t *cache = S3FIFO_init(cc_params, ghost_params[i]);
+    replay_n_req(cache, reader, get_num_of_req(reader) / 2);
+    cache_t *cloned_cache = deep_clone_cache(cache, ghost_params[1 - i]);
+    g_assert_nonnull(cloned_cache);
+    g_assert_cmpint(cloned_cache->get_n_obj(cloned_cache), ==, cache->get_n_obj(cache));
+    g_assert_cmpint(replay_n_req(cloned_cache, reader, -1), >, 0);
+    cache->cache_free(cache);
+    cloned_cache->cache_free(cloned_cache);
+    close_reader(reader);
+  }
+
+  cache_t *cache = LIRS_init(cc_params, NULL);
+  g_assert_false(cache_support_checkpoint(cache));
+  g_assert_false(cache_checkpoint(cache, cache_ckpt));
+  cache->cache_free(cache);
+  g_assert_null(cache_restore(reader_ckpt));
+
+  remove(cache_ckpt);
+  remove(reader_ckpt);
+}
+
+#ifdef SUPPORT_TTL
+/* the expired objects are removed from their segments, so the segments have
+ * room for the objects inserted later and a working set of the cache size
+ * stays in the cache */
+static void test_segmented_cache_expire(void) {
+  const int n_obj = 100, obj_size = 100;
+  common_cache_params_t cc_params = {.cache_size = n_obj * obj_size, .hashpower = 12};
+  struct {
+    cache_init_func_ptr init;
+    const char *params;
+  } algos[] = {{SFIFO_init, "n-seg=4"}, {SLRU_init, "n-seg=4"}};
+
+  for (int i = 0; i < (int)(sizeof(algos) / sizeof(algos[0])); i++) {
+    cache_t *cache = algos[i].init(cc_params, algos[i].params);
+    request_t *req = new_request();
+    req->obj_size = obj_size;
+
+    /* the objects are accessed several times to fill every segment */
+    req->clock_time = 0;
+    req->ttl = 10;
+    for (int round = 0; round < 3; round++) {
+      for (int id = 0; id < n_obj; id++) {
+        req->obj_id = id;
+        cache->get(cache, req);
+      }
+    }
+    g_assert_cmpint(cache->get_n_obj(cache), ==, n_obj);
+
+    req->clock_time = 100;
+    req->ttl = 0;
+    for (int round = 0; round < 3; round++) {
+      for (int id = n_obj; id < 2 * n_obj; id++) {
+        req->obj_id = id;
+        g_assert_true(cache->get(cache, req) == (round > 0));
+      }
+    }
+    g_assert_cmpint(cache->n_expired_obj, ==, n_obj);
+    g_assert_cmpint(cache->get_n_obj(cache), ==, n_obj);
+    g_assert_cmpint(cache->get_occupied_byte(cache), ==, n_obj * obj_size);
+
+    free_request(req);
+    cache->cache_free(cache);
+  }
+}
+#endif
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   srand(0);  // for reproducibility
@@ -537,7 +806,20 @@ int main(int argc, char *argv[]) {
 
   g_test_add_data_func("/libCacheSim/cacheAlgo_LFUCpp", reader, test_LFUCpp);
   g_test_add_data_func("/libCacheSim/cacheAlgo_GDSF", reader, test_GDSF);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_GDSF_set", reader, test_GDSF_set);
   g_test_add_data_func("/libCacheSim/cacheAlgo_LHD", reader, test_LHD);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_Belady_engine", reader, test_Belady_engine);
+
+  g_test_add_func("/libCacheSim/cacheAlgo_concurrent", test_concurrent_cache);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_concurrent_miss_ratio", reader, test_concurrent_cache_miss_ratio);
+  g_test_add_data_func("/libCacheSim/cache_checkpoint", reader, test_cache_checkpoint);
+#ifdef SUPPORT_TTL
+  g_test_add_func("/libCacheSim/cacheAlgo_segmented_expire", test_segmented_cache_expire);
+#endif
+
+  reader = setup_synthetic_reader(true);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_WTinyLFU", reader, test_WTinyLFU);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_WTinyLFU_CBF", reader, test_WTinyLFU_CBF);
 
   // /* Belady requires reader that has next access information and can only use
   //  * oracleGeneral trace */
@@ -114,6 +114,61 @@ static void test_GLCache_LEARNED_ONLINE(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+/* the LearnedOnline miss count at 2 GiB with synchronous training */
+#define GLCache_LEARNED_ONLINE_2GiB_MISS 1375970
+
+typedef struct {
+  uint64_t n_req;
+  uint64_t n_miss;
+  int64_t n_installed_model;
+} GLCache_run_t;
+
+static GLCache_run_t run_GLCache(reader_t *reader, const char *alg_name) {
+  common_cache_params_t cc_params = {.cache_size = 2 * GiB, .hashpower = 24, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache(alg_name, cc_params, reader, NULL);
+  g_assert_true(cache != NULL);
+  request_t *req = new_request();
+  GLCache_run_t run = {0};
+
+  reset_reader(reader);
+  while (read_one_req(reader, req) == 0) {
+    run.n_req += 1;
+    if (!cache->get(cache, req)) {
+      run.n_miss += 1;
+    }
+  }
+  run.n_installed_model = GLCache_get_n_installed_model(cache);
+  printf("%s: req %" PRIu64 " miss %" PRIu64 " models %" PRId64 "\n", cache->cache_name, run.n_req, run.n_miss,
+         run.n_installed_model);
+
+  free_request(req);
+  cache->cache_free(cache);
+  return run;
+}
+
+/* the deterministic mode does not depend on the training speed */
+static void test_GLCache_LEARNED_ONLINE_DETERMINISTIC(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  GLCache_run_t run1 = run_GLCache(reader, "GLCache-LearnedOnlineDeterministic");
+  GLCache_run_t run2 = run_GLCache(reader, "GLCache-LearnedOnlineDeterministic");
+
+  g_assert_cmpint(run1.n_installed_model, >, 0);
+  g_assert_cmpint(run1.n_installed_model, ==, run2.n_installed_model);
+  g_assert_cmpuint(run1.n_miss, ==, run2.n_miss);
+  g_assert_cmpfloat(fabs((double)run1.n_miss - GLCache_LEARNED_ONLINE_2GiB_MISS) / GLCache_LEARNED_ONLINE_2GiB_MISS,
+                    <, 0.05);
+}
+
+/* the models trained on the background thread are installed and used */
+static void test_GLCache_LEARNED_ONLINE_ASYNC(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  GLCache_run_t run = run_GLCache(reader, "GLCache-LearnedOnlineAsync");
+
+  g_assert_cmpint(run.n_installed_model, >, 0);
+  g_assert_cmpfloat(fabs((double)run.n_miss - GLCache_LEARNED_ONLINE_2GiB_MISS) / GLCache_LEARNED_ONLINE_2GiB_MISS,
+                    <, 0.05);
+}
+
 static void empty_test(gconstpointer user_data) { ; }
 
 int main(int argc, char *argv[]) {
@@ -128,6 +183,10 @@ int main(int argc, char *argv[]) {
   g_test_add_data_func("/libCacheSim/cacheAlgo_GLCache_ORACLE_LOG", reader, test_GLCache_ORACLE_LOG);
   g_test_add_data_func("/libCacheSim/cacheAlgo_GLCache_ORACLE_ITEM", reader, test_GLCache_ORACLE_ITEM);
   g_test_add_data_func("/libCacheSim/cacheAlgo_GLCache_ORACLE_BOTH", reader, test_GLCache_ORACLE_BOTH);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_GLCache_LEARNED_ONLINE_DETERMINISTIC", reader,
+                       test_GLCache_LEARNED_ONLINE_DETERMINISTIC);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_GLCache_LEARNED_ONLINE_ASYNC", reader,
+                       test_GLCache_LEARNED_ONLINE_ASYNC);
 
   g_test_add_data_func_full("/libCacheSim/empty", reader, empty_test, test_teardown);
 #endif /* ENABLE_GLCACHE */
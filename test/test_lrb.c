@@ -0,0 +1,94 @@
+//
+// the training modes of LRB, the model trained on a worker thread must be
+// installed and used, and the synchronous training must not change
+//
+
+#include "common.h"
+
+#define LRB_CACHE_SIZE (32 * MiB)
+#define LRB_N_PASS 4
+/* the number of batches in LRB_N_PASS passes */
+#define LRB_N_SYNC_MODEL 5
+
+typedef struct {
+  uint64_t n_req;
+  uint64_t n_miss;
+  uint64_t n_miss_byte;
+  int64_t n_installed_model;
+} lrb_run_t;
+
+static lrb_run_t run_lrb(reader_t *reader, const char *params) {
+  common_cache_params_t cc_params = {.cache_size = LRB_CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = create_test_cache("LRB", cc_params, reader, params);
+  request_t *req = new_request();
+  lrb_run_t run = {0};
+
+  /* the trace is replayed so that several batches are trained */
+  for (int i = 0; i < LRB_N_PASS; i++) {
+    reset_reader(reader);
+    while (read_one_req(reader, req) == 0) {
+      run.n_req += 1;
+      if (!cache->get(cache, req)) {
+        run.n_miss += 1;
+        run.n_miss_byte += req->obj_size;
+      }
+    }
+  }
+  run.n_installed_model = LRB_get_n_installed_model(cache);
+  printf("%s: req %" PRIu64 " miss %" PRIu64 " miss_byte %" PRIu64 " models %" PRId64 "\n", cache->cache_name,
+         run.n_req, run.n_miss, run.n_miss_byte, run.n_installed_model);
+
+  free_request(req);
+  cache->cache_free(cache);
+  return run;
+}
+
+/* the results before the training modes were added */
+static void test_LRB_sync(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  lrb_run_t run = run_lrb(reader, "training=sync");
+
+  g_assert_cmpuint(run.n_req, ==, SYNTHETIC_N_REQ * LRB_N_PASS);
+  g_assert_cmpuint(run.n_miss, ==, 595107);
+  g_assert_cmpuint(run.n_miss_byte, ==, 19793651712ULL);
+  g_assert_cmpint(run.n_installed_model, ==, LRB_N_SYNC_MODEL);
+}
+
+/* the deterministic mode does not depend on the training speed, and the
+ * results change with the swap delay only if the installed models are used */
+static void test_LRB_deterministic(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  lrb_run_t run1 = run_lrb(reader, "training=deterministic,swap-delay=1000");
+  lrb_run_t run2 = run_lrb(reader, "training=deterministic,swap-delay=1000");
+  lrb_run_t run3 = run_lrb(reader, "training=deterministic,swap-delay=100000000");
+
+  g_assert_cmpint(run1.n_installed_model, >, 1);
+  g_assert_cmpint(run1.n_installed_model, ==, run2.n_installed_model);
+  g_assert_cmpuint(run1.n_miss, ==, run2.n_miss);
+  g_assert_cmpuint(run1.n_miss_byte, ==, run2.n_miss_byte);
+  /* a model is only swapped in when the next batch is full */
+  g_assert_cmpint(run3.n_installed_model, ==, run1.n_installed_model - 1);
+  g_assert_cmpuint(run3.n_miss, !=, run1.n_miss);
+}
+
+/* the models trained on the worker thread are installed, the last one may
+ * still be training when the trace ends */
+static void test_LRB_async(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  lrb_run_t run = run_lrb(reader, "training=async");
+
+  g_assert_cmpint(run.n_installed_model, >=, LRB_N_SYNC_MODEL - 1);
+  g_assert_cmpfloat(fabs((double)run.n_miss - 595107) / 595107, <, 0.05);
+}
+
+int main(int argc, char *argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  srand(0);  // for reproducibility
+  reader_t *reader = setup_synthetic_reader(false);
+
+  g_test_add_data_func("/libCacheSim/LRB_sync", reader, test_LRB_sync);
+  g_test_add_data_func("/libCacheSim/LRB_deterministic", reader, test_LRB_deterministic);
+  g_test_add_data_func_full("/libCacheSim/LRB_async", reader, test_LRB_async, test_teardown);
+
+  return g_test_run();
+}
@@ -204,6 +204,51 @@ static void test_minisim_profiler_with_fixed_sample_rate(gconstpointer user_data
   close_reader(reader);
 }
 
+/**
+ * this one for testing with the minisim profiler with adaptive sample rate
+ * @param user_data
+ */
+static void test_minisim_profiler_with_auto_sample_rate(gconstpointer user_data) {
+  reader_t * reader = setup_vscsi_reader();
+  mrcProfiler::mrc_profiler_params_t params;
+  mrcProfiler::mrc_profiler_e mrc_profiler_type = mrcProfiler::MINISIM_PROFILER;
+
+  params.cache_algorithm_str = "FIFO";
+  params.minisim_params.parse_params("AUTO_RATE,0.02,4,0.01,4");
+  g_assert_true(params.minisim_params.enable_auto_rate);
+  uint64_t step_size = 202976972;
+  int test_steps = 10;
+  for(int i = 0; i < test_steps; i++){
+    params.profile_size.push_back(step_size * (i + 1));
+  }
+
+  mrcProfiler::MRCProfilerBase * profiler = create_mrc_profiler(mrc_profiler_type, reader, "", params);
+  g_assert_true(profiler != NULL);
+  profiler->run();
+
+  std::vector<int64_t> hit_cnt_vec = profiler->get_hit_cnt_vec();
+  std::vector<int64_t> hit_size_vec = profiler->get_hit_size_vec();
+
+  g_assert_cmpuint(profiler->get_n_req(), ==, 113872);
+  g_assert_cmpuint(profiler->get_sum_obj_size_req(), ==, 4205978112);
+  g_assert_cmpuint(hit_cnt_vec.size(), ==, test_steps);
+
+  const mrcProfiler::minisim_auto_rate_stat_t &stat =
+      static_cast<mrcProfiler::MRCProfilerMINISIM *>(profiler)->get_auto_rate_stat();
+  g_assert_cmpuint(stat.sample_rate.size(), ==, test_steps);
+  for(int i = 0; i < test_steps; i++){
+    g_assert_true(stat.converged[i]);
+    g_assert_cmpfloat(stat.ci_half_width[i], <=, 0.02);
+    g_assert_cmpfloat(stat.sample_rate[i], >=, 0.01 - 1e-6);
+    g_assert_cmpint(hit_cnt_vec[i], >=, 0);
+    g_assert_cmpint(hit_cnt_vec[i], <=, 113872);
+    g_assert_cmpint(hit_size_vec[i], <=, 4205978112);
+  }
+
+  delete profiler;
+
+  close_reader(reader);
+}
 
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
@@ -215,6 +260,8 @@ int main(int argc, char *argv[]) {
 
   g_test_add_data_func("/libCacheSim/test_minisim_profiler_with_fixed_sample_rate", NULL, test_minisim_profiler_with_fixed_sample_rate);
 
+  g_test_add_data_func("/libCacheSim/test_minisim_profiler_with_auto_sample_rate", NULL, test_minisim_profiler_with_auto_sample_rate);
+
 
   return g_test_run();
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 //
 #include "../libCacheSim/utils/include/mymath.h"
 #include "common.h"
+/* after common.h, Mithril.h declares the enumerator miss */
+#include "../libCacheSim/include/libCacheSim/prefetchAlgo/Mithril.h"
 
 static const uint64_t g_req_cnt_true = 113872, g_req_byte_true = 4368040448;
 
@@ -57,6 +59,71 @@ static void test_Mithril(gconstpointer user_data) {
   my_free(sizeof(cache_stat_t), res);
 }
 
+/* every mining implementation mines the same associations */
+static void test_Mithril_mining_impl(gconstpointer user_data) {
+  uint64_t miss_cnt_true[] = {79796, 78480, 76126, 75256, 72336, 72062, 71936, 71667};
+  uint64_t miss_byte_true[] = {3471357440, 3399726080, 3285093888, 3245231616,
+                               3092759040, 3077801472, 3075234816, 3061489664};
+  const char *impls[] = {"mining-impl=scalar", "mining-impl=sse2", "mining-impl=avx2", "mining-impl=avx512"};
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+    cache_t *cache = LRU_init(cc_params, NULL);
+    cache->prefetcher = create_prefetcher("Mithril", impls[i], cc_params.cache_size);
+    cache_stat_t *res = simulate_at_multi_sizes_with_step_size(reader, cache, STEP_SIZE, NULL, 0, 0, _n_cores(), false);
+
+    _verify_profiler_results(res, CACHE_SIZE / STEP_SIZE, g_req_cnt_true, miss_cnt_true, g_req_byte_true,
+                             miss_byte_true);
+    cache->cache_free(cache);
+    my_free(sizeof(cache_stat_t), res);
+  }
+}
+
+typedef struct {
+  uint64_t n_miss;
+  Mithril_mining_stat_t mining_stat;
+  uint64_t n_prefetch_hit;
+} Mithril_run_t;
+
+static Mithril_run_t run_Mithril(reader_t *reader, const char *params) {
+  common_cache_params_t cc_params = {.cache_size = CACHE_SIZE / 2, .hashpower = 20, .default_ttl = DEFAULT_TTL};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  cache->prefetcher = create_prefetcher("Mithril", params, cc_params.cache_size);
+  request_t *req = new_request();
+  Mithril_run_t run = {0};
+
+  reset_reader(reader);
+  while (read_one_req(reader, req) == 0) {
+    if (!cache->get(cache, req)) run.n_miss += 1;
+  }
+  Mithril_params_t *Mithril_params = (Mithril_params_t *)cache->prefetcher->params;
+  run.mining_stat = Mithril_params->mining_stat;
+  run.n_prefetch_hit = Mithril_params->hit_on_prefetch_Mithril;
+  printf("%s: miss %" PRIu64 " mining %" PRIu64 " associations %" PRIu64 " prefetch hits %" PRIu64 "\n", params,
+         run.n_miss, (uint64_t)run.mining_stat.n_mining, (uint64_t)run.mining_stat.n_association, run.n_prefetch_hit);
+
+  free_request(req);
+  cache->cache_free(cache);
+  return run;
+}
+
+/* the deterministic mining mode does not depend on the speed of the mining
+ * thread */
+static void test_Mithril_mining_deterministic(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  Mithril_run_t run1 = run_Mithril(reader, "mining-mode=deterministic");
+  Mithril_run_t run2 = run_Mithril(reader, "mining-mode=deterministic");
+
+  g_assert_cmpuint(run1.mining_stat.n_mining, >, 0);
+  g_assert_cmpuint(run1.mining_stat.n_association, >, 0);
+  g_assert_cmpuint(run1.n_miss, ==, run2.n_miss);
+  g_assert_cmpuint(run1.mining_stat.n_mining, ==, run2.mining_stat.n_mining);
+  g_assert_cmpuint(run1.mining_stat.n_association, ==, run2.mining_stat.n_association);
+  g_assert_cmpuint(run1.mining_stat.association_hash, ==, run2.mining_stat.association_hash);
+  g_assert_cmpuint(run1.n_prefetch_hit, ==, run2.n_prefetch_hit);
+}
+
 static void test_OBL(gconstpointer user_data) {
   uint64_t miss_cnt_true[] = {92139, 88548, 82337, 80487, 71259, 70869, 70737, 70469};
   uint64_t miss_byte_true[] = {4213140480, 4060079616, 3776877568, 3659406848,
@@ -106,6 +173,9 @@ int main(int argc, char *argv[]) {
   reader = setup_oracleGeneralBin_reader();
   // reader = setup_vscsi_reader_with_ignored_obj_size();
   g_test_add_data_func("/libCacheSim/cacheAlgo_Mithril", reader, test_Mithril);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_Mithril_mining_impl", reader, test_Mithril_mining_impl);
+  g_test_add_data_func("/libCacheSim/cacheAlgo_Mithril_mining_deterministic", reader,
+                       test_Mithril_mining_deterministic);
   g_test_add_data_func("/libCacheSim/cacheAlgo_OBL", reader, test_OBL);
   g_test_add_data_func("/libCacheSim/cacheAlgo_PG", reader, test_PG);
 
@@ -2,6 +2,8 @@
 // Created by Juncheng Yang on 11/21/19.
 //
 
+#include <math.h>
+
 #include "common.h"
 
 /**
@@ -200,6 +202,401 @@ static void test_simulator_with_ttl(gconstpointer user_data) {
   cache->cache_free(cache);
 }
 
+/**
+ * replay on a sharded cache with multiple threads, one shard and the
+ * unsharded cache have the same result, and dispatching by shard gives the
+ * same result with any number of threads
+ */
+static void test_simulator_concurrent(gconstpointer user_data) {
+  uint64_t req_cnt_true = 113872, req_byte_true = 4205978112;
+  uint64_t miss_cnt_true = 71702, miss_byte_true = 3059534336;
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .default_ttl = 0, .hashpower = 16, .consider_obj_metadata = false};
+  cache_t *cache = LRU_init(cc_params, NULL);
+  cache_stat_t stat;
+
+  simulate_concurrent(reader, cache, 1, CONCURRENT_DISPATCH_BY_SHARD, 0, &stat);
+  g_assert_cmpuint(stat.n_req, ==, req_cnt_true);
+  g_assert_cmpuint(stat.n_req_byte, ==, req_byte_true);
+  g_assert_cmpuint(stat.n_miss, ==, miss_cnt_true);
+  g_assert_cmpuint(stat.n_miss_byte, ==, miss_byte_true);
+
+  cache_t *sharded = sharded_cache_init(cache, 1);
+  simulate_concurrent(reader, sharded, 2, CONCURRENT_DISPATCH_BY_ARRIVAL, 0, &stat);
+  g_assert_cmpuint(stat.n_req, ==, req_cnt_true);
+  sharded->cache_free(sharded);
+
+  sharded = sharded_cache_init(cache, 1);
+  simulate_concurrent(reader, sharded, 1, CONCURRENT_DISPATCH_BY_SHARD, 0, &stat);
+  g_assert_cmpuint(stat.n_miss, ==, miss_cnt_true);
+  g_assert_cmpuint(stat.n_miss_byte, ==, miss_byte_true);
+  sharded->cache_free(sharded);
+
+  sharded = sharded_cache_init(cache, 4);
+  cache_stat_t stat_one_thread;
+  simulate_concurrent(reader, sharded, 1, CONCURRENT_DISPATCH_BY_SHARD, 0, &stat_one_thread);
+  int64_t n_obj = sharded->get_n_obj(sharded);
+  g_assert_cmpint(n_obj, >, 0);
+  g_assert_cmpint(sharded->get_occupied_byte(sharded), <=, CACHE_SIZE);
+  sharded->cache_free(sharded);
+
+  sharded = sharded_cache_init(cache, 4);
+  simulate_concurrent(reader, sharded, 4, CONCURRENT_DISPATCH_BY_SHARD, 0, &stat);
+  g_assert_cmpuint(stat.n_req, ==, req_cnt_true);
+  g_assert_cmpuint(stat.n_miss, ==, stat_one_thread.n_miss);
+  g_assert_cmpuint(stat.n_miss_byte, ==, stat_one_thread.n_miss_byte);
+  g_assert_cmpint(sharded->get_n_obj(sharded), ==, n_obj);
+  sharded->cache_free(sharded);
+
+  /* get and remove route an object to the same shard, whatever hash value
+   * the request carries */
+  sharded = sharded_cache_init(cache, 4);
+  request_t *req = new_request();
+  for (obj_id_t id = 1; id <= 100; id++) {
+    req->obj_id = id;
+    req->hv = id;
+    sharded->get(sharded, req);
+  }
+  for (obj_id_t id = 1; id <= 100; id++) {
+    g_assert_true(sharded->remove(sharded, id));
+  }
+  g_assert_cmpint(sharded->get_n_obj(sharded), ==, 0);
+  free_request(req);
+  sharded->cache_free(sharded);
+
+  cache->cache_free(cache);
+}
+
+typedef struct {
+  GHashTable *dirty;
+  int64_t n_writeback;
+} writeback_counter_t;
+
+/* count the dirty objects evicted from the cache */
+static void count_writeback(cache_t *cache, const cache_obj_t *obj, void *data) {
+  writeback_counter_t *counter = data;
+  if (g_hash_table_remove(counter->dirty, GSIZE_TO_POINTER(obj->obj_id))) {
+    counter->n_writeback += 1;
+  }
+}
+
+static void test_cache_hierarchy(gconstpointer user_data) {
+  uint64_t req_cnt_true = 113872;
+  uint64_t miss_cnt_true = 71702, miss_byte_true = 3059534336;
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .default_ttl = 0, .hashpower = 16, .consider_obj_metadata = false};
+  cache_t *cache = LRU_init(cc_params, NULL);
+
+  /* one level is the same as simulating the cache */
+  uint64_t l1_size = CACHE_SIZE;
+  cache_hierarchy_t *hierarchy = create_cache_hierarchy(CACHE_HIERARCHY_INCLUSIVE);
+  cache_hierarchy_add_level(hierarchy, cache, &l1_size, 1);
+  simulate_cache_hierarchy(hierarchy, &reader, 1);
+  g_assert_cmpuint(hierarchy->levels[0].stats[0].stat.n_req, ==, req_cnt_true);
+  g_assert_cmpuint(hierarchy->levels[0].stats[0].stat.n_miss, ==, miss_cnt_true);
+  g_assert_cmpuint(hierarchy->levels[0].stats[0].stat.n_miss_byte, ==, miss_byte_true);
+  free_cache_hierarchy(hierarchy);
+
+  /* the inclusive L2 sees the misses of the L1 */
+  l1_size = CACHE_SIZE / 4;
+  uint64_t l2_sizes[] = {CACHE_SIZE / 2, CACHE_SIZE};
+  cache_t *l1 = create_cache_with_new_size(cache, l1_size);
+  cache_t *l2[] = {create_cache_with_new_size(cache, l2_sizes[0]), create_cache_with_new_size(cache, l2_sizes[1])};
+  uint64_t l2_miss_true[2] = {0, 0};
+  request_t *req = new_request();
+  reset_reader(reader);
+  read_one_req(reader, req);
+  while (req->valid) {
+    if (!l1->get(l1, req)) {
+      for (int i = 0; i < 2; i++) {
+        if (!l2[i]->get(l2[i], req)) l2_miss_true[i] += 1;
+      }
+    }
+    read_one_req(reader, req);
+  }
+
+  hierarchy = create_cache_hierarchy(CACHE_HIERARCHY_INCLUSIVE);
+  /* a small queue makes the levels wait for each other */
+  hierarchy->queue_size = 128;
+  cache_hierarchy_add_level(hierarchy, cache, &l1_size, 1);
+  cache_hierarchy_add_level(hierarchy, cache, l2_sizes, 2);
+  simulate_cache_hierarchy(hierarchy, &reader, 1);
+  int64_t l1_miss = hierarchy->levels[0].stats[0].stat.n_miss;
+  for (int i = 0; i < 2; i++) {
+    g_assert_cmpint(hierarchy->levels[1].stats[i].stat.n_req, ==, l1_miss);
+    g_assert_cmpuint(hierarchy->levels[1].stats[i].stat.n_miss, ==, l2_miss_true[i]);
+  }
+  free_cache_hierarchy(hierarchy);
+
+  /* the exclusive L2 holds the objects evicted from the L1 */
+  hierarchy = create_cache_hierarchy(CACHE_HIERARCHY_EXCLUSIVE);
+  cache_hierarchy_add_level(hierarchy, cache, &l1_size, 1);
+  cache_hierarchy_add_level(hierarchy, cache, l2_sizes, 1);
+  simulate_cache_hierarchy(hierarchy, &reader, 1);
+  cache_hierarchy_stat_t *l1_stat = &hierarchy->levels[0].stats[0];
+  cache_hierarchy_stat_t *l2_stat = &hierarchy->levels[1].stats[0];
+  g_assert_cmpint(l2_stat->stat.n_req, ==, l1_stat->stat.n_miss);
+  g_assert_cmpint(l2_stat->n_demote, ==, l1_stat->stat.n_miss - l1_stat->stat.n_obj);
+  g_assert_cmpint(l2_stat->stat.n_miss, <, l2_miss_true[0]);
+  free_cache_hierarchy(hierarchy);
+
+  /* the write-back L2 sees the reads the L1 misses and the dirty objects
+   * evicted from the L1, the vscsi trace has writes */
+  reader_t *vscsi_reader = setup_vscsi_reader();
+  cache_t *wb_l1 = create_cache_with_new_size(cache, l1_size);
+  int64_t n_read_miss_true = 0;
+  writeback_counter_t counter = {.dirty = g_hash_table_new(g_direct_hash, g_direct_equal), .n_writeback = 0};
+  wb_l1->evict_listener = count_writeback;
+  wb_l1->evict_listener_data = &counter;
+  read_one_req(vscsi_reader, req);
+  while (req->valid) {
+    bool hit = wb_l1->get(wb_l1, req);
+    if (req->op == OP_WRITE) {
+      if (wb_l1->find(wb_l1, req, false) != NULL) g_hash_table_add(counter.dirty, GSIZE_TO_POINTER(req->obj_id));
+    } else if (!hit) {
+      n_read_miss_true += 1;
+    }
+    read_one_req(vscsi_reader, req);
+  }
+  g_hash_table_destroy(counter.dirty);
+  wb_l1->cache_free(wb_l1);
+
+  hierarchy = create_cache_hierarchy(CACHE_HIERARCHY_WRITE_BACK);
+  cache_hierarchy_add_level(hierarchy, cache, &l1_size, 1);
+  cache_hierarchy_add_level(hierarchy, cache, l2_sizes, 1);
+  simulate_cache_hierarchy(hierarchy, &vscsi_reader, 1);
+  l1_stat = &hierarchy->levels[0].stats[0];
+  l2_stat = &hierarchy->levels[1].stats[0];
+  g_assert_cmpint(counter.n_writeback, >, 0);
+  g_assert_cmpint(l1_stat->n_writeback, ==, counter.n_writeback);
+  g_assert_cmpint(l2_stat->n_demote, ==, counter.n_writeback);
+  g_assert_cmpint(l2_stat->stat.n_req, ==, n_read_miss_true);
+  free_cache_hierarchy(hierarchy);
+  close_reader(vscsi_reader);
+
+  free_request(req);
+  l1->cache_free(l1);
+  l2[0]->cache_free(l2[0]);
+  l2[1]->cache_free(l2[1]);
+  cache->cache_free(cache);
+}
+
+static void test_cache_cluster(gconstpointer user_data) {
+  uint64_t req_cnt_true = 113872;
+  uint64_t miss_cnt_true = 71702, miss_byte_true = 3059534336;
+
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .default_ttl = 0, .hashpower = 16, .consider_obj_metadata = false};
+  cache_t *cache = LRU_init(cc_params, NULL);
+
+  /* one server is the same as simulating the cache */
+  cache_cluster_t *cluster = create_cache_cluster(cache, 1, CLUSTER_ROUTING_KETAMA);
+  simulate_cache_cluster(cluster, reader, 4);
+  g_assert_cmpuint(cluster->stat.n_req, ==, req_cnt_true);
+  g_assert_cmpuint(cluster->stat.n_miss, ==, miss_cnt_true);
+  g_assert_cmpuint(cluster->stat.n_miss_byte, ==, miss_byte_true);
+  g_assert_cmpfloat(cache_cluster_load_imbalance(cluster), ==, 1.0);
+  free_cache_cluster(cluster);
+
+  cluster_routing_e routings[] = {CLUSTER_ROUTING_KETAMA, CLUSTER_ROUTING_JUMP_HASH};
+  for (int i = 0; i < 2; i++) {
+    /* the result does not depend on the number of threads */
+    cache_cluster_t *one_thread = create_cache_cluster(cache, 8, routings[i]);
+    simulate_cache_cluster(one_thread, reader, 1);
+    cluster = create_cache_cluster(cache, 8, routings[i]);
+    simulate_cache_cluster(cluster, reader, 3);
+    g_assert_cmpuint(cluster->stat.n_req, ==, req_cnt_true);
+    g_assert_cmpuint(cluster->stat.n_miss, ==, one_thread->stat.n_miss);
+    for (int s = 0; s < 8; s++) {
+      g_assert_cmpuint(cluster->server_stats[s].n_req, ==, one_thread->server_stats[s].n_req);
+      g_assert_cmpuint(cluster->server_stats[s].n_miss, ==, one_thread->server_stats[s].n_miss);
+    }
+    g_assert_cmpfloat(cache_cluster_load_imbalance(cluster), >=, 1.0);
+
+    /* the replay sends every request to the server cache_cluster_route gives */
+    uint64_t n_server_req[8] = {0};
+    reader_t *cloned_reader = clone_reader(reader);
+    request_t *req = new_request();
+    while (read_one_req(cloned_reader, req) == 0) {
+      n_server_req[cache_cluster_route(cluster, req->obj_id)] += 1;
+    }
+    for (int s = 0; s < 8; s++) {
+      g_assert_cmpuint(cluster->server_stats[s].n_req, ==, n_server_req[s]);
+    }
+    free_request(req);
+    close_reader(cloned_reader);
+    free_cache_cluster(one_thread);
+    free_cache_cluster(cluster);
+
+    /* server 7 joins at the end of the trace, server 2 leaves in the middle
+     * and its requests go to the other servers */
+    cluster = create_cache_cluster(cache, 8, routings[i]);
+    cache_cluster_add_event(cluster, 0, CLUSTER_EVENT_REMOVE_SERVER, 7);
+    cache_cluster_add_event(cluster, INT64_MAX, CLUSTER_EVENT_ADD_SERVER, 7);
+    cache_cluster_add_event(cluster, 0, CLUSTER_EVENT_REMOVE_SERVER, 2);
+    simulate_cache_cluster(cluster, reader, 2);
+    g_assert_cmpuint(cluster->stat.n_req, ==, req_cnt_true);
+    g_assert_cmpuint(cluster->server_stats[7].n_req, ==, 0);
+    g_assert_cmpuint(cluster->server_stats[2].n_req, ==, 0);
+    g_assert_true(cluster->active[7]);
+    g_assert_false(cluster->active[2]);
+    g_assert_cmpint(cluster->servers[2]->get_n_obj(cluster->servers[2]), ==, 0);
+    free_cache_cluster(cluster);
+  }
+
+  cache->cache_free(cache);
+}
+
+static void test_successive_halving(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .default_ttl = 0, .hashpower = 16, .consider_obj_metadata = false};
+  const char *s3fifo_params[] = {"small-size-ratio=0.01", "small-size-ratio=0.1", "small-size-ratio=0.3"};
+#define N_CANDIDATE 6
+  cache_t *caches[N_CANDIDATE], *expected_caches[N_CANDIDATE];
+  for (int i = 0; i < 3; i++) {
+    caches[i] = S3FIFO_init(cc_params, s3fifo_params[i]);
+    expected_caches[i] = S3FIFO_init(cc_params, s3fifo_params[i]);
+  }
+  caches[3] = LRU_init(cc_params, NULL);
+  caches[4] = FIFO_init(cc_params, NULL);
+  caches[5] = Clock_init(cc_params, NULL);
+  expected_caches[3] = LRU_init(cc_params, NULL);
+  expected_caches[4] = FIFO_init(cc_params, NULL);
+  expected_caches[5] = Clock_init(cc_params, NULL);
+
+  cache_stat_t *expected = simulate_with_multi_caches(reader, expected_caches, N_CANDIDATE, NULL, 0.2, 0, 2, true, false);
+  /* checkpoints at 25% and 50% of the requests after the warmup, 6 -> 3 -> 2
+   * candidates */
+  halving_result_t *res = simulate_with_multi_caches_halving(reader, caches, N_CANDIDATE, 0.2, 0.25, 2, 2, true);
+
+  int n_finish = 0;
+  bool rank_seen[N_CANDIDATE + 1] = {false};
+  for (int i = 0; i < N_CANDIDATE; i++) {
+    g_assert_cmpstr(res[i].stat.cache_name, ==, expected[i].cache_name);
+    g_assert_cmpuint(res[i].stat.n_warmup_req, ==, expected[i].n_warmup_req);
+    g_assert_cmpint(res[i].rank, >=, 1);
+    g_assert_cmpint(res[i].rank, <=, N_CANDIDATE);
+    rank_seen[res[i].rank] = true;
+    if (res[i].n_checkpoint_passed == 3) {
+      /* the candidates that are not stopped are simulated as usual */
+      n_finish += 1;
+      g_assert_cmpuint(res[i].stat.n_req, ==, expected[i].n_req);
+      g_assert_cmpuint(res[i].stat.n_miss, ==, expected[i].n_miss);
+      g_assert_cmpuint(res[i].stat.n_miss_byte, ==, expected[i].n_miss_byte);
+      g_assert_cmpint(res[i].rank, <=, 2);
+    } else {
+      g_assert_cmpuint(res[i].stat.n_req, <, expected[i].n_req);
+      g_assert_cmpint(res[i].rank, >, 2);
+    }
+  }
+  g_assert_cmpint(n_finish, ==, 2);
+  for (int r = 1; r <= N_CANDIDATE; r++) g_assert_true(rank_seen[r]);
+#undef N_CANDIDATE
+
+  g_free(expected);
+  free(res);
+}
+
+static void test_warmup_sweep(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .default_ttl = 0, .hashpower = 16, .consider_obj_metadata = false};
+  const char *variant_params[] = {NULL, "small-size-ratio=0.05", "small-size-ratio=0.3,move-to-main-threshold=1"};
+
+  /* the variant with the parameters of the warm cache is the same as
+   * simulating the cache with warmup */
+  cache_t *caches[] = {S3FIFO_init(cc_params, NULL)};
+  cache_stat_t *expected = simulate_with_multi_caches(reader, caches, 1, NULL, 0.5, 0, 1, true, false);
+
+  cache_t *cache = S3FIFO_init(cc_params, NULL);
+  cache_stat_t *res = simulate_variants_after_warmup(reader, cache, 3, variant_params, 0.5, 2, WARMUP_SWEEP_THREAD);
+  cache->cache_free(cache);
+  g_assert_cmpuint(res[0].n_req, ==, expected[0].n_req);
+  g_assert_cmpuint(res[0].n_miss, ==, expected[0].n_miss);
+  g_assert_cmpuint(res[0].n_miss_byte, ==, expected[0].n_miss_byte);
+  g_assert_cmpstr(res[1].cache_name, ==, "S3FIFO-0.0500-2");
+
+  cache = S3FIFO_init(cc_params, NULL);
+  cache_stat_t *res_fork = simulate_variants_after_warmup(reader, cache, 3, variant_params, 0.5, 2, WARMUP_SWEEP_FORK);
+  cache->cache_free(cache);
+  for (int i = 0; i < 3; i++) {
+    g_assert_cmpuint(res[i].n_req, ==, expected[0].n_req);
+    g_assert_cmpuint(res_fork[i].n_req, ==, res[i].n_req);
+    g_assert_cmpuint(res_fork[i].n_miss, ==, res[i].n_miss);
+    g_assert_cmpstr(res_fork[i].cache_name, ==, res[i].cache_name);
+  }
+  g_assert_cmpuint(res[1].n_miss, !=, res[0].n_miss);
+
+  /* the variant parameters are applied over the parameters of the cache */
+  const char *merged_params[] = {"small-size-ratio=0.3", "small-size-ratio=0.3,move-to-main-threshold=1"};
+  cache = S3FIFO_init(cc_params, "move-to-main-threshold=1");
+  cache_stat_t *res_merged = simulate_variants_after_warmup(reader, cache, 2, merged_params, 0.5, 2, WARMUP_SWEEP_THREAD);
+  cache->cache_free(cache);
+  g_assert_cmpstr(res_merged[0].cache_name, ==, "S3FIFO-0.3000-1");
+  g_assert_cmpuint(res_merged[0].n_miss, ==, res_merged[1].n_miss);
+  g_free(res_merged);
+
+  /* LIRS cannot be cloned, the variant is reported with no request */
+  cache = LIRS_init(cc_params, NULL);
+  cache_stat_t *res_lirs = simulate_variants_after_warmup(reader, cache, 1, variant_params, 0.5, 1, WARMUP_SWEEP_THREAD);
+  g_assert_cmpuint(res_lirs[0].n_req, ==, 0);
+  g_free(res_lirs);
+  cache->cache_free(cache);
+
+  g_free(expected);
+  g_free(res);
+  g_free(res_fork);
+}
+
+static void test_early_stop(gconstpointer user_data) {
+  reader_t *reader = (reader_t *)user_data;
+  common_cache_params_t cc_params = {
+      .cache_size = CACHE_SIZE, .default_ttl = 0, .hashpower = 16, .consider_obj_metadata = false};
+
+  g_assert_cmpfloat(fabs(student_t_quantile(0.95, 15) - 2.1314), <, 1e-3);
+  g_assert_cmpfloat(fabs(student_t_quantile(0.99, 30) - 2.7500), <, 1e-3);
+
+  cache_t *caches[] = {LRU_init(cc_params, NULL), FIFO_init(cc_params, NULL)};
+  cache_stat_t *full = simulate_with_multi_caches(reader, caches, 2, NULL, 0.1, 0, 2, true, false);
+
+  /* the miss ratio never converges to this error, so the caches run to the
+   * end of the trace */
+  convergence_params_t params = default_convergence_params(1e-9, 0.95);
+  params.batch_size = 1000;
+  caches[0] = LRU_init(cc_params, NULL);
+  caches[1] = FIFO_init(cc_params, NULL);
+  cache_stat_t *res = simulate_with_multi_caches_early_stop(reader, caches, 2, NULL, 0.1, 0, 2, true, false, &params);
+  for (int i = 0; i < 2; i++) {
+    g_assert_false(res[i].early_stopped);
+    g_assert_cmpuint(res[i].n_req, ==, full[i].n_req);
+    g_assert_cmpuint(res[i].n_miss, ==, full[i].n_miss);
+  }
+  g_free(res);
+
+  /* each cache stops on its own once its miss ratio is within the error */
+  params.max_error = 0.01;
+  caches[0] = LRU_init(cc_params, NULL);
+  caches[1] = FIFO_init(cc_params, NULL);
+  res = simulate_with_multi_caches_early_stop(reader, caches, 2, NULL, 0.1, 0, 2, true, false, &params);
+  for (int i = 0; i < 2; i++) {
+    g_assert_true(res[i].early_stopped);
+    g_assert_cmpuint(res[i].n_req, <, full[i].n_req);
+    g_assert_cmpuint(res[i].n_req, >=, params.batch_size * params.min_n_batch);
+    g_assert_cmpfloat(res[i].miss_ratio_ci, <=, params.max_error);
+    double full_miss_ratio = (double)full[i].n_miss / (double)full[i].n_req;
+    g_assert_cmpfloat(fabs((double)res[i].n_miss / (double)res[i].n_req - full_miss_ratio), <, 3 * params.max_error);
+  }
+
+  g_free(full);
+  g_free(res);
+}
+
 int main(int argc, char *argv[]) {
   g_test_init(&argc, &argv, NULL);
   reader_t *reader;
@@ -222,6 +619,24 @@ int main(int argc, char *argv[]) {
   reader = setup_vscsi_reader();
   g_test_add_data_func_full("/libCacheSim/simulator_vscsi", reader, test_simulator, test_teardown);
 
+  reader = setup_binary_reader();
+  g_test_add_data_func_full("/libCacheSim/simulator_concurrent", reader, test_simulator_concurrent, test_teardown);
+
+  reader = setup_binary_reader();
+  g_test_add_data_func_full("/libCacheSim/cache_hierarchy", reader, test_cache_hierarchy, test_teardown);
+
+  reader = setup_binary_reader();
+  g_test_add_data_func_full("/libCacheSim/cache_cluster", reader, test_cache_cluster, test_teardown);
+
+  reader = setup_binary_reader();
+  g_test_add_data_func_full("/libCacheSim/warmup_sweep", reader, test_warmup_sweep, test_teardown);
+
+  reader = setup_binary_reader();
+  g_test_add_data_func_full("/libCacheSim/successive_halving", reader, test_successive_halving, test_teardown);
+
+  reader = setup_binary_reader();
+  g_test_add_data_func_full("/libCacheSim/early_stop", reader, test_early_stop, test_teardown);
+
   reader = setup_vscsi_reader();
   g_test_add_data_func_full("/libCacheSim/simulator_warmup1", reader, test_simulator_with_warmup1, test_teardown);
 